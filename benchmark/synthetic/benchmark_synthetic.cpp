@@ -0,0 +1,701 @@
+// Copyright (C) 2019-2023 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License.
+
+// Latency and QPS benchmark on generated data, so that it runs anywhere without downloading a dataset:
+//
+//   benchmark_synthetic --data=dense --index=HNSW --metric=L2 --dim=128 --nb=100000 --nq=1000 --k=10 \
+//       --build_params='{"M":16,"efConstruction":200}' --search_params='{"ef":64}' \
+//       --filter_ratio=0.5 --threads=1,8 --qps=500,2000 --duration=10 --output=hnsw.json
+//
+// --data is one of dense, sparse, binary or emb_list. Rows are drawn around `clusters` random centers, so graph and
+// IVF indexes see some structure, and `filter_ratio` of the rows (or emb lists) are filtered out by a random bitset.
+//
+// All queries are first searched once, which warms the index up and measures recall against brute force. Then a
+// closed-loop run is made for every entry of --threads, each thread issuing single-query searches back to back, and
+// an open-loop run for every entry of --qps, where searches arrive at a fixed rate (or as a Poisson process with
+// --arrival=poisson) and are served by the largest --threads entry. Open-loop latencies are measured from the
+// scheduled arrival, so a stalled search shows up in the tail rather than slowing the generator down.
+//
+// The report is a single JSON document on stdout, or in --output; progress goes to stderr.
+
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "benchmark/utils.h"
+#include "knowhere/comp/brute_force.h"
+#include "knowhere/comp/index_param.h"
+#include "knowhere/comp/knowhere_config.h"
+#include "knowhere/dataset.h"
+#include "knowhere/index/index_factory.h"
+#include "knowhere/sparse_utils.h"
+#include "knowhere/version.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Options {
+    std::string data = "dense";
+    std::string index = knowhere::IndexEnum::INDEX_HNSW;
+    std::string metric;
+    int64_t dim = 128;
+    int64_t nb = 100000;
+    int64_t nq = 1000;
+    int64_t k = 10;
+    int64_t clusters = 64;
+    // non-zeros per sparse base row and query row
+    int64_t avg_nnz = 64;
+    int64_t query_nnz = 16;
+    // vectors per emb list
+    int64_t el_len = 8;
+    float filter_ratio = 0.0f;
+    std::vector<int64_t> threads = {1};
+    std::vector<double> qps;
+    std::string arrival = "uniform";
+    double duration = 10.0;
+    int64_t max_requests = 0;
+    uint64_t seed = 42;
+    int64_t build_pool = 0;
+    int64_t search_pool = 0;
+    knowhere::Json build_params = knowhere::Json::object();
+    knowhere::Json search_params = knowhere::Json::object();
+    std::string output;
+};
+
+[[noreturn]] void
+Usage(const char* prog, const std::string& error) {
+    if (!error.empty()) {
+        fprintf(stderr, "error: %s\n\n", error.c_str());
+    }
+    fprintf(stderr,
+            "usage: %s [--data=dense|sparse|binary|emb_list] [--index=HNSW] [--metric=L2] [--dim=128]\n"
+            "       [--nb=100000] [--nq=1000] [--k=10] [--clusters=64] [--avg_nnz=64] [--query_nnz=16] [--el_len=8]\n"
+            "       [--filter_ratio=0] [--threads=1,8] [--qps=500,2000] [--arrival=uniform|poisson] [--duration=10]\n"
+            "       [--max_requests=0] [--seed=42] [--build_pool=0] [--search_pool=0]\n"
+            "       [--build_params=JSON] [--search_params=JSON] [--output=FILE]\n",
+            prog);
+    exit(error.empty() ? 0 : 1);
+}
+
+template <typename T>
+std::vector<T>
+ParseList(const std::string& value) {
+    std::vector<T> list;
+    size_t begin = 0;
+    while (begin <= value.size()) {
+        auto end = value.find(',', begin);
+        if (end == std::string::npos) {
+            end = value.size();
+        }
+        if (end > begin) {
+            list.push_back(static_cast<T>(std::stod(value.substr(begin, end - begin))));
+        }
+        begin = end + 1;
+    }
+    return list;
+}
+
+Options
+ParseOptions(int argc, char** argv) {
+    Options opt;
+    const std::unordered_map<std::string, std::function<void(const std::string&)>> setters = {
+        {"data", [&](const std::string& v) { opt.data = v; }},
+        {"index", [&](const std::string& v) { opt.index = v; }},
+        {"metric", [&](const std::string& v) { opt.metric = v; }},
+        {"dim", [&](const std::string& v) { opt.dim = std::stoll(v); }},
+        {"nb", [&](const std::string& v) { opt.nb = std::stoll(v); }},
+        {"nq", [&](const std::string& v) { opt.nq = std::stoll(v); }},
+        {"k", [&](const std::string& v) { opt.k = std::stoll(v); }},
+        {"clusters", [&](const std::string& v) { opt.clusters = std::stoll(v); }},
+        {"avg_nnz", [&](const std::string& v) { opt.avg_nnz = std::stoll(v); }},
+        {"query_nnz", [&](const std::string& v) { opt.query_nnz = std::stoll(v); }},
+        {"el_len", [&](const std::string& v) { opt.el_len = std::stoll(v); }},
+        {"filter_ratio", [&](const std::string& v) { opt.filter_ratio = std::stof(v); }},
+        {"threads", [&](const std::string& v) { opt.threads = ParseList<int64_t>(v); }},
+        {"qps", [&](const std::string& v) { opt.qps = ParseList<double>(v); }},
+        {"arrival", [&](const std::string& v) { opt.arrival = v; }},
+        {"duration", [&](const std::string& v) { opt.duration = std::stod(v); }},
+        {"max_requests", [&](const std::string& v) { opt.max_requests = std::stoll(v); }},
+        {"seed", [&](const std::string& v) { opt.seed = std::stoull(v); }},
+        {"build_pool", [&](const std::string& v) { opt.build_pool = std::stoll(v); }},
+        {"search_pool", [&](const std::string& v) { opt.search_pool = std::stoll(v); }},
+        {"build_params", [&](const std::string& v) { opt.build_params = knowhere::Json::parse(v); }},
+        {"search_params", [&](const std::string& v) { opt.search_params = knowhere::Json::parse(v); }},
+        {"output", [&](const std::string& v) { opt.output = v; }},
+    };
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            Usage(argv[0], "");
+        }
+        auto eq = arg.find('=');
+        if (arg.rfind("--", 0) != 0 || eq == std::string::npos) {
+            Usage(argv[0], "malformed argument " + arg);
+        }
+        auto it = setters.find(arg.substr(2, eq - 2));
+        if (it == setters.end()) {
+            Usage(argv[0], "unknown option " + arg);
+        }
+        try {
+            it->second(arg.substr(eq + 1));
+        } catch (const std::exception& e) {
+            Usage(argv[0], "invalid value in " + arg + ": " + e.what());
+        }
+    }
+
+    if (opt.data != "dense" && opt.data != "sparse" && opt.data != "binary" && opt.data != "emb_list") {
+        Usage(argv[0], "unknown data kind " + opt.data);
+    }
+    if (opt.metric.empty()) {
+        opt.metric = opt.data == "sparse"     ? knowhere::metric::IP
+                     : opt.data == "binary"   ? knowhere::metric::HAMMING
+                     : opt.data == "emb_list" ? knowhere::metric::MAX_SIM_IP
+                                              : knowhere::metric::L2;
+    }
+    if (opt.data == "binary" && opt.dim % 8 != 0) {
+        Usage(argv[0], "binary dim must be a multiple of 8");
+    }
+    if (opt.arrival != "uniform" && opt.arrival != "poisson") {
+        Usage(argv[0], "unknown arrival process " + opt.arrival);
+    }
+    if (opt.dim <= 0 || opt.nb <= 0 || opt.nq <= 0 || opt.k <= 0 || opt.clusters <= 0 || opt.el_len <= 0 ||
+        opt.threads.empty() || opt.filter_ratio < 0.0f || opt.filter_ratio > 1.0f) {
+        Usage(argv[0], "invalid sizes");
+    }
+    return opt;
+}
+
+// Generated base and queries. `requests[i]` is a single-query view of query i, and the filter bitset covers
+// `filter_bits` rows, which are emb lists for emb_list data.
+struct Workload {
+    knowhere::DataSetPtr base;
+    knowhere::DataSetPtr queries;
+    std::vector<knowhere::DataSetPtr> requests;
+    int64_t filter_bits = 0;
+
+    std::vector<float> floats;
+    std::vector<uint8_t> bits;
+    std::vector<size_t> offsets;
+};
+
+// Gaussian clusters around centers drawn uniformly from [-1, 1]^dim.
+class ClusteredFloats {
+ public:
+    ClusteredFloats(int64_t dim, int64_t clusters, std::mt19937_64& rng) : dim_(dim), centers_(dim * clusters) {
+        std::uniform_real_distribution<float> center_dist(-1.0f, 1.0f);
+        for (auto& c : centers_) {
+            c = center_dist(rng);
+        }
+    }
+
+    int64_t
+    clusters() const {
+        return centers_.size() / dim_;
+    }
+
+    void
+    Fill(float* out, int64_t rows, int64_t cluster, std::mt19937_64& rng) const {
+        std::normal_distribution<float> noise(0.0f, 0.25f);
+        const float* center = centers_.data() + cluster * dim_;
+        for (int64_t i = 0; i < rows; ++i) {
+            for (int64_t j = 0; j < dim_; ++j) {
+                out[i * dim_ + j] = center[j] + noise(rng);
+            }
+        }
+    }
+
+    void
+    FillRandom(float* out, int64_t rows, std::mt19937_64& rng) const {
+        std::uniform_int_distribution<int64_t> cluster_dist(0, clusters() - 1);
+        for (int64_t i = 0; i < rows; ++i) {
+            Fill(out + i * dim_, 1, cluster_dist(rng), rng);
+        }
+    }
+
+ private:
+    int64_t dim_;
+    std::vector<float> centers_;
+};
+
+void
+GenDense(const Options& opt, Workload& w) {
+    std::mt19937_64 rng(opt.seed);
+    ClusteredFloats gen(opt.dim, opt.clusters, rng);
+    w.floats.resize((opt.nb + opt.nq) * opt.dim);
+    gen.FillRandom(w.floats.data(), opt.nb + opt.nq, rng);
+
+    const float* xq = w.floats.data() + opt.nb * opt.dim;
+    w.base = knowhere::GenDataSet(opt.nb, opt.dim, w.floats.data());
+    w.queries = knowhere::GenDataSet(opt.nq, opt.dim, xq);
+    for (int64_t i = 0; i < opt.nq; ++i) {
+        w.requests.push_back(knowhere::GenDataSet(1, opt.dim, xq + i * opt.dim));
+    }
+    w.filter_bits = opt.nb;
+}
+
+// Every row is one of the cluster centers with each bit flipped with a fixed probability.
+void
+GenBinary(const Options& opt, Workload& w) {
+    std::mt19937_64 rng(opt.seed);
+    const int64_t code_size = opt.dim / 8;
+    std::uniform_int_distribution<int> byte_dist(0, 255);
+    std::vector<uint8_t> centers(opt.clusters * code_size);
+    for (auto& c : centers) {
+        c = byte_dist(rng);
+    }
+
+    std::uniform_int_distribution<int64_t> cluster_dist(0, opt.clusters - 1);
+    std::bernoulli_distribution flip(0.15);
+    w.bits.resize((opt.nb + opt.nq) * code_size);
+    for (int64_t i = 0; i < opt.nb + opt.nq; ++i) {
+        const uint8_t* center = centers.data() + cluster_dist(rng) * code_size;
+        for (int64_t j = 0; j < opt.dim; ++j) {
+            bool bit = ((center[j / 8] >> (j % 8)) & 1) ^ flip(rng);
+            w.bits[i * code_size + j / 8] |= uint8_t(bit) << (j % 8);
+        }
+    }
+
+    const uint8_t* xq = w.bits.data() + opt.nb * code_size;
+    w.base = knowhere::GenDataSet(opt.nb, opt.dim, w.bits.data());
+    w.queries = knowhere::GenDataSet(opt.nq, opt.dim, xq);
+    for (int64_t i = 0; i < opt.nq; ++i) {
+        w.requests.push_back(knowhere::GenDataSet(1, opt.dim, xq + i * code_size));
+    }
+    w.filter_bits = opt.nb;
+}
+
+// Terms follow a Zipf popularity over the `dim` vocabulary. Every cluster is a topic of popular-ish terms, and a row
+// takes half of its terms from its topic and the rest from the whole vocabulary.
+void
+GenSparse(const Options& opt, Workload& w) {
+    std::mt19937_64 rng(opt.seed);
+    std::vector<double> popularity(opt.dim);
+    for (int64_t i = 0; i < opt.dim; ++i) {
+        popularity[i] = 1.0 / (i + 1);
+    }
+    std::discrete_distribution<int32_t> term_dist(popularity.begin(), popularity.end());
+
+    const int64_t topic_size = std::max<int64_t>(16, opt.avg_nnz * 4);
+    std::vector<std::vector<int32_t>> topics(opt.clusters);
+    for (auto& topic : topics) {
+        for (int64_t i = 0; i < topic_size; ++i) {
+            topic.push_back(term_dist(rng));
+        }
+    }
+
+    std::uniform_int_distribution<int64_t> cluster_dist(0, opt.clusters - 1);
+    std::uniform_real_distribution<float> val_dist(0.05f, 1.0f);
+    auto gen_rows = [&](int64_t rows, int64_t avg_nnz) {
+        auto tensor = std::make_unique<knowhere::sparse::SparseRow<float>[]>(rows);
+        std::uniform_int_distribution<int64_t> nnz_dist(std::max<int64_t>(1, avg_nnz / 2), avg_nnz * 3 / 2 + 1);
+        for (int64_t i = 0; i < rows; ++i) {
+            const auto& topic = topics[cluster_dist(rng)];
+            std::uniform_int_distribution<size_t> topic_dist(0, topic.size() - 1);
+            const int64_t nnz = std::min(nnz_dist(rng), opt.dim);
+            std::map<int32_t, float> row;
+            while ((int64_t)row.size() < nnz) {
+                auto term = row.size() % 2 == 0 ? topic[topic_dist(rng)] : term_dist(rng);
+                row[term] = val_dist(rng);
+            }
+            knowhere::sparse::SparseRow<float> sparse_row(row.size());
+            size_t j = 0;
+            for (auto& [term, val] : row) {
+                sparse_row.set_at(j++, term, val);
+            }
+            tensor[i] = std::move(sparse_row);
+        }
+        auto ds = knowhere::GenDataSet(rows, opt.dim, tensor.release());
+        ds->SetIsOwner(true);
+        ds->SetIsSparse(true);
+        return ds;
+    };
+
+    w.base = gen_rows(opt.nb, opt.avg_nnz);
+    w.queries = gen_rows(opt.nq, opt.query_nnz);
+    auto xq = static_cast<const knowhere::sparse::SparseRow<float>*>(w.queries->GetTensor());
+    for (int64_t i = 0; i < opt.nq; ++i) {
+        auto ds = knowhere::GenDataSet(1, opt.dim, xq + i);
+        ds->SetIsSparse(true);
+        w.requests.push_back(ds);
+    }
+    w.filter_bits = opt.nb;
+}
+
+// `nb` emb lists of `el_len` vectors, all vectors of a list drawn from the same cluster. Queries are emb lists too.
+void
+GenEmbList(const Options& opt, Workload& w) {
+    std::mt19937_64 rng(opt.seed);
+    ClusteredFloats gen(opt.dim, opt.clusters, rng);
+    std::uniform_int_distribution<int64_t> cluster_dist(0, opt.clusters - 1);
+    const int64_t list_floats = opt.el_len * opt.dim;
+    w.floats.resize((opt.nb + opt.nq) * list_floats);
+    for (int64_t i = 0; i < opt.nb + opt.nq; ++i) {
+        gen.Fill(w.floats.data() + i * list_floats, opt.el_len, cluster_dist(rng), rng);
+    }
+
+    // the offsets of the first nq + 1 lists serve the queries as well
+    w.offsets.resize(std::max(opt.nb, opt.nq) + 1);
+    for (size_t i = 0; i < w.offsets.size(); ++i) {
+        w.offsets[i] = i * opt.el_len;
+    }
+    w.base = knowhere::GenDataSet(opt.nb * opt.el_len, opt.dim, w.floats.data());
+    w.base->Set(knowhere::meta::EMB_LIST_OFFSET, const_cast<const size_t*>(w.offsets.data()));
+
+    const float* xq = w.floats.data() + opt.nb * list_floats;
+    w.queries = knowhere::GenDataSet(opt.nq * opt.el_len, opt.dim, xq);
+    w.queries->Set(knowhere::meta::EMB_LIST_OFFSET, const_cast<const size_t*>(w.offsets.data()));
+    for (int64_t i = 0; i < opt.nq; ++i) {
+        auto ds = knowhere::GenDataSet(opt.el_len, opt.dim, xq + i * list_floats);
+        ds->Set(knowhere::meta::EMB_LIST_OFFSET, const_cast<const size_t*>(w.offsets.data()));
+        w.requests.push_back(ds);
+    }
+    w.filter_bits = opt.nb;
+}
+
+int64_t
+PeakRssKB() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+    return usage.ru_maxrss / 1024;
+#else
+    return usage.ru_maxrss;
+#endif
+}
+
+double
+Seconds(Clock::duration d) {
+    return std::chrono::duration<double>(d).count();
+}
+
+knowhere::Json
+LatencyReport(std::vector<double>& latencies) {
+    knowhere::Json report;
+    if (latencies.empty()) {
+        return report;
+    }
+    std::sort(latencies.begin(), latencies.end());
+    // nearest-rank percentiles
+    auto percentile = [&](double p) {
+        auto rank = static_cast<size_t>(std::ceil(p * latencies.size()));
+        return latencies[std::clamp<size_t>(rank, 1, latencies.size()) - 1] * 1e3;
+    };
+    double sum = 0.0;
+    for (auto l : latencies) {
+        sum += l;
+    }
+    report["mean_ms"] = sum / latencies.size() * 1e3;
+    report["p50_ms"] = percentile(0.50);
+    report["p95_ms"] = percentile(0.95);
+    report["p99_ms"] = percentile(0.99);
+    report["p999_ms"] = percentile(0.999);
+    report["max_ms"] = latencies.back() * 1e3;
+    return report;
+}
+
+template <typename DataType>
+class Runner {
+ public:
+    Runner(const Options& opt, const Workload& w) : opt_(opt), w_(w) {
+    }
+
+    knowhere::Json
+    Run() {
+        knowhere::Json report;
+        std::vector<uint8_t> filter;
+        if (opt_.filter_ratio > 0.0f) {
+            filter = GenRandomBitset(w_.filter_bits, static_cast<size_t>(w_.filter_bits * opt_.filter_ratio));
+            bitset_ = knowhere::BitsetView(filter.data(), w_.filter_bits);
+        }
+
+        knowhere::Json conf;
+        conf[knowhere::meta::METRIC_TYPE] = opt_.metric;
+        conf[knowhere::meta::DIM] = opt_.dim;
+        conf[knowhere::meta::TOPK] = opt_.k;
+        build_conf_ = conf;
+        build_conf_.update(opt_.build_params);
+        search_conf_ = conf;
+        search_conf_.update(opt_.search_params);
+
+        auto version = knowhere::Version::GetCurrentVersion().VersionNumber();
+        auto index = knowhere::IndexFactory::Instance().Create<DataType>(opt_.index, version);
+        if (!index.has_value()) {
+            throw std::runtime_error("failed to create index " + opt_.index + ": " + index.what());
+        }
+        index_ = index.value();
+
+        fprintf(stderr, "building %s on %ld %s rows\n", opt_.index.c_str(), (long)opt_.nb, opt_.data.c_str());
+        auto build_start = Clock::now();
+        auto status = index_.Build(w_.base, build_conf_);
+        if (status != knowhere::Status::success) {
+            throw std::runtime_error("build failed: " + knowhere::Status2String(status));
+        }
+        report["build_s"] = Seconds(Clock::now() - build_start);
+        report["index_size_bytes"] = index_.Size();
+        report["peak_rss_after_build_kb"] = PeakRssKB();
+
+        report["recall"] = Recall(conf);
+
+        for (auto threads : opt_.threads) {
+            fprintf(stderr, "closed loop, %ld threads\n", (long)threads);
+            report["runs"].push_back(ClosedLoop(threads));
+        }
+        const auto workers = *std::max_element(opt_.threads.begin(), opt_.threads.end());
+        for (auto qps : opt_.qps) {
+            fprintf(stderr, "open loop, %.1f qps on %ld threads\n", qps, (long)workers);
+            report["runs"].push_back(OpenLoop(qps, workers));
+        }
+        return report;
+    }
+
+ private:
+    const Options& opt_;
+    const Workload& w_;
+    knowhere::BitsetView bitset_ = nullptr;
+    knowhere::Json build_conf_;
+    knowhere::Json search_conf_;
+    knowhere::Index<knowhere::IndexNode> index_;
+
+    bool
+    Search(int64_t query) const {
+        return index_.Search(w_.requests[query % opt_.nq], search_conf_, bitset_).has_value();
+    }
+
+    // searches every query once, which also warms the index up before the timed runs
+    double
+    Recall(const knowhere::Json& conf) const {
+        fprintf(stderr, "computing ground truth\n");
+        auto gt = [&] {
+            if constexpr (std::is_same_v<DataType, knowhere::sparse_u32_f32>) {
+                return knowhere::BruteForce::SearchSparse(w_.base, w_.queries, conf, bitset_);
+            } else {
+                return knowhere::BruteForce::Search<DataType>(w_.base, w_.queries, conf, bitset_);
+            }
+        }();
+        if (!gt.has_value()) {
+            throw std::runtime_error("ground truth search failed: " + gt.what());
+        }
+        const int64_t* gt_ids = gt.value()->GetIds();
+
+        int64_t hits = 0;
+        int64_t total = 0;
+        for (int64_t q = 0; q < opt_.nq; ++q) {
+            auto res = index_.Search(w_.requests[q], search_conf_, bitset_);
+            if (!res.has_value()) {
+                throw std::runtime_error("search failed: " + res.what());
+            }
+            std::unordered_set<int64_t> expected;
+            for (int64_t j = 0; j < opt_.k; ++j) {
+                if (gt_ids[q * opt_.k + j] >= 0) {
+                    expected.insert(gt_ids[q * opt_.k + j]);
+                }
+            }
+            const int64_t* ids = res.value()->GetIds();
+            for (int64_t j = 0; j < opt_.k; ++j) {
+                hits += expected.count(ids[j]);
+            }
+            total += expected.size();
+        }
+        return total == 0 ? 1.0 : double(hits) / total;
+    }
+
+    knowhere::Json
+    ClosedLoop(int64_t threads) const {
+        std::atomic<int64_t> next{0};
+        std::atomic<int64_t> errors{0};
+        std::vector<std::vector<double>> latencies(threads);
+        const auto start = Clock::now();
+        const auto deadline = start + std::chrono::duration_cast<Clock::duration>(
+                                          std::chrono::duration<double>(opt_.duration));
+
+        std::vector<std::thread> workers;
+        for (int64_t t = 0; t < threads; ++t) {
+            workers.emplace_back([&, t] {
+                while (true) {
+                    auto i = next.fetch_add(1);
+                    auto begin = Clock::now();
+                    if (begin >= deadline || (opt_.max_requests > 0 && i >= opt_.max_requests)) {
+                        break;
+                    }
+                    if (!Search(i)) {
+                        errors++;
+                    }
+                    latencies[t].push_back(Seconds(Clock::now() - begin));
+                }
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        const double elapsed = Seconds(Clock::now() - start);
+
+        std::vector<double> all;
+        for (auto& l : latencies) {
+            all.insert(all.end(), l.begin(), l.end());
+        }
+        knowhere::Json run;
+        run["mode"] = "closed";
+        run["threads"] = threads;
+        run["requests"] = all.size();
+        run["errors"] = errors.load();
+        run["elapsed_s"] = elapsed;
+        run["qps"] = all.size() / elapsed;
+        run["latency"] = LatencyReport(all);
+        return run;
+    }
+
+    knowhere::Json
+    OpenLoop(double qps, int64_t threads) const {
+        // the arrival schedule, as offsets from the start
+        int64_t requests = static_cast<int64_t>(qps * opt_.duration);
+        if (opt_.max_requests > 0) {
+            requests = std::min(requests, opt_.max_requests);
+        }
+        std::vector<double> arrivals(requests);
+        std::mt19937_64 rng(opt_.seed);
+        std::exponential_distribution<double> gap(qps);
+        double t = 0.0;
+        for (auto& arrival : arrivals) {
+            arrival = t;
+            t += opt_.arrival == "poisson" ? gap(rng) : 1.0 / qps;
+        }
+
+        std::atomic<int64_t> next{0};
+        std::atomic<int64_t> errors{0};
+        std::vector<double> latencies(requests);
+        std::vector<double> lags(requests);
+        const auto start = Clock::now();
+
+        std::vector<std::thread> workers;
+        for (int64_t w = 0; w < threads; ++w) {
+            workers.emplace_back([&] {
+                int64_t i;
+                while ((i = next.fetch_add(1)) < requests) {
+                    auto scheduled =
+                        start + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(arrivals[i]));
+                    std::this_thread::sleep_until(scheduled);
+                    lags[i] = Seconds(Clock::now() - scheduled);
+                    if (!Search(i)) {
+                        errors++;
+                    }
+                    latencies[i] = Seconds(Clock::now() - scheduled);
+                }
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        const double elapsed = Seconds(Clock::now() - start);
+
+        knowhere::Json run;
+        run["mode"] = "open";
+        run["arrival"] = opt_.arrival;
+        run["threads"] = threads;
+        run["offered_qps"] = qps;
+        run["requests"] = requests;
+        run["errors"] = errors.load();
+        run["elapsed_s"] = elapsed;
+        run["qps"] = requests / elapsed;
+        run["latency"] = LatencyReport(latencies);
+        // how long searches waited for a free worker, high values mean the offered load is over capacity
+        run["queueing"] = LatencyReport(lags);
+        return run;
+    }
+};
+
+}  // namespace
+
+int
+main(int argc, char** argv) {
+    auto opt = ParseOptions(argc, argv);
+    if (opt.build_pool > 0) {
+        knowhere::KnowhereConfig::SetBuildThreadPoolSize(opt.build_pool);
+    }
+    if (opt.search_pool > 0) {
+        knowhere::KnowhereConfig::SetSearchThreadPoolSize(opt.search_pool);
+    }
+
+    knowhere::Json report;
+    report["options"] = {
+        {"data", opt.data},
+        {"index", opt.index},
+        {"metric", opt.metric},
+        {"dim", opt.dim},
+        {"nb", opt.nb},
+        {"nq", opt.nq},
+        {"k", opt.k},
+        {"clusters", opt.clusters},
+        {"filter_ratio", opt.filter_ratio},
+        {"duration_s", opt.duration},
+        {"seed", opt.seed},
+        {"build_params", opt.build_params},
+        {"search_params", opt.search_params},
+    };
+    if (opt.data == "sparse") {
+        report["options"]["avg_nnz"] = opt.avg_nnz;
+        report["options"]["query_nnz"] = opt.query_nnz;
+    } else if (opt.data == "emb_list") {
+        report["options"]["el_len"] = opt.el_len;
+    }
+
+    try {
+        Workload w;
+        fprintf(stderr, "generating %s data\n", opt.data.c_str());
+        if (opt.data == "dense") {
+            GenDense(opt, w);
+        } else if (opt.data == "binary") {
+            GenBinary(opt, w);
+        } else if (opt.data == "sparse") {
+            GenSparse(opt, w);
+        } else {
+            GenEmbList(opt, w);
+        }
+        report["peak_rss_after_data_kb"] = PeakRssKB();
+
+        knowhere::Json result;
+        if (opt.data == "binary") {
+            result = Runner<knowhere::bin1>(opt, w).Run();
+        } else if (opt.data == "sparse") {
+            result = Runner<knowhere::sparse_u32_f32>(opt, w).Run();
+        } else {
+            result = Runner<knowhere::fp32>(opt, w).Run();
+        }
+        report.update(result);
+    } catch (const std::exception& e) {
+        fprintf(stderr, "error: %s\n", e.what());
+        return 1;
+    }
+    report["peak_rss_kb"] = PeakRssKB();
+
+    if (opt.output.empty()) {
+        printf("%s\n", report.dump(2).c_str());
+    } else {
+        std::ofstream(opt.output) << report.dump(2) << std::endl;
+    }
+    return 0;
+}
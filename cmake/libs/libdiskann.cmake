@@ -5,13 +5,14 @@ find_package(aio REQUIRED)
 include_directories(${AIO_INCLUDE})
 find_package(fmt REQUIRED)
 
-include_directories(${URING_INCLUDE})
+find_package(liburing REQUIRED)
 include_directories(thirdparty/DiskANN/include)
 
 find_package(double-conversion REQUIRED)
 include_directories(${double-conversion_INCLUDE_DIRS})
 
 set(DISKANN_SOURCES
+    thirdparty/DiskANN/src/adaptive_node_cache.cpp
     thirdparty/DiskANN/src/ann_exception.cpp
     thirdparty/DiskANN/src/aux_utils.cpp
     thirdparty/DiskANN/src/distance.cpp
@@ -22,13 +23,14 @@ set(DISKANN_SOURCES
     thirdparty/DiskANN/src/partition_and_pq.cpp
     thirdparty/DiskANN/src/pq_flash_index.cpp
     thirdparty/DiskANN/src/pq_flash_aisaq_index.cpp
+    thirdparty/DiskANN/src/uring_aligned_file_reader.cpp
     thirdparty/DiskANN/src/aisaq_utils.cpp
     thirdparty/DiskANN/src/aisaq_pq_reader.cpp
     thirdparty/DiskANN/src/logger.cpp
     thirdparty/DiskANN/src/utils.cpp)
 
 find_package(folly REQUIRED)
-set(DISKANN_LINKER_LIBS PUBLIC ${AIO_LIBRARIES} ${DISKANN_BOOST_PROGRAM_OPTIONS_LIB} nlohmann_json::nlohmann_json
+set(DISKANN_LINKER_LIBS PUBLIC ${AIO_LIBRARIES} liburing::liburing ${DISKANN_BOOST_PROGRAM_OPTIONS_LIB} nlohmann_json::nlohmann_json
          	Folly::folly fmt::fmt-header-only prometheus-cpp::core prometheus-cpp::push glog::glog)
 if (WITH_CUVS)
     list(APPEND DISKANN_LINKER_LIBS PRIVATE cuvs::cuvs)
@@ -39,6 +41,7 @@ add_library(diskann STATIC ${DISKANN_SOURCES})
 target_link_libraries(
   diskann
   PUBLIC ${AIO_LIBRARIES}
+         liburing::liburing
          ${DISKANN_BOOST_PROGRAM_OPTIONS_LIB}
          nlohmann_json::nlohmann_json
          Folly::folly
@@ -61,15 +61,29 @@ if(__X86_64)
   target_compile_options(utils_avx512 PRIVATE -mfma -mf16c -mavx512f -mavx512dq
                                               -mavx512bw -mpopcnt -mavx512vl)
   target_compile_options(utils_avx512icx PRIVATE -mfma -mf16c -mavx512f -mavx512dq
-                                              -mavx512bw -mpopcnt -mavx512vl -mavx512vpopcntdq)
+                                              -mavx512bw -mpopcnt -mavx512vl -mavx512vpopcntdq -mavx512vnni)
   target_compile_options(sparse_simd_avx512 PRIVATE -mavx512f -mavx512dq)
   target_include_directories(sparse_simd_avx512 PRIVATE ${Boost_INCLUDE_DIRS})
 
+  # the VEX encoded AVX-VNNI needs gcc 11 or clang 12
+  check_cxx_compiler_flag("-mavxvnni" HAS_AVXVNNI)
+  set(UTILS_AVXVNNI_OBJS)
+  if(HAS_AVXVNNI)
+    add_library(utils_avxvnni OBJECT src/simd/distances_avxvnni.cc)
+    target_compile_options(utils_avxvnni PRIVATE -mfma -mf16c -mavx2 -mavxvnni)
+    set(UTILS_AVXVNNI_OBJS $<TARGET_OBJECTS:utils_avxvnni>)
+  else()
+    message(STATUS "AVX-VNNI: Not Found")
+  endif()
+
   add_library(
     knowhere_utils STATIC
     ${UTILS_SRC} $<TARGET_OBJECTS:utils_sse> $<TARGET_OBJECTS:utils_avx>
     $<TARGET_OBJECTS:utils_avx512> $<TARGET_OBJECTS:utils_avx512icx>
-    $<TARGET_OBJECTS:sparse_simd_avx512>)
+    $<TARGET_OBJECTS:sparse_simd_avx512> ${UTILS_AVXVNNI_OBJS})
+  if(HAS_AVXVNNI)
+    target_compile_definitions(knowhere_utils PRIVATE KNOWHERE_WITH_AVXVNNI)
+  endif()
   target_link_libraries(knowhere_utils PUBLIC glog::glog)
   target_link_libraries(knowhere_utils PUBLIC xxHash::xxhash)
 endif()
@@ -78,7 +92,8 @@ if(__AARCH64)
 
   set(UTILS_SRC src/simd/distances_ref.cc src/simd/distances_neon.cc)
   set(UTILS_SVE_SRC src/simd/hook.cc src/simd/distances_sve.cc)
-  set(ALL_UTILS_SRC ${UTILS_SRC} ${UTILS_SVE_SRC})
+  set(UTILS_DOTPROD_SRC src/simd/distances_neon_dotprod.cc)
+  set(ALL_UTILS_SRC ${UTILS_SRC} ${UTILS_SVE_SRC} ${UTILS_DOTPROD_SRC})
 
   add_library(
     knowhere_utils STATIC
@@ -147,6 +162,15 @@ if(__AARCH64)
     target_compile_options(knowhere_utils PRIVATE -march=armv8-a)
   endif()
 
+  check_cxx_compiler_flag("-march=armv8.2-a+dotprod" HAS_ARMV8_DOTPROD)
+  if (HAS_ARMV8_DOTPROD)
+    message(STATUS "Dot product for ARMv8.2: Found")
+    set_source_files_properties(${UTILS_DOTPROD_SRC} PROPERTIES COMPILE_OPTIONS "-march=armv8.2-a+dotprod")
+    target_compile_definitions(knowhere_utils PRIVATE KNOWHERE_WITH_NEON_DOTPROD)
+  else()
+    message(STATUS "Dot product for ARMv8.2: Not Found")
+  endif()
+
   target_link_libraries(knowhere_utils PUBLIC glog::glog)
   target_link_libraries(knowhere_utils PUBLIC xxHash::xxhash)
 endif()
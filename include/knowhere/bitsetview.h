@@ -12,11 +12,13 @@
 #ifndef BITSET_H
 #define BITSET_H
 
+#include <algorithm>
 #include <cassert>
 #include <cstdint>
 #include <optional>
 #include <sstream>
 #include <string>
+#include <utility>
 
 namespace knowhere {
 class BitsetView {
@@ -51,6 +53,9 @@ class BitsetView {
         if (out_ids_ != nullptr) {
             return num_filtered_out_ids_;
         }
+        if (has_allow_list()) {
+            return get_filtered_out_num_();
+        }
         return num_filtered_out_bits_;
     }
 
@@ -82,6 +87,45 @@ class BitsetView {
         }
     }
 
+    // the allow list is an optional sorted copy of the bits that are NOT set, for filters that keep only a handful of
+    // rows (e.g. a single tenant). the bitmap stays authoritative for test(), the list lets brute-force paths visit the
+    // allowed rows directly and spares the popcount in count(). ignored when the bitset has an id mapping.
+    void
+    set_allow_list(const uint32_t* allow_ids, size_t num_allow_ids) {
+        assert(std::is_sorted(allow_ids, allow_ids + num_allow_ids));
+        allow_ids_ = allow_ids;
+        num_allow_ids_ = num_allow_ids;
+    }
+
+    bool
+    has_allow_list() const {
+        return allow_ids_ != nullptr && out_ids_ == nullptr;
+    }
+
+    const uint32_t*
+    allow_list_data() const {
+        return allow_ids_;
+    }
+
+    size_t
+    allow_list_size() const {
+        return num_allow_ids_;
+    }
+
+    // call fn(internal_id) for every allowed internal id in [0, limit), in ascending order. requires has_allow_list().
+    template <typename Fn>
+    void
+    for_each_allowed(size_t limit, Fn&& fn) const {
+        auto end = allow_ids_ + num_allow_ids_;
+        for (auto it = std::lower_bound(allow_ids_, end, id_offset_); it != end; ++it) {
+            size_t id = *it - id_offset_;
+            if (id >= limit) {
+                break;
+            }
+            fn(id);
+        }
+    }
+
     const uint32_t*
     out_ids_data() const {
         if (out_ids_ == nullptr) {
@@ -116,6 +160,10 @@ class BitsetView {
         if (empty()) {
             return 0;
         }
+        if (has_allow_list()) {
+            auto [first, last] = allowed_range_();
+            return num_bits_ - (last - first);
+        }
         if (out_ids_ != nullptr) {
             // if with id mapping, there is no optimization for the traversal.
             size_t count = 0;
@@ -166,6 +214,10 @@ class BitsetView {
             }
             return num_internal_ids_;
         }
+        if (has_allow_list()) {
+            auto [first, last] = allowed_range_();
+            return first == last ? num_bits_ : *first - id_offset_;
+        }
         // if without id mapping, use a better algorithm to find the first valid index.
         size_t ret = 0;
         auto len_uint8 = byte_size();
@@ -211,6 +263,16 @@ class BitsetView {
     }
 
  private:
+    // the allowed ids that map to an index of this view: the ids in [id_offset_, id_offset_ + num_bits_), capped at
+    // num_bits_ as test() filters out every id past the bitmap.
+    std::pair<const uint32_t*, const uint32_t*>
+    allowed_range_() const {
+        auto end = allow_ids_ + num_allow_ids_;
+        auto first = std::lower_bound(allow_ids_, end, id_offset_);
+        auto last = std::lower_bound(first, end, std::max(id_offset_, num_bits_));
+        return {first, last};
+    }
+
     const uint8_t* bits_ = nullptr;
     size_t num_bits_ = 0;
     size_t num_filtered_out_bits_ = 0;
@@ -224,6 +286,10 @@ class BitsetView {
     const uint32_t* out_ids_ = nullptr;
     size_t num_internal_ids_ = 0;
     size_t num_filtered_out_ids_ = 0;
+
+    // optional. sorted ids of the bits that are not set, see set_allow_list().
+    const uint32_t* allow_ids_ = nullptr;
+    size_t num_allow_ids_ = 0;
 };
 }  // namespace knowhere
 
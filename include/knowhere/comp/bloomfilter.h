@@ -10,79 +10,143 @@
 #ifndef KNOWHERE_KNOWHERE_H
 #define KNOWHERE_KNOWHERE_H
 #include <cmath>
+#include <cstdint>
 #include <cstring>
 #include <fstream>
 #include <functional>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
 #include <vector>
 
 #include "io/memory_io.h"
 #include "knowhere/bitsetview.h"
 #include "knowhere/utils.h"
 namespace knowhere {
+
+// A cache-line blocked Bloom filter.
+//
+// Every key owns one 64-byte block and sets one bit in each of the block's eight words, the bit being picked by
+// multiplying the key hash with a per-word odd constant. A lookup therefore touches a single cache line and tests the
+// eight words without branches or modulo operations, which compiles to a handful of SIMD instructions. The number of
+// blocks is a power of two, so the block is selected by masking the hash.
+//
+// add() may run concurrently with other add() calls. The blocks are serialized at a 64-byte aligned offset of the
+// blob, so that load() can also view them in place, e.g. from a mmapped file. Filters saved with the former
+// bit-per-position layout are still loaded and queried as they were written.
 template <typename T>
 class BloomFilter {
  public:
     explicit BloomFilter(size_t expected_elements, double false_positive_prob)
         : n(expected_elements), p(false_positive_prob) {
-        m = static_cast<size_t>(-(n * log(p)) / (log(2) * log(2)));
-        k = static_cast<int>(m / n * log(2));
-        m = std::max<size_t>(m, 1);
-        k = std::max(k, 1);
-        bits.resize(m, false);
+        // bits of a classic filter for (n, p), rounded up to whole blocks
+        const double n_ = std::max<size_t>(n, 1);
+        const auto bits = static_cast<size_t>(-(n_ * log(p)) / (log(2) * log(2)));
+        size_t blocks = 1;
+        while (blocks * kBlockBits < bits) {
+            blocks <<= 1;
+        }
+        allocate(blocks);
     }
 
+    BloomFilter(BloomFilter&&) noexcept = default;
+    BloomFilter&
+    operator=(BloomFilter&&) noexcept = default;
+
     void
     add(const T& element) {
-        size_t glb_hash = hash((const char*)&element, sizeof(element), 0);
-        for (int i = 0; i < k; ++i) {
-            size_t pos = (glb_hash + i) % m;
-            bits[pos] = true;
+        if (owned_blocks_ == nullptr) {
+            throw std::runtime_error("can't add to a bloom filter viewing external data.");
+        }
+        const uint64_t h = hash(element);
+        auto& block = owned_blocks_[h & block_mask_];
+        const auto x = static_cast<uint32_t>(h >> 32);
+        for (size_t i = 0; i < kWordsPerBlock; ++i) {
+            const uint64_t bit = uint64_t{1} << ((x * kSalt[i]) >> 26);
+            if ((block.words[i] & bit) == 0) {
+                __atomic_fetch_or(&block.words[i], bit, __ATOMIC_RELAXED);
+            }
         }
     }
 
     bool
     contains(const T& element) const {
-        size_t glb_hash = hash((const char*)&element, sizeof(element), 0);
-        for (int i = 0; i < k; ++i) {
-            size_t pos = (glb_hash + i) % m;
-            if (!bits[pos])
-                return false;
+        if (legacy_) {
+            return legacy_contains(element);
+        }
+        const uint64_t h = hash(element);
+        const auto& block = blocks_[h & block_mask_];
+        const auto x = static_cast<uint32_t>(h >> 32);
+        uint64_t missing = 0;
+        for (size_t i = 0; i < kWordsPerBlock; ++i) {
+            missing |= ~block.words[i] & (uint64_t{1} << ((x * kSalt[i]) >> 26));
+        }
+        return missing == 0;
+    }
+
+    // pulls the block of `element` into the cache ahead of contains()
+    void
+    prefetch(const T& element) const {
+        if (!legacy_) {
+            __builtin_prefetch(&blocks_[hash(element) & block_mask_]);
         }
-        return true;
     }
 
     void
     save(MemoryIOWriter& writer) const {
-        writeBinaryPOD(writer, m);
-        writeBinaryPOD(writer, k);
+        if (legacy_) {
+            writeBinaryPOD(writer, legacy_m_);
+            writeBinaryPOD(writer, legacy_k_);
+            writeBinaryPOD(writer, n);
+            writeBinaryPOD(writer, p);
+            writer.write(legacy_bits_.data(), legacy_bits_.size());
+            return;
+        }
+        writeBinaryPOD(writer, kBlockedMagic);
+        writeBinaryPOD(writer, kBlockedVersion);
         writeBinaryPOD(writer, n);
         writeBinaryPOD(writer, p);
-        auto bytes_num = (m + 8 - 1) / 8;
-        std::vector<char> buffer(bytes_num, 0);
-        for (size_t i = 0; i < m; ++i) {
-            if (bits[i]) {
-                buffer[i / 8] |= (1 << (i % 8));
-            }
-        }
-        writer.write(buffer.data(), buffer.size());
+        writeBinaryPOD(writer, num_blocks_);
+        const std::vector<char> padding(padding_to_block(writer.tellg()), 0);
+        writer.write(padding.data(), padding.size());
+        writer.write((const char*)blocks_, num_blocks_ * sizeof(Block));
     }
 
+    // with `view`, the blocks are used in place when the reader's buffer is suitably aligned, and that buffer has to
+    // outlive the filter
     void
-    load(MemoryIOReader& reader) {
-        readBinaryPOD(reader, m);
-        readBinaryPOD(reader, k);
+    load(MemoryIOReader& reader, bool view = false) {
+        size_t head;
+        readBinaryPOD(reader, head);
+        if (head != kBlockedMagic) {
+            load_legacy(reader, head);
+            return;
+        }
+        uint32_t version;
+        size_t blocks;
+        readBinaryPOD(reader, version);
         readBinaryPOD(reader, n);
         readBinaryPOD(reader, p);
-        bits.clear();
-        bits.resize(m);
-        auto bytes_num = (m + 8 - 1) / 8;
-        std::vector<char> buffer(bytes_num);
-        reader.read(buffer.data(), bytes_num);
-        for (size_t i = 0; i < m; ++i) {
-            bool bit = (buffer[i / 8] >> (i % 8)) & 1;
-            bits.push_back(bit);
+        readBinaryPOD(reader, blocks);
+        if (version != kBlockedVersion || blocks == 0 || (blocks & (blocks - 1)) != 0) {
+            throw std::runtime_error("invalid bloom filter data.");
+        }
+        reader.advance(padding_to_block(reader.tellg()));
+        const uint8_t* data = reader.data() + reader.tellg();
+        legacy_ = false;
+        if (view && reinterpret_cast<uintptr_t>(data) % alignof(Block) == 0) {
+            owned_blocks_.reset();
+            blocks_ = reinterpret_cast<const Block*>(data);
+            num_blocks_ = blocks;
+            block_mask_ = blocks - 1;
+            reader.advance(blocks * sizeof(Block));
+        } else {
+            allocate(blocks);
+            reader.read((char*)owned_blocks_.get(), blocks * sizeof(Block));
         }
     }
+
     size_t
     size() const {
         return n;
@@ -93,27 +157,105 @@ class BloomFilter {
     }
     size_t
     memory_usage() const {
-        return m / 8;
+        return legacy_ ? legacy_bits_.size() : num_blocks_ * sizeof(Block);
     }
 
  private:
-    static constexpr size_t multiplier = 31;
-    std::vector<bool> bits;
+    static constexpr size_t kWordsPerBlock = 8;
+    static constexpr size_t kBlockBits = kWordsPerBlock * 64;
+    static constexpr size_t kBlockedMagic = std::numeric_limits<size_t>::max();
+    static constexpr uint32_t kBlockedVersion = 1;
+    // odd constants from the split block Bloom filter of Apache Parquet
+    static constexpr uint32_t kSalt[kWordsPerBlock] = {0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+                                                        0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U};
+
+    struct alignas(64) Block {
+        uint64_t words[kWordsPerBlock];
+    };
+
+    std::unique_ptr<Block[]> owned_blocks_;
+    const Block* blocks_ = nullptr;
+    size_t num_blocks_ = 0;
+    size_t block_mask_ = 0;
     size_t n = 0;
     double p = 0.0;
-    size_t m = 0;
-    int k = 0;
 
-    size_t
-    hash(const char* data, size_t length, size_t bucket_i) const {
-        if (data == nullptr) {
-            throw std::runtime_error("can't hash null data.");
+    // the former layout, kept for loaded filters only
+    static constexpr size_t multiplier = 31;
+    bool legacy_ = false;
+    std::vector<uint8_t> legacy_bits_;
+    size_t legacy_m_ = 0;
+    int legacy_k_ = 0;
+
+    void
+    allocate(size_t blocks) {
+        owned_blocks_ = std::make_unique<Block[]>(blocks);
+        blocks_ = owned_blocks_.get();
+        num_blocks_ = blocks;
+        block_mask_ = blocks - 1;
+    }
+
+    static size_t
+    padding_to_block(size_t pos) {
+        return (sizeof(Block) - pos % sizeof(Block)) % sizeof(Block);
+    }
+
+    static uint64_t
+    mix(uint64_t x) {
+        x ^= x >> 33;
+        x *= 0xff51afd7ed558ccdULL;
+        x ^= x >> 33;
+        x *= 0xc4ceb9fe1a85ec53ULL;
+        x ^= x >> 33;
+        return x;
+    }
+
+    static uint64_t
+    hash(const T& element) {
+        if constexpr (std::is_integral_v<T> && sizeof(T) <= sizeof(uint64_t)) {
+            return mix(static_cast<uint64_t>(element));
+        } else {
+            const char* data = (const char*)&element;
+            uint64_t h = sizeof(T);
+            for (size_t i = 0; i < sizeof(T); i += sizeof(uint64_t)) {
+                uint64_t word = 0;
+                std::memcpy(&word, data + i, std::min(sizeof(uint64_t), sizeof(T) - i));
+                h = mix(h ^ word);
+            }
+            return h;
         }
+    }
+
+    void
+    load_legacy(MemoryIOReader& reader, size_t m) {
+        legacy_ = true;
+        legacy_m_ = m;
+        readBinaryPOD(reader, legacy_k_);
+        readBinaryPOD(reader, n);
+        readBinaryPOD(reader, p);
+        legacy_bits_.resize((m + 8 - 1) / 8);
+        reader.read((char*)legacy_bits_.data(), legacy_bits_.size());
+        owned_blocks_.reset();
+        blocks_ = nullptr;
+        num_blocks_ = 0;
+        block_mask_ = 0;
+    }
+
+    bool
+    legacy_contains(const T& element) const {
+        const char* data = (const char*)&element;
         size_t result = 0;
-        for (size_t i = 0; i < length; ++i) {
+        for (size_t i = 0; i < sizeof(element); ++i) {
             result = (result * multiplier) + static_cast<size_t>(data[i]);
         }
-        return (result + bucket_i) % m;
+        const size_t glb_hash = result % legacy_m_;
+        for (int i = 0; i < legacy_k_; ++i) {
+            const size_t pos = (glb_hash + i) % legacy_m_;
+            if (!((legacy_bits_[pos / 8] >> (pos % 8)) & 1)) {
+                return false;
+            }
+        }
+        return true;
     }
 };
 }  // namespace knowhere
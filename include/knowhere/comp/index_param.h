@@ -65,6 +65,7 @@ constexpr const char* INDEX_SPARSE_INVERTED_INDEX = "SPARSE_INVERTED_INDEX";
 constexpr const char* INDEX_SPARSE_WAND = "SPARSE_WAND";
 constexpr const char* INDEX_SPARSE_INVERTED_INDEX_CC = "SPARSE_INVERTED_INDEX_CC";
 constexpr const char* INDEX_SPARSE_WAND_CC = "SPARSE_WAND_CC";
+constexpr const char* INDEX_SPARSE_SEISMIC = "SPARSE_SEISMIC";
 
 constexpr const char* INDEX_CARDINAL_TIERED = "CARDINAL_TIERED";
 }  // namespace IndexEnum
@@ -183,8 +184,11 @@ constexpr const char* PQ_CODE_BUDGET_GB = "pq_code_budget_gb";
 constexpr const char* BUILD_DRAM_BUDGET_GB = "build_dram_budget_gb";
 constexpr const char* BEAMWIDTH = "beamwidth";
 constexpr const char* SEARCH_CACHE_BUDGET_GB = "search_cache_budget_gb";
+constexpr const char* SEARCH_CACHE_ADAPTIVE_RATIO = "search_cache_adaptive_ratio";
+constexpr const char* DELTA_MAX_POINTS = "delta_max_points";
 constexpr const char* SEARCH_LIST_SIZE = "search_list_size";
 constexpr const char* DISK_PQ_DIMS = "disk_pq_dims";
+constexpr const char* QUERIES_PER_THREAD = "queries_per_thread";
 
 // AISAQ Params
 constexpr const char* REARRANGE = "rearrange";
@@ -198,13 +202,20 @@ constexpr const char* VECTORS_BEAMWIDTH = "vectors_beamwidth";
 constexpr const char* HNSW_REFINE = "refine";
 constexpr const char* HNSW_REFINE_K = "refine_k";
 constexpr const char* HNSW_REFINE_TYPE = "refine_type";
+constexpr const char* HNSW_REORDER = "reorder";
 constexpr const char* SQ_TYPE = "sq_type";  // for IVF_SQ and HNSW_SQ
 constexpr const char* PRQ_NUM = "nrq";      // for PRQ, number of redisual quantizers
 
 // Sparse Inverted Index Params
 constexpr const char* INVERTED_INDEX_ALGO = "inverted_index_algo";
+constexpr const char* INVERTED_INDEX_COMPRESSION = "inverted_index_compression";
+constexpr const char* INVERTED_INDEX_DOC_REORDER = "inverted_index_doc_reorder";
 constexpr const char* DROP_RATIO_BUILD = "drop_ratio_build";
 constexpr const char* DROP_RATIO_SEARCH = "drop_ratio_search";
+constexpr const char* SEISMIC_N_POSTINGS = "seismic_n_postings";
+constexpr const char* SEISMIC_CENTROID_FRACTION = "seismic_centroid_fraction";
+constexpr const char* SEISMIC_SUMMARY_ENERGY = "seismic_summary_energy";
+constexpr const char* SEISMIC_HEAP_FACTOR = "seismic_heap_factor";
 
 // RaBitQ Params
 constexpr const char* RABITQ_QUERY_BITS = "rbq_bits_query";
@@ -223,6 +234,11 @@ constexpr const char* MH_LSH_BATCH_SEARCH = "mh_lsh_batch_search";
 
 // Emb List Index Params
 constexpr const char* RETRIEVAL_ANN_RATIO = "retrieval_ann_ratio";
+
+// KMeans Cluster Params, the number of iterations is KMEANS_N_ITERS
+constexpr const char* NUM_CLUSTERS = "num_clusters";
+constexpr const char* KMEANS_INIT = "kmeans_init";
+constexpr const char* KMEANS_BATCH_SIZE = "kmeans_batch_size";
 }  // namespace indexparam
 
 using MetricType = std::string;
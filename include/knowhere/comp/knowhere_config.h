@@ -95,6 +95,20 @@ class KnowhereConfig {
     static bool
     SetAioContextPool(size_t num_ctx);
 
+    enum DiskIOEngine {
+        AIO = 0,  // libaio (default)
+        URING,    // io_uring with registered files and buffers
+    };
+
+    /**
+     * Selects the I/O engine of DiskANN/AiSAQ indexes loaded afterwards. The io_uring engine still takes its contexts
+     * from the aio context pool, so `SetAioContextPool` keeps bounding the number of in-flight searches. `sqpoll`
+     * lets a shared kernel thread poll the submission queues instead of issuing a syscall per batch. Returns false
+     * and keeps libaio if io_uring is not available on this kernel.
+     */
+    static bool
+    SetDiskIOEngine(const DiskIOEngine engine, bool sqpoll = false);
+
     static void
     SetBuildThreadPoolSize(size_t num_threads);
     static size_t
@@ -550,6 +550,11 @@ class Config {
         return cfg.CheckAndAdjust(type, err_msg);
     }
 
+    // Copies the value of every param of `src` into the param of the same name of `dst`, which is expected to be a
+    // config of the same type. Lets a loaded config be instantiated again without going through json.
+    static void
+    CopyValues(const Config& src, Config& dst);
+
     virtual ~Config() {
     }
 
@@ -604,6 +609,7 @@ class BaseConfig : public Config {
     CFG_BOOL trace_visit;
     CFG_BOOL enable_mmap;
     CFG_BOOL enable_mmap_pop;
+    CFG_BOOL enable_zero_copy;
     CFG_BOOL shuffle_build;
     CFG_STRING trace_id;
     CFG_STRING span_id;
@@ -706,6 +712,11 @@ class BaseConfig : public Config {
             .description("enable map_populate option for mmap")
             .for_deserialize()
             .for_deserialize_from_file();
+        KNOWHERE_CONFIG_DECLARE_FIELD(enable_zero_copy)
+            .set_default(false)
+            .description("load index arrays as views into the binary set instead of copying them, the index then "
+                         "keeps the binary alive and cannot be modified")
+            .for_deserialize();
         KNOWHERE_CONFIG_DECLARE_FIELD(shuffle_build)
             .set_default(true)
             .description("shuffle ids before index building")
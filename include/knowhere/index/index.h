@@ -20,6 +20,45 @@
 #include "knowhere/index/interrupt.h"
 namespace knowhere {
 
+/**
+ * @brief A search config that has been checked and loaded once, to be reused by many searches.
+ *
+ * Search, RangeSearch and AnnIterator normally format, load and check the json config on every call. A plan does this
+ * once in Index::PrepareSearch, and searching with it only instantiates the loaded config. A plan is immutable and can
+ * be shared across threads and across indexes of the type it was prepared for.
+ */
+class SearchPlan {
+ public:
+    PARAM_TYPE
+    ParamType() const {
+        return param_type_;
+    }
+
+    const BaseConfig&
+    Cfg() const {
+        return *cfg_;
+    }
+
+ private:
+    template <typename T>
+    friend class Index;
+
+    std::string index_type_;
+    PARAM_TYPE param_type_ = PARAM_TYPE::SEARCH;
+    // the formatted json, used again only if the plan is instantiated with a different k
+    Json json_;
+    std::unique_ptr<BaseConfig> cfg_;
+};
+using SearchPlanPtr = std::shared_ptr<const SearchPlan>;
+
+// The params of a prepared search that can change from call to call, the filter being the bitset argument.
+struct SearchPlanOverrides {
+    std::optional<int32_t> k;
+    std::optional<std::string> trace_id;
+    std::optional<std::string> span_id;
+    std::optional<int32_t> trace_flags;
+};
+
 template <typename T1>
 class Index {
  public:
@@ -169,6 +208,24 @@ class Index {
     RangeSearch(const DataSetPtr dataset, const Json& json, const BitsetView& bitset,
                 milvus::OpContext* op_context = nullptr) const;
 
+    // Checks and loads `json` for searches of the given type (SEARCH, RANGE_SEARCH or ITERATOR) once, the returned
+    // plan is then passed to the overloads below in place of the json.
+    expected<SearchPlanPtr>
+    PrepareSearch(const Json& json, PARAM_TYPE param_type = PARAM_TYPE::SEARCH) const;
+
+    expected<DataSetPtr>
+    Search(const DataSetPtr dataset, const SearchPlan& plan, const BitsetView& bitset,
+           const SearchPlanOverrides& overrides = {}, milvus::OpContext* op_context = nullptr) const;
+
+    expected<std::vector<IndexNode::IteratorPtr>>
+    AnnIterator(const DataSetPtr dataset, const SearchPlan& plan, const BitsetView& bitset,
+                const SearchPlanOverrides& overrides = {}, bool use_knowhere_search_pool = true,
+                milvus::OpContext* op_context = nullptr) const;
+
+    expected<DataSetPtr>
+    RangeSearch(const DataSetPtr dataset, const SearchPlan& plan, const BitsetView& bitset,
+                const SearchPlanOverrides& overrides = {}, milvus::OpContext* op_context = nullptr) const;
+
     expected<DataSetPtr>
     GetVectorByIds(const DataSetPtr dataset, milvus::OpContext* op_context = nullptr) const;
 
@@ -187,6 +244,12 @@ class Index {
     Status
     Serialize(BinarySet& binset) const;
 
+    // Writes the index to a file that DeserializeFromFile can load, without an intermediate BinarySet for the index
+    // types that support streaming. The emb_list meta is not part of the file, it is loaded from
+    // emb_list_meta_file_path.
+    Status
+    SerializeToFile(const std::string& filename, bool direct_io = false) const;
+
     Status
     Deserialize(const BinarySet& binset, const Json& json = {});
 
@@ -223,6 +286,22 @@ class Index {
         static_assert(std::is_base_of<IndexNode, T1>::value);
     }
 
+    Status
+    InstantiatePlan(const SearchPlan& plan, PARAM_TYPE param_type, const SearchPlanOverrides& overrides,
+                    std::unique_ptr<BaseConfig>& cfg, std::string* msg) const;
+
+    expected<DataSetPtr>
+    SearchWithConfig(const DataSetPtr dataset, std::unique_ptr<BaseConfig> cfg, const BitsetView& bitset,
+                     milvus::OpContext* op_context) const;
+
+    expected<std::vector<IndexNode::IteratorPtr>>
+    AnnIteratorWithConfig(const DataSetPtr dataset, std::unique_ptr<BaseConfig> cfg, const BitsetView& bitset,
+                          bool use_knowhere_search_pool, milvus::OpContext* op_context) const;
+
+    expected<DataSetPtr>
+    RangeSearchWithConfig(const DataSetPtr dataset, std::unique_ptr<BaseConfig> cfg, const BitsetView& bitset,
+                          milvus::OpContext* op_context) const;
+
     T1* node;
 };
 
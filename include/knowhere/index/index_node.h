@@ -246,6 +246,19 @@ class IndexNode : public Object {
     virtual Status
     Serialize(BinarySet& binset) const = 0;
 
+    /**
+     * @brief Serializes the index straight into a file that `DeserializeFromFile` can load.
+     *
+     * Indexes that can stream their serialization override this to write through a buffered file writer without
+     * materializing the index in memory. The default goes through `Serialize` and writes the single resulting binary.
+     *
+     * @param filename Path of the file to (over)write.
+     * @param direct_io Bypass the page cache with O_DIRECT where the filesystem supports it.
+     * @return Status indicating success or failure of the serialization.
+     */
+    virtual Status
+    SerializeToFile(const std::string& filename, bool direct_io = false) const;
+
     /**
      * @brief Deserializes the index from a binary set.
      *
@@ -0,0 +1,671 @@
+// Copyright (C) 2019-2023 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License.
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <unordered_set>
+#include <vector>
+
+#include "cluster/kmeans/kmeans_config.h"
+#include "faiss/cppcontrib/knowhere/Clustering.h"
+#include "faiss/cppcontrib/knowhere/utils/distances_tiled.h"
+#include "knowhere/cluster/cluster_factory.h"
+#include "knowhere/cluster/cluster_node.h"
+#include "knowhere/comp/task.h"
+#include "knowhere/comp/time_recorder.h"
+#include "knowhere/dataset.h"
+#include "knowhere/expected.h"
+#include "knowhere/log.h"
+#include "knowhere/utils.h"
+#include "simd/hook.h"
+
+namespace knowhere {
+
+namespace {
+
+// rows widened to float and assigned together
+constexpr int64_t kBlockRows = 4096;
+// below this many centroids the distances of each row are computed directly, from here on they go through
+// sgemm tiles
+constexpr int64_t kGemmMinClusters = 64;
+// k-means++ seeds from a sample of this many rows per cluster
+constexpr int64_t kInitSamplePerCluster = 16;
+// upper bound of the centroid sums held by all tasks at once while a full iteration assigns the rows
+constexpr int64_t kSumBufferBytes = 1LL << 30;
+constexpr uint64_t kSeed = 1234;
+
+// Rows of a dense dataset, either a single tensor or chunks delimited by meta::EMB_LIST_OFFSET. Rows are widened to
+// float block by block, so the data is never converted or copied as a whole.
+template <typename DataType>
+class RowReader {
+ public:
+    explicit RowReader(const DataSet& dataset) : rows_(dataset.GetRows()), dim_(dataset.GetDim()) {
+        if (dataset.GetIsChunk()) {
+            chunks_ = (const DataType* const*)dataset.GetTensor();
+            lims_ = dataset.Get<const size_t*>(meta::EMB_LIST_OFFSET);
+            num_chunk_ = dataset.GetNumChunk();
+        } else {
+            data_ = (const DataType*)dataset.GetTensor();
+        }
+    }
+
+    int64_t
+    rows() const {
+        return rows_;
+    }
+
+    int64_t
+    dim() const {
+        return dim_;
+    }
+
+    // widens rows [begin, end) into out
+    void
+    Read(int64_t begin, int64_t end, float* out) const {
+        if (data_ != nullptr) {
+            Widen(data_ + begin * dim_, (end - begin) * dim_, out);
+            return;
+        }
+        int64_t chunk = std::upper_bound(lims_, lims_ + num_chunk_ + 1, (size_t)begin) - lims_ - 1;
+        while (begin < end) {
+            const int64_t chunk_end = std::min<int64_t>(end, lims_[chunk + 1]);
+            Widen(chunks_[chunk] + (begin - lims_[chunk]) * dim_, (chunk_end - begin) * dim_, out);
+            out += (chunk_end - begin) * dim_;
+            begin = chunk_end;
+            chunk++;
+        }
+    }
+
+    // widens the rows `ids` into out
+    void
+    Gather(const int64_t* ids, int64_t n, float* out) const {
+        for (int64_t i = 0; i < n; i++) {
+            Read(ids[i], ids[i] + 1, out + i * dim_);
+        }
+    }
+
+ private:
+    static void
+    Widen(const DataType* src, int64_t n, float* dst) {
+        if constexpr (std::is_same_v<DataType, fp32>) {
+            std::copy(src, src + n, dst);
+        } else {
+            for (int64_t i = 0; i < n; i++) {
+                dst[i] = static_cast<float>(src[i]);
+            }
+        }
+    }
+
+    int64_t rows_;
+    int64_t dim_;
+    const DataType* data_ = nullptr;
+    const DataType* const* chunks_ = nullptr;
+    const size_t* lims_ = nullptr;
+    int64_t num_chunk_ = 0;
+};
+
+// runs fn(task, begin, end) over [0, n) split into at most `tasks` contiguous ranges
+template <typename Fn>
+void
+ParallelFor(const std::shared_ptr<ThreadPool>& pool, int64_t n, int64_t tasks, Fn&& fn) {
+    tasks = std::max<int64_t>(std::min(tasks, n), 1);
+    const int64_t step = (n + tasks - 1) / tasks;
+    std::vector<folly::Future<folly::Unit>> futs;
+    futs.reserve(tasks);
+    for (int64_t t = 0; t * step < n; t++) {
+        futs.emplace_back(pool->push([&, t] {
+            ThreadPool::ScopedBuildOmpSetter setter(1);
+            fn(t, t * step, std::min(n, (t + 1) * step));
+        }));
+    }
+    WaitAllSuccess(futs);
+}
+
+// distinct row ids in [0, n), sorted, so that they are read in storage order (Floyd's algorithm)
+std::vector<int64_t>
+SampleRows(int64_t n, int64_t count, std::mt19937_64& rng) {
+    std::unordered_set<int64_t> picked;
+    picked.reserve(count);
+    for (int64_t j = n - count; j < n; j++) {
+        const int64_t t = std::uniform_int_distribution<int64_t>(0, j)(rng);
+        picked.insert(picked.count(t) ? j : t);
+    }
+    std::vector<int64_t> ids(picked.begin(), picked.end());
+    std::sort(ids.begin(), ids.end());
+    return ids;
+}
+
+// Lloyd iterations with Hamerly's bounds, or mini-batch k-means, over the L2 distance.
+//
+// Every row keeps an upper bound of the distance to its centroid and a lower bound of the distance to any other
+// centroid. Both are moved by how far the centroids drifted, and only the rows whose bounds overlap are compared with
+// all centroids again, in blocks through SearchCentroids. Once the clusters settle, an iteration is mostly a pass
+// that reads the rows to sum them up.
+template <typename DataType>
+class Kmeans {
+ public:
+    Kmeans(const RowReader<DataType>& reader, int64_t k)
+        : reader_(reader),
+          k_(k),
+          dim_(reader.dim()),
+          pool_(ThreadPool::GetGlobalBuildThreadPool()),
+          centroids_(std::make_unique<float[]>(k * reader.dim())),
+          norms_(std::make_unique<float[]>(k)) {
+    }
+
+    void
+    Init(bool plus_plus) {
+        std::mt19937_64 rng(kSeed);
+        const auto n = reader_.rows();
+        if (!plus_plus) {
+            auto ids = SampleRows(n, k_, rng);
+            reader_.Gather(ids.data(), k_, centroids_.get());
+            return;
+        }
+
+        // k-means++ over a sample: every next centroid is drawn with a probability proportional to the squared
+        // distance to the closest centroid so far
+        auto ids = SampleRows(n, std::min(n, k_ * kInitSamplePerCluster), rng);
+        const int64_t m = ids.size();
+        auto x = std::make_unique<float[]>(m * dim_);
+        ParallelFor(pool_, m, pool_->size(), [&](int64_t, int64_t begin, int64_t end) {
+            reader_.Gather(ids.data() + begin, end - begin, x.get() + begin * dim_);
+        });
+        std::vector<float> min_dis(m, std::numeric_limits<float>::max());
+        int64_t pick = std::uniform_int_distribution<int64_t>(0, m - 1)(rng);
+        for (int64_t c = 0; c < k_; c++) {
+            if (c > 0) {
+                const double total = std::accumulate(min_dis.begin(), min_dis.end(), 0.0);
+                if (total > 0) {
+                    double r = std::uniform_real_distribution<double>(0, total)(rng);
+                    for (pick = 0; pick < m - 1 && r >= min_dis[pick]; pick++) {
+                        r -= min_dis[pick];
+                    }
+                } else {
+                    // all sampled rows coincide with a centroid already
+                    pick = std::uniform_int_distribution<int64_t>(0, m - 1)(rng);
+                }
+            }
+            const float* centroid = x.get() + pick * dim_;
+            std::copy(centroid, centroid + dim_, centroids_.get() + c * dim_);
+            ParallelFor(pool_, m, pool_->size(), [&](int64_t, int64_t begin, int64_t end) {
+                for (int64_t i = begin; i < end; i++) {
+                    min_dis[i] = std::min(min_dis[i],
+                                          faiss::cppcontrib::knowhere::fvec_L2sqr(x.get() + i * dim_, centroid, dim_));
+                }
+            });
+        }
+    }
+
+    // full iterations over all rows, labels are left consistent with the final centroids
+    void
+    Lloyd(int64_t n_iters, uint32_t* labels) {
+        const auto n = reader_.rows();
+        const int64_t nn = k_ > 1 ? 2 : 1;
+        std::vector<float> upper(n), lower(n);
+        std::vector<float> drift(k_, 0), half_gap(k_, std::numeric_limits<float>::max());
+        float max_drift = 0, second_drift = 0;
+        int64_t max_drift_id = -1;
+
+        // the assignment always runs on all threads. The rows are summed up while they are assigned when every task
+        // can hold the sums of all centroids within kSumBufferBytes, otherwise by SumByCentroid after the assignment.
+        const int64_t tasks = std::max<int64_t>(pool_->size(), 1);
+        const bool fused_sums = k_ * dim_ * (int64_t)sizeof(double) * tasks <= kSumBufferBytes;
+        std::vector<std::vector<double>> sums(fused_sums ? tasks : 1);
+        std::vector<std::vector<int64_t>> counts(fused_sums ? tasks : 1);
+
+        for (int64_t iter = 0; iter <= n_iters; iter++) {
+            const bool first = iter == 0;
+            std::atomic<int64_t> n_changed = 0;
+            UpdateNorms();
+            ParallelFor(pool_, n, tasks, [&](int64_t t, int64_t begin, int64_t end) {
+                if (fused_sums) {
+                    sums[t].assign(k_ * dim_, 0);
+                    counts[t].assign(k_, 0);
+                }
+                auto x = std::make_unique<float[]>(kBlockRows * dim_);
+                auto todo_x = std::make_unique<float[]>(kBlockRows * dim_);
+                auto dis = std::make_unique<float[]>(kBlockRows * nn);
+                auto ids = std::make_unique<int64_t[]>(kBlockRows * nn);
+                std::vector<int64_t> todo;
+                int64_t changed = 0;
+                for (int64_t b = begin; b < end; b += kBlockRows) {
+                    const int64_t block_end = std::min(end, b + kBlockRows);
+                    reader_.Read(b, block_end, x.get());
+                    todo.clear();
+                    for (int64_t i = b; i < block_end; i++) {
+                        const float* row = x.get() + (i - b) * dim_;
+                        if (!first) {
+                            const auto a = labels[i];
+                            upper[i] += drift[a];
+                            lower[i] -= (int64_t)a == max_drift_id ? second_drift : max_drift;
+                            const float bound = std::max(half_gap[a], lower[i]);
+                            if (upper[i] <= bound) {
+                                continue;
+                            }
+                            const float* centroid = centroids_.get() + a * dim_;
+                            upper[i] = std::sqrt(faiss::cppcontrib::knowhere::fvec_L2sqr(row, centroid, dim_));
+                            if (upper[i] <= bound) {
+                                continue;
+                            }
+                        }
+                        std::copy(row, row + dim_, todo_x.get() + todo.size() * dim_);
+                        todo.push_back(i);
+                    }
+                    SearchCentroids(todo_x.get(), todo.size(), nn, dis.get(), ids.get());
+                    for (size_t j = 0; j < todo.size(); j++) {
+                        const auto i = todo[j];
+                        const auto label = (uint32_t)ids[j * nn];
+                        if (first || label != labels[i]) {
+                            changed++;
+                        }
+                        labels[i] = label;
+                        upper[i] = std::sqrt(dis[j * nn]);
+                        lower[i] = nn > 1 ? std::sqrt(dis[j * nn + 1]) : std::numeric_limits<float>::max();
+                    }
+                    if (fused_sums) {
+                        AddRows(x.get(), labels + b, block_end - b, sums[t], counts[t]);
+                    }
+                }
+                n_changed += changed;
+            });
+            LOG_KNOWHERE_DEBUG_ << "kmeans iteration " << iter << ", " << n_changed << " rows changed cluster";
+            if (iter == n_iters || (!first && n_changed == 0)) {
+                break;
+            }
+            if (!fused_sums) {
+                SumByCentroid(labels, sums[0], counts[0]);
+            }
+
+            Update(sums, counts, drift);
+            max_drift = second_drift = 0;
+            max_drift_id = -1;
+            for (int64_t j = 0; j < k_; j++) {
+                if (drift[j] > max_drift) {
+                    second_drift = max_drift;
+                    max_drift = drift[j];
+                    max_drift_id = j;
+                } else if (drift[j] > second_drift) {
+                    second_drift = drift[j];
+                }
+            }
+            UpdateHalfGaps(half_gap);
+        }
+    }
+
+    // mini-batch k-means (Sculley, 2010): each iteration assigns a random sample of rows with the centroids fixed,
+    // then moves every centroid towards its rows with a learning rate of 1 / (rows it has seen so far). Only the
+    // sampled rows are read until the final assignment.
+    void
+    MiniBatch(int64_t n_iters, int64_t batch_size) {
+        std::mt19937_64 rng(kSeed + 1);
+        std::uniform_int_distribution<int64_t> pick(0, reader_.rows() - 1);
+        std::vector<int64_t> seen(k_, 0);
+        std::vector<int64_t> batch(batch_size);
+        auto x = std::make_unique<float[]>(batch_size * dim_);
+        auto dis = std::make_unique<float[]>(batch_size);
+        auto ids = std::make_unique<int64_t[]>(batch_size);
+        for (int64_t iter = 0; iter < n_iters; iter++) {
+            for (auto& id : batch) {
+                id = pick(rng);
+            }
+            std::sort(batch.begin(), batch.end());
+            UpdateNorms();
+            ParallelFor(pool_, batch_size, pool_->size(), [&](int64_t, int64_t begin, int64_t end) {
+                reader_.Gather(batch.data() + begin, end - begin, x.get() + begin * dim_);
+                for (int64_t b = begin; b < end; b += kBlockRows) {
+                    const int64_t block_end = std::min(end, b + kBlockRows);
+                    SearchCentroids(x.get() + b * dim_, block_end - b, 1, dis.get() + b, ids.get() + b);
+                }
+            });
+            for (int64_t i = 0; i < batch_size; i++) {
+                const auto c = ids[i];
+                const float eta = 1.0f / ++seen[c];
+                const float* row = x.get() + i * dim_;
+                float* centroid = centroids_.get() + c * dim_;
+                for (int64_t d = 0; d < dim_; d++) {
+                    centroid[d] += eta * (row[d] - centroid[d]);
+                }
+            }
+        }
+    }
+
+    void
+    Assign(const RowReader<DataType>& reader, uint32_t* labels) {
+        UpdateNorms();
+        ParallelFor(pool_, reader.rows(), pool_->size(), [&](int64_t, int64_t begin, int64_t end) {
+            auto x = std::make_unique<float[]>(kBlockRows * dim_);
+            auto dis = std::make_unique<float[]>(kBlockRows);
+            auto ids = std::make_unique<int64_t[]>(kBlockRows);
+            for (int64_t b = begin; b < end; b += kBlockRows) {
+                const int64_t block_end = std::min(end, b + kBlockRows);
+                reader.Read(b, block_end, x.get());
+                SearchCentroids(x.get(), block_end - b, 1, dis.get(), ids.get());
+                for (int64_t i = b; i < block_end; i++) {
+                    labels[i] = ids[i - b];
+                }
+            }
+        });
+    }
+
+    void
+    SetCentroids(const float* centroids) {
+        std::copy(centroids, centroids + k_ * dim_, centroids_.get());
+    }
+
+    std::unique_ptr<float[]>
+    TakeCentroids() {
+        return std::move(centroids_);
+    }
+
+ private:
+    // the nn (1 or 2) nearest centroids of n rows, squared distances in ascending order
+    void
+    SearchCentroids(const float* x, int64_t n, int64_t nn, float* dis, int64_t* ids) const {
+        if (n == 0) {
+            return;
+        }
+        if (k_ >= kGemmMinClusters) {
+            faiss::cppcontrib::knowhere::knn_L2sqr_tiled<float>(x, centroids_.get(), dim_, n, k_, nn, dis, ids,
+                                                                norms_.get());
+            return;
+        }
+        std::vector<float> row_dis(k_);
+        for (int64_t i = 0; i < n; i++) {
+            faiss::cppcontrib::knowhere::fvec_L2sqr_ny(row_dis.data(), x + i * dim_, centroids_.get(), dim_, k_);
+            float best = std::numeric_limits<float>::max(), second = best;
+            int64_t best_id = -1, second_id = -1;
+            for (int64_t j = 0; j < k_; j++) {
+                if (row_dis[j] < best) {
+                    second = best;
+                    second_id = best_id;
+                    best = row_dis[j];
+                    best_id = j;
+                } else if (row_dis[j] < second) {
+                    second = row_dis[j];
+                    second_id = j;
+                }
+            }
+            dis[i * nn] = best;
+            ids[i * nn] = best_id;
+            if (nn > 1) {
+                dis[i * nn + 1] = second;
+                ids[i * nn + 1] = second_id;
+            }
+        }
+    }
+
+    void
+    UpdateNorms() {
+        faiss::cppcontrib::knowhere::fvec_norms_L2sqr(norms_.get(), centroids_.get(), dim_, k_);
+    }
+
+    // new centroids from the per-task sums, and how far each of them moved
+    // adds the n rows x, assigned to `labels`, to the centroid sums
+    void
+    AddRows(const float* x, const uint32_t* labels, int64_t n, std::vector<double>& sum,
+            std::vector<int64_t>& count) const {
+        for (int64_t i = 0; i < n; i++) {
+            const float* row = x + i * dim_;
+            double* centroid_sum = sum.data() + labels[i] * dim_;
+            for (int64_t d = 0; d < dim_; d++) {
+                centroid_sum[d] += row[d];
+            }
+            count[labels[i]]++;
+        }
+    }
+
+    // sums up the rows of every centroid when a copy of the sums per task does not fit: the centroids are split into
+    // contiguous ranges of about the same number of rows, and every task reads the rows of its own range, in storage
+    // order, into the shared sums
+    void
+    SumByCentroid(const uint32_t* labels, std::vector<double>& sum, std::vector<int64_t>& count) {
+        const auto n = reader_.rows();
+        const int64_t tasks = std::clamp<int64_t>(pool_->size(), 1, k_);
+        count.assign(k_, 0);
+        for (int64_t i = 0; i < n; i++) {
+            count[labels[i]]++;
+        }
+        std::vector<uint32_t> part(k_);
+        std::vector<int64_t> offsets(tasks + 1, 0);
+        int64_t acc = 0;
+        for (int64_t j = 0; j < k_; j++) {
+            part[j] = std::min(acc * tasks / n, tasks - 1);
+            acc += count[j];
+            offsets[part[j] + 1] += count[j];
+        }
+        std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+        std::vector<int64_t> rows(n);
+        auto next = offsets;
+        for (int64_t i = 0; i < n; i++) {
+            rows[next[part[labels[i]]]++] = i;
+        }
+
+        // no two tasks add to the same centroid
+        sum.assign(k_ * dim_, 0);
+        count.assign(k_, 0);
+        ParallelFor(pool_, tasks, tasks, [&](int64_t, int64_t begin, int64_t end) {
+            auto x = std::make_unique<float[]>(kBlockRows * dim_);
+            auto block_labels = std::make_unique<uint32_t[]>(kBlockRows);
+            for (int64_t r = offsets[begin]; r < offsets[end]; r += kBlockRows) {
+                const int64_t m = std::min(offsets[end] - r, kBlockRows);
+                reader_.Gather(rows.data() + r, m, x.get());
+                for (int64_t i = 0; i < m; i++) {
+                    block_labels[i] = labels[rows[r + i]];
+                }
+                AddRows(x.get(), block_labels.get(), m, sum, count);
+            }
+        });
+    }
+
+    void
+    Update(const std::vector<std::vector<double>>& sums, const std::vector<std::vector<int64_t>>& counts,
+           std::vector<float>& drift) {
+        std::vector<int64_t> count(k_, 0);
+        for (const auto& task_count : counts) {
+            for (int64_t j = 0; j < k_; j++) {
+                count[j] += task_count[j];
+            }
+        }
+        auto old_centroids = std::make_unique<float[]>(k_ * dim_);
+        std::copy(centroids_.get(), centroids_.get() + k_ * dim_, old_centroids.get());
+        ParallelFor(pool_, k_, pool_->size(), [&](int64_t, int64_t begin, int64_t end) {
+            std::vector<double> sum(dim_);
+            for (int64_t j = begin; j < end; j++) {
+                if (count[j] == 0) {
+                    continue;
+                }
+                std::fill(sum.begin(), sum.end(), 0);
+                for (const auto& task_sum : sums) {
+                    for (int64_t d = 0; d < dim_; d++) {
+                        sum[d] += task_sum[j * dim_ + d];
+                    }
+                }
+                for (int64_t d = 0; d < dim_; d++) {
+                    centroids_[j * dim_ + d] = sum[d] / count[j];
+                }
+            }
+        });
+
+        // an empty cluster takes over half of the largest one, the two centroids are pushed slightly apart
+        constexpr float kEps = 1.0f / 1024;
+        int64_t n_split = 0;
+        for (int64_t j = 0; j < k_; j++) {
+            if (count[j] != 0) {
+                continue;
+            }
+            const int64_t largest = std::max_element(count.begin(), count.end()) - count.begin();
+            float* from = centroids_.get() + largest * dim_;
+            float* to = centroids_.get() + j * dim_;
+            for (int64_t d = 0; d < dim_; d++) {
+                const float delta = (d % 2 == 0 ? kEps : -kEps) * from[d];
+                to[d] = from[d] + delta;
+                from[d] -= delta;
+            }
+            count[j] = count[largest] / 2;
+            count[largest] -= count[j];
+            n_split++;
+        }
+        if (n_split > 0) {
+            LOG_KNOWHERE_DEBUG_ << "kmeans split " << n_split << " clusters to refill empty ones";
+        }
+
+        for (int64_t j = 0; j < k_; j++) {
+            drift[j] = std::sqrt(faiss::cppcontrib::knowhere::fvec_L2sqr(centroids_.get() + j * dim_,
+                                                                         old_centroids.get() + j * dim_, dim_));
+        }
+    }
+
+    // half the distance from each centroid to its closest other centroid. A row closer than that to its own
+    // centroid cannot be closer to any other one.
+    void
+    UpdateHalfGaps(std::vector<float>& half_gap) {
+        if (k_ == 1) {
+            return;
+        }
+        UpdateNorms();
+        ParallelFor(pool_, k_, pool_->size(), [&](int64_t, int64_t begin, int64_t end) {
+            auto dis = std::make_unique<float[]>(kBlockRows * 2);
+            auto ids = std::make_unique<int64_t[]>(kBlockRows * 2);
+            for (int64_t b = begin; b < end; b += kBlockRows) {
+                const int64_t block_end = std::min(end, b + kBlockRows);
+                SearchCentroids(centroids_.get() + b * dim_, block_end - b, 2, dis.get(), ids.get());
+                for (int64_t j = b; j < block_end; j++) {
+                    // the nearest one is normally the centroid itself, unless another coincides with it
+                    const int64_t pos = (j - b) * 2;
+                    const float gap = ids[pos] == j ? dis[pos + 1] : dis[pos];
+                    half_gap[j] = std::sqrt(gap) / 2;
+                }
+            }
+        });
+    }
+
+    const RowReader<DataType>& reader_;
+    const int64_t k_;
+    const int64_t dim_;
+    std::shared_ptr<ThreadPool> pool_;
+    std::unique_ptr<float[]> centroids_;
+    // squared norms of the centroids for the sgemm tiles
+    std::unique_ptr<float[]> norms_;
+};
+
+}  // namespace
+
+template <typename DataType>
+class KmeansClusterNode : public ClusterNode {
+    static_assert(KnowhereFloatTypeCheck<DataType>::value);
+
+ public:
+    KmeansClusterNode(const Object& object) {
+    }
+
+    expected<DataSetPtr>
+    Train(const DataSet& dataset, const Config& cfg) override {
+        const auto& kmeans_cfg = static_cast<const KmeansConfig&>(cfg);
+        const auto rows = dataset.GetRows();
+        const auto dim = dataset.GetDim();
+        const int64_t num_clusters = kmeans_cfg.num_clusters.value();
+        if (rows < num_clusters) {
+            std::string msg = "the number of rows " + std::to_string(rows) + " is smaller than num_clusters " +
+                              std::to_string(num_clusters);
+            LOG_KNOWHERE_ERROR_ << msg;
+            return expected<DataSetPtr>::Err(Status::invalid_args, msg);
+        }
+        const bool plus_plus =
+            kmeans_cfg.kmeans_init.has_value()
+                ? kmeans_cfg.kmeans_init.value() == kKmeansInitPlusPlus
+                : faiss::cppcontrib::knowhere::clustering_type == faiss::cppcontrib::knowhere::K_MEANS_PLUS_PLUS;
+        const int64_t n_iters = kmeans_cfg.kmeans_n_iters.value();
+        const int64_t batch_size = kmeans_cfg.kmeans_batch_size.value();
+
+        try {
+            TimeRecorder rc("KMeans Train", 2);
+            RowReader<DataType> reader(dataset);
+            Kmeans<DataType> kmeans(reader, num_clusters);
+            kmeans.Init(plus_plus);
+            rc.RecordSection("init");
+            auto labels = std::make_unique<uint32_t[]>(rows);
+            if (batch_size > 0 && batch_size < rows) {
+                kmeans.MiniBatch(n_iters, batch_size);
+                kmeans.Assign(reader, labels.get());
+            } else {
+                kmeans.Lloyd(n_iters, labels.get());
+            }
+            rc.ElapseFromBegin("done");
+            centroids_ = kmeans.TakeCentroids();
+            dim_ = dim;
+            num_clusters_ = num_clusters;
+            return GenResultDataSet(rows, 1, std::move(labels));
+        } catch (const std::exception& e) {
+            LOG_KNOWHERE_WARNING_ << "kmeans inner error: " << e.what();
+            return expected<DataSetPtr>::Err(Status::cluster_inner_error, e.what());
+        }
+    }
+
+    expected<DataSetPtr>
+    Assign(const DataSet& dataset) override {
+        if (centroids_ == nullptr) {
+            return expected<DataSetPtr>::Err(Status::empty_index, "kmeans is not trained");
+        }
+        if (dataset.GetDim() != dim_) {
+            return expected<DataSetPtr>::Err(Status::invalid_args, "dimension mismatch");
+        }
+        try {
+            RowReader<DataType> reader(dataset);
+            Kmeans<DataType> kmeans(reader, num_clusters_);
+            kmeans.SetCentroids(centroids_.get());
+            auto labels = std::make_unique<uint32_t[]>(reader.rows());
+            kmeans.Assign(reader, labels.get());
+            return GenResultDataSet(reader.rows(), 1, std::move(labels));
+        } catch (const std::exception& e) {
+            LOG_KNOWHERE_WARNING_ << "kmeans inner error: " << e.what();
+            return expected<DataSetPtr>::Err(Status::cluster_inner_error, e.what());
+        }
+    }
+
+    expected<DataSetPtr>
+    GetCentroids() const override {
+        if (centroids_ == nullptr) {
+            return expected<DataSetPtr>::Err(Status::empty_index, "kmeans is not trained");
+        }
+        auto centroids = std::make_unique<float[]>(num_clusters_ * dim_);
+        std::copy(centroids_.get(), centroids_.get() + num_clusters_ * dim_, centroids.get());
+        return ConvertToDataTypeIfNeeded<DataType>(GenResultDataSet(num_clusters_, dim_, std::move(centroids)));
+    }
+
+    std::unique_ptr<Config>
+    CreateConfig() const override {
+        return std::make_unique<KmeansConfig>();
+    }
+
+    std::string
+    Type() const override {
+        return ClusterEnum::CLUSTER_KMEANS;
+    }
+
+ private:
+    int64_t dim_ = 0;
+    int64_t num_clusters_ = 0;
+    std::unique_ptr<float[]> centroids_;
+};
+
+#ifndef KNOWHERE_WITH_CARDINAL
+KNOWHERE_CLUSTER_SIMPLE_REGISTER_GLOBAL(KMEANS, KmeansClusterNode, fp32);
+KNOWHERE_CLUSTER_SIMPLE_REGISTER_GLOBAL(KMEANS, KmeansClusterNode, fp16);
+KNOWHERE_CLUSTER_SIMPLE_REGISTER_GLOBAL(KMEANS, KmeansClusterNode, bf16);
+#endif
+
+}  // namespace knowhere
@@ -0,0 +1,78 @@
+// Copyright (C) 2019-2023 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License.
+
+#ifndef KMEANS_CONFIG_H
+#define KMEANS_CONFIG_H
+
+#include <limits>
+#include <string>
+
+#include "knowhere/comp/index_param.h"
+#include "knowhere/config.h"
+#include "knowhere/tolower.h"
+
+namespace knowhere {
+
+namespace {
+constexpr const char* kKmeansInitRandom = "random";
+constexpr const char* kKmeansInitPlusPlus = "kmeans++";
+}  // namespace
+
+class KmeansConfig : public Config {
+ public:
+    CFG_INT num_clusters;
+    CFG_INT kmeans_n_iters;
+    // how the first centroids are picked, "random" or "kmeans++". When empty, it follows
+    // KnowhereConfig::SetClusteringType
+    CFG_STRING kmeans_init;
+    // rows sampled per iteration. 0 runs full Lloyd iterations over all rows, anything else runs mini-batch
+    // k-means, which only touches the sampled rows until the final assignment pass
+    CFG_INT kmeans_batch_size;
+
+    KNOHWERE_DECLARE_CONFIG(KmeansConfig) {
+        KNOWHERE_CONFIG_DECLARE_FIELD(num_clusters)
+            .description("number of clusters")
+            .set_range(1, std::numeric_limits<CFG_INT::value_type>::max())
+            .for_cluster();
+        KNOWHERE_CONFIG_DECLARE_FIELD(kmeans_n_iters)
+            .description("number of k-means iterations")
+            .set_default(10)
+            .set_range(1, 1024)
+            .for_cluster();
+        KNOWHERE_CONFIG_DECLARE_FIELD(kmeans_init)
+            .description("centroid initialization, random or kmeans++")
+            .allow_empty_without_default()
+            .for_cluster();
+        KNOWHERE_CONFIG_DECLARE_FIELD(kmeans_batch_size)
+            .description("rows sampled per mini-batch iteration, 0 for full iterations")
+            .set_default(0)
+            .set_range(0, std::numeric_limits<CFG_INT::value_type>::max())
+            .for_cluster();
+    }
+
+    Status
+    CheckAndAdjust(PARAM_TYPE param_type, std::string* err_msg) override {
+        if (param_type == PARAM_TYPE::CLUSTER && kmeans_init.has_value()) {
+            auto init = str_to_lower(kmeans_init.value());
+            if (init != kKmeansInitRandom && init != kKmeansInitPlusPlus) {
+                std::string msg = "invalid kmeans init : " + kmeans_init.value() + ", optional types are [" +
+                                  kKmeansInitRandom + ", " + kKmeansInitPlusPlus + "]";
+                return HandleError(err_msg, msg, Status::invalid_args);
+            }
+            kmeans_init = init;
+        }
+        return Status::success;
+    }
+};
+
+}  // namespace knowhere
+
+#endif /* KMEANS_CONFIG_H */
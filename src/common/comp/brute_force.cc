@@ -18,6 +18,7 @@
 #include "common/metric.h"
 #include "faiss/MetricType.h"
 #include "faiss/cppcontrib/knowhere/utils/distances.h"
+#include "faiss/cppcontrib/knowhere/utils/distances_tiled.h"
 #include "faiss/cppcontrib/knowhere/utils/distances_typed.h"
 #include "index/minhash/minhash_util.h"
 #include "knowhere/bitsetview_idselector.h"
@@ -180,9 +181,12 @@ template <typename DataType>
 Status
 brute_force_dense_impl(const void* xq, size_t query_idx, const void* xb, const float* norms, int64_t* cur_labels,
                        float* cur_distances, size_t dim, size_t nb, size_t topk, faiss::MetricType faiss_metric_type,
-                       const BitsetView& bitset, bool is_cosine) {
+                       const BitsetView& bitset, bool is_cosine, const faiss::IDSelector* allow_selector = nullptr) {
     BitsetViewIDSelector bw_idselector(bitset);
-    faiss::IDSelector* id_selector = (bitset.empty()) ? nullptr : &bw_idselector;
+    const faiss::IDSelector* id_selector = (bitset.empty()) ? nullptr : &bw_idselector;
+    if (allow_selector != nullptr) {
+        id_selector = allow_selector;
+    }
     switch (faiss_metric_type) {
         case faiss::METRIC_L2: {
             auto cur_query = (const DataType*)xq + dim * query_idx;
@@ -262,6 +266,68 @@ brute_force_dense_impl(const void* xq, size_t query_idx, const void* xb, const f
     return Status::success;
 }
 
+// Smallest number of queries per search thread for which scoring a block of queries against shared base tiles beats
+// one independent scan per query.
+constexpr int64_t kMinTiledQueryBlock = 4;
+
+// Returns how many queries each task of a dense search should take, or 1 to keep one task per query. The tiled path
+// covers fp32 and the low-precision types under L2/IP/COSINE, and only kicks in when every search thread gets enough
+// queries to amortize a base tile over.
+template <typename DataType>
+int64_t
+GetDenseQueryBlockSize(faiss::MetricType faiss_metric_type, int64_t nq, size_t num_threads) {
+    if constexpr (!std::is_same_v<DataType, knowhere::fp32> && !KnowhereLowPrecisionTypeCheck<DataType>::value) {
+        return 1;
+    }
+    if (faiss_metric_type != faiss::METRIC_L2 && faiss_metric_type != faiss::METRIC_INNER_PRODUCT) {
+        return 1;
+    }
+    auto threads = std::max<int64_t>(num_threads, 1);
+    auto queries_per_thread = (nq + threads - 1) / threads;
+    if (queries_per_thread < kMinTiledQueryBlock) {
+        return 1;
+    }
+    return std::min<int64_t>(queries_per_thread, faiss::cppcontrib::knowhere::distance_compute_tiled_query_bs);
+}
+
+template <typename DataType>
+Status
+brute_force_dense_tiled_impl(const void* xq, size_t query_beg, size_t query_num, const void* xb, const float* norms,
+                             int64_t* labels, float* distances, size_t dim, size_t nb, size_t topk,
+                             faiss::MetricType faiss_metric_type, const BitsetView& bitset, bool is_cosine) {
+    if constexpr (std::is_same_v<DataType, knowhere::fp32> || KnowhereLowPrecisionTypeCheck<DataType>::value) {
+        BitsetViewIDSelector bw_idselector(bitset);
+        faiss::IDSelector* id_selector = (bitset.empty()) ? nullptr : &bw_idselector;
+        auto cur_query = (const DataType*)xq + dim * query_beg;
+        auto cur_labels = labels + topk * query_beg;
+        auto cur_distances = distances + topk * query_beg;
+        switch (faiss_metric_type) {
+            case faiss::METRIC_L2:
+                faiss::cppcontrib::knowhere::knn_L2sqr_tiled(cur_query, (const DataType*)xb, dim, query_num, nb, topk,
+                                                             cur_distances, cur_labels, nullptr, id_selector);
+                break;
+            case faiss::METRIC_INNER_PRODUCT:
+                if (is_cosine) {
+                    faiss::cppcontrib::knowhere::knn_cosine_tiled(cur_query, (const DataType*)xb, norms, dim,
+                                                                  query_num, nb, topk, cur_distances, cur_labels,
+                                                                  id_selector);
+                } else {
+                    faiss::cppcontrib::knowhere::knn_inner_product_tiled(cur_query, (const DataType*)xb, dim,
+                                                                         query_num, nb, topk, cur_distances,
+                                                                         cur_labels, id_selector);
+                }
+                break;
+            default:
+                LOG_KNOWHERE_ERROR_ << "Invalid metric type for tiled brute force: " << faiss_metric_type;
+                return Status::invalid_metric_type;
+        }
+        return Status::success;
+    } else {
+        LOG_KNOWHERE_ERROR_ << "Tiled brute force not supported for current vector type";
+        return Status::faiss_inner_error;
+    }
+}
+
 template <typename DataType>
 Status
 brute_force_minhash_impl(const void* xq, const void* xb, int64_t* labels, float* distances, size_t dim, size_t nb,
@@ -560,17 +626,49 @@ BruteForce::SearchWithBuf(const DataSetPtr base_dataset, const DataSetPtr query_
         std::unique_ptr<float[]> norms = is_cosine ? GetVecNorms<DataType>(base_dataset) : nullptr;
         auto pool = ThreadPool::GetGlobalSearchThreadPool();
         std::vector<folly::Future<Status>> futs;
-        futs.reserve(nq);
-        for (int i = 0; i < nq; ++i) {
-            futs.emplace_back(pool->push([&, index = i] {
-                ThreadPool::ScopedSearchOmpSetter setter(1);
-                auto cur_labels = labels + topk * index;
-                auto cur_distances = distances + topk * index;
-                RETURN_IF_ERROR(brute_force_dense_impl<DataType>(xq, index, xb, norms.get(), cur_labels, cur_distances,
-                                                                 dim, nb, topk, faiss_metric_type, bitset, is_cosine));
 
-                return Status::success;
-            }));
+        // a filter that comes with an allow list is scored over the allowed rows only; faiss walks an IDSelectorArray
+        // by index instead of testing every base row against the bitset.
+        std::vector<int64_t> allowed_ids;
+        std::unique_ptr<faiss::IDSelectorArray> allow_selector;
+        if constexpr (std::is_same_v<DataType, knowhere::fp32>) {
+            if (!bitset.empty() && bitset.has_allow_list() &&
+                (faiss_metric_type == faiss::METRIC_L2 || faiss_metric_type == faiss::METRIC_INNER_PRODUCT)) {
+                allowed_ids.reserve(std::min<size_t>(bitset.allow_list_size(), nb));
+                bitset.for_each_allowed(nb, [&](size_t id) { allowed_ids.push_back(id); });
+                allow_selector = std::make_unique<faiss::IDSelectorArray>(allowed_ids.size(), allowed_ids.data());
+            }
+        }
+
+        auto query_bs = allow_selector != nullptr
+                            ? 1
+                            : GetDenseQueryBlockSize<DataType>(faiss_metric_type, nq, pool->size());
+        if (query_bs > 1) {
+            // each task streams the base dataset once for a whole block of queries
+            futs.reserve((nq + query_bs - 1) / query_bs);
+            for (int64_t i = 0; i < nq; i += query_bs) {
+                futs.emplace_back(pool->push([&, beg = i, num = std::min<int64_t>(query_bs, nq - i)] {
+                    ThreadPool::ScopedSearchOmpSetter setter(1);
+                    RETURN_IF_ERROR(brute_force_dense_tiled_impl<DataType>(xq, beg, num, xb, norms.get(), labels,
+                                                                           distances, dim, nb, topk,
+                                                                           faiss_metric_type, bitset, is_cosine));
+                    return Status::success;
+                }));
+            }
+        } else {
+            futs.reserve(nq);
+            for (int i = 0; i < nq; ++i) {
+                futs.emplace_back(pool->push([&, index = i] {
+                    ThreadPool::ScopedSearchOmpSetter setter(1);
+                    auto cur_labels = labels + topk * index;
+                    auto cur_distances = distances + topk * index;
+                    RETURN_IF_ERROR(brute_force_dense_impl<DataType>(xq, index, xb, norms.get(), cur_labels,
+                                                                     cur_distances, dim, nb, topk, faiss_metric_type,
+                                                                     bitset, is_cosine, allow_selector.get()));
+
+                    return Status::success;
+                }));
+            }
         }
         RETURN_IF_ERROR(WaitAllSuccess(futs));
 
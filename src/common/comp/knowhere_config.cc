@@ -15,6 +15,7 @@
 
 #ifdef KNOWHERE_WITH_DISKANN
 #include "diskann/aio_context_pool.h"
+#include "diskann/uring_aligned_file_reader.h"
 #endif
 #include "faiss/cppcontrib/knowhere/Clustering.h"
 #include "faiss/cppcontrib/knowhere/utils/distances.h"
@@ -147,6 +148,17 @@ KnowhereConfig::SetAioContextPool(size_t num_ctx) {
     return true;
 }
 
+bool
+KnowhereConfig::SetDiskIOEngine(const DiskIOEngine engine, bool sqpoll) {
+#ifdef KNOWHERE_WITH_DISKANN
+    LOG_KNOWHERE_INFO_ << "Set disk io engine to " << (engine == DiskIOEngine::URING ? "io_uring" : "libaio")
+                       << (sqpoll ? " with sqpoll" : "");
+    return diskann::set_global_io_engine(
+        engine == DiskIOEngine::URING ? diskann::IOEngine::URING : diskann::IOEngine::AIO, sqpoll);
+#endif
+    return engine == DiskIOEngine::AIO;
+}
+
 void
 KnowhereConfig::SetBuildThreadPoolSize(size_t num_threads) {
     knowhere::ThreadPool::SetGlobalBuildThreadPoolSize(num_threads);
@@ -169,4 +169,22 @@ Config::FormatAndCheck(const Config& cfg, Json& json, std::string* const err_msg
     return Status::success;
 }
 
+void
+Config::CopyValues(const Config& src, Config& dst) {
+    for (const auto& it : src.__DICT__) {
+        auto dst_it = dst.__DICT__.find(it.first);
+        if (dst_it == dst.__DICT__.end()) {
+            continue;
+        }
+        std::visit(
+            [&dst_var = dst_it->second](const auto& src_entry) {
+                using EntryType = std::decay_t<decltype(src_entry)>;
+                if (auto dst_entry = std::get_if<EntryType>(&dst_var)) {
+                    *dst_entry->val = *src_entry.val;
+                }
+            },
+            it.second);
+    }
+}
+
 }  // namespace knowhere
@@ -213,6 +213,11 @@ struct QuantDataDistanceComputer : faiss::DistanceComputer {
         return;
     }
 
+    void
+    prefetch(idx_t i) override {
+        prefetch_L1(quant_data->GetCode(i));
+    }
+
     /// compute distance between two stored vectors
     float
     symmetric_dis(idx_t i, idx_t j) override {
@@ -287,6 +292,11 @@ struct DataViewDistanceComputer : faiss::DistanceComputer {
         }
     }
 
+    void
+    prefetch(idx_t i) override {
+        prefetch_L1(view_data(i));
+    }
+
     /// compute distance between two stored vectors
     float
     symmetric_dis(idx_t i, idx_t j) override {
@@ -296,6 +306,31 @@ struct DataViewDistanceComputer : faiss::DistanceComputer {
     }
 };
 
+// the kernels are picked once for `dim`, so that every distance of the computer is a direct call
+template <typename DataType>
+std::unique_ptr<faiss::DistanceComputer>
+MakeDataViewComputer(const ViewDataOp& view_data, const knowhere::MetricType& metric, const size_t dim,
+                     bool is_cosine) {
+    using Kernels = faiss::cppcontrib::knowhere::DistanceKernels<DataType>;
+    using Distance1 = typename Kernels::distance_t;
+    using Distance4 = typename Kernels::distance_batch_4_t;
+    const auto kernels = faiss::cppcontrib::knowhere::get_distance_kernels<DataType>(dim);
+    if (metric == metric::IP) {
+        if (is_cosine) {
+            return std::unique_ptr<faiss::DistanceComputer>(
+                new DataViewDistanceComputer<DataType, Distance1, Distance4, true>(
+                    view_data, dim, kernels.inner_product, kernels.inner_product_batch_4));
+        } else {
+            return std::unique_ptr<faiss::DistanceComputer>(
+                new DataViewDistanceComputer<DataType, Distance1, Distance4, false>(
+                    view_data, dim, kernels.inner_product, kernels.inner_product_batch_4));
+        }
+    } else {
+        return std::unique_ptr<faiss::DistanceComputer>(new DataViewDistanceComputer<DataType, Distance1, Distance4>(
+            view_data, dim, kernels.L2sqr, kernels.L2sqr_batch_4));
+    }
+}
+
 static std::unique_ptr<faiss::DistanceComputer>
 SelectDataViewComputer(const ViewDataOp& view_data, const DataFormatEnum& data_type, const knowhere::MetricType& metric,
                        const size_t dim, bool is_cosine, const std::shared_ptr<QuantRefine> quant = nullptr) {
@@ -306,75 +341,11 @@ SelectDataViewComputer(const ViewDataOp& view_data, const DataFormatEnum& data_t
             return std::unique_ptr<faiss::DistanceComputer>(new QuantDataDistanceComputer<false>(quant, dim));
         }
     } else if (data_type == DataFormatEnum::fp16) {
-        if (metric == metric::IP) {
-            if (is_cosine) {
-                return std::unique_ptr<faiss::DistanceComputer>(
-                    new DataViewDistanceComputer<fp16, decltype(faiss::cppcontrib::knowhere::fp16_vec_inner_product),
-                                                 decltype(faiss::cppcontrib::knowhere::fp16_vec_inner_product_batch_4),
-                                                 true>(view_data, dim,
-                                                       faiss::cppcontrib::knowhere::fp16_vec_inner_product,
-                                                       faiss::cppcontrib::knowhere::fp16_vec_inner_product_batch_4));
-            } else {
-                return std::unique_ptr<faiss::DistanceComputer>(
-                    new DataViewDistanceComputer<fp16, decltype(faiss::cppcontrib::knowhere::fp16_vec_inner_product),
-                                                 decltype(faiss::cppcontrib::knowhere::fp16_vec_inner_product_batch_4),
-                                                 false>(view_data, dim,
-                                                        faiss::cppcontrib::knowhere::fp16_vec_inner_product,
-                                                        faiss::cppcontrib::knowhere::fp16_vec_inner_product_batch_4));
-            }
-        } else {
-            return std::unique_ptr<faiss::DistanceComputer>(
-                new DataViewDistanceComputer<fp16, decltype(faiss::cppcontrib::knowhere::fp16_vec_L2sqr),
-                                             decltype(faiss::cppcontrib::knowhere::fp16_vec_L2sqr_batch_4)>(
-                    view_data, dim, faiss::cppcontrib::knowhere::fp16_vec_L2sqr,
-                    faiss::cppcontrib::knowhere::fp16_vec_L2sqr_batch_4));
-        }
+        return MakeDataViewComputer<fp16>(view_data, metric, dim, is_cosine);
     } else if (data_type == DataFormatEnum::bf16) {
-        if (metric == metric::IP) {
-            if (is_cosine) {
-                return std::unique_ptr<faiss::DistanceComputer>(
-                    new DataViewDistanceComputer<bf16, decltype(faiss::cppcontrib::knowhere::bf16_vec_inner_product),
-                                                 decltype(faiss::cppcontrib::knowhere::bf16_vec_inner_product_batch_4),
-                                                 true>(view_data, dim,
-                                                       faiss::cppcontrib::knowhere::bf16_vec_inner_product,
-                                                       faiss::cppcontrib::knowhere::bf16_vec_inner_product_batch_4));
-            } else {
-                return std::unique_ptr<faiss::DistanceComputer>(
-                    new DataViewDistanceComputer<bf16, decltype(faiss::cppcontrib::knowhere::bf16_vec_inner_product),
-                                                 decltype(faiss::cppcontrib::knowhere::bf16_vec_inner_product_batch_4),
-                                                 false>(view_data, dim,
-                                                        faiss::cppcontrib::knowhere::bf16_vec_inner_product,
-                                                        faiss::cppcontrib::knowhere::bf16_vec_inner_product_batch_4));
-            }
-        } else {
-            return std::unique_ptr<faiss::DistanceComputer>(
-                new DataViewDistanceComputer<bf16, decltype(faiss::cppcontrib::knowhere::bf16_vec_L2sqr),
-                                             decltype(faiss::cppcontrib::knowhere::bf16_vec_L2sqr_batch_4)>(
-                    view_data, dim, faiss::cppcontrib::knowhere::bf16_vec_L2sqr,
-                    faiss::cppcontrib::knowhere::bf16_vec_L2sqr_batch_4));
-        }
+        return MakeDataViewComputer<bf16>(view_data, metric, dim, is_cosine);
     } else if (data_type == DataFormatEnum::fp32) {
-        if (metric == metric::IP) {
-            if (is_cosine) {
-                return std::unique_ptr<faiss::DistanceComputer>(
-                    new DataViewDistanceComputer<fp32, decltype(faiss::cppcontrib::knowhere::fvec_inner_product),
-                                                 decltype(faiss::cppcontrib::knowhere::fvec_inner_product_batch_4),
-                                                 true>(view_data, dim, faiss::cppcontrib::knowhere::fvec_inner_product,
-                                                       faiss::cppcontrib::knowhere::fvec_inner_product_batch_4));
-            } else {
-                return std::unique_ptr<faiss::DistanceComputer>(
-                    new DataViewDistanceComputer<fp32, decltype(faiss::cppcontrib::knowhere::fvec_inner_product),
-                                                 decltype(faiss::cppcontrib::knowhere::fvec_inner_product_batch_4),
-                                                 false>(view_data, dim, faiss::cppcontrib::knowhere::fvec_inner_product,
-                                                        faiss::cppcontrib::knowhere::fvec_inner_product_batch_4));
-            }
-        } else {
-            return std::unique_ptr<faiss::DistanceComputer>(
-                new DataViewDistanceComputer<fp32, decltype(faiss::cppcontrib::knowhere::fvec_L2sqr),
-                                             decltype(faiss::cppcontrib::knowhere::fvec_L2sqr_batch_4)>(
-                    view_data, dim, faiss::cppcontrib::knowhere::fvec_L2sqr,
-                    faiss::cppcontrib::knowhere::fvec_L2sqr_batch_4));
-        }
+        return MakeDataViewComputer<fp32>(view_data, metric, dim, is_cosine);
     } else {
         return nullptr;
     }
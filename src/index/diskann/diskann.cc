@@ -11,16 +11,23 @@
 
 #include "knowhere/feder/DiskANN.h"
 
+#include <algorithm>
 #include <cstdint>
+#include <cstdio>
+#include <cstring>
 #include <fstream>
 #include <limits>
+#include <numeric>
+#include <shared_mutex>
 
 #include "diskann/aux_utils.h"
-#include "diskann/linux_aligned_file_reader.h"
+#include "diskann/index.h"
 #include "diskann/pq_flash_index.h"
+#include "diskann/uring_aligned_file_reader.h"
 #include "filemanager/FileManager.h"
 #include "fmt/core.h"
 #include "index/diskann/diskann_config.h"
+#include "simd/hook.h"
 #include "knowhere/comp/index_param.h"
 #include "knowhere/context.h"
 #include "knowhere/dataset.h"
@@ -60,9 +67,7 @@ class DiskANNIndexNode : public IndexNode {
     }
 
     Status
-    Add(const DataSetPtr dataset, std::shared_ptr<Config> cfg, bool use_knowhere_build_pool) override {
-        return Status::not_implemented;
-    }
+    Add(const DataSetPtr dataset, std::shared_ptr<Config> cfg, bool use_knowhere_build_pool) override;
 
     expected<DataSetPtr>
     Search(const DataSetPtr dataset, std::unique_ptr<Config> cfg, const BitsetView& bitset,
@@ -113,10 +118,15 @@ class DiskANNIndexNode : public IndexNode {
     expected<DataSetPtr>
     GetIndexMeta(std::unique_ptr<Config> cfg) const override;
 
+    // the index itself is written to files by Build, only the points added after loading are serialized here.
     Status
     Serialize(BinarySet& binset) const override {
-        LOG_KNOWHERE_INFO_ << "DiskANN does nothing for serialize";
-        return Status::success;
+        std::shared_lock<std::shared_mutex> index_lock(index_lock_);
+        if (delta_count_.load(std::memory_order_acquire) == 0) {
+            LOG_KNOWHERE_INFO_ << "DiskANN does nothing for serialize";
+            return Status::success;
+        }
+        return SerializeDelta(binset);
     }
 
     Status
@@ -180,20 +190,22 @@ class DiskANNIndexNode : public IndexNode {
 
     int64_t
     Size() const override {
+        std::shared_lock<std::shared_mutex> index_lock(index_lock_);
         if (!is_prepared_.load() || !pq_flash_index_) {
             LOG_KNOWHERE_ERROR_ << "Diskann not loaded.";
             return 0;
         }
-        return pq_flash_index_->cal_size();
+        return pq_flash_index_->cal_size() + delta_mem_size_.load();
     }
 
     int64_t
     Count() const override {
+        std::shared_lock<std::shared_mutex> index_lock(index_lock_);
         if (count_.load() == -1) {
             LOG_KNOWHERE_ERROR_ << "Count() function is not supported when index is not ready yet.";
             return 0;
         }
-        return count_.load();
+        return count_.load() + delta_count_.load();
     }
 
     std::string
@@ -208,18 +220,27 @@ class DiskANNIndexNode : public IndexNode {
  private:
     class iterator : public IndexIterator {
      public:
+        // delta_dists are the distances of the points added after loading, which are all handed out with the first
+        // batch. They are taken when the iterator is created, so that a merge of the delta into the disk index in the
+        // meantime neither hides nor repeats them, and the iterator keeps the disk index it started on.
         iterator(const bool transform, const DataType* query_data, const uint64_t lsearch, const uint64_t beam_width,
-                 const float filter_ratio, const knowhere::BitsetView& bitset, diskann::PQFlashIndex<DataType>* index,
+                 const float filter_ratio, const knowhere::BitsetView& bitset,
+                 std::shared_ptr<diskann::PQFlashIndex<DataType>> index, std::vector<DistId>&& delta_dists,
                  bool use_knowhere_search_pool = true)
             : IndexIterator(transform, use_knowhere_search_pool),
-              index_(index),
+              index_(std::move(index)),
               transform_(transform),
-              workspace_(index_->getIteratorWorkspace(query_data, lsearch, beam_width, filter_ratio, bitset)) {
+              workspace_(index_->getIteratorWorkspace(query_data, lsearch, beam_width, filter_ratio, bitset)),
+              delta_dists_(std::move(delta_dists)) {
         }
 
      protected:
         void
         next_batch(std::function<void(const std::vector<DistId>&)> batch_handler) override {
+            if (!delta_dists_.empty()) {
+                batch_handler(delta_dists_);
+                delta_dists_ = std::vector<DistId>();
+            }
             index_->getIteratorNextBatch(workspace_.get());
             if (transform_) {
                 for (auto& p : workspace_->backup_res) {
@@ -231,9 +252,10 @@ class DiskANNIndexNode : public IndexNode {
         }
 
      private:
-        diskann::PQFlashIndex<DataType>* index_;
+        std::shared_ptr<diskann::PQFlashIndex<DataType>> index_;
         const bool transform_;
         std::unique_ptr<diskann::IteratorWorkspace<DataType>> workspace_;
+        std::vector<DistId> delta_dists_;
     };
 
     bool
@@ -257,15 +279,84 @@ class DiskANNIndexNode : public IndexNode {
     uint64_t
     GetCachedNodeNum(const float cache_dram_budget, const uint64_t data_dim, const uint64_t max_degree);
 
+    Status
+    BuildDiskIndex(const DiskANNConfig& build_conf, const diskann::Metric diskann_metric, const std::string& data_path,
+                   const std::string& prefix, const uint64_t dim);
+
+    // loads the disk index at index_prefix_ with load_options_.
+    Status
+    LoadDiskIndex(std::shared_ptr<diskann::PQFlashIndex<DataType>>& disk_index);
+
+    Status
+    AddToDelta(const DataType* data, const int64_t rows, const uint32_t max_degree, const uint32_t build_l,
+               const int64_t initial_points);
+
+    // copies the vector of the tag-th added point as it was added, delta_data_lock_ must be held.
+    bool
+    GetDeltaVector(uint32_t tag, DataType* vec) const;
+
+    Status
+    MergeDeltaResults(const DataType* xq, const int64_t nq, const int64_t dim, const uint64_t k, const uint64_t lsearch,
+                      const BitsetView& bitset, int64_t* p_id, DistType* p_dist) const;
+
+    // exact distances from query to every point added after loading that the bitset doesn't filter out.
+    std::vector<DistId>
+    DeltaDistances(const DataType* query, const BitsetView& bitset) const;
+
+    std::string
+    DeltaBinaryName() const {
+        return Type() + "_delta";
+    }
+
+    Status
+    SerializeDelta(BinarySet& binset) const;
+
+    Status
+    DeserializeDelta(const BinaryPtr& binary);
+
+    // rebuilds the disk index from its points, the delta and the rows being added, and replaces the index files and
+    // the loaded index with it. delta_add_lock_ must be held.
+    Status
+    MergeDelta(const DiskANNConfig& build_conf, const DataType* data, const int64_t rows);
+
+    // the cache and warm-up settings given at load, a merge loads the rebuilt index with them too
+    struct LoadOptions {
+        float search_cache_budget_gb = 0.0f;
+        float search_cache_adaptive_ratio = 0.0f;
+        bool use_bfs_cache = false;
+        bool warm_up = false;
+    };
+
     std::string index_prefix_;
     mutable std::mutex preparation_lock_;
     std::atomic_bool is_prepared_;
     std::shared_ptr<milvus::FileManager> file_manager_;
-    std::unique_ptr<diskann::PQFlashIndex<DataType>> pq_flash_index_;
+    // held shared by the readers of pq_flash_index_, count_ and the delta, and exclusively by a merge to swap them
+    mutable std::shared_mutex index_lock_;
+    std::shared_ptr<diskann::PQFlashIndex<DataType>> pq_flash_index_;
+    LoadOptions load_options_;
     std::atomic_int64_t dim_;
     std::atomic_int64_t count_;
     std::shared_ptr<ThreadPool> search_pool_;
     std::vector<uint32_t> internal_id_to_most_external_id_map_;  // for 1-hop bitset check
+
+    // Points added after loading live in an in-memory Vamana graph, the delta. They take the ids after the ones on
+    // disk in insertion order, and deletes are left to the bitset like for the disk points. Only delta_count_ points
+    // are visible to searches. The delta grows as points are added, graph searches are safe against its growth, while
+    // reads of its vectors hold delta_data_lock_. Serialize() keeps the added vectors and Deserialize() adds them
+    // again. The delta is bounded by delta_max_points: the Add that would go past it merges the delta into the disk
+    // index instead, by rebuilding the disk index from all the points, which keeps their ids.
+    diskann::Metric metric_ = diskann::Metric::L2;
+    std::mutex delta_add_lock_;
+    mutable std::shared_mutex delta_data_lock_;
+    std::unique_ptr<diskann::Index<DataType, uint32_t>> delta_index_;
+    std::vector<float> delta_norms_;  // cosine only, the delta keeps the normalized vectors
+    uint32_t delta_max_degree_ = 0;
+    uint32_t delta_build_l_ = 0;
+    uint32_t delta_search_l_ = 0;
+    int64_t delta_point_size_ = 0;
+    std::atomic_int64_t delta_count_{0};
+    std::atomic_int64_t delta_mem_size_{0};
 };
 
 }  // namespace knowhere
@@ -273,6 +364,30 @@ class DiskANNIndexNode : public IndexNode {
 namespace knowhere {
 namespace {
 static constexpr float kCacheExpansionRate = 1.2;
+// graph parameters of the in-memory delta that are not taken from the config
+static constexpr float kDeltaAlpha = 1.2;
+static constexpr uint32_t kDeltaMaxCandidates = 750;
+static constexpr uint32_t kDeltaMinSearchListSize = 256;
+// the index files of a merge are built under the index prefix followed by this, then moved over the index's ones
+static constexpr const char* kMergePrefixSuffix = "_merge";
+// the number of points on disk read at a time while writing the raw data of a merge
+static constexpr int64_t kMergeReadBatchSize = 4096;
+
+// L2 or inner product between two points of the in-memory delta
+template <typename DataType>
+float
+DeltaDistance(const DataType* x, const DataType* y, size_t dim, bool is_l2) {
+    if constexpr (std::is_same_v<DataType, fp16>) {
+        return is_l2 ? faiss::cppcontrib::knowhere::fp16_vec_L2sqr(x, y, dim)
+                     : faiss::cppcontrib::knowhere::fp16_vec_inner_product(x, y, dim);
+    } else if constexpr (std::is_same_v<DataType, bf16>) {
+        return is_l2 ? faiss::cppcontrib::knowhere::bf16_vec_L2sqr(x, y, dim)
+                     : faiss::cppcontrib::knowhere::bf16_vec_inner_product(x, y, dim);
+    } else {
+        return is_l2 ? faiss::cppcontrib::knowhere::fvec_L2sqr(x, y, dim)
+                     : faiss::cppcontrib::knowhere::fvec_inner_product(x, y, dim);
+    }
+}
 
 Status
 ReadEmbListOffsetFromFile(const std::string& file_path, std::vector<size_t>& offsets) {
@@ -443,26 +558,7 @@ DiskANNIndexNode<DataType>::Build(const DataSetPtr dataset, std::shared_ptr<Conf
             return diskann::Metric::INNER_PRODUCT;
         }
     }();
-    auto num_nodes_to_cache =
-        GetCachedNodeNum(build_conf.search_cache_budget_gb.value(), dim, build_conf.max_degree.value());
-    diskann::BuildConfig diskann_internal_build_config{data_path,
-                                                       index_prefix_,
-                                                       diskann_metric,
-                                                       static_cast<unsigned>(build_conf.max_degree.value()),
-                                                       static_cast<unsigned>(build_conf.search_list_size.value()),
-                                                       static_cast<double>(build_conf.pq_code_budget_gb.value()),
-                                                       static_cast<double>(build_conf.build_dram_budget_gb.value()),
-                                                       static_cast<uint32_t>(build_conf.disk_pq_dims.value()),
-                                                       false,
-                                                       build_conf.accelerate_build.value(),
-                                                       static_cast<uint32_t>(num_nodes_to_cache),
-                                                       build_conf.shuffle_build.value()};
-    RETURN_IF_ERROR(TryDiskANNCall([&]() {
-        int res = diskann::build_disk_index<DataType>(diskann_internal_build_config);
-        if (res != 0)
-            throw diskann::ANNException("diskann::build_disk_index returned non-zero value: " + std::to_string(res),
-                                        -1);
-    }));
+    RETURN_IF_ERROR(BuildDiskIndex(build_conf, diskann_metric, data_path, index_prefix_, dim));
 
     // Add file to the file manager
     for (auto& filename : GetNecessaryFilenames(index_prefix_, need_norm, true, true)) {
@@ -482,6 +578,34 @@ DiskANNIndexNode<DataType>::Build(const DataSetPtr dataset, std::shared_ptr<Conf
     return Status::success;
 }
 
+template <typename DataType>
+Status
+DiskANNIndexNode<DataType>::BuildDiskIndex(const DiskANNConfig& build_conf, const diskann::Metric diskann_metric,
+                                           const std::string& data_path, const std::string& prefix,
+                                           const uint64_t dim) {
+    auto num_nodes_to_cache =
+        GetCachedNodeNum(build_conf.search_cache_budget_gb.value(), dim, build_conf.max_degree.value());
+    diskann::BuildConfig diskann_internal_build_config{data_path,
+                                                       prefix,
+                                                       diskann_metric,
+                                                       static_cast<unsigned>(build_conf.max_degree.value()),
+                                                       static_cast<unsigned>(build_conf.search_list_size.value()),
+                                                       static_cast<double>(build_conf.pq_code_budget_gb.value()),
+                                                       static_cast<double>(build_conf.build_dram_budget_gb.value()),
+                                                       static_cast<uint32_t>(build_conf.disk_pq_dims.value()),
+                                                       false,
+                                                       build_conf.accelerate_build.value(),
+                                                       static_cast<uint32_t>(num_nodes_to_cache),
+                                                       build_conf.shuffle_build.value()};
+    diskann_internal_build_config.bfs_layout = build_conf.reorder.value();
+    return TryDiskANNCall([&]() {
+        int res = diskann::build_disk_index<DataType>(diskann_internal_build_config);
+        if (res != 0)
+            throw diskann::ANNException("diskann::build_disk_index returned non-zero value: " + std::to_string(res),
+                                        -1);
+    });
+}
+
 template <typename DataType>
 Status
 DiskANNIndexNode<DataType>::BuildEmbListIfNeed(const DataSetPtr dataset, std::shared_ptr<Config> cfg,
@@ -539,6 +663,300 @@ DiskANNIndexNode<DataType>::BuildEmbListIfNeed(const DataSetPtr dataset, std::sh
     return Status::success;
 }
 
+template <typename DataType>
+Status
+DiskANNIndexNode<DataType>::Add(const DataSetPtr dataset, std::shared_ptr<Config> cfg, bool use_knowhere_build_pool) {
+    if (!is_prepared_.load() || !pq_flash_index_) {
+        LOG_KNOWHERE_ERROR_ << "DiskANN only supports adding points to a loaded index, use Build instead.";
+        return Status::not_implemented;
+    }
+    if (emb_list_offset_ != nullptr) {
+        LOG_KNOWHERE_ERROR_ << "DiskANN doesn't support adding points to an emb_list index.";
+        return Status::not_implemented;
+    }
+    if (dataset == nullptr || dataset->GetTensor() == nullptr) {
+        LOG_KNOWHERE_ERROR_ << "Empty dataset to add.";
+        return Status::invalid_args;
+    }
+    auto add_conf = static_cast<const DiskANNConfig&>(*cfg);
+    auto rows = dataset->GetRows();
+    auto dim = dataset->GetDim();
+    auto data = static_cast<const DataType*>(dataset->GetTensor());
+    if (dim != dim_.load()) {
+        LOG_KNOWHERE_ERROR_ << "Dim of the points to add(" << dim << ") doesn't match the index(" << dim_.load()
+                            << ").";
+        return Status::invalid_args;
+    }
+
+    std::lock_guard<std::mutex> lock(delta_add_lock_);
+    auto max_points = add_conf.delta_max_points.value();
+    if (max_points == 0) {
+        max_points = std::max<int64_t>(count_.load() / 10, 1);
+    }
+    if (delta_count_.load() + rows > max_points) {
+        LOG_KNOWHERE_INFO_ << "Adding " << rows << " points to the " << delta_count_.load()
+                           << " in the in-memory delta goes past its bound of " << max_points
+                           << " points, merging them into the disk index.";
+        return MergeDelta(add_conf, data, rows);
+    }
+    return AddToDelta(data, rows, static_cast<uint32_t>(add_conf.max_degree.value()),
+                      static_cast<uint32_t>(add_conf.search_list_size.value()), max_points);
+}
+
+template <typename DataType>
+Status
+DiskANNIndexNode<DataType>::AddToDelta(const DataType* data, const int64_t rows, const uint32_t max_degree,
+                                       const uint32_t build_l, const int64_t initial_points) {
+    const auto dim = dim_.load();
+    const bool is_cosine = metric_ == diskann::Metric::COSINE;
+    if (delta_index_ == nullptr) {
+        auto max_points = std::max(initial_points, rows);
+        delta_max_degree_ = max_degree;
+        delta_build_l_ = build_l;
+        delta_search_l_ = std::max(build_l, kDeltaMinSearchListSize);
+        diskann::Parameters index_params;
+        index_params.Set<unsigned>("L", build_l);
+        index_params.Set<unsigned>("R", max_degree);
+        index_params.Set<unsigned>("C", kDeltaMaxCandidates);
+        index_params.Set<float>("alpha", kDeltaAlpha);
+        diskann::Parameters search_params;
+        search_params.Set<unsigned>("L", delta_search_l_);
+        // the delta keeps normalized vectors for cosine, so that both metrics rank by inner product
+        auto delta_metric = metric_ == diskann::Metric::L2 ? diskann::Metric::L2 : diskann::Metric::INNER_PRODUCT;
+        if (TryDiskANNCall([&]() {
+                delta_index_ = std::make_unique<diskann::Index<DataType, uint32_t>>(
+                    delta_metric, false, dim, max_points, true, index_params, search_params, true);
+            }) != Status::success) {
+            LOG_KNOWHERE_ERROR_ << "Failed to create the in-memory delta for DiskANN.";
+            return Status::diskann_inner_error;
+        }
+        delta_point_size_ =
+            ROUND_UP(dim, 8) * sizeof(DataType) + max_degree * sizeof(uint32_t) + (is_cosine ? sizeof(float) : 0);
+        delta_mem_size_.store(max_points * delta_point_size_);
+        LOG_KNOWHERE_INFO_ << "Created the in-memory delta for " << max_points << " added points.";
+    }
+
+    std::unique_ptr<DataType[]> normalized;
+    std::vector<float> norms;
+    if (is_cosine) {
+        normalized = std::make_unique<DataType[]>(rows * dim);
+        std::copy_n(data, rows * dim, normalized.get());
+        norms = NormalizeVecs(normalized.get(), rows, dim);
+        data = normalized.get();
+    }
+    // the points are inserted one by one so that the delta's locations are their insertion order, and each becomes
+    // visible to searches as soon as it is linked into the graph. An insert may grow the delta, which moves its
+    // vectors, so it excludes the readers of the vectors.
+    auto n_delta = delta_count_.load();
+    auto status = TryDiskANNCall([&]() {
+        for (int64_t i = 0; i < rows; ++i) {
+            auto tag = static_cast<uint32_t>(n_delta + i);
+            {
+                std::unique_lock<std::shared_mutex> data_lock(delta_data_lock_);
+                delta_index_->insert_point(data + i * dim, tag);
+                if (is_cosine) {
+                    delta_norms_.push_back(norms[i]);
+                }
+            }
+            delta_count_.store(n_delta + i + 1, std::memory_order_release);
+        }
+    });
+    auto n_allocated = delta_mem_size_.load() / delta_point_size_;
+    if (delta_count_.load() > n_allocated) {
+        delta_mem_size_.store(delta_count_.load() * delta_point_size_);
+    }
+    if (status != Status::success) {
+        LOG_KNOWHERE_ERROR_ << "Failed to add points to the in-memory delta, " << delta_count_.load() - n_delta
+                            << " of " << rows << " were added.";
+        return Status::diskann_inner_error;
+    }
+    return Status::success;
+}
+
+template <typename DataType>
+bool
+DiskANNIndexNode<DataType>::GetDeltaVector(uint32_t tag, DataType* vec) const {
+    if (delta_index_->get_vector_by_tag(tag, vec) != 0) {
+        return false;
+    }
+    if (metric_ == diskann::Metric::COSINE) {
+        const auto dim = dim_.load();
+        for (int64_t j = 0; j < dim; ++j) {
+            vec[j] = static_cast<DataType>(static_cast<float>(vec[j]) * delta_norms_[tag]);
+        }
+    }
+    return true;
+}
+
+template <typename DataType>
+Status
+DiskANNIndexNode<DataType>::SerializeDelta(BinarySet& binset) const {
+    // Serialized format: n_delta, dim, max_degree and build_l of the delta as uint64_t, followed by the n_delta added
+    // vectors as they were added.
+    std::shared_lock<std::shared_mutex> data_lock(delta_data_lock_);
+    const uint64_t n_delta = delta_count_.load(std::memory_order_acquire);
+    const uint64_t dim = dim_.load();
+    const uint64_t header[4] = {n_delta, dim, delta_max_degree_, delta_build_l_};
+    const auto size = sizeof(header) + n_delta * dim * sizeof(DataType);
+    std::shared_ptr<uint8_t[]> data(new uint8_t[size]);
+    std::memcpy(data.get(), header, sizeof(header));
+    auto vecs = reinterpret_cast<DataType*>(data.get() + sizeof(header));
+    for (uint64_t i = 0; i < n_delta; ++i) {
+        if (!GetDeltaVector(static_cast<uint32_t>(i), vecs + i * dim)) {
+            LOG_KNOWHERE_ERROR_ << "Failed to read the added point " << i << " from the in-memory delta.";
+            return Status::diskann_inner_error;
+        }
+    }
+    binset.Append(DeltaBinaryName(), data, size);
+    return Status::success;
+}
+
+template <typename DataType>
+Status
+DiskANNIndexNode<DataType>::DeserializeDelta(const BinaryPtr& binary) {
+    uint64_t header[4];
+    if (binary->size < static_cast<int64_t>(sizeof(header))) {
+        LOG_KNOWHERE_ERROR_ << "Invalid serialized DiskANN delta.";
+        return Status::invalid_binary_set;
+    }
+    std::memcpy(header, binary->data.get(), sizeof(header));
+    const auto [n_delta, dim, max_degree, build_l] = header;
+    if (dim != static_cast<uint64_t>(dim_.load()) ||
+        static_cast<uint64_t>(binary->size) != sizeof(header) + n_delta * dim * sizeof(DataType)) {
+        LOG_KNOWHERE_ERROR_ << "The serialized DiskANN delta doesn't match the index.";
+        return Status::invalid_binary_set;
+    }
+    LOG_KNOWHERE_INFO_ << "Adding the " << n_delta << " serialized points to the in-memory delta.";
+    std::lock_guard<std::mutex> lock(delta_add_lock_);
+    return AddToDelta(reinterpret_cast<const DataType*>(binary->data.get() + sizeof(header)), n_delta,
+                      static_cast<uint32_t>(max_degree), static_cast<uint32_t>(build_l), n_delta);
+}
+
+template <typename DataType>
+Status
+DiskANNIndexNode<DataType>::MergeDelta(const DiskANNConfig& build_conf, const DataType* data, const int64_t rows) {
+    if (build_conf.pq_code_budget_gb.value() <= 0 || build_conf.build_dram_budget_gb.value() <= 0) {
+        LOG_KNOWHERE_ERROR_ << "Merging the added points into the disk index needs the build parameters "
+                               "pq_code_budget_gb and build_dram_budget_gb.";
+        return Status::invalid_args;
+    }
+    const auto disk_count = count_.load();
+    const auto n_delta = delta_count_.load();
+    const auto dim = dim_.load();
+    const auto n_total = disk_count + n_delta + rows;
+    const bool need_norm = metric_ != diskann::Metric::L2;
+    const auto merge_prefix = index_prefix_ + kMergePrefixSuffix;
+    const auto data_path = merge_prefix + "_raw_data.bin";
+    auto merge_filenames = GetNecessaryFilenames(merge_prefix, need_norm, true, true);
+    for (auto& filename : GetOptionalFilenames(merge_prefix)) {
+        merge_filenames.push_back(filename);
+    }
+    // the files of an earlier merge that failed
+    for (auto& filename : merge_filenames) {
+        std::remove(filename.c_str());
+    }
+
+    // The raw data of the rebuild is written in the format Build reads from data_path: the points on disk, then the
+    // ones in the delta and the ones being added, so that every point keeps its id. pq_flash_index_ and the delta
+    // only change under delta_add_lock_, which the caller holds.
+    std::ofstream writer(data_path, std::ios::binary);
+    const int32_t header[2] = {static_cast<int32_t>(n_total), static_cast<int32_t>(dim)};
+    writer.write(reinterpret_cast<const char*>(header), sizeof(header));
+    auto vecs = std::make_unique<DataType[]>(kMergeReadBatchSize * dim);
+    std::vector<int64_t> ids;
+    auto status = TryDiskANNCall([&]() {
+        for (int64_t begin = 0; begin < disk_count; begin += kMergeReadBatchSize) {
+            auto n = std::min(kMergeReadBatchSize, disk_count - begin);
+            ids.resize(n);
+            std::iota(ids.begin(), ids.end(), begin);
+            pq_flash_index_->get_vector_by_ids(ids.data(), n, vecs.get());
+            writer.write(reinterpret_cast<const char*>(vecs.get()), n * dim * sizeof(DataType));
+        }
+    });
+    if (status != Status::success) {
+        LOG_KNOWHERE_ERROR_ << "Failed to read the points on disk for the merge.";
+        std::remove(data_path.c_str());
+        return status;
+    }
+    {
+        std::shared_lock<std::shared_mutex> data_lock(delta_data_lock_);
+        for (int64_t i = 0; i < n_delta; ++i) {
+            if (!GetDeltaVector(static_cast<uint32_t>(i), vecs.get())) {
+                LOG_KNOWHERE_ERROR_ << "Failed to read the added point " << i << " from the in-memory delta.";
+                std::remove(data_path.c_str());
+                return Status::diskann_inner_error;
+            }
+            writer.write(reinterpret_cast<const char*>(vecs.get()), dim * sizeof(DataType));
+        }
+    }
+    writer.write(reinterpret_cast<const char*>(data), rows * dim * sizeof(DataType));
+    writer.close();
+    if (writer.fail()) {
+        LOG_KNOWHERE_ERROR_ << "Failed to write the raw data for the merge to " << data_path << ".";
+        std::remove(data_path.c_str());
+        return Status::disk_file_error;
+    }
+
+    status = BuildDiskIndex(build_conf, metric_, data_path, merge_prefix, dim);
+    std::remove(data_path.c_str());
+    if (status != Status::success) {
+        LOG_KNOWHERE_ERROR_ << "Failed to rebuild the disk index with the added points.";
+        return status;
+    }
+
+    // The rebuilt files replace the ones of the index. The loaded index keeps reading the replaced disk index through
+    // its open file until it is swapped out below.
+    for (auto& filename : GetOptionalFilenames(index_prefix_)) {
+        if (!file_exists(merge_prefix + filename.substr(index_prefix_.size()))) {
+            std::remove(filename.c_str());
+        }
+    }
+    std::vector<std::string> index_filenames;
+    for (auto& filename : merge_filenames) {
+        if (!file_exists(filename)) {
+            continue;
+        }
+        auto index_filename = index_prefix_ + filename.substr(merge_prefix.size());
+        if (std::rename(filename.c_str(), index_filename.c_str()) != 0) {
+            LOG_KNOWHERE_ERROR_ << "Failed to move " << filename << " to " << index_filename << ".";
+            return Status::disk_file_error;
+        }
+        index_filenames.push_back(index_filename);
+    }
+
+    std::shared_ptr<diskann::PQFlashIndex<DataType>> merged_index;
+    status = LoadDiskIndex(merged_index);
+    if (status != Status::success) {
+        // the files already hold the merged points, which the loaded index and the delta don't match any more
+        LOG_KNOWHERE_ERROR_ << "Failed to load the merged DiskANN index, the index has to be loaded again.";
+        is_prepared_.store(false);
+        return status;
+    }
+
+    // the replaced index and delta are released once the searches still on them are done, outside of the lock
+    std::unique_ptr<diskann::Index<DataType, uint32_t>> delta_index;
+    std::vector<float> delta_norms;
+    {
+        std::unique_lock<std::shared_mutex> index_lock(index_lock_);
+        pq_flash_index_.swap(merged_index);
+        delta_index_.swap(delta_index);
+        delta_norms_.swap(delta_norms);
+        count_.store(n_total);
+        delta_count_.store(0, std::memory_order_release);
+        delta_mem_size_.store(0);
+    }
+    LOG_KNOWHERE_INFO_ << "Merged " << n_delta + rows << " added points into the disk index, which now holds "
+                       << n_total << " points.";
+
+    for (auto& filename : index_filenames) {
+        if (!AddFile(filename)) {
+            LOG_KNOWHERE_ERROR_ << "Failed to add file " << filename << ".";
+            return Status::disk_file_error;
+        }
+    }
+    return Status::success;
+}
+
 template <typename DataType>
 Status
 DiskANNIndexNode<DataType>::Deserialize(const BinarySet& binset, std::shared_ptr<Config> cfg) {
@@ -566,6 +984,7 @@ DiskANNIndexNode<DataType>::Deserialize(const BinarySet& binset, std::shared_ptr
             return diskann::Metric::INNER_PRODUCT;
         }
     }();
+    metric_ = diskann_metric;
 
     // Load file from file manager.
     for (auto& filename : GetNecessaryFilenames(
@@ -589,16 +1008,42 @@ DiskANNIndexNode<DataType>::Deserialize(const BinarySet& binset, std::shared_ptr
     // set thread pool
     search_pool_ = ThreadPool::GetGlobalSearchThreadPool();
 
-    // load diskann pq code and meta info
-    std::shared_ptr<AlignedFileReader> reader = nullptr;
+    load_options_ = {prep_conf.search_cache_budget_gb.value(), prep_conf.search_cache_adaptive_ratio.value(),
+                     prep_conf.use_bfs_cache.value(), prep_conf.warm_up.value()};
+    RETURN_IF_ERROR(LoadDiskIndex(pq_flash_index_));
+
+    count_.store(pq_flash_index_->get_num_points());
+    // DiskANN will add one more dim for IP type.
+    if (is_ip) {
+        dim_.store(pq_flash_index_->get_data_dim() - 1);
+    } else {
+        dim_.store(pq_flash_index_->get_data_dim());
+    }
+
+    // the points added before the index was serialized
+    if (binset.Contains(DeltaBinaryName())) {
+        auto status = DeserializeDelta(binset.GetByName(DeltaBinaryName()));
+        if (status != Status::success) {
+            return status;
+        }
+    }
 
-    reader.reset(new LinuxAlignedFileReader());
+    is_prepared_.store(true);
+    LOG_KNOWHERE_INFO_ << "End of diskann loading.";
+    return Status::success;
+}
+
+template <typename DataType>
+Status
+DiskANNIndexNode<DataType>::LoadDiskIndex(std::shared_ptr<diskann::PQFlashIndex<DataType>>& disk_index) {
+    // load diskann pq code and meta info
+    std::shared_ptr<AlignedFileReader> reader = diskann::create_aligned_file_reader();
 
-    pq_flash_index_ = std::make_unique<diskann::PQFlashIndex<DataType>>(reader, diskann_metric);
+    disk_index = std::make_shared<diskann::PQFlashIndex<DataType>>(reader, metric_);
     auto disk_ann_call = [&]() {
-        int res = pq_flash_index_->load(search_pool_->size(), index_prefix_.c_str());
+        int res = disk_index->load(search_pool_->size(), index_prefix_.c_str());
         if (res != 0) {
-            throw diskann::ANNException("pq_flash_index_->load returned non-zero value: " + std::to_string(res), -1);
+            throw diskann::ANNException("PQFlashIndex::load returned non-zero value: " + std::to_string(res), -1);
         }
     };
     if (TryDiskANNCall(disk_ann_call) != Status::success) {
@@ -606,17 +1051,13 @@ DiskANNIndexNode<DataType>::Deserialize(const BinarySet& binset, std::shared_ptr
         return Status::diskann_inner_error;
     }
 
-    count_.store(pq_flash_index_->get_num_points());
-    // DiskANN will add one more dim for IP type.
-    if (is_ip) {
-        dim_.store(pq_flash_index_->get_data_dim() - 1);
-    } else {
-        dim_.store(pq_flash_index_->get_data_dim());
-    }
-
     std::string warmup_query_file = diskann::get_sample_data_filename(index_prefix_);
     // load cache
     auto cached_nodes_file = diskann::get_cached_nodes_file(index_prefix_);
+    // the adaptive cache takes its share of the budget off the static one
+    auto adaptive_ratio = load_options_.search_cache_adaptive_ratio;
+    auto static_cache_budget_gb = load_options_.search_cache_budget_gb * (1.0f - adaptive_ratio);
+    auto adaptive_cache_budget_gb = load_options_.search_cache_budget_gb * adaptive_ratio;
     std::vector<uint32_t> node_list;
     if (file_exists(cached_nodes_file)) {
         LOG_KNOWHERE_INFO_ << "Reading cached nodes from file.";
@@ -624,19 +1065,25 @@ DiskANNIndexNode<DataType>::Deserialize(const BinarySet& binset, std::shared_ptr
         std::unique_ptr<uint32_t[]> cached_nodes_ids = nullptr;
         diskann::load_bin<uint32_t>(cached_nodes_file, cached_nodes_ids, num_nodes, nodes_id_dim);
         node_list.assign(cached_nodes_ids.get(), cached_nodes_ids.get() + num_nodes);
+        if (adaptive_ratio > 0) {
+            // the list was generated for the whole budget, keep its leading (most visited) part
+            auto num_static_nodes = GetCachedNodeNum(static_cache_budget_gb, disk_index->get_data_dim(),
+                                                     disk_index->get_max_degree());
+            node_list.resize(std::min<size_t>(node_list.size(), num_static_nodes));
+        }
     } else {
-        auto num_nodes_to_cache = GetCachedNodeNum(prep_conf.search_cache_budget_gb.value(),
-                                                   pq_flash_index_->get_data_dim(), pq_flash_index_->get_max_degree());
-        if (num_nodes_to_cache > pq_flash_index_->get_num_points() / 3) {
+        auto num_nodes_to_cache =
+            GetCachedNodeNum(static_cache_budget_gb, disk_index->get_data_dim(), disk_index->get_max_degree());
+        if (num_nodes_to_cache > disk_index->get_num_points() / 3) {
             LOG_KNOWHERE_ERROR_ << "Failed to generate cache, num_nodes_to_cache(" << num_nodes_to_cache
                                 << ") is larger than 1/3 of the total data number.";
             return Status::invalid_args;
         }
         if (num_nodes_to_cache > 0) {
             LOG_KNOWHERE_INFO_ << "Caching " << num_nodes_to_cache << " sample nodes around medoid(s).";
-            if (prep_conf.use_bfs_cache.value()) {
+            if (load_options_.use_bfs_cache) {
                 LOG_KNOWHERE_INFO_ << "Use bfs to generate cache list";
-                if (TryDiskANNCall([&]() { pq_flash_index_->cache_bfs_levels(num_nodes_to_cache, node_list); }) !=
+                if (TryDiskANNCall([&]() { disk_index->cache_bfs_levels(num_nodes_to_cache, node_list); }) !=
                     Status::success) {
                     LOG_KNOWHERE_ERROR_ << "Failed to generate bfs cache for DiskANN.";
                     return Status::diskann_inner_error;
@@ -644,8 +1091,8 @@ DiskANNIndexNode<DataType>::Deserialize(const BinarySet& binset, std::shared_ptr
             } else {
                 LOG_KNOWHERE_INFO_ << "Use sample_queries to generate cache list";
                 if (TryDiskANNCall([&]() {
-                        pq_flash_index_->async_generate_cache_list_from_sample_queries(warmup_query_file, 15, 6,
-                                                                                       num_nodes_to_cache);
+                        disk_index->async_generate_cache_list_from_sample_queries(warmup_query_file, 15, 6,
+                                                                                  num_nodes_to_cache);
                     }) != Status::success) {
                     LOG_KNOWHERE_ERROR_ << "Failed to generate cache from sample queries for DiskANN.";
                     return Status::diskann_inner_error;
@@ -656,14 +1103,24 @@ DiskANNIndexNode<DataType>::Deserialize(const BinarySet& binset, std::shared_ptr
     }
 
     if (node_list.size() > 0) {
-        if (TryDiskANNCall([&]() { pq_flash_index_->load_cache_list(node_list); }) != Status::success) {
+        if (TryDiskANNCall([&]() { disk_index->load_cache_list(node_list); }) != Status::success) {
             LOG_KNOWHERE_ERROR_ << "Failed to load cache for DiskANN.";
             return Status::diskann_inner_error;
         }
     }
 
+    auto num_adaptive_nodes =
+        GetCachedNodeNum(adaptive_cache_budget_gb, disk_index->get_data_dim(), disk_index->get_max_degree());
+    if (num_adaptive_nodes > 0) {
+        LOG_KNOWHERE_INFO_ << "Caching up to " << num_adaptive_nodes << " nodes adaptively while searching.";
+        if (TryDiskANNCall([&]() { disk_index->enable_adaptive_cache(num_adaptive_nodes); }) != Status::success) {
+            LOG_KNOWHERE_ERROR_ << "Failed to set up the adaptive cache for DiskANN.";
+            return Status::diskann_inner_error;
+        }
+    }
+
     // warmup
-    if (prep_conf.warm_up.value()) {
+    if (load_options_.warm_up) {
         LOG_KNOWHERE_INFO_ << "Warming up.";
         uint64_t warmup_L = 20;
         uint64_t warmup_num = 0;
@@ -684,9 +1141,9 @@ DiskANNIndexNode<DataType>::Deserialize(const BinarySet& binset, std::shared_ptr
         futures.reserve(warmup_num);
         for (_s64 i = 0; i < (int64_t)warmup_num; ++i) {
             futures.emplace_back(search_pool_->push([&, index = i]() {
-                pq_flash_index_->cached_beam_search(warmup + (index * warmup_aligned_dim), 1, warmup_L,
-                                                    warmup_result_ids_64.data() + (index * 1),
-                                                    warmup_result_dists.data() + (index * 1), 4);
+                disk_index->cached_beam_search(warmup + (index * warmup_aligned_dim), 1, warmup_L,
+                                               warmup_result_ids_64.data() + (index * 1),
+                                               warmup_result_dists.data() + (index * 1), 4);
             }));
         }
 
@@ -701,9 +1158,6 @@ DiskANNIndexNode<DataType>::Deserialize(const BinarySet& binset, std::shared_ptr
             return Status::diskann_inner_error;
         }
     }
-
-    is_prepared_.store(true);
-    LOG_KNOWHERE_INFO_ << "End of diskann loading.";
     return Status::success;
 }
 
@@ -768,6 +1222,7 @@ template <typename DataType>
 expected<std::vector<IndexNode::IteratorPtr>>
 DiskANNIndexNode<DataType>::AnnIterator(const DataSetPtr dataset, std::unique_ptr<Config> cfg, const BitsetView& bitset,
                                         bool use_knowhere_search_pool, milvus::OpContext* op_context) const {
+    std::shared_lock<std::shared_mutex> index_lock(index_lock_);
     if (!is_prepared_.load() || !pq_flash_index_) {
         LOG_KNOWHERE_ERROR_ << "Failed to load diskann.";
         return expected<std::vector<IndexNode::IteratorPtr>>::Err(Status::empty_index, "DiskANN not loaded");
@@ -795,8 +1250,13 @@ DiskANNIndexNode<DataType>::AnnIterator(const DataSetPtr dataset, std::unique_pt
     try {
         for (int i = 0; i < nq; i++) {
             auto single_query = (DataType*)xq + i * dim;
+            // the points added after loading are not in the disk graph, the iterator hands them out by exact distance
+            std::vector<DistId> delta_dists;
+            if (delta_count_.load(std::memory_order_acquire) > 0) {
+                delta_dists = DeltaDistances(single_query, bitset);
+            }
             auto it = std::make_shared<iterator>(transform, single_query, lsearch, beamwidth, filter_ratio, bitset,
-                                                 pq_flash_index_.get(), use_knowhere_search_pool);
+                                                 pq_flash_index_, std::move(delta_dists), use_knowhere_search_pool);
             vec[i] = it;
         }
     } catch (const std::exception& e) {
@@ -810,6 +1270,7 @@ template <typename DataType>
 expected<DataSetPtr>
 DiskANNIndexNode<DataType>::Search(const DataSetPtr dataset, std::unique_ptr<Config> cfg, const BitsetView& bitset_,
                                    milvus::OpContext* op_context) const {
+    std::shared_lock<std::shared_mutex> index_lock(index_lock_);
     if (!is_prepared_.load() || !pq_flash_index_) {
         LOG_KNOWHERE_ERROR_ << "Failed to load diskann.";
         return expected<DataSetPtr>::Err(Status::empty_index, "DiskANN not loaded");
@@ -866,23 +1327,55 @@ DiskANNIndexNode<DataType>::Search(const DataSetPtr dataset, std::unique_ptr<Con
     auto p_dist = std::make_unique<DistType[]>(k * nq);
 
     std::vector<folly::Future<folly::Unit>> futures;
-    futures.reserve(nq);
-    for (int64_t row = 0; row < nq; ++row) {
-        futures.emplace_back(search_pool_->push([&, index = row, p_id_ptr = p_id.get(), p_dist_ptr = p_dist.get()]() {
-            knowhere::checkCancellation(op_context);
-            diskann::QueryStats stats;
-            pq_flash_index_->cached_beam_search(xq + (index * dim), k, lsearch, p_id_ptr + (index * k),
-                                                p_dist_ptr + (index * k), beamwidth, false, &stats, feder_result,
-                                                bitset, filter_ratio);
+    auto queries_per_thread = static_cast<int64_t>(search_conf.queries_per_thread.value());
+    if (queries_per_thread > 1 && nq > 1 && feder_result == nullptr) {
+        // Every query in flight still holds one of the search_pool_->size() scratches, so spread the queries over
+        // just enough threads to have all of them in use.
+        auto n_threads = std::max<int64_t>(1, static_cast<int64_t>(search_pool_->size()) / queries_per_thread);
+        n_threads = std::min(n_threads, (nq + queries_per_thread - 1) / queries_per_thread);
+        auto rows_per_thread = (nq + n_threads - 1) / n_threads;
+        futures.reserve(n_threads);
+        for (int64_t begin = 0; begin < nq; begin += rows_per_thread) {
+            auto n_rows = std::min(rows_per_thread, nq - begin);
+            futures.emplace_back(search_pool_->push(
+                [&, begin, n_rows, p_id_ptr = p_id.get(), p_dist_ptr = p_dist.get()]() {
+                    knowhere::checkCancellation(op_context);
+                    std::vector<diskann::QueryStats> stats(n_rows);
+                    pq_flash_index_->batch_cached_beam_search(
+                        xq + (begin * dim), n_rows, dim, k, lsearch, p_id_ptr + (begin * k),
+                        p_dist_ptr + (begin * k), beamwidth, queries_per_thread, stats.data(), bitset, filter_ratio);
 #ifdef NOT_COMPILE_FOR_SWIG
-            knowhere_diskann_search_hops.Observe(stats.n_hops);
+                    for (const auto& s : stats) {
+                        knowhere_diskann_search_hops.Observe(s.n_hops);
+                        knowhere_cache_hit_cnt.Observe(s.n_cache_hits);
+                    }
 #endif
-        }));
+                }));
+        }
+    } else {
+        futures.reserve(nq);
+        for (int64_t row = 0; row < nq; ++row) {
+            futures.emplace_back(
+                search_pool_->push([&, index = row, p_id_ptr = p_id.get(), p_dist_ptr = p_dist.get()]() {
+                    knowhere::checkCancellation(op_context);
+                    diskann::QueryStats stats;
+                    pq_flash_index_->cached_beam_search(xq + (index * dim), k, lsearch, p_id_ptr + (index * k),
+                                                        p_dist_ptr + (index * k), beamwidth, false, &stats,
+                                                        feder_result, bitset, filter_ratio);
+#ifdef NOT_COMPILE_FOR_SWIG
+                    knowhere_diskann_search_hops.Observe(stats.n_hops);
+                    knowhere_cache_hit_cnt.Observe(stats.n_cache_hits);
+#endif
+                }));
+        }
     }
 
     if (TryDiskANNCall([&]() { WaitAllSuccess(futures); }) != Status::success) {
         return expected<DataSetPtr>::Err(Status::diskann_inner_error, "some search failed");
     }
+    if (MergeDeltaResults(xq, nq, dim, k, lsearch, bitset_, p_id.get(), p_dist.get()) != Status::success) {
+        return expected<DataSetPtr>::Err(Status::diskann_inner_error, "some search of the in-memory delta failed");
+    }
 
     auto res = GenResultDataSet(nq, k, std::move(p_id), std::move(p_dist));
 
@@ -897,6 +1390,105 @@ DiskANNIndexNode<DataType>::Search(const DataSetPtr dataset, std::unique_ptr<Con
     return res;
 }
 
+template <typename DataType>
+Status
+DiskANNIndexNode<DataType>::MergeDeltaResults(const DataType* xq, const int64_t nq, const int64_t dim, const uint64_t k,
+                                              const uint64_t lsearch, const BitsetView& bitset, int64_t* p_id,
+                                              DistType* p_dist) const {
+    auto n_delta = delta_count_.load(std::memory_order_acquire);
+    if (n_delta == 0) {
+        return Status::success;
+    }
+    const auto disk_count = count_.load();
+    const bool is_l2 = metric_ == diskann::Metric::L2;
+    const bool is_cosine = metric_ == diskann::Metric::COSINE;
+    // the delta is searched with the same list size as the disk graph, and all of the list is kept so that points
+    // filtered out by the bitset do not leave the top-k short
+    const auto delta_l = static_cast<uint32_t>(std::min<uint64_t>(std::max(k, lsearch), delta_search_l_));
+    const auto delta_k = std::min<uint64_t>(delta_l, n_delta);
+
+    std::vector<folly::Future<folly::Unit>> futures;
+    futures.reserve(nq);
+    for (int64_t row = 0; row < nq; ++row) {
+        futures.emplace_back(search_pool_->push([&, row]() {
+            const DataType* query = xq + row * dim;
+            std::unique_ptr<DataType[]> normalized;
+            if (is_cosine) {
+                normalized = CopyAndNormalizeVecs(query, 1, dim);
+                query = normalized.get();
+            }
+            // points inserted while searching may show up in the graph before they are counted, skip them
+            std::vector<uint32_t> locs(delta_k, std::numeric_limits<uint32_t>::max());
+            std::vector<float> dists(delta_k);
+            delta_index_->search(query, delta_k, delta_l, locs.data(), dists.data());
+
+            std::vector<std::pair<DistType, int64_t>> candidates;
+            candidates.reserve(k + delta_k);
+            for (uint64_t i = 0; i < k; ++i) {
+                if (p_id[row * k + i] != -1) {
+                    candidates.emplace_back(p_dist[row * k + i], p_id[row * k + i]);
+                }
+            }
+            for (uint64_t i = 0; i < delta_k; ++i) {
+                if (locs[i] >= n_delta) {
+                    continue;
+                }
+                auto id = disk_count + static_cast<int64_t>(locs[i]);
+                if (!bitset.empty() && static_cast<size_t>(id) < bitset.size() && bitset.test(id)) {
+                    continue;
+                }
+                candidates.emplace_back(dists[i], id);
+            }
+            auto n = std::min<size_t>(k, candidates.size());
+            std::partial_sort(candidates.begin(), candidates.begin() + n, candidates.end(),
+                              [is_l2](const auto& a, const auto& b) { return is_l2 ? a < b : a > b; });
+            for (uint64_t i = 0; i < k; ++i) {
+                if (i < n) {
+                    p_dist[row * k + i] = candidates[i].first;
+                    p_id[row * k + i] = candidates[i].second;
+                } else {
+                    // same as the disk search leaves the slots it cannot fill
+                    p_dist[row * k + i] = -1;
+                    p_id[row * k + i] = -1;
+                }
+            }
+        }));
+    }
+    return TryDiskANNCall([&]() { WaitAllSuccess(futures); });
+}
+
+template <typename DataType>
+std::vector<DistId>
+DiskANNIndexNode<DataType>::DeltaDistances(const DataType* query, const BitsetView& bitset) const {
+    auto n_delta = delta_count_.load(std::memory_order_acquire);
+    const auto dim = dim_.load();
+    const auto disk_count = count_.load();
+    const bool is_l2 = metric_ == diskann::Metric::L2;
+    std::unique_ptr<DataType[]> normalized;
+    if (metric_ == diskann::Metric::COSINE) {
+        normalized = CopyAndNormalizeVecs(query, 1, dim);
+        query = normalized.get();
+    }
+
+    std::vector<DistId> distances;
+    distances.reserve(n_delta);
+    auto vec = std::make_unique<DataType[]>(dim);
+    std::shared_lock<std::shared_mutex> data_lock(delta_data_lock_);
+    for (int64_t i = 0; i < n_delta; ++i) {
+        auto id = disk_count + i;
+        if (!bitset.empty() && static_cast<size_t>(id) < bitset.size() && bitset.test(id)) {
+            continue;
+        }
+        // the stored vectors are normalized for cosine, like the query
+        auto tag = static_cast<uint32_t>(i);
+        if (delta_index_->get_vector_by_tag(tag, vec.get()) != 0) {
+            continue;
+        }
+        distances.emplace_back(id, DeltaDistance(query, vec.get(), dim, is_l2));
+    }
+    return distances;
+}
+
 template <typename DataType>
 expected<DataSetPtr>
 DiskANNIndexNode<DataType>::CalcDistByIDs(const DataSetPtr dataset, const BitsetView& bitset, const int64_t* labels,
@@ -904,6 +1496,7 @@ DiskANNIndexNode<DataType>::CalcDistByIDs(const DataSetPtr dataset, const Bitset
                                           milvus::OpContext* op_context) const {
     (void)bitset;
     (void)is_cosine;
+    std::shared_lock<std::shared_mutex> index_lock(index_lock_);
     if (!is_prepared_.load() || !pq_flash_index_) {
         LOG_KNOWHERE_ERROR_ << "Failed to load diskann.";
         return expected<DataSetPtr>::Err(Status::empty_index, "DiskANN not loaded");
@@ -952,6 +1545,7 @@ DiskANNIndexNode<DataType>::CalcDistByIDs(const DataSetPtr dataset, const Bitset
 template <typename DataType>
 expected<DataSetPtr>
 DiskANNIndexNode<DataType>::GetVectorByIds(const DataSetPtr dataset, milvus::OpContext* op_context) const {
+    std::shared_lock<std::shared_mutex> index_lock(index_lock_);
     if (!is_prepared_.load() || !pq_flash_index_) {
         LOG_KNOWHERE_ERROR_ << "Failed to load diskann.";
         return expected<DataSetPtr>::Err(Status::empty_index, "index not loaded");
@@ -965,10 +1559,44 @@ DiskANNIndexNode<DataType>::GetVectorByIds(const DataSetPtr dataset, milvus::OpC
         return expected<DataSetPtr>::Err(Status::malloc_error, "failed to allocate memory for data");
     }
 
-    if (TryDiskANNCall([&]() { pq_flash_index_->get_vector_by_ids(ids, rows, data); }) != Status::success) {
-        delete[] data;
-        return expected<DataSetPtr>::Err(Status::diskann_inner_error, "failed to get vector");
-    };
+    auto n_delta = delta_count_.load(std::memory_order_acquire);
+    if (n_delta == 0) {
+        if (TryDiskANNCall([&]() { pq_flash_index_->get_vector_by_ids(ids, rows, data); }) != Status::success) {
+            delete[] data;
+            return expected<DataSetPtr>::Err(Status::diskann_inner_error, "failed to get vector");
+        };
+        return GenResultDataSet(rows, dim, data);
+    }
+
+    // the points added after loading are copied from the delta, the rest is read from disk in one go
+    const auto disk_count = count_.load();
+    std::vector<int64_t> disk_ids;
+    std::vector<int64_t> disk_rows;
+    for (int64_t i = 0; i < rows; ++i) {
+        if (ids[i] < disk_count) {
+            disk_ids.push_back(ids[i]);
+            disk_rows.push_back(i);
+            continue;
+        }
+        std::shared_lock<std::shared_mutex> data_lock(delta_data_lock_);
+        if (ids[i] - disk_count >= n_delta ||
+            !GetDeltaVector(static_cast<uint32_t>(ids[i] - disk_count), data + i * dim)) {
+            delete[] data;
+            return expected<DataSetPtr>::Err(Status::invalid_args, "id " + std::to_string(ids[i]) + " not found");
+        }
+    }
+    if (!disk_ids.empty()) {
+        auto disk_data = std::make_unique<DataType[]>(disk_ids.size() * dim);
+        if (TryDiskANNCall([&]() {
+                pq_flash_index_->get_vector_by_ids(disk_ids.data(), disk_ids.size(), disk_data.get());
+            }) != Status::success) {
+            delete[] data;
+            return expected<DataSetPtr>::Err(Status::diskann_inner_error, "failed to get vector");
+        }
+        for (size_t i = 0; i < disk_ids.size(); ++i) {
+            std::copy_n(disk_data.get() + i * dim, dim, data + disk_rows[i] * dim);
+        }
+    }
 
     return GenResultDataSet(rows, dim, data);
 }
@@ -976,6 +1604,7 @@ DiskANNIndexNode<DataType>::GetVectorByIds(const DataSetPtr dataset, milvus::OpC
 template <typename DataType>
 expected<DataSetPtr>
 DiskANNIndexNode<DataType>::GetIndexMeta(std::unique_ptr<Config> cfg) const {
+    std::shared_lock<std::shared_mutex> index_lock(index_lock_);
     std::vector<int64_t> entry_points;
     for (size_t i = 0; i < pq_flash_index_->get_num_medoids(); i++) {
         entry_points.push_back(pq_flash_index_->get_medoids()[i]);
@@ -984,7 +1613,8 @@ DiskANNIndexNode<DataType>::GetIndexMeta(std::unique_ptr<Config> cfg) const {
     feder::diskann::DiskANNMeta meta(diskann_conf.data_path.value(), diskann_conf.max_degree.value(),
                                      diskann_conf.search_list_size.value(), diskann_conf.pq_code_budget_gb.value(),
                                      diskann_conf.build_dram_budget_gb.value(), diskann_conf.disk_pq_dims.value(),
-                                     diskann_conf.accelerate_build.value(), Count(), entry_points);
+                                     diskann_conf.accelerate_build.value(), count_.load() + delta_count_.load(),
+                                     entry_points);
     std::unordered_set<int64_t> id_set(entry_points.begin(), entry_points.end());
 
     Json json_meta, json_id_set;
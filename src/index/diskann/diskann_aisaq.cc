@@ -5,9 +5,9 @@
 
 #include "diskann/aisaq.h"
 #include "diskann/aux_utils.h"
-#include "diskann/linux_aligned_file_reader.h"
 #include "diskann/pq_flash_aisaq_index.h"
 #include "diskann/pq_flash_index.h"
+#include "diskann/uring_aligned_file_reader.h"
 #include "filemanager/FileManager.h"
 #include "fmt/core.h"
 #include "index/diskann/aisaq_config.h"
@@ -469,9 +469,7 @@ AisaqIndexNode<DataType>::Deserialize(const BinarySet& binset, std::shared_ptr<C
     search_pool_ = ThreadPool::GetGlobalSearchThreadPool();
 
     // load diskann pq code and meta info
-    std::shared_ptr<AlignedFileReader> reader = nullptr;
-
-    reader.reset(new LinuxAlignedFileReader());
+    std::shared_ptr<AlignedFileReader> reader = diskann::create_aligned_file_reader();
 
     pq_flash_index_ = std::make_unique<diskann::PQFlashAisaqIndex<DataType>>(reader, diskann_metric);
 
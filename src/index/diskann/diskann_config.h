@@ -55,6 +55,10 @@ class DiskANNConfig : public BaseConfig {
     // This is the flag to enable fast build, in which we will not build vamana graph by full 2 round. This can
     // accelerate index build ~30% with an ~1% recall regression.
     CFG_BOOL accelerate_build;
+    // Write the nodes to disk in breadth-first order of the graph from the medoid instead of in id order. The nodes a
+    // search expands together then tend to share a sector, and a sector already read for one of them is not read
+    // again. The ids, and so the results, do not change.
+    CFG_BOOL reorder;
 
     // The ratio of the size reserved for the search cache to the size of the raw data (defined with vec_field_size_gb)
     // This parameter will replace pq_code_budget_gb to avoid calculating the actual size on the Milvus side.
@@ -70,6 +74,15 @@ class DiskANNConfig : public BaseConfig {
     // cached the nodes on the search paths; 2. do bfs from the entry point and cache them. The first method is suitable
     // for TopK query heavy circumstances and the second one performed better in range search.
     CFG_BOOL use_bfs_cache;
+    // The share of search_cache_budget_gb given to the adaptive cache, which is filled at search time from the nodes
+    // the searches read from disk and so keeps following the query distribution. The remaining share goes to the
+    // static cache chosen at load time. 0 keeps the whole budget static.
+    CFG_FLOAT search_cache_adaptive_ratio;
+    // The most points kept in memory after adding to a loaded index. Added points are kept in an in-memory Vamana
+    // graph that is searched next to the one on disk. The Add that would take it past this many points merges them
+    // into the disk index instead, by rebuilding the index files with the build parameters of that Add, which blocks
+    // the Add for as long as a build of the whole index. 0 bounds it to a tenth of the points on disk.
+    CFG_INT delta_max_points;
     // The beamwidth to be used for search. This is the maximum number of IO requests each query will issue per
     // iteration of search code. Larger beamwidth will result in fewer IO round-trips per query but might result in
     // slightly higher total number of IO requests to SSD per query. For the highest query throughput with a fixed SSD
@@ -83,6 +96,10 @@ class DiskANNConfig : public BaseConfig {
     // value should be in range of [0.0, 1.0] which means when greater or equal to x% of the bits are set,
     // use PQ + Refine. Default to -1.0f, negative vlaues will use dynamic threshold calculator given topk.
     CFG_FLOAT filter_threshold;
+    // The number of queries a search thread keeps in flight. With more than one, each thread interleaves its queries:
+    // the beams of all of them are read with one submission and one half is expanded while the other waits for its
+    // sectors, so fewer threads are needed to keep the SSD busy. 1 searches one query per thread at a time.
+    CFG_INT queries_per_thread;
     KNOHWERE_DECLARE_CONFIG(DiskANNConfig) {
         KNOWHERE_CONFIG_DECLARE_FIELD(max_degree)
             .description("the degree of the graph index.")
@@ -120,6 +137,10 @@ class DiskANNConfig : public BaseConfig {
             .description("a flag to enbale fast build.")
             .set_default(false)
             .for_train();
+        KNOWHERE_CONFIG_DECLARE_FIELD(reorder)
+            .description("whether the nodes are written to disk in bfs order of the graph.")
+            .set_default(false)
+            .for_train();
         KNOWHERE_CONFIG_DECLARE_FIELD(search_cache_budget_gb_ratio)
             .description("the ratio of the size reserved for the search cache to the size of the raw data.")
             .set_default(0)
@@ -140,6 +161,16 @@ class DiskANNConfig : public BaseConfig {
             .description("should bfs strategy to cache nodes.")
             .set_default(false)
             .for_deserialize();
+        KNOWHERE_CONFIG_DECLARE_FIELD(search_cache_adaptive_ratio)
+            .description("the share of the search cache budget filled at search time.")
+            .set_default(0.0f)
+            .set_range(0.0f, 1.0f)
+            .for_deserialize();
+        KNOWHERE_CONFIG_DECLARE_FIELD(delta_max_points)
+            .description("the most points kept in memory before they are merged into the disk index.")
+            .set_default(0)
+            .set_range(0, std::numeric_limits<CFG_INT::value_type>::max())
+            .for_train();
         KNOWHERE_CONFIG_DECLARE_FIELD(beamwidth)
             .description("the maximum number of IO requests each query will issue per iteration of search code.")
             .set_default(8)
@@ -163,6 +194,11 @@ class DiskANNConfig : public BaseConfig {
             .set_range(-1.0f, 1.0f)
             .for_search()
             .for_iterator();
+        KNOWHERE_CONFIG_DECLARE_FIELD(queries_per_thread)
+            .description("the number of queries a search thread keeps in flight.")
+            .set_default(1)
+            .set_range(1, 64)
+            .for_search();
     }
 
     Status
@@ -12,9 +12,11 @@
 #include "common/metric.h"
 #include "faiss/cppcontrib/knowhere/IndexBinaryFlat.h"
 #include "faiss/cppcontrib/knowhere/IndexFlat.h"
+#include "faiss/cppcontrib/knowhere/IndexFlatTyped.h"
 #include "faiss/cppcontrib/knowhere/index_io.h"
 #include "faiss/impl/AuxIndexStructures.h"
 #include "index/flat/flat_config.h"
+#include "io/file_io.h"
 #include "io/memory_io.h"
 #include "knowhere/bitsetview_idselector.h"
 #include "knowhere/comp/task.h"
@@ -30,13 +32,18 @@ namespace knowhere {
 
 template <typename DataType, typename IndexType>
 class FlatIndexNode : public IndexNode {
+    // fp16, bf16 and int8 vectors are stored as is rather than converted to fp32
+    using FaissIndexType = std::conditional_t<KnowhereLowPrecisionTypeCheck<DataType>::value,
+                                              faiss::cppcontrib::knowhere::IndexFlatTyped<DataType>, IndexType>;
+
  public:
     FlatIndexNode(const int32_t version, const Object& object) : IndexNode(version), index_(nullptr) {
         static_assert(std::is_same<IndexType, faiss::cppcontrib::knowhere::IndexFlat>::value ||
                           std::is_same<IndexType, faiss::cppcontrib::knowhere::IndexBinaryFlat>::value,
                       "not support");
-        static_assert(std::is_same_v<DataType, fp32> || std::is_same_v<DataType, bin1>,
-                      "FlatIndexNode only support float/binary");
+        static_assert(std::is_same_v<DataType, fp32> || std::is_same_v<DataType, bin1> ||
+                          KnowhereLowPrecisionTypeCheck<DataType>::value,
+                      "FlatIndexNode only support float/binary/fp16/bf16/int8");
         search_pool_ = ThreadPool::GetGlobalSearchThreadPool();
     }
 
@@ -54,8 +61,7 @@ class FlatIndexNode : public IndexNode {
         }
         if constexpr (std::is_same<faiss::cppcontrib::knowhere::IndexFlat, IndexType>::value) {
             bool is_cosine = IsMetricType(f_cfg.metric_type.value(), knowhere::metric::COSINE);
-            index_ =
-                std::make_unique<faiss::cppcontrib::knowhere::IndexFlat>(dataset->GetDim(), metric.value(), is_cosine);
+            index_ = std::make_unique<FaissIndexType>(dataset->GetDim(), metric.value(), is_cosine);
         }
         return Status::success;
     }
@@ -107,9 +113,12 @@ class FlatIndexNode : public IndexNode {
                     if constexpr (std::is_same<IndexType, faiss::cppcontrib::knowhere::IndexFlat>::value) {
                         auto cur_query = (const DataType*)x + dim * index;
                         std::unique_ptr<DataType[]> copied_query = nullptr;
-                        if (is_cosine) {
-                            copied_query = CopyAndNormalizeVecs(cur_query, 1, dim);
-                            cur_query = copied_query.get();
+                        // the typed cosine kernels divide by the query norm themselves
+                        if constexpr (std::is_same_v<DataType, fp32>) {
+                            if (is_cosine) {
+                                copied_query = CopyAndNormalizeVecs(cur_query, 1, dim);
+                                cur_query = copied_query.get();
+                            }
                         }
 
                         faiss::SearchParameters search_params;
@@ -183,9 +192,12 @@ class FlatIndexNode : public IndexNode {
                     if constexpr (std::is_same<IndexType, faiss::cppcontrib::knowhere::IndexFlat>::value) {
                         auto cur_query = (const DataType*)xq + dim * index;
                         std::unique_ptr<DataType[]> copied_query = nullptr;
-                        if (is_cosine) {
-                            copied_query = CopyAndNormalizeVecs(cur_query, 1, dim);
-                            cur_query = copied_query.get();
+                        // the typed cosine kernels divide by the query norm themselves
+                        if constexpr (std::is_same_v<DataType, fp32>) {
+                            if (is_cosine) {
+                                copied_query = CopyAndNormalizeVecs(cur_query, 1, dim);
+                                cur_query = copied_query.get();
+                            }
                         }
 
                         faiss::SearchParameters search_params;
@@ -303,12 +315,7 @@ class FlatIndexNode : public IndexNode {
         }
         try {
             MemoryIOWriter writer;
-            if constexpr (std::is_same<IndexType, faiss::cppcontrib::knowhere::IndexFlat>::value) {
-                faiss::cppcontrib::knowhere::write_index(index_.get(), &writer);
-            }
-            if constexpr (std::is_same<IndexType, faiss::cppcontrib::knowhere::IndexBinaryFlat>::value) {
-                faiss::cppcontrib::knowhere::write_index_binary(index_.get(), &writer);
-            }
+            WriteExactSize(writer, [this](IOWriter& w) { WriteIndex(&w); });
             std::shared_ptr<uint8_t[]> data(writer.data());
             binset.Append(Type(), data, writer.tellg());
             return Status::success;
@@ -319,7 +326,24 @@ class FlatIndexNode : public IndexNode {
     }
 
     Status
-    Deserialize(const BinarySet& binset, std::shared_ptr<Config>) override {
+    SerializeToFile(const std::string& filename, bool direct_io) const override {
+        if (!index_) {
+            LOG_KNOWHERE_ERROR_ << "Can not serialize empty index.";
+            return Status::empty_index;
+        }
+        try {
+            FileIOWriter writer(filename, direct_io);
+            WriteIndex(&writer);
+            writer.close();
+            return Status::success;
+        } catch (const std::exception& e) {
+            LOG_KNOWHERE_WARNING_ << "error inner faiss: " << e.what();
+            return Status::faiss_inner_error;
+        }
+    }
+
+    Status
+    Deserialize(const BinarySet& binset, std::shared_ptr<Config> cfg) override {
         std::vector<std::string> names = {"IVF",        // compatible with knowhere-1.x
                                           "BinaryIVF",  // compatible with knowhere-1.x
                                           Type()};
@@ -329,13 +353,15 @@ class FlatIndexNode : public IndexNode {
             return Status::invalid_binary_set;
         }
 
-        MemoryIOReader reader(binary->data.get(), binary->size);
+        auto flat_cfg = static_cast<const knowhere::BaseConfig&>(*cfg);
+        auto reader = CreateBinaryIOReader(binary->data, binary->size, flat_cfg.enable_zero_copy.value_or(false));
         if constexpr (std::is_same<IndexType, faiss::cppcontrib::knowhere::IndexFlat>::value) {
-            faiss::cppcontrib::knowhere::Index* index = faiss::cppcontrib::knowhere::read_index(&reader);
-            index_.reset(static_cast<IndexType*>(index));
+            faiss::cppcontrib::knowhere::Index* index = faiss::cppcontrib::knowhere::read_index(reader.get());
+            index_ = FromLoadedIndex(index);
         }
         if constexpr (std::is_same<IndexType, faiss::cppcontrib::knowhere::IndexBinaryFlat>::value) {
-            faiss::cppcontrib::knowhere::IndexBinary* index = faiss::cppcontrib::knowhere::read_index_binary(&reader);
+            faiss::cppcontrib::knowhere::IndexBinary* index =
+                faiss::cppcontrib::knowhere::read_index_binary(reader.get());
             index_.reset(static_cast<IndexType*>(index));
         }
         return Status::success;
@@ -353,7 +379,7 @@ class FlatIndexNode : public IndexNode {
         if constexpr (std::is_same<IndexType, faiss::cppcontrib::knowhere::IndexFlat>::value) {
             faiss::cppcontrib::knowhere::Index* index =
                 faiss::cppcontrib::knowhere::read_index(filename.data(), io_flags);
-            index_.reset(static_cast<IndexType*>(index));
+            index_ = FromLoadedIndex(index);
         }
         if constexpr (std::is_same<IndexType, faiss::cppcontrib::knowhere::IndexBinaryFlat>::value) {
             faiss::cppcontrib::knowhere::IndexBinary* index =
@@ -399,18 +425,45 @@ class FlatIndexNode : public IndexNode {
     }
 
  private:
-    std::unique_ptr<IndexType> index_;
+    // takes the ownership of an index loaded by read_index()
+    static std::unique_ptr<FaissIndexType>
+    FromLoadedIndex(faiss::cppcontrib::knowhere::Index* index) {
+        std::unique_ptr<faiss::cppcontrib::knowhere::Index> loaded(index);
+        if constexpr (KnowhereLowPrecisionTypeCheck<DataType>::value) {
+            // fp16/bf16/int8 FLAT indexes used to be stored as fp32 IndexFlat, convert them back
+            auto legacy = dynamic_cast<const faiss::cppcontrib::knowhere::IndexFlat*>(loaded.get());
+            if (legacy != nullptr) {
+                auto converted = std::make_unique<FaissIndexType>(legacy->d, legacy->metric_type, legacy->is_cosine);
+                converted->add(legacy->ntotal, legacy->get_xb());
+                return converted;
+            }
+        }
+        return std::unique_ptr<FaissIndexType>(static_cast<FaissIndexType*>(loaded.release()));
+    }
+
+    void
+    WriteIndex(faiss::IOWriter* writer) const {
+        if constexpr (std::is_same<IndexType, faiss::cppcontrib::knowhere::IndexFlat>::value) {
+            faiss::cppcontrib::knowhere::write_index(index_.get(), writer);
+        }
+        if constexpr (std::is_same<IndexType, faiss::cppcontrib::knowhere::IndexBinaryFlat>::value) {
+            faiss::cppcontrib::knowhere::write_index_binary(index_.get(), writer);
+        }
+    }
+
+    std::unique_ptr<FaissIndexType> index_;
     std::shared_ptr<ThreadPool> search_pool_;
 };
 
-KNOWHERE_MOCK_REGISTER_DENSE_FLOAT_ALL_GLOBAL(FLAT, FlatIndexNode,
-                                              knowhere::feature::NO_TRAIN | knowhere::feature::KNN |
-                                                  knowhere::feature::MMAP,
-                                              faiss::cppcontrib::knowhere::IndexFlat);
+KNOWHERE_SIMPLE_REGISTER_DENSE_FLOAT_ALL_GLOBAL(FLAT, FlatIndexNode,
+                                                knowhere::feature::NO_TRAIN | knowhere::feature::KNN |
+                                                    knowhere::feature::MMAP,
+                                                faiss::cppcontrib::knowhere::IndexFlat);
 
-KNOWHERE_MOCK_REGISTER_DENSE_INT_GLOBAL(FLAT, FlatIndexNode,
-                                        knowhere::feature::NO_TRAIN | knowhere::feature::KNN | knowhere::feature::MMAP,
-                                        faiss::cppcontrib::knowhere::IndexFlat);
+KNOWHERE_SIMPLE_REGISTER_DENSE_INT_GLOBAL(FLAT, FlatIndexNode,
+                                          knowhere::feature::NO_TRAIN | knowhere::feature::KNN |
+                                              knowhere::feature::MMAP,
+                                          faiss::cppcontrib::knowhere::IndexFlat);
 
 KNOWHERE_SIMPLE_REGISTER_DENSE_BIN_GLOBAL(BINFLAT, FlatIndexNode,
                                           knowhere::feature::NO_TRAIN | knowhere::feature::KNN |
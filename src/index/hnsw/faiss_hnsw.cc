@@ -44,6 +44,7 @@
 #include "index/hnsw/impl/IndexHNSWWrapper.h"
 #include "index/hnsw/impl/IndexWrapperCosine.h"
 #include "index/refine/refine_utils.h"
+#include "io/file_io.h"
 #include "io/memory_io.h"
 #include "knowhere/bitsetview_idselector.h"
 #include "knowhere/comp/index_param.h"
@@ -184,22 +185,27 @@ class BaseFaissRegularIndexNode : public BaseFaissIndexNode {
 
         try {
             MemoryIOWriter writer;
-            if (indexes.size() > 1) {
-                // this is a hack for compatibility, faiss index has 4-byte header to indicate index category
-                // create a new one to distinguish MV faiss hnsw from faiss hnsw
-                faiss::cppcontrib::knowhere::write_mv(&writer);
-                writeHeader(&writer);
-                for (const auto& index : indexes) {
-                    faiss::cppcontrib::knowhere::write_index(index.get(), &writer);
-                }
+            WriteExactSize(writer, [this](IOWriter& w) { writeIndexes(&w); });
+            std::shared_ptr<uint8_t[]> data(writer.data());
+            binset.Append(Type(), data, writer.tellg());
+        } catch (const std::exception& e) {
+            LOG_KNOWHERE_WARNING_ << "faiss inner error: " << e.what();
+            return Status::faiss_inner_error;
+        }
 
-                std::shared_ptr<uint8_t[]> data(writer.data());
-                binset.Append(Type(), data, writer.tellg());
-            } else {
-                faiss::cppcontrib::knowhere::write_index(indexes[0].get(), &writer);
-                std::shared_ptr<uint8_t[]> data(writer.data());
-                binset.Append(Type(), data, writer.tellg());
-            }
+        return Status::success;
+    }
+
+    Status
+    SerializeToFile(const std::string& filename, bool direct_io) const override {
+        if (isIndexEmpty()) {
+            return Status::empty_index;
+        }
+
+        try {
+            FileIOWriter writer(filename, direct_io);
+            writeIndexes(&writer);
+            writer.close();
         } catch (const std::exception& e) {
             LOG_KNOWHERE_WARNING_ << "faiss inner error: " << e.what();
             return Status::faiss_inner_error;
@@ -216,25 +222,27 @@ class BaseFaissRegularIndexNode : public BaseFaissIndexNode {
             return Status::invalid_binary_set;
         }
 
-        MemoryIOReader reader(binary->data.get(), binary->size);
+        auto cfg = static_cast<const knowhere::BaseConfig&>(*config);
+        bool zero_copy = cfg.enable_zero_copy.value_or(false);
+        auto reader = CreateBinaryIOReader(binary->data, binary->size, zero_copy);
         try {
             // this is a hack for compatibility, faiss index has 4-byte header to indicate index category
             // create a new one to distinguish MV faiss hnsw from faiss hnsw
-            bool is_mv = faiss::cppcontrib::knowhere::read_is_mv(&reader);
+            bool is_mv = faiss::cppcontrib::knowhere::read_is_mv(reader.get());
             if (is_mv) {
                 LOG_KNOWHERE_INFO_ << "start to load index by mv";
-                uint32_t v = readHeader(&reader);
+                uint32_t v = readHeader(reader.get());
                 indexes.resize(v);
                 LOG_KNOWHERE_INFO_ << "read " << v << " mvs";
                 for (auto i = 0; i < v; ++i) {
                     auto read_index = std::unique_ptr<faiss::cppcontrib::knowhere::Index>(
-                        faiss::cppcontrib::knowhere::read_index(&reader));
+                        faiss::cppcontrib::knowhere::read_index(reader.get()));
                     indexes[i].reset(read_index.release());
                 }
             } else {
-                reader.reset();
+                reader = CreateBinaryIOReader(binary->data, binary->size, zero_copy);
                 auto read_index = std::unique_ptr<faiss::cppcontrib::knowhere::Index>(
-                    faiss::cppcontrib::knowhere::read_index(&reader));
+                    faiss::cppcontrib::knowhere::read_index(reader.get()));
                 indexes[0].reset(read_index.release());
             }
         } catch (const std::exception& e) {
@@ -348,7 +356,7 @@ class BaseFaissRegularIndexNode : public BaseFaissIndexNode {
     GetInternalIdToExternalIdMap() const override {
         auto internal_offset_to_label = std::make_shared<std::vector<uint32_t>>();
         assert(indexes.size() > 0);
-        if (indexes.size() == 1) {
+        if (labels.empty()) {
             // without mv-only labels, the id mapping is the same as the internal offset.
             internal_offset_to_label->resize(Count());
             std::iota(internal_offset_to_label->begin(), internal_offset_to_label->end(), 0);
@@ -380,7 +388,8 @@ class BaseFaissRegularIndexNode : public BaseFaissIndexNode {
     // it is std::shared_ptr, not std::unique_ptr, because it can be
     //    shared with FaissHnswIterator
     std::vector<std::shared_ptr<faiss::cppcontrib::knowhere::Index>> indexes;
-    // each index's out ids(label), can be shared with FaissHnswIterator
+    // each index's out ids(label), can be shared with FaissHnswIterator.
+    // a single index has them too once its graph was reordered
     std::vector<std::shared_ptr<std::vector<uint32_t>>> labels;
 
     // index rows, help to locate index id by offset
@@ -432,6 +441,21 @@ class BaseFaissRegularIndexNode : public BaseFaissIndexNode {
         faiss::cppcontrib::knowhere::write_vector(label_to_internal_offset, f);
     }
 
+    void
+    writeIndexes(faiss::IOWriter* f) const {
+        if (indexes.size() > 1 || !labels.empty()) {
+            // this is a hack for compatibility, faiss index has 4-byte header to indicate index category
+            // create a new one to distinguish MV faiss hnsw from faiss hnsw
+            faiss::cppcontrib::knowhere::write_mv(f);
+            writeHeader(f);
+            for (const auto& index : indexes) {
+                faiss::cppcontrib::knowhere::write_index(index.get(), f);
+            }
+        } else {
+            faiss::cppcontrib::knowhere::write_index(indexes[0].get(), f);
+        }
+    }
+
     uint32_t
     readHeader(faiss::IOReader* f) {
         [[maybe_unused]] uint32_t version = faiss::cppcontrib::knowhere::read_value(f);
@@ -1154,7 +1178,7 @@ class BaseFaissRegularIndexHNSWNode : public BaseFaissRegularIndexNode {
         auto ids = dataset->GetIds();
 
         auto get_vector = [&](int64_t id, float* result) -> bool {
-            if (indexes.size() == 1) {
+            if (labels.empty()) {
                 indexes_to_reconstruct_from[0]->reconstruct(id, result);
             } else {
                 auto it =
@@ -1306,7 +1330,7 @@ class BaseFaissRegularIndexHNSWNode : public BaseFaissRegularIndexNode {
         if (index_id < 0) {
             return expected<DataSetPtr>::Err(Status::invalid_args, "partition key value not correctly set");
         }
-        if (indexes.size() > 1) {
+        if (!labels.empty()) {
             // calculate more accurate filter statistics for the single mv-index.
             size_t num_mv_ids = labels[index_id].get()->size();
             size_t num_mv_filtered_out_ids = num_mv_ids - (bitset.size() - bitset.count());
@@ -1555,7 +1579,7 @@ class BaseFaissRegularIndexHNSWNode : public BaseFaissRegularIndexNode {
                     dist_computer->set_query(cur_query);
                     for (auto j = 0; j < labels_len; j++) {
                         auto id = labels[j];
-                        if (indexes.size() > 1) {
+                        if (!this->labels.empty()) {
                             id = label_to_internal_offset[labels[j]] - index_rows_sum[index_id];
                         }
                         distances[idx * labels_len + j] = (*dist_computer)(id);
@@ -1606,7 +1630,7 @@ class BaseFaissRegularIndexHNSWNode : public BaseFaissRegularIndexNode {
         if (index_id < 0) {
             return expected<DataSetPtr>::Err(Status::invalid_args, "partition key value not correctly set");
         }
-        if (indexes.size() > 1) {
+        if (!labels.empty()) {
             size_t num_mv_ids = labels[index_id].get()->size();
             size_t num_mv_filtered_out_ids = num_mv_ids - (bitset.size() - bitset.count());
             if (!bitset.has_out_ids()) {
@@ -1762,7 +1786,7 @@ class BaseFaissRegularIndexHNSWNode : public BaseFaissRegularIndexNode {
     std::vector<std::vector<int>> tmp_combined_scalar_ids;
 
     Status
-    AddInternal(const DataSetPtr dataset, const Config&) override {
+    AddInternal(const DataSetPtr dataset, const Config& cfg) override {
         if (isIndexEmpty()) {
             LOG_KNOWHERE_ERROR_ << "Can not add data to an empty index.";
             return Status::empty_index;
@@ -1777,6 +1801,13 @@ class BaseFaissRegularIndexHNSWNode : public BaseFaissRegularIndexNode {
                 LOG_KNOWHERE_INFO_ << "Adding " << rows << " rows to HNSW Index";
 
                 auto status = add_to_index(indexes[0].get(), dataset, data_format);
+                if (status != Status::success) {
+                    return status;
+                }
+                ExtendLabels();
+                if (static_cast<const FaissHnswConfig&>(cfg).reorder.value()) {
+                    status = ReorderIndex();
+                }
                 return status;
             } catch (const std::exception& e) {
                 LOG_KNOWHERE_WARNING_ << "faiss inner error: " << e.what();
@@ -1814,6 +1845,59 @@ class BaseFaissRegularIndexHNSWNode : public BaseFaissRegularIndexNode {
         return Status::success;
     }
 
+    // rows appended to a reordered index keep their own ids
+    void
+    ExtendLabels() {
+        if (labels.empty()) {
+            return;
+        }
+        const uint32_t ntotal = indexes[0]->ntotal;
+        for (uint32_t i = labels[0]->size(); i < ntotal; ++i) {
+            labels[0]->push_back(i);
+            label_to_internal_offset.push_back(i);
+        }
+        index_rows_sum.back() = ntotal;
+    }
+
+    // renumbers the nodes of a single index in BFS order of its bottom layer, so that the nodes a search visits
+    // together sit next to each other in the graph and the codes. labels map the new offsets back to the ids.
+    Status
+    ReorderIndex() {
+        auto index_refine = dynamic_cast<faiss::cppcontrib::knowhere::IndexRefine*>(indexes[0].get());
+        auto index_hnsw = dynamic_cast<faiss::cppcontrib::knowhere::IndexHNSW*>(
+            index_refine != nullptr ? index_refine->base_index : indexes[0].get());
+        faiss::cppcontrib::knowhere::IndexFlatCodes* refine_storage = nullptr;
+        if (index_refine != nullptr) {
+            refine_storage = dynamic_cast<faiss::cppcontrib::knowhere::IndexFlatCodes*>(index_refine->refine_index);
+        }
+        if (index_hnsw == nullptr ||
+            dynamic_cast<faiss::cppcontrib::knowhere::IndexFlatCodes*>(index_hnsw->storage) == nullptr ||
+            (index_refine != nullptr && refine_storage == nullptr)) {
+            LOG_KNOWHERE_WARNING_ << "reorder is not supported by this index type, skipped";
+            return Status::success;
+        }
+
+        const uint32_t ntotal = index_hnsw->ntotal;
+        std::vector<faiss::idx_t> perm(ntotal);
+        index_hnsw->hnsw.bfs_order(perm.data());
+        index_hnsw->permute_entries(perm.data());
+        if (refine_storage != nullptr) {
+            refine_storage->permute_entries(perm.data());
+        }
+
+        auto new_labels = std::make_shared<std::vector<uint32_t>>(ntotal);
+        label_to_internal_offset.resize(ntotal);
+        for (uint32_t i = 0; i < ntotal; ++i) {
+            const uint32_t label = labels.empty() ? perm[i] : labels[0]->at(perm[i]);
+            new_labels->at(i) = label;
+            label_to_internal_offset[label] = i;
+        }
+        labels = {new_labels};
+        index_rows_sum = {0, ntotal};
+        LOG_KNOWHERE_INFO_ << "Reordered " << ntotal << " rows of HNSW Index";
+        return Status::success;
+    }
+
     const faiss::cppcontrib::knowhere::Index*
     GetIndexToReconstructRawDataFrom(int i) const {
         if (indexes.size() <= i) {
@@ -1942,7 +2026,7 @@ class BaseFaissRegularIndexHNSWNode : public BaseFaissRegularIndexNode {
             return expected<std::vector<IndexNode::IteratorPtr>>::Err(Status::invalid_args,
                                                                       "partition key value not correctly set");
         }
-        if (indexes.size() > 1) {
+        if (!labels.empty()) {
             size_t num_mv_ids = labels[index_id].get()->size();
             size_t num_mv_filtered_out_ids = num_mv_ids - (bitset.size() - bitset.count());
             if (!bitset.has_out_ids()) {
@@ -2215,6 +2299,15 @@ class HNSWIndexNodeWithFallback : public IndexNode {
         }
     }
 
+    Status
+    SerializeToFile(const std::string& filename, bool direct_io) const override {
+        if (use_base_index) {
+            return base_index->SerializeToFile(filename, direct_io);
+        } else {
+            return fallback_search_index->SerializeToFile(filename, direct_io);
+        }
+    }
+
     Status
     Deserialize(const BinarySet& binset, std::shared_ptr<Config> config) override {
         if (use_base_index) {
@@ -29,6 +29,9 @@ class FaissHnswConfig : public BaseHnswConfig {
     CFG_FLOAT refine_k;
     // type of refine
     CFG_STRING refine_type;
+    // renumber the nodes after the build in a breadth-first order of the graph, so that neighbors are stored close
+    // together and a search touches fewer cache lines and pages
+    CFG_BOOL reorder;
 
     KNOHWERE_DECLARE_CONFIG(FaissHnswConfig) {
         KNOWHERE_CONFIG_DECLARE_FIELD(seed_ef)
@@ -51,6 +54,10 @@ class FaissHnswConfig : public BaseHnswConfig {
             .allow_empty_without_default()
             .for_train()
             .for_static();
+        KNOWHERE_CONFIG_DECLARE_FIELD(reorder)
+            .description("whether the graph is reordered for locality after the build")
+            .set_default(false)
+            .for_train();
     }
 
  protected:
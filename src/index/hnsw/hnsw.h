@@ -17,6 +17,7 @@
 #include "hnswlib/hnswalg.h"
 #include "hnswlib/hnswlib.h"
 #include "index/hnsw/hnsw_config.h"
+#include "io/file_io.h"
 #include "knowhere/comp/index_param.h"
 #include "knowhere/comp/task.h"
 #include "knowhere/comp/time_recorder.h"
@@ -476,7 +477,7 @@ class HnswIndexNode : public IndexNode {
         }
         try {
             MemoryIOWriter writer;
-            index_->saveIndex(writer);
+            WriteExactSize(writer, [this](IOWriter& w) { index_->saveIndex(w); });
             std::shared_ptr<uint8_t[]> data(writer.data());
             binset.Append(Type(), data, writer.tellg());
         } catch (std::exception& e) {
@@ -486,6 +487,23 @@ class HnswIndexNode : public IndexNode {
         return Status::success;
     }
 
+    Status
+    SerializeToFile(const std::string& filename, bool direct_io) const override {
+        if (!index_) {
+            LOG_KNOWHERE_ERROR_ << "Can not serialize empty HNSW index.";
+            return Status::empty_index;
+        }
+        try {
+            FileIOWriter writer(filename, direct_io);
+            index_->saveIndex(writer);
+            writer.close();
+        } catch (std::exception& e) {
+            LOG_KNOWHERE_WARNING_ << "hnsw inner error: " << e.what();
+            return Status::hnsw_inner_error;
+        }
+        return Status::success;
+    }
+
     Status
     Deserialize(const BinarySet& binset, std::shared_ptr<Config>) override {
         if (index_) {
@@ -22,6 +22,7 @@
 
 #include <algorithm>
 #include <memory>
+#include <vector>
 
 #include "knowhere/bitsetview.h"
 #include "knowhere/bitsetview_idselector.h"
@@ -45,6 +46,22 @@ struct BitsetViewIDSelectorWrapper final {
     }
 };
 
+// collects the internal ids allowed by a bitset that carries an allow list, so that a selective filter costs
+//   one distance per allowed row rather than a bitset test per row.
+static bool
+collect_allowed_ids(const faiss::SearchParameters* params, const idx_t ntotal, std::vector<idx_t>& allowed_ids) {
+    const faiss::IDSelector* sel = (params == nullptr) ? nullptr : params->sel;
+    const auto* bw_idselector = dynamic_cast<const knowhere::BitsetViewIDSelector*>(sel);
+    if (bw_idselector == nullptr || bw_idselector->bitset_view.empty() ||
+        !bw_idselector->bitset_view.has_allow_list()) {
+        return false;
+    }
+    const auto& bitset_view = bw_idselector->bitset_view;
+    allowed_ids.reserve(std::min<size_t>(bitset_view.allow_list_size(), ntotal));
+    bitset_view.for_each_allowed(ntotal, [&](size_t id) { allowed_ids.push_back(id); });
+    return true;
+}
+
 //
 IndexBruteForceWrapper::IndexBruteForceWrapper(faiss::cppcontrib::knowhere::Index* underlying_index)
     : faiss::cppcontrib::knowhere::IndexWrapper{underlying_index} {
@@ -58,6 +75,9 @@ IndexBruteForceWrapper::search(faiss::idx_t n, const float* __restrict x, faiss:
 
     std::unique_ptr<faiss::DistanceComputer> dis(index->get_distance_computer());
 
+    std::vector<idx_t> allowed_ids;
+    const bool by_ids = collect_allowed_ids(params, index->ntotal, allowed_ids);
+
     // no parallelism by design
     for (idx_t i = 0; i < n; i++) {
         // prepare the query
@@ -73,8 +93,10 @@ IndexBruteForceWrapper::search(faiss::idx_t n, const float* __restrict x, faiss:
         if (faiss::cppcontrib::knowhere::is_similarity_metric(index->metric_type)) {
             using C = faiss::CMin<float, idx_t>;
 
-            // try knowhere-specific filter
-            if (const knowhere::BitsetViewIDSelector* __restrict bw_idselector =
+            if (by_ids) {
+                faiss::cppcontrib::knowhere::brute_force_search_by_ids_impl<C, faiss::DistanceComputer>(
+                    allowed_ids.data(), allowed_ids.size(), *dis, k, local_distances, local_ids);
+            } else if (const knowhere::BitsetViewIDSelector* __restrict bw_idselector =
                     dynamic_cast<const knowhere::BitsetViewIDSelector*>(sel);
                 bw_idselector && !bw_idselector->bitset_view.empty()) {
                 BitsetViewIDSelectorWrapper bw_idselector_w(bw_idselector->bitset_view);
@@ -90,8 +112,10 @@ IndexBruteForceWrapper::search(faiss::idx_t n, const float* __restrict x, faiss:
         } else {
             using C = faiss::CMax<float, idx_t>;
 
-            // try knowhere-specific filter
-            if (const knowhere::BitsetViewIDSelector* __restrict bw_idselector =
+            if (by_ids) {
+                faiss::cppcontrib::knowhere::brute_force_search_by_ids_impl<C, faiss::DistanceComputer>(
+                    allowed_ids.data(), allowed_ids.size(), *dis, k, local_distances, local_ids);
+            } else if (const knowhere::BitsetViewIDSelector* __restrict bw_idselector =
                     dynamic_cast<const knowhere::BitsetViewIDSelector*>(sel);
                 bw_idselector && !bw_idselector->bitset_view.empty()) {
                 BitsetViewIDSelectorWrapper bw_idselector_w(bw_idselector->bitset_view);
@@ -118,6 +142,9 @@ IndexBruteForceWrapper::range_search(faiss::idx_t n, const float* x, float radiu
 
     std::unique_ptr<faiss::DistanceComputer> dis(index->get_distance_computer());
 
+    std::vector<idx_t> allowed_ids;
+    const bool by_ids = collect_allowed_ids(params, index->ntotal, allowed_ids);
+
     // no parallelism by design
     for (idx_t i = 0; i < n; i++) {
         // prepare the query
@@ -130,7 +157,11 @@ IndexBruteForceWrapper::range_search(faiss::idx_t n, const float* x, float radiu
             typename RH_max::SingleResultHandler res_max(bres_max);
             res_max.begin(i);
 
-            if (sel == nullptr) {
+            if (by_ids) {
+                faiss::cppcontrib::knowhere::brute_force_range_search_by_ids_impl<typename RH_max::SingleResultHandler,
+                                                                                  faiss::DistanceComputer>(
+                    allowed_ids.data(), allowed_ids.size(), *dis, res_max);
+            } else if (sel == nullptr) {
                 // Compiler is expected to de-virtualize virtual method calls
                 faiss::IDSelectorAll sel_all;
 
@@ -148,7 +179,11 @@ IndexBruteForceWrapper::range_search(faiss::idx_t n, const float* x, float radiu
             typename RH_min::SingleResultHandler res_min(bres_min);
             res_min.begin(i);
 
-            if (sel == nullptr) {
+            if (by_ids) {
+                faiss::cppcontrib::knowhere::brute_force_range_search_by_ids_impl<typename RH_min::SingleResultHandler,
+                                                                                  faiss::DistanceComputer>(
+                    allowed_ids.data(), allowed_ids.size(), *dis, res_min);
+            } else if (sel == nullptr) {
                 // Compiler is expected to de-virtualize virtual method calls
                 faiss::IDSelectorAll sel_all;
 
@@ -18,7 +18,7 @@
 #include <faiss/cppcontrib/knowhere/impl/HNSW.h>
 #include <faiss/cppcontrib/knowhere/impl/HnswSearcher.h>
 #include <faiss/cppcontrib/knowhere/impl/ResultHandler.h>
-#include <faiss/cppcontrib/knowhere/utils/Bitset.h>
+#include <faiss/cppcontrib/knowhere/utils/VisitedTable.h>
 #include <faiss/impl/AuxIndexStructures.h>
 #include <faiss/impl/DistanceComputer.h>
 #include <faiss/impl/FaissAssert.h>
@@ -113,9 +113,10 @@ IndexHNSWWrapper::search(idx_t n, const float* __restrict x, idx_t k, float* __r
     size_t ndis = 0;
     size_t nhops = 0;
 
-    //
-    faiss::cppcontrib::knowhere::Bitset bitset_visited_nodes =
-        faiss::cppcontrib::knowhere::Bitset::create_uninitialized(index->ntotal);
+    // a table of visited elements from the pool of the index, cleared in O(1) per query
+    faiss::cppcontrib::knowhere::VisitedTablePool::Handle visited_nodes_handle =
+        index_hnsw->visited_pool.acquire(index->ntotal);
+    faiss::cppcontrib::knowhere::EpochVisitedTable& visited_nodes = *visited_nodes_handle;
 
     // create a distance computer
     std::unique_ptr<faiss::DistanceComputer> dis(storage_distance_computer(index_hnsw->storage));
@@ -126,7 +127,7 @@ IndexHNSWWrapper::search(idx_t n, const float* __restrict x, idx_t k, float* __r
         dis->set_query(x + i * index->d);
 
         // prepare the table of visited elements
-        bitset_visited_nodes.clear();
+        visited_nodes.clear();
 
         // a visitor
         knowhere::feder::hnsw::FederResult* feder = (params == nullptr) ? nullptr : params->feder;
@@ -150,10 +151,10 @@ IndexHNSWWrapper::search(idx_t n, const float* __restrict x, idx_t k, float* __r
 
                 using searcher_type =
                     faiss::cppcontrib::knowhere::v2_hnsw_searcher<faiss::DistanceComputer, DummyVisitor,
-                                                                  faiss::cppcontrib::knowhere::Bitset,
+                                                                  faiss::cppcontrib::knowhere::EpochVisitedTable,
                                                                   knowhere::BitsetViewIDSelector>;
 
-                searcher_type searcher{hnsw,           *(dis.get()), graph_visitor, bitset_visited_nodes,
+                searcher_type searcher{hnsw,           *(dis.get()), graph_visitor, visited_nodes,
                                        *bw_idselector, kAlpha,       params};
 
                 local_stats = searcher.search(k, distances + i * k, labels + i * k);
@@ -163,10 +164,10 @@ IndexHNSWWrapper::search(idx_t n, const float* __restrict x, idx_t k, float* __r
 
                 using searcher_type =
                     faiss::cppcontrib::knowhere::v2_hnsw_searcher<faiss::DistanceComputer, FederVisitor,
-                                                                  faiss::cppcontrib::knowhere::Bitset,
+                                                                  faiss::cppcontrib::knowhere::EpochVisitedTable,
                                                                   knowhere::BitsetViewIDSelector>;
 
-                searcher_type searcher{hnsw,           *(dis.get()), graph_visitor, bitset_visited_nodes,
+                searcher_type searcher{hnsw,           *(dis.get()), graph_visitor, visited_nodes,
                                        *bw_idselector, kAlpha,       params};
 
                 local_stats = searcher.search(k, distances + i * k, labels + i * k);
@@ -180,10 +181,12 @@ IndexHNSWWrapper::search(idx_t n, const float* __restrict x, idx_t k, float* __r
                 // no feder
                 DummyVisitor graph_visitor;
 
-                using searcher_type = faiss::cppcontrib::knowhere::v2_hnsw_searcher<
-                    faiss::DistanceComputer, DummyVisitor, faiss::cppcontrib::knowhere::Bitset, faiss::IDSelectorAll>;
+                using searcher_type =
+                    faiss::cppcontrib::knowhere::v2_hnsw_searcher<faiss::DistanceComputer, DummyVisitor,
+                                                                  faiss::cppcontrib::knowhere::EpochVisitedTable,
+                                                                  faiss::IDSelectorAll>;
 
-                searcher_type searcher{hnsw,    *(dis.get()), graph_visitor, bitset_visited_nodes,
+                searcher_type searcher{hnsw,    *(dis.get()), graph_visitor, visited_nodes,
                                        sel_all, kAlpha,       params};
 
                 local_stats = searcher.search(k, distances + i * k, labels + i * k);
@@ -191,10 +194,12 @@ IndexHNSWWrapper::search(idx_t n, const float* __restrict x, idx_t k, float* __r
                 // use feder
                 FederVisitor graph_visitor(feder);
 
-                using searcher_type = faiss::cppcontrib::knowhere::v2_hnsw_searcher<
-                    faiss::DistanceComputer, FederVisitor, faiss::cppcontrib::knowhere::Bitset, faiss::IDSelectorAll>;
+                using searcher_type =
+                    faiss::cppcontrib::knowhere::v2_hnsw_searcher<faiss::DistanceComputer, FederVisitor,
+                                                                  faiss::cppcontrib::knowhere::EpochVisitedTable,
+                                                                  faiss::IDSelectorAll>;
 
-                searcher_type searcher{hnsw,    *(dis.get()), graph_visitor, bitset_visited_nodes,
+                searcher_type searcher{hnsw,    *(dis.get()), graph_visitor, visited_nodes,
                                        sel_all, kAlpha,       params};
 
                 local_stats = searcher.search(k, distances + i * k, labels + i * k);
@@ -266,9 +271,10 @@ IndexHNSWWrapper::range_search(idx_t n, const float* __restrict x, float radius_
     size_t ndis = 0;
     size_t nhops = 0;
 
-    //
-    faiss::cppcontrib::knowhere::Bitset bitset_visited_nodes =
-        faiss::cppcontrib::knowhere::Bitset::create_uninitialized(index->ntotal);
+    // a table of visited elements from the pool of the index, cleared in O(1) per query
+    faiss::cppcontrib::knowhere::VisitedTablePool::Handle visited_nodes_handle =
+        index_hnsw->visited_pool.acquire(index->ntotal);
+    faiss::cppcontrib::knowhere::EpochVisitedTable& visited_nodes = *visited_nodes_handle;
 
     // create a distance computer
     std::unique_ptr<faiss::DistanceComputer> dis(storage_distance_computer(index_hnsw->storage));
@@ -293,7 +299,7 @@ IndexHNSWWrapper::range_search(idx_t n, const float* __restrict x, float radius_
         dis->set_query(x + i * index->d);
 
         // prepare the table of visited elements
-        bitset_visited_nodes.clear();
+        visited_nodes.clear();
 
         // a visitor
         knowhere::feder::hnsw::FederResult* feder = (params == nullptr) ? nullptr : params->feder;
@@ -317,10 +323,10 @@ IndexHNSWWrapper::range_search(idx_t n, const float* __restrict x, float radius_
 
                 using searcher_type =
                     faiss::cppcontrib::knowhere::v2_hnsw_searcher<faiss::DistanceComputer, DummyVisitor,
-                                                                  faiss::cppcontrib::knowhere::Bitset,
+                                                                  faiss::cppcontrib::knowhere::EpochVisitedTable,
                                                                   knowhere::BitsetViewIDSelector>;
 
-                searcher_type searcher{hnsw,           *(dis.get()), graph_visitor, bitset_visited_nodes,
+                searcher_type searcher{hnsw,           *(dis.get()), graph_visitor, visited_nodes,
                                        *bw_idselector, kAlpha,       params};
 
                 local_stats = searcher.range_search(radius, &res_min);
@@ -330,10 +336,10 @@ IndexHNSWWrapper::range_search(idx_t n, const float* __restrict x, float radius_
 
                 using searcher_type =
                     faiss::cppcontrib::knowhere::v2_hnsw_searcher<faiss::DistanceComputer, FederVisitor,
-                                                                  faiss::cppcontrib::knowhere::Bitset,
+                                                                  faiss::cppcontrib::knowhere::EpochVisitedTable,
                                                                   knowhere::BitsetViewIDSelector>;
 
-                searcher_type searcher{hnsw,           *(dis.get()), graph_visitor, bitset_visited_nodes,
+                searcher_type searcher{hnsw,           *(dis.get()), graph_visitor, visited_nodes,
                                        *bw_idselector, kAlpha,       params};
 
                 local_stats = searcher.range_search(radius, &res_min);
@@ -347,10 +353,12 @@ IndexHNSWWrapper::range_search(idx_t n, const float* __restrict x, float radius_
                 // no feder
                 DummyVisitor graph_visitor;
 
-                using searcher_type = faiss::cppcontrib::knowhere::v2_hnsw_searcher<
-                    faiss::DistanceComputer, DummyVisitor, faiss::cppcontrib::knowhere::Bitset, faiss::IDSelectorAll>;
+                using searcher_type =
+                    faiss::cppcontrib::knowhere::v2_hnsw_searcher<faiss::DistanceComputer, DummyVisitor,
+                                                                  faiss::cppcontrib::knowhere::EpochVisitedTable,
+                                                                  faiss::IDSelectorAll>;
 
-                searcher_type searcher{hnsw,    *(dis.get()), graph_visitor, bitset_visited_nodes,
+                searcher_type searcher{hnsw,    *(dis.get()), graph_visitor, visited_nodes,
                                        sel_all, kAlpha,       params};
 
                 local_stats = searcher.range_search(radius, &res_min);
@@ -358,10 +366,12 @@ IndexHNSWWrapper::range_search(idx_t n, const float* __restrict x, float radius_
                 // use feder
                 FederVisitor graph_visitor(feder);
 
-                using searcher_type = faiss::cppcontrib::knowhere::v2_hnsw_searcher<
-                    faiss::DistanceComputer, FederVisitor, faiss::cppcontrib::knowhere::Bitset, faiss::IDSelectorAll>;
+                using searcher_type =
+                    faiss::cppcontrib::knowhere::v2_hnsw_searcher<faiss::DistanceComputer, FederVisitor,
+                                                                  faiss::cppcontrib::knowhere::EpochVisitedTable,
+                                                                  faiss::IDSelectorAll>;
 
-                searcher_type searcher{hnsw,    *(dis.get()), graph_visitor, bitset_visited_nodes,
+                searcher_type searcher{hnsw,    *(dis.get()), graph_visitor, visited_nodes,
                                        sel_all, kAlpha,       params};
 
                 local_stats = searcher.range_search(radius, &res_min);
@@ -112,6 +112,60 @@ Index<T>::Add(const DataSetPtr dataset, const Json& json, bool use_knowhere_buil
     return this->node->AddEmbListIfNeed(dataset, std::move(cfg), use_knowhere_build_pool);
 }
 
+template <typename T>
+inline expected<SearchPlanPtr>
+Index<T>::PrepareSearch(const Json& json, PARAM_TYPE param_type) const {
+    if (param_type != knowhere::SEARCH && param_type != knowhere::RANGE_SEARCH && param_type != knowhere::ITERATOR) {
+        return expected<SearchPlanPtr>::Err(Status::invalid_args, "search plans are only for searches and iterators");
+    }
+    auto plan = std::make_shared<SearchPlan>();
+    plan->index_type_ = Type();
+    plan->param_type_ = param_type;
+    plan->json_ = json;
+    plan->cfg_ = this->node->CreateConfig();
+    std::string msg;
+    auto status = Config::FormatAndCheck(*plan->cfg_, plan->json_, &msg);
+    LOG_KNOWHERE_DEBUG_ << "PrepareSearch config dump: " << plan->json_.dump();
+    if (status == Status::success) {
+        status = Config::Load(*plan->cfg_, plan->json_, param_type, &msg);
+    }
+    if (status != Status::success) {
+        return expected<SearchPlanPtr>::Err(status, msg);
+    }
+    return SearchPlanPtr(std::move(plan));
+}
+
+template <typename T>
+inline Status
+Index<T>::InstantiatePlan(const SearchPlan& plan, PARAM_TYPE param_type, const SearchPlanOverrides& overrides,
+                          std::unique_ptr<BaseConfig>& cfg, std::string* msg) const {
+    if (plan.param_type_ != param_type || plan.index_type_ != Type()) {
+        *msg = fmt::format("search plan prepared for {} can not be used for this search on {}", plan.index_type_,
+                           Type());
+        LOG_KNOWHERE_ERROR_ << *msg;
+        return Status::invalid_args;
+    }
+    cfg = this->node->CreateConfig();
+    if (overrides.k.has_value() && overrides.k != plan.cfg_->k) {
+        // params such as ef may be derived from k when the config is checked
+        Json json(plan.json_);
+        json[meta::TOPK] = overrides.k.value();
+        RETURN_IF_ERROR(Config::Load(*cfg, json, param_type, msg));
+    } else {
+        Config::CopyValues(*plan.cfg_, *cfg);
+    }
+    if (overrides.trace_id.has_value()) {
+        cfg->trace_id = overrides.trace_id;
+    }
+    if (overrides.span_id.has_value()) {
+        cfg->span_id = overrides.span_id;
+    }
+    if (overrides.trace_flags.has_value()) {
+        cfg->trace_flags = overrides.trace_flags;
+    }
+    return Status::success;
+}
+
 template <typename T>
 inline expected<DataSetPtr>
 Index<T>::Search(const DataSetPtr dataset, const Json& json, const BitsetView& bitset_,
@@ -122,6 +176,27 @@ Index<T>::Search(const DataSetPtr dataset, const Json& json, const BitsetView& b
     if (load_status != Status::success) {
         return expected<DataSetPtr>::Err(load_status, msg);
     }
+    return SearchWithConfig(dataset, std::move(cfg), bitset_, op_context);
+}
+
+template <typename T>
+inline expected<DataSetPtr>
+Index<T>::Search(const DataSetPtr dataset, const SearchPlan& plan, const BitsetView& bitset_,
+                 const SearchPlanOverrides& overrides, milvus::OpContext* op_context) const {
+    std::unique_ptr<BaseConfig> cfg;
+    std::string msg;
+    const Status status = InstantiatePlan(plan, knowhere::SEARCH, overrides, cfg, &msg);
+    if (status != Status::success) {
+        return expected<DataSetPtr>::Err(status, msg);
+    }
+    return SearchWithConfig(dataset, std::move(cfg), bitset_, op_context);
+}
+
+template <typename T>
+inline expected<DataSetPtr>
+Index<T>::SearchWithConfig(const DataSetPtr dataset, std::unique_ptr<BaseConfig> cfg, const BitsetView& bitset_,
+                           milvus::OpContext* op_context) const {
+    std::string msg;
     // when index is immutable, bitset size should always equal to data count in index
     // when index is mutable, it could happen that data count larger than bitset size, see
     // https://github.com/zilliztech/knowhere/issues/70
@@ -191,6 +266,28 @@ Index<T>::AnnIterator(const DataSetPtr dataset, const Json& json, const BitsetVi
     if (status != Status::success) {
         return expected<std::vector<std::shared_ptr<IndexNode::iterator>>>::Err(status, msg);
     }
+    return AnnIteratorWithConfig(dataset, std::move(cfg), bitset_, use_knowhere_search_pool, op_context);
+}
+
+template <typename T>
+inline expected<std::vector<std::shared_ptr<IndexNode::iterator>>>
+Index<T>::AnnIterator(const DataSetPtr dataset, const SearchPlan& plan, const BitsetView& bitset_,
+                      const SearchPlanOverrides& overrides, bool use_knowhere_search_pool,
+                      milvus::OpContext* op_context) const {
+    std::unique_ptr<BaseConfig> cfg;
+    std::string msg;
+    Status status = InstantiatePlan(plan, knowhere::ITERATOR, overrides, cfg, &msg);
+    if (status != Status::success) {
+        return expected<std::vector<std::shared_ptr<IndexNode::iterator>>>::Err(status, msg);
+    }
+    return AnnIteratorWithConfig(dataset, std::move(cfg), bitset_, use_knowhere_search_pool, op_context);
+}
+
+template <typename T>
+inline expected<std::vector<std::shared_ptr<IndexNode::iterator>>>
+Index<T>::AnnIteratorWithConfig(const DataSetPtr dataset, std::unique_ptr<BaseConfig> cfg, const BitsetView& bitset_,
+                                bool use_knowhere_search_pool, milvus::OpContext* op_context) const {
+    std::string msg;
     // when index is immutable, bitset size should always equal to data count in index
     // when index is mutable, it could happen that data count larger than bitset size, see
     // https://github.com/zilliztech/knowhere/issues/70
@@ -202,7 +299,10 @@ Index<T>::AnnIterator(const DataSetPtr dataset, const Json& json, const BitsetVi
         return expected<std::vector<std::shared_ptr<IndexNode::iterator>>>::Err(Status::invalid_args, msg);
     }
 
-    const auto bitset = BitsetView(bitset_.data(), bitset_.size(), bitset_.get_filtered_out_num_());
+    auto bitset = BitsetView(bitset_.data(), bitset_.size(), bitset_.get_filtered_out_num_());
+    if (bitset_.has_allow_list()) {
+        bitset.set_allow_list(bitset_.allow_list_data(), bitset_.allow_list_size());
+    }
 
 #if defined(NOT_COMPILE_FOR_SWIG) && !defined(KNOWHERE_WITH_LIGHT)
     // note that this time includes only the initial search phase of iterator.
@@ -229,6 +329,27 @@ Index<T>::RangeSearch(const DataSetPtr dataset, const Json& json, const BitsetVi
     if (status != Status::success) {
         return expected<DataSetPtr>::Err(status, std::move(msg));
     }
+    return RangeSearchWithConfig(dataset, std::move(cfg), bitset_, op_context);
+}
+
+template <typename T>
+inline expected<DataSetPtr>
+Index<T>::RangeSearch(const DataSetPtr dataset, const SearchPlan& plan, const BitsetView& bitset_,
+                      const SearchPlanOverrides& overrides, milvus::OpContext* op_context) const {
+    std::unique_ptr<BaseConfig> cfg;
+    std::string msg;
+    auto status = InstantiatePlan(plan, knowhere::RANGE_SEARCH, overrides, cfg, &msg);
+    if (status != Status::success) {
+        return expected<DataSetPtr>::Err(status, std::move(msg));
+    }
+    return RangeSearchWithConfig(dataset, std::move(cfg), bitset_, op_context);
+}
+
+template <typename T>
+inline expected<DataSetPtr>
+Index<T>::RangeSearchWithConfig(const DataSetPtr dataset, std::unique_ptr<BaseConfig> cfg, const BitsetView& bitset_,
+                                milvus::OpContext* op_context) const {
+    std::string msg;
     // when index is immutable, bitset size should always equal to data count in index
     // when index is mutable, it could happen that data count larger than bitset size, see
     // https://github.com/zilliztech/knowhere/issues/70
@@ -240,7 +361,10 @@ Index<T>::RangeSearch(const DataSetPtr dataset, const Json& json, const BitsetVi
         return expected<DataSetPtr>::Err(Status::invalid_args, msg);
     }
 
-    const auto bitset = BitsetView(bitset_.data(), bitset_.size(), bitset_.get_filtered_out_num_());
+    auto bitset = BitsetView(bitset_.data(), bitset_.size(), bitset_.get_filtered_out_num_());
+    if (bitset_.has_allow_list()) {
+        bitset.set_allow_list(bitset_.allow_list_data(), bitset_.allow_list_size());
+    }
 
 #if defined(NOT_COMPILE_FOR_SWIG) && !defined(KNOWHERE_WITH_LIGHT)
     const BaseConfig& b_cfg = static_cast<const BaseConfig&>(*cfg);
@@ -323,6 +447,12 @@ Index<T>::Serialize(BinarySet& binset) const {
     return this->node->SerializeEmbListIfNeed(binset);
 }
 
+template <typename T>
+inline Status
+Index<T>::SerializeToFile(const std::string& filename, bool direct_io) const {
+    return this->node->SerializeToFile(filename, direct_io);
+}
+
 template <typename T>
 inline Status
 Index<T>::Deserialize(const BinarySet& binset, const Json& json) {
@@ -15,6 +15,7 @@
 #include <queue>
 #include <unordered_set>
 
+#include "io/file_io.h"
 #include "knowhere/context.h"
 #include "knowhere/log.h"
 #include "knowhere/range_util.h"
@@ -28,6 +29,27 @@
 namespace knowhere {
 
 // NOLINTBEGIN(google-default-arguments)
+Status
+IndexNode::SerializeToFile(const std::string& filename, bool direct_io) const {
+    BinarySet binset;
+    RETURN_IF_ERROR(Serialize(binset));
+    if (binset.binary_map_.size() != 1) {
+        LOG_KNOWHERE_WARNING_ << Type() << " serializes into " << binset.binary_map_.size()
+                              << " binaries and can not be written as a single file";
+        return Status::not_implemented;
+    }
+    const auto& binary = binset.binary_map_.begin()->second;
+    try {
+        FileIOWriter writer(filename, direct_io);
+        writer(binary->data.get(), 1, binary->size);
+        writer.close();
+    } catch (const std::exception& e) {
+        LOG_KNOWHERE_WARNING_ << "failed to write " << filename << ": " << e.what();
+        return Status::disk_file_error;
+    }
+    return Status::success;
+}
+
 expected<DataSetPtr>
 IndexNode::RangeSearch(const DataSetPtr dataset, std::unique_ptr<Config> cfg, const BitsetView& bitset,
                        milvus::OpContext* op_context) const {
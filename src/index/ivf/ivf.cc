@@ -19,6 +19,7 @@
 #include "faiss/cppcontrib/knowhere/IndexBinaryIVF.h"
 #include "faiss/cppcontrib/knowhere/IndexFlat.h"
 #include "faiss/cppcontrib/knowhere/IndexIVFFlat.h"
+#include "faiss/cppcontrib/knowhere/IndexIVFFlatTyped.h"
 #include "faiss/cppcontrib/knowhere/IndexIVFPQ.h"
 #include "faiss/cppcontrib/knowhere/IndexIVFPQFastScan.h"
 #include "faiss/cppcontrib/knowhere/IndexIVFRaBitQ.h"
@@ -28,6 +29,7 @@
 #include "index/ivf/ivf_config.h"
 #include "index/ivf/ivf_wrapper.h"
 #include "index/ivf/ivfrbq_wrapper.h"
+#include "io/file_io.h"
 #include "io/memory_io.h"
 #include "knowhere/bitsetview_idselector.h"
 #include "knowhere/context.h"
@@ -56,8 +58,30 @@ struct IndexDispatch<faiss::cppcontrib::knowhere::IndexIVFFlat> {
     using Tag = IVFFlatTag;
 };
 
+// fp16, bf16 and int8 IVF_FLAT vectors are stored as is rather than converted to fp32
+template <typename DataType, class IndexType>
+struct FaissIndexDispatch {
+    using Type = IndexType;
+};
+
+template <typename DataType>
+struct FaissIndexDispatch<DataType, faiss::cppcontrib::knowhere::IndexIVFFlat> {
+    using Type = std::conditional_t<KnowhereLowPrecisionTypeCheck<DataType>::value,
+                                    faiss::cppcontrib::knowhere::IndexIVFFlatTyped<DataType>,
+                                    faiss::cppcontrib::knowhere::IndexIVFFlat>;
+};
+
+template <typename DataType>
+struct FaissIndexDispatch<DataType, faiss::cppcontrib::knowhere::IndexIVFFlatCC> {
+    using Type = std::conditional_t<KnowhereLowPrecisionTypeCheck<DataType>::value,
+                                    faiss::cppcontrib::knowhere::IndexIVFFlatCCTyped<DataType>,
+                                    faiss::cppcontrib::knowhere::IndexIVFFlatCC>;
+};
+
 template <typename DataType, typename IndexType>
 class IvfIndexNode : public IndexNode {
+    using FaissIndexType = typename FaissIndexDispatch<DataType, IndexType>::Type;
+
  public:
     IvfIndexNode(const int32_t version, const Object& object) : IndexNode(version), index_(nullptr) {
         static_assert(std::is_same<IndexType, faiss::cppcontrib::knowhere::IndexIVFFlat>::value ||
@@ -69,8 +93,8 @@ class IvfIndexNode : public IndexNode {
                           std::is_same<IndexType, faiss::cppcontrib::knowhere::IndexIVFScalarQuantizerCC>::value ||
                           std::is_same<IndexType, IndexIVFRaBitQWrapper>::value,
                       "not support");
-        static_assert(std::is_same_v<DataType, fp32> || std::is_same_v<DataType, bin1>,
-                      "IvfIndexNode only support float/binary");
+        static_assert(std::is_same_v<DataType, fp32> || std::is_same_v<DataType, bin1> || IsTypedStorage(),
+                      "IvfIndexNode only support float/binary, and fp16/bf16/int8 for IVF_FLAT");
         search_pool_ = ThreadPool::GetGlobalSearchThreadPool();
         build_pool_ = ThreadPool::GetGlobalBuildThreadPool();
         base_index_lock_ = std::make_unique<FairRWLock>();
@@ -118,8 +142,8 @@ class IvfIndexNode : public IndexNode {
     GetVectorByIds(const DataSetPtr dataset, milvus::OpContext* op_context) const override;
     std::optional<size_t>
     GetQueryCodeSize(const DataSetPtr dataset) const override {
-        // only support fp32
-        return 4 * dataset->GetDim();
+        // only support fp32, and fp16/bf16/int8 for IVF_FLAT
+        return sizeof(DataType) * dataset->GetDim();
     }
     expected<DataSetPtr>
     CalcDistByIDs(const DataSetPtr dataset, const BitsetView& bitset, const int64_t* labels, const size_t labels_len,
@@ -215,6 +239,8 @@ class IvfIndexNode : public IndexNode {
         return this->SerializeImpl(binset);
     }
     Status
+    SerializeToFile(const std::string& filename, bool direct_io) const override;
+    Status
     Deserialize(const BinarySet& binset, std::shared_ptr<Config> cfg) override;
     Status
     DeserializeFromFile(const std::string& filename, std::shared_ptr<Config> cfg) override;
@@ -268,13 +294,15 @@ class IvfIndexNode : public IndexNode {
             auto nb = index_->invlists->compute_ntotal();
             auto nlist = index_->nlist;
             auto code_size = index_->code_size;
-            return ((nb + nlist) * (code_size + sizeof(int64_t)));
+            auto centroid_size = index_->d * sizeof(float);
+            return (nb * (code_size + sizeof(int64_t)) + nlist * (centroid_size + sizeof(int64_t)));
         }
         if constexpr (std::is_same<IndexType, faiss::cppcontrib::knowhere::IndexIVFFlatCC>::value) {
             auto nb = index_->invlists->compute_ntotal();
             auto nlist = index_->nlist;
             auto code_size = index_->code_size;
-            return (nb * code_size + nb * sizeof(int64_t) + nlist * code_size);
+            auto centroid_size = index_->d * sizeof(float);
+            return (nb * code_size + nb * sizeof(int64_t) + nlist * centroid_size);
         }
         if constexpr (std::is_same<IndexType, IndexIVFPQWrapper>::value) {
             return index_->size();
@@ -347,9 +375,78 @@ class IvfIndexNode : public IndexNode {
     Status
     SerializeImpl(BinarySet& binset) const;
 
+    void
+    WriteIndex(faiss::IOWriter* writer) const;
+
     Status
     TrainInternal(const DataSetPtr dataset, std::shared_ptr<Config> cfg);
 
+    // fp16/bf16/int8 IVF_FLAT keeps the vectors in their own type. Its scanners take the queries as is and divide by
+    // their norms for COSINE, because a normalized int8 query can not be represented.
+    static constexpr bool
+    IsTypedStorage() {
+        return !std::is_same_v<FaissIndexType, IndexType>;
+    }
+
+    // takes the ownership of an index loaded by read_index()
+    static std::unique_ptr<FaissIndexType>
+    FromLoadedIndex(faiss::cppcontrib::knowhere::Index* index) {
+        std::unique_ptr<faiss::cppcontrib::knowhere::Index> loaded(index);
+        if constexpr (IsTypedStorage()) {
+            // fp16/bf16/int8 IVF_FLAT indexes used to be stored as fp32 IndexIVFFlat, convert them back
+            auto legacy = dynamic_cast<faiss::cppcontrib::knowhere::IndexIVFFlat*>(loaded.get());
+            if (legacy != nullptr && dynamic_cast<FaissIndexType*>(legacy) == nullptr) {
+                return FromLegacyIndex(legacy);
+            }
+        }
+        return std::unique_ptr<FaissIndexType>(static_cast<FaissIndexType*>(loaded.release()));
+    }
+
+    // re-adds the fp32 vectors of a legacy IVF_FLAT to the same inverted lists of a typed one
+    static std::unique_ptr<FaissIndexType>
+    FromLegacyIndex(faiss::cppcontrib::knowhere::IndexIVFFlat* legacy) {
+        std::unique_ptr<FaissIndexType> converted;
+        if constexpr (std::is_same_v<IndexType, faiss::cppcontrib::knowhere::IndexIVFFlatCC>) {
+            auto legacy_lists =
+                dynamic_cast<const faiss::cppcontrib::knowhere::ConcurrentArrayInvertedLists*>(legacy->invlists);
+            if (legacy_lists == nullptr) {
+                throw std::runtime_error("unexpected inverted lists of a legacy IVF_FLAT_CC index");
+            }
+            converted = std::make_unique<FaissIndexType>(legacy->quantizer, legacy->d, legacy->nlist,
+                                                         legacy_lists->segment_size, legacy->metric_type,
+                                                         legacy->is_cosine);
+        } else {
+            converted = std::make_unique<FaissIndexType>(legacy->quantizer, legacy->d, legacy->nlist,
+                                                         legacy->metric_type, legacy->is_cosine);
+        }
+        // the quantizer moves to the converted index
+        converted->own_fields = legacy->own_fields;
+        legacy->own_fields = false;
+        converted->is_trained = legacy->is_trained;
+        converted->nprobe = legacy->nprobe;
+
+        const auto dim = legacy->d;
+        for (size_t list_no = 0; list_no < legacy->nlist; list_no++) {
+            const size_t list_size = legacy->invlists->list_size(list_no);
+            if (list_size == 0) {
+                continue;
+            }
+            auto vecs = std::make_unique<float[]>(list_size * dim);
+            std::vector<faiss::idx_t> ids(list_size);
+            for (size_t offset = 0; offset < list_size; offset++) {
+                faiss::cppcontrib::knowhere::InvertedLists::ScopedCodes code(legacy->invlists, list_no, offset);
+                std::memcpy(vecs.get() + offset * dim, code.get(), dim * sizeof(float));
+                ids[offset] = legacy->invlists->get_single_id(list_no, offset);
+            }
+            std::vector<faiss::idx_t> assign(list_size, list_no);
+            converted->add_core(list_size, vecs.get(), nullptr, ids.data(), assign.data());
+        }
+        if (legacy->direct_map.type != faiss::cppcontrib::knowhere::DirectMap::NoMap) {
+            converted->make_direct_map(true, legacy->direct_map.type);
+        }
+        return converted;
+    }
+
     static constexpr bool
     IsQuantized() {
         return std::is_same_v<IndexType, IndexIVFPQWrapper> || std::is_same_v<IndexType, IndexIVFSQWrapper> ||
@@ -365,7 +462,7 @@ class IvfIndexNode : public IndexNode {
     // TODO: If SCANN support Iterator, raw_distance() function should be override.
     class iterator : public IndexIterator {
      public:
-        iterator(const IndexType* index, std::unique_ptr<float[]>&& copied_query, const BitsetView& bitset,
+        iterator(const FaissIndexType* index, std::unique_ptr<float[]>&& copied_query, const BitsetView& bitset,
                  size_t nprobe, bool larger_is_closer, const float refine_ratio = 0.5f,
                  bool use_knowhere_search_pool = true)
             : IndexIterator(larger_is_closer, use_knowhere_search_pool, refine_ratio),
@@ -403,14 +500,14 @@ class IvfIndexNode : public IndexNode {
         }
 
      private:
-        const IndexType* index_ = nullptr;
+        const FaissIndexType* index_ = nullptr;
         std::unique_ptr<faiss::cppcontrib::knowhere::IVFIteratorWorkspace> workspace_ = nullptr;
         std::unique_ptr<float[]> copied_query_ = nullptr;
         std::unique_ptr<BitsetViewIDSelector> bw_idselector_ = nullptr;
         faiss::cppcontrib::knowhere::IVFSearchParameters ivf_search_params_;
     };
 
-    std::unique_ptr<IndexType> index_;
+    std::unique_ptr<FaissIndexType> index_;
     std::shared_ptr<ThreadPool> search_pool_;
     // Faiss uses OpenMP for training/building the index and we have no control
     // over those threads. build_pool_ is used to make sure the OMP threads
@@ -459,6 +556,20 @@ MatchNbits(int64_t size, int64_t nbits) {
 
 namespace {
 
+// the number of queries of a single search task, for the indexes that support the list-major scan. Small batches keep
+// one query per task, so that all the threads of the search pool are busy.
+int64_t
+GetSearchBlockSize(int64_t rows, size_t num_threads) {
+    constexpr int64_t kMinSearchBlockSize = 8;
+    constexpr int64_t kMaxSearchBlockSize = 256;
+
+    const int64_t block_size = rows / std::max<int64_t>(1, num_threads);
+    if (block_size < kMinSearchBlockSize) {
+        return 1;
+    }
+    return std::min(block_size, kMaxSearchBlockSize);
+}
+
 // turn IndexFlatElkan into IndexFlat
 std::unique_ptr<faiss::cppcontrib::knowhere::IndexFlat>
 to_index_flat(std::unique_ptr<faiss::cppcontrib::knowhere::IndexFlat>&& index) {
@@ -528,7 +639,9 @@ IvfIndexNode<DataType, IndexType>::TrainInternal(const DataSetPtr dataset, std::
 
     auto rows = dataset->GetRows();
     auto dim = dataset->GetDim();
-    auto data = dataset->GetTensor();
+    // fp16/bf16/int8 vectors are converted to fp32 for the clustering only
+    auto train_dataset = ConvertFromDataTypeIfNeeded<DataType>(dataset);
+    auto data = train_dataset->GetTensor();
 
     // faiss scann needs at least 16 rows since nbits=4
     constexpr int64_t SCANN_MIN_ROWS = 16;
@@ -539,7 +652,7 @@ IvfIndexNode<DataType, IndexType>::TrainInternal(const DataSetPtr dataset, std::
         }
     }
 
-    std::unique_ptr<IndexType> index;
+    std::unique_ptr<FaissIndexType> index;
     // if cfg.use_elkan is used, then we'll use a temporary instance of
     //  IndexFlatElkan for the training.
     if constexpr (std::is_same<faiss::cppcontrib::knowhere::IndexIVFFlat, IndexType>::value) {
@@ -552,8 +665,7 @@ IvfIndexNode<DataType, IndexType>::TrainInternal(const DataSetPtr dataset, std::
         std::unique_ptr<faiss::cppcontrib::knowhere::IndexFlat> qzr =
             std::make_unique<faiss::cppcontrib::knowhere::IndexFlatElkan>(dim, metric.value(), false, use_elkan);
         // create index. Index does not own qzr
-        index = std::make_unique<faiss::cppcontrib::knowhere::IndexIVFFlat>(qzr.get(), dim, nlist, metric.value(),
-                                                                            is_cosine);
+        index = std::make_unique<FaissIndexType>(qzr.get(), dim, nlist, metric.value(), is_cosine);
         // train
         index->train(rows, (const float*)data);
         // replace quantizer with a regular IndexFlat
@@ -572,8 +684,8 @@ IvfIndexNode<DataType, IndexType>::TrainInternal(const DataSetPtr dataset, std::
         std::unique_ptr<faiss::cppcontrib::knowhere::IndexFlat> qzr =
             std::make_unique<faiss::cppcontrib::knowhere::IndexFlatElkan>(dim, metric.value(), false, use_elkan);
         // create index. Index does not own qzr
-        index = std::make_unique<faiss::cppcontrib::knowhere::IndexIVFFlatCC>(
-            qzr.get(), dim, nlist, ivf_flat_cc_cfg.ssize.value(), metric.value(), is_cosine);
+        index = std::make_unique<FaissIndexType>(qzr.get(), dim, nlist, ivf_flat_cc_cfg.ssize.value(), metric.value(),
+                                                 is_cosine);
         // train
         index->train(rows, (const float*)data);
         // replace quantizer with a regular IndexFlat
@@ -760,6 +872,14 @@ IvfIndexNode<DataType, IndexType>::Add(const DataSetPtr dataset, std::shared_ptr
                           }
                           if constexpr (std::is_same<faiss::cppcontrib::knowhere::IndexBinaryIVF, IndexType>::value) {
                               index_->add(rows, (const uint8_t*)data);
+                          } else if constexpr (IsTypedStorage()) {
+                              // only a batch of vectors is converted to fp32 at a time, for the coarse assignment
+                              constexpr int64_t kAddBatchSize = 65536;
+                              for (int64_t start = 0; start < rows; start += kAddBatchSize) {
+                                  auto count = std::min(kAddBatchSize, rows - start);
+                                  auto batch = ConvertFromDataTypeIfNeeded<DataType>(dataset, start, count);
+                                  index_->add(count, (const float*)batch->GetTensor());
+                              }
                           } else {
                               index_->add(rows, (const float*)data);
                           }
@@ -858,7 +978,9 @@ IvfIndexNode<DataType, IndexType>::Search(const DataSetPtr dataset, std::unique_
 
     auto dim = dataset->GetDim();
     auto rows = dataset->GetRows();
-    auto data = dataset->GetTensor();
+    // fp16/bf16/int8 queries are converted back to their type by the IVF_FLAT scanners
+    auto query_dataset = ConvertFromDataTypeIfNeeded<DataType>(dataset);
+    auto data = query_dataset->GetTensor();
 
     const IvfConfig& ivf_cfg = static_cast<const IvfConfig&>(*cfg);
     bool is_cosine = IsMetricType(ivf_cfg.metric_type.value(), knowhere::metric::COSINE);
@@ -884,16 +1006,36 @@ IvfIndexNode<DataType, IndexType>::Search(const DataSetPtr dataset, std::unique_
         }
     }
 
+    // IVF_FLAT, IVF_PQ, IVF_SQ and SCANN search a block of queries per task. For the first three, the coarse
+    // assignment of a block is a single GEMM and every probed inverted list is scanned once for all the queries of
+    // the block. SCANN batches the queries of a block in its fast-scan kernels.
+    constexpr bool is_block_search_supported =
+        std::is_same<IndexType, faiss::cppcontrib::knowhere::IndexIVFFlat>::value ||
+        std::is_same<IndexType, IndexIVFPQWrapper>::value || std::is_same<IndexType, IndexIVFSQWrapper>::value ||
+        std::is_same<IndexType, faiss::cppcontrib::knowhere::IndexScaNN>::value;
+    int64_t block_size = 1;
+    if constexpr (is_block_search_supported) {
+        // ensure_topk_full relies on max_codes, which is tracked per query
+        bool ensure_topk_full = false;
+        if constexpr (std::is_same<IndexType, faiss::cppcontrib::knowhere::IndexScaNN>::value) {
+            ensure_topk_full = static_cast<const ScannConfig&>(*cfg).ensure_topk_full.value();
+        }
+        if (!ensure_topk_full) {
+            block_size = GetSearchBlockSize(rows, search_pool_->size());
+        }
+    }
+
     auto ids = std::make_unique<int64_t[]>(rows * k);
     auto distances = std::make_unique<float[]>(rows * k);
     try {
         std::vector<folly::Future<folly::Unit>> futs;
-        futs.reserve(rows);
-        for (int i = 0; i < rows; ++i) {
+        futs.reserve((rows + block_size - 1) / block_size);
+        for (int64_t i = 0; i < rows; i += block_size) {
             futs.emplace_back(search_pool_->push([&, index = i] {
                 knowhere::checkCancellation(op_context);
                 ThreadPool::ScopedSearchOmpSetter setter(1);
                 auto offset = k * index;
+                auto block_n = std::min(block_size, rows - index);
                 std::unique_ptr<float[]> copied_query = nullptr;
 
                 BitsetViewIDSelector bw_idselector(bitset);
@@ -919,7 +1061,7 @@ IvfIndexNode<DataType, IndexType>::Search(const DataSetPtr dataset, std::unique_
                                      std::is_same<IndexType,
                                                   faiss::cppcontrib::knowhere::IndexIVFScalarQuantizerCC>::value) {
                     auto cur_query = (const float*)data + index * dim;
-                    if (is_cosine) {
+                    if (is_cosine && !IsTypedStorage()) {
                         copied_query = CopyAndNormalizeVecs(cur_query, 1, dim);
                         cur_query = copied_query.get();
                     }
@@ -943,7 +1085,7 @@ IvfIndexNode<DataType, IndexType>::Search(const DataSetPtr dataset, std::unique_
                     auto cur_query = (const float*)data + index * dim;
                     const ScannConfig& scann_cfg = static_cast<const ScannConfig&>(*cfg);
                     if (is_cosine) {
-                        copied_query = CopyAndNormalizeVecs(cur_query, 1, dim);
+                        copied_query = CopyAndNormalizeVecs(cur_query, block_n, dim);
                         cur_query = copied_query.get();
                     }
 
@@ -972,7 +1114,8 @@ IvfIndexNode<DataType, IndexType>::Search(const DataSetPtr dataset, std::unique_
                     scann_search_params.base_index_params = &base_search_params;
                     scann_search_params.reorder_k = scann_cfg.reorder_k.value();
 
-                    index_->search(1, cur_query, k, distances.get() + offset, ids.get() + offset, &scann_search_params);
+                    index_->search(block_n, cur_query, k, distances.get() + offset, ids.get() + offset,
+                                   &scann_search_params);
                 } else if constexpr (std::is_same<IndexType, IndexIVFRaBitQWrapper>::value) {
                     auto cur_query = (const float*)data + index * dim;
                     if (is_cosine) {
@@ -1016,7 +1159,7 @@ IvfIndexNode<DataType, IndexType>::Search(const DataSetPtr dataset, std::unique_
                 } else if constexpr (std::is_same<IndexType, IndexIVFPQWrapper>::value) {
                     auto cur_query = (const float*)data + index * dim;
                     if (is_cosine) {
-                        copied_query = CopyAndNormalizeVecs(cur_query, 1, dim);
+                        copied_query = CopyAndNormalizeVecs(cur_query, block_n, dim);
                         cur_query = copied_query.get();
                     }
 
@@ -1037,6 +1180,7 @@ IvfIndexNode<DataType, IndexType>::Search(const DataSetPtr dataset, std::unique_
                     ivf_search_params.nprobe = nprobe;
                     ivf_search_params.max_codes = 0;
                     ivf_search_params.sel = id_selector;
+                    ivf_search_params.list_major_scan = (block_n > 1);
                     if (use_refine && whether_to_enable_refine) {
                         // yes, use refine
                         faiss::cppcontrib::knowhere::IndexRefineSearchParameters refine_search_params;
@@ -1044,17 +1188,17 @@ IvfIndexNode<DataType, IndexType>::Search(const DataSetPtr dataset, std::unique_
                         refine_search_params.k_factor = ivf_pg_cfg.refine_k.value_or(1);
                         refine_search_params.base_index_params = &ivf_search_params;
 
-                        index_->search(1, cur_query, k, distances.get() + offset, ids.get() + offset,
+                        index_->search(block_n, cur_query, k, distances.get() + offset, ids.get() + offset,
                                        &refine_search_params);
                     } else {
                         // do not use refine
-                        index_->search(1, cur_query, k, distances.get() + offset, ids.get() + offset,
+                        index_->search(block_n, cur_query, k, distances.get() + offset, ids.get() + offset,
                                        &ivf_search_params);
                     }
                 } else if constexpr (std::is_same<IndexType, IndexIVFSQWrapper>::value) {
                     auto cur_query = (const float*)data + index * dim;
                     if (is_cosine) {
-                        copied_query = CopyAndNormalizeVecs(cur_query, 1, dim);
+                        copied_query = CopyAndNormalizeVecs(cur_query, block_n, dim);
                         cur_query = copied_query.get();
                     }
 
@@ -1075,6 +1219,7 @@ IvfIndexNode<DataType, IndexType>::Search(const DataSetPtr dataset, std::unique_
                     ivf_search_params.nprobe = nprobe;
                     ivf_search_params.max_codes = 0;
                     ivf_search_params.sel = id_selector;
+                    ivf_search_params.list_major_scan = (block_n > 1);
                     if (use_refine && whether_to_enable_refine) {
                         // yes, use refine
                         faiss::cppcontrib::knowhere::IndexRefineSearchParameters refine_search_params;
@@ -1082,17 +1227,17 @@ IvfIndexNode<DataType, IndexType>::Search(const DataSetPtr dataset, std::unique_
                         refine_search_params.k_factor = ivf_sq_cfg.refine_k.value_or(1);
                         refine_search_params.base_index_params = &ivf_search_params;
 
-                        index_->search(1, cur_query, k, distances.get() + offset, ids.get() + offset,
+                        index_->search(block_n, cur_query, k, distances.get() + offset, ids.get() + offset,
                                        &refine_search_params);
                     } else {
                         // do not use refine
-                        index_->search(1, cur_query, k, distances.get() + offset, ids.get() + offset,
+                        index_->search(block_n, cur_query, k, distances.get() + offset, ids.get() + offset,
                                        &ivf_search_params);
                     }
                 } else {
                     auto cur_query = (const float*)data + index * dim;
-                    if (is_cosine) {
-                        copied_query = CopyAndNormalizeVecs(cur_query, 1, dim);
+                    if (is_cosine && !IsTypedStorage()) {
+                        copied_query = CopyAndNormalizeVecs(cur_query, block_n, dim);
                         cur_query = copied_query.get();
                     }
 
@@ -1100,8 +1245,10 @@ IvfIndexNode<DataType, IndexType>::Search(const DataSetPtr dataset, std::unique_
                     ivf_search_params.nprobe = nprobe;
                     ivf_search_params.max_codes = 0;
                     ivf_search_params.sel = id_selector;
+                    ivf_search_params.list_major_scan = (block_n > 1);
 
-                    index_->search(1, cur_query, k, distances.get() + offset, ids.get() + offset, &ivf_search_params);
+                    index_->search(block_n, cur_query, k, distances.get() + offset, ids.get() + offset,
+                                   &ivf_search_params);
                 }
             }));
         }
@@ -1132,7 +1279,8 @@ IvfIndexNode<DataType, IndexType>::CalcDistByIDs(const DataSetPtr dataset, const
     if constexpr (std::is_same_v<IndexType, faiss::cppcontrib::knowhere::IndexIVFFlat> ||
                   std::is_same_v<IndexType, faiss::cppcontrib::knowhere::IndexIVFFlatCC>) {
         auto num_queries = dataset->GetRows();
-        auto query_data = dataset->GetTensor();
+        auto query_dataset = ConvertFromDataTypeIfNeeded<DataType>(dataset);
+        auto query_data = query_dataset->GetTensor();
         auto dim = dataset->GetDim();
         auto distances = std::make_unique<float[]>(num_queries * labels_len);
 
@@ -1144,7 +1292,7 @@ IvfIndexNode<DataType, IndexType>::CalcDistByIDs(const DataSetPtr dataset, const
                     ThreadPool::ScopedSearchOmpSetter setter(1);
                     std::unique_ptr<float[]> copied_query = nullptr;
                     auto query = (const float*)query_data + index * dim;
-                    if (is_cosine) {
+                    if (is_cosine && !IsTypedStorage()) {
                         copied_query = CopyAndNormalizeVecs(query, 1, dim);
                         query = copied_query.get();
                     }
@@ -1184,7 +1332,8 @@ IvfIndexNode<DataType, IndexType>::RangeSearch(const DataSetPtr dataset, std::un
     }
 
     auto nq = dataset->GetRows();
-    auto xq = dataset->GetTensor();
+    auto query_dataset = ConvertFromDataTypeIfNeeded<DataType>(dataset);
+    auto xq = query_dataset->GetTensor();
     auto dim = dataset->GetDim();
 
     const IvfConfig& ivf_cfg = static_cast<const IvfConfig&>(*cfg);
@@ -1223,7 +1372,7 @@ IvfIndexNode<DataType, IndexType>::RangeSearch(const DataSetPtr dataset, std::un
                     index_->range_search(1, cur_data, radius, &res, &ivf_search_params);
                 } else if constexpr (std::is_same<IndexType, faiss::cppcontrib::knowhere::IndexIVFFlat>::value) {
                     auto cur_query = (const float*)xq + index * dim;
-                    if (is_cosine) {
+                    if (is_cosine && !IsTypedStorage()) {
                         copied_query = CopyAndNormalizeVecs(cur_query, 1, dim);
                         cur_query = copied_query.get();
                     }
@@ -1368,7 +1517,7 @@ IvfIndexNode<DataType, IndexType>::RangeSearch(const DataSetPtr dataset, std::un
                     }
                 } else {
                     auto cur_query = (const float*)xq + index * dim;
-                    if (is_cosine) {
+                    if (is_cosine && !IsTypedStorage()) {
                         copied_query = CopyAndNormalizeVecs(cur_query, 1, dim);
                         cur_query = copied_query.get();
                     }
@@ -1425,7 +1574,8 @@ IvfIndexNode<DataType, IndexType>::AnnIterator(const DataSetPtr dataset, std::un
     } else {
         auto dim = dataset->GetDim();
         auto rows = dataset->GetRows();
-        auto data = dataset->GetTensor();
+        auto query_dataset = ConvertFromDataTypeIfNeeded<DataType>(dataset);
+        auto data = query_dataset->GetTensor();
 
         auto vec = std::vector<IndexNode::IteratorPtr>(rows, nullptr);
 
@@ -1446,7 +1596,7 @@ IvfIndexNode<DataType, IndexType>::AnnIterator(const DataSetPtr dataset, std::un
                 auto cur_query = (const float*)data + i * dim;
                 // if cosine, need normalize
                 std::unique_ptr<float[]> copied_query = nullptr;
-                if (is_cosine) {
+                if (is_cosine && !IsTypedStorage()) {
                     copied_query = CopyAndNormalizeVecs(cur_query, 1, dim);
                 } else {
                     copied_query = std::make_unique<float[]>(dim);
@@ -1500,7 +1650,7 @@ IvfIndexNode<DataType, IndexType>::GetVectorByIds(const DataSetPtr dataset, milv
         auto ids = dataset->GetIds();
 
         try {
-            auto data = std::make_unique<float[]>(dim * rows);
+            auto data = std::make_unique<DataType[]>(dim * rows);
             for (int64_t i = 0; i < rows; i++) {
                 int64_t id = ids[i];
                 assert(id >= 0 && id < index_->ntotal);
@@ -1577,6 +1727,22 @@ IvfIndexNode<DataType, IndexType>::GetIndexMetaImpl(std::unique_ptr<Config>, IVF
     return GenResultDataSet(json_meta.dump(), json_id_set.dump());
 }
 
+template <typename DataType, typename IndexType>
+void
+IvfIndexNode<DataType, IndexType>::WriteIndex(faiss::IOWriter* writer) const {
+    if constexpr (std::is_same<IndexType, faiss::cppcontrib::knowhere::IndexBinaryIVF>::value) {
+        faiss::cppcontrib::knowhere::write_index_binary(index_.get(), writer);
+    } else if constexpr (std::is_same<IndexType, IndexIVFRaBitQWrapper>::value) {
+        faiss::cppcontrib::knowhere::write_index(index_->index.get(), writer);
+    } else if constexpr (std::is_same<IndexType, IndexIVFPQWrapper>::value) {
+        faiss::cppcontrib::knowhere::write_index(index_->index.get(), writer);
+    } else if constexpr (std::is_same<IndexType, IndexIVFSQWrapper>::value) {
+        faiss::cppcontrib::knowhere::write_index(index_->index.get(), writer);
+    } else {
+        faiss::cppcontrib::knowhere::write_index(index_.get(), writer);
+    }
+}
+
 template <typename DataType, typename IndexType>
 Status
 IvfIndexNode<DataType, IndexType>::SerializeImpl(BinarySet& binset) const {
@@ -1586,17 +1752,7 @@ IvfIndexNode<DataType, IndexType>::SerializeImpl(BinarySet& binset) const {
             return Status::empty_index;
         }
         MemoryIOWriter writer;
-        if constexpr (std::is_same<IndexType, faiss::cppcontrib::knowhere::IndexBinaryIVF>::value) {
-            faiss::cppcontrib::knowhere::write_index_binary(index_.get(), &writer);
-        } else if constexpr (std::is_same<IndexType, IndexIVFRaBitQWrapper>::value) {
-            faiss::cppcontrib::knowhere::write_index(index_->index.get(), &writer);
-        } else if constexpr (std::is_same<IndexType, IndexIVFPQWrapper>::value) {
-            faiss::cppcontrib::knowhere::write_index(index_->index.get(), &writer);
-        } else if constexpr (std::is_same<IndexType, IndexIVFSQWrapper>::value) {
-            faiss::cppcontrib::knowhere::write_index(index_->index.get(), &writer);
-        } else {
-            faiss::cppcontrib::knowhere::write_index(index_.get(), &writer);
-        }
+        WriteExactSize(writer, [this](IOWriter& w) { WriteIndex(&w); });
         std::shared_ptr<uint8_t[]> data(writer.data());
         binset.Append(Type(), data, writer.tellg());
         return Status::success;
@@ -1606,6 +1762,24 @@ IvfIndexNode<DataType, IndexType>::SerializeImpl(BinarySet& binset) const {
     }
 }
 
+template <typename DataType, typename IndexType>
+Status
+IvfIndexNode<DataType, IndexType>::SerializeToFile(const std::string& filename, bool direct_io) const {
+    try {
+        if (!this->index_) {
+            LOG_KNOWHERE_WARNING_ << "index can not be serialized for empty index";
+            return Status::empty_index;
+        }
+        FileIOWriter writer(filename, direct_io);
+        WriteIndex(&writer);
+        writer.close();
+        return Status::success;
+    } catch (const std::exception& e) {
+        LOG_KNOWHERE_WARNING_ << "faiss inner error: " << e.what();
+        return Status::faiss_inner_error;
+    }
+}
+
 template <typename DataType, typename IndexType>
 Status
 IvfIndexNode<DataType, IndexType>::Deserialize(const BinarySet& binset, std::shared_ptr<Config> cfg) {
@@ -1618,7 +1792,9 @@ IvfIndexNode<DataType, IndexType>::Deserialize(const BinarySet& binset, std::sha
         return Status::invalid_binary_set;
     }
 
-    MemoryIOReader reader(binary->data.get(), binary->size);
+    const BaseConfig& base_cfg = static_cast<const BaseConfig&>(*cfg);
+    auto reader_ptr = CreateBinaryIOReader(binary->data, binary->size, base_cfg.enable_zero_copy.value_or(false));
+    auto& reader = *reader_ptr;
     try {
         if constexpr (std::is_same<IndexType, IndexIVFRaBitQWrapper>::value) {
             // a special case for IVFRaBitQ, bcz a wrapper is involved.
@@ -1663,12 +1839,11 @@ IvfIndexNode<DataType, IndexType>::Deserialize(const BinarySet& binset, std::sha
             if constexpr (std::is_same<IndexType, faiss::cppcontrib::knowhere::IndexBinaryIVF>::value) {
                 index_.reset(static_cast<IndexType*>(faiss::cppcontrib::knowhere::read_index_binary(&reader)));
             } else {
-                index_.reset(static_cast<IndexType*>(faiss::cppcontrib::knowhere::read_index(&reader)));
+                index_ = FromLoadedIndex(faiss::cppcontrib::knowhere::read_index(&reader));
             }
 
             if constexpr (!std::is_same_v<IndexType, faiss::cppcontrib::knowhere::IndexScaNN> &&
                           !std::is_same_v<IndexType, faiss::cppcontrib::knowhere::IndexIVFScalarQuantizerCC>) {
-                const BaseConfig& base_cfg = static_cast<const BaseConfig&>(*cfg);
                 if (HasRawData(base_cfg.metric_type.value())) {
                     index_->make_direct_map(true);
                 }
@@ -1735,8 +1910,7 @@ IvfIndexNode<DataType, IndexType>::DeserializeFromFile(const std::string& filena
                 index_.reset(
                     static_cast<IndexType*>(faiss::cppcontrib::knowhere::read_index_binary(filename.data(), io_flags)));
             } else {
-                index_.reset(
-                    static_cast<IndexType*>(faiss::cppcontrib::knowhere::read_index(filename.data(), io_flags)));
+                index_ = FromLoadedIndex(faiss::cppcontrib::knowhere::read_index(filename.data(), io_flags));
             }
 
             if constexpr (!std::is_same_v<IndexType, faiss::cppcontrib::knowhere::IndexScaNN>) {
@@ -1759,18 +1933,14 @@ KNOWHERE_SIMPLE_REGISTER_DENSE_BIN_GLOBAL(BIN_IVF_FLAT, IvfIndexNode, knowhere::
                                           faiss::cppcontrib::knowhere::IndexBinaryIVF)
 
 // float
-KNOWHERE_MOCK_REGISTER_DENSE_FLOAT_ALL_GLOBAL(IVFFLAT, IvfIndexNode,
-                                              knowhere::feature::MMAP | knowhere::feature::EMB_LIST,
-                                              faiss::cppcontrib::knowhere::IndexIVFFlat)
-KNOWHERE_MOCK_REGISTER_DENSE_FLOAT_ALL_GLOBAL(IVF_FLAT, IvfIndexNode,
-                                              knowhere::feature::MMAP | knowhere::feature::EMB_LIST,
-                                              faiss::cppcontrib::knowhere::IndexIVFFlat)
-KNOWHERE_MOCK_REGISTER_DENSE_FLOAT_ALL_GLOBAL(IVFFLATCC, IvfIndexNode,
-                                              knowhere::feature::NONE | knowhere::feature::EMB_LIST,
-                                              faiss::cppcontrib::knowhere::IndexIVFFlatCC)
-KNOWHERE_MOCK_REGISTER_DENSE_FLOAT_ALL_GLOBAL(IVF_FLAT_CC, IvfIndexNode,
-                                              knowhere::feature::NONE | knowhere::feature::EMB_LIST,
-                                              faiss::cppcontrib::knowhere::IndexIVFFlatCC)
+KNOWHERE_SIMPLE_REGISTER_DENSE_FLOAT_ALL_GLOBAL(IVFFLAT, IvfIndexNode, knowhere::feature::MMAP | knowhere::feature::EMB_LIST,
+                                                faiss::cppcontrib::knowhere::IndexIVFFlat)
+KNOWHERE_SIMPLE_REGISTER_DENSE_FLOAT_ALL_GLOBAL(IVF_FLAT, IvfIndexNode, knowhere::feature::MMAP | knowhere::feature::EMB_LIST,
+                                                faiss::cppcontrib::knowhere::IndexIVFFlat)
+KNOWHERE_SIMPLE_REGISTER_DENSE_FLOAT_ALL_GLOBAL(IVFFLATCC, IvfIndexNode, knowhere::feature::NONE | knowhere::feature::EMB_LIST,
+                                                faiss::cppcontrib::knowhere::IndexIVFFlatCC)
+KNOWHERE_SIMPLE_REGISTER_DENSE_FLOAT_ALL_GLOBAL(IVF_FLAT_CC, IvfIndexNode, knowhere::feature::NONE | knowhere::feature::EMB_LIST,
+                                                faiss::cppcontrib::knowhere::IndexIVFFlatCC)
 KNOWHERE_MOCK_REGISTER_DENSE_FLOAT_ALL_GLOBAL(SCANN, IvfIndexNode, knowhere::feature::MMAP,
                                               faiss::cppcontrib::knowhere::IndexScaNN)
 KNOWHERE_MOCK_REGISTER_DENSE_FLOAT_ALL_GLOBAL(IVFPQ, IvfIndexNode, knowhere::feature::MMAP, IndexIVFPQWrapper)
@@ -1783,15 +1953,14 @@ KNOWHERE_MOCK_REGISTER_DENSE_FLOAT_ALL_GLOBAL(IVF_SQ_CC, IvfIndexNode, knowhere:
 KNOWHERE_MOCK_REGISTER_DENSE_FLOAT_ALL_GLOBAL(IVFRABITQ, IvfIndexNode, knowhere::feature::MMAP, IndexIVFRaBitQWrapper)
 KNOWHERE_MOCK_REGISTER_DENSE_FLOAT_ALL_GLOBAL(IVF_RABITQ, IvfIndexNode, knowhere::feature::MMAP, IndexIVFRaBitQWrapper)
 // int
-KNOWHERE_MOCK_REGISTER_DENSE_INT_GLOBAL(IVFFLAT, IvfIndexNode, knowhere::feature::MMAP | knowhere::feature::EMB_LIST,
-                                        faiss::cppcontrib::knowhere::IndexIVFFlat)
-KNOWHERE_MOCK_REGISTER_DENSE_INT_GLOBAL(IVF_FLAT, IvfIndexNode, knowhere::feature::MMAP | knowhere::feature::EMB_LIST,
-                                        faiss::cppcontrib::knowhere::IndexIVFFlat)
-KNOWHERE_MOCK_REGISTER_DENSE_INT_GLOBAL(IVFFLATCC, IvfIndexNode, knowhere::feature::NONE | knowhere::feature::EMB_LIST,
-                                        faiss::cppcontrib::knowhere::IndexIVFFlatCC)
-KNOWHERE_MOCK_REGISTER_DENSE_INT_GLOBAL(IVF_FLAT_CC, IvfIndexNode,
-                                        knowhere::feature::NONE | knowhere::feature::EMB_LIST,
-                                        faiss::cppcontrib::knowhere::IndexIVFFlatCC)
+KNOWHERE_SIMPLE_REGISTER_DENSE_INT_GLOBAL(IVFFLAT, IvfIndexNode, knowhere::feature::MMAP | knowhere::feature::EMB_LIST,
+                                          faiss::cppcontrib::knowhere::IndexIVFFlat)
+KNOWHERE_SIMPLE_REGISTER_DENSE_INT_GLOBAL(IVF_FLAT, IvfIndexNode, knowhere::feature::MMAP | knowhere::feature::EMB_LIST,
+                                          faiss::cppcontrib::knowhere::IndexIVFFlat)
+KNOWHERE_SIMPLE_REGISTER_DENSE_INT_GLOBAL(IVFFLATCC, IvfIndexNode, knowhere::feature::NONE | knowhere::feature::EMB_LIST,
+                                          faiss::cppcontrib::knowhere::IndexIVFFlatCC)
+KNOWHERE_SIMPLE_REGISTER_DENSE_INT_GLOBAL(IVF_FLAT_CC, IvfIndexNode, knowhere::feature::NONE | knowhere::feature::EMB_LIST,
+                                          faiss::cppcontrib::knowhere::IndexIVFFlatCC)
 KNOWHERE_MOCK_REGISTER_DENSE_INT_GLOBAL(SCANN, IvfIndexNode, knowhere::feature::MMAP,
                                         faiss::cppcontrib::knowhere::IndexScaNN)
 KNOWHERE_MOCK_REGISTER_DENSE_INT_GLOBAL(IVFPQ, IvfIndexNode, knowhere::feature::MMAP, IndexIVFPQWrapper)
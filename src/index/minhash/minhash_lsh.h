@@ -525,6 +525,9 @@ MinHashLSH::BatchSearch(const char* query, size_t nq, float* distances, idx_t* l
                         auto index = access_list[j];
                         const auto hash = band_i_q_hash[index];
                         auto& res = all_res[index];
+                        if (j + kBloomPrefetchDistance < query_id_end) {
+                            bloom.prefetch(band_i_q_hash[access_list[j + kBloomPrefetchDistance]]);
+                        }
                         if (res.full()) {
                             continue;
                         }
@@ -31,6 +31,8 @@ struct KVPair {
 constexpr int kBatch = 4096;
 constexpr int kQueryBatch = 64;
 constexpr int kQueryBandBatch = 4;
+// queries ahead whose bloom filter block is prefetched in batch search
+constexpr int kBloomPrefetchDistance = 4;
 using idx_t = faiss::idx_t;
 
 struct MinHashLSHResultHandler {
@@ -0,0 +1,249 @@
+// Copyright (C) 2019-2023 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License.
+
+#ifndef SPARSE_DOC_REORDER_H
+#define SPARSE_DOC_REORDER_H
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "knowhere/comp/task.h"
+#include "knowhere/sparse_utils.h"
+#include "knowhere/thread_pool.h"
+
+namespace knowhere::sparse {
+
+// Orders rows with recursive graph bisection (Dhulipala et al., "Compressing Graphs and Indexes with Recursive Graph
+// Bisection", KDD 2016), also known as BP ordering.
+//
+// The rows are split in two halves, and rows are swapped between the halves as long as that lowers the estimated
+// number of bits needed to encode the gaps of the posting lists, log2(n / (deg + 1)) per posting of a dim with deg
+// postings in a half of n rows. Both halves are then bisected in the same way, so that rows sharing many dims end up
+// next to each other, which shortens the gaps of posting lists and packs the high scores of a dim into fewer blocks.
+template <typename DType>
+class GraphBisectionReorderer {
+ public:
+    GraphBisectionReorderer(const SparseRow<DType>* data, size_t rows) : rows_(rows) {
+        build_forward_index(data);
+    }
+
+    // returns the new order of the rows, the i-th row of the new order being row order[i]. With a pool, partitions
+    // are bisected by its tasks once every thread has one.
+    std::vector<table_t>
+    Reorder(ThreadPool* pool) {
+        std::vector<table_t> order(rows_);
+        std::iota(order.begin(), order.end(), 0);
+        if (nr_terms_ == 0 || rows_ <= kMinPartitionSize) {
+            return order;
+        }
+
+        const size_t nr_threads = pool == nullptr ? 1 : std::max<size_t>(pool->size(), 1);
+        std::vector<std::pair<size_t, size_t>> partitions = {{0, rows_}};
+        while (!partitions.empty()) {
+            // once there are enough partitions for all threads, each one is bisected down to the leaves
+            const bool to_leaves = partitions.size() >= nr_threads;
+            const size_t nr_tasks = std::min(partitions.size(), nr_threads);
+            auto task = [&](size_t t) {
+                Scratch scratch(nr_terms_);
+                for (size_t p = t; p < partitions.size(); p += nr_tasks) {
+                    auto [begin, end] = partitions[p];
+                    if (to_leaves) {
+                        bisect_to_leaves(order, begin, end, scratch);
+                    } else {
+                        bisect(order, begin, end, scratch);
+                    }
+                }
+            };
+            if (nr_tasks == 1) {
+                task(0);
+            } else {
+                std::vector<folly::Future<folly::Unit>> futures;
+                futures.reserve(nr_tasks);
+                for (size_t t = 0; t < nr_tasks; ++t) {
+                    futures.emplace_back(pool->push([&, t] { task(t); }));
+                }
+                WaitAllSuccess(futures);
+            }
+            if (to_leaves) {
+                break;
+            }
+            std::vector<std::pair<size_t, size_t>> next_partitions;
+            for (auto [begin, end] : partitions) {
+                if (end - begin > kMinPartitionSize) {
+                    const size_t mid = begin + (end - begin) / 2;
+                    next_partitions.emplace_back(begin, mid);
+                    next_partitions.emplace_back(mid, end);
+                }
+            }
+            partitions = std::move(next_partitions);
+        }
+        return order;
+    }
+
+ private:
+    // partitions of at most this many rows are left as is
+    static constexpr size_t kMinPartitionSize = 16;
+    static constexpr size_t kMaxIterations = 20;
+    static constexpr uint32_t kNoTerm = std::numeric_limits<uint32_t>::max();
+
+    // per task buffers, the degrees are all zero between two bisections
+    struct Scratch {
+        explicit Scratch(size_t nr_terms)
+            : left_deg(nr_terms, 0), right_deg(nr_terms, 0), to_left_gain(nr_terms), to_right_gain(nr_terms) {
+        }
+        std::vector<uint32_t> left_deg;
+        std::vector<uint32_t> right_deg;
+        std::vector<float> to_left_gain;
+        std::vector<float> to_right_gain;
+        std::vector<uint32_t> touched_terms;
+        // (gain, position in order) of the rows of each half
+        std::vector<std::pair<float, size_t>> left_gains;
+        std::vector<std::pair<float, size_t>> right_gains;
+    };
+
+    // the dims of each row as dense term ids, dims that appear in a single row don't change the cost and are dropped
+    void
+    build_forward_index(const SparseRow<DType>* data) {
+        std::unordered_map<table_t, uint32_t> term_ids;
+        std::vector<uint32_t> doc_freqs;
+        for (size_t i = 0; i < rows_; ++i) {
+            for (size_t j = 0; j < data[i].size(); ++j) {
+                auto [dim, val] = data[i][j];
+                if (val == 0) {
+                    continue;
+                }
+                auto [it, inserted] = term_ids.emplace(dim, doc_freqs.size());
+                if (inserted) {
+                    doc_freqs.push_back(0);
+                }
+                doc_freqs[it->second]++;
+            }
+        }
+        std::vector<uint32_t> dense_ids(doc_freqs.size(), kNoTerm);
+        for (size_t t = 0; t < doc_freqs.size(); ++t) {
+            if (doc_freqs[t] > 1) {
+                dense_ids[t] = nr_terms_++;
+            }
+        }
+
+        term_offsets_.resize(rows_ + 1, 0);
+        for (size_t i = 0; i < rows_; ++i) {
+            for (size_t j = 0; j < data[i].size(); ++j) {
+                auto [dim, val] = data[i][j];
+                if (val == 0) {
+                    continue;
+                }
+                auto term = dense_ids[term_ids.find(dim)->second];
+                if (term != kNoTerm) {
+                    terms_.push_back(term);
+                }
+            }
+            term_offsets_[i + 1] = terms_.size();
+        }
+    }
+
+    // estimated bits of the gaps of a dim with deg postings among n rows
+    static inline float
+    cost(uint32_t deg, size_t n) {
+        return deg == 0 ? 0.0f : deg * std::log2(static_cast<float>(n) / (deg + 1));
+    }
+
+    void
+    bisect_to_leaves(std::vector<table_t>& order, size_t begin, size_t end, Scratch& scratch) const {
+        if (end - begin <= kMinPartitionSize) {
+            return;
+        }
+        bisect(order, begin, end, scratch);
+        const size_t mid = begin + (end - begin) / 2;
+        bisect_to_leaves(order, begin, mid, scratch);
+        bisect_to_leaves(order, mid, end, scratch);
+    }
+
+    // moves rows between order[begin, mid) and order[mid, end) to lower the cost of the two halves
+    void
+    bisect(std::vector<table_t>& order, size_t begin, size_t end, Scratch& scratch) const {
+        const size_t mid = begin + (end - begin) / 2;
+        const size_t n_left = mid - begin;
+        const size_t n_right = end - mid;
+        auto& touched = scratch.touched_terms;
+        for (size_t iter = 0; iter < kMaxIterations; ++iter) {
+            touched.clear();
+            for (size_t pos = begin; pos < end; ++pos) {
+                auto& deg = pos < mid ? scratch.left_deg : scratch.right_deg;
+                for (size_t k = term_offsets_[order[pos]]; k < term_offsets_[order[pos] + 1]; ++k) {
+                    const auto term = terms_[k];
+                    if (scratch.left_deg[term] == 0 && scratch.right_deg[term] == 0) {
+                        touched.push_back(term);
+                    }
+                    deg[term]++;
+                }
+            }
+            for (auto term : touched) {
+                const auto l = scratch.left_deg[term];
+                const auto r = scratch.right_deg[term];
+                const float current = cost(l, n_left) + cost(r, n_right);
+                scratch.to_right_gain[term] = l == 0 ? 0.0f : current - cost(l - 1, n_left) - cost(r + 1, n_right);
+                scratch.to_left_gain[term] = r == 0 ? 0.0f : current - cost(l + 1, n_left) - cost(r - 1, n_right);
+            }
+
+            auto row_gain = [&](size_t pos, const std::vector<float>& term_gains) {
+                float gain = 0.0f;
+                for (size_t k = term_offsets_[order[pos]]; k < term_offsets_[order[pos] + 1]; ++k) {
+                    gain += term_gains[terms_[k]];
+                }
+                return gain;
+            };
+            scratch.left_gains.clear();
+            scratch.right_gains.clear();
+            for (size_t pos = begin; pos < mid; ++pos) {
+                scratch.left_gains.emplace_back(row_gain(pos, scratch.to_right_gain), pos);
+            }
+            for (size_t pos = mid; pos < end; ++pos) {
+                scratch.right_gains.emplace_back(row_gain(pos, scratch.to_left_gain), pos);
+            }
+            auto by_gain = [](const auto& a, const auto& b) {
+                return a.first > b.first || (a.first == b.first && a.second < b.second);
+            };
+            std::sort(scratch.left_gains.begin(), scratch.left_gains.end(), by_gain);
+            std::sort(scratch.right_gains.begin(), scratch.right_gains.end(), by_gain);
+
+            size_t swaps = 0;
+            for (; swaps < n_left && swaps < n_right; ++swaps) {
+                if (scratch.left_gains[swaps].first + scratch.right_gains[swaps].first <= 0) {
+                    break;
+                }
+                std::swap(order[scratch.left_gains[swaps].second], order[scratch.right_gains[swaps].second]);
+            }
+
+            for (auto term : touched) {
+                scratch.left_deg[term] = 0;
+                scratch.right_deg[term] = 0;
+            }
+            if (swaps == 0) {
+                break;
+            }
+        }
+    }
+
+    size_t rows_;
+    uint32_t nr_terms_ = 0;
+    std::vector<size_t> term_offsets_;
+    std::vector<uint32_t> terms_;
+};
+
+}  // namespace knowhere::sparse
+
+#endif  // SPARSE_DOC_REORDER_H
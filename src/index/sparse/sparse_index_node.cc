@@ -11,10 +11,14 @@
 
 #include <sys/mman.h>
 
+#include <algorithm>
 #include <exception>
+#include <memory>
+#include <mutex>
 
 #include "index/sparse/sparse_inverted_index.h"
 #include "index/sparse/sparse_inverted_index_config.h"
+#include "index/sparse/sparse_seismic_index.h"
 #include "io/file_io.h"
 #include "io/memory_io.h"
 #include "knowhere/comp/index_param.h"
@@ -61,11 +65,15 @@ class SparseInvertedIndexNode : public IndexNode {
             LOG_KNOWHERE_ERROR_ << Type() << " only support metric_type IP or BM25";
             return Status::invalid_metric_type;
         }
-        auto index_or = CreateIndex</*mmapped=*/false>(cfg);
+        auto index_or = NewIndex(cfg, /*mmapped=*/false);
         if (!index_or.has_value()) {
             return index_or.error();
         }
         auto index = index_or.value();
+        index->SetPostingListEncoding(cfg.inverted_index_compression.value_or(false)
+                                          ? sparse::PostingListEncoding::BLOCK_BITPACKED
+                                          : sparse::PostingListEncoding::RAW);
+        index->SetDocReorder(cfg.inverted_index_doc_reorder.value_or(false));
         index->Train(static_cast<const sparse::SparseRow<value_type>*>(dataset->GetTensor()), dataset->GetRows());
         if (index_ != nullptr) {
             LOG_KNOWHERE_WARNING_ << Type() << " has already been created, deleting old";
@@ -81,12 +89,14 @@ class SparseInvertedIndexNode : public IndexNode {
             LOG_KNOWHERE_ERROR_ << "Could not add data to empty " << Type();
             return Status::empty_index;
         }
-        auto build_pool_wrapper = std::make_shared<ThreadPoolWrapper>(build_pool_, use_knowhere_build_pool);
+        // with the build pool, rows are added by tasks of the pool that index_->Add() waits for, so it is called
+        // from this thread rather than from a thread of the pool.
+        auto build_pool_wrapper = std::make_shared<ThreadPoolWrapper>(build_pool_, false);
         auto tryObj =
             build_pool_wrapper
                 ->push([&] {
                     return index_->Add(static_cast<const sparse::SparseRow<value_type>*>(dataset->GetTensor()),
-                                       dataset->GetRows(), dataset->GetDim());
+                                       dataset->GetRows(), dataset->GetDim(), use_knowhere_build_pool);
                 })
                 .getTry();
         if (!tryObj.hasValue()) {
@@ -99,14 +109,22 @@ class SparseInvertedIndexNode : public IndexNode {
     [[nodiscard]] expected<DataSetPtr>
     Search(const DataSetPtr dataset, std::unique_ptr<Config> config, const BitsetView& bitset,
            milvus::OpContext* op_context) const override {
-        if (!index_) {
+        return SearchIndex(index_, dataset, std::move(config), bitset, op_context);
+    }
+
+ protected:
+    // searches index, which is either index_ or a read view of it.
+    expected<DataSetPtr>
+    SearchIndex(const sparse::BaseInvertedIndex<value_type>* index, const DataSetPtr dataset,
+                std::unique_ptr<Config> config, const BitsetView& bitset, milvus::OpContext* op_context) const {
+        if (!index) {
             LOG_KNOWHERE_ERROR_ << "Could not search empty " << Type();
             return expected<DataSetPtr>::Err(Status::empty_index, "index not loaded");
         }
 
         auto cfg = static_cast<const SparseInvertedIndexConfig&>(*config);
 
-        auto computer_or = index_->GetDocValueComputer(cfg);
+        auto computer_or = index->GetDocValueComputer(cfg);
         if (!computer_or.has_value()) {
             return expected<DataSetPtr>::Err(computer_or.error(), computer_or.what());
         }
@@ -123,6 +141,7 @@ class SparseInvertedIndexNode : public IndexNode {
             .refine_factor = refine_factor,
             .drop_ratio_search = drop_ratio_search,
             .dim_max_score_ratio = dim_max_score_ratio,
+            .heap_factor = cfg.seismic_heap_factor.value(),
         };
 
         auto queries = static_cast<const sparse::SparseRow<value_type>*>(dataset->GetTensor());
@@ -131,12 +150,16 @@ class SparseInvertedIndexNode : public IndexNode {
         auto p_id = std::make_unique<sparse::label_t[]>(nq * k);
         auto p_dist = std::make_unique<float[]>(nq * k);
 
+        // queries are searched in batches, as long as there are enough batches to keep all search threads busy
+        const int64_t batch_size = std::clamp<int64_t>(nq / std::max<int64_t>(search_pool_->size(), 1), 1,
+                                                       sparse::inverted_index_max_query_batch);
         std::vector<folly::Future<folly::Unit>> futs;
-        futs.reserve(nq);
-        for (int64_t idx = 0; idx < nq; ++idx) {
+        futs.reserve((nq + batch_size - 1) / batch_size);
+        for (int64_t idx = 0; idx < nq; idx += batch_size) {
             futs.emplace_back(search_pool_->push([&, idx = idx, p_id = p_id.get(), p_dist = p_dist.get()]() {
                 knowhere::checkCancellation(op_context);
-                index_->Search(queries[idx], k, p_dist + idx * k, p_id + idx * k, bitset, computer, approx_params);
+                index->SearchBatch(queries + idx, std::min(batch_size, nq - idx), k, p_dist + idx * k,
+                                   p_id + idx * k, bitset, computer, approx_params);
             }));
         }
         WaitAllSuccess(futs);
@@ -189,7 +212,17 @@ class SparseInvertedIndexNode : public IndexNode {
     [[nodiscard]] expected<std::vector<IndexNode::IteratorPtr>>
     AnnIterator(const DataSetPtr dataset, std::unique_ptr<Config> config, const BitsetView& bitset,
                 bool use_knowhere_search_pool, milvus::OpContext* op_context) const override {
-        if (!index_) {
+        // index_ is owned by this node, which must outlive the iterators, so the iterators don't share its ownership.
+        auto index = std::shared_ptr<const sparse::BaseInvertedIndex<value_type>>(std::shared_ptr<void>(), index_);
+        return AnnIteratorIndex(std::move(index), dataset, std::move(config), bitset, use_knowhere_search_pool);
+    }
+
+ protected:
+    // creates iterators on index, which is either index_ or a read view of it. index is kept alive by the iterators.
+    expected<std::vector<IndexNode::IteratorPtr>>
+    AnnIteratorIndex(std::shared_ptr<const sparse::BaseInvertedIndex<value_type>> index, const DataSetPtr dataset,
+                     std::unique_ptr<Config> config, const BitsetView& bitset, bool use_knowhere_search_pool) const {
+        if (!index) {
             LOG_KNOWHERE_WARNING_ << "creating iterator on empty index";
             return expected<std::vector<std::shared_ptr<IndexNode::iterator>>>::Err(Status::empty_index,
                                                                                     "index not loaded");
@@ -198,7 +231,7 @@ class SparseInvertedIndexNode : public IndexNode {
         auto queries = static_cast<const sparse::SparseRow<value_type>*>(dataset->GetTensor());
 
         auto cfg = static_cast<const SparseInvertedIndexConfig&>(*config);
-        auto computer_or = index_->GetDocValueComputer(cfg);
+        auto computer_or = index->GetDocValueComputer(cfg);
         if (!computer_or.has_value()) {
             return expected<std::vector<std::shared_ptr<IndexNode::iterator>>>::Err(computer_or.error(),
                                                                                     computer_or.what());
@@ -217,7 +250,7 @@ class SparseInvertedIndexNode : public IndexNode {
                 auto compute_dist_func = [=]() -> std::vector<DistId> {
                     auto queries = static_cast<const sparse::SparseRow<value_type>*>(dataset->GetTensor());
                     std::vector<float> distances =
-                        index_->GetAllDistances(queries[i], drop_ratio_search, bitset, computer);
+                        index->GetAllDistances(queries[i], drop_ratio_search, bitset, computer);
                     std::vector<DistId> distances_ids;
                     // 30% is a ratio guesstimate of non-zero distances: probability of 2 random sparse splade
                     // vectors(100 non zero dims out of 30000 total dims) sharing at least 1 common non-zero
@@ -237,7 +270,7 @@ class SparseInvertedIndexNode : public IndexNode {
                 } else {
                     sparse::SparseRow<value_type> query_copy(queries[i]);
                     auto it = std::make_shared<PrecomputedDistanceIterator>(compute_dist_func, true, false);
-                    vec[i] = std::make_shared<RefineIterator>(index_, std::move(query_copy), it, computer,
+                    vec[i] = std::make_shared<RefineIterator>(index.get(), std::move(query_copy), it, computer,
                                                               use_knowhere_search_pool);
                 }
             }
@@ -248,6 +281,7 @@ class SparseInvertedIndexNode : public IndexNode {
         return vec;
     }
 
+ public:
     [[nodiscard]] expected<DataSetPtr>
     GetVectorByIds(const DataSetPtr dataset, milvus::OpContext* op_context) const override {
         return expected<DataSetPtr>::Err(Status::not_implemented, "GetVectorByIds not implemented");
@@ -275,16 +309,29 @@ class SparseInvertedIndexNode : public IndexNode {
             return Status::empty_index;
         }
         MemoryIOWriter writer;
-        if (version_use_raw_data()) {
-            RETURN_IF_ERROR(index_->SerializeV0(writer));
-        } else {
-            RETURN_IF_ERROR(index_->Serialize(writer));
-        }
+        RETURN_IF_ERROR(WriteIndex(writer));
         std::shared_ptr<uint8_t[]> data(writer.data());
         binset.Append(Type(), data, writer.tellg());
         return Status::success;
     }
 
+    Status
+    SerializeToFile(const std::string& filename, bool direct_io) const override {
+        if (!index_) {
+            LOG_KNOWHERE_ERROR_ << "Could not serialize empty " << Type();
+            return Status::empty_index;
+        }
+        try {
+            FileIOWriter writer(filename, direct_io);
+            RETURN_IF_ERROR(WriteIndex(writer));
+            writer.close();
+        } catch (const std::exception& e) {
+            LOG_KNOWHERE_ERROR_ << "Failed to write " << Type() << " to " << filename << ": " << e.what();
+            return Status::disk_file_error;
+        }
+        return Status::success;
+    }
+
     Status
     Deserialize(const BinarySet& binset, std::shared_ptr<Config> config) override {
         if (index_ != nullptr) {
@@ -298,7 +345,7 @@ class SparseInvertedIndexNode : public IndexNode {
             return Status::invalid_binary_set;
         }
         MemoryIOReader reader(binary->data.get(), binary->size);
-        auto index_or = CreateIndex</*mmapped=*/false>(cfg);
+        auto index_or = NewIndex(cfg, /*mmapped=*/false);
         if (!index_or.has_value()) {
             return index_or.error();
         }
@@ -319,7 +366,7 @@ class SparseInvertedIndexNode : public IndexNode {
         }
 
         auto cfg = static_cast<const knowhere::SparseInvertedIndexConfig&>(*config);
-        auto index_or = CreateIndex</*mmapped=*/true>(cfg);
+        auto index_or = NewIndex(cfg, /*mmapped=*/true);
         if (!index_or.has_value()) {
             return index_or.error();
         }
@@ -380,6 +427,18 @@ class SparseInvertedIndexNode : public IndexNode {
         return use_wand ? knowhere::IndexEnum::INDEX_SPARSE_WAND : knowhere::IndexEnum::INDEX_SPARSE_INVERTED_INDEX;
     }
 
+ protected:
+    // creates the empty index to train or to deserialize into, nodes backed by another index type override it.
+    virtual expected<sparse::BaseInvertedIndex<value_type>*>
+    NewIndex(const SparseInvertedIndexConfig& cfg, bool mmapped) const {
+        return mmapped ? CreateIndex</*mmapped=*/true>(cfg) : CreateIndex</*mmapped=*/false>(cfg);
+    }
+
+    [[nodiscard]] virtual bool
+    version_use_raw_data() const {
+        return index_version_ < 8;
+    }
+
  private:
     template <bool mmapped>
     expected<sparse::BaseInvertedIndex<value_type>*>
@@ -408,6 +467,18 @@ class SparseInvertedIndexNode : public IndexNode {
                         sparse::SparseMetricType::METRIC_BM25);
                 index->SetBM25Params(k1, b, avgdl);
                 return index;
+            } else if (cfg.inverted_index_algo.value() == "DAAT_BLOCK_MAX_WAND") {
+                auto index = new sparse::InvertedIndex<value_type, uint16_t,
+                                                       sparse::InvertedIndexAlgo::DAAT_BLOCK_MAX_WAND, mmapped>(
+                    sparse::SparseMetricType::METRIC_BM25);
+                index->SetBM25Params(k1, b, avgdl);
+                return index;
+            } else if (cfg.inverted_index_algo.value() == "DAAT_BLOCK_MAX_MAXSCORE") {
+                auto index = new sparse::InvertedIndex<value_type, uint16_t,
+                                                       sparse::InvertedIndexAlgo::DAAT_BLOCK_MAX_MAXSCORE, mmapped>(
+                    sparse::SparseMetricType::METRIC_BM25);
+                index->SetBM25Params(k1, b, avgdl);
+                return index;
             } else if (cfg.inverted_index_algo.value() == "TAAT_NAIVE") {
                 auto index =
                     new sparse::InvertedIndex<value_type, uint16_t, sparse::InvertedIndexAlgo::TAAT_NAIVE, mmapped>(
@@ -429,6 +500,16 @@ class SparseInvertedIndexNode : public IndexNode {
                     new sparse::InvertedIndex<value_type, float, sparse::InvertedIndexAlgo::DAAT_MAXSCORE, mmapped>(
                         sparse::SparseMetricType::METRIC_IP);
                 return index;
+            } else if (cfg.inverted_index_algo.value() == "DAAT_BLOCK_MAX_WAND") {
+                auto index = new sparse::InvertedIndex<value_type, float,
+                                                       sparse::InvertedIndexAlgo::DAAT_BLOCK_MAX_WAND, mmapped>(
+                    sparse::SparseMetricType::METRIC_IP);
+                return index;
+            } else if (cfg.inverted_index_algo.value() == "DAAT_BLOCK_MAX_MAXSCORE") {
+                auto index = new sparse::InvertedIndex<value_type, float,
+                                                       sparse::InvertedIndexAlgo::DAAT_BLOCK_MAX_MAXSCORE, mmapped>(
+                    sparse::SparseMetricType::METRIC_IP);
+                return index;
             } else if (cfg.inverted_index_algo.value() == "TAAT_NAIVE") {
                 auto index =
                     new sparse::InvertedIndex<value_type, float, sparse::InvertedIndexAlgo::TAAT_NAIVE, mmapped>(
@@ -449,9 +530,12 @@ class SparseInvertedIndexNode : public IndexNode {
         }
     }
 
-    [[nodiscard]] bool
-    version_use_raw_data() const {
-        return index_version_ < 8;
+    Status
+    WriteIndex(IOWriter& writer) const {
+        if (version_use_raw_data()) {
+            return index_->SerializeV0(writer);
+        }
+        return index_->Serialize(writer);
     }
 
     struct MmapGuard {
@@ -469,17 +553,23 @@ class SparseInvertedIndexNode : public IndexNode {
         }
     };
 
-    sparse::BaseInvertedIndex<value_type>* index_{};
     std::shared_ptr<ThreadPool> search_pool_;
     std::shared_ptr<ThreadPool> build_pool_;
     const int32_t index_version_;
     BinaryPtr binary_{nullptr};
     std::unique_ptr<MmapGuard> mmap_guard_{nullptr};
+
+ protected:
+    sparse::BaseInvertedIndex<value_type>* index_{};
 };  // class SparseInvertedIndexNode
 
 // Concurrent version of SparseInvertedIndexNode
 //
-// Thread safety: only the overridden methods are allowed to be called concurrently.
+// Rows are published to readers RCU-style: Add appends rows to the index beyond the row watermark of the published
+// snapshot, without reallocating anything the snapshot refers to, then atomically publishes a new snapshot with a
+// higher watermark. Searches run on the snapshot they started with and never wait for Add.
+//
+// Thread safety: only the overridden methods except Train are allowed to be called concurrently.
 template <typename T, bool use_wand>
 class SparseInvertedIndexNodeCC : public SparseInvertedIndexNode<T, use_wand> {
     static_assert(std::is_same_v<T, knowhere::sparse_u32_f32>, "SparseInvertedIndexNode only support sparse_u32_f32");
@@ -491,74 +581,79 @@ class SparseInvertedIndexNodeCC : public SparseInvertedIndexNode<T, use_wand> {
     }
 
     Status
-    Add(const DataSetPtr dataset, std::shared_ptr<Config> config, bool use_knowhere_build_pool) override {
-        std::unique_lock<std::mutex> lock(mutex_);
-        uint64_t task_id = next_task_id_++;
-        add_tasks_.push(task_id);
+    Train(const DataSetPtr dataset, std::shared_ptr<Config> config, bool use_knowhere_build_pool) override {
+        std::lock_guard<std::mutex> lock(add_mutex_);
+        // the read views of the published snapshot refer to the index that may be replaced here
+        {
+            std::lock_guard<std::mutex> snapshot_lock(snapshot_mutex_);
+            snapshot_ = nullptr;
+        }
+        auto res = SparseInvertedIndexNode<T, use_wand>::Train(dataset, config, use_knowhere_build_pool);
+        if (res != Status::success) {
+            return res;
+        }
+        raw_data_chunks_.clear();
+        n_raw_rows_ = 0;
+        PublishSnapshot();
+        return res;
+    }
 
-        // add task is allowed to run only after all search tasks that come before it have finished.
-        cv_.wait(lock, [this, task_id]() { return current_task_id_ == task_id && active_readers_ == 0; });
+    Status
+    Add(const DataSetPtr dataset, std::shared_ptr<Config> config, bool use_knowhere_build_pool) override {
+        // add tasks are serialized with each other, but not with search tasks.
+        std::lock_guard<std::mutex> lock(add_mutex_);
 
         auto res = SparseInvertedIndexNode<T, use_wand>::Add(dataset, config, use_knowhere_build_pool);
+        if (res != Status::success) {
+            return res;
+        }
 
         auto cfg = static_cast<const SparseInvertedIndexConfig&>(*config);
         if (IsMetricType(cfg.metric_type.value(), metric::IP)) {
             // insert dataset to raw data if metric type is IP
-            auto data = static_cast<const sparse::SparseRow<value_type>*>(dataset->GetTensor());
-            auto rows = dataset->GetRows();
-            raw_data_.insert(raw_data_.end(), data, data + rows);
+            AppendRawData(static_cast<const sparse::SparseRow<value_type>*>(dataset->GetTensor()), dataset->GetRows());
         }
 
-        add_tasks_.pop();
-        current_task_id_++;
-        lock.unlock();
-        cv_.notify_all();
+        PublishSnapshot();
         return res;
     }
 
     expected<DataSetPtr>
     Search(const DataSetPtr dataset, std::unique_ptr<Config> cfg, const BitsetView& bitset,
            milvus::OpContext* op_context) const override {
-        ReadPermission permission(*this);
-        return SparseInvertedIndexNode<T, use_wand>::Search(dataset, std::move(cfg), bitset, op_context);
+        auto snapshot = GetSnapshot();
+        return this->SearchIndex(snapshot ? snapshot->index.get() : nullptr, dataset, std::move(cfg), bitset,
+                                 op_context);
     }
 
+    // RangeSearch of IndexNode searches with AnnIterator, thus on a single snapshot as well.
     expected<std::vector<IndexNode::IteratorPtr>>
     AnnIterator(const DataSetPtr dataset, std::unique_ptr<Config> cfg, const BitsetView& bitset,
                 bool use_knowhere_search_pool, milvus::OpContext* op_context) const override {
-        ReadPermission permission(*this);
-        // Always uses PrecomputedDistanceIterator for SparseInvertedIndexNodeCC:
-        // If we want to use RefineIterator, it needs to get another ReadPermission when calling
-        // index_->GetRawDistance(). If an Add task is added in between, there will be a deadlock.
-        auto config = static_cast<const knowhere::SparseInvertedIndexConfig&>(*cfg);
-        config.drop_ratio_search = 0.0f;
-        return SparseInvertedIndexNode<T, use_wand>::AnnIterator(dataset, std::move(cfg), bitset,
-                                                                 use_knowhere_search_pool, op_context);
-    }
-
-    expected<DataSetPtr>
-    RangeSearch(const DataSetPtr dataset, std::unique_ptr<Config> cfg, const BitsetView& bitset,
-                milvus::OpContext* op_context) const override {
-        ReadPermission permission(*this);
-        return SparseInvertedIndexNode<T, use_wand>::RangeSearch(dataset, std::move(cfg), bitset, op_context);
+        auto snapshot = GetSnapshot();
+        // the iterators keep the snapshot alive, as their distances are computed lazily.
+        auto index = snapshot ? std::shared_ptr<const sparse::BaseInvertedIndex<value_type>>(snapshot,
+                                                                                             snapshot->index.get())
+                              : nullptr;
+        return this->AnnIteratorIndex(std::move(index), dataset, std::move(cfg), bitset, use_knowhere_search_pool);
     }
 
     int64_t
     Dim() const override {
-        ReadPermission permission(*this);
-        return SparseInvertedIndexNode<T, use_wand>::Dim();
+        auto snapshot = GetSnapshot();
+        return snapshot ? snapshot->index->n_cols() : 0;
     }
 
     int64_t
     Size() const override {
-        ReadPermission permission(*this);
-        return SparseInvertedIndexNode<T, use_wand>::Size();
+        auto snapshot = GetSnapshot();
+        return snapshot ? snapshot->index->size() : 0;
     }
 
     int64_t
     Count() const override {
-        ReadPermission permission(*this);
-        return SparseInvertedIndexNode<T, use_wand>::Count();
+        auto snapshot = GetSnapshot();
+        return snapshot ? snapshot->index->n_rows() : 0;
     }
 
     std::string
@@ -569,9 +664,9 @@ class SparseInvertedIndexNodeCC : public SparseInvertedIndexNode<T, use_wand> {
 
     expected<DataSetPtr>
     GetVectorByIds(const DataSetPtr dataset, milvus::OpContext* op_context) const override {
-        ReadPermission permission(*this);
+        auto snapshot = GetSnapshot();
 
-        if (raw_data_.empty()) {
+        if (snapshot == nullptr || snapshot->n_raw_rows == 0) {
             return expected<DataSetPtr>::Err(Status::invalid_args, "GetVectorByIds failed: raw data is empty");
         }
 
@@ -582,7 +677,10 @@ class SparseInvertedIndexNodeCC : public SparseInvertedIndexNode<T, use_wand> {
 
         try {
             for (int64_t i = 0; i < rows; ++i) {
-                data[i] = raw_data_[ids[i]];
+                if (ids[i] < 0 || static_cast<size_t>(ids[i]) >= snapshot->n_raw_rows) {
+                    throw std::out_of_range("id " + std::to_string(ids[i]) + " out of range");
+                }
+                data[i] = snapshot->raw_data_chunks[ids[i] / raw_data_chunk_size][ids[i] % raw_data_chunk_size];
                 dim = std::max(dim, data[i].dim());
             }
         } catch (std::exception& e) {
@@ -619,37 +717,99 @@ class SparseInvertedIndexNodeCC : public SparseInvertedIndexNode<T, use_wand> {
     }
 
  private:
-    struct ReadPermission {
-        ReadPermission(const SparseInvertedIndexNodeCC& node) : node_(node) {
-            std::unique_lock<std::mutex> lock(node_.mutex_);
-            uint64_t task_id = node_.next_task_id_++;
-            // read task may execute only after all add tasks that come before it have finished.
-            if (!node_.add_tasks_.empty() && task_id > node_.add_tasks_.front()) {
-                node_.cv_.wait(
-                    lock, [this, task_id]() { return node_.add_tasks_.empty() || task_id < node_.add_tasks_.front(); });
-            }
-            // read task is allowed to run, block all add tasks
-            node_.active_readers_++;
+    // raw data is stored in chunks that are never reallocated, so rows can be appended to the last chunk while
+    // readers access the rows below the watermark.
+    static constexpr size_t raw_data_chunk_size = 4096;
+
+    // the rows visible to readers: a read view of index_ that holds the rows below the watermark, and the raw data of
+    // the same rows.
+    struct Snapshot {
+        std::unique_ptr<const sparse::BaseInvertedIndex<value_type>> index;
+        std::vector<std::shared_ptr<const sparse::SparseRow<value_type>[]>> raw_data_chunks;
+        size_t n_raw_rows;
+    };
+
+    std::shared_ptr<const Snapshot>
+    GetSnapshot() const {
+        std::lock_guard<std::mutex> lock(snapshot_mutex_);
+        return snapshot_;
+    }
+
+    // must be called with add_mutex_ held.
+    void
+    PublishSnapshot() {
+        auto snapshot = std::make_shared<Snapshot>();
+        snapshot->index = this->index_->CreateReadView();
+        snapshot->raw_data_chunks.assign(raw_data_chunks_.begin(), raw_data_chunks_.end());
+        snapshot->n_raw_rows = n_raw_rows_;
+
+        std::shared_ptr<const Snapshot> old_snapshot = std::move(snapshot);
+        {
+            std::lock_guard<std::mutex> lock(snapshot_mutex_);
+            std::swap(snapshot_, old_snapshot);
         }
+        // the old snapshot is released out of the lock, as it may be the last reference to it.
+    }
 
-        ~ReadPermission() {
-            std::unique_lock<std::mutex> lock(node_.mutex_);
-            node_.active_readers_--;
-            node_.current_task_id_++;
-            node_.cv_.notify_all();
+    // must be called with add_mutex_ held.
+    void
+    AppendRawData(const sparse::SparseRow<value_type>* data, size_t rows) {
+        for (size_t i = 0; i < rows; ++i, ++n_raw_rows_) {
+            if (n_raw_rows_ % raw_data_chunk_size == 0) {
+                raw_data_chunks_.emplace_back(new sparse::SparseRow<value_type>[raw_data_chunk_size]);
+            }
+            raw_data_chunks_.back()[n_raw_rows_ % raw_data_chunk_size] = data[i];
         }
-        const SparseInvertedIndexNodeCC& node_;
-    };
+    }
 
-    mutable std::mutex mutex_;
-    mutable std::condition_variable cv_;
-    mutable int64_t active_readers_ = 0;
-    mutable std::queue<uint64_t> add_tasks_;
-    mutable uint64_t next_task_id_ = 0;
-    mutable uint64_t current_task_id_ = 0;
-    mutable std::vector<sparse::SparseRow<value_type>> raw_data_ = {};
+    std::mutex add_mutex_;
+    std::vector<std::shared_ptr<sparse::SparseRow<value_type>[]>> raw_data_chunks_;
+    size_t n_raw_rows_ = 0;
+
+    // only guards snapshot_ itself, and is never held while adding data or searching.
+    mutable std::mutex snapshot_mutex_;
+    std::shared_ptr<const Snapshot> snapshot_;
 };  // class SparseInvertedIndexNodeCC
 
+// SparseInvertedIndexNode backed by a SeismicIndex, an approximate index for IP that searches only the blocks of
+// posting lists whose summaries may score high enough.
+template <typename T>
+class SparseSeismicIndexNode : public SparseInvertedIndexNode<T, /*use_wand=*/false> {
+    using value_type = typename T::ValueType;
+
+ public:
+    explicit SparseSeismicIndexNode(const int32_t& version, const Object& object)
+        : SparseInvertedIndexNode<T, false>(version, object) {
+    }
+
+    [[nodiscard]] std::string
+    Type() const override {
+        return knowhere::IndexEnum::INDEX_SPARSE_SEISMIC;
+    }
+
+ protected:
+    expected<sparse::BaseInvertedIndex<value_type>*>
+    NewIndex(const SparseInvertedIndexConfig& cfg, bool mmapped) const override {
+        if (!IsMetricType(cfg.metric_type.value(), metric::IP)) {
+            return expected<sparse::BaseInvertedIndex<value_type>*>::Err(
+                Status::invalid_metric_type, Type() + " only support metric_type IP, got: " + cfg.metric_type.value());
+        }
+        // a deserialized SeismicIndex always refers to the serialized data, whether it is mmapped or not.
+        sparse::SeismicBuildParams params = {
+            .n_postings = static_cast<size_t>(cfg.seismic_n_postings.value()),
+            .centroid_fraction = cfg.seismic_centroid_fraction.value(),
+            .summary_energy = cfg.seismic_summary_energy.value(),
+        };
+        return new sparse::SeismicIndex<value_type>(params);
+    }
+
+    // SeismicIndex has no raw data format, it was added after the format was replaced.
+    [[nodiscard]] bool
+    version_use_raw_data() const override {
+        return false;
+    }
+};  // class SparseSeismicIndexNode
+
 #ifdef KNOWHERE_WITH_CARDINAL
 KNOWHERE_SIMPLE_REGISTER_SPARSE_FLOAT_GLOBAL(SPARSE_INVERTED_INDEX_DEPRECATED, SparseInvertedIndexNode,
                                              knowhere::feature::MMAP,
@@ -673,4 +833,5 @@ KNOWHERE_SIMPLE_REGISTER_SPARSE_FLOAT_GLOBAL(SPARSE_INVERTED_INDEX_CC, SparseInv
 KNOWHERE_SIMPLE_REGISTER_SPARSE_FLOAT_GLOBAL(SPARSE_WAND_CC, SparseInvertedIndexNodeCC, knowhere::feature::MMAP,
                                              /*use_wand=*/true)
 #endif
+KNOWHERE_SIMPLE_REGISTER_SPARSE_FLOAT_GLOBAL(SPARSE_SEISMIC, SparseSeismicIndexNode, knowhere::feature::MMAP)
 }  // namespace knowhere
@@ -16,23 +16,29 @@
 #include <sys/mman.h>
 #include <unistd.h>
 
+#include <atomic>
 #include <boost/core/span.hpp>
 #include <cmath>
+#include <deque>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
 #include <memory>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
+#include "index/sparse/sparse_doc_reorder.h"
 #include "index/sparse/sparse_inverted_index_config.h"
 #include "io/memory_io.h"
 #include "knowhere/bitsetview.h"
 #include "knowhere/comp/index_param.h"
+#include "knowhere/comp/task.h"
 #include "knowhere/expected.h"
 #include "knowhere/log.h"
 #include "knowhere/prometheus_client.h"
 #include "knowhere/sparse_utils.h"
+#include "knowhere/thread_pool.h"
 #include "knowhere/utils.h"
 #include "simd/instruction_set.h"
 #include "simd/sparse_simd.h"
@@ -43,6 +49,8 @@ enum class InvertedIndexAlgo {
     TAAT_NAIVE,
     DAAT_WAND,
     DAAT_MAXSCORE,
+    DAAT_BLOCK_MAX_WAND,
+    DAAT_BLOCK_MAX_MAXSCORE,
 };
 
 struct InvertedIndexBuildStats {
@@ -56,7 +64,9 @@ enum class InvertedIndexSectionType : uint32_t {
     DIM_MAP = 2,
     ROW_SUMS = 3,
     MAX_SCORES_PER_DIM = 4,
-    PROMETHEUS_BUILD_STATS = 5
+    PROMETHEUS_BUILD_STATS = 5,
+    BLOCK_MAX_SCORES = 6,
+    DOC_ID_MAP = 7
 };
 
 struct InvertedIndexSectionHeader {
@@ -65,10 +75,127 @@ struct InvertedIndexSectionHeader {
     uint64_t size;
 };
 
+// encoding of the posting lists section, stored as index_encoding_type
+enum class PostingListEncoding : uint32_t {
+    // doc ids and values are stored as is
+    RAW = 0,
+    // doc ids are delta encoded and bit packed in blocks of posting_list_block_size ids, see encode_posting_block().
+    // values are stored as is.
+    BLOCK_BITPACKED = 1,
+};
+
+// doc ids of a posting list encoded with PostingListEncoding::BLOCK_BITPACKED
+struct CompressedPostingIds {
+    // number of ids in the posting list
+    size_t size = 0;
+    // last id of each block, used to skip blocks without decoding them
+    boost::span<const uint32_t> block_last_ids;
+    // offset of each block in words, with an extra one for the end of the last block
+    boost::span<const uint64_t> block_word_offsets;
+    const uint32_t* words = nullptr;
+
+    // decodes the block-th block to out, which must be able to hold posting_list_block_size ids, and returns the
+    // number of valid ids.
+    inline size_t
+    decode(size_t block, table_t* out) const {
+        const auto word_offset = block_word_offsets[block];
+        const auto bit_width = static_cast<uint32_t>((block_word_offsets[block + 1] - word_offset) / 2);
+        const table_t base = block == 0 ? 0 : block_last_ids[block - 1] + 1;
+        decode_posting_block(words + word_offset, bit_width, base, out);
+        return std::min(posting_list_block_size, size - block * posting_list_block_size);
+    }
+};
+
+// array of per-dim metadata stored in chunks of dim_chunk_size elements. Copies of the array share the chunks and a
+// shared chunk is copied before it is modified, so that an InvertedIndex and its read views share the metadata of
+// all dims while Add() only copies the chunks of the dims it changes.
+template <typename T>
+class DimChunkedArray {
+ public:
+    static constexpr size_t dim_chunk_size = 1024;
+
+    const T&
+    operator[](size_t i) const {
+        return (*chunks_[i / dim_chunk_size])[i % dim_chunk_size];
+    }
+
+    [[nodiscard]] size_t
+    size() const {
+        return size_;
+    }
+
+    void
+    resize(size_t n) {
+        const size_t nr_chunks = (n + dim_chunk_size - 1) / dim_chunk_size;
+        // elements of the last chunk beyond the old size may have been left by a previous shrink
+        for (size_t i = size_; i < std::min(n, chunks_.size() * dim_chunk_size); ++i) {
+            set(i, T());
+        }
+        chunks_.resize(nr_chunks);
+        for (auto& chunk : chunks_) {
+            if (chunk == nullptr) {
+                chunk = std::make_shared<std::vector<T>>(dim_chunk_size);
+            }
+        }
+        size_ = n;
+    }
+
+    void
+    clear() {
+        chunks_.clear();
+        size_ = 0;
+    }
+
+    void
+    set(size_t i, T value) {
+        mutable_chunk(i / dim_chunk_size)[i % dim_chunk_size] = std::move(value);
+    }
+
+    // replaces the content of the array with data[0, n)
+    void
+    assign(const T* data, size_t n) {
+        clear();
+        resize(n);
+        for (size_t i = 0; i < n; i += dim_chunk_size) {
+            std::copy(data + i, data + std::min(n, i + dim_chunk_size), chunks_[i / dim_chunk_size]->begin());
+        }
+    }
+
+    // calls func(data, n) on the consecutive chunks of the array
+    template <typename Func>
+    void
+    for_each_chunk(Func&& func) const {
+        for (size_t i = 0; i < size_; i += dim_chunk_size) {
+            func(chunks_[i / dim_chunk_size]->data(), std::min(dim_chunk_size, size_ - i));
+        }
+    }
+
+ private:
+    std::vector<T>&
+    mutable_chunk(size_t c) {
+        auto& chunk = chunks_[c];
+        if (chunk.use_count() > 1) {
+            chunk = std::make_shared<std::vector<T>>(*chunk);
+        } else {
+            // the last read view sharing the chunk may just have released it on another thread
+            std::atomic_thread_fence(std::memory_order_acquire);
+        }
+        return *chunk;
+    }
+
+    std::vector<std::shared_ptr<std::vector<T>>> chunks_;
+    size_t size_ = 0;
+};
+
+// max number of queries that BaseInvertedIndex::SearchBatch() searches together
+constexpr size_t inverted_index_max_query_batch = 16;
+
 struct InvertedIndexApproxSearchParams {
     int refine_factor;
     float drop_ratio_search;
     float dim_max_score_ratio;
+    // used by SeismicIndex only, see seismic_heap_factor
+    float heap_factor;
 };
 
 template <typename T>
@@ -77,7 +204,7 @@ class BaseInvertedIndex {
     virtual ~BaseInvertedIndex() = default;
 
     virtual Status
-    SerializeV0(MemoryIOWriter& writer) const = 0;
+    SerializeV0(IOWriter& writer) const = 0;
 
     // supplement_target_filename: when in mmap mode, we need an extra file to store the mmapped index data structure.
     // this file will be created during loading and deleted in the destructor.
@@ -85,7 +212,7 @@ class BaseInvertedIndex {
     DeserializeV0(MemoryIOReader& reader, int map_flags, const std::string& supplement_target_filename) = 0;
 
     virtual Status
-    Serialize(MemoryIOWriter& writer) const = 0;
+    Serialize(IOWriter& writer) const = 0;
 
     virtual Status
     Deserialize(MemoryIOReader& reader) = 0;
@@ -93,13 +220,39 @@ class BaseInvertedIndex {
     virtual Status
     Train(const SparseRow<T>* data, size_t rows) = 0;
 
+    // with use_build_pool, the rows are added by tasks of the global build thread pool and the calling thread waits
+    // for them, so it must not be a thread of that pool.
     virtual Status
-    Add(const SparseRow<T>* data, size_t rows, int64_t dim) = 0;
+    Add(const SparseRow<T>* data, size_t rows, int64_t dim, bool use_build_pool) = 0;
+
+    // returns a read-only view of the rows added so far. A view never observes rows added afterwards and stays valid
+    // while more rows are added, so it can be searched concurrently with Add(). Views support searching only.
+    virtual std::unique_ptr<BaseInvertedIndex<T>>
+    CreateReadView() = 0;
+
+    // sets the encoding of posting lists used by Serialize(), the encoding of a deserialized index is the one it was
+    // serialized with.
+    virtual void
+    SetPostingListEncoding(PostingListEncoding encoding) = 0;
+
+    // when enabled, the rows of the first Add() to an empty index are reordered by recursive graph bisection before
+    // being added, the ids of search results and the ids given to the index are still the ones the rows were added
+    // with.
+    virtual void
+    SetDocReorder(bool enable) = 0;
 
     virtual void
     Search(const SparseRow<T>& query, size_t k, float* distances, label_t* labels, const BitsetView& bitset,
            const DocValueComputer<T>& computer, InvertedIndexApproxSearchParams& approx_params) const = 0;
 
+    // searches queries[0, nq) like Search(), the results of the i-th query are stored at distances + i * k and
+    // labels + i * k. TAAT_NAIVE shares each pass over the posting lists among the queries, other algorithms search
+    // the queries one by one.
+    virtual void
+    SearchBatch(const SparseRow<T>* queries, size_t nq, size_t k, float* distances, label_t* labels,
+                const BitsetView& bitset, const DocValueComputer<T>& computer,
+                InvertedIndexApproxSearchParams& approx_params) const = 0;
+
     virtual std::vector<float>
     GetAllDistances(const SparseRow<T>& query, float drop_ratio_search, const BitsetView& bitset,
                     const DocValueComputer<T>& computer) const = 0;
@@ -169,12 +322,28 @@ class InvertedIndex : public BaseInvertedIndex<DType> {
 
     template <typename U>
     using Vector = std::conditional_t<mmapped, GrowableVectorView<U>, std::vector<U>>;
+    using DimMap = std::unordered_map<table_t, uint32_t>;
+
+    // the max score of each dim is used for pruning by all DAAT algorithms
+    static constexpr bool use_dim_max_score =
+        algo == InvertedIndexAlgo::DAAT_WAND || algo == InvertedIndexAlgo::DAAT_MAXSCORE ||
+        algo == InvertedIndexAlgo::DAAT_BLOCK_MAX_WAND || algo == InvertedIndexAlgo::DAAT_BLOCK_MAX_MAXSCORE;
+    // block-max algorithms additionally keep the max score of every block_max_block_size postings
+    static constexpr bool use_block_max_score =
+        algo == InvertedIndexAlgo::DAAT_BLOCK_MAX_WAND || algo == InvertedIndexAlgo::DAAT_BLOCK_MAX_MAXSCORE;
+    // the blocks of block max scores are the same as the blocks of compressed posting lists
+    static constexpr size_t block_max_block_size = posting_list_block_size;
 
     void
     SetBM25Params(float k1, float b, float avgdl) {
         bm25_params_ = std::make_unique<BM25Params>(k1, b, avgdl);
     }
 
+    void
+    SetPostingListEncoding(PostingListEncoding encoding) override {
+        posting_list_encoding_ = encoding;
+    }
+
     expected<DocValueComputer<float>>
     GetDocValueComputer(const SparseInvertedIndexConfig& cfg) const override {
         // if metric_type is set in config, it must match with how the index was built.
@@ -199,13 +368,14 @@ class InvertedIndex : public BaseInvertedIndex<DType> {
         }
         auto avgdl = cfg.bm25_avgdl.value();
         avgdl = std::max(avgdl, 1.0f);
-        if constexpr (algo == InvertedIndexAlgo::DAAT_WAND || algo == InvertedIndexAlgo::DAAT_MAXSCORE) {
-            // daat_wand and daat_maxscore: search time k1/b must equal load time config.
+        if constexpr (use_dim_max_score) {
+            // daat algorithms: search time k1/b must equal load time config.
             if ((cfg.bm25_k1.has_value() && cfg.bm25_k1.value() != bm25_params_->k1) ||
                 ((cfg.bm25_b.has_value() && cfg.bm25_b.value() != bm25_params_->b))) {
                 return expected<DocValueComputer<float>>::Err(
                     Status::invalid_args,
-                    "search time k1/b must equal load time config for DAAT_WAND or DAAT_MAXSCORE algorithm.");
+                    "search time k1/b must equal load time config for DAAT_WAND, DAAT_MAXSCORE, DAAT_BLOCK_MAX_WAND "
+                    "or DAAT_BLOCK_MAX_MAXSCORE algorithm.");
             }
             return GetDocValueBM25Computer<float>(bm25_params_->k1, bm25_params_->b, avgdl);
         } else {
@@ -217,7 +387,7 @@ class InvertedIndex : public BaseInvertedIndex<DType> {
     }
 
     Status
-    SerializeV0(MemoryIOWriter& writer) const override {
+    SerializeV0(IOWriter& writer) const override {
         /**
          * Layout:
          *
@@ -231,10 +401,13 @@ class InvertedIndex : public BaseInvertedIndex<DType> {
          *        2. DType val (when QType is different from DType, the QType value of val is stored as a DType with
          *           precision loss)
          *
-         * inverted_index_ids_spans_, inverted_index_vals_spans_ and max_score_in_dim_spans_ are
+         * inverted_index_ids_spans_, inverted_index_vals_spans_ and published_max_score_in_dim_ are
          * not serialized, they will be constructed dynamically during
          * deserialization.
          *
+         * Reordered rows are written in the order they were added, the
+         * loaded index is thus not reordered.
+         *
          * Data are densely packed in serialized bytes and no padding is added.
          */
         DType deprecated_value_threshold = 0;
@@ -244,15 +417,19 @@ class InvertedIndex : public BaseInvertedIndex<DType> {
         BitsetView bitset(nullptr, 0);
 
         auto dim_map_reverse = std::unordered_map<uint32_t, table_t>();
-        for (const auto& [dim, dim_id] : dim_map_) {
+        for (const auto& [dim, dim_id] : *dim_map_) {
             dim_map_reverse[dim_id] = dim;
         }
 
+        auto row_id = [this](table_t id) { return doc_id_map_span_.empty() ? id : doc_id_map_span_[id]; };
+
         std::vector<size_t> row_sizes(n_rows_internal_, 0);
-        for (auto inverted_index_ids_span : inverted_index_ids_spans_) {
-            for (const auto& id : inverted_index_ids_span) {
-                row_sizes[id]++;
-            }
+        for (size_t i = 0; i < nr_inner_dims_; ++i) {
+            for_each_posting_chunk(i, [&](const table_t* ids, const QType*, size_t n) {
+                for (size_t j = 0; j < n; ++j) {
+                    row_sizes[row_id(ids[j])]++;
+                }
+            });
         }
 
         std::vector<SparseRow<DType>> raw_rows(n_rows_internal_);
@@ -260,14 +437,16 @@ class InvertedIndex : public BaseInvertedIndex<DType> {
             raw_rows[i] = std::move(SparseRow<DType>(row_sizes[i]));
         }
 
-        for (size_t i = 0; i < inverted_index_ids_spans_.size(); ++i) {
-            const auto& ids = inverted_index_ids_spans_[i];
-            const auto& vals = inverted_index_vals_spans_[i];
+        for (size_t i = 0; i < nr_inner_dims_; ++i) {
             const auto dim = dim_map_reverse[i];
-            for (size_t j = 0; j < ids.size(); ++j) {
-                raw_rows[ids[j]].set_at(raw_rows[ids[j]].size() - row_sizes[ids[j]], dim, vals[j]);
-                --row_sizes[ids[j]];
-            }
+            for_each_posting_chunk(i, [&](const table_t* ids, const QType* vals, size_t n) {
+                for (size_t j = 0; j < n; ++j) {
+                    auto& raw_row = raw_rows[row_id(ids[j])];
+                    auto& row_size = row_sizes[row_id(ids[j])];
+                    raw_row.set_at(raw_row.size() - row_size, dim, vals[j]);
+                    --row_size;
+                }
+            });
         }
 
         for (table_t vec_id = 0; vec_id < n_rows_internal_; ++vec_id) {
@@ -327,7 +506,7 @@ class InvertedIndex : public BaseInvertedIndex<DType> {
         LOG_KNOWHERE_INFO_ << "Sparse Inverted Index loading progress: 100%";
 
 #if defined(NOT_COMPILE_FOR_SWIG) && !defined(KNOWHERE_WITH_LIGHT)
-        for (size_t i = 0; i < dim_map_.size(); ++i) {
+        for (size_t i = 0; i < dim_map_->size(); ++i) {
             index_posting_list_len_histogram_->Observe(inverted_index_ids_[i].size());
         }
         index_size_gauge_->Set((double)size() / 1024.0 / 1024.0);
@@ -335,7 +514,7 @@ class InvertedIndex : public BaseInvertedIndex<DType> {
 
         n_rows_internal_ = rows;
 
-        nr_inner_dims_ = dim_map_.size();
+        nr_inner_dims_ = dim_map_->size();
 
 #if defined(NOT_COMPILE_FOR_SWIG) && !defined(KNOWHERE_WITH_LIGHT)
         build_stats_.posting_list_length_stats_.resize(nr_inner_dims_);
@@ -344,15 +523,9 @@ class InvertedIndex : public BaseInvertedIndex<DType> {
         }
 #endif
         // mapping data to spans
-        inverted_index_ids_spans_.reserve(nr_inner_dims_);
-        inverted_index_vals_spans_.reserve(nr_inner_dims_);
+        resize_published_dims();
         for (size_t i = 0; i < nr_inner_dims_; ++i) {
-            inverted_index_ids_spans_.emplace_back(inverted_index_ids_[i].data(), inverted_index_ids_[i].size());
-            inverted_index_vals_spans_.emplace_back(inverted_index_vals_[i].data(), inverted_index_vals_[i].size());
-        }
-
-        if (max_score_in_dim_.size() > 0) {
-            max_score_in_dim_spans_ = boost::span<const float>(max_score_in_dim_.data(), max_score_in_dim_.size());
+            publish_dim(i);
         }
 
         if (metric_type_ == SparseMetricType::METRIC_BM25) {
@@ -364,7 +537,7 @@ class InvertedIndex : public BaseInvertedIndex<DType> {
     }
 
     Status
-    Serialize(MemoryIOWriter& writer) const override {
+    Serialize(IOWriter& writer) const override {
         // Serialized format:
         // 1. Index File Header (v1) (32 bytes):
         //    - index_format_version (uint32_t): Version of the index format, currently 1
@@ -381,8 +554,13 @@ class InvertedIndex : public BaseInvertedIndex<DType> {
         //      - size (uint64_t): Size of the section in bytes
         //
         // 3. Posting Lists Section:
-        //    - index_encoding_type (uint32_t): Type of encoding used, only 0 is supported for now
+        //    - index_encoding_type (uint32_t): Type of encoding used, see PostingListEncoding
         //    - encoded_index_data: Flattened posting lists
+        //      - RAW: plist_offsets[nr_inner_dims + 1] (uint64_t), ids[nnz] (uint32_t), vals[nnz] (QType)
+        //      - BLOCK_BITPACKED: plist_offsets[nr_inner_dims + 1] (uint64_t),
+        //        block_word_offsets[nr_blocks + 1] (uint64_t), block_last_ids[nr_blocks] (uint32_t),
+        //        words[nr_words] (uint32_t), vals[nnz] (QType), where blocks of all posting lists are numbered
+        //        consecutively and the number of blocks of a posting list is ceil(posting_list_size / 64)
         //
         // 4. Dimension Map Section:
         //    - dim_map_reverse[nr_inner_dims]: Array mapping internal dimension IDs to original dimensions
@@ -392,6 +570,14 @@ class InvertedIndex : public BaseInvertedIndex<DType> {
         //
         // 6. Optional Max Scores Per Dimension Section:
         //    - max_score_per_dim[nr_inner_dims]: Array of maximum scores per dimension (float)
+        //
+        // 7. Optional Block Max Scores Section:
+        //    - block_size (uint32_t): Number of postings covered by each block max score
+        //    - block_max_scores: Flattened max scores of every block of each posting list (float), the number of
+        //      blocks of a posting list is ceil(posting_list_size / block_size)
+        //
+        // 8. Optional Doc Id Map Section, for reordered rows:
+        //    - doc_id_map[nr_rows]: Array mapping internal row ids to the ids the rows were added with (uint32_t)
 
         // write index header data
         const uint32_t index_format_version = 1;
@@ -411,15 +597,28 @@ class InvertedIndex : public BaseInvertedIndex<DType> {
         if (metric_type_ == SparseMetricType::METRIC_BM25) {
             nr_sections += 1;  // row sums
         }
-        if (max_score_in_dim_spans_.size() > 0) {
+        if (published_max_score_in_dim_.size() > 0) {
             nr_sections += 1;  // max scores per dim
         }
+        if (block_max_scores_spans_.size() > 0) {
+            nr_sections += 1;  // block max scores
+        }
+        if (doc_id_map_span_.size() > 0) {
+            nr_sections += 1;  // doc id map
+        }
 #if defined(NOT_COMPILE_FOR_SWIG) && !defined(KNOHWERE_WITH_LIGHT)
         // use a section to store some build stats for prometheus
         nr_sections += 1;
 #endif
         writer.write(&nr_sections, sizeof(uint32_t));
 
+        // compressed posting lists are encoded upfront, their size is not known otherwise
+        const bool compressed = posting_list_encoding_ == PostingListEncoding::BLOCK_BITPACKED;
+        EncodedPostingIds encoded_ids;
+        if (compressed) {
+            encoded_ids = encode_posting_ids();
+        }
+
         // since writer doesn't support seekp() for now, calculate all sizes of each sections first
         std::vector<InvertedIndexSectionHeader> section_headers(nr_sections);
         uint64_t used_offset = InvertedIndex::index_file_v1_header_size + sizeof(uint32_t) +
@@ -429,8 +628,15 @@ class InvertedIndex : public BaseInvertedIndex<DType> {
         uint64_t posting_lists_size = sizeof(uint32_t);                       // used to store encoding type
         posting_lists_size += sizeof(uint64_t) * (this->nr_inner_dims_ + 1);  // used to store dim offsets
         for (size_t i = 0; i < this->nr_inner_dims_; ++i) {
-            posting_lists_size += this->inverted_index_ids_spans_[i].size() * sizeof(uint32_t) +
-                                  this->inverted_index_vals_spans_[i].size() * sizeof(QType);
+            posting_lists_size += this->inverted_index_vals_spans_[i].size() * sizeof(QType);
+            if (!compressed) {
+                posting_lists_size += this->inverted_index_vals_spans_[i].size() * sizeof(uint32_t);
+            }
+        }
+        if (compressed) {
+            posting_lists_size += sizeof(uint64_t) * encoded_ids.block_word_offsets.size() +
+                                  sizeof(uint32_t) * encoded_ids.block_last_ids.size() +
+                                  sizeof(uint32_t) * encoded_ids.words.size();
         }
         section_headers[0].size = posting_lists_size;
         used_offset += section_headers[0].size;
@@ -449,7 +655,7 @@ class InvertedIndex : public BaseInvertedIndex<DType> {
             curr_section_idx++;
         }
 
-        if (max_score_in_dim_spans_.size() > 0) {
+        if (published_max_score_in_dim_.size() > 0) {
             section_headers[curr_section_idx].type = InvertedIndexSectionType::MAX_SCORES_PER_DIM;
             section_headers[curr_section_idx].offset = used_offset;
             section_headers[curr_section_idx].size = sizeof(float) * this->nr_inner_dims_;
@@ -457,6 +663,26 @@ class InvertedIndex : public BaseInvertedIndex<DType> {
             curr_section_idx++;
         }
 
+        if (block_max_scores_spans_.size() > 0) {
+            section_headers[curr_section_idx].type = InvertedIndexSectionType::BLOCK_MAX_SCORES;
+            section_headers[curr_section_idx].offset = used_offset;
+            uint64_t block_max_scores_size = sizeof(uint32_t);  // used to store block size
+            for (size_t i = 0; i < this->nr_inner_dims_; ++i) {
+                block_max_scores_size += sizeof(float) * num_blocks(this->inverted_index_vals_spans_[i].size());
+            }
+            section_headers[curr_section_idx].size = block_max_scores_size;
+            used_offset += section_headers[curr_section_idx].size;
+            curr_section_idx++;
+        }
+
+        if (doc_id_map_span_.size() > 0) {
+            section_headers[curr_section_idx].type = InvertedIndexSectionType::DOC_ID_MAP;
+            section_headers[curr_section_idx].offset = used_offset;
+            section_headers[curr_section_idx].size = sizeof(uint32_t) * this->n_rows_internal_;
+            used_offset += section_headers[curr_section_idx].size;
+            curr_section_idx++;
+        }
+
 #if defined(NOT_COMPILE_FOR_SWIG) && !defined(KNOHWERE_WITH_LIGHT)
         section_headers[curr_section_idx].type = InvertedIndexSectionType::PROMETHEUS_BUILD_STATS;
         section_headers[curr_section_idx].offset = used_offset;
@@ -472,17 +698,24 @@ class InvertedIndex : public BaseInvertedIndex<DType> {
         writer.write(section_headers.data(), sizeof(InvertedIndexSectionHeader), nr_sections);
 
         // write index encoding type and index
-        uint32_t index_encoding_type = 0;  // not used for now
+        uint32_t index_encoding_type = static_cast<uint32_t>(posting_list_encoding_);
         writer.write(&index_encoding_type, sizeof(uint32_t));
         std::vector<uint64_t> inverted_index_offsets(this->nr_inner_dims_ + 1);
         inverted_index_offsets[0] = 0;
         for (size_t i = 1; i <= this->nr_inner_dims_; ++i) {
-            inverted_index_offsets[i] = inverted_index_offsets[i - 1] + this->inverted_index_ids_spans_[i - 1].size();
+            inverted_index_offsets[i] = inverted_index_offsets[i - 1] + this->inverted_index_vals_spans_[i - 1].size();
         }
         writer.write(inverted_index_offsets.data(), sizeof(uint64_t), inverted_index_offsets.size());
-        for (size_t i = 0; i < this->nr_inner_dims_; ++i) {
-            writer.write(this->inverted_index_ids_spans_[i].data(), sizeof(uint32_t),
-                         this->inverted_index_ids_spans_[i].size());
+        if (compressed) {
+            writer.write(encoded_ids.block_word_offsets.data(), sizeof(uint64_t),
+                         encoded_ids.block_word_offsets.size());
+            writer.write(encoded_ids.block_last_ids.data(), sizeof(uint32_t), encoded_ids.block_last_ids.size());
+            writer.write(encoded_ids.words.data(), sizeof(uint32_t), encoded_ids.words.size());
+        } else {
+            for (size_t i = 0; i < this->nr_inner_dims_; ++i) {
+                for_each_posting_chunk(
+                    i, [&](const table_t* ids, const QType*, size_t n) { writer.write(ids, sizeof(uint32_t), n); });
+            }
         }
         for (size_t i = 0; i < this->nr_inner_dims_; ++i) {
             writer.write(this->inverted_index_vals_spans_[i].data(), sizeof(QType),
@@ -491,7 +724,7 @@ class InvertedIndex : public BaseInvertedIndex<DType> {
 
         // write dim map
         auto dim_map_reverse = std::vector<uint32_t>(this->nr_inner_dims_);
-        for (const auto& [dim, dim_id] : this->dim_map_) {
+        for (const auto& [dim, dim_id] : *this->dim_map_) {
             dim_map_reverse[dim_id] = dim;
         }
         writer.write(dim_map_reverse.data(), sizeof(uint32_t), this->nr_inner_dims_);
@@ -501,8 +734,28 @@ class InvertedIndex : public BaseInvertedIndex<DType> {
             writer.write(bm25_params_->row_sums_spans_.data(), sizeof(float), this->n_rows_internal_);
         }
 
-        if (max_score_in_dim_spans_.size() > 0) {
-            writer.write(max_score_in_dim_spans_.data(), sizeof(float), this->nr_inner_dims_);
+        if (published_max_score_in_dim_.size() > 0) {
+            published_max_score_in_dim_.for_each_chunk(
+                [&](const float* max_scores, size_t n) { writer.write(max_scores, sizeof(float), n); });
+        }
+
+        if (block_max_scores_spans_.size() > 0) {
+            const uint32_t block_size = block_max_block_size;
+            writer.write(&block_size, sizeof(uint32_t));
+            for (size_t i = 0; i < this->nr_inner_dims_; ++i) {
+                const auto& plist_block_max_scores = block_max_scores_spans_[i];
+                writer.write(plist_block_max_scores.data(), sizeof(float), plist_block_max_scores.size());
+                // the last block is not published until it is full, see publish_dim()
+                for (size_t block = plist_block_max_scores.size();
+                     block < num_blocks(this->inverted_index_vals_spans_[i].size()); ++block) {
+                    const float block_max_score = compute_block_max_score(i, block);
+                    writer.write(&block_max_score, sizeof(float), 1);
+                }
+            }
+        }
+
+        if (doc_id_map_span_.size() > 0) {
+            writer.write(doc_id_map_span_.data(), sizeof(uint32_t), this->n_rows_internal_);
         }
 
         // write prometheus build stats
@@ -547,27 +800,58 @@ class InvertedIndex : public BaseInvertedIndex<DType> {
                 switch (section_header.type) {
                     case InvertedIndexSectionType::POSTING_LISTS: {
                         reader.seekg(section_header.offset);
-                        // check index encoding type, 0 is the only supported type for now
                         uint32_t index_encoding_type = 0;
                         reader.read(&index_encoding_type, sizeof(uint32_t));
-                        if (index_encoding_type != 0) {
+                        if (index_encoding_type != static_cast<uint32_t>(PostingListEncoding::RAW) &&
+                            index_encoding_type != static_cast<uint32_t>(PostingListEncoding::BLOCK_BITPACKED)) {
                             return Status::invalid_serialized_index_type;
                         }
+                        posting_list_encoding_ = static_cast<PostingListEncoding>(index_encoding_type);
                         auto inverted_index_offsets_span = boost::span<const uint64_t>(
                             reinterpret_cast<uint64_t*>(reader.data() + reader.tellg()), this->nr_inner_dims_ + 1);
                         reader.advance(sizeof(uint64_t) * (this->nr_inner_dims_ + 1));
-                        inverted_index_ids_spans_.resize(this->nr_inner_dims_);
                         inverted_index_vals_spans_.resize(this->nr_inner_dims_);
-                        for (size_t i = 0; i < this->nr_inner_dims_; ++i) {
-                            inverted_index_ids_spans_[i] = boost::span<const uint32_t>(
-                                reinterpret_cast<uint32_t*>(reader.data() + reader.tellg()),
-                                inverted_index_offsets_span[i + 1] - inverted_index_offsets_span[i]);
-                            reader.advance(inverted_index_ids_spans_[i].size() * sizeof(uint32_t));
+                        if (posting_list_encoding_ == PostingListEncoding::BLOCK_BITPACKED) {
+                            size_t nr_blocks = 0;
+                            for (size_t i = 0; i < this->nr_inner_dims_; ++i) {
+                                nr_blocks += num_blocks(inverted_index_offsets_span[i + 1] -
+                                                        inverted_index_offsets_span[i]);
+                            }
+                            auto block_word_offsets_span = boost::span<const uint64_t>(
+                                reinterpret_cast<uint64_t*>(reader.data() + reader.tellg()), nr_blocks + 1);
+                            reader.advance(sizeof(uint64_t) * (nr_blocks + 1));
+                            auto block_last_ids_span = boost::span<const uint32_t>(
+                                reinterpret_cast<uint32_t*>(reader.data() + reader.tellg()), nr_blocks);
+                            reader.advance(sizeof(uint32_t) * nr_blocks);
+                            auto words = reinterpret_cast<const uint32_t*>(reader.data() + reader.tellg());
+                            reader.advance(sizeof(uint32_t) * block_word_offsets_span[nr_blocks]);
+                            compressed_ids_.resize(this->nr_inner_dims_);
+                            size_t block_offset = 0;
+                            for (size_t i = 0; i < this->nr_inner_dims_; ++i) {
+                                auto& plist_ids = compressed_ids_[i];
+                                plist_ids.size = inverted_index_offsets_span[i + 1] - inverted_index_offsets_span[i];
+                                auto plist_nr_blocks = num_blocks(plist_ids.size);
+                                plist_ids.block_last_ids = block_last_ids_span.subspan(block_offset, plist_nr_blocks);
+                                plist_ids.block_word_offsets =
+                                    block_word_offsets_span.subspan(block_offset, plist_nr_blocks + 1);
+                                plist_ids.words = words;
+                                block_offset += plist_nr_blocks;
+                            }
+                        } else {
+                            inverted_index_ids_spans_.resize(this->nr_inner_dims_);
+                            for (size_t i = 0; i < this->nr_inner_dims_; ++i) {
+                                inverted_index_ids_spans_.set(
+                                    i, boost::span<const uint32_t>(
+                                           reinterpret_cast<uint32_t*>(reader.data() + reader.tellg()),
+                                           inverted_index_offsets_span[i + 1] - inverted_index_offsets_span[i]));
+                                reader.advance(inverted_index_ids_spans_[i].size() * sizeof(uint32_t));
+                            }
                         }
                         for (size_t i = 0; i < this->nr_inner_dims_; ++i) {
-                            inverted_index_vals_spans_[i] = boost::span<const QType>(
-                                reinterpret_cast<QType*>(reader.data() + reader.tellg()),
-                                inverted_index_offsets_span[i + 1] - inverted_index_offsets_span[i]);
+                            inverted_index_vals_spans_.set(
+                                i, boost::span<const QType>(
+                                       reinterpret_cast<QType*>(reader.data() + reader.tellg()),
+                                       inverted_index_offsets_span[i + 1] - inverted_index_offsets_span[i]));
                             reader.advance(inverted_index_vals_spans_[i].size() * sizeof(QType));
                         }
                         break;
@@ -577,7 +861,7 @@ class InvertedIndex : public BaseInvertedIndex<DType> {
                         for (uint32_t i = 0; i < this->nr_inner_dims_; ++i) {
                             uint32_t dim = 0;
                             reader.read(&dim, sizeof(uint32_t));
-                            this->dim_map_[dim] = i;
+                            (*this->dim_map_)[dim] = i;
                         }
                         break;
                     }
@@ -590,11 +874,46 @@ class InvertedIndex : public BaseInvertedIndex<DType> {
                     }
                     case InvertedIndexSectionType::MAX_SCORES_PER_DIM: {
                         reader.seekg(section_header.offset);
-                        max_score_in_dim_spans_ = boost::span<const float>(
-                            reinterpret_cast<float*>(reader.data() + section_header.offset), this->nr_inner_dims_);
+                        published_max_score_in_dim_.assign(
+                            reinterpret_cast<const float*>(reader.data() + section_header.offset), this->nr_inner_dims_);
                         reader.advance(sizeof(float) * this->nr_inner_dims_);
                         break;
                     }
+                    case InvertedIndexSectionType::BLOCK_MAX_SCORES: {
+                        if constexpr (!use_block_max_score) {
+                            break;
+                        }
+                        reader.seekg(section_header.offset);
+                        uint32_t block_size = 0;
+                        reader.read(&block_size, sizeof(uint32_t));
+                        // the section is ignored if it was written with a different block size, the block max
+                        // scores will be rebuilt from the posting lists.
+                        if (block_size != block_max_block_size ||
+                            inverted_index_vals_spans_.size() != this->nr_inner_dims_) {
+                            break;
+                        }
+                        block_max_scores_spans_.resize(this->nr_inner_dims_);
+                        for (size_t i = 0; i < this->nr_inner_dims_; ++i) {
+                            block_max_scores_spans_.set(
+                                i, boost::span<const float>(reinterpret_cast<float*>(reader.data() + reader.tellg()),
+                                                            num_blocks(inverted_index_vals_spans_[i].size())));
+                            reader.advance(sizeof(float) * block_max_scores_spans_[i].size());
+                        }
+                        break;
+                    }
+                    case InvertedIndexSectionType::DOC_ID_MAP: {
+                        reader.seekg(section_header.offset);
+                        doc_id_map_span_ = boost::span<const table_t>(
+                            reinterpret_cast<table_t*>(reader.data() + section_header.offset), this->n_rows_internal_);
+                        reader.advance(sizeof(uint32_t) * this->n_rows_internal_);
+                        doc_id_map_reverse_.resize(this->n_rows_internal_);
+                        for (size_t i = 0; i < this->n_rows_internal_; ++i) {
+                            doc_id_map_reverse_[doc_id_map_span_[i]] = i;
+                        }
+                        doc_id_map_reverse_span_ =
+                            boost::span<const table_t>(doc_id_map_reverse_.data(), doc_id_map_reverse_.size());
+                        break;
+                    }
                     case InvertedIndexSectionType::PROMETHEUS_BUILD_STATS: {
 #if defined(NOT_COMPILE_FOR_SWIG) && !defined(KNOWHERE_WITH_LIGHT)
                         reader.seekg(section_header.offset);
@@ -628,6 +947,13 @@ class InvertedIndex : public BaseInvertedIndex<DType> {
             return status;
         }
 
+        if constexpr (use_block_max_score) {
+            // indexes serialized by other algorithms don't carry the max scores needed by block-max search
+            if (published_max_score_in_dim_.size() == 0 || block_max_scores_spans_.size() == 0) {
+                build_max_scores_from_posting_lists();
+            }
+        }
+
 #if defined(NOT_COMPILE_FOR_SWIG) && !defined(KNOWHERE_WITH_LIGHT)
         this->index_size_gauge_->Set((double)size() / 1024.0 / 1024.0);
 #endif
@@ -667,13 +993,23 @@ class InvertedIndex : public BaseInvertedIndex<DType> {
         auto plists_ids_byte_size = nnz * sizeof(typename decltype(inverted_index_ids_)::value_type::value_type);
         auto plists_vals_byte_size = nnz * sizeof(typename decltype(inverted_index_vals_)::value_type::value_type);
         auto max_score_in_dim_byte_size = idx_counts.size() * sizeof(typename decltype(max_score_in_dim_)::value_type);
+        auto block_max_scores_byte_size =
+            idx_counts.size() * sizeof(typename decltype(block_max_scores_)::value_type);
+        size_t block_max_scores_vals_byte_size = 0;
+        for (const auto& [idx, count] : idx_counts) {
+            block_max_scores_vals_byte_size +=
+                num_blocks(count) * sizeof(typename decltype(block_max_scores_)::value_type::value_type);
+        }
         size_t row_sums_byte_size = 0;
 
         map_byte_size_ =
             inverted_index_ids_byte_size + inverted_index_vals_byte_size + plists_ids_byte_size + plists_vals_byte_size;
-        if constexpr (algo == InvertedIndexAlgo::DAAT_WAND || algo == InvertedIndexAlgo::DAAT_MAXSCORE) {
+        if constexpr (use_dim_max_score) {
             map_byte_size_ += max_score_in_dim_byte_size;
         }
+        if constexpr (use_block_max_score) {
+            map_byte_size_ += block_max_scores_byte_size + block_max_scores_vals_byte_size;
+        }
         if (metric_type_ == SparseMetricType::METRIC_BM25) {
             row_sums_byte_size = rows * sizeof(typename decltype(bm25_params_->row_sums)::value_type);
             map_byte_size_ += row_sums_byte_size;
@@ -725,11 +1061,16 @@ class InvertedIndex : public BaseInvertedIndex<DType> {
         inverted_index_vals_.initialize(ptr, inverted_index_vals_byte_size);
         ptr += inverted_index_vals_byte_size;
 
-        if constexpr (algo == InvertedIndexAlgo::DAAT_WAND || algo == InvertedIndexAlgo::DAAT_MAXSCORE) {
+        if constexpr (use_dim_max_score) {
             max_score_in_dim_.initialize(ptr, max_score_in_dim_byte_size);
             ptr += max_score_in_dim_byte_size;
         }
 
+        if constexpr (use_block_max_score) {
+            block_max_scores_.initialize(ptr, block_max_scores_byte_size);
+            ptr += block_max_scores_byte_size;
+        }
+
         if (metric_type_ == SparseMetricType::METRIC_BM25) {
             bm25_params_->row_sums.initialize(ptr, row_sums_byte_size);
             ptr += row_sums_byte_size;
@@ -747,10 +1088,19 @@ class InvertedIndex : public BaseInvertedIndex<DType> {
             plist_vals.initialize(ptr, plist_vals_byte_size);
             ptr += plist_vals_byte_size;
         }
+        if constexpr (use_block_max_score) {
+            for (const auto& [idx, count] : idx_counts) {
+                auto& plist_block_max_scores = block_max_scores_.emplace_back();
+                auto plist_block_max_scores_byte_size =
+                    num_blocks(count) * sizeof(typename decltype(block_max_scores_)::value_type::value_type);
+                plist_block_max_scores.initialize(ptr, plist_block_max_scores_byte_size);
+                ptr += plist_block_max_scores_byte_size;
+            }
+        }
         size_t dim_id = 0;
         for (const auto& [idx, count] : idx_counts) {
-            dim_map_[idx] = dim_id;
-            if constexpr (algo == InvertedIndexAlgo::DAAT_WAND || algo == InvertedIndexAlgo::DAAT_MAXSCORE) {
+            (*dim_map_)[idx] = dim_id;
+            if constexpr (use_dim_max_score) {
                 max_score_in_dim_.emplace_back(0.0f);
             }
             ++dim_id;
@@ -773,45 +1123,77 @@ class InvertedIndex : public BaseInvertedIndex<DType> {
     }
 
     Status
-    Add(const SparseRow<DType>* data, size_t rows, int64_t dim) override {
+    Add(const SparseRow<DType>* data, size_t rows, int64_t dim, bool use_build_pool) override {
         if constexpr (mmapped) {
             throw std::invalid_argument("mmapped InvertedIndex does not support Add");
         } else {
+            if (!compressed_ids_.empty()) {
+                throw std::invalid_argument("InvertedIndex with compressed posting lists does not support Add");
+            }
+            if (is_read_view_) {
+                throw std::invalid_argument("read view of InvertedIndex does not support Add");
+            }
             auto current_rows = n_rows_internal_;
             if ((size_t)dim > max_dim_) {
                 max_dim_ = dim;
             }
+            auto pool = use_build_pool ? ThreadPool::GetGlobalBuildThreadPool() : nullptr;
 
-            if (metric_type_ == SparseMetricType::METRIC_BM25) {
+            // the internal id current_rows + i is given to data[order[i]], or to data[i] if order is empty
+            std::vector<table_t> order;
+            if (doc_reorder_ && current_rows == 0 && rows > 1) {
+                order = GraphBisectionReorderer<DType>(data, rows).Reorder(pool.get());
+            }
+            if (!order.empty() || !doc_id_map_.empty()) {
+                if (!retired_buffers_.empty()) {
+                    reserve_for_append(doc_id_map_, rows, retired_buffers_.back()->ids);
+                }
+                for (size_t i = 0; i < rows; ++i) {
+                    doc_id_map_.push_back(current_rows + (order.empty() ? i : order[i]));
+                }
+                // rows added after the reordered ones keep their ids, so the reverse map only grows as well
+                if (!retired_buffers_.empty()) {
+                    reserve_for_append(doc_id_map_reverse_, rows, retired_buffers_.back()->ids);
+                }
+                doc_id_map_reverse_.resize(current_rows + rows);
+                for (size_t i = current_rows; i < current_rows + rows; ++i) {
+                    doc_id_map_reverse_[doc_id_map_[i]] = i;
+                }
+            }
+
+            if (!retired_buffers_.empty()) {
+                // read views may be searching the buffers being appended to, make sure that none of them is
+                // reallocated in place.
+                reserve_posting_lists_for_append(data, rows);
+                if (metric_type_ == SparseMetricType::METRIC_BM25) {
+                    reserve_for_append(bm25_params_->row_sums, rows, retired_buffers_.back()->row_sums);
+                }
+            } else if (metric_type_ == SparseMetricType::METRIC_BM25) {
                 bm25_params_->row_sums.reserve(current_rows + rows);
             }
-            for (size_t i = 0; i < rows; ++i) {
-                add_row_to_index(data[i], current_rows + i);
+            if (pool != nullptr && pool->size() > 1 && rows >= parallel_add_min_rows) {
+                add_rows_parallel(data, order, rows, *pool);
+            } else {
+                for (size_t i = 0; i < rows; ++i) {
+                    add_row_to_index(order.empty() ? data[i] : data[order[i]], current_rows + i);
+                }
             }
             n_rows_internal_ += rows;
 
-            nr_inner_dims_ = dim_map_.size();
+            nr_inner_dims_ = dim_map_->size();
 
+            // only the dims that got new postings are published again, the others stay shared with read views
+            const auto added_dim_ids = dim_ids_of(data, rows);
 #if defined(NOT_COMPILE_FOR_SWIG) && !defined(KNOWHERE_WITH_LIGHT)
             build_stats_.posting_list_length_stats_.resize(nr_inner_dims_);
-            for (size_t i = 0; i < nr_inner_dims_; ++i) {
+            for (auto i : added_dim_ids) {
                 build_stats_.posting_list_length_stats_[i] = inverted_index_ids_[i].size();
             }
 #endif
 
-            inverted_index_ids_spans_.clear();
-            inverted_index_vals_spans_.clear();
-            inverted_index_ids_spans_.reserve(nr_inner_dims_);
-            inverted_index_vals_spans_.reserve(nr_inner_dims_);
-
-            // mapping data to spans
-            for (size_t i = 0; i < nr_inner_dims_; ++i) {
-                inverted_index_ids_spans_.emplace_back(inverted_index_ids_[i].data(), inverted_index_ids_[i].size());
-                inverted_index_vals_spans_.emplace_back(inverted_index_vals_[i].data(), inverted_index_vals_[i].size());
-            }
-
-            if (max_score_in_dim_.size() > 0) {
-                max_score_in_dim_spans_ = boost::span<const float>(max_score_in_dim_.data(), max_score_in_dim_.size());
+            resize_published_dims();
+            for (auto i : added_dim_ids) {
+                publish_dim(i);
             }
 
             if (metric_type_ == SparseMetricType::METRIC_BM25) {
@@ -819,10 +1201,39 @@ class InvertedIndex : public BaseInvertedIndex<DType> {
                     boost::span<const float>(bm25_params_->row_sums.data(), bm25_params_->row_sums.size());
             }
 
+            if (!doc_id_map_.empty()) {
+                doc_id_map_span_ = boost::span<const table_t>(doc_id_map_.data(), doc_id_map_.size());
+                doc_id_map_reverse_span_ =
+                    boost::span<const table_t>(doc_id_map_reverse_.data(), doc_id_map_reverse_.size());
+            }
+
             return Status::success;
         }
     }
 
+    void
+    SetDocReorder(bool enable) override {
+        doc_reorder_ = enable;
+    }
+
+    std::unique_ptr<BaseInvertedIndex<DType>>
+    CreateReadView() override {
+        if constexpr (mmapped) {
+            throw std::invalid_argument("mmapped InvertedIndex does not support CreateReadView");
+        } else {
+            if (is_read_view_) {
+                throw std::invalid_argument("read view of InvertedIndex does not support CreateReadView");
+            }
+            // the buffers retired after a view was created may be referred to by it and by all older views, release
+            // them once these views are gone.
+            while (!retired_buffers_.empty() && retired_buffers_.front().use_count() == 1) {
+                retired_buffers_.pop_front();
+            }
+            retired_buffers_.push_back(std::make_shared<RetiredBuffers>());
+            return std::unique_ptr<BaseInvertedIndex<DType>>(new InvertedIndex(*this, retired_buffers_.back()));
+        }
+    }
+
     void
     Search(const SparseRow<DType>& query, size_t k, float* distances, label_t* labels, const BitsetView& bitset,
            const DocValueComputer<float>& computer, InvertedIndexApproxSearchParams& approx_params) const override {
@@ -839,19 +1250,50 @@ class InvertedIndex : public BaseInvertedIndex<DType> {
         }
 
         MaxMinHeap<float> heap(k * approx_params.refine_factor);
-        // DAAT_WAND and DAAT_MAXSCORE are based on the implementation in PISA.
-        if constexpr (algo == InvertedIndexAlgo::DAAT_WAND) {
-            search_daat_wand(q_vec, heap, bitset, computer, approx_params.dim_max_score_ratio);
-        } else if constexpr (algo == InvertedIndexAlgo::DAAT_MAXSCORE) {
-            search_daat_maxscore(q_vec, heap, bitset, computer, approx_params.dim_max_score_ratio);
+        if (doc_id_map_span_.empty()) {
+            search_with_filter(q_vec, heap, bitset, computer, approx_params.dim_max_score_ratio);
         } else {
-            search_taat_naive(q_vec, heap, bitset, computer);
+            DocIdFilterByMap filter{bitset, doc_id_map_span_};
+            search_with_filter(q_vec, heap, filter, computer, approx_params.dim_max_score_ratio);
         }
+        finish_search(query, heap, k, distances, labels, computer, approx_params);
+    }
 
-        if (approx_params.refine_factor == 1) {
-            collect_result(heap, distances, labels);
+    void
+    SearchBatch(const SparseRow<DType>* queries, size_t nq, size_t k, float* distances, label_t* labels,
+                const BitsetView& bitset, const DocValueComputer<float>& computer,
+                InvertedIndexApproxSearchParams& approx_params) const override {
+        if constexpr (algo != InvertedIndexAlgo::TAAT_NAIVE) {
+            for (size_t i = 0; i < nq; ++i) {
+                Search(queries[i], k, distances + i * k, labels + i * k, bitset, computer, approx_params);
+            }
         } else {
-            refine_and_collect(query, heap, k, distances, labels, computer, approx_params);
+            std::fill(distances, distances + nq * k, std::numeric_limits<float>::quiet_NaN());
+            std::fill(labels, labels + nq * k, -1);
+            for (size_t begin = 0; begin < nq; begin += inverted_index_max_query_batch) {
+                const size_t batch_nq = std::min(inverted_index_max_query_batch, nq - begin);
+                std::vector<std::vector<std::pair<size_t, DType>>> q_vecs(batch_nq);
+                std::vector<MaxMinHeap<float>> heaps;
+                heaps.reserve(batch_nq);
+                for (size_t i = 0; i < batch_nq; ++i) {
+                    if (queries[begin + i].size() > 0) {
+                        q_vecs[i] = parse_query(queries[begin + i], approx_params.drop_ratio_search);
+                    }
+                    heaps.emplace_back(k * approx_params.refine_factor);
+                }
+                if (doc_id_map_span_.empty()) {
+                    search_taat_blocked(q_vecs.data(), heaps.data(), batch_nq, bitset, computer);
+                } else {
+                    DocIdFilterByMap filter{bitset, doc_id_map_span_};
+                    search_taat_blocked(q_vecs.data(), heaps.data(), batch_nq, filter, computer);
+                }
+                for (size_t i = 0; i < batch_nq; ++i) {
+                    if (!q_vecs[i].empty()) {
+                        finish_search(queries[begin + i], heaps[i], k, distances + (begin + i) * k,
+                                      labels + (begin + i) * k, computer, approx_params);
+                    }
+                }
+            }
         }
     }
 
@@ -869,6 +1311,13 @@ class InvertedIndex : public BaseInvertedIndex<DType> {
         auto q_vec = parse_query(query, drop_ratio_search);
 
         auto distances = compute_all_distances(q_vec, computer);
+        if (!doc_id_map_span_.empty()) {
+            std::vector<float> reordered_distances(distances.size());
+            for (size_t i = 0; i < distances.size(); ++i) {
+                reordered_distances[doc_id_map_span_[i]] = distances[i];
+            }
+            distances.swap(reordered_distances);
+        }
         if (!bitset.empty()) {
             for (size_t i = 0; i < distances.size(); ++i) {
                 if (bitset.test(i)) {
@@ -883,21 +1332,20 @@ class InvertedIndex : public BaseInvertedIndex<DType> {
     GetRawDistance(const label_t vec_id, const SparseRow<DType>& query,
                    const DocValueComputer<float>& computer) const override {
         float distance = 0.0f;
+        const table_t doc_id = doc_id_map_reverse_span_.empty() ? vec_id : doc_id_map_reverse_span_[vec_id];
 
         for (size_t i = 0; i < query.size(); ++i) {
             auto [dim, val] = query[i];
-            auto dim_it = dim_map_.find(dim);
-            if (dim_it == dim_map_.cend()) {
+            auto dim_it = dim_map_->find(dim);
+            if (dim_it == dim_map_->cend()) {
                 continue;
             }
-            auto& plist_ids = inverted_index_ids_spans_[dim_it->second];
-            auto it = std::lower_bound(plist_ids.begin(), plist_ids.end(), vec_id,
-                                       [](const auto& x, table_t y) { return x < y; });
-            if (it != plist_ids.end() && *it == vec_id) {
+            auto loc = find_in_posting_list(dim_it->second, doc_id);
+            if (loc < inverted_index_vals_spans_[dim_it->second].size()) {
                 distance +=
                     val *
-                    computer(inverted_index_vals_spans_[dim_it->second][it - plist_ids.begin()],
-                             metric_type_ == SparseMetricType::METRIC_BM25 ? bm25_params_->row_sums_spans_[vec_id] : 0);
+                    computer(inverted_index_vals_spans_[dim_it->second][loc],
+                             metric_type_ == SparseMetricType::METRIC_BM25 ? bm25_params_->row_sums_spans_[doc_id] : 0);
             }
         }
 
@@ -907,25 +1355,33 @@ class InvertedIndex : public BaseInvertedIndex<DType> {
     [[nodiscard]] size_t
     size() const override {
         size_t res = sizeof(*this);
-        res += dim_map_.size() *
-               (sizeof(typename decltype(dim_map_)::key_type) + sizeof(typename decltype(dim_map_)::mapped_type));
+        res += dim_map_->size() * (sizeof(typename DimMap::key_type) + sizeof(typename DimMap::mapped_type));
 
         if constexpr (mmapped) {
             return res + map_byte_size_;
         } else {
-            res += sizeof(typename decltype(inverted_index_ids_spans_)::value_type) * inverted_index_ids_spans_.size();
-            for (auto inverted_index_ids_span : inverted_index_ids_spans_) {
-                res += sizeof(typename decltype(inverted_index_ids_spans_)::value_type::value_type) *
-                       inverted_index_ids_span.size();
+            res += sizeof(boost::span<const table_t>) * inverted_index_ids_spans_.size();
+            for (size_t i = 0; i < inverted_index_ids_spans_.size(); ++i) {
+                res += sizeof(table_t) * inverted_index_ids_spans_[i].size();
             }
-            res +=
-                sizeof(typename decltype(inverted_index_vals_spans_)::value_type) * inverted_index_vals_spans_.size();
-            for (auto inverted_index_vals_span : inverted_index_vals_spans_) {
-                res += sizeof(typename decltype(inverted_index_vals_spans_)::value_type::value_type) *
-                       inverted_index_vals_span.size();
+            res += sizeof(boost::span<const QType>) * inverted_index_vals_spans_.size();
+            for (size_t i = 0; i < inverted_index_vals_spans_.size(); ++i) {
+                res += sizeof(QType) * inverted_index_vals_spans_[i].size();
             }
-            if constexpr (algo == InvertedIndexAlgo::DAAT_WAND || algo == InvertedIndexAlgo::DAAT_MAXSCORE) {
-                res += sizeof(typename decltype(max_score_in_dim_spans_)::value_type) * max_score_in_dim_spans_.size();
+            if constexpr (use_dim_max_score) {
+                res += sizeof(float) * published_max_score_in_dim_.size();
+            }
+            if constexpr (use_block_max_score) {
+                for (size_t i = 0; i < block_max_scores_spans_.size(); ++i) {
+                    res += sizeof(float) * block_max_scores_spans_[i].size();
+                }
+            }
+            res += sizeof(table_t) * (doc_id_map_span_.size() + doc_id_map_reverse_span_.size());
+            res += sizeof(typename decltype(compressed_ids_)::value_type) * compressed_ids_.size();
+            for (const auto& plist_ids : compressed_ids_) {
+                res += sizeof(uint32_t) * plist_ids.block_last_ids.size() +
+                       sizeof(uint64_t) * plist_ids.block_word_offsets.size() +
+                       sizeof(uint32_t) * (plist_ids.block_word_offsets.back() - plist_ids.block_word_offsets.front());
             }
             return res;
         }
@@ -942,6 +1398,144 @@ class InvertedIndex : public BaseInvertedIndex<DType> {
     }
 
  private:
+    // buffers that have been replaced by larger ones while a read view may still refer to them.
+    struct RetiredBuffers {
+        std::vector<std::vector<table_t>> ids;
+        std::vector<std::vector<QType>> vals;
+        std::vector<std::vector<float>> row_sums;
+        std::vector<std::vector<float>> block_max_scores;
+    };
+
+    // creates a read view of origin, see CreateReadView(). Posting lists, row sums and doc id maps are shared with
+    // origin, which only appends to them beyond the sizes captured here. The dim map and the published spans and max
+    // scores are shared as well, origin copies them before changing them, see mutable_dim_map() and publish_dim().
+    InvertedIndex(const InvertedIndex& origin, std::shared_ptr<const RetiredBuffers> retired_buffers)
+        : metric_type_(origin.metric_type_), is_read_view_(true), view_retired_buffers_(std::move(retired_buffers)) {
+        dim_map_ = origin.dim_map_;
+        nr_inner_dims_ = origin.nr_inner_dims_;
+        n_rows_internal_ = origin.n_rows_internal_;
+        max_dim_ = origin.max_dim_;
+        posting_list_encoding_ = origin.posting_list_encoding_;
+        inverted_index_ids_spans_ = origin.inverted_index_ids_spans_;
+        inverted_index_vals_spans_ = origin.inverted_index_vals_spans_;
+        published_max_score_in_dim_ = origin.published_max_score_in_dim_;
+        block_max_scores_spans_ = origin.block_max_scores_spans_;
+        compressed_ids_ = origin.compressed_ids_;
+        doc_id_map_span_ = origin.doc_id_map_span_;
+        doc_id_map_reverse_span_ = origin.doc_id_map_reverse_span_;
+
+        if (origin.bm25_params_ != nullptr) {
+            bm25_params_ = std::make_unique<BM25Params>(*origin.bm25_params_, origin.bm25_params_->row_sums_spans_);
+        }
+    }
+
+    // makes sure that n elements can be appended to buffer without reallocating it in place. If it has to grow, the
+    // elements are copied to a new buffer and the old one is retired, as read views may still refer to it.
+    template <typename U>
+    static void
+    reserve_for_append(std::vector<U>& buffer, size_t n, std::vector<std::vector<U>>& retired) {
+        if (buffer.size() + n <= buffer.capacity()) {
+            return;
+        }
+        std::vector<U> grown;
+        grown.reserve(std::max(buffer.size() + n, 2 * buffer.capacity()));
+        grown.insert(grown.end(), buffer.begin(), buffer.end());
+        buffer.swap(grown);
+        retired.emplace_back(std::move(grown));
+    }
+
+    // reserves the posting lists and block max scores of existing dims for appending data[0, rows), those of new dims
+    // are not referred to by any read view yet.
+    void
+    reserve_posting_lists_for_append(const SparseRow<DType>* data, size_t rows) {
+        std::unordered_map<uint32_t, size_t> append_counts;
+        for (size_t i = 0; i < rows; ++i) {
+            for (size_t j = 0; j < data[i].size(); ++j) {
+                auto [dim, val] = data[i][j];
+                if (val == 0) {
+                    continue;
+                }
+                auto dim_it = dim_map_->find(dim);
+                if (dim_it != dim_map_->cend()) {
+                    append_counts[dim_it->second]++;
+                }
+            }
+        }
+        auto& retired = *retired_buffers_.back();
+        for (const auto& [dim_id, count] : append_counts) {
+            auto& plist_ids = inverted_index_ids_[dim_id];
+            if constexpr (use_block_max_score) {
+                auto& plist_block_max_scores = block_max_scores_[dim_id];
+                auto nr_new_blocks = num_blocks(plist_ids.size() + count) - plist_block_max_scores.size();
+                reserve_for_append(plist_block_max_scores, nr_new_blocks, retired.block_max_scores);
+            }
+            reserve_for_append(plist_ids, count, retired.ids);
+            reserve_for_append(inverted_index_vals_[dim_id], count, retired.vals);
+        }
+    }
+
+    // internal ids of the dims in which data[0, rows) have non-zero values, in ascending order
+    std::vector<uint32_t>
+    dim_ids_of(const SparseRow<DType>* data, size_t rows) const {
+        std::vector<uint32_t> dim_ids;
+        for (size_t i = 0; i < rows; ++i) {
+            for (size_t j = 0; j < data[i].size(); ++j) {
+                auto [dim, val] = data[i][j];
+                if (val != 0) {
+                    dim_ids.push_back(dim_map_->find(dim)->second);
+                }
+            }
+        }
+        std::sort(dim_ids.begin(), dim_ids.end());
+        dim_ids.erase(std::unique(dim_ids.begin(), dim_ids.end()), dim_ids.end());
+        return dim_ids;
+    }
+
+    // dim_map_ may be shared with read views, in which case it is copied before new dims are added to it.
+    DimMap&
+    mutable_dim_map() {
+        if (dim_map_.use_count() > 1) {
+            dim_map_ = std::make_shared<DimMap>(*dim_map_);
+        } else {
+            // the last read view sharing the map may just have released it on another thread
+            std::atomic_thread_fence(std::memory_order_acquire);
+        }
+        return *dim_map_;
+    }
+
+    // grows the published spans and max scores to nr_inner_dims_, new dims are then published by publish_dim().
+    void
+    resize_published_dims() {
+        inverted_index_ids_spans_.resize(nr_inner_dims_);
+        inverted_index_vals_spans_.resize(nr_inner_dims_);
+        if constexpr (use_dim_max_score) {
+            published_max_score_in_dim_.resize(nr_inner_dims_);
+        }
+        if constexpr (use_block_max_score) {
+            block_max_scores_spans_.resize(nr_inner_dims_);
+        }
+    }
+
+    // publishes the posting list and max scores of dim_id to searches and to the read views created from now on.
+    // Add() updates the block max score of the last block of a posting list in place until the block is full, so
+    // that block is only published once full and searches bound it by the max score of the dim until then.
+    void
+    publish_dim(size_t dim_id) {
+        const auto& plist_ids = inverted_index_ids_[dim_id];
+        const auto& plist_vals = inverted_index_vals_[dim_id];
+        inverted_index_ids_spans_.set(dim_id, boost::span<const table_t>(plist_ids.data(), plist_ids.size()));
+        inverted_index_vals_spans_.set(dim_id, boost::span<const QType>(plist_vals.data(), plist_vals.size()));
+        if constexpr (use_dim_max_score) {
+            published_max_score_in_dim_.set(dim_id, max_score_in_dim_[dim_id]);
+        }
+        if constexpr (use_block_max_score) {
+            const auto& plist_block_max_scores = block_max_scores_[dim_id];
+            const size_t nr_blocks =
+                mmapped ? plist_block_max_scores.size() : plist_ids.size() / block_max_block_size;
+            block_max_scores_spans_.set(dim_id, boost::span<const float>(plist_block_max_scores.data(), nr_blocks));
+        }
+    }
+
     // Given a vector of values, returns the threshold value.
     // All values strictly smaller than the threshold will be ignored.
     // values will be modified in this function.
@@ -965,41 +1559,55 @@ class InvertedIndex : public BaseInvertedIndex<DType> {
 
         if (metric_type_ == SparseMetricType::METRIC_IP) {
             for (const auto& [dim_idx, q_weight] : q_vec) {
-                const auto& plist_ids = inverted_index_ids_spans_[dim_idx];
-                const auto& plist_vals = inverted_index_vals_spans_[dim_idx];
-
-                accumulate_posting_list_contribution_ip_dispatch<QType>(
-                    plist_ids.data(), plist_vals.data(), plist_ids.size(), static_cast<float>(q_weight), scores.data());
+                const float q_weight_float = static_cast<float>(q_weight);
+                for_each_posting_chunk(dim_idx, [&](const table_t* ids, const QType* vals, size_t n) {
+                    accumulate_posting_list_contribution_ip_dispatch<QType>(ids, vals, n, q_weight_float,
+                                                                            scores.data());
+                });
             }
         } else {
             const auto& doc_len_ratios = bm25_params_->row_sums_spans_;
             for (const auto& [dim_idx, q_weight] : q_vec) {
-                const auto& plist_ids = inverted_index_ids_spans_[dim_idx];
-                const auto& plist_vals = inverted_index_vals_spans_[dim_idx];
                 const float q_weight_float = static_cast<float>(q_weight);
-                for (size_t j = 0; j < plist_ids.size(); ++j) {
-                    const auto doc_id = plist_ids[j];
-                    const float doc_val = computer(plist_vals[j], doc_len_ratios[doc_id]);
-                    scores[doc_id] += q_weight_float * doc_val;
-                }
+                for_each_posting_chunk(dim_idx, [&](const table_t* ids, const QType* vals, size_t n) {
+                    for (size_t j = 0; j < n; ++j) {
+                        const auto doc_id = ids[j];
+                        const float doc_val = computer(vals[j], doc_len_ratios[doc_id]);
+                        scores[doc_id] += q_weight_float * doc_val;
+                    }
+                });
             }
         }
 
         return scores;
     }
 
+    // iterates a posting list, which is either given by plist_ids, or by compressed_ids whose blocks are decoded
+    // when the cursor reaches them.
     template <typename DocIdFilter>
     struct Cursor {
      public:
-        Cursor(const boost::span<const table_t>& plist_ids, const boost::span<const QType>& plist_vals, size_t num_vec,
-               float max_score, float q_value, DocIdFilter filter)
+        Cursor(const boost::span<const table_t>& plist_ids, const CompressedPostingIds* compressed_ids,
+               const boost::span<const QType>& plist_vals, size_t num_vec, float max_score, float q_value,
+               DocIdFilter filter, const boost::span<const float>& block_max_scores = {},
+               float block_score_scale = 0.0f)
             : plist_ids_(plist_ids),
               plist_vals_(plist_vals),
-              plist_size_(plist_ids.size()),
+              plist_size_(plist_vals.size()),
               total_num_vec_(num_vec),
               max_score_(max_score),
               q_value_(q_value),
-              filter_(filter) {
+              filter_(filter),
+              block_max_scores_(block_max_scores),
+              block_score_scale_(block_score_scale),
+              compressed_ids_(compressed_ids) {
+            if (compressed_ids_ != nullptr) {
+                decoded_ids_ = std::make_unique<table_t[]>(posting_list_block_size);
+            } else {
+                // the whole posting list is a single block
+                block_ids_ = plist_ids_.data();
+                block_end_ = plist_size_;
+            }
             skip_filtered_ids();
             update_cur_vec_id();
         }
@@ -1015,19 +1623,49 @@ class InvertedIndex : public BaseInvertedIndex<DType> {
 
         void
         seek(table_t vec_id) {
-            while (loc_ < plist_size_ && plist_ids_[loc_] < vec_id) {
+            // skip whole blocks whose last id is smaller than vec_id
+            size_t block = loc_ / block_max_block_size;
+            while ((block + 1) * block_max_block_size < plist_size_ && last_vec_id_of_block(block) < vec_id) {
+                loc_ = ++block * block_max_block_size;
+            }
+            while (loc_ < plist_size_ && vec_id_at(loc_) < vec_id) {
                 ++loc_;
             }
             skip_filtered_ids();
             update_cur_vec_id();
         }
 
+        // moves the current block to the one that may contain vec_id, without moving the cursor itself.
+        void
+        shallow_seek(table_t vec_id) {
+            block_idx_ = std::max(block_idx_, loc_ / block_max_block_size);
+            while (block_idx_ < block_max_scores_.size() && block_last_vec_id() < vec_id) {
+                ++block_idx_;
+            }
+        }
+
+        // upper bound of the scores in the current block, already multiplied by the query value. The last block of
+        // a posting list may not have a block max score yet, see publish_dim(), it is bound by the max score then.
+        float
+        block_max_score() const {
+            return block_idx_ < block_max_scores_.size() ? block_max_scores_[block_idx_] * block_score_scale_
+                                                         : max_score_;
+        }
+
+        table_t
+        block_last_vec_id() const {
+            if (block_idx_ >= block_max_scores_.size()) {
+                return total_num_vec_;
+            }
+            return last_vec_id_of_block(block_idx_);
+        }
+
         QType
         cur_vec_val() const {
             return plist_vals_[loc_];
         }
 
-        const boost::span<const table_t>& plist_ids_;
+        boost::span<const table_t> plist_ids_;
         const boost::span<const QType>& plist_vals_;
         const size_t plist_size_;
         size_t loc_ = 0;
@@ -1036,16 +1674,46 @@ class InvertedIndex : public BaseInvertedIndex<DType> {
         float q_value_ = 0.0f;
         DocIdFilter filter_;
         table_t cur_vec_id_ = 0;
+        boost::span<const float> block_max_scores_;
+        float block_score_scale_ = 0.0f;
+        size_t block_idx_ = 0;
 
      private:
+        // the ids of [block_begin_, block_end_) of the posting list are available in block_ids_
+        const CompressedPostingIds* compressed_ids_ = nullptr;
+        std::unique_ptr<table_t[]> decoded_ids_;
+        const table_t* block_ids_ = nullptr;
+        size_t block_begin_ = 0;
+        size_t block_end_ = 0;
+
+        // loc must be smaller than plist_size_ and not smaller than the current location.
+        inline table_t
+        vec_id_at(size_t loc) {
+            if (loc >= block_end_) {
+                // only happens to compressed posting lists
+                block_begin_ = loc / posting_list_block_size * posting_list_block_size;
+                block_end_ = block_begin_ + compressed_ids_->decode(loc / posting_list_block_size, decoded_ids_.get());
+                block_ids_ = decoded_ids_.get();
+            }
+            return block_ids_[loc - block_begin_];
+        }
+
+        inline table_t
+        last_vec_id_of_block(size_t block) const {
+            if (compressed_ids_ != nullptr) {
+                return compressed_ids_->block_last_ids[block];
+            }
+            return plist_ids_[std::min((block + 1) * block_max_block_size, plist_size_) - 1];
+        }
+
         inline void
         update_cur_vec_id() {
-            cur_vec_id_ = (loc_ >= plist_size_) ? total_num_vec_ : plist_ids_[loc_];
+            cur_vec_id_ = (loc_ >= plist_size_) ? total_num_vec_ : vec_id_at(loc_);
         }
 
         inline void
         skip_filtered_ids() {
-            while (loc_ < plist_size_ && !filter_.empty() && filter_.test(plist_ids_[loc_])) {
+            while (loc_ < plist_size_ && !filter_.empty() && filter_.test(vec_id_at(loc_))) {
                 ++loc_;
             }
         }
@@ -1065,8 +1733,8 @@ class InvertedIndex : public BaseInvertedIndex<DType> {
         std::vector<std::pair<size_t, DType>> filtered_query;
         for (size_t i = 0; i < query.size(); ++i) {
             auto [dim, val] = query[i];
-            auto dim_it = dim_map_.find(dim);
-            if (dim_it == dim_map_.cend() || std::abs(val) < q_threshold) {
+            auto dim_it = dim_map_->find(dim);
+            if (dim_it == dim_map_->cend() || std::abs(val) < q_threshold) {
                 continue;
             }
             filtered_query.emplace_back(dim_it->second, val);
@@ -1082,15 +1750,74 @@ class InvertedIndex : public BaseInvertedIndex<DType> {
         std::vector<Cursor<DocIdFilter>> cursors;
         cursors.reserve(q_vec.size());
         for (auto q_dim : q_vec) {
-            auto& plist_ids = inverted_index_ids_spans_[q_dim.first];
+            const bool compressed = !compressed_ids_.empty();
+            auto plist_ids = compressed ? boost::span<const table_t>() : inverted_index_ids_spans_[q_dim.first];
+            auto compressed_ids = compressed ? &compressed_ids_[q_dim.first] : nullptr;
             auto& plist_vals = inverted_index_vals_spans_[q_dim.first];
-            cursors.emplace_back(plist_ids, plist_vals, n_rows_internal_,
-                                 max_score_in_dim_spans_[q_dim.first] * q_dim.second * dim_max_score_ratio,
-                                 q_dim.second, filter);
+            if constexpr (use_block_max_score) {
+                cursors.emplace_back(plist_ids, compressed_ids, plist_vals, n_rows_internal_,
+                                     published_max_score_in_dim_[q_dim.first] * q_dim.second * dim_max_score_ratio,
+                                     q_dim.second, filter, block_max_scores_spans_[q_dim.first],
+                                     q_dim.second * dim_max_score_ratio);
+            } else {
+                cursors.emplace_back(plist_ids, compressed_ids, plist_vals, n_rows_internal_,
+                                     published_max_score_in_dim_[q_dim.first] * q_dim.second * dim_max_score_ratio,
+                                     q_dim.second, filter);
+            }
         }
         return cursors;
     }
 
+    // filters internal ids of reordered rows by the ids the rows were added with
+    struct DocIdFilterByMap {
+        BitsetView bitset;
+        boost::span<const table_t> doc_id_map;
+
+        [[nodiscard]] bool
+        empty() const {
+            return bitset.empty();
+        }
+
+        [[nodiscard]] bool
+        test(const table_t id) const {
+            return bitset.test(doc_id_map[id]);
+        }
+    };
+
+    template <typename DocIdFilter>
+    void
+    search_with_filter(std::vector<std::pair<size_t, DType>>& q_vec, MaxMinHeap<float>& heap, DocIdFilter& filter,
+                       const DocValueComputer<float>& computer, float dim_max_score_ratio) const {
+        // DAAT_WAND, DAAT_MAXSCORE and their block-max variants are based on the implementation in PISA.
+        if constexpr (algo == InvertedIndexAlgo::DAAT_WAND) {
+            search_daat_wand(q_vec, heap, filter, computer, dim_max_score_ratio);
+        } else if constexpr (algo == InvertedIndexAlgo::DAAT_BLOCK_MAX_WAND) {
+            search_daat_block_max_wand(q_vec, heap, filter, computer, dim_max_score_ratio);
+        } else if constexpr (algo == InvertedIndexAlgo::DAAT_MAXSCORE ||
+                             algo == InvertedIndexAlgo::DAAT_BLOCK_MAX_MAXSCORE) {
+            search_daat_maxscore(q_vec, heap, filter, computer, dim_max_score_ratio);
+        } else {
+            search_taat_naive(q_vec, heap, filter, computer);
+        }
+    }
+
+    // writes the candidates of heap to distances and labels, after refining them if the search was approximate.
+    void
+    finish_search(const SparseRow<DType>& query, MaxMinHeap<float>& heap, size_t k, float* distances, label_t* labels,
+                  const DocValueComputer<float>& computer, InvertedIndexApproxSearchParams& approx_params) const {
+        if (approx_params.refine_factor == 1) {
+            collect_result(heap, distances, labels);
+        } else {
+            refine_and_collect(query, heap, k, distances, labels, computer, approx_params);
+        }
+
+        if (!doc_id_map_span_.empty()) {
+            for (size_t i = 0; i < k && labels[i] != -1; ++i) {
+                labels[i] = doc_id_map_span_[labels[i]];
+            }
+        }
+    }
+
     // find the top-k candidates using brute force search, k as specified by the capacity of the heap.
     // any value in q_vec that is smaller than q_threshold and any value with dimension >= n_cols() will be ignored.
     // TODO: may switch to row-wise brute force if filter rate is high. Benchmark needed.
@@ -1098,14 +1825,134 @@ class InvertedIndex : public BaseInvertedIndex<DType> {
     void
     search_taat_naive(const std::vector<std::pair<size_t, DType>>& q_vec, MaxMinHeap<float>& heap, DocIdFilter& filter,
                       const DocValueComputer<float>& computer) const {
-        auto scores = compute_all_distances(q_vec, computer);
-        for (size_t i = 0; i < n_rows_internal_; ++i) {
-            if ((filter.empty() || !filter.test(i)) && scores[i] != 0) {
-                heap.push(i, scores[i]);
+        search_taat_blocked(&q_vec, &heap, 1, filter, computer);
+    }
+
+    // the postings of a dim used by some queries of a TAAT search, loc is the location of the first posting not
+    // accumulated yet.
+    struct TaatTerm {
+        size_t dim_id;
+        size_t loc = 0;
+        // (query, query value of the dim)
+        std::vector<std::pair<size_t, float>> weights;
+    };
+
+    // TAAT search of q_vecs[0, nq), the top-k candidates of the i-th query are pushed to heaps[i].
+    //
+    // The doc id space is split into windows, so that the scores of a window for all queries fit in L2 while the
+    // posting lists of all query dims are scattered into them, instead of scattering into a score per row. Each
+    // window then pushes its candidates to the heaps. A dim used by several queries is located once per window and
+    // its postings are read while they are cached.
+    template <typename DocIdFilter>
+    void
+    search_taat_blocked(const std::vector<std::pair<size_t, DType>>* q_vecs, MaxMinHeap<float>* heaps, size_t nq,
+                        DocIdFilter& filter, const DocValueComputer<float>& computer) const {
+        std::vector<TaatTerm> terms;
+        std::unordered_map<size_t, size_t> term_of_dim;
+        for (size_t q = 0; q < nq; ++q) {
+            for (const auto& [dim_id, q_weight] : q_vecs[q]) {
+                auto [it, inserted] = term_of_dim.emplace(dim_id, terms.size());
+                if (inserted) {
+                    terms.push_back({dim_id});
+                }
+                terms[it->second].weights.emplace_back(q, static_cast<float>(q_weight));
+            }
+        }
+        if (terms.empty()) {
+            return;
+        }
+
+        const size_t window = std::max(taat_window_size / nq, posting_list_block_size);
+        float* scores = taat_accumulator(window * nq);
+        for (size_t window_begin = 0; window_begin < n_rows_internal_; window_begin += window) {
+            const size_t window_end = std::min(window_begin + window, n_rows_internal_);
+            const size_t window_len = window_end - window_begin;
+            std::fill(scores, scores + window * nq, 0.0f);
+            for (auto& term : terms) {
+                accumulate_taat_term(term, window_begin, window_end, scores, window, computer);
+            }
+            if (!filter.empty()) {
+                // a filter tests each id once and in order, for all queries
+                for (size_t i = 0; i < window_len; ++i) {
+                    if (filter.test(window_begin + i)) {
+                        for (size_t q = 0; q < nq; ++q) {
+                            scores[q * window + i] = 0.0f;
+                        }
+                    }
+                }
+            }
+            for (size_t q = 0; q < nq; ++q) {
+                const float* q_scores = scores + q * window;
+                for (size_t i = 0; i < window_len; ++i) {
+                    if (q_scores[i] != 0) {
+                        heaps[q].push(window_begin + i, q_scores[i]);
+                    }
+                }
             }
         }
     }
 
+    // adds the postings of term with ids in [window_begin, window_end) to the window scores of the queries using
+    // it, the scores of the q-th query being scores[q * window, (q + 1) * window).
+    void
+    accumulate_taat_term(TaatTerm& term, size_t window_begin, size_t window_end, float* scores, size_t window,
+                         const DocValueComputer<float>& computer) const {
+        auto accumulate = [&](const table_t* ids, const QType* vals, size_t n) {
+            if (n == 0) {
+                return;
+            }
+            for (const auto& [q, q_weight] : term.weights) {
+                // the ids of the window are relative to window_begin in the scores of the window
+                float* q_scores = scores + q * window;
+                if (metric_type_ == SparseMetricType::METRIC_IP) {
+                    accumulate_posting_list_contribution_ip_dispatch<QType>(ids, vals, n, q_weight, q_scores,
+                                                                            static_cast<table_t>(window_begin));
+                } else {
+                    const auto& doc_len_ratios = bm25_params_->row_sums_spans_;
+                    for (size_t j = 0; j < n; ++j) {
+                        q_scores[ids[j] - window_begin] += q_weight * computer(vals[j], doc_len_ratios[ids[j]]);
+                    }
+                }
+            }
+        };
+
+        const auto& plist_vals = inverted_index_vals_spans_[term.dim_id];
+        if (compressed_ids_.empty()) {
+            const auto& plist_ids = inverted_index_ids_spans_[term.dim_id];
+            const size_t end =
+                std::lower_bound(plist_ids.begin() + term.loc, plist_ids.end(), window_end) - plist_ids.begin();
+            accumulate(plist_ids.data() + term.loc, plist_vals.data() + term.loc, end - term.loc);
+            term.loc = end;
+            return;
+        }
+        // a block crossing the end of the window is decoded again by the next window
+        const auto& plist_ids = compressed_ids_[term.dim_id];
+        table_t ids[posting_list_block_size];
+        while (term.loc < plist_vals.size()) {
+            const size_t block = term.loc / posting_list_block_size;
+            const size_t block_begin = block * posting_list_block_size;
+            const size_t n = plist_ids.decode(block, ids);
+            const size_t begin = term.loc - block_begin;
+            const size_t end = std::lower_bound(ids + begin, ids + n, window_end) - ids;
+            accumulate(ids + begin, plist_vals.data() + term.loc, end - begin);
+            term.loc = block_begin + end;
+            if (end < n) {
+                break;
+            }
+        }
+    }
+
+    // returns the scores buffer of this thread for TAAT search, which holds at least size floats. The buffer is
+    // reused by all TAAT searches on the thread rather than allocated per query.
+    static float*
+    taat_accumulator(size_t size) {
+        thread_local std::vector<float> scores;
+        if (scores.size() < size) {
+            scores.resize(size);
+        }
+        return scores.data();
+    }
+
     template <typename DocIdFilter>
     void
     search_daat_wand(const std::vector<std::pair<size_t, DType>>& q_vec, MaxMinHeap<float>& heap, DocIdFilter& filter,
@@ -1171,12 +2018,119 @@ class InvertedIndex : public BaseInvertedIndex<DType> {
         }
     }
 
+    // Block-max WAND (Ding & Suel, SIGIR 2011): the pivot is selected with the max scores of dims like WAND, then the
+    // block max scores of the lists up to the pivot are checked, and the whole range covered by these blocks is
+    // skipped if it cannot beat the threshold.
+    template <typename DocIdFilter>
+    void
+    search_daat_block_max_wand(const std::vector<std::pair<size_t, DType>>& q_vec, MaxMinHeap<float>& heap,
+                               DocIdFilter& filter, const DocValueComputer<float>& computer,
+                               float dim_max_score_ratio) const {
+        std::vector<Cursor<DocIdFilter>> cursors = make_cursors(q_vec, computer, filter, dim_max_score_ratio);
+        std::vector<Cursor<DocIdFilter>*> cursor_ptrs(cursors.size());
+        for (size_t i = 0; i < cursors.size(); ++i) {
+            cursor_ptrs[i] = &cursors[i];
+        }
+
+        auto sort_cursors = [&cursor_ptrs] {
+            std::sort(cursor_ptrs.begin(), cursor_ptrs.end(),
+                      [](auto& x, auto& y) { return x->cur_vec_id_ < y->cur_vec_id_; });
+        };
+        // move cursor_ptrs[list] forward to keep cursor_ptrs sorted after it has been advanced
+        auto bubble_down = [&cursor_ptrs](size_t list) {
+            for (size_t i = list + 1; i < cursor_ptrs.size(); ++i) {
+                if (cursor_ptrs[i]->cur_vec_id_ >= cursor_ptrs[i - 1]->cur_vec_id_) {
+                    break;
+                }
+                std::swap(cursor_ptrs[i], cursor_ptrs[i - 1]);
+            }
+        };
+        sort_cursors();
+
+        while (true) {
+            float threshold = heap.full() ? heap.top().val : 0;
+            float upper_bound = 0;
+            size_t pivot;
+
+            bool found_pivot = false;
+            for (pivot = 0; pivot < q_vec.size(); ++pivot) {
+                if (cursor_ptrs[pivot]->cur_vec_id_ >= n_rows_internal_) {
+                    break;
+                }
+                upper_bound += cursor_ptrs[pivot]->max_score_;
+                if (upper_bound > threshold) {
+                    found_pivot = true;
+                    break;
+                }
+            }
+            if (!found_pivot) {
+                break;
+            }
+
+            table_t pivot_id = cursor_ptrs[pivot]->cur_vec_id_;
+            // lists after the pivot pointing to the same vector also contribute to it
+            while (pivot + 1 < q_vec.size() && cursor_ptrs[pivot + 1]->cur_vec_id_ == pivot_id) {
+                ++pivot;
+            }
+
+            float block_upper_bound = 0;
+            for (size_t i = 0; i <= pivot; ++i) {
+                cursor_ptrs[i]->shallow_seek(pivot_id);
+                block_upper_bound += cursor_ptrs[i]->block_max_score();
+            }
+
+            if (block_upper_bound > threshold) {
+                if (pivot_id == cursor_ptrs[0]->cur_vec_id_) {
+                    float score = 0;
+                    float cur_vec_sum =
+                        metric_type_ == SparseMetricType::METRIC_BM25 ? bm25_params_->row_sums_spans_[pivot_id] : 0;
+                    for (auto& cursor_ptr : cursor_ptrs) {
+                        if (cursor_ptr->cur_vec_id_ != pivot_id) {
+                            break;
+                        }
+                        score += cursor_ptr->q_value_ * computer(cursor_ptr->cur_vec_val(), cur_vec_sum);
+                        cursor_ptr->next();
+                    }
+                    heap.push(pivot_id, score);
+                    sort_cursors();
+                } else {
+                    size_t next_list = pivot;
+                    for (; cursor_ptrs[next_list]->cur_vec_id_ == pivot_id; --next_list) {
+                    }
+                    cursor_ptrs[next_list]->seek(pivot_id);
+                    bubble_down(next_list);
+                }
+            } else {
+                // no vector before the end of the current blocks can beat the threshold: advance the list with the
+                // largest max score to the first vector that may be outside of these blocks.
+                size_t next_list = pivot;
+                float next_list_max_score = cursor_ptrs[pivot]->max_score_;
+                table_t next_vec_id = n_rows_internal_;
+                for (size_t i = 0; i <= pivot; ++i) {
+                    if (cursor_ptrs[i]->max_score_ > next_list_max_score) {
+                        next_list = i;
+                        next_list_max_score = cursor_ptrs[i]->max_score_;
+                    }
+                    next_vec_id = std::min<table_t>(next_vec_id, cursor_ptrs[i]->block_last_vec_id() + 1);
+                }
+                if (pivot + 1 < q_vec.size() && cursor_ptrs[pivot + 1]->cur_vec_id_ < next_vec_id) {
+                    next_vec_id = cursor_ptrs[pivot + 1]->cur_vec_id_;
+                }
+                if (next_vec_id <= pivot_id) {
+                    next_vec_id = pivot_id + 1;
+                }
+                cursor_ptrs[next_list]->seek(next_vec_id);
+                bubble_down(next_list);
+            }
+        }
+    }
+
     template <typename DocIdFilter>
     void
     search_daat_maxscore(std::vector<std::pair<size_t, DType>>& q_vec, MaxMinHeap<float>& heap, DocIdFilter& filter,
                          const DocValueComputer<float>& computer, float dim_max_score_ratio) const {
         std::sort(q_vec.begin(), q_vec.end(), [this](auto& a, auto& b) {
-            return a.second * max_score_in_dim_spans_[a.first] > b.second * max_score_in_dim_spans_[b.first];
+            return a.second * published_max_score_in_dim_[a.first] > b.second * published_max_score_in_dim_[b.first];
         });
 
         std::vector<Cursor<DocIdFilter>> cursors = make_cursors(q_vec, computer, filter, dim_max_score_ratio);
@@ -1236,14 +2190,35 @@ class InvertedIndex : public BaseInvertedIndex<DType> {
                 }
 
                 found_cand = true;
-                for (size_t i = first_ne_idx; i < cursors.size(); ++i) {
-                    if (curr_cand_score + upper_bounds[i] <= threshold) {
-                        found_cand = false;
-                        break;
+                if constexpr (use_block_max_score) {
+                    // the block max scores of the non-essential lists give a tighter bound than upper_bounds,
+                    // and are checked before touching any posting of these lists.
+                    float block_upper_bound = 0.0f;
+                    for (size_t i = first_ne_idx; i < cursors.size(); ++i) {
+                        cursors[i].shallow_seek(curr_cand_vec_id);
+                        block_upper_bound += cursors[i].block_max_score();
                     }
-                    cursors[i].seek(curr_cand_vec_id);
-                    if (cursors[i].cur_vec_id_ == curr_cand_vec_id) {
-                        curr_cand_score += cursors[i].q_value_ * computer(cursors[i].cur_vec_val(), cur_vec_sum);
+                    for (size_t i = first_ne_idx; i < cursors.size(); ++i) {
+                        if (curr_cand_score + block_upper_bound <= threshold) {
+                            found_cand = false;
+                            break;
+                        }
+                        cursors[i].seek(curr_cand_vec_id);
+                        if (cursors[i].cur_vec_id_ == curr_cand_vec_id) {
+                            curr_cand_score += cursors[i].q_value_ * computer(cursors[i].cur_vec_val(), cur_vec_sum);
+                        }
+                        block_upper_bound -= cursors[i].block_max_score();
+                    }
+                } else {
+                    for (size_t i = first_ne_idx; i < cursors.size(); ++i) {
+                        if (curr_cand_score + upper_bounds[i] <= threshold) {
+                            found_cand = false;
+                            break;
+                        }
+                        cursors[i].seek(curr_cand_vec_id);
+                        if (cursors[i].cur_vec_id_ == curr_cand_vec_id) {
+                            curr_cand_score += cursors[i].q_value_ * computer(cursors[i].cur_vec_val(), cur_vec_sum);
+                        }
                     }
                 }
             }
@@ -1283,16 +2258,136 @@ class InvertedIndex : public BaseInvertedIndex<DType> {
         float dim_max_score_ratio = std::max(approx_params.dim_max_score_ratio, 1.0f);
 
         DocIdFilterByVector filter(std::move(docids));
-        if constexpr (algo == InvertedIndexAlgo::DAAT_WAND) {
-            search_daat_wand(q_vec, heap, filter, computer, dim_max_score_ratio);
-        } else if constexpr (algo == InvertedIndexAlgo::DAAT_MAXSCORE) {
-            search_daat_maxscore(q_vec, heap, filter, computer, dim_max_score_ratio);
-        } else {
-            search_taat_naive(q_vec, heap, filter, computer);
-        }
+        search_with_filter(q_vec, heap, filter, computer, dim_max_score_ratio);
         collect_result(heap, distances, labels);
     }
 
+    static inline size_t
+    num_blocks(size_t plist_size) {
+        return (plist_size + block_max_block_size - 1) / block_max_block_size;
+    }
+
+    // computes the max scores of dims and blocks from the posting lists, for indexes that were serialized without
+    // them, e.g. built with another algorithm.
+    void
+    build_max_scores_from_posting_lists() {
+        std::vector<float> max_score_in_dim(nr_inner_dims_, 0.0f);
+        std::vector<size_t> block_offsets(nr_inner_dims_ + 1, 0);
+        for (size_t i = 0; i < nr_inner_dims_; ++i) {
+            block_offsets[i + 1] = block_offsets[i] + num_blocks(inverted_index_vals_spans_[i].size());
+        }
+        derived_block_max_scores_.assign(block_offsets[nr_inner_dims_], 0.0f);
+
+        for (size_t i = 0; i < nr_inner_dims_; ++i) {
+            size_t loc = 0;
+            for_each_posting_chunk(i, [&](const table_t* ids, const QType* vals, size_t n) {
+                for (size_t j = 0; j < n; ++j, ++loc) {
+                    auto score = posting_max_score(ids[j], vals[j]);
+                    max_score_in_dim[i] = std::max(max_score_in_dim[i], score);
+                    auto& block_max_score = derived_block_max_scores_[block_offsets[i] + loc / block_max_block_size];
+                    block_max_score = std::max(block_max_score, score);
+                }
+            });
+        }
+
+        published_max_score_in_dim_.assign(max_score_in_dim.data(), nr_inner_dims_);
+        block_max_scores_spans_.resize(nr_inner_dims_);
+        for (size_t i = 0; i < nr_inner_dims_; ++i) {
+            block_max_scores_spans_.set(i, boost::span<const float>(derived_block_max_scores_.data() + block_offsets[i],
+                                                                    block_offsets[i + 1] - block_offsets[i]));
+        }
+    }
+
+    // max score of the block-th block of the raw posting list of dim_id
+    float
+    compute_block_max_score(size_t dim_id, size_t block) const {
+        const auto& plist_ids = inverted_index_ids_spans_[dim_id];
+        const auto& plist_vals = inverted_index_vals_spans_[dim_id];
+        float block_max_score = 0.0f;
+        for (size_t loc = block * block_max_block_size;
+             loc < std::min(plist_vals.size(), (block + 1) * block_max_block_size); ++loc) {
+            block_max_score = std::max(block_max_score, posting_max_score(plist_ids[loc], plist_vals[loc]));
+        }
+        return block_max_score;
+    }
+
+    // upper bound of the score of a posting, for the max scores of dims and blocks
+    float
+    posting_max_score(table_t doc_id, QType val) const {
+        if (metric_type_ == SparseMetricType::METRIC_BM25) {
+            return bm25_params_->max_score_computer(val, bm25_params_->row_sums_spans_[doc_id]);
+        }
+        return static_cast<float>(val);
+    }
+
+    // calls func(ids, vals, n) on consecutive chunks of the posting list of dim_id. compressed posting lists are
+    // decoded block by block, while raw posting lists are given in one chunk.
+    template <typename Func>
+    void
+    for_each_posting_chunk(size_t dim_id, Func&& func) const {
+        const auto& plist_vals = inverted_index_vals_spans_[dim_id];
+        if (compressed_ids_.empty()) {
+            func(inverted_index_ids_spans_[dim_id].data(), plist_vals.data(), plist_vals.size());
+            return;
+        }
+        const auto& plist_ids = compressed_ids_[dim_id];
+        table_t ids[posting_list_block_size];
+        for (size_t block = 0; block < plist_ids.block_last_ids.size(); ++block) {
+            auto n = plist_ids.decode(block, ids);
+            func(ids, plist_vals.data() + block * posting_list_block_size, n);
+        }
+    }
+
+    // returns the location of vec_id in the posting list of dim_id, or the size of the posting list if not found.
+    size_t
+    find_in_posting_list(size_t dim_id, table_t vec_id) const {
+        const auto plist_size = inverted_index_vals_spans_[dim_id].size();
+        if (compressed_ids_.empty()) {
+            const auto& plist_ids = inverted_index_ids_spans_[dim_id];
+            auto it = std::lower_bound(plist_ids.begin(), plist_ids.end(), vec_id);
+            return (it != plist_ids.end() && *it == vec_id) ? it - plist_ids.begin() : plist_size;
+        }
+        const auto& plist_ids = compressed_ids_[dim_id];
+        auto block_it = std::lower_bound(plist_ids.block_last_ids.begin(), plist_ids.block_last_ids.end(), vec_id);
+        if (block_it == plist_ids.block_last_ids.end()) {
+            return plist_size;
+        }
+        const size_t block = block_it - plist_ids.block_last_ids.begin();
+        table_t ids[posting_list_block_size];
+        auto n = plist_ids.decode(block, ids);
+        auto it = std::lower_bound(ids, ids + n, vec_id);
+        return (it != ids + n && *it == vec_id) ? block * posting_list_block_size + (it - ids) : plist_size;
+    }
+
+    struct EncodedPostingIds {
+        std::vector<uint64_t> block_word_offsets;
+        std::vector<uint32_t> block_last_ids;
+        std::vector<uint32_t> words;
+    };
+
+    // encodes the doc ids of all posting lists with PostingListEncoding::BLOCK_BITPACKED
+    EncodedPostingIds
+    encode_posting_ids() const {
+        EncodedPostingIds encoded;
+        encoded.block_word_offsets.push_back(0);
+        uint32_t block_words[posting_list_block_max_words];
+        for (size_t i = 0; i < nr_inner_dims_; ++i) {
+            table_t base = 0;
+            // compressed chunks are whole blocks, raw chunks are split into blocks here
+            for_each_posting_chunk(i, [&](const table_t* ids, const QType*, size_t n) {
+                for (size_t j = 0; j < n; j += posting_list_block_size) {
+                    auto block_n = std::min(posting_list_block_size, n - j);
+                    auto bit_width = encode_posting_block(ids + j, block_n, base, block_words);
+                    encoded.words.insert(encoded.words.end(), block_words, block_words + 2 * bit_width);
+                    encoded.block_word_offsets.push_back(encoded.words.size());
+                    encoded.block_last_ids.push_back(ids[j + block_n - 1]);
+                    base = ids[j + block_n - 1] + 1;
+                }
+            });
+        }
+        return encoded;
+    }
+
     template <typename HeapType>
     void
     collect_result(HeapType& heap, float* distances, label_t* labels) const {
@@ -1317,17 +2412,20 @@ class InvertedIndex : public BaseInvertedIndex<DType> {
             if (val == 0) {
                 continue;
             }
-            auto dim_it = dim_map_.find(dim);
-            if (dim_it == dim_map_.cend()) {
+            auto dim_it = dim_map_->find(dim);
+            if (dim_it == dim_map_->cend()) {
                 if constexpr (mmapped) {
                     throw std::runtime_error("unexpected vector dimension in mmapped InvertedIndex");
                 }
-                dim_it = dim_map_.insert({dim, next_dim_id_++}).first;
+                dim_it = mutable_dim_map().insert({dim, next_dim_id_++}).first;
                 inverted_index_ids_.emplace_back();
                 inverted_index_vals_.emplace_back();
-                if constexpr (algo == InvertedIndexAlgo::DAAT_WAND || algo == InvertedIndexAlgo::DAAT_MAXSCORE) {
+                if constexpr (use_dim_max_score) {
                     max_score_in_dim_.emplace_back(0.0f);
                 }
+                if constexpr (use_block_max_score) {
+                    block_max_scores_.emplace_back();
+                }
             }
             inverted_index_ids_[dim_it->second].emplace_back(vec_id);
             inverted_index_vals_[dim_it->second].emplace_back(get_quant_val(val));
@@ -1336,14 +2434,14 @@ class InvertedIndex : public BaseInvertedIndex<DType> {
         build_stats_.dataset_nnz_stats_.push_back(row.size());
 #endif
         // update max_score_in_dim_
-        if constexpr (algo == InvertedIndexAlgo::DAAT_WAND || algo == InvertedIndexAlgo::DAAT_MAXSCORE) {
+        if constexpr (use_dim_max_score) {
             for (size_t j = 0; j < row.size(); ++j) {
                 auto [dim, val] = row[j];
                 if (val == 0) {
                     continue;
                 }
-                auto dim_it = dim_map_.find(dim);
-                if (dim_it == dim_map_.cend()) {
+                auto dim_it = dim_map_->find(dim);
+                if (dim_it == dim_map_->cend()) {
                     throw std::runtime_error("unexpected vector dimension in InvertedIndex");
                 }
                 auto score = static_cast<float>(val);
@@ -1351,6 +2449,16 @@ class InvertedIndex : public BaseInvertedIndex<DType> {
                     score = bm25_params_->max_score_computer(val, row_sum);
                 }
                 max_score_in_dim_[dim_it->second] = std::max(max_score_in_dim_[dim_it->second], score);
+                if constexpr (use_block_max_score) {
+                    // vec_id has just been appended to the posting list of this dim
+                    auto& plist_block_max_scores = block_max_scores_[dim_it->second];
+                    auto block_id = (inverted_index_ids_[dim_it->second].size() - 1) / block_max_block_size;
+                    if (block_id == plist_block_max_scores.size()) {
+                        plist_block_max_scores.emplace_back(score);
+                    } else {
+                        plist_block_max_scores[block_id] = std::max(plist_block_max_scores[block_id], score);
+                    }
+                }
             }
         }
         if (metric_type_ == SparseMetricType::METRIC_BM25) {
@@ -1358,6 +2466,150 @@ class InvertedIndex : public BaseInvertedIndex<DType> {
         }
     }
 
+    // adds data[order[i]], or data[i] if order is empty, as row n_rows_internal_ + i for i in [0, rows), the same as
+    // add_row_to_index() would do row by row. The rows are split into contiguous ranges, one per task: a counting
+    // pass finds the number of postings each range adds to each dim, which gives every range the exact location of
+    // its postings in the posting lists, grown once to their final sizes, and the ranges then fill them in parallel.
+    void
+    add_rows_parallel(const SparseRow<DType>* data, const std::vector<table_t>& order, size_t rows, ThreadPool& pool) {
+        const size_t first_id = n_rows_internal_;
+        const size_t nr_tasks =
+            std::min<size_t>(pool.size(), (rows + parallel_add_min_rows - 1) / parallel_add_min_rows);
+        const size_t rows_per_task = (rows + nr_tasks - 1) / nr_tasks;
+        auto row_at = [&](size_t i) -> const SparseRow<DType>& { return order.empty() ? data[i] : data[order[i]]; };
+        auto run_tasks = [&](size_t n, auto&& task) {
+            std::vector<folly::Future<folly::Unit>> futures;
+            futures.reserve(n);
+            for (size_t t = 0; t < n; ++t) {
+                futures.emplace_back(pool.push([&, t] { task(t); }));
+            }
+            WaitAllSuccess(futures);
+        };
+
+        // dim -> number of postings of the range, then location of its next posting in the posting list of dim_id
+        struct RangePostings {
+            uint32_t dim_id;
+            size_t loc;
+        };
+        std::vector<std::unordered_map<table_t, RangePostings>> range_postings(nr_tasks);
+        run_tasks(nr_tasks, [&](size_t t) {
+            auto& postings = range_postings[t];
+            for (size_t i = t * rows_per_task; i < std::min(rows, (t + 1) * rows_per_task); ++i) {
+                const auto& row = row_at(i);
+                for (size_t j = 0; j < row.size(); ++j) {
+                    auto [dim, val] = row[j];
+                    if (val != 0) {
+                        postings[dim].loc++;
+                    }
+                }
+            }
+        });
+
+        // new dims get their ids in ascending order of dim, so that the result doesn't depend on the number of tasks
+        std::vector<table_t> new_dims;
+        for (const auto& postings : range_postings) {
+            for (const auto& [dim, p] : postings) {
+                if (dim_map_->find(dim) == dim_map_->cend()) {
+                    new_dims.push_back(dim);
+                }
+            }
+        }
+        std::sort(new_dims.begin(), new_dims.end());
+        new_dims.erase(std::unique(new_dims.begin(), new_dims.end()), new_dims.end());
+        for (auto dim : new_dims) {
+            mutable_dim_map().insert({dim, next_dim_id_++});
+            inverted_index_ids_.emplace_back();
+            inverted_index_vals_.emplace_back();
+            if constexpr (use_dim_max_score) {
+                max_score_in_dim_.emplace_back(0.0f);
+            }
+            if constexpr (use_block_max_score) {
+                block_max_scores_.emplace_back();
+            }
+        }
+
+        const size_t nr_dims = dim_map_->size();
+        std::vector<size_t> old_sizes(nr_dims);
+        std::vector<size_t> new_sizes(nr_dims);
+        for (size_t i = 0; i < nr_dims; ++i) {
+            old_sizes[i] = new_sizes[i] = inverted_index_ids_[i].size();
+        }
+        for (auto& postings : range_postings) {
+            for (auto& [dim, p] : postings) {
+                p.dim_id = dim_map_->find(dim)->second;
+                const auto count = p.loc;
+                p.loc = new_sizes[p.dim_id];
+                new_sizes[p.dim_id] += count;
+            }
+        }
+        for (size_t i = 0; i < nr_dims; ++i) {
+            if (new_sizes[i] != old_sizes[i]) {
+                inverted_index_ids_[i].resize(new_sizes[i]);
+                inverted_index_vals_[i].resize(new_sizes[i]);
+            }
+        }
+        if (metric_type_ == SparseMetricType::METRIC_BM25) {
+            bm25_params_->row_sums.resize(first_id + rows);
+        }
+#if defined(NOT_COMPILE_FOR_SWIG) && !defined(KNOWHERE_WITH_LIGHT)
+        build_stats_.dataset_nnz_stats_.resize(first_id + rows);
+#endif
+
+        run_tasks(nr_tasks, [&](size_t t) {
+            auto& postings = range_postings[t];
+            for (size_t i = t * rows_per_task; i < std::min(rows, (t + 1) * rows_per_task); ++i) {
+                const auto& row = row_at(i);
+                const table_t vec_id = first_id + i;
+                float row_sum = 0;
+                for (size_t j = 0; j < row.size(); ++j) {
+                    auto [dim, val] = row[j];
+                    row_sum += val;
+                    if (val == 0) {
+                        continue;
+                    }
+                    auto& p = postings.find(dim)->second;
+                    inverted_index_ids_[p.dim_id][p.loc] = vec_id;
+                    inverted_index_vals_[p.dim_id][p.loc] = get_quant_val(val);
+                    ++p.loc;
+                }
+                if (metric_type_ == SparseMetricType::METRIC_BM25) {
+                    bm25_params_->row_sums[vec_id] = row_sum;
+                }
+#if defined(NOT_COMPILE_FOR_SWIG) && !defined(KNOWHERE_WITH_LIGHT)
+                build_stats_.dataset_nnz_stats_[vec_id] = row.size();
+#endif
+            }
+        });
+
+        // the max scores are updated with the new postings of each dim, the blocks of a posting list may span
+        // several ranges so this is done per dim rather than per range.
+        if constexpr (use_dim_max_score) {
+            run_tasks(nr_tasks, [&](size_t t) {
+                for (size_t i = t; i < nr_dims; i += nr_tasks) {
+                    const auto& plist_ids = inverted_index_ids_[i];
+                    const auto& plist_vals = inverted_index_vals_[i];
+                    for (size_t loc = old_sizes[i]; loc < new_sizes[i]; ++loc) {
+                        auto score = static_cast<float>(plist_vals[loc]);
+                        if (metric_type_ == SparseMetricType::METRIC_BM25) {
+                            score = bm25_params_->max_score_computer(plist_vals[loc],
+                                                                     bm25_params_->row_sums[plist_ids[loc]]);
+                        }
+                        max_score_in_dim_[i] = std::max(max_score_in_dim_[i], score);
+                        if constexpr (use_block_max_score) {
+                            auto& plist_block_max_scores = block_max_scores_[i];
+                            auto block_id = loc / block_max_block_size;
+                            if (block_id == plist_block_max_scores.size()) {
+                                plist_block_max_scores.emplace_back(score);
+                            } else {
+                                plist_block_max_scores[block_id] = std::max(plist_block_max_scores[block_id], score);
+                            }
+                        }
+                    }
+                }
+            });
+        }
+    }
+
     inline QType
     get_quant_val(DType val) const {
         if constexpr (!std::is_same_v<QType, DType>) {
@@ -1374,17 +2626,37 @@ class InvertedIndex : public BaseInvertedIndex<DType> {
         }
     }
 
-    // key is raw sparse vector dim/idx, value is the mapped dim/idx id in the index.
-    std::unordered_map<table_t, uint32_t> dim_map_;
+    // key is raw sparse vector dim/idx, value is the mapped dim/idx id in the index. The map is shared with read
+    // views, see mutable_dim_map().
+    std::shared_ptr<DimMap> dim_map_ = std::make_shared<DimMap>();
     uint32_t nr_inner_dims_ = 0;
 
     // reserve, [], size, emplace_back
     Vector<Vector<table_t>> inverted_index_ids_;
     Vector<Vector<QType>> inverted_index_vals_;
-    std::vector<boost::span<const table_t>> inverted_index_ids_spans_;
-    std::vector<boost::span<const QType>> inverted_index_vals_spans_;
+    // the spans and max scores searched, shared with read views, see publish_dim().
+    DimChunkedArray<boost::span<const table_t>> inverted_index_ids_spans_;
+    DimChunkedArray<boost::span<const QType>> inverted_index_vals_spans_;
     Vector<float> max_score_in_dim_;
-    boost::span<const float> max_score_in_dim_spans_;
+    DimChunkedArray<float> published_max_score_in_dim_;
+    // max scores of every block_max_block_size postings of each dim, only used by block-max algorithms
+    Vector<Vector<float>> block_max_scores_;
+    DimChunkedArray<boost::span<const float>> block_max_scores_spans_;
+    // owns the block max scores rebuilt by build_max_scores_from_posting_lists()
+    std::vector<float> derived_block_max_scores_;
+    // encoding of posting lists used by Serialize()
+    PostingListEncoding posting_list_encoding_ = PostingListEncoding::RAW;
+    // doc ids of posting lists deserialized with PostingListEncoding::BLOCK_BITPACKED, inverted_index_ids_spans_ is
+    // not used in this case.
+    std::vector<CompressedPostingIds> compressed_ids_;
+    // see SetDocReorder()
+    bool doc_reorder_ = false;
+    // for reordered rows, doc_id_map_[internal id] is the id a row was added with and doc_id_map_reverse_ is the
+    // inverse mapping, both are empty otherwise. The spans refer to deserialized data when loaded from a file.
+    std::vector<table_t> doc_id_map_;
+    std::vector<table_t> doc_id_map_reverse_;
+    boost::span<const table_t> doc_id_map_span_;
+    boost::span<const table_t> doc_id_map_reverse_span_;
 
     SparseMetricType metric_type_;
 
@@ -1409,10 +2681,30 @@ class InvertedIndex : public BaseInvertedIndex<DType> {
         BM25Params(float k1, float b, float avgdl)
             : k1(k1), b(b), max_score_computer(GetDocValueBM25Computer<float>(k1, b, avgdl)) {
         }
+
+        // shares the row sums of other, for read views
+        BM25Params(const BM25Params& other, boost::span<const float> row_sums_spans)
+            : k1(other.k1), b(other.b), row_sums_spans_(row_sums_spans), max_score_computer(other.max_score_computer) {
+        }
     };  // struct BM25Params
 
     std::unique_ptr<BM25Params> bm25_params_;
 
+    // set for read views created by CreateReadView()
+    bool is_read_view_ = false;
+    // for the origin of read views, the buffers retired since the creation of each view that may still be alive,
+    // oldest first. Buffers are retired to the last one.
+    std::deque<std::shared_ptr<RetiredBuffers>> retired_buffers_;
+    // for a read view, keeps the buffers retired since its creation alive.
+    std::shared_ptr<const RetiredBuffers> view_retired_buffers_;
+
+    // TAAT search accumulates the scores of this many rows at a time, 256KB of scores that stay in L2. Batched
+    // searches split the window among their queries.
+    static constexpr size_t taat_window_size = 1 << 16;
+
+    // Add() with the build pool only splits the rows into ranges of at least this many rows
+    static constexpr size_t parallel_add_min_rows = 4096;
+
     static constexpr uint32_t index_file_v1_header_size = 32;
     static constexpr uint32_t index_file_v1_header_reserved_size = 16;
 
@@ -24,6 +24,12 @@ class SparseInvertedIndexConfig : public BaseConfig {
     CFG_INT refine_factor;
     CFG_FLOAT dim_max_score_ratio;
     CFG_STRING inverted_index_algo;
+    CFG_BOOL inverted_index_compression;
+    CFG_BOOL inverted_index_doc_reorder;
+    CFG_INT seismic_n_postings;
+    CFG_FLOAT seismic_centroid_fraction;
+    CFG_FLOAT seismic_summary_energy;
+    CFG_FLOAT seismic_heap_factor;
     KNOHWERE_DECLARE_CONFIG(SparseInvertedIndexConfig) {
         // NOTE: drop_ratio_build has been deprecated, it won't change anything
         KNOWHERE_CONFIG_DECLARE_FIELD(drop_ratio_build)
@@ -81,24 +87,91 @@ class SparseInvertedIndexConfig : public BaseConfig {
             .set_default(1.05)
             .description("ratio to upscale/downscale the max score of each dimension")
             .for_search();
+        /**
+         * DAAT_BLOCK_MAX_WAND and DAAT_BLOCK_MAX_MAXSCORE additionally keep
+         * the max score of every 64 postings of each dim, which bounds the
+         * score of a range of vectors much tighter than the max score of the
+         * whole dim, so that more postings can be skipped on long posting
+         * lists, at the cost of one float per 64 postings.
+         */
         KNOWHERE_CONFIG_DECLARE_FIELD(inverted_index_algo)
             .description("inverted index algorithm")
             .set_default("DAAT_MAXSCORE")
             .for_train()
             .for_deserialize()
             .for_deserialize_from_file();
+        /**
+         * When enabled, doc ids of posting lists are serialized delta
+         * encoded and bit packed in blocks of 64 ids, which takes about 1-2
+         * bytes per id instead of 4, and the loaded index decodes them block
+         * by block during search. Values are kept as is. The encoding is
+         * recorded in the index file, so it is not needed when loading.
+         */
+        KNOWHERE_CONFIG_DECLARE_FIELD(inverted_index_compression)
+            .description("whether to compress posting lists of the serialized index")
+            .set_default(false)
+            .for_train();
+        /**
+         * When enabled, the rows of the first batch added to the index are
+         * reordered by recursive graph bisection, which puts rows sharing
+         * many dims next to each other. This shortens the gaps of posting
+         * lists, so they compress better, and clusters high scores into
+         * fewer blocks for the block-max algorithms, at the cost of a longer
+         * build. Search results still use the original row ids.
+         */
+        KNOWHERE_CONFIG_DECLARE_FIELD(inverted_index_doc_reorder)
+            .description("whether to reorder rows to cluster similar rows")
+            .set_default(false)
+            .for_train();
+        /**
+         * SPARSE_SEISMIC keeps only the seismic_n_postings largest values
+         * of each posting list, and clusters the kept rows of a list into
+         * ceil(seismic_centroid_fraction * list size) blocks. Each block is
+         * summarized by the max weight of each dim over its rows, keeping
+         * the largest weights up to seismic_summary_energy of their sum.
+         * More postings, blocks and summary weights improve recall, at the
+         * cost of a larger index and a slower search.
+         */
+        KNOWHERE_CONFIG_DECLARE_FIELD(seismic_n_postings)
+            .description("max number of postings kept in each posting list")
+            .set_default(4000)
+            .set_range(1, std::numeric_limits<CFG_INT::value_type>::max())
+            .for_train();
+        KNOWHERE_CONFIG_DECLARE_FIELD(seismic_centroid_fraction)
+            .description("number of blocks of each posting list, as a fraction of its size")
+            .set_default(0.1f)
+            .set_range(0.0f, 1.0f, false, true)
+            .for_train();
+        KNOWHERE_CONFIG_DECLARE_FIELD(seismic_summary_energy)
+            .description("fraction of the weights of a block kept in its summary")
+            .set_default(0.4f)
+            .set_range(0.0f, 1.0f, false, true)
+            .for_train();
+        /**
+         * SPARSE_SEISMIC skips the blocks whose summary scores below
+         * seismic_heap_factor times the k-th best score found so far. A
+         * smaller value scores more blocks, which is slower and more
+         * accurate.
+         */
+        KNOWHERE_CONFIG_DECLARE_FIELD(seismic_heap_factor)
+            .description("ratio of the k-th best score below which blocks are skipped")
+            .set_default(0.9f)
+            .set_range(0.0f, 1.0f, false, true)
+            .for_search()
+            .for_iterator();
     }
 
     Status
     CheckAndAdjust(PARAM_TYPE param_type, std::string* err_msg) override {
         if (param_type == PARAM_TYPE::TRAIN) {
-            constexpr std::array<std::string_view, 3> legal_inverted_index_algo_list{"TAAT_NAIVE", "DAAT_WAND",
-                                                                                     "DAAT_MAXSCORE"};
+            constexpr std::array<std::string_view, 5> legal_inverted_index_algo_list{
+                "TAAT_NAIVE", "DAAT_WAND", "DAAT_MAXSCORE", "DAAT_BLOCK_MAX_WAND", "DAAT_BLOCK_MAX_MAXSCORE"};
             std::string inverted_index_algo_str = inverted_index_algo.value_or("");
             if (std::find(legal_inverted_index_algo_list.begin(), legal_inverted_index_algo_list.end(),
                           inverted_index_algo_str) == legal_inverted_index_algo_list.end()) {
                 std::string msg = "sparse inverted index algo " + inverted_index_algo_str +
-                                  " not found or not supported, supported: [TAAT_NAIVE DAAT_WAND DAAT_MAXSCORE]";
+                                  " not found or not supported, supported: [TAAT_NAIVE DAAT_WAND DAAT_MAXSCORE "
+                                  "DAAT_BLOCK_MAX_WAND DAAT_BLOCK_MAX_MAXSCORE]";
                 return HandleError(err_msg, msg, Status::invalid_args);
             }
         }
@@ -0,0 +1,877 @@
+// Copyright (C) 2019-2023 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License.
+
+#ifndef SPARSE_SEISMIC_INDEX_H
+#define SPARSE_SEISMIC_INDEX_H
+
+#include <algorithm>
+#include <array>
+#include <boost/core/span.hpp>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+#include "faiss/cppcontrib/knowhere/utils/VisitedTable.h"
+#include "index/sparse/sparse_inverted_index.h"
+
+namespace knowhere::sparse {
+
+struct SeismicBuildParams {
+    // max number of postings kept in each posting list, the ones with the largest values
+    size_t n_postings;
+    // the postings of a dim are clustered into ceil(centroid_fraction * posting_list_size) blocks
+    float centroid_fraction;
+    // summaries keep the largest weights of a block up to this fraction of the sum of its weights
+    float summary_energy;
+};
+
+enum class SeismicIndexSectionType : uint32_t {
+    DIM_MAP = 0,
+    FORWARD_INDEX = 1,
+    POSTING_LISTS = 2,
+    SUMMARIES = 3,
+};
+
+// Approximate sparse retrieval with clustered posting lists, after Seismic (Bruch et al., "Efficient Inverted Indexes
+// for Approximate Retrieval over Learned Sparse Representations", SIGIR 2024).
+//
+// Each posting list is statically pruned to the postings with the largest values, then its docs are clustered into
+// blocks of similar docs. Every block has a summary, the max weight of each dim over the docs of the block, pruned
+// and quantized to 8 bits. A search visits the posting lists of the query dims from the largest query value down, and
+// skips the blocks whose summary scores below heap_factor times the current k-th score. The docs of the other blocks
+// are scored exactly with the forward index, which keeps every row.
+//
+// Only IP is supported, and doc values are expected to be non-negative, as in learned sparse embeddings. A posting
+// list only depends on the rows that have its dim, so Add() clusters again just the posting lists of the dims of the
+// added rows, over all rows added so far, and keeps the others. An Add() thus costs as much as clustering the full
+// posting lists of every dim it touches, and since a small batch of rows usually touches the common dims, frequent
+// small Adds are best batched. A deserialized index refers to the serialized data, which may be mmapped, and does
+// not support Add().
+template <typename DType>
+class SeismicIndex : public BaseInvertedIndex<DType> {
+ public:
+    explicit SeismicIndex(const SeismicBuildParams& params)
+        : params_(params),
+          row_offsets_(1, 0),
+          dim_block_offsets_(1, 0),
+          block_doc_offsets_(1, 0),
+          summary_offsets_(1, 0) {
+        update_spans();
+    }
+
+    Status
+    SerializeV0(IOWriter& writer) const override {
+        return Status::not_implemented;
+    }
+
+    Status
+    DeserializeV0(MemoryIOReader& reader, int map_flags, const std::string& supplement_target_filename) override {
+        return Status::not_implemented;
+    }
+
+    Status
+    Serialize(IOWriter& writer) const override {
+        // Serialized format:
+        // 1. Index File Header (32 bytes):
+        //    - index_format_version (uint32_t): Version of the index format, currently 1
+        //    - nr_rows (uint32_t): Number of rows in the index
+        //    - max_dim (uint32_t): Number of columns, or maximum dimension ID
+        //    - nr_inner_dims (uint32_t): Number of inner dimensions
+        //    - nr_blocks (uint32_t): Number of blocks of all posting lists
+        //    - reserved (12 bytes): Reserved for future use
+        //
+        // 2. Section Headers Table:
+        //    - nr_sections (uint32_t): Number of sections, followed by 4 bytes of padding
+        //    - section_headers[nr_sections]: Array of InvertedIndexSectionHeader, with a SeismicIndexSectionType
+        //
+        // 3. Dimension Map Section:
+        //    - dim_map_reverse[nr_inner_dims] (uint32_t): Original dimension of each inner dimension
+        //
+        // 4. Forward Index Section:
+        //    - row_offsets[nr_rows + 1] (uint64_t), dims[nnz] (uint32_t, inner dimensions), vals[nnz] (float)
+        //
+        // 5. Posting Lists Section:
+        //    - dim_block_offsets[nr_inner_dims + 1] (uint64_t): Blocks of each posting list
+        //    - block_doc_offsets[nr_blocks + 1] (uint64_t): Docs of each block
+        //    - doc_ids[nr_postings] (uint32_t)
+        //
+        // 6. Summaries Section:
+        //    - summary_offsets[nr_blocks + 1] (uint64_t), summary_scales[nr_blocks] (float),
+        //      summary_dims[nr_summary_entries] (uint32_t, inner dimensions), summary_vals[nr_summary_entries]
+        //      (uint8_t, the weight divided by the scale of the block)
+        //
+        // Every section starts at a multiple of 8 bytes, so that the arrays mapped from it are aligned.
+        const uint32_t index_format_version = 1;
+        const uint32_t nr_rows = n_rows_;
+        const uint32_t max_dim = max_dim_;
+        const uint32_t nr_inner_dims = nr_inner_dims_;
+        const uint32_t nr_blocks = this->nr_blocks();
+        writer.write(&index_format_version, sizeof(uint32_t));
+        writer.write(&nr_rows, sizeof(uint32_t));
+        writer.write(&max_dim, sizeof(uint32_t));
+        writer.write(&nr_inner_dims, sizeof(uint32_t));
+        writer.write(&nr_blocks, sizeof(uint32_t));
+        auto reserved = std::array<uint8_t, index_file_header_reserved_size>();
+        writer.write(reserved.data(), reserved.size());
+
+        const uint32_t nr_sections = 4;
+        const uint32_t padding = 0;
+        writer.write(&nr_sections, sizeof(uint32_t));
+        writer.write(&padding, sizeof(uint32_t));
+
+        const uint64_t section_sizes[nr_sections] = {
+            aligned_size(sizeof(uint32_t) * nr_inner_dims_),
+            aligned_size(sizeof(uint64_t) * row_offsets_span_.size() + sizeof(uint32_t) * fwd_dims_span_.size() +
+                         sizeof(float) * fwd_vals_span_.size()),
+            aligned_size(sizeof(uint64_t) * (dim_block_offsets_span_.size() + block_doc_offsets_span_.size()) +
+                         sizeof(uint32_t) * doc_ids_span_.size()),
+            aligned_size(sizeof(uint64_t) * summary_offsets_span_.size() + sizeof(float) * summary_scales_span_.size() +
+                         sizeof(uint32_t) * summary_dims_span_.size() + sizeof(uint8_t) * summary_vals_span_.size()),
+        };
+        const SeismicIndexSectionType section_types[nr_sections] = {
+            SeismicIndexSectionType::DIM_MAP, SeismicIndexSectionType::FORWARD_INDEX,
+            SeismicIndexSectionType::POSTING_LISTS, SeismicIndexSectionType::SUMMARIES};
+        std::vector<InvertedIndexSectionHeader> section_headers(nr_sections);
+        uint64_t used_offset =
+            index_file_header_size + 2 * sizeof(uint32_t) + sizeof(InvertedIndexSectionHeader) * nr_sections;
+        for (uint32_t i = 0; i < nr_sections; ++i) {
+            section_headers[i].type = static_cast<InvertedIndexSectionType>(section_types[i]);
+            section_headers[i].offset = used_offset;
+            section_headers[i].size = section_sizes[i];
+            used_offset += section_sizes[i];
+        }
+        writer.write(section_headers.data(), sizeof(InvertedIndexSectionHeader), nr_sections);
+
+        auto dim_map_reverse = std::vector<uint32_t>(nr_inner_dims_);
+        for (const auto& [dim, dim_id] : dim_map_) {
+            dim_map_reverse[dim_id] = dim;
+        }
+        uint64_t written = 0;
+        write_array(writer, dim_map_reverse, written);
+        write_padding(writer, written);
+
+        write_array(writer, row_offsets_span_, written);
+        write_array(writer, fwd_dims_span_, written);
+        write_array(writer, fwd_vals_span_, written);
+        write_padding(writer, written);
+
+        write_array(writer, dim_block_offsets_span_, written);
+        write_array(writer, block_doc_offsets_span_, written);
+        write_array(writer, doc_ids_span_, written);
+        write_padding(writer, written);
+
+        write_array(writer, summary_offsets_span_, written);
+        write_array(writer, summary_scales_span_, written);
+        write_array(writer, summary_dims_span_, written);
+        write_array(writer, summary_vals_span_, written);
+        write_padding(writer, written);
+
+        return Status::success;
+    }
+
+    Status
+    Deserialize(MemoryIOReader& reader) override {
+        uint32_t index_format_version = 0;
+        reader.read(&index_format_version, sizeof(uint32_t));
+        if (index_format_version != 1) {
+            return Status::invalid_serialized_index_type;
+        }
+        uint32_t nr_rows = 0;
+        uint32_t max_dim = 0;
+        uint32_t nr_blocks = 0;
+        reader.read(&nr_rows, sizeof(uint32_t));
+        reader.read(&max_dim, sizeof(uint32_t));
+        reader.read(&nr_inner_dims_, sizeof(uint32_t));
+        reader.read(&nr_blocks, sizeof(uint32_t));
+        reader.advance(index_file_header_reserved_size);
+        n_rows_ = nr_rows;
+        max_dim_ = max_dim;
+
+        uint32_t nr_sections = 0;
+        reader.read(&nr_sections, sizeof(uint32_t));
+        reader.advance(sizeof(uint32_t));
+        std::vector<InvertedIndexSectionHeader> section_headers(nr_sections);
+        reader.read(section_headers.data(), sizeof(InvertedIndexSectionHeader) * nr_sections);
+
+        for (const auto& section_header : section_headers) {
+            reader.seekg(section_header.offset);
+            switch (static_cast<SeismicIndexSectionType>(section_header.type)) {
+                case SeismicIndexSectionType::DIM_MAP: {
+                    for (uint32_t i = 0; i < nr_inner_dims_; ++i) {
+                        uint32_t dim = 0;
+                        reader.read(&dim, sizeof(uint32_t));
+                        dim_map_[dim] = i;
+                    }
+                    break;
+                }
+                case SeismicIndexSectionType::FORWARD_INDEX: {
+                    row_offsets_span_ = map_array<uint64_t>(reader, n_rows_ + 1);
+                    fwd_dims_span_ = map_array<uint32_t>(reader, row_offsets_span_[n_rows_]);
+                    fwd_vals_span_ = map_array<float>(reader, row_offsets_span_[n_rows_]);
+                    break;
+                }
+                case SeismicIndexSectionType::POSTING_LISTS: {
+                    dim_block_offsets_span_ = map_array<uint64_t>(reader, nr_inner_dims_ + 1);
+                    block_doc_offsets_span_ = map_array<uint64_t>(reader, nr_blocks + 1);
+                    doc_ids_span_ = map_array<uint32_t>(reader, block_doc_offsets_span_[nr_blocks]);
+                    break;
+                }
+                case SeismicIndexSectionType::SUMMARIES: {
+                    summary_offsets_span_ = map_array<uint64_t>(reader, nr_blocks + 1);
+                    summary_scales_span_ = map_array<float>(reader, nr_blocks);
+                    summary_dims_span_ = map_array<uint32_t>(reader, summary_offsets_span_[nr_blocks]);
+                    summary_vals_span_ = map_array<uint8_t>(reader, summary_offsets_span_[nr_blocks]);
+                    break;
+                }
+                default:
+                    // skip unknown sections
+                    break;
+            }
+        }
+        is_deserialized_ = true;
+        return Status::success;
+    }
+
+    Status
+    Train(const SparseRow<DType>* data, size_t rows) override {
+        return Status::success;
+    }
+
+    Status
+    Add(const SparseRow<DType>* data, size_t rows, int64_t dim, bool use_build_pool) override {
+        if (is_deserialized_) {
+            throw std::invalid_argument("deserialized SeismicIndex does not support Add");
+        }
+        if ((size_t)dim > max_dim_) {
+            max_dim_ = dim;
+        }
+        for (size_t i = 0; i < rows; ++i) {
+            for (size_t j = 0; j < data[i].size(); ++j) {
+                auto [row_dim, val] = data[i][j];
+                if (val == 0) {
+                    continue;
+                }
+                auto dim_it = dim_map_.find(row_dim);
+                if (dim_it == dim_map_.cend()) {
+                    dim_it = dim_map_.insert({row_dim, nr_inner_dims_++}).first;
+                }
+                fwd_dims_.push_back(dim_it->second);
+                fwd_vals_.push_back(static_cast<float>(val));
+            }
+            row_offsets_.push_back(fwd_dims_.size());
+        }
+        const size_t first_row = n_rows_;
+        n_rows_ += rows;
+
+        auto pool = use_build_pool ? ThreadPool::GetGlobalBuildThreadPool() : nullptr;
+        build_posting_lists(first_row, pool.get());
+        update_spans();
+        return Status::success;
+    }
+
+    std::unique_ptr<BaseInvertedIndex<DType>>
+    CreateReadView() override {
+        throw std::invalid_argument("SeismicIndex does not support CreateReadView");
+    }
+
+    // posting lists are ordered by block rather than by doc id, so they are neither compressed nor reordered.
+    void
+    SetPostingListEncoding(PostingListEncoding encoding) override {
+    }
+
+    void
+    SetDocReorder(bool enable) override {
+    }
+
+    void
+    Search(const SparseRow<DType>& query, size_t k, float* distances, label_t* labels, const BitsetView& bitset,
+           const DocValueComputer<float>& computer, InvertedIndexApproxSearchParams& approx_params) const override {
+        std::fill(distances, distances + k, std::numeric_limits<float>::quiet_NaN());
+        std::fill(labels, labels + k, -1);
+        auto q_vec = parse_query(query, approx_params.drop_ratio_search);
+        if (q_vec.empty()) {
+            return;
+        }
+        // the lists of the largest query values first, as their docs are the most likely to make the top-k
+        std::sort(q_vec.begin(), q_vec.end(), [](const auto& a, const auto& b) { return a.second > b.second; });
+
+        auto buffers = search_buffers_pool_.acquire(nr_inner_dims_, n_rows_);
+        float* q_dense = buffers->q_dense.data();
+        for (const auto& [dim_id, val] : q_vec) {
+            q_dense[dim_id] = val;
+        }
+        auto& visited = buffers->visited;
+
+        MaxMinHeap<float> heap(k);
+        for (const auto& [dim_id, q_val] : q_vec) {
+            for (size_t block = dim_block_offsets_span_[dim_id]; block < dim_block_offsets_span_[dim_id + 1];
+                 ++block) {
+                if (heap.full() && summary_score(block, q_dense) < approx_params.heap_factor * heap.top().val) {
+                    continue;
+                }
+                for (size_t i = block_doc_offsets_span_[block]; i < block_doc_offsets_span_[block + 1]; ++i) {
+                    const auto doc_id = doc_ids_span_[i];
+                    if (visited.get(doc_id)) {
+                        continue;
+                    }
+                    visited.set(doc_id);
+                    if (!bitset.empty() && bitset.test(doc_id)) {
+                        continue;
+                    }
+                    heap.push(doc_id, row_score(doc_id, q_dense));
+                }
+            }
+        }
+
+        for (const auto& [dim_id, val] : q_vec) {
+            q_dense[dim_id] = 0.0f;
+        }
+        int cnt = heap.size();
+        for (auto i = cnt - 1; i >= 0; --i) {
+            labels[i] = heap.top().id;
+            distances[i] = heap.top().val;
+            heap.pop();
+        }
+    }
+
+    void
+    SearchBatch(const SparseRow<DType>* queries, size_t nq, size_t k, float* distances, label_t* labels,
+                const BitsetView& bitset, const DocValueComputer<float>& computer,
+                InvertedIndexApproxSearchParams& approx_params) const override {
+        for (size_t i = 0; i < nq; ++i) {
+            Search(queries[i], k, distances + i * k, labels + i * k, bitset, computer, approx_params);
+        }
+    }
+
+    // distances are exact, computed with the forward index.
+    std::vector<float>
+    GetAllDistances(const SparseRow<DType>& query, float drop_ratio_search, const BitsetView& bitset,
+                    const DocValueComputer<float>& computer) const override {
+        auto q_vec = parse_query(query, drop_ratio_search);
+        if (q_vec.empty()) {
+            return {};
+        }
+        auto buffers = search_buffers_pool_.acquire(nr_inner_dims_, 0);
+        float* q_dense = buffers->q_dense.data();
+        for (const auto& [dim_id, val] : q_vec) {
+            q_dense[dim_id] = val;
+        }
+        std::vector<float> distances(n_rows_, 0.0f);
+        for (size_t i = 0; i < n_rows_; ++i) {
+            if (bitset.empty() || !bitset.test(i)) {
+                distances[i] = row_score(i, q_dense);
+            }
+        }
+        for (const auto& [dim_id, val] : q_vec) {
+            q_dense[dim_id] = 0.0f;
+        }
+        return distances;
+    }
+
+    float
+    GetRawDistance(const label_t vec_id, const SparseRow<DType>& query,
+                   const DocValueComputer<float>& computer) const override {
+        auto q_vec = parse_query(query, 0);
+        float distance = 0.0f;
+        for (size_t i = row_offsets_span_[vec_id]; i < row_offsets_span_[vec_id + 1]; ++i) {
+            for (const auto& [dim_id, val] : q_vec) {
+                if (dim_id == fwd_dims_span_[i]) {
+                    distance += val * fwd_vals_span_[i];
+                }
+            }
+        }
+        return distance;
+    }
+
+    expected<DocValueComputer<float>>
+    GetDocValueComputer(const SparseInvertedIndexConfig& cfg) const override {
+        auto metric_type = cfg.metric_type;
+        if (metric_type.has_value() && !IsMetricType(metric_type.value(), metric::IP)) {
+            auto msg = "metric type not match, expected: " + std::string(metric::IP) + ", got: " + metric_type.value();
+            return expected<DocValueComputer<float>>::Err(Status::invalid_metric_type, msg);
+        }
+        return GetDocValueOriginalComputer<float>();
+    }
+
+    [[nodiscard]] size_t
+    size() const override {
+        size_t res = sizeof(*this);
+        res += dim_map_.size() *
+               (sizeof(typename decltype(dim_map_)::key_type) + sizeof(typename decltype(dim_map_)::mapped_type));
+        res += sizeof(uint64_t) * (row_offsets_span_.size() + dim_block_offsets_span_.size() +
+                                   block_doc_offsets_span_.size() + summary_offsets_span_.size());
+        res += sizeof(uint32_t) * (fwd_dims_span_.size() + doc_ids_span_.size() + summary_dims_span_.size());
+        res += sizeof(float) * (fwd_vals_span_.size() + summary_scales_span_.size());
+        res += sizeof(uint8_t) * summary_vals_span_.size();
+        return res;
+    }
+
+    [[nodiscard]] size_t
+    n_rows() const override {
+        return n_rows_;
+    }
+
+    [[nodiscard]] size_t
+    n_cols() const override {
+        return max_dim_;
+    }
+
+ private:
+    // the blocks of a posting list and their summaries, built by cluster_posting_list()
+    struct ClusteredPostingList {
+        std::vector<uint32_t> doc_ids;
+        // offsets of the blocks in doc_ids, with an extra one for the end of the last block
+        std::vector<uint64_t> block_offsets;
+        std::vector<uint64_t> summary_offsets;
+        std::vector<float> summary_scales;
+        std::vector<uint32_t> summary_dims;
+        std::vector<uint8_t> summary_vals;
+    };
+
+    // the buffers of a search: the query as a dense vector over inner dims, all zeros between searches, and the
+    // docs scored by the search.
+    struct SearchBuffers {
+        std::vector<float> q_dense;
+        faiss::cppcontrib::knowhere::EpochVisitedTable visited;
+
+        size_t
+        bytes() const {
+            return q_dense.capacity() * sizeof(float) + visited.capacity;
+        }
+    };
+
+    // A pool of search buffers that belongs to the index, like the visited tables of HNSW. A search takes buffers
+    // for its duration and returns them, and the pool keeps idle buffers for reuse as long as they take no more than
+    // max_idle_bytes. They are freed with the index.
+    class SearchBuffersPool {
+     public:
+        static constexpr size_t max_idle_bytes = size_t(256) << 20;
+
+        struct Release {
+            SearchBuffersPool* pool;
+
+            void
+            operator()(SearchBuffers* buffers) const {
+                pool->release(std::unique_ptr<SearchBuffers>(buffers));
+            }
+        };
+        using Handle = std::unique_ptr<SearchBuffers, Release>;
+
+        // returns buffers for nr_dims inner dims with no doc of the first n_rows visited.
+        Handle
+        acquire(size_t nr_dims, size_t n_rows) {
+            std::unique_ptr<SearchBuffers> buffers;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (!idle_.empty()) {
+                    buffers = std::move(idle_.back());
+                    idle_.pop_back();
+                    idle_bytes_ -= buffers->bytes();
+                }
+            }
+            if (buffers == nullptr) {
+                buffers = std::make_unique<SearchBuffers>();
+            }
+            if (buffers->q_dense.size() < nr_dims) {
+                buffers->q_dense.resize(nr_dims, 0.0f);
+            }
+            buffers->visited.resize(n_rows);
+            buffers->visited.clear();
+            return Handle(buffers.release(), Release{this});
+        }
+
+     private:
+        // buffers that are not kept are freed after the lock is released
+        void
+        release(std::unique_ptr<SearchBuffers> buffers) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (idle_bytes_ + buffers->bytes() <= max_idle_bytes) {
+                idle_bytes_ += buffers->bytes();
+                idle_.push_back(std::move(buffers));
+            }
+        }
+
+        std::mutex mutex_;
+        std::vector<std::unique_ptr<SearchBuffers>> idle_;
+        size_t idle_bytes_ = 0;
+    };
+
+    std::vector<std::pair<uint32_t, float>>
+    parse_query(const SparseRow<DType>& query, float drop_ratio_search) const {
+        DType q_threshold = 0;
+        if (drop_ratio_search != 0 && query.size() > 0) {
+            std::vector<DType> values(query.size());
+            for (size_t i = 0; i < query.size(); ++i) {
+                values[i] = std::abs(query[i].val);
+            }
+            auto drop_count = static_cast<size_t>(drop_ratio_search * values.size());
+            if (drop_count > 0) {
+                std::nth_element(values.begin(), values.begin() + drop_count, values.end());
+                q_threshold = values[drop_count];
+            }
+        }
+        std::vector<std::pair<uint32_t, float>> q_vec;
+        for (size_t i = 0; i < query.size(); ++i) {
+            auto [dim, val] = query[i];
+            auto dim_it = dim_map_.find(dim);
+            if (dim_it == dim_map_.cend() || val == 0 || std::abs(val) < q_threshold) {
+                continue;
+            }
+            q_vec.emplace_back(dim_it->second, static_cast<float>(val));
+        }
+        return q_vec;
+    }
+
+    inline float
+    row_score(size_t doc_id, const float* q_dense) const {
+        float score = 0.0f;
+        for (size_t i = row_offsets_span_[doc_id]; i < row_offsets_span_[doc_id + 1]; ++i) {
+            score += q_dense[fwd_dims_span_[i]] * fwd_vals_span_[i];
+        }
+        return score;
+    }
+
+    inline float
+    summary_score(size_t block, const float* q_dense) const {
+        float score = 0.0f;
+        for (size_t i = summary_offsets_span_[block]; i < summary_offsets_span_[block + 1]; ++i) {
+            score += q_dense[summary_dims_span_[i]] * summary_vals_span_[i];
+        }
+        return score * summary_scales_span_[block];
+    }
+
+    // clusters the posting lists of the dims of rows [first_row, n_rows_) again from the forward index, and keeps
+    // the blocks of the other dims, whose postings didn't change. With a pool, the posting lists are clustered by
+    // its tasks.
+    void
+    build_posting_lists(size_t first_row, ThreadPool* pool) {
+        // every dim that is new since the last build is one of the added rows
+        std::vector<bool> affected(nr_inner_dims_, false);
+        for (size_t i = row_offsets_[first_row]; i < fwd_dims_.size(); ++i) {
+            affected[fwd_dims_[i]] = true;
+        }
+        std::vector<uint32_t> affected_dims;
+        for (uint32_t dim_id = 0; dim_id < nr_inner_dims_; ++dim_id) {
+            if (affected[dim_id]) {
+                affected_dims.push_back(dim_id);
+            }
+        }
+
+        // full posting lists of the affected dims as (doc id, value), grouped by dim with a counting pass
+        std::vector<uint64_t> plist_offsets(nr_inner_dims_ + 1, 0);
+        for (auto dim_id : fwd_dims_) {
+            if (affected[dim_id]) {
+                plist_offsets[dim_id + 1]++;
+            }
+        }
+        for (size_t i = 0; i < nr_inner_dims_; ++i) {
+            plist_offsets[i + 1] += plist_offsets[i];
+        }
+        std::vector<std::pair<uint32_t, float>> postings(plist_offsets.back());
+        {
+            std::vector<uint64_t> locs(plist_offsets.begin(), plist_offsets.end() - 1);
+            for (size_t doc_id = 0; doc_id < n_rows_; ++doc_id) {
+                for (size_t i = row_offsets_[doc_id]; i < row_offsets_[doc_id + 1]; ++i) {
+                    if (affected[fwd_dims_[i]]) {
+                        postings[locs[fwd_dims_[i]]++] = {static_cast<uint32_t>(doc_id), fwd_vals_[i]};
+                    }
+                }
+            }
+        }
+
+        std::vector<ClusteredPostingList> clustered(affected_dims.size());
+        auto cluster_dims = [&](size_t begin, size_t step) {
+            for (size_t j = begin; j < affected_dims.size(); j += step) {
+                const auto i = affected_dims[j];
+                clustered[j] = cluster_posting_list(i, postings.data() + plist_offsets[i],
+                                                    plist_offsets[i + 1] - plist_offsets[i]);
+            }
+        };
+        const size_t nr_tasks =
+            pool == nullptr ? 1 : std::max<size_t>(std::min<size_t>(pool->size(), affected_dims.size()), 1);
+        if (nr_tasks == 1) {
+            cluster_dims(0, 1);
+        } else {
+            std::vector<folly::Future<folly::Unit>> futures;
+            futures.reserve(nr_tasks);
+            for (size_t t = 0; t < nr_tasks; ++t) {
+                futures.emplace_back(pool->push([&, t] { cluster_dims(t, nr_tasks); }));
+            }
+            WaitAllSuccess(futures);
+        }
+
+        // the blocks of all dims in order, the ones of the dims that are not affected copied from the current lists
+        std::vector<uint64_t> dim_block_offsets(1, 0);
+        std::vector<uint64_t> block_doc_offsets(1, 0);
+        std::vector<uint64_t> summary_offsets(1, 0);
+        std::vector<uint32_t> doc_ids;
+        std::vector<float> summary_scales;
+        std::vector<uint32_t> summary_dims;
+        std::vector<uint8_t> summary_vals;
+        doc_ids.reserve(doc_ids_.size());
+        summary_dims.reserve(summary_dims_.size());
+        summary_vals.reserve(summary_vals_.size());
+        for (size_t dim_id = 0, j = 0; dim_id < nr_inner_dims_; ++dim_id) {
+            if (affected[dim_id]) {
+                auto& plist = clustered[j++];
+                for (size_t b = 0; b + 1 < plist.block_offsets.size(); ++b) {
+                    block_doc_offsets.push_back(doc_ids.size() + plist.block_offsets[b + 1]);
+                    summary_offsets.push_back(summary_dims.size() + plist.summary_offsets[b + 1]);
+                }
+                doc_ids.insert(doc_ids.end(), plist.doc_ids.begin(), plist.doc_ids.end());
+                summary_scales.insert(summary_scales.end(), plist.summary_scales.begin(), plist.summary_scales.end());
+                summary_dims.insert(summary_dims.end(), plist.summary_dims.begin(), plist.summary_dims.end());
+                summary_vals.insert(summary_vals.end(), plist.summary_vals.begin(), plist.summary_vals.end());
+                plist = ClusteredPostingList();
+            } else {
+                for (size_t b = dim_block_offsets_[dim_id]; b < dim_block_offsets_[dim_id + 1]; ++b) {
+                    doc_ids.insert(doc_ids.end(), doc_ids_.begin() + block_doc_offsets_[b],
+                                   doc_ids_.begin() + block_doc_offsets_[b + 1]);
+                    block_doc_offsets.push_back(doc_ids.size());
+                    summary_scales.push_back(summary_scales_[b]);
+                    summary_dims.insert(summary_dims.end(), summary_dims_.begin() + summary_offsets_[b],
+                                        summary_dims_.begin() + summary_offsets_[b + 1]);
+                    summary_vals.insert(summary_vals.end(), summary_vals_.begin() + summary_offsets_[b],
+                                        summary_vals_.begin() + summary_offsets_[b + 1]);
+                    summary_offsets.push_back(summary_dims.size());
+                }
+            }
+            dim_block_offsets.push_back(block_doc_offsets.size() - 1);
+        }
+        dim_block_offsets_.swap(dim_block_offsets);
+        block_doc_offsets_.swap(block_doc_offsets);
+        summary_offsets_.swap(summary_offsets);
+        doc_ids_.swap(doc_ids);
+        summary_scales_.swap(summary_scales);
+        summary_dims_.swap(summary_dims);
+        summary_vals_.swap(summary_vals);
+    }
+
+    // prunes the posting list postings[0, n) of dim_id, clusters its docs into blocks and summarizes the blocks.
+    ClusteredPostingList
+    cluster_posting_list(size_t dim_id, std::pair<uint32_t, float>* postings, size_t n) const {
+        ClusteredPostingList plist;
+        plist.block_offsets.push_back(0);
+        plist.summary_offsets.push_back(0);
+        if (n == 0) {
+            return plist;
+        }
+        // static pruning: keep the postings with the largest values
+        if (n > params_.n_postings) {
+            std::nth_element(postings, postings + params_.n_postings, postings + n,
+                             [](const auto& a, const auto& b) { return a.second > b.second; });
+            n = params_.n_postings;
+        }
+
+        // clustering: random docs of the list are the centroids, and each doc goes to the most similar centroid
+        const size_t n_blocks =
+            std::clamp<size_t>(static_cast<size_t>(std::ceil(params_.centroid_fraction * n)), 1, n);
+        std::vector<uint32_t> docs(n);
+        for (size_t i = 0; i < n; ++i) {
+            docs[i] = postings[i].first;
+        }
+        std::sort(docs.begin(), docs.end());
+        std::vector<uint32_t> centroids(docs);
+        std::mt19937 rng(dim_id);
+        std::shuffle(centroids.begin(), centroids.end(), rng);
+        centroids.resize(n_blocks);
+
+        // dims of the centroids as (centroid, value), to score a doc against all centroids at once
+        std::unordered_map<uint32_t, std::vector<std::pair<uint32_t, float>>> centroid_dims;
+        for (uint32_t c = 0; c < n_blocks; ++c) {
+            for (size_t i = row_offsets_[centroids[c]]; i < row_offsets_[centroids[c] + 1]; ++i) {
+                centroid_dims[fwd_dims_[i]].emplace_back(c, fwd_vals_[i]);
+            }
+        }
+        std::vector<uint32_t> assignment(n);
+        std::vector<float> centroid_scores(n_blocks);
+        std::vector<uint64_t> block_sizes(n_blocks + 1, 0);
+        for (size_t d = 0; d < n; ++d) {
+            std::fill(centroid_scores.begin(), centroid_scores.end(), 0.0f);
+            for (size_t i = row_offsets_[docs[d]]; i < row_offsets_[docs[d] + 1]; ++i) {
+                auto it = centroid_dims.find(fwd_dims_[i]);
+                if (it == centroid_dims.end()) {
+                    continue;
+                }
+                for (const auto& [c, val] : it->second) {
+                    centroid_scores[c] += val * fwd_vals_[i];
+                }
+            }
+            assignment[d] = std::max_element(centroid_scores.begin(), centroid_scores.end()) - centroid_scores.begin();
+            block_sizes[assignment[d] + 1]++;
+        }
+
+        // blocks keep their docs in id order, empty blocks are dropped
+        for (size_t c = 0; c < n_blocks; ++c) {
+            block_sizes[c + 1] += block_sizes[c];
+        }
+        plist.doc_ids.resize(n);
+        {
+            std::vector<uint64_t> locs(block_sizes.begin(), block_sizes.end() - 1);
+            for (size_t d = 0; d < n; ++d) {
+                plist.doc_ids[locs[assignment[d]]++] = docs[d];
+            }
+        }
+
+        std::unordered_map<uint32_t, float> summary;
+        std::vector<std::pair<uint32_t, float>> summary_entries;
+        for (size_t c = 0; c < n_blocks; ++c) {
+            if (block_sizes[c + 1] == block_sizes[c]) {
+                continue;
+            }
+            plist.block_offsets.push_back(block_sizes[c + 1]);
+
+            // the max weight of each dim over the docs of the block
+            summary.clear();
+            for (size_t d = block_sizes[c]; d < block_sizes[c + 1]; ++d) {
+                const auto doc_id = plist.doc_ids[d];
+                for (size_t i = row_offsets_[doc_id]; i < row_offsets_[doc_id + 1]; ++i) {
+                    auto& weight = summary[fwd_dims_[i]];
+                    weight = std::max(weight, fwd_vals_[i]);
+                }
+            }
+            summary_entries.assign(summary.begin(), summary.end());
+            std::sort(summary_entries.begin(), summary_entries.end(),
+                      [](const auto& a, const auto& b) { return a.second > b.second; });
+            float total = 0.0f;
+            for (const auto& [dim, weight] : summary_entries) {
+                total += weight;
+            }
+            // keep the largest weights up to summary_energy of the total, at least one
+            float kept = 0.0f;
+            size_t n_kept = 0;
+            while (n_kept < summary_entries.size() && (n_kept == 0 || kept < params_.summary_energy * total)) {
+                kept += summary_entries[n_kept++].second;
+            }
+            summary_entries.resize(n_kept);
+
+            // weights are rounded up when quantized, so that a summary doesn't underestimate the weights it keeps
+            const float scale = summary_entries[0].second > 0 ? summary_entries[0].second / 255.0f : 1.0f;
+            plist.summary_scales.push_back(scale);
+            for (const auto& [dim, weight] : summary_entries) {
+                plist.summary_dims.push_back(dim);
+                plist.summary_vals.push_back(
+                    static_cast<uint8_t>(std::clamp(std::ceil(weight / scale), 0.0f, 255.0f)));
+            }
+            plist.summary_offsets.push_back(plist.summary_dims.size());
+        }
+        return plist;
+    }
+
+    void
+    update_spans() {
+        row_offsets_span_ = boost::span<const uint64_t>(row_offsets_.data(), row_offsets_.size());
+        fwd_dims_span_ = boost::span<const uint32_t>(fwd_dims_.data(), fwd_dims_.size());
+        fwd_vals_span_ = boost::span<const float>(fwd_vals_.data(), fwd_vals_.size());
+        dim_block_offsets_span_ = boost::span<const uint64_t>(dim_block_offsets_.data(), dim_block_offsets_.size());
+        block_doc_offsets_span_ = boost::span<const uint64_t>(block_doc_offsets_.data(), block_doc_offsets_.size());
+        doc_ids_span_ = boost::span<const uint32_t>(doc_ids_.data(), doc_ids_.size());
+        summary_offsets_span_ = boost::span<const uint64_t>(summary_offsets_.data(), summary_offsets_.size());
+        summary_scales_span_ = boost::span<const float>(summary_scales_.data(), summary_scales_.size());
+        summary_dims_span_ = boost::span<const uint32_t>(summary_dims_.data(), summary_dims_.size());
+        summary_vals_span_ = boost::span<const uint8_t>(summary_vals_.data(), summary_vals_.size());
+    }
+
+    size_t
+    nr_blocks() const {
+        return block_doc_offsets_span_.empty() ? 0 : block_doc_offsets_span_.size() - 1;
+    }
+
+    static constexpr uint64_t
+    aligned_size(uint64_t size) {
+        return (size + 7) / 8 * 8;
+    }
+
+    template <typename U>
+    static void
+    write_array(IOWriter& writer, const boost::span<const U>& array, uint64_t& written) {
+        if (!array.empty()) {
+            writer.write(array.data(), sizeof(U), array.size());
+        }
+        written += sizeof(U) * array.size();
+    }
+
+    template <typename U>
+    static void
+    write_array(IOWriter& writer, const std::vector<U>& array, uint64_t& written) {
+        write_array(writer, boost::span<const U>(array.data(), array.size()), written);
+    }
+
+    // pads the current section to a multiple of 8 bytes
+    static void
+    write_padding(IOWriter& writer, uint64_t& written) {
+        const uint64_t padding = 0;
+        if (aligned_size(written) != written) {
+            writer.write(&padding, aligned_size(written) - written);
+        }
+        written = 0;
+    }
+
+    template <typename U>
+    static boost::span<const U>
+    map_array(MemoryIOReader& reader, size_t n) {
+        auto array = boost::span<const U>(reinterpret_cast<const U*>(reader.data() + reader.tellg()), n);
+        reader.advance(sizeof(U) * n);
+        return array;
+    }
+
+    static constexpr uint32_t index_file_header_size = 32;
+    static constexpr uint32_t index_file_header_reserved_size = 12;
+
+    const SeismicBuildParams params_;
+
+    // key is raw sparse vector dim/idx, value is the mapped dim/idx id in the index.
+    std::unordered_map<table_t, uint32_t> dim_map_;
+    uint32_t nr_inner_dims_ = 0;
+    size_t n_rows_ = 0;
+    size_t max_dim_ = 0;
+    // set once loaded, the spans then refer to the serialized data rather than to the vectors below.
+    bool is_deserialized_ = false;
+
+    // forward index: the inner dims and values of each row
+    std::vector<uint64_t> row_offsets_;
+    std::vector<uint32_t> fwd_dims_;
+    std::vector<float> fwd_vals_;
+    // blocks of all posting lists, numbered consecutively: the blocks of inner dim i are
+    // [dim_block_offsets_[i], dim_block_offsets_[i + 1]), and the docs of block b are
+    // doc_ids_[block_doc_offsets_[b], block_doc_offsets_[b + 1]).
+    std::vector<uint64_t> dim_block_offsets_;
+    std::vector<uint64_t> block_doc_offsets_;
+    std::vector<uint32_t> doc_ids_;
+    // the summary of block b is summary_dims_/summary_vals_[summary_offsets_[b], summary_offsets_[b + 1]), whose
+    // weights are summary_vals_ times summary_scales_[b].
+    std::vector<uint64_t> summary_offsets_;
+    std::vector<float> summary_scales_;
+    std::vector<uint32_t> summary_dims_;
+    std::vector<uint8_t> summary_vals_;
+
+    boost::span<const uint64_t> row_offsets_span_;
+    boost::span<const uint32_t> fwd_dims_span_;
+    boost::span<const float> fwd_vals_span_;
+    boost::span<const uint64_t> dim_block_offsets_span_;
+    boost::span<const uint64_t> block_doc_offsets_span_;
+    boost::span<const uint32_t> doc_ids_span_;
+    boost::span<const uint64_t> summary_offsets_span_;
+    boost::span<const float> summary_scales_span_;
+    boost::span<const uint32_t> summary_dims_span_;
+    boost::span<const uint8_t> summary_vals_span_;
+
+    mutable SearchBuffersPool search_buffers_pool_;
+};  // class SeismicIndex
+
+}  // namespace knowhere::sparse
+
+#endif  // SPARSE_SEISMIC_INDEX_H
@@ -0,0 +1,138 @@
+// Copyright (C) 2019-2023 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#include "io/file_io.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstdio>
+#include <cstring>
+
+#include "knowhere/log.h"
+
+namespace knowhere {
+
+FileIOWriter::FileIOWriter(const std::string& filename, bool direct_io, size_t buffer_size)
+    : filename_(filename), tmp_filename_(filename + ".tmp") {
+    constexpr int flags = O_WRONLY | O_CREAT | O_TRUNC;
+    if (direct_io) {
+        fd_ = open(tmp_filename_.c_str(), flags | O_DIRECT, 0644);
+        if (fd_ < 0) {
+            LOG_KNOWHERE_WARNING_ << "Cannot open " << tmp_filename_ << " with O_DIRECT (" << strerror(errno)
+                                  << "), falling back to buffered io";
+        } else {
+            direct_io_ = true;
+        }
+    }
+    if (fd_ < 0) {
+        fd_ = open(tmp_filename_.c_str(), flags, 0644);
+    }
+    if (fd_ < 0) {
+        throw std::runtime_error("Cannot open file " + tmp_filename_ + ": " + strerror(errno));
+    }
+
+    buf_size_ = std::max((buffer_size + kAlignment - 1) / kAlignment * kAlignment, kAlignment);
+    void* buf = nullptr;
+    if (posix_memalign(&buf, kAlignment, buf_size_) != 0) {
+        ::close(fd_);
+        unlink(tmp_filename_.c_str());
+        throw std::bad_alloc();
+    }
+    buf_ = static_cast<uint8_t*>(buf);
+}
+
+FileIOWriter::~FileIOWriter() {
+    if (fd_ >= 0) {
+        LOG_KNOWHERE_WARNING_ << "Discarding " << tmp_filename_ << ", the writer was not closed";
+        ::close(fd_);
+        unlink(tmp_filename_.c_str());
+    }
+    free(buf_);
+}
+
+size_t
+FileIOWriter::operator()(const void* ptr, size_t size, size_t nitems) {
+    auto src = static_cast<const uint8_t*>(ptr);
+    size_t n = size * nitems;
+    total_ += n;
+
+    // large chunks such as raw vectors skip the copy when the page cache does the buffering anyway
+    if (!direct_io_ && buf_pos_ == 0 && n >= buf_size_) {
+        write_fully(src, n);
+        return nitems;
+    }
+    while (n > 0) {
+        size_t len = std::min(n, buf_size_ - buf_pos_);
+        memcpy(buf_ + buf_pos_, src, len);
+        buf_pos_ += len;
+        src += len;
+        n -= len;
+        if (buf_pos_ == buf_size_) {
+            flush(false);
+        }
+    }
+    return nitems;
+}
+
+void
+FileIOWriter::close() {
+    if (fd_ < 0) {
+        return;
+    }
+    flush(true);
+    if (direct_io_ && ftruncate(fd_, total_) != 0) {
+        throw std::runtime_error("Cannot truncate file " + tmp_filename_ + ": " + strerror(errno));
+    }
+    int fd = fd_;
+    fd_ = -1;
+    if (::close(fd) != 0) {
+        unlink(tmp_filename_.c_str());
+        throw std::runtime_error("Cannot close file " + tmp_filename_ + ": " + strerror(errno));
+    }
+    if (std::rename(tmp_filename_.c_str(), filename_.c_str()) != 0) {
+        unlink(tmp_filename_.c_str());
+        throw std::runtime_error("Cannot rename " + tmp_filename_ + " to " + filename_ + ": " + strerror(errno));
+    }
+}
+
+void
+FileIOWriter::flush(bool final) {
+    if (buf_pos_ == 0) {
+        return;
+    }
+    size_t len = buf_pos_;
+    if (direct_io_ && final) {
+        // O_DIRECT only takes whole blocks, the tail is cut off again in close()
+        size_t padded = (len + kAlignment - 1) / kAlignment * kAlignment;
+        memset(buf_ + len, 0, padded - len);
+        len = padded;
+    }
+    write_fully(buf_, len);
+    buf_pos_ = 0;
+}
+
+void
+FileIOWriter::write_fully(const uint8_t* src, size_t n) {
+    while (n > 0) {
+        auto ret = ::write(fd_, src, n);
+        if (ret < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::runtime_error("Cannot write file " + filename_ + ": " + strerror(errno));
+        }
+        src += ret;
+        n -= ret;
+    }
+}
+
+}  // namespace knowhere
@@ -16,6 +16,8 @@
 #include <stdexcept>
 #include <string>
 
+#include "io/memory_io.h"
+
 namespace knowhere {
 struct FileReader {
     FileReader(const std::string& filename, bool auto_remove = false) {
@@ -73,4 +75,53 @@ struct FileReader {
     int fd_ = -1;
     size_t size_;
 };
+
+// Streams a serialized index straight to a file through one aligned buffer, so that saving an index never needs a
+// second in-memory copy of it. With direct_io the file is opened with O_DIRECT and every write is a whole number of
+// blocks; the padding of the last block is truncated away by close(). If the filesystem refuses O_DIRECT, the file is
+// written through the page cache instead.
+//
+// The data goes to `<filename>.tmp`, which close() renames to filename once it is complete, so a failed or interrupted
+// write never leaves a truncated index in place of the previous one.
+struct FileIOWriter : public IOWriter {
+    static constexpr size_t kAlignment = 4096;
+
+    explicit FileIOWriter(const std::string& filename, bool direct_io = false, size_t buffer_size = 4 << 20);
+
+    ~FileIOWriter() override;
+
+    size_t
+    operator()(const void* ptr, size_t size, size_t nitems) override;
+
+    // Flushes the buffer, closes the file and renames it to filename, throws on failure. A writer destroyed without
+    // close() removes its temporary file and leaves filename untouched.
+    void
+    close();
+
+    size_t
+    tellg() const {
+        return total_;
+    }
+
+    bool
+    direct_io() const {
+        return direct_io_;
+    }
+
+ private:
+    void
+    flush(bool final);
+
+    void
+    write_fully(const uint8_t* src, size_t n);
+
+    std::string filename_;
+    std::string tmp_filename_;
+    int fd_ = -1;
+    bool direct_io_ = false;
+    uint8_t* buf_ = nullptr;
+    size_t buf_size_ = 0;
+    size_t buf_pos_ = 0;
+    size_t total_ = 0;
+};
 }  // namespace knowhere
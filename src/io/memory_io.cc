@@ -47,6 +47,15 @@ MemoryIOWriter::operator()(const void* ptr, size_t size, size_t nitems) {
     return nitems;
 }
 
+void
+MemoryIOWriter::reserve(size_t size) {
+    if (data_ != nullptr || size == 0) {
+        return;
+    }
+    total_ = size;
+    data_ = new uint8_t[total_];
+}
+
 size_t
 MemoryIOReader::operator()(void* ptr, size_t size, size_t nitems) {
     if (rp_ >= total_) {
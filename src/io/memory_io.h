@@ -11,7 +11,11 @@
 
 #pragma once
 
+#include <faiss/cppcontrib/knowhere/impl/CountSizeIOWriter.h>
 #include <faiss/impl/io.h>
+#include <faiss/impl/zerocopy_io.h>
+
+#include <memory>
 
 namespace knowhere {
 
@@ -71,14 +75,9 @@ getSwappedBytes(char C) {
 
 #endif
 
-struct MemoryIOWriter : public faiss::IOWriter {
-    uint8_t* data_ = nullptr;
-    size_t total_ = 0;
-    size_t rp_ = 0;
-
-    size_t
-    operator()(const void* ptr, size_t size, size_t nitems) override;
-
+// A faiss::IOWriter with the typed write() used by knowhere's own serializers, so that the same serialization code
+// can target a memory buffer, a file or a byte counter.
+struct IOWriter : public faiss::IOWriter {
     template <typename T>
     size_t
     write(T* ptr, size_t size, size_t nitems = 1) {
@@ -90,6 +89,36 @@ struct MemoryIOWriter : public faiss::IOWriter {
 #endif
         return operator()((const void*)ptr, size, nitems);
     }
+};
+
+// faiss's CountSizeIOWriter behind the typed write() of knowhere's serializers, used to size a MemoryIOWriter exactly
+// before the real pass.
+struct CountingIOWriter : public IOWriter {
+    faiss::cppcontrib::knowhere::CountSizeIOWriter counter_;
+
+    size_t
+    operator()(const void* ptr, size_t size, size_t nitems) override {
+        return counter_(ptr, size, nitems);
+    }
+
+    size_t
+    tellg() const {
+        return counter_.total_size;
+    }
+};
+
+struct MemoryIOWriter : public IOWriter {
+    uint8_t* data_ = nullptr;
+    size_t total_ = 0;
+    size_t rp_ = 0;
+
+    size_t
+    operator()(const void* ptr, size_t size, size_t nitems) override;
+
+    // Allocates the buffer with exactly `size` bytes of capacity, so that writing up to that many bytes never
+    // reallocates. Must be called before anything is written.
+    void
+    reserve(size_t size);
 
     uint8_t*
     data() const {
@@ -102,6 +131,17 @@ struct MemoryIOWriter : public faiss::IOWriter {
     }
 };
 
+// Runs `write` against a CountingIOWriter first and then into `writer` reserved to exactly that many bytes, so the
+// serialized index ends up in a single allocation of the right size instead of a buffer regrown by doubling.
+template <typename WriteFn>
+void
+WriteExactSize(MemoryIOWriter& writer, WriteFn&& write) {
+    CountingIOWriter counter;
+    write(counter);
+    writer.reserve(counter.tellg());
+    write(writer);
+}
+
 struct MemoryIOReader : public faiss::IOReader {
     uint8_t* data_;
     size_t rp_ = 0;
@@ -162,4 +202,23 @@ struct MemoryIOReader : public faiss::IOReader {
     }
 };
 
+// Keeps a serialized blob alive for as long as faiss vectors view into it.
+struct BinaryViewOwner : public faiss::MaybeOwnedVectorOwner {
+    explicit BinaryViewOwner(std::shared_ptr<uint8_t[]> data) : data_(std::move(data)) {
+    }
+
+    std::shared_ptr<uint8_t[]> data_;
+};
+
+// Returns a reader over a serialized blob. With zero_copy, the arrays faiss stores as MaybeOwnedVector (flat codes,
+// inverted lists, HNSW offsets and neighbors) are loaded as views into the blob instead of being copied, and each of
+// them holds a reference to it; everything else is still copied out.
+inline std::unique_ptr<faiss::IOReader>
+CreateBinaryIOReader(const std::shared_ptr<uint8_t[]>& data, size_t size, bool zero_copy) {
+    if (zero_copy) {
+        return std::make_unique<faiss::ZeroCopyIOReader>(data.get(), size, std::make_shared<BinaryViewOwner>(data));
+    }
+    return std::make_unique<MemoryIOReader>(data.get(), size);
+}
+
 }  // namespace knowhere
@@ -0,0 +1,41 @@
+// Copyright (C) 2019-2023 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License.
+
+#pragma once
+
+#include <cstddef>
+
+namespace faiss {
+namespace cppcontrib {
+namespace knowhere {
+
+/// The distance functions of one data type, with the same signatures as the hooks in hook.h. A distance computer
+/// picks a table once with get_distance_kernels() and calls through it, instead of reloading the global hooks for
+/// every distance.
+template <typename DataType>
+struct DistanceKernels {
+    using distance_t = float (*)(const DataType*, const DataType*, size_t);
+    using distance_batch_4_t = void (*)(const DataType*, const DataType*, const DataType*, const DataType*,
+                                        const DataType*, const size_t, float&, float&, float&, float&);
+
+    distance_t inner_product = nullptr;
+    distance_t L2sqr = nullptr;
+    distance_batch_4_t inner_product_batch_4 = nullptr;
+    distance_batch_4_t L2sqr_batch_4 = nullptr;
+};
+
+/// Dimensions with kernels specialized at compile time. They are all multiples of 64, so the specialized kernels
+/// never need a tail.
+#define KNOWHERE_FOR_EACH_FIXED_DIM(X) X(128) X(384) X(768) X(1024) X(1536)
+
+}  // namespace knowhere
+}  // namespace cppcontrib
+}  // namespace faiss
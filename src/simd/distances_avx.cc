@@ -17,6 +17,7 @@
 
 #include <cassert>
 
+#include "distances_fixed_dim.h"
 #include "faiss/impl/platform_macros.h"
 #include "xxhash.h"
 
@@ -880,91 +881,113 @@ bf16_vec_L2sqr_batch_4_avx(const ::knowhere::bf16* x, const ::knowhere::bf16* y0
 ///////////////////////////////////////////////////////////////////////////////
 // int8
 
-FAISS_PRAGMA_IMPRECISE_FUNCTION_BEGIN
-float
-int8_vec_inner_product_avx(const int8_t* x, const int8_t* y, size_t d) {
+namespace {
+inline int32_t
+_mm256_reduce_add_epi32(const __m256i res) {
+    __m128i sum = _mm_add_epi32(_mm256_castsi256_si128(res), _mm256_extracti128_si256(res, 1));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(sum);
+}
+
+// sign-extends 16 int8 to int16
+inline __m256i
+int8_load_epi16(const int8_t* x) {
+    return _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i*)x));
+}
+
+// vpmaddwd sums adjacent int16 products into int32 lanes, which can't overflow for int8 inputs. vpmaddubsw is not
+// used, it takes one unsigned operand and saturates to int16.
+template <bool IP>
+inline __m256i
+int8_madd(const __m256i acc, const __m256i x, const __m256i y) {
+    if constexpr (IP) {
+        return _mm256_add_epi32(acc, _mm256_madd_epi16(x, y));
+    } else {
+        const __m256i diff = _mm256_sub_epi16(x, y);
+        return _mm256_add_epi32(acc, _mm256_madd_epi16(diff, diff));
+    }
+}
+
+template <bool IP>
+inline int32_t
+int8_distance_scalar(const int8_t* x, const int8_t* y, size_t d) {
     int32_t res = 0;
-    FAISS_PRAGMA_IMPRECISE_LOOP
     for (size_t i = 0; i < d; i++) {
-        res += (int32_t)x[i] * (int32_t)y[i];
+        const int32_t v = IP ? (int32_t)x[i] * (int32_t)y[i] : ((int32_t)x[i] - (int32_t)y[i]);
+        res += IP ? v : v * v;
     }
-    return (float)res;
+    return res;
 }
-FAISS_PRAGMA_IMPRECISE_FUNCTION_END
 
-FAISS_PRAGMA_IMPRECISE_FUNCTION_BEGIN
+template <bool IP>
 float
-int8_vec_L2sqr_avx(const int8_t* x, const int8_t* y, size_t d) {
-    int32_t res = 0;
-    FAISS_PRAGMA_IMPRECISE_LOOP
-    for (size_t i = 0; i < d; i++) {
-        const int32_t tmp = (int32_t)x[i] - (int32_t)y[i];
-        res += tmp * tmp;
+int8_distance(const int8_t* x, const int8_t* y, size_t d) {
+    __m256i msum_0 = _mm256_setzero_si256();
+    __m256i msum_1 = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 32 <= d; i += 32) {
+        msum_0 = int8_madd<IP>(msum_0, int8_load_epi16(x + i), int8_load_epi16(y + i));
+        msum_1 = int8_madd<IP>(msum_1, int8_load_epi16(x + i + 16), int8_load_epi16(y + i + 16));
+    }
+    if (i + 16 <= d) {
+        msum_0 = int8_madd<IP>(msum_0, int8_load_epi16(x + i), int8_load_epi16(y + i));
+        i += 16;
     }
-    return (float)res;
+    const int32_t res = _mm256_reduce_add_epi32(_mm256_add_epi32(msum_0, msum_1));
+    return (float)(res + int8_distance_scalar<IP>(x + i, y + i, d - i));
+}
+
+template <bool IP>
+void
+int8_distance_batch_4(const int8_t* x, const int8_t* y0, const int8_t* y1, const int8_t* y2, const int8_t* y3,
+                      const size_t d, float& dis0, float& dis1, float& dis2, float& dis3) {
+    __m256i msum_0 = _mm256_setzero_si256();
+    __m256i msum_1 = _mm256_setzero_si256();
+    __m256i msum_2 = _mm256_setzero_si256();
+    __m256i msum_3 = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 16 <= d; i += 16) {
+        const __m256i mx = int8_load_epi16(x + i);
+        msum_0 = int8_madd<IP>(msum_0, mx, int8_load_epi16(y0 + i));
+        msum_1 = int8_madd<IP>(msum_1, mx, int8_load_epi16(y1 + i));
+        msum_2 = int8_madd<IP>(msum_2, mx, int8_load_epi16(y2 + i));
+        msum_3 = int8_madd<IP>(msum_3, mx, int8_load_epi16(y3 + i));
+    }
+    dis0 = (float)(_mm256_reduce_add_epi32(msum_0) + int8_distance_scalar<IP>(x + i, y0 + i, d - i));
+    dis1 = (float)(_mm256_reduce_add_epi32(msum_1) + int8_distance_scalar<IP>(x + i, y1 + i, d - i));
+    dis2 = (float)(_mm256_reduce_add_epi32(msum_2) + int8_distance_scalar<IP>(x + i, y2 + i, d - i));
+    dis3 = (float)(_mm256_reduce_add_epi32(msum_3) + int8_distance_scalar<IP>(x + i, y3 + i, d - i));
+}
+}  // namespace
+
+float
+int8_vec_inner_product_avx(const int8_t* x, const int8_t* y, size_t d) {
+    return int8_distance<true>(x, y, d);
+}
+
+float
+int8_vec_L2sqr_avx(const int8_t* x, const int8_t* y, size_t d) {
+    return int8_distance<false>(x, y, d);
 }
-FAISS_PRAGMA_IMPRECISE_FUNCTION_END
 
-FAISS_PRAGMA_IMPRECISE_FUNCTION_BEGIN
 float
 int8_vec_norm_L2sqr_avx(const int8_t* x, size_t d) {
-    int32_t res = 0;
-    FAISS_PRAGMA_IMPRECISE_LOOP
-    for (size_t i = 0; i < d; i++) {
-        res += (int32_t)x[i] * (int32_t)x[i];
-    }
-    return (float)res;
+    return int8_distance<true>(x, x, d);
 }
-FAISS_PRAGMA_IMPRECISE_FUNCTION_END
 
-FAISS_PRAGMA_IMPRECISE_FUNCTION_BEGIN
 void
 int8_vec_inner_product_batch_4_avx(const int8_t* x, const int8_t* y0, const int8_t* y1, const int8_t* y2,
                                    const int8_t* y3, const size_t d, float& dis0, float& dis1, float& dis2,
                                    float& dis3) {
-    int32_t d0 = 0, d1 = 0, d2 = 0, d3 = 0;
-
-    FAISS_PRAGMA_IMPRECISE_LOOP
-    for (size_t i = 0; i < d; ++i) {
-        auto x_i = (int32_t)x[i];
-        d0 += x_i * (int32_t)y0[i];
-        d1 += x_i * (int32_t)y1[i];
-        d2 += x_i * (int32_t)y2[i];
-        d3 += x_i * (int32_t)y3[i];
-    }
-
-    dis0 = (float)d0;
-    dis1 = (float)d1;
-    dis2 = (float)d2;
-    dis3 = (float)d3;
+    int8_distance_batch_4<true>(x, y0, y1, y2, y3, d, dis0, dis1, dis2, dis3);
 }
-FAISS_PRAGMA_IMPRECISE_FUNCTION_END
 
-FAISS_PRAGMA_IMPRECISE_FUNCTION_BEGIN
 void
 int8_vec_L2sqr_batch_4_avx(const int8_t* x, const int8_t* y0, const int8_t* y1, const int8_t* y2, const int8_t* y3,
                            const size_t d, float& dis0, float& dis1, float& dis2, float& dis3) {
-    int32_t d0 = 0, d1 = 0, d2 = 0, d3 = 0;
-
-    FAISS_PRAGMA_IMPRECISE_LOOP
-    for (size_t i = 0; i < d; ++i) {
-        auto x_i = (int32_t)x[i];
-        const int32_t q0 = x_i - (int32_t)y0[i];
-        const int32_t q1 = x_i - (int32_t)y1[i];
-        const int32_t q2 = x_i - (int32_t)y2[i];
-        const int32_t q3 = x_i - (int32_t)y3[i];
-        d0 += q0 * q0;
-        d1 += q1 * q1;
-        d2 += q2 * q2;
-        d3 += q3 * q3;
-    }
-
-    dis0 = (float)d0;
-    dis1 = (float)d1;
-    dis2 = (float)d2;
-    dis3 = (float)d3;
+    int8_distance_batch_4<false>(x, y0, y1, y2, y3, d, dis0, dis1, dis2, dis3);
 }
-FAISS_PRAGMA_IMPRECISE_FUNCTION_END
 
 ///////////////////////////////////////////////////////////////////////////////
 // for cardinal
@@ -1145,5 +1168,115 @@ calculate_hash_avx2(const char* data, size_t size) {
     return XXH3_64bits(data, size);
 }
 
+///////////////////////////////////////////////////////////////////////////////
+// dimension-specialized kernels, see distances_fixed_dim.h
+
+namespace {
+
+struct FixedDimFloatOps {
+    using vec_t = __m256;
+    using acc_t = __m256;
+    static constexpr size_t kStep = 8;
+
+    static acc_t
+    zero() {
+        return _mm256_setzero_ps();
+    }
+    static acc_t
+    ip(acc_t acc, vec_t x, vec_t y) {
+        return _mm256_fmadd_ps(x, y, acc);
+    }
+    static acc_t
+    l2(acc_t acc, vec_t x, vec_t y) {
+        const auto diff = _mm256_sub_ps(x, y);
+        return _mm256_fmadd_ps(diff, diff, acc);
+    }
+    static acc_t
+    add(acc_t a, acc_t b) {
+        return _mm256_add_ps(a, b);
+    }
+    static float
+    reduce(acc_t acc) {
+        return _mm256_reduce_add_ps(acc);
+    }
+};
+
+template <typename DataType>
+struct FixedDimOps;
+
+template <>
+struct FixedDimOps<float> : FixedDimFloatOps {
+    static vec_t
+    load(const float* x) {
+        return _mm256_loadu_ps(x);
+    }
+};
+
+template <>
+struct FixedDimOps<::knowhere::fp16> : FixedDimFloatOps {
+    static vec_t
+    load(const ::knowhere::fp16* x) {
+        return _mm256_cvtph_ps(_mm_loadu_si128((const __m128i*)x));
+    }
+};
+
+template <>
+struct FixedDimOps<::knowhere::bf16> : FixedDimFloatOps {
+    static vec_t
+    load(const ::knowhere::bf16* x) {
+        return _mm256_bf16_to_fp32(_mm_loadu_si128((const __m128i*)x));
+    }
+};
+
+// int8 is widened to int16, and pairs of int16 products are summed into int32 lanes
+template <>
+struct FixedDimOps<::knowhere::int8> {
+    using vec_t = __m256i;
+    using acc_t = __m256i;
+    static constexpr size_t kStep = 16;
+
+    static vec_t
+    load(const ::knowhere::int8* x) {
+        return int8_load_epi16(x);
+    }
+    static acc_t
+    zero() {
+        return _mm256_setzero_si256();
+    }
+    static acc_t
+    ip(acc_t acc, vec_t x, vec_t y) {
+        return int8_madd<true>(acc, x, y);
+    }
+    static acc_t
+    l2(acc_t acc, vec_t x, vec_t y) {
+        return int8_madd<false>(acc, x, y);
+    }
+    static acc_t
+    add(acc_t a, acc_t b) {
+        return _mm256_add_epi32(a, b);
+    }
+    static float
+    reduce(acc_t acc) {
+        return (float)_mm256_reduce_add_epi32(acc);
+    }
+};
+
+}  // namespace
+
+template <typename DataType>
+bool
+get_fixed_dim_kernels_avx(size_t d, DistanceKernels<DataType>& kernels) {
+    return fixed_dim::get_kernels<FixedDimOps, DataType>(d, kernels);
+}
+
+template bool
+get_fixed_dim_kernels_avx<float>(size_t, DistanceKernels<float>&);
+template bool
+get_fixed_dim_kernels_avx<::knowhere::fp16>(size_t, DistanceKernels<::knowhere::fp16>&);
+template bool
+get_fixed_dim_kernels_avx<::knowhere::bf16>(size_t, DistanceKernels<::knowhere::bf16>&);
+template bool
+get_fixed_dim_kernels_avx<::knowhere::int8>(size_t, DistanceKernels<::knowhere::int8>&);
+
 }  // namespace faiss::cppcontrib::knowhere
 #endif
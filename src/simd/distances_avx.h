@@ -14,6 +14,7 @@
 #include <cstddef>
 #include <cstdint>
 
+#include "distance_kernels.h"
 #include "knowhere/operands.h"
 
 namespace faiss {
@@ -159,6 +160,11 @@ rabitq_dp_popcnt_avx(const uint8_t* q, const uint8_t* x, const size_t d, const s
 uint64_t
 calculate_hash_avx2(const char* data, size_t size);
 
+/// Kernels specialized for the dimensions of KNOWHERE_FOR_EACH_FIXED_DIM, returns false when `d` is not one of them.
+template <typename DataType>
+bool
+get_fixed_dim_kernels_avx(size_t d, DistanceKernels<DataType>& kernels);
+
 }  // namespace knowhere
 }  // namespace cppcontrib
 }  // namespace faiss
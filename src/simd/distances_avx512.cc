@@ -20,6 +20,7 @@
 #include <iostream>
 #include <string>
 
+#include "distances_fixed_dim.h"
 #include "faiss/impl/platform_macros.h"
 #include "xxhash.h"
 
@@ -687,91 +688,108 @@ bf16_vec_L2sqr_batch_4_avx512(const ::knowhere::bf16* x, const ::knowhere::bf16*
 ///////////////////////////////////////////////////////////////////////////////
 // int8
 
-FAISS_PRAGMA_IMPRECISE_FUNCTION_BEGIN
+namespace {
+// sign-extends 32 int8 to int16, or the first `n` of them with zeros after
+inline __m512i
+int8_load_epi16(const int8_t* x) {
+    return _mm512_cvtepi8_epi16(_mm256_loadu_si256((const __m256i*)x));
+}
+
+inline __m512i
+int8_load_epi16(const int8_t* x, const size_t n) {
+    return _mm512_cvtepi8_epi16(_mm256_maskz_loadu_epi8((__mmask32)((1u << n) - 1), x));
+}
+
+// vpmaddwd sums adjacent int16 products into int32 lanes, which can't overflow for int8 inputs
+template <bool IP>
+inline __m512i
+int8_madd(const __m512i acc, const __m512i x, const __m512i y) {
+    if constexpr (IP) {
+        return _mm512_add_epi32(acc, _mm512_madd_epi16(x, y));
+    } else {
+        const __m512i diff = _mm512_sub_epi16(x, y);
+        return _mm512_add_epi32(acc, _mm512_madd_epi16(diff, diff));
+    }
+}
+
+template <bool IP>
+float
+int8_distance(const int8_t* x, const int8_t* y, size_t d) {
+    __m512i msum_0 = _mm512_setzero_si512();
+    __m512i msum_1 = _mm512_setzero_si512();
+    size_t i = 0;
+    for (; i + 64 <= d; i += 64) {
+        msum_0 = int8_madd<IP>(msum_0, int8_load_epi16(x + i), int8_load_epi16(y + i));
+        msum_1 = int8_madd<IP>(msum_1, int8_load_epi16(x + i + 32), int8_load_epi16(y + i + 32));
+    }
+    if (i + 32 <= d) {
+        msum_0 = int8_madd<IP>(msum_0, int8_load_epi16(x + i), int8_load_epi16(y + i));
+        i += 32;
+    }
+    if (i < d) {
+        msum_1 = int8_madd<IP>(msum_1, int8_load_epi16(x + i, d - i), int8_load_epi16(y + i, d - i));
+    }
+    return (float)_mm512_reduce_add_epi32(_mm512_add_epi32(msum_0, msum_1));
+}
+
+template <bool IP>
+void
+int8_distance_batch_4(const int8_t* x, const int8_t* y0, const int8_t* y1, const int8_t* y2, const int8_t* y3,
+                      const size_t d, float& dis0, float& dis1, float& dis2, float& dis3) {
+    __m512i msum_0 = _mm512_setzero_si512();
+    __m512i msum_1 = _mm512_setzero_si512();
+    __m512i msum_2 = _mm512_setzero_si512();
+    __m512i msum_3 = _mm512_setzero_si512();
+    size_t i = 0;
+    for (; i + 32 <= d; i += 32) {
+        const __m512i mx = int8_load_epi16(x + i);
+        msum_0 = int8_madd<IP>(msum_0, mx, int8_load_epi16(y0 + i));
+        msum_1 = int8_madd<IP>(msum_1, mx, int8_load_epi16(y1 + i));
+        msum_2 = int8_madd<IP>(msum_2, mx, int8_load_epi16(y2 + i));
+        msum_3 = int8_madd<IP>(msum_3, mx, int8_load_epi16(y3 + i));
+    }
+    if (i < d) {
+        const size_t n = d - i;
+        const __m512i mx = int8_load_epi16(x + i, n);
+        msum_0 = int8_madd<IP>(msum_0, mx, int8_load_epi16(y0 + i, n));
+        msum_1 = int8_madd<IP>(msum_1, mx, int8_load_epi16(y1 + i, n));
+        msum_2 = int8_madd<IP>(msum_2, mx, int8_load_epi16(y2 + i, n));
+        msum_3 = int8_madd<IP>(msum_3, mx, int8_load_epi16(y3 + i, n));
+    }
+    dis0 = (float)_mm512_reduce_add_epi32(msum_0);
+    dis1 = (float)_mm512_reduce_add_epi32(msum_1);
+    dis2 = (float)_mm512_reduce_add_epi32(msum_2);
+    dis3 = (float)_mm512_reduce_add_epi32(msum_3);
+}
+}  // namespace
+
 float
 int8_vec_inner_product_avx512(const int8_t* x, const int8_t* y, size_t d) {
-    int32_t res = 0;
-    FAISS_PRAGMA_IMPRECISE_LOOP
-    for (size_t i = 0; i < d; i++) {
-        res += (int32_t)x[i] * (int32_t)y[i];
-    }
-    return (float)res;
+    return int8_distance<true>(x, y, d);
 }
-FAISS_PRAGMA_IMPRECISE_FUNCTION_END
 
-FAISS_PRAGMA_IMPRECISE_FUNCTION_BEGIN
 float
 int8_vec_L2sqr_avx512(const int8_t* x, const int8_t* y, size_t d) {
-    int32_t res = 0;
-    FAISS_PRAGMA_IMPRECISE_LOOP
-    for (size_t i = 0; i < d; i++) {
-        const int32_t tmp = (int32_t)x[i] - (int32_t)y[i];
-        res += tmp * tmp;
-    }
-    return (float)res;
+    return int8_distance<false>(x, y, d);
 }
-FAISS_PRAGMA_IMPRECISE_FUNCTION_END
 
-FAISS_PRAGMA_IMPRECISE_FUNCTION_BEGIN
 float
 int8_vec_norm_L2sqr_avx512(const int8_t* x, size_t d) {
-    int32_t res = 0;
-    FAISS_PRAGMA_IMPRECISE_LOOP
-    for (size_t i = 0; i < d; i++) {
-        res += (int32_t)x[i] * (int32_t)x[i];
-    }
-    return (float)res;
+    return int8_distance<true>(x, x, d);
 }
-FAISS_PRAGMA_IMPRECISE_FUNCTION_END
 
-FAISS_PRAGMA_IMPRECISE_FUNCTION_BEGIN
 void
 int8_vec_inner_product_batch_4_avx512(const int8_t* x, const int8_t* y0, const int8_t* y1, const int8_t* y2,
                                       const int8_t* y3, const size_t d, float& dis0, float& dis1, float& dis2,
                                       float& dis3) {
-    int32_t d0 = 0, d1 = 0, d2 = 0, d3 = 0;
-
-    FAISS_PRAGMA_IMPRECISE_LOOP
-    for (size_t i = 0; i < d; ++i) {
-        auto x_i = (int32_t)x[i];
-        d0 += x_i * (int32_t)y0[i];
-        d1 += x_i * (int32_t)y1[i];
-        d2 += x_i * (int32_t)y2[i];
-        d3 += x_i * (int32_t)y3[i];
-    }
-
-    dis0 = (float)d0;
-    dis1 = (float)d1;
-    dis2 = (float)d2;
-    dis3 = (float)d3;
+    int8_distance_batch_4<true>(x, y0, y1, y2, y3, d, dis0, dis1, dis2, dis3);
 }
-FAISS_PRAGMA_IMPRECISE_FUNCTION_END
 
-FAISS_PRAGMA_IMPRECISE_FUNCTION_BEGIN
 void
 int8_vec_L2sqr_batch_4_avx512(const int8_t* x, const int8_t* y0, const int8_t* y1, const int8_t* y2, const int8_t* y3,
                               const size_t d, float& dis0, float& dis1, float& dis2, float& dis3) {
-    int32_t d0 = 0, d1 = 0, d2 = 0, d3 = 0;
-
-    FAISS_PRAGMA_IMPRECISE_LOOP
-    for (size_t i = 0; i < d; ++i) {
-        auto x_i = (int32_t)x[i];
-        const int32_t q0 = x_i - (int32_t)y0[i];
-        const int32_t q1 = x_i - (int32_t)y1[i];
-        const int32_t q2 = x_i - (int32_t)y2[i];
-        const int32_t q3 = x_i - (int32_t)y3[i];
-        d0 += q0 * q0;
-        d1 += q1 * q1;
-        d2 += q2 * q2;
-        d3 += q3 * q3;
-    }
-
-    dis0 = (float)d0;
-    dis1 = (float)d1;
-    dis2 = (float)d2;
-    dis3 = (float)d3;
+    int8_distance_batch_4<false>(x, y0, y1, y2, y3, d, dis0, dis1, dis2, dis3);
 }
-FAISS_PRAGMA_IMPRECISE_FUNCTION_END
 
 ///////////////////////////////////////////////////////////////////////////////
 // for cardinal
@@ -1207,6 +1225,116 @@ u64_jaccard_distance_batch_4_avx512(const char* x, const char* y0, const char* y
     dis3 = float(d3) / element_length;
 }
 
+///////////////////////////////////////////////////////////////////////////////
+// dimension-specialized kernels, see distances_fixed_dim.h
+
+namespace {
+
+struct FixedDimFloatOps {
+    using vec_t = __m512;
+    using acc_t = __m512;
+    static constexpr size_t kStep = 16;
+
+    static acc_t
+    zero() {
+        return _mm512_setzero_ps();
+    }
+    static acc_t
+    ip(acc_t acc, vec_t x, vec_t y) {
+        return _mm512_fmadd_ps(x, y, acc);
+    }
+    static acc_t
+    l2(acc_t acc, vec_t x, vec_t y) {
+        const auto diff = _mm512_sub_ps(x, y);
+        return _mm512_fmadd_ps(diff, diff, acc);
+    }
+    static acc_t
+    add(acc_t a, acc_t b) {
+        return _mm512_add_ps(a, b);
+    }
+    static float
+    reduce(acc_t acc) {
+        return _mm512_reduce_add_ps(acc);
+    }
+};
+
+template <typename DataType>
+struct FixedDimOps;
+
+template <>
+struct FixedDimOps<float> : FixedDimFloatOps {
+    static vec_t
+    load(const float* x) {
+        return _mm512_loadu_ps(x);
+    }
+};
+
+template <>
+struct FixedDimOps<::knowhere::fp16> : FixedDimFloatOps {
+    static vec_t
+    load(const ::knowhere::fp16* x) {
+        return _mm512_cvtph_ps(_mm256_loadu_si256((const __m256i*)x));
+    }
+};
+
+template <>
+struct FixedDimOps<::knowhere::bf16> : FixedDimFloatOps {
+    static vec_t
+    load(const ::knowhere::bf16* x) {
+        return _mm512_bf16_to_fp32(_mm256_loadu_si256((const __m256i*)x));
+    }
+};
+
+// int8 is widened to int16, and pairs of int16 products are summed into int32 lanes
+template <>
+struct FixedDimOps<::knowhere::int8> {
+    using vec_t = __m512i;
+    using acc_t = __m512i;
+    static constexpr size_t kStep = 32;
+
+    static vec_t
+    load(const ::knowhere::int8* x) {
+        return int8_load_epi16(x);
+    }
+    static acc_t
+    zero() {
+        return _mm512_setzero_si512();
+    }
+    static acc_t
+    ip(acc_t acc, vec_t x, vec_t y) {
+        return int8_madd<true>(acc, x, y);
+    }
+    static acc_t
+    l2(acc_t acc, vec_t x, vec_t y) {
+        return int8_madd<false>(acc, x, y);
+    }
+    static acc_t
+    add(acc_t a, acc_t b) {
+        return _mm512_add_epi32(a, b);
+    }
+    static float
+    reduce(acc_t acc) {
+        return (float)_mm512_reduce_add_epi32(acc);
+    }
+};
+
+}  // namespace
+
+template <typename DataType>
+bool
+get_fixed_dim_kernels_avx512(size_t d, DistanceKernels<DataType>& kernels) {
+    return fixed_dim::get_kernels<FixedDimOps, DataType>(d, kernels);
+}
+
+template bool
+get_fixed_dim_kernels_avx512<float>(size_t, DistanceKernels<float>&);
+template bool
+get_fixed_dim_kernels_avx512<::knowhere::fp16>(size_t, DistanceKernels<::knowhere::fp16>&);
+template bool
+get_fixed_dim_kernels_avx512<::knowhere::bf16>(size_t, DistanceKernels<::knowhere::bf16>&);
+template bool
+get_fixed_dim_kernels_avx512<::knowhere::int8>(size_t, DistanceKernels<::knowhere::int8>&);
+
 }  // namespace faiss::cppcontrib::knowhere
 
 #endif
@@ -14,6 +14,7 @@
 #include <cstddef>
 #include <cstdint>
 
+#include "distance_kernels.h"
 #include "knowhere/operands.h"
 
 namespace faiss {
@@ -168,6 +169,11 @@ void
 u64_jaccard_distance_batch_4_avx512(const char*, const char*, const char*, const char*, const char*, size_t, size_t,
                                     float&, float&, float&, float&);
 
+/// Kernels specialized for the dimensions of KNOWHERE_FOR_EACH_FIXED_DIM, returns false when `d` is not one of them.
+template <typename DataType>
+bool
+get_fixed_dim_kernels_avx512(size_t d, DistanceKernels<DataType>& kernels);
+
 }  // namespace knowhere
 }  // namespace cppcontrib
 }  // namespace faiss
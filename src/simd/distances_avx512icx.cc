@@ -13,10 +13,11 @@
 
 #include <immintrin.h>
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
 
-#include "distances_avx512.h"
+#include "distances_avx512icx.h"
 
 namespace faiss::cppcontrib::knowhere {
 
@@ -89,6 +90,49 @@ rabitq_dp_q(const uint8_t* q, const uint8_t* x, const size_t d) {
     return sum_64le;
 }
 
+// the first 0 < n <= 64 bytes of `x`, zeros after
+inline __m512i
+load_first_epi8(const int8_t* x, const size_t n) {
+    return _mm512_maskz_loadu_epi8((__mmask64)(~0ull >> (64 - n)), x);
+}
+
+// vpdpbusd multiplies unsigned by signed bytes, so x is biased to x + 128 and the excess 128 * sum(y) is taken off
+// at the end. The excess is accumulated with another vpdpbusd against ones. Both sums may wrap around in int32 for
+// very long vectors, their difference doesn't.
+struct Int8DotProduct {
+    __m512i dot = _mm512_setzero_si512();
+    __m512i sum = _mm512_setzero_si512();
+
+    static __m512i
+    bias(const __m512i x) {
+        return _mm512_xor_si512(x, _mm512_set1_epi8(-128));
+    }
+
+    void
+    add(const __m512i x_biased, const __m512i y) {
+        dot = _mm512_dpbusd_epi32(dot, x_biased, y);
+        sum = _mm512_dpbusd_epi32(sum, _mm512_set1_epi8(1), y);
+    }
+
+    int32_t
+    reduce() const {
+        return _mm512_reduce_add_epi32(_mm512_sub_epi32(dot, _mm512_slli_epi32(sum, 7)));
+    }
+};
+
+// the differences don't fit in int8, so they are taken in int16 and squared with vpdpwssd
+inline __m512i
+l2_dpwssd(const __m512i acc, const __m256i x, const __m256i y) {
+    const __m512i diff = _mm512_sub_epi16(_mm512_cvtepi8_epi16(x), _mm512_cvtepi8_epi16(y));
+    return _mm512_dpwssd_epi32(acc, diff, diff);
+}
+
+// the first 0 < n <= 32 bytes of `x`, zeros after
+inline __m256i
+load_first_epi8_256(const int8_t* x, const size_t n) {
+    return _mm256_maskz_loadu_epi8((__mmask32)(~0u >> (32 - n)), x);
+}
+
 }  // namespace
 
 int
@@ -115,6 +159,96 @@ rabitq_dp_popcnt_avx512icx(const uint8_t* q, const uint8_t* x, const size_t d, c
     return 0;
 }
 
+float
+int8_vec_inner_product_avx512icx(const int8_t* x, const int8_t* y, size_t d) {
+    Int8DotProduct ip_0, ip_1;
+    size_t i = 0;
+    for (; i + 128 <= d; i += 128) {
+        ip_0.add(Int8DotProduct::bias(_mm512_loadu_si512(x + i)), _mm512_loadu_si512(y + i));
+        ip_1.add(Int8DotProduct::bias(_mm512_loadu_si512(x + i + 64)), _mm512_loadu_si512(y + i + 64));
+    }
+    for (; i < d; i += 64) {
+        const size_t n = std::min<size_t>(d - i, 64);
+        const __m512i mx = n == 64 ? _mm512_loadu_si512(x + i) : load_first_epi8(x + i, n);
+        const __m512i my = n == 64 ? _mm512_loadu_si512(y + i) : load_first_epi8(y + i, n);
+        // the zeroed tail of y cancels out the bias of x
+        ip_0.add(Int8DotProduct::bias(mx), my);
+    }
+    return (float)(ip_0.reduce() + ip_1.reduce());
+}
+
+float
+int8_vec_L2sqr_avx512icx(const int8_t* x, const int8_t* y, size_t d) {
+    __m512i msum_0 = _mm512_setzero_si512();
+    __m512i msum_1 = _mm512_setzero_si512();
+    size_t i = 0;
+    for (; i + 64 <= d; i += 64) {
+        msum_0 = l2_dpwssd(msum_0, _mm256_loadu_si256((const __m256i*)(x + i)),
+                           _mm256_loadu_si256((const __m256i*)(y + i)));
+        msum_1 = l2_dpwssd(msum_1, _mm256_loadu_si256((const __m256i*)(x + i + 32)),
+                           _mm256_loadu_si256((const __m256i*)(y + i + 32)));
+    }
+    for (; i < d; i += 32) {
+        const size_t n = std::min<size_t>(d - i, 32);
+        msum_0 = l2_dpwssd(msum_0, load_first_epi8_256(x + i, n), load_first_epi8_256(y + i, n));
+    }
+    return (float)_mm512_reduce_add_epi32(_mm512_add_epi32(msum_0, msum_1));
+}
+
+float
+int8_vec_norm_L2sqr_avx512icx(const int8_t* x, size_t d) {
+    return int8_vec_inner_product_avx512icx(x, x, d);
+}
+
+void
+int8_vec_inner_product_batch_4_avx512icx(const int8_t* x, const int8_t* y0, const int8_t* y1, const int8_t* y2,
+                                         const int8_t* y3, const size_t d, float& dis0, float& dis1, float& dis2,
+                                         float& dis3) {
+    Int8DotProduct ip_0, ip_1, ip_2, ip_3;
+    for (size_t i = 0; i < d; i += 64) {
+        const size_t n = std::min<size_t>(d - i, 64);
+        if (n == 64) {
+            const __m512i mx = Int8DotProduct::bias(_mm512_loadu_si512(x + i));
+            ip_0.add(mx, _mm512_loadu_si512(y0 + i));
+            ip_1.add(mx, _mm512_loadu_si512(y1 + i));
+            ip_2.add(mx, _mm512_loadu_si512(y2 + i));
+            ip_3.add(mx, _mm512_loadu_si512(y3 + i));
+        } else {
+            const __m512i mx = Int8DotProduct::bias(load_first_epi8(x + i, n));
+            ip_0.add(mx, load_first_epi8(y0 + i, n));
+            ip_1.add(mx, load_first_epi8(y1 + i, n));
+            ip_2.add(mx, load_first_epi8(y2 + i, n));
+            ip_3.add(mx, load_first_epi8(y3 + i, n));
+        }
+    }
+    dis0 = (float)ip_0.reduce();
+    dis1 = (float)ip_1.reduce();
+    dis2 = (float)ip_2.reduce();
+    dis3 = (float)ip_3.reduce();
+}
+
+void
+int8_vec_L2sqr_batch_4_avx512icx(const int8_t* x, const int8_t* y0, const int8_t* y1, const int8_t* y2,
+                                 const int8_t* y3, const size_t d, float& dis0, float& dis1, float& dis2,
+                                 float& dis3) {
+    __m512i msum_0 = _mm512_setzero_si512();
+    __m512i msum_1 = _mm512_setzero_si512();
+    __m512i msum_2 = _mm512_setzero_si512();
+    __m512i msum_3 = _mm512_setzero_si512();
+    for (size_t i = 0; i < d; i += 32) {
+        const size_t n = std::min<size_t>(d - i, 32);
+        const __m256i mx = load_first_epi8_256(x + i, n);
+        msum_0 = l2_dpwssd(msum_0, mx, load_first_epi8_256(y0 + i, n));
+        msum_1 = l2_dpwssd(msum_1, mx, load_first_epi8_256(y1 + i, n));
+        msum_2 = l2_dpwssd(msum_2, mx, load_first_epi8_256(y2 + i, n));
+        msum_3 = l2_dpwssd(msum_3, mx, load_first_epi8_256(y3 + i, n));
+    }
+    dis0 = (float)_mm512_reduce_add_epi32(msum_0);
+    dis1 = (float)_mm512_reduce_add_epi32(msum_1);
+    dis2 = (float)_mm512_reduce_add_epi32(msum_2);
+    dis3 = (float)_mm512_reduce_add_epi32(msum_3);
+}
+
 }  // namespace faiss::cppcontrib::knowhere
 
 #endif
@@ -23,6 +23,26 @@ namespace knowhere {
 int
 rabitq_dp_popcnt_avx512icx(const uint8_t* q, const uint8_t* x, const size_t d, const size_t nb);
 
+///////////////////////////////////////////////////////////////////////////////
+// int8, with AVX512-VNNI
+float
+int8_vec_inner_product_avx512icx(const int8_t* x, const int8_t* y, size_t d);
+
+float
+int8_vec_L2sqr_avx512icx(const int8_t* x, const int8_t* y, size_t d);
+
+float
+int8_vec_norm_L2sqr_avx512icx(const int8_t* x, size_t d);
+
+void
+int8_vec_inner_product_batch_4_avx512icx(const int8_t* x, const int8_t* y0, const int8_t* y1, const int8_t* y2,
+                                         const int8_t* y3, const size_t d, float& dis0, float& dis1, float& dis2,
+                                         float& dis3);
+
+void
+int8_vec_L2sqr_batch_4_avx512icx(const int8_t* x, const int8_t* y0, const int8_t* y1, const int8_t* y2,
+                                 const int8_t* y3, const size_t d, float& dis0, float& dis1, float& dis2, float& dis3);
+
 }  // namespace knowhere
 }  // namespace cppcontrib
 }  // namespace faiss
@@ -0,0 +1,161 @@
+// Copyright (C) 2019-2025 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License.
+
+#if defined(__x86_64__)
+
+#include "distances_avxvnni.h"
+
+#include <immintrin.h>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace faiss::cppcontrib::knowhere {
+
+namespace {
+
+inline int32_t
+reduce_add_epi32(const __m256i res) {
+    __m128i sum = _mm_add_epi32(_mm256_castsi256_si128(res), _mm256_extracti128_si256(res, 1));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(sum);
+}
+
+template <bool IP>
+inline int32_t
+distance_scalar(const int8_t* x, const int8_t* y, size_t d) {
+    int32_t res = 0;
+    for (size_t i = 0; i < d; i++) {
+        const int32_t v = IP ? (int32_t)x[i] * (int32_t)y[i] : ((int32_t)x[i] - (int32_t)y[i]);
+        res += IP ? v : v * v;
+    }
+    return res;
+}
+
+// vpdpbusd multiplies unsigned by signed bytes, so x is biased to x + 128 and the excess 128 * sum(y) is taken off
+// at the end, see the AVX512-VNNI version in distances_avx512icx.cc
+struct DotProduct {
+    __m256i dot = _mm256_setzero_si256();
+    __m256i sum = _mm256_setzero_si256();
+
+    static __m256i
+    bias(const int8_t* x) {
+        return _mm256_xor_si256(_mm256_loadu_si256((const __m256i*)x), _mm256_set1_epi8(-128));
+    }
+
+    void
+    add(const __m256i x_biased, const int8_t* y) {
+        const __m256i my = _mm256_loadu_si256((const __m256i*)y);
+        dot = _mm256_dpbusd_avx_epi32(dot, x_biased, my);
+        sum = _mm256_dpbusd_avx_epi32(sum, _mm256_set1_epi8(1), my);
+    }
+
+    int32_t
+    reduce() const {
+        return reduce_add_epi32(_mm256_sub_epi32(dot, _mm256_slli_epi32(sum, 7)));
+    }
+};
+
+// sign-extends 16 int8 to int16
+inline __m256i
+load_epi16(const int8_t* x) {
+    return _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i*)x));
+}
+
+// the differences don't fit in int8, so they are taken in int16 and squared with vpdpwssd
+inline __m256i
+l2_dpwssd(const __m256i acc, const __m256i x, const __m256i y) {
+    const __m256i diff = _mm256_sub_epi16(x, y);
+    return _mm256_dpwssd_avx_epi32(acc, diff, diff);
+}
+
+}  // namespace
+
+float
+int8_vec_inner_product_avxvnni(const int8_t* x, const int8_t* y, size_t d) {
+    DotProduct ip_0, ip_1;
+    size_t i = 0;
+    for (; i + 64 <= d; i += 64) {
+        ip_0.add(DotProduct::bias(x + i), y + i);
+        ip_1.add(DotProduct::bias(x + i + 32), y + i + 32);
+    }
+    if (i + 32 <= d) {
+        ip_0.add(DotProduct::bias(x + i), y + i);
+        i += 32;
+    }
+    return (float)(ip_0.reduce() + ip_1.reduce() + distance_scalar<true>(x + i, y + i, d - i));
+}
+
+float
+int8_vec_L2sqr_avxvnni(const int8_t* x, const int8_t* y, size_t d) {
+    __m256i msum_0 = _mm256_setzero_si256();
+    __m256i msum_1 = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 32 <= d; i += 32) {
+        msum_0 = l2_dpwssd(msum_0, load_epi16(x + i), load_epi16(y + i));
+        msum_1 = l2_dpwssd(msum_1, load_epi16(x + i + 16), load_epi16(y + i + 16));
+    }
+    if (i + 16 <= d) {
+        msum_0 = l2_dpwssd(msum_0, load_epi16(x + i), load_epi16(y + i));
+        i += 16;
+    }
+    return (float)(reduce_add_epi32(_mm256_add_epi32(msum_0, msum_1)) + distance_scalar<false>(x + i, y + i, d - i));
+}
+
+float
+int8_vec_norm_L2sqr_avxvnni(const int8_t* x, size_t d) {
+    return int8_vec_inner_product_avxvnni(x, x, d);
+}
+
+void
+int8_vec_inner_product_batch_4_avxvnni(const int8_t* x, const int8_t* y0, const int8_t* y1, const int8_t* y2,
+                                       const int8_t* y3, const size_t d, float& dis0, float& dis1, float& dis2,
+                                       float& dis3) {
+    DotProduct ip_0, ip_1, ip_2, ip_3;
+    size_t i = 0;
+    for (; i + 32 <= d; i += 32) {
+        const __m256i mx = DotProduct::bias(x + i);
+        ip_0.add(mx, y0 + i);
+        ip_1.add(mx, y1 + i);
+        ip_2.add(mx, y2 + i);
+        ip_3.add(mx, y3 + i);
+    }
+    dis0 = (float)(ip_0.reduce() + distance_scalar<true>(x + i, y0 + i, d - i));
+    dis1 = (float)(ip_1.reduce() + distance_scalar<true>(x + i, y1 + i, d - i));
+    dis2 = (float)(ip_2.reduce() + distance_scalar<true>(x + i, y2 + i, d - i));
+    dis3 = (float)(ip_3.reduce() + distance_scalar<true>(x + i, y3 + i, d - i));
+}
+
+void
+int8_vec_L2sqr_batch_4_avxvnni(const int8_t* x, const int8_t* y0, const int8_t* y1, const int8_t* y2, const int8_t* y3,
+                               const size_t d, float& dis0, float& dis1, float& dis2, float& dis3) {
+    __m256i msum_0 = _mm256_setzero_si256();
+    __m256i msum_1 = _mm256_setzero_si256();
+    __m256i msum_2 = _mm256_setzero_si256();
+    __m256i msum_3 = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 16 <= d; i += 16) {
+        const __m256i mx = load_epi16(x + i);
+        msum_0 = l2_dpwssd(msum_0, mx, load_epi16(y0 + i));
+        msum_1 = l2_dpwssd(msum_1, mx, load_epi16(y1 + i));
+        msum_2 = l2_dpwssd(msum_2, mx, load_epi16(y2 + i));
+        msum_3 = l2_dpwssd(msum_3, mx, load_epi16(y3 + i));
+    }
+    dis0 = (float)(reduce_add_epi32(msum_0) + distance_scalar<false>(x + i, y0 + i, d - i));
+    dis1 = (float)(reduce_add_epi32(msum_1) + distance_scalar<false>(x + i, y1 + i, d - i));
+    dis2 = (float)(reduce_add_epi32(msum_2) + distance_scalar<false>(x + i, y2 + i, d - i));
+    dis3 = (float)(reduce_add_epi32(msum_3) + distance_scalar<false>(x + i, y3 + i, d - i));
+}
+
+}  // namespace faiss::cppcontrib::knowhere
+
+#endif
@@ -0,0 +1,112 @@
+// Copyright (C) 2019-2023 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License.
+
+// Dimension-specialized distance kernels, shared by the instruction set specific translation units.
+//
+// Only include this from a distances_<isa>.cc. The kernels are written against an `Ops<DataType>` class of that
+// file, which must live in an anonymous namespace so that every instruction set gets its own instantiations:
+//
+//   using vec_t = ...;                  // DataType elements widened for arithmetic
+//   using acc_t = ...;                  // accumulator
+//   static constexpr size_t kStep;      // elements per load()
+//   static vec_t load(const DataType*);
+//   static acc_t zero();
+//   static acc_t ip(acc_t, vec_t, vec_t);
+//   static acc_t l2(acc_t, vec_t, vec_t);
+//   static acc_t add(acc_t, acc_t);
+//   static float reduce(acc_t);
+
+#pragma once
+
+#include <cstddef>
+
+#include "distance_kernels.h"
+
+namespace faiss {
+namespace cppcontrib {
+namespace knowhere {
+namespace fixed_dim {
+
+// independent accumulators per vector, to hide the latency of the fused multiply-adds
+constexpr size_t kLanes = 4;
+
+template <template <typename> class Ops, typename DataType, size_t D, bool IP>
+float
+distance(const DataType* x, const DataType* y, size_t) {
+    using O = Ops<DataType>;
+    static_assert(D % (O::kStep * kLanes) == 0, "the dimension must not leave a tail");
+    typename O::acc_t acc[kLanes];
+    for (size_t l = 0; l < kLanes; ++l) {
+        acc[l] = O::zero();
+    }
+#pragma GCC unroll 128
+    for (size_t i = 0; i < D; i += O::kStep * kLanes) {
+        for (size_t l = 0; l < kLanes; ++l) {
+            const auto vx = O::load(x + i + l * O::kStep);
+            const auto vy = O::load(y + i + l * O::kStep);
+            acc[l] = IP ? O::ip(acc[l], vx, vy) : O::l2(acc[l], vx, vy);
+        }
+    }
+    return O::reduce(O::add(O::add(acc[0], acc[1]), O::add(acc[2], acc[3])));
+}
+
+template <template <typename> class Ops, typename DataType, size_t D, bool IP>
+void
+distance_batch_4(const DataType* x, const DataType* y0, const DataType* y1, const DataType* y2, const DataType* y3,
+                 const size_t, float& dis0, float& dis1, float& dis2, float& dis3) {
+    using O = Ops<DataType>;
+    static_assert(D % (O::kStep * 2) == 0, "the dimension must not leave a tail");
+    // two accumulators per y already keep eight multiply-adds in flight
+    typename O::acc_t acc[4][2];
+    for (size_t j = 0; j < 4; ++j) {
+        acc[j][0] = O::zero();
+        acc[j][1] = O::zero();
+    }
+    const DataType* y[4] = {y0, y1, y2, y3};
+#pragma GCC unroll 128
+    for (size_t i = 0; i < D; i += O::kStep * 2) {
+        for (size_t l = 0; l < 2; ++l) {
+            const auto vx = O::load(x + i + l * O::kStep);
+            for (size_t j = 0; j < 4; ++j) {
+                const auto vy = O::load(y[j] + i + l * O::kStep);
+                acc[j][l] = IP ? O::ip(acc[j][l], vx, vy) : O::l2(acc[j][l], vx, vy);
+            }
+        }
+    }
+    dis0 = O::reduce(O::add(acc[0][0], acc[0][1]));
+    dis1 = O::reduce(O::add(acc[1][0], acc[1][1]));
+    dis2 = O::reduce(O::add(acc[2][0], acc[2][1]));
+    dis3 = O::reduce(O::add(acc[3][0], acc[3][1]));
+}
+
+// fills `kernels` and returns true when `d` is one of KNOWHERE_FOR_EACH_FIXED_DIM
+template <template <typename> class Ops, typename DataType>
+bool
+get_kernels(size_t d, DistanceKernels<DataType>& kernels) {
+    switch (d) {
+#define KNOWHERE_FIXED_DIM_CASE(D)                                                 \
+    case D:                                                                        \
+        kernels.inner_product = &distance<Ops, DataType, D, true>;                 \
+        kernels.L2sqr = &distance<Ops, DataType, D, false>;                        \
+        kernels.inner_product_batch_4 = &distance_batch_4<Ops, DataType, D, true>; \
+        kernels.L2sqr_batch_4 = &distance_batch_4<Ops, DataType, D, false>;        \
+        return true;
+        KNOWHERE_FOR_EACH_FIXED_DIM(KNOWHERE_FIXED_DIM_CASE)
+#undef KNOWHERE_FIXED_DIM_CASE
+        default:
+            return false;
+    }
+}
+
+}  // namespace fixed_dim
+}  // namespace knowhere
+}  // namespace cppcontrib
+}  // namespace faiss
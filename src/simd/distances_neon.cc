@@ -17,6 +17,8 @@
 #include <arm_neon.h>
 #include <math.h>
 
+#include "distances_fixed_dim.h"
+
 namespace faiss {
 namespace cppcontrib {
 namespace knowhere {
@@ -3522,6 +3524,117 @@ fvec_L2sqr_batch_4_bf16_patch_neon(const float* x, const float* y0, const float*
     dis3 = vaddvq_f32(sum_.val[3]);
 }
 
+///////////////////////////////////////////////////////////////////////////////
+// dimension-specialized kernels, see distances_fixed_dim.h
+
+namespace {
+
+struct FixedDimFloatOps {
+    using vec_t = float32x4_t;
+    using acc_t = float32x4_t;
+    static constexpr size_t kStep = 4;
+
+    static acc_t
+    zero() {
+        return vdupq_n_f32(0.0f);
+    }
+    static acc_t
+    ip(acc_t acc, vec_t x, vec_t y) {
+        return vfmaq_f32(acc, x, y);
+    }
+    static acc_t
+    l2(acc_t acc, vec_t x, vec_t y) {
+        const auto diff = vsubq_f32(x, y);
+        return vfmaq_f32(acc, diff, diff);
+    }
+    static acc_t
+    add(acc_t a, acc_t b) {
+        return vaddq_f32(a, b);
+    }
+    static float
+    reduce(acc_t acc) {
+        return vaddvq_f32(acc);
+    }
+};
+
+template <typename DataType>
+struct FixedDimOps;
+
+template <>
+struct FixedDimOps<float> : FixedDimFloatOps {
+    static vec_t
+    load(const float* x) {
+        return vld1q_f32(x);
+    }
+};
+
+template <>
+struct FixedDimOps<::knowhere::fp16> : FixedDimFloatOps {
+    static vec_t
+    load(const ::knowhere::fp16* x) {
+        return vcvt_f32_f16(vld1_f16((const __fp16*)x));
+    }
+};
+
+template <>
+struct FixedDimOps<::knowhere::bf16> : FixedDimFloatOps {
+    static vec_t
+    load(const ::knowhere::bf16* x) {
+        return vreinterpretq_f32_u32(vshll_n_u16(vld1_u16((const uint16_t*)x), 16));
+    }
+};
+
+// int8 is widened to int16, and the int16 products are accumulated into int32 lanes
+template <>
+struct FixedDimOps<::knowhere::int8> {
+    using vec_t = int16x8_t;
+    using acc_t = int32x4_t;
+    static constexpr size_t kStep = 8;
+
+    static vec_t
+    load(const ::knowhere::int8* x) {
+        return vmovl_s8(vld1_s8(x));
+    }
+    static acc_t
+    zero() {
+        return vdupq_n_s32(0);
+    }
+    static acc_t
+    ip(acc_t acc, vec_t x, vec_t y) {
+        return vmlal_high_s16(vmlal_s16(acc, vget_low_s16(x), vget_low_s16(y)), x, y);
+    }
+    static acc_t
+    l2(acc_t acc, vec_t x, vec_t y) {
+        const auto diff = vsubq_s16(x, y);
+        return vmlal_high_s16(vmlal_s16(acc, vget_low_s16(diff), vget_low_s16(diff)), diff, diff);
+    }
+    static acc_t
+    add(acc_t a, acc_t b) {
+        return vaddq_s32(a, b);
+    }
+    static float
+    reduce(acc_t acc) {
+        return (float)vaddvq_s32(acc);
+    }
+};
+
+}  // namespace
+
+template <typename DataType>
+bool
+get_fixed_dim_kernels_neon(size_t d, DistanceKernels<DataType>& kernels) {
+    return fixed_dim::get_kernels<FixedDimOps, DataType>(d, kernels);
+}
+
+template bool
+get_fixed_dim_kernels_neon<float>(size_t, DistanceKernels<float>&);
+template bool
+get_fixed_dim_kernels_neon<::knowhere::fp16>(size_t, DistanceKernels<::knowhere::fp16>&);
+template bool
+get_fixed_dim_kernels_neon<::knowhere::bf16>(size_t, DistanceKernels<::knowhere::bf16>&);
+template bool
+get_fixed_dim_kernels_neon<::knowhere::int8>(size_t, DistanceKernels<::knowhere::int8>&);
+
 }  // namespace knowhere
 }  // namespace cppcontrib
 }  // namespace faiss
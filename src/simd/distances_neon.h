@@ -14,6 +14,7 @@
 #include <cstdint>
 #include <cstdio>
 
+#include "distance_kernels.h"
 #include "knowhere/operands.h"
 
 namespace faiss {
@@ -164,6 +165,11 @@ void
 fvec_L2sqr_batch_4_bf16_patch_neon(const float* x, const float* y0, const float* y1, const float* y2, const float* y3,
                                    const size_t dim, float& dis0, float& dis1, float& dis2, float& dis3);
 
+/// Kernels specialized for the dimensions of KNOWHERE_FOR_EACH_FIXED_DIM, returns false when `d` is not one of them.
+template <typename DataType>
+bool
+get_fixed_dim_kernels_neon(size_t d, DistanceKernels<DataType>& kernels);
+
 }  // namespace knowhere
 }  // namespace cppcontrib
 }  // namespace faiss
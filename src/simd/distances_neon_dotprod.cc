@@ -0,0 +1,132 @@
+// Copyright (C) 2019-2025 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License.
+
+#if defined(__ARM_FEATURE_DOTPROD)
+
+#include "distances_neon_dotprod.h"
+
+#include <arm_neon.h>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace faiss {
+namespace cppcontrib {
+namespace knowhere {
+
+namespace {
+
+template <bool IP>
+inline int32_t
+distance_scalar(const int8_t* x, const int8_t* y, size_t d) {
+    int32_t res = 0;
+    for (size_t i = 0; i < d; i++) {
+        const int32_t v = IP ? (int32_t)x[i] * (int32_t)y[i] : ((int32_t)x[i] - (int32_t)y[i]);
+        res += IP ? v : v * v;
+    }
+    return res;
+}
+
+// |x - y| may reach 255, which doesn't fit int8 but does fit uint8, so it is squared with the unsigned udot
+inline uint32x4_t
+l2_udot(const uint32x4_t acc, const int8x16_t x, const int8x16_t y) {
+    const uint8x16_t diff = vreinterpretq_u8_s8(vabdq_s8(x, y));
+    return vdotq_u32(acc, diff, diff);
+}
+
+}  // namespace
+
+float
+int8_vec_inner_product_neon_dotprod(const int8_t* x, const int8_t* y, size_t d) {
+    int32x4_t sum_0 = vdupq_n_s32(0);
+    int32x4_t sum_1 = vdupq_n_s32(0);
+    size_t i = 0;
+    for (; i + 32 <= d; i += 32) {
+        sum_0 = vdotq_s32(sum_0, vld1q_s8(x + i), vld1q_s8(y + i));
+        sum_1 = vdotq_s32(sum_1, vld1q_s8(x + i + 16), vld1q_s8(y + i + 16));
+    }
+    if (i + 16 <= d) {
+        sum_0 = vdotq_s32(sum_0, vld1q_s8(x + i), vld1q_s8(y + i));
+        i += 16;
+    }
+    return (float)(vaddvq_s32(vaddq_s32(sum_0, sum_1)) + distance_scalar<true>(x + i, y + i, d - i));
+}
+
+float
+int8_vec_L2sqr_neon_dotprod(const int8_t* x, const int8_t* y, size_t d) {
+    uint32x4_t sum_0 = vdupq_n_u32(0);
+    uint32x4_t sum_1 = vdupq_n_u32(0);
+    size_t i = 0;
+    for (; i + 32 <= d; i += 32) {
+        sum_0 = l2_udot(sum_0, vld1q_s8(x + i), vld1q_s8(y + i));
+        sum_1 = l2_udot(sum_1, vld1q_s8(x + i + 16), vld1q_s8(y + i + 16));
+    }
+    if (i + 16 <= d) {
+        sum_0 = l2_udot(sum_0, vld1q_s8(x + i), vld1q_s8(y + i));
+        i += 16;
+    }
+    return (float)((int32_t)vaddvq_u32(vaddq_u32(sum_0, sum_1)) + distance_scalar<false>(x + i, y + i, d - i));
+}
+
+float
+int8_vec_norm_L2sqr_neon_dotprod(const int8_t* x, size_t d) {
+    return int8_vec_inner_product_neon_dotprod(x, x, d);
+}
+
+void
+int8_vec_inner_product_batch_4_neon_dotprod(const int8_t* x, const int8_t* y0, const int8_t* y1, const int8_t* y2,
+                                            const int8_t* y3, const size_t d, float& dis0, float& dis1, float& dis2,
+                                            float& dis3) {
+    int32x4_t sum_0 = vdupq_n_s32(0);
+    int32x4_t sum_1 = vdupq_n_s32(0);
+    int32x4_t sum_2 = vdupq_n_s32(0);
+    int32x4_t sum_3 = vdupq_n_s32(0);
+    size_t i = 0;
+    for (; i + 16 <= d; i += 16) {
+        const int8x16_t a = vld1q_s8(x + i);
+        sum_0 = vdotq_s32(sum_0, a, vld1q_s8(y0 + i));
+        sum_1 = vdotq_s32(sum_1, a, vld1q_s8(y1 + i));
+        sum_2 = vdotq_s32(sum_2, a, vld1q_s8(y2 + i));
+        sum_3 = vdotq_s32(sum_3, a, vld1q_s8(y3 + i));
+    }
+    dis0 = (float)(vaddvq_s32(sum_0) + distance_scalar<true>(x + i, y0 + i, d - i));
+    dis1 = (float)(vaddvq_s32(sum_1) + distance_scalar<true>(x + i, y1 + i, d - i));
+    dis2 = (float)(vaddvq_s32(sum_2) + distance_scalar<true>(x + i, y2 + i, d - i));
+    dis3 = (float)(vaddvq_s32(sum_3) + distance_scalar<true>(x + i, y3 + i, d - i));
+}
+
+void
+int8_vec_L2sqr_batch_4_neon_dotprod(const int8_t* x, const int8_t* y0, const int8_t* y1, const int8_t* y2,
+                                    const int8_t* y3, const size_t d, float& dis0, float& dis1, float& dis2,
+                                    float& dis3) {
+    uint32x4_t sum_0 = vdupq_n_u32(0);
+    uint32x4_t sum_1 = vdupq_n_u32(0);
+    uint32x4_t sum_2 = vdupq_n_u32(0);
+    uint32x4_t sum_3 = vdupq_n_u32(0);
+    size_t i = 0;
+    for (; i + 16 <= d; i += 16) {
+        const int8x16_t a = vld1q_s8(x + i);
+        sum_0 = l2_udot(sum_0, a, vld1q_s8(y0 + i));
+        sum_1 = l2_udot(sum_1, a, vld1q_s8(y1 + i));
+        sum_2 = l2_udot(sum_2, a, vld1q_s8(y2 + i));
+        sum_3 = l2_udot(sum_3, a, vld1q_s8(y3 + i));
+    }
+    dis0 = (float)((int32_t)vaddvq_u32(sum_0) + distance_scalar<false>(x + i, y0 + i, d - i));
+    dis1 = (float)((int32_t)vaddvq_u32(sum_1) + distance_scalar<false>(x + i, y1 + i, d - i));
+    dis2 = (float)((int32_t)vaddvq_u32(sum_2) + distance_scalar<false>(x + i, y2 + i, d - i));
+    dis3 = (float)((int32_t)vaddvq_u32(sum_3) + distance_scalar<false>(x + i, y3 + i, d - i));
+}
+
+}  // namespace knowhere
+}  // namespace cppcontrib
+}  // namespace faiss
+
+#endif
@@ -14,17 +14,20 @@
 #include <faiss/cppcontrib/knowhere/FaissHook.h>
 
 #include <mutex>
+#include <type_traits>
 
 #if defined(__x86_64__)
 #include "distances_avx.h"
 #include "distances_avx512.h"
 #include "distances_avx512icx.h"
+#include "distances_avxvnni.h"
 #include "distances_sse.h"
 #include "instruction_set.h"
 #endif
 
 #if defined(__ARM_NEON)
 #include "distances_neon.h"
+#include "distances_neon_dotprod.h"
 #endif
 
 #if defined(__riscv_vector)
@@ -151,20 +154,41 @@ bool
 supports_sve() {
     return false;
 }
+
+// every Apple silicon has the Armv8.2 dot product instructions
+bool
+supports_dotprod() {
+    return true;
+}
 #else
 bool
 supports_sve() {
     unsigned long hwcap = getauxval(AT_HWCAP);
     return (hwcap & HWCAP_SVE) != 0;
 }
+
+bool
+supports_dotprod() {
+    unsigned long hwcap = getauxval(AT_HWCAP);
+    return (hwcap & HWCAP_ASIMDDP) != 0;
+}
 #endif
 #endif
 
 static std::mutex patch_bf16_mutex;
 
+// the instruction set of the dimension-specialized kernels, picked by fvec_hook
+enum class FixedDimIsa { NONE, AVX2, AVX512, NEON };
+static FixedDimIsa fixed_dim_isa = FixedDimIsa::NONE;
+// the fp32 hooks compute in bf16 precision while the patch is enabled, the specialized kernels do not
+static bool fp32_bf16_patched = false;
+// the int8 hooks use dot product instructions, which beat the specialized kernels
+static bool int8_dot_product = false;
+
 void
 enable_patch_for_fp32_bf16() {
     std::lock_guard<std::mutex> lock(patch_bf16_mutex);
+    fp32_bf16_patched = true;
 #if defined(__x86_64__)
     if (use_avx512 && cpu_support_avx512()) {
         // Cloud branch
@@ -208,6 +232,7 @@ enable_patch_for_fp32_bf16() {
 void
 disable_patch_for_fp32_bf16() {
     std::lock_guard<std::mutex> lock(patch_bf16_mutex);
+    fp32_bf16_patched = false;
 #if defined(__x86_64__)
     if (use_avx512 && cpu_support_avx512()) {
         // Cloud branch
@@ -238,6 +263,8 @@ void
 fvec_hook(std::string& simd_type) {
     static std::mutex hook_mutex;
     std::lock_guard<std::mutex> lock(hook_mutex);
+    fixed_dim_isa = FixedDimIsa::NONE;
+    int8_dot_product = false;
 #if defined(__x86_64__)
     if (use_avx512 && cpu_support_avx512()) {
         fvec_inner_product = fvec_inner_product_avx512;
@@ -282,6 +309,15 @@ fvec_hook(std::string& simd_type) {
 
         int8_vec_inner_product_batch_4 = int8_vec_inner_product_batch_4_avx512;
         int8_vec_L2sqr_batch_4 = int8_vec_L2sqr_batch_4_avx512;
+        if (InstructionSet::GetInstance().AVX512VNNI()) {
+            int8_vec_inner_product = int8_vec_inner_product_avx512icx;
+            int8_vec_L2sqr = int8_vec_L2sqr_avx512icx;
+            int8_vec_norm_L2sqr = int8_vec_norm_L2sqr_avx512icx;
+
+            int8_vec_inner_product_batch_4 = int8_vec_inner_product_batch_4_avx512icx;
+            int8_vec_L2sqr_batch_4 = int8_vec_L2sqr_batch_4_avx512icx;
+            int8_dot_product = true;
+        }
 
         // rabitq
         fvec_masked_sum = fvec_masked_sum_avx512;
@@ -299,6 +335,7 @@ fvec_hook(std::string& simd_type) {
         u64_jaccard_distance = u64_jaccard_distance_avx512;
         u64_jaccard_distance_batch_4 = u64_jaccard_distance_batch_4_avx512;
         //
+        fixed_dim_isa = FixedDimIsa::AVX512;
         simd_type = "AVX512";
         support_pq_fast_scan = true;
     } else if (use_avx2 && cpu_support_avx2()) {
@@ -344,12 +381,24 @@ fvec_hook(std::string& simd_type) {
 
         int8_vec_inner_product_batch_4 = int8_vec_inner_product_batch_4_avx;
         int8_vec_L2sqr_batch_4 = int8_vec_L2sqr_batch_4_avx;
+#if defined(KNOWHERE_WITH_AVXVNNI)
+        if (InstructionSet::GetInstance().AVXVNNI()) {
+            int8_vec_inner_product = int8_vec_inner_product_avxvnni;
+            int8_vec_L2sqr = int8_vec_L2sqr_avxvnni;
+            int8_vec_norm_L2sqr = int8_vec_norm_L2sqr_avxvnni;
+
+            int8_vec_inner_product_batch_4 = int8_vec_inner_product_batch_4_avxvnni;
+            int8_vec_L2sqr_batch_4 = int8_vec_L2sqr_batch_4_avxvnni;
+            int8_dot_product = true;
+        }
+#endif
 
         // rabitq
         fvec_masked_sum = fvec_masked_sum_avx;
         rabitq_dp_popcnt = rabitq_dp_popcnt_avx;
 
         //
+        fixed_dim_isa = FixedDimIsa::AVX2;
         simd_type = "AVX2";
         support_pq_fast_scan = true;
     } else if (use_sse4_2 && cpu_support_sse4_2()) {
@@ -535,7 +584,21 @@ fvec_hook(std::string& simd_type) {
         bf16_vec_inner_product_batch_4 = bf16_vec_inner_product_batch_4_neon;
         bf16_vec_L2sqr_batch_4 = bf16_vec_L2sqr_batch_4_neon;
 
+        // int8
+#if defined(KNOWHERE_WITH_NEON_DOTPROD)
+        if (supports_dotprod()) {
+            int8_vec_inner_product = int8_vec_inner_product_neon_dotprod;
+            int8_vec_L2sqr = int8_vec_L2sqr_neon_dotprod;
+            int8_vec_norm_L2sqr = int8_vec_norm_L2sqr_neon_dotprod;
+
+            int8_vec_inner_product_batch_4 = int8_vec_inner_product_batch_4_neon_dotprod;
+            int8_vec_L2sqr_batch_4 = int8_vec_L2sqr_batch_4_neon_dotprod;
+            int8_dot_product = true;
+        }
+#endif
+
         //
+        fixed_dim_isa = FixedDimIsa::NEON;
         simd_type = "NEON";
         support_pq_fast_scan = true;
 #endif
@@ -614,6 +677,56 @@ fvec_hook(std::string& simd_type) {
 #endif
 }
 
+template <typename DataType>
+DistanceKernels<DataType>
+get_distance_kernels(size_t d) {
+    DistanceKernels<DataType> kernels;
+    if constexpr (std::is_same_v<DataType, float>) {
+        kernels = {fvec_inner_product, fvec_L2sqr, fvec_inner_product_batch_4, fvec_L2sqr_batch_4};
+        if (fp32_bf16_patched) {
+            return kernels;
+        }
+    } else if constexpr (std::is_same_v<DataType, ::knowhere::fp16>) {
+        kernels = {fp16_vec_inner_product, fp16_vec_L2sqr, fp16_vec_inner_product_batch_4, fp16_vec_L2sqr_batch_4};
+    } else if constexpr (std::is_same_v<DataType, ::knowhere::bf16>) {
+        kernels = {bf16_vec_inner_product, bf16_vec_L2sqr, bf16_vec_inner_product_batch_4, bf16_vec_L2sqr_batch_4};
+    } else {
+        static_assert(std::is_same_v<DataType, ::knowhere::int8>, "unsupported data type");
+        kernels = {int8_vec_inner_product, int8_vec_L2sqr, int8_vec_inner_product_batch_4, int8_vec_L2sqr_batch_4};
+        if (int8_dot_product) {
+            return kernels;
+        }
+    }
+
+    switch (fixed_dim_isa) {
+#if defined(__x86_64__)
+        case FixedDimIsa::AVX512:
+            get_fixed_dim_kernels_avx512(d, kernels);
+            break;
+        case FixedDimIsa::AVX2:
+            get_fixed_dim_kernels_avx(d, kernels);
+            break;
+#endif
+#if defined(__ARM_NEON)
+        case FixedDimIsa::NEON:
+            get_fixed_dim_kernels_neon(d, kernels);
+            break;
+#endif
+        default:
+            break;
+    }
+    return kernels;
+}
+
+template DistanceKernels<float>
+get_distance_kernels<float>(size_t);
+template DistanceKernels<::knowhere::fp16>
+get_distance_kernels<::knowhere::fp16>(size_t);
+template DistanceKernels<::knowhere::bf16>
+get_distance_kernels<::knowhere::bf16>(size_t);
+template DistanceKernels<::knowhere::int8>
+get_distance_kernels<::knowhere::int8>(size_t);
+
 static int init_hook_ = []() {
     std::string simd_type;
     fvec_hook(simd_type);
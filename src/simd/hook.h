@@ -16,6 +16,7 @@
 
 #include <string>
 
+#include "distance_kernels.h"
 #include "knowhere/operands.h"
 
 namespace faiss {
@@ -164,6 +165,14 @@ disable_patch_for_fp32_bf16();
 void
 fvec_hook(std::string&);
 
+/// The inner product and L2 kernels of DataType (float, fp16, bf16 or int8) for vectors of dimension `d`. These are
+/// kernels specialized for `d` when it is one of KNOWHERE_FOR_EACH_FIXED_DIM and the selected instruction set has
+/// them, and the hooks above otherwise. Meant to be called once per index or distance computer rather than per
+/// distance; the result stays valid until the hooks are changed.
+template <typename DataType>
+DistanceKernels<DataType>
+get_distance_kernels(size_t d);
+
 }  // namespace knowhere
 }  // namespace cppcontrib
 }  // namespace faiss
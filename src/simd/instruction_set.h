@@ -45,6 +45,7 @@ class InstructionSet {
           f_1_EDX_{0},
           f_7_EBX_{0},
           f_7_ECX_{0},
+          f_7_1_EAX_{0},
           f_81_ECX_{0},
           f_81_EDX_{0},
           data_{},
@@ -84,6 +85,11 @@ class InstructionSet {
         if (nIds_ >= 7) {
             f_7_EBX_ = data_[7][1];
             f_7_ECX_ = data_[7][2];
+            // sub-leaf 1 of function 0x00000007
+            if (data_[7][0] >= 1) {
+                __cpuid_count(7, 1, cpui[0], cpui[1], cpui[2], cpui[3]);
+                f_7_1_EAX_ = cpui[0];
+            }
         }
 
         // Calling __cpuid with 0x80000000 as the function_id argument
@@ -351,11 +357,20 @@ class InstructionSet {
         return isAMD_ && f_81_EDX_[31];
     }
 
+    bool
+    AVX512VNNI() {
+        return f_7_ECX_[11];
+    }
     bool
     AVX512VPOPCNTDQ() {
         return f_7_ECX_[14];
     }
 
+    bool
+    AVXVNNI() {
+        return f_7_1_EAX_[4];
+    }
+
  private:
     int nIds_;
     int nExIds_;
@@ -367,6 +382,7 @@ class InstructionSet {
     std::bitset<32> f_1_EDX_;
     std::bitset<32> f_7_EBX_;
     std::bitset<32> f_7_ECX_;
+    std::bitset<32> f_7_1_EAX_;
     std::bitset<32> f_81_ECX_;
     std::bitset<32> f_81_EDX_;
     std::vector<std::array<int, 4>> data_;
@@ -3,27 +3,132 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <type_traits>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 #include "knowhere/sparse_utils.h"
 #include "simd/instruction_set.h"
 
 namespace knowhere::sparse {
 
+// ============================================================================
+// Bit packed posting list blocks
+// ============================================================================
+// Doc ids of a posting list are compressed in blocks of posting_list_block_size ids. Each id is stored as its gap to
+// the previous id minus 1, where the id before the first one of a block is base - 1, and base is the last id of the
+// previous block plus 1 (or 0 for the first block). All gaps of a block are packed with the same even bit width.
+//
+// The gaps are laid out in 4 lanes like SIMD-BP128: gap i is in lane i % 4 at slot i / 4, each lane is a stream of 16
+// slots of bit_width bits, and the k-th 32-bit word of lane l is stored at word 4 * k + l. A block thus takes
+// 2 * bit_width words, and 4 consecutive gaps are unpacked at once by 128-bit shifts.
+constexpr size_t posting_list_block_size = 64;
+constexpr size_t posting_list_block_lanes = 4;
+constexpr size_t posting_list_block_max_words = 2 * 32;
+
+// Encodes ids[0, n) to out, n must not be larger than posting_list_block_size. Returns the bit width of the block,
+// the number of words written to out is 2 * bit_width.
+inline uint32_t
+encode_posting_block(const uint32_t* ids, size_t n, uint32_t base, uint32_t* out) {
+    uint32_t gaps[posting_list_block_size] = {};
+    uint32_t prev = base - 1;
+    uint32_t gaps_or = 0;
+    for (size_t i = 0; i < n; ++i) {
+        gaps[i] = ids[i] - prev - 1;
+        gaps_or |= gaps[i];
+        prev = ids[i];
+    }
+    uint32_t bit_width = 0;
+    while (bit_width < 32 && (gaps_or >> bit_width) != 0) {
+        ++bit_width;
+    }
+    // an even bit width makes every lane end at a word boundary
+    bit_width = (bit_width + 1) & ~1u;
+
+    std::memset(out, 0, 2 * bit_width * sizeof(uint32_t));
+    for (size_t i = 0; i < n; ++i) {
+        const size_t lane = i % posting_list_block_lanes;
+        const size_t bit = (i / posting_list_block_lanes) * bit_width;
+        const size_t word = bit / 32;
+        const size_t shift = bit % 32;
+        out[word * posting_list_block_lanes + lane] |= gaps[i] << shift;
+        if (shift + bit_width > 32) {
+            out[(word + 1) * posting_list_block_lanes + lane] |= gaps[i] >> (32 - shift);
+        }
+    }
+    return bit_width;
+}
+
+// Decodes a full block encoded by encode_posting_block() to out, which must be able to hold posting_list_block_size
+// ids. Only the first n ids of a block that was encoded with n ids are valid.
+inline void
+decode_posting_block(const uint32_t* in, uint32_t bit_width, uint32_t base, uint32_t* out) {
+    if (bit_width == 0) {
+        // consecutive ids
+        for (size_t i = 0; i < posting_list_block_size; ++i) {
+            out[i] = base + i;
+        }
+        return;
+    }
+#if defined(__SSE2__)
+    const __m128i mask = _mm_set1_epi32(bit_width == 32 ? 0xFFFFFFFFu : (1u << bit_width) - 1);
+    const __m128i one = _mm_set1_epi32(1);
+    __m128i prev = _mm_set1_epi32(base - 1);
+    for (size_t slot = 0; slot < posting_list_block_size / posting_list_block_lanes; ++slot) {
+        const size_t bit = slot * bit_width;
+        const size_t word = bit / 32;
+        const size_t shift = bit % 32;
+        __m128i gaps = _mm_srl_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + word * 4)),
+                                     _mm_cvtsi32_si128(shift));
+        if (shift + bit_width > 32) {
+            const __m128i next = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + word * 4 + 4));
+            gaps = _mm_or_si128(gaps, _mm_sll_epi32(next, _mm_cvtsi32_si128(32 - shift)));
+        }
+        // ids = prev + prefix sum of (gaps + 1)
+        __m128i deltas = _mm_add_epi32(_mm_and_si128(gaps, mask), one);
+        deltas = _mm_add_epi32(deltas, _mm_slli_si128(deltas, 4));
+        deltas = _mm_add_epi32(deltas, _mm_slli_si128(deltas, 8));
+        const __m128i ids = _mm_add_epi32(deltas, prev);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + slot * 4), ids);
+        prev = _mm_shuffle_epi32(ids, _MM_SHUFFLE(3, 3, 3, 3));
+    }
+#else
+    const uint32_t mask = bit_width == 32 ? 0xFFFFFFFFu : (1u << bit_width) - 1;
+    uint32_t prev = base - 1;
+    for (size_t i = 0; i < posting_list_block_size; ++i) {
+        const size_t lane = i % posting_list_block_lanes;
+        const size_t bit = (i / posting_list_block_lanes) * bit_width;
+        const size_t word = bit / 32;
+        const size_t shift = bit % 32;
+        uint32_t gap = in[word * posting_list_block_lanes + lane] >> shift;
+        if (shift + bit_width > 32) {
+            gap |= in[(word + 1) * posting_list_block_lanes + lane] << (32 - shift);
+        }
+        prev += (gap & mask) + 1;
+        out[i] = prev;
+    }
+#endif
+}
+
+// scores[doc_ids[i] - id_base] += q_weight * doc_vals[i] for all i in [0, list_size). id_base lets scores cover a
+// window of the doc ids that starts at id_base, every doc id must not be smaller than it.
 #if defined(__x86_64__) || defined(_M_X64)
 void
 accumulate_posting_list_ip_avx512(const uint32_t* doc_ids, const float* doc_vals, size_t list_size, float q_weight,
-                                  float* scores);
+                                  float* scores, uint32_t id_base = 0);
 #endif
 
 template <typename QType>
 inline void
 accumulate_posting_list_contribution_ip_dispatch(const uint32_t* doc_ids, const QType* doc_vals, size_t list_size,
-                                                 float q_weight, float* scores) {
+                                                 float q_weight, float* scores, uint32_t id_base = 0) {
 #if defined(__x86_64__) || defined(_M_X64)
     if constexpr (std::is_same_v<QType, float>) {
         if (faiss::cppcontrib::knowhere::InstructionSet::GetInstance().AVX512F()) {
-            accumulate_posting_list_ip_avx512(doc_ids, doc_vals, list_size, q_weight, scores);
+            accumulate_posting_list_ip_avx512(doc_ids, doc_vals, list_size, q_weight, scores, id_base);
             return;
         }
     }
@@ -32,7 +137,7 @@ accumulate_posting_list_contribution_ip_dispatch(const uint32_t* doc_ids, const
     // Scalar fallback for IP computation
     for (size_t i = 0; i < list_size; ++i) {
         const auto doc_id = doc_ids[i];
-        scores[doc_id] += q_weight * static_cast<float>(doc_vals[i]);
+        scores[doc_id - id_base] += q_weight * static_cast<float>(doc_vals[i]);
     }
 }
 
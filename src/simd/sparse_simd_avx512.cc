@@ -22,7 +22,7 @@ namespace knowhere::sparse {
 // AVX512 SIMD Implementation (16-wide vectorization with hardware scatter)
 // ============================================================================
 // Accumulates contributions from a single posting list for IP metric
-// scores[doc_ids[i]] += q_weight * doc_vals[i] for all i in [0, list_size)
+// scores[doc_ids[i] - id_base] += q_weight * doc_vals[i] for all i in [0, list_size)
 //
 // TODO: Future optimization - pipelined gathers
 // Moving gathers earlier (gather0, gather1, then compute0, scatter0, compute1, scatter1)
@@ -32,22 +32,26 @@ namespace knowhere::sparse {
 // but would need conflict detection (AVX512CD) for multi-term fusion scenarios.
 void
 accumulate_posting_list_ip_avx512(const uint32_t* doc_ids, const float* doc_vals, size_t list_size, float q_weight,
-                                  float* scores) {
+                                  float* scores, uint32_t id_base) {
     constexpr size_t SIMD_WIDTH = 16;  // AVX512 processes 16 floats
     size_t j = 0;
 
     // Broadcast q_weight to all 16 lanes once before the loops
     __m512 q_weight_vec = _mm512_set1_ps(q_weight);
+    // the ids are made relative to scores before they index it
+    __m512i id_base_vec = _mm512_set1_epi32(static_cast<int>(id_base));
 
     // 2x unrolled SIMD loop to hide gather/scatter latency
     for (; j + 2 * SIMD_WIDTH <= list_size; j += 2 * SIMD_WIDTH) {
         // Chunk 0: elements [j, j+16)
         __m512 vals0 = _mm512_loadu_ps(&doc_vals[j]);
-        __m512i doc_ids0 = _mm512_loadu_si512(reinterpret_cast<const __m512i*>(&doc_ids[j]));
+        __m512i doc_ids0 =
+            _mm512_sub_epi32(_mm512_loadu_si512(reinterpret_cast<const __m512i*>(&doc_ids[j])), id_base_vec);
 
         // Chunk 1: elements [j+16, j+32)
         __m512 vals1 = _mm512_loadu_ps(&doc_vals[j + SIMD_WIDTH]);
-        __m512i doc_ids1 = _mm512_loadu_si512(reinterpret_cast<const __m512i*>(&doc_ids[j + SIMD_WIDTH]));
+        __m512i doc_ids1 = _mm512_sub_epi32(
+            _mm512_loadu_si512(reinterpret_cast<const __m512i*>(&doc_ids[j + SIMD_WIDTH])), id_base_vec);
 
         // Process chunk 0: new_score = current_score + val * q_weight (FMA)
         __m512 current_scores0 = _mm512_i32gather_ps(doc_ids0, scores, sizeof(float));
@@ -63,7 +67,8 @@ accumulate_posting_list_ip_avx512(const uint32_t* doc_ids, const float* doc_vals
     // Handle remaining 16-31 elements
     for (; j + SIMD_WIDTH <= list_size; j += SIMD_WIDTH) {
         __m512 vals = _mm512_loadu_ps(&doc_vals[j]);
-        __m512i doc_ids_vec = _mm512_loadu_si512(reinterpret_cast<const __m512i*>(&doc_ids[j]));
+        __m512i doc_ids_vec =
+            _mm512_sub_epi32(_mm512_loadu_si512(reinterpret_cast<const __m512i*>(&doc_ids[j])), id_base_vec);
         __m512 current_scores = _mm512_i32gather_ps(doc_ids_vec, scores, sizeof(float));
         __m512 new_scores = _mm512_fmadd_ps(vals, q_weight_vec, current_scores);
         _mm512_i32scatter_ps(scores, doc_ids_vec, new_scores, sizeof(float));
@@ -73,7 +78,7 @@ accumulate_posting_list_ip_avx512(const uint32_t* doc_ids, const float* doc_vals
     if (j < list_size) {
         __mmask16 mask = (1u << (list_size - j)) - 1;  // Enable only valid lanes
         __m512 vals = _mm512_maskz_loadu_ps(mask, &doc_vals[j]);
-        __m512i doc_ids_vec = _mm512_maskz_loadu_epi32(mask, &doc_ids[j]);
+        __m512i doc_ids_vec = _mm512_maskz_sub_epi32(mask, _mm512_maskz_loadu_epi32(mask, &doc_ids[j]), id_base_vec);
         __m512 current_scores = _mm512_mask_i32gather_ps(_mm512_setzero_ps(), mask, doc_ids_vec, scores, sizeof(float));
         __m512 new_scores = _mm512_fmadd_ps(vals, q_weight_vec, current_scores);
         _mm512_mask_i32scatter_ps(scores, mask, doc_ids_vec, new_scores, sizeof(float));
@@ -274,3 +274,93 @@ TEST_CASE("Test Brute Force with input ids", "[float vector]") {
     check_search_with_out_ids<knowhere::bf16>(nb, nq, dim, k, metric, conf);
     check_search_with_out_ids<knowhere::int8>(nb, nq, dim, k, metric, conf);
 }
+
+template <typename T>
+void
+check_search_multi_query(const uint64_t nb, const uint64_t nq, const uint64_t dim, const int64_t k,
+                         const knowhere::Json& conf, const knowhere::BitsetView& bitset) {
+    auto train_ds = knowhere::ConvertToDataTypeIfNeeded<T>(GenDataSet(nb, dim));
+    auto query_ds = knowhere::ConvertToDataTypeIfNeeded<T>(GenDataSet(nq, dim));
+
+    // a batch of queries goes through the query-tiled path
+    std::vector<int64_t> ids(nq * k);
+    std::vector<float> dis(nq * k);
+    auto res = knowhere::BruteForce::SearchWithBuf<T>(train_ds, query_ds, ids.data(), dis.data(), conf, bitset);
+    REQUIRE(res == knowhere::Status::success);
+
+    // one query at a time goes through the per-query path
+    for (uint64_t i = 0; i < nq; i++) {
+        auto tensor = (const T*)query_ds->GetTensor() + dim * i;
+        auto single_query_ds = knowhere::GenDataSet(1, dim, tensor);
+        std::vector<int64_t> gt_ids(k);
+        std::vector<float> gt_dis(k);
+        res = knowhere::BruteForce::SearchWithBuf<T>(train_ds, single_query_ds, gt_ids.data(), gt_dis.data(), conf,
+                                                     bitset);
+        REQUIRE(res == knowhere::Status::success);
+        for (int64_t j = 0; j < k; j++) {
+            auto id = ids[i * k + j];
+            REQUIRE((id >= 0 && !bitset.test(id)));
+            REQUIRE(GetRelativeLoss(gt_dis[j], dis[i * k + j]) < 0.0001);
+        }
+    }
+}
+
+TEST_CASE("Test Brute Force multi-query search", "[float vector]") {
+    const int64_t nb = 3000;
+    // enough queries for every search thread to get a block of its own
+    const int64_t nq = 512;
+    const int64_t dim = 96;
+    const int64_t k = 10;
+    auto metric = GENERATE(as<std::string>{}, knowhere::metric::L2, knowhere::metric::IP, knowhere::metric::COSINE);
+    auto filter_rate = GENERATE(0.0f, 0.5f, 0.99f);
+    const knowhere::Json conf = {
+        {knowhere::meta::DIM, dim},
+        {knowhere::meta::METRIC_TYPE, metric},
+        {knowhere::meta::TOPK, k},
+    };
+    auto filter_bits = GenerateBitsetWithRandomTbitsSet(nb, nb * filter_rate);
+    knowhere::BitsetView bitset(filter_bits.data(), nb);
+
+    check_search_multi_query<knowhere::fp32>(nb, nq, dim, k, conf, bitset);
+    check_search_multi_query<knowhere::fp16>(nb, nq, dim, k, conf, bitset);
+    check_search_multi_query<knowhere::bf16>(nb, nq, dim, k, conf, bitset);
+    check_search_multi_query<knowhere::int8>(nb, nq, dim, k, conf, bitset);
+}
+
+TEST_CASE("Test Brute Force with allow list", "[float vector]") {
+    const int64_t nb = 5000;
+    const int64_t nq = 20;
+    const int64_t dim = 64;
+    const int64_t k = 10;
+    auto metric = GENERATE(as<std::string>{}, knowhere::metric::L2, knowhere::metric::IP, knowhere::metric::COSINE);
+    const knowhere::Json conf = {
+        {knowhere::meta::DIM, dim},
+        {knowhere::meta::METRIC_TYPE, metric},
+        {knowhere::meta::TOPK, k},
+    };
+    auto base_ds = GenDataSet(nb, dim);
+    auto query_ds = GenDataSet(nq, dim);
+
+    // fewer allowed rows than k, so that the padding with -1 is covered too
+    auto allowed_num = GENERATE(as<int64_t>{}, 5, 50);
+    auto filter_bits = GenerateBitsetWithRandomTbitsSet(nb, nb - allowed_num);
+    knowhere::BitsetView bitset(filter_bits.data(), nb);
+    std::vector<uint32_t> allow_ids;
+    for (int64_t i = 0; i < nb; i++) {
+        if (!bitset.test(i)) {
+            allow_ids.push_back(i);
+        }
+    }
+    knowhere::BitsetView allow_bitset(filter_bits.data(), nb);
+    allow_bitset.set_allow_list(allow_ids.data(), allow_ids.size());
+    REQUIRE(allow_bitset.count() == nb - allowed_num);
+
+    auto res = knowhere::BruteForce::Search<knowhere::fp32>(base_ds, query_ds, conf, bitset);
+    auto allow_res = knowhere::BruteForce::Search<knowhere::fp32>(base_ds, query_ds, conf, allow_bitset);
+    REQUIRE(res.has_value());
+    REQUIRE(allow_res.has_value());
+    for (int64_t i = 0; i < nq * k; i++) {
+        REQUIRE(res.value()->GetIds()[i] == allow_res.value()->GetIds()[i]);
+        REQUIRE(GetRelativeLoss(res.value()->GetDistance()[i], allow_res.value()->GetDistance()[i]) < 0.0001);
+    }
+}
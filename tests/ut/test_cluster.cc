@@ -46,6 +46,19 @@ TEST_CASE("Test Kmeans With Float Vector", "[float metrics]") {
         return json;
     };
 
+    auto plus_plus_gen = [base_gen]() {
+        knowhere::Json json = base_gen();
+        json[knowhere::indexparam::KMEANS_INIT] = "kmeans++";
+        return json;
+    };
+
+    auto mini_batch_gen = [plus_plus_gen]() {
+        knowhere::Json json = plus_plus_gen();
+        json[knowhere::indexparam::KMEANS_BATCH_SIZE] = 200;
+        json[knowhere::indexparam::KMEANS_N_ITERS] = 50;
+        return json;
+    };
+
     const auto train_ds = GenDataSet(nb, dim);
     const auto query_ds = GenDataSet(nq, dim);
 
@@ -58,7 +71,9 @@ TEST_CASE("Test Kmeans With Float Vector", "[float metrics]") {
     SECTION("Test Kmeans result") {
         using std::make_tuple;
         auto [name, gen] = GENERATE_REF(table<std::string, std::function<knowhere::Json()>>(
-            {make_tuple(knowhere::ClusterEnum::CLUSTER_KMEANS, base_gen)}));
+            {make_tuple(knowhere::ClusterEnum::CLUSTER_KMEANS, base_gen),
+             make_tuple(knowhere::ClusterEnum::CLUSTER_KMEANS, plus_plus_gen),
+             make_tuple(knowhere::ClusterEnum::CLUSTER_KMEANS, mini_batch_gen)}));
         auto cluster = knowhere::ClusterFactory::Instance().Create<knowhere::fp32>(name).value();
         auto cfg_json = gen().dump();
         CAPTURE(name, cfg_json);
@@ -88,4 +103,70 @@ TEST_CASE("Test Kmeans With Float Vector", "[float metrics]") {
         LOG_KNOWHERE_INFO_ << "recall: " << recall;
         REQUIRE(recall > kKnnRecallThreshold);
     }
+
+    SECTION("Test Kmeans centroids and assignment") {
+        // enough clusters for the assignment to go through sgemm tiles
+        const int64_t many_clusters = 100;
+        auto cluster = knowhere::ClusterFactory::Instance()
+                           .Create<knowhere::fp32>(knowhere::ClusterEnum::CLUSTER_KMEANS)
+                           .value();
+        REQUIRE(cluster.Assign(*query_ds).error() == knowhere::Status::empty_index);
+
+        knowhere::Json json;
+        json[NUM_CLUSTERS] = nb + 1;
+        REQUIRE(cluster.Train(*train_ds, json).error() == knowhere::Status::invalid_args);
+        json[NUM_CLUSTERS] = many_clusters;
+        json[knowhere::indexparam::KMEANS_INIT] = "unknown";
+        REQUIRE(!cluster.Train(*train_ds, json).has_value());
+        json[knowhere::indexparam::KMEANS_INIT] = "kmeans++";
+        auto res = cluster.Train(*train_ds, json);
+        REQUIRE(res.has_value());
+
+        auto centroids = cluster.GetCentroids();
+        REQUIRE(centroids.has_value());
+        REQUIRE(centroids.value()->GetRows() == many_clusters);
+        REQUIRE(centroids.value()->GetDim() == dim);
+
+        // the labels of the last iteration are the nearest centroids
+        auto assign_res = cluster.Assign(*train_ds);
+        REQUIRE(assign_res.has_value());
+        auto labels = reinterpret_cast<const uint32_t*>(res.value()->GetTensor());
+        auto assigned = reinterpret_cast<const uint32_t*>(assign_res.value()->GetTensor());
+        std::unordered_set<uint32_t> used;
+        for (int64_t i = 0; i < nb; ++i) {
+            REQUIRE(labels[i] == assigned[i]);
+            used.insert(labels[i]);
+        }
+        REQUIRE(used.size() > many_clusters / 2);
+    }
+}
+
+TEST_CASE("Test Kmeans With Half Precision Vector", "[float metrics]") {
+    const int64_t nb = 1000;
+    const int64_t dim = 64;
+    const int64_t num_clusters = 8;
+
+    auto train_ds = GenDataSet(nb, dim);
+    auto fp16_ds = knowhere::ConvertToDataTypeIfNeeded<knowhere::fp16>(train_ds);
+    auto bf16_ds = knowhere::ConvertToDataTypeIfNeeded<knowhere::bf16>(train_ds);
+
+    knowhere::Json json;
+    json["num_clusters"] = num_clusters;
+
+    auto fp16_cluster =
+        knowhere::ClusterFactory::Instance().Create<knowhere::fp16>(knowhere::ClusterEnum::CLUSTER_KMEANS).value();
+    auto bf16_cluster =
+        knowhere::ClusterFactory::Instance().Create<knowhere::bf16>(knowhere::ClusterEnum::CLUSTER_KMEANS).value();
+    for (auto [cluster, ds] : {std::make_pair(fp16_cluster, fp16_ds), std::make_pair(bf16_cluster, bf16_ds)}) {
+        auto res = cluster.Train(*ds, json);
+        REQUIRE(res.has_value());
+        REQUIRE(res.value()->GetRows() == nb);
+        auto labels = reinterpret_cast<const uint32_t*>(res.value()->GetTensor());
+        for (int64_t i = 0; i < nb; ++i) {
+            REQUIRE(labels[i] < num_clusters);
+        }
+        auto centroids = cluster.GetCentroids();
+        REQUIRE(centroids.has_value());
+        REQUIRE(centroids.value()->GetRows() == num_clusters);
+    }
 }
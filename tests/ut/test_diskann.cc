@@ -20,11 +20,14 @@
 #include "catch2/catch_test_macros.hpp"
 #include "catch2/generators/catch_generators.hpp"
 #include "diskann/diskann_gpu.h"
+#include "diskann/pq_flash_index.h"
+#include "diskann/uring_aligned_file_reader.h"
 #include "filemanager/FileManager.h"
 #include "filemanager/impl/LocalFileManager.h"
 #include "index/diskann/diskann_config.h"
 #include "knowhere/comp/brute_force.h"
 #include "knowhere/comp/knowhere_check.h"
+#include "knowhere/comp/knowhere_config.h"
 #include "knowhere/context.h"
 #include "knowhere/expected.h"
 #include "knowhere/index/index_factory.h"
@@ -356,6 +359,48 @@ base_search() {
                 REQUIRE(res.has_value());
                 REQUIRE(GetKNNRecall(*knn_gt_ptr, *res.value()) >= kKnnRecall);
             }
+            // interleaving queries on a thread does not change their results
+            {
+                knowhere::Json batch_json = knn_json;
+                batch_json[knowhere::indexparam::QUERIES_PER_THREAD] = 8;
+                auto batch_res = diskann.Search(query_ds, batch_json, nullptr);
+                REQUIRE(batch_res.has_value());
+                auto ids = res.value()->GetIds();
+                auto batch_ids = batch_res.value()->GetIds();
+                REQUIRE(std::equal(ids, ids + kNumQueries * kK, batch_ids));
+            }
+            // nodes served by the adaptive cache are the bytes earlier searches read, so results stay the same
+            {
+                knowhere::Json adaptive_json = deserialize_json;
+                adaptive_json[knowhere::indexparam::SEARCH_CACHE_ADAPTIVE_RATIO] = 1.0f;
+                auto diskann_adaptive =
+                    knowhere::IndexFactory::Instance().Create<DataType>("DISKANN", version, diskann_index_pack).value();
+                diskann_adaptive.Deserialize(binset, adaptive_json);
+                auto ids = res.value()->GetIds();
+                for (int round = 0; round < 2; round++) {
+                    auto adaptive_res = diskann_adaptive.Search(query_ds, knn_json, nullptr);
+                    REQUIRE(adaptive_res.has_value());
+                    auto adaptive_ids = adaptive_res.value()->GetIds();
+                    REQUIRE(std::equal(ids, ids + kNumQueries * kK, adaptive_ids));
+                }
+                knowhere::Json batch_json = knn_json;
+                batch_json[knowhere::indexparam::QUERIES_PER_THREAD] = 8;
+                auto batch_res = diskann_adaptive.Search(query_ds, batch_json, nullptr);
+                REQUIRE(batch_res.has_value());
+                REQUIRE(std::equal(ids, ids + kNumQueries * kK, batch_res.value()->GetIds()));
+            }
+            // knn search through io_uring reads the same sectors as libaio
+            if (knowhere::KnowhereConfig::SetDiskIOEngine(knowhere::KnowhereConfig::DiskIOEngine::URING)) {
+                auto diskann_uring =
+                    knowhere::IndexFactory::Instance().Create<DataType>("DISKANN", version, diskann_index_pack).value();
+                diskann_uring.Deserialize(binset, deserialize_json);
+                auto uring_res = diskann_uring.Search(query_ds, knn_json, nullptr);
+                REQUIRE(knowhere::KnowhereConfig::SetDiskIOEngine(knowhere::KnowhereConfig::DiskIOEngine::AIO));
+                REQUIRE(uring_res.has_value());
+                auto ids = res.value()->GetIds();
+                auto uring_ids = uring_res.value()->GetIds();
+                REQUIRE(std::equal(ids, ids + kNumQueries * kK, uring_ids));
+            }
             // knn search with bitset
             std::vector<std::function<std::vector<uint8_t>(size_t, size_t)>> gen_bitset_funcs = {
                 GenerateBitsetWithFirstTbitsSet, GenerateBitsetWithRandomTbitsSet};
@@ -710,6 +755,252 @@ TEST_CASE("Test DiskANN GetVectorByIds", "[diskann]") {
     fs::remove(kDir);
 }
 
+TEST_CASE("Test DiskANN Add after load", "[diskann]") {
+    auto version = GenTestVersionList();
+    constexpr uint32_t kNumAdded = 200;
+    auto metric_str = GENERATE(as<std::string>{}, knowhere::metric::L2, knowhere::metric::COSINE);
+    auto index_dir = metric_str == knowhere::metric::L2 ? kL2IndexDir : kCOSINEIndexDir;
+    auto index_prefix = metric_str == knowhere::metric::L2 ? kL2IndexPrefix : kCOSINEIndexPrefix;
+    fs::remove_all(kDir);
+    fs::remove(kDir);
+    REQUIRE_NOTHROW(fs::create_directories(index_dir));
+
+    auto base_gen = [&] {
+        knowhere::Json json;
+        json["dim"] = kDim;
+        json["metric_type"] = metric_str;
+        json["k"] = kK;
+        return json;
+    };
+    auto build_json = base_gen();
+    build_json["index_prefix"] = index_prefix;
+    build_json["data_path"] = kRawDataPath;
+    build_json["max_degree"] = 32;
+    build_json["search_list_size"] = kK;
+    build_json["pq_code_budget_gb"] = sizeof(float) * kDim * kNumRows * 0.03125 / (1024 * 1024 * 1024);
+    build_json["build_dram_budget_gb"] = 32.0;
+
+    auto base_ds = GenDataSet(kNumRows, kDim, 30);
+    WriteRawDataToDisk<float>(kRawDataPath, static_cast<const float*>(base_ds->GetTensor()), kNumRows, kDim);
+
+    std::shared_ptr<milvus::FileManager> file_manager = std::make_shared<milvus::LocalFileManager>();
+    auto diskann_index_pack = knowhere::Pack(file_manager);
+    auto diskann =
+        knowhere::IndexFactory::Instance().Create<knowhere::fp32>("DISKANN", version, diskann_index_pack).value();
+    knowhere::DataSetPtr ds_ptr = nullptr;
+    REQUIRE(diskann.Build(ds_ptr, build_json) == knowhere::Status::success);
+    knowhere::BinarySet binset;
+    diskann.Serialize(binset);
+
+    auto index =
+        knowhere::IndexFactory::Instance().Create<knowhere::fp32>("DISKANN", version, diskann_index_pack).value();
+    auto added_ds = GenDataSet(kNumAdded, kDim, 50);
+    auto add_json = base_gen();
+    add_json["max_degree"] = 32;
+    add_json["search_list_size"] = 64;
+    add_json["pq_code_budget_gb"] = build_json["pq_code_budget_gb"];
+    add_json["build_dram_budget_gb"] = build_json["build_dram_budget_gb"];
+    add_json[knowhere::indexparam::DELTA_MAX_POINTS] = kNumAdded;
+    // points can only be added once the index is loaded
+    REQUIRE(index.Add(added_ds, add_json) == knowhere::Status::not_implemented);
+
+    auto deserialize_json = base_gen();
+    deserialize_json["index_prefix"] = index_prefix;
+    REQUIRE(index.Deserialize(binset, deserialize_json) == knowhere::Status::success);
+    // both halves fit in the in-memory delta
+    auto half = kNumAdded / 2;
+    auto xa = static_cast<const float*>(added_ds->GetTensor());
+    REQUIRE(index.Add(knowhere::GenDataSet(half, kDim, xa), add_json) == knowhere::Status::success);
+    REQUIRE(index.Add(knowhere::GenDataSet(kNumAdded - half, kDim, xa + half * kDim), add_json) ==
+            knowhere::Status::success);
+    REQUIRE(index.Count() == kNumRows + kNumAdded);
+
+    // the added points are kept by Serialize
+    knowhere::BinarySet delta_binset;
+    REQUIRE(index.Serialize(delta_binset) == knowhere::Status::success);
+    index = knowhere::IndexFactory::Instance().Create<knowhere::fp32>("DISKANN", version, diskann_index_pack).value();
+    REQUIRE(index.Deserialize(delta_binset, deserialize_json) == knowhere::Status::success);
+    REQUIRE(index.Count() == kNumRows + kNumAdded);
+
+    // every added point finds itself
+    auto query_ds = GenDataSet(kNumAdded, kDim, 50);
+    auto knn_json = base_gen();
+    knn_json["search_list_size"] = 36;
+    auto res = index.Search(query_ds, knn_json, nullptr);
+    REQUIRE(res.has_value());
+    auto ids = res.value()->GetIds();
+    for (uint32_t i = 0; i < kNumAdded; ++i) {
+        REQUIRE(ids[i * kK] == kNumRows + i);
+    }
+
+    // deleted added points are filtered like the ones on disk
+    std::vector<uint8_t> bitset_data((kNumRows + kNumAdded + 7) / 8, 0);
+    for (uint32_t i = kNumRows; i < kNumRows + kNumAdded; ++i) {
+        bitset_data[i >> 3] |= 1 << (i & 7);
+    }
+    knowhere::BitsetView bitset(bitset_data.data(), kNumRows + kNumAdded);
+    auto filtered_res = index.Search(query_ds, knn_json, bitset);
+    REQUIRE(filtered_res.has_value());
+    auto filtered_ids = filtered_res.value()->GetIds();
+    for (uint32_t i = 0; i < kNumAdded * kK; ++i) {
+        REQUIRE(filtered_ids[i] < kNumRows);
+    }
+
+    // the raw vectors of both the disk and the added points are returned
+    std::vector<int64_t> raw_ids = {0, kNumRows - 1, kNumRows, kNumRows + kNumAdded - 1};
+    auto raw_res = index.GetVectorByIds(GenIdsDataSet(raw_ids.size(), raw_ids));
+    REQUIRE(raw_res.has_value());
+    auto raw = static_cast<const float*>(raw_res.value()->GetTensor());
+    auto xb = static_cast<const float*>(base_ds->GetTensor());
+    for (size_t i = 0; i < raw_ids.size(); ++i) {
+        auto expected = raw_ids[i] < kNumRows ? xb + raw_ids[i] * kDim : xa + (raw_ids[i] - kNumRows) * kDim;
+        for (uint32_t j = 0; j < kDim; ++j) {
+            REQUIRE(raw[i * kDim + j] == Catch::Approx(expected[j]).epsilon(1e-4));
+        }
+    }
+
+    // iterators and range search cover the added points too, each added point is the closest to itself
+    auto iterators = index.AnnIterator(query_ds, knn_json, nullptr);
+    REQUIRE(iterators.has_value());
+    for (uint32_t i = 0; i < kNumAdded; ++i) {
+        REQUIRE(iterators.value()[i]->HasNext());
+        REQUIRE(iterators.value()[i]->Next().first == kNumRows + i);
+    }
+    auto range_json = base_gen();
+    range_json["search_list_size"] = 36;
+    range_json[knowhere::meta::RADIUS] = metric_str == knowhere::metric::L2 ? 1e-3 : 0.999;
+    range_json[knowhere::meta::RANGE_FILTER] = metric_str == knowhere::metric::L2 ? -1.0 : 1.001;
+    auto range_res = index.RangeSearch(query_ds, range_json, nullptr);
+    REQUIRE(range_res.has_value());
+    auto lims = range_res.value()->GetLims();
+    auto range_ids = range_res.value()->GetIds();
+    for (uint32_t i = 0; i < kNumAdded; ++i) {
+        REQUIRE(std::find(range_ids + lims[i], range_ids + lims[i + 1], kNumRows + i) != range_ids + lims[i + 1]);
+    }
+
+    // one more point goes past the bound of the delta, all the added points are merged into the index files and keep
+    // their ids
+    auto extra_ds = GenDataSet(1, kDim, 70);
+    REQUIRE(index.Add(extra_ds, add_json) == knowhere::Status::success);
+    REQUIRE(index.Count() == kNumRows + kNumAdded + 1);
+    knowhere::BinarySet merged_binset;
+    REQUIRE(index.Serialize(merged_binset) == knowhere::Status::success);
+    REQUIRE_FALSE(merged_binset.Contains(std::string(knowhere::IndexEnum::INDEX_DISKANN) + "_delta"));
+    auto merged_index =
+        knowhere::IndexFactory::Instance().Create<knowhere::fp32>("DISKANN", version, diskann_index_pack).value();
+    REQUIRE(merged_index.Deserialize(merged_binset, deserialize_json) == knowhere::Status::success);
+    REQUIRE(merged_index.Count() == kNumRows + kNumAdded + 1);
+    auto check_merged = [&](const auto& loaded) {
+        auto merged_raw_res = loaded.GetVectorByIds(GenIdsDataSet(raw_ids.size(), raw_ids));
+        REQUIRE(merged_raw_res.has_value());
+        auto merged_raw = static_cast<const float*>(merged_raw_res.value()->GetTensor());
+        for (size_t i = 0; i < raw_ids.size() * kDim; ++i) {
+            REQUIRE(merged_raw[i] == Catch::Approx(raw[i]).epsilon(1e-4));
+        }
+        auto merged_res = loaded.Search(query_ds, knn_json, nullptr);
+        REQUIRE(merged_res.has_value());
+        auto merged_ids = merged_res.value()->GetIds();
+        uint32_t found = 0;
+        for (uint32_t i = 0; i < kNumAdded; ++i) {
+            found += merged_ids[i * kK] == kNumRows + i;
+        }
+        REQUIRE(found >= kNumAdded * 0.9);
+    };
+    check_merged(index);
+    check_merged(merged_index);
+    fs::remove_all(kDir);
+    fs::remove(kDir);
+}
+
+TEST_CASE("Test DiskANN BFS layout", "[diskann]") {
+    auto version = GenTestVersionList();
+    constexpr uint32_t kNumLayoutRows = 5000;
+    constexpr uint32_t kNumLayoutQueries = 100;
+    constexpr uint32_t kLayoutSearchListSize = 64;
+    constexpr uint32_t kLayoutBeamwidth = 8;
+    fs::remove_all(kDir);
+    fs::remove(kDir);
+    REQUIRE_NOTHROW(fs::create_directories(kL2IndexDir));
+
+    auto base_gen = [] {
+        knowhere::Json json;
+        json["dim"] = kDim;
+        json["metric_type"] = knowhere::metric::L2;
+        json["k"] = kK;
+        return json;
+    };
+
+    auto base_ds = GenDataSet(kNumLayoutRows, kDim, 30);
+    auto query_ds = GenDataSet(kNumLayoutQueries, kDim, 42);
+    auto base_ptr = static_cast<const float*>(base_ds->GetTensor());
+    auto query_ptr = static_cast<const float*>(query_ds->GetTensor());
+    WriteRawDataToDisk<float>(kRawDataPath, base_ptr, kNumLayoutRows, kDim);
+    auto gt = knowhere::BruteForce::Search<knowhere::fp32>(base_ds, query_ds, base_gen(), nullptr);
+    REQUIRE(gt.has_value());
+
+    std::shared_ptr<milvus::FileManager> file_manager = std::make_shared<milvus::LocalFileManager>();
+    auto diskann_index_pack = knowhere::Pack(file_manager);
+
+    // sectors read from disk over all the queries, with the nodes in id order and in bfs order
+    uint64_t n_ios[2] = {0, 0};
+    for (const bool reorder : {false, true}) {
+        const auto index_prefix = kL2IndexDir + (reorder ? "/bfs" : "/id");
+        auto build_json = base_gen();
+        build_json["index_prefix"] = index_prefix;
+        build_json["data_path"] = kRawDataPath;
+        build_json["max_degree"] = 32;
+        build_json["search_list_size"] = 64;
+        build_json["pq_code_budget_gb"] = sizeof(float) * kDim * kNumLayoutRows * 0.03125 / (1024 * 1024 * 1024);
+        build_json["build_dram_budget_gb"] = 32.0;
+        build_json["reorder"] = reorder;
+
+        auto diskann =
+            knowhere::IndexFactory::Instance().Create<knowhere::fp32>("DISKANN", version, diskann_index_pack).value();
+        knowhere::DataSetPtr ds_ptr = nullptr;
+        REQUIRE(diskann.Build(ds_ptr, build_json) == knowhere::Status::success);
+        knowhere::BinarySet binset;
+        REQUIRE(diskann.Serialize(binset) == knowhere::Status::success);
+
+        auto deserialize_json = base_gen();
+        deserialize_json["index_prefix"] = index_prefix;
+        auto index =
+            knowhere::IndexFactory::Instance().Create<knowhere::fp32>("DISKANN", version, diskann_index_pack).value();
+        REQUIRE(index.Deserialize(binset, deserialize_json) == knowhere::Status::success);
+
+        // the layout moves the nodes, not the ids
+        auto ids_ds = GenIdsDataSet(kNumLayoutRows, kNumLayoutRows);
+        auto vectors = index.GetVectorByIds(ids_ds);
+        REQUIRE(vectors.has_value());
+        auto data = static_cast<const float*>(vectors.value()->GetTensor());
+        for (uint32_t i = 0; i < kNumLayoutRows; ++i) {
+            auto id = ids_ds->GetIds()[i];
+            REQUIRE(std::memcmp(data + i * kDim, base_ptr + id * kDim, kDim * sizeof(float)) == 0);
+        }
+        auto search_json = base_gen();
+        search_json["search_list_size"] = kLayoutSearchListSize;
+        search_json["beamwidth"] = kLayoutBeamwidth;
+        auto res = index.Search(query_ds, search_json, nullptr);
+        REQUIRE(res.has_value());
+        REQUIRE(GetKNNRecall(*gt.value(), *res.value()) >= kKnnRecall);
+
+        std::shared_ptr<AlignedFileReader> reader = diskann::create_aligned_file_reader();
+        diskann::PQFlashIndex<float> flash_index(reader, diskann::Metric::L2);
+        REQUIRE(flash_index.load(1, index_prefix.c_str()) == 0);
+        std::vector<int64_t> ids(kK);
+        std::vector<float> dists(kK);
+        for (uint32_t i = 0; i < kNumLayoutQueries; ++i) {
+            diskann::QueryStats stats;
+            flash_index.cached_beam_search(query_ptr + i * kDim, kK, kLayoutSearchListSize, ids.data(), dists.data(),
+                                           kLayoutBeamwidth, false, &stats);
+            n_ios[reorder] += stats.n_ios;
+        }
+    }
+    LOG_KNOWHERE_INFO_ << "sectors read with nodes in id order: " << n_ios[0] << ", in bfs order: " << n_ios[1];
+    REQUIRE(n_ios[1] < n_ios[0]);
+    fs::remove_all(kDir);
+    fs::remove(kDir);
+}
+
 TEST_CASE("Test_AiSAQ_dynamic_cache", "[diskann]") {
     std::string index_type = "AISAQ";
     constexpr uint32_t kNumRowsTest = 10000;
@@ -14,6 +14,8 @@
 #include "catch2/catch_approx.hpp"
 #include "catch2/catch_test_macros.hpp"
 #include "catch2/generators/catch_generators.hpp"
+#include "faiss/cppcontrib/knowhere/IndexFlat.h"
+#include "faiss/cppcontrib/knowhere/IndexIVFFlatTyped.h"
 #include "knowhere/comp/index_param.h"
 #include "knowhere/comp/knowhere_check.h"
 #include "knowhere/comp/knowhere_config.h"
@@ -242,3 +244,152 @@ TEST_CASE("Test Float Get Vector By Ids", "[Float GetVectorByIds]") {
         }
     }
 }
+
+template <typename T>
+void
+check_low_precision_flat(const std::string& metric) {
+    const int64_t nb = 1000;
+    const int64_t nq = 100;
+    const int64_t dim = 128;
+    auto version = GenTestVersionList();
+
+    knowhere::Json json;
+    json[knowhere::meta::DIM] = dim;
+    json[knowhere::meta::METRIC_TYPE] = metric;
+    json[knowhere::meta::TOPK] = 1;
+
+    auto name = knowhere::IndexEnum::INDEX_FAISS_IDMAP;
+    auto train_ds = knowhere::ConvertToDataTypeIfNeeded<T>(GenDataSet(nb, dim));
+    auto ids_ds = GenIdsDataSet(nb, nq);
+
+    auto idx = knowhere::IndexFactory::Instance().Create<T>(name, version).value();
+    REQUIRE(idx.Build(train_ds, json) == knowhere::Status::success);
+    // vectors are kept in their own type, not widened to fp32
+    REQUIRE(idx.Size() == nb * dim * (int64_t)sizeof(T));
+
+    knowhere::BinarySet bs;
+    REQUIRE(idx.Serialize(bs) == knowhere::Status::success);
+    auto idx_new = knowhere::IndexFactory::Instance().Create<T>(name, version).value();
+    REQUIRE(idx_new.Deserialize(bs) == knowhere::Status::success);
+
+    auto results = idx_new.GetVectorByIds(ids_ds);
+    REQUIRE(results.has_value());
+    auto xb = (const T*)train_ds->GetTensor();
+    auto res_data = (const T*)results.value()->GetTensor();
+    REQUIRE(results.value()->GetRows() == nq);
+    for (int i = 0; i < nq; ++i) {
+        const auto id = ids_ds->GetIds()[i];
+        REQUIRE(std::memcmp(res_data + i * dim, xb + id * dim, dim * sizeof(T)) == 0);
+    }
+
+    // every base vector finds itself
+    auto query_ds = knowhere::GenDataSet(nq, dim, train_ds->GetTensor());
+    auto search_res = idx_new.Search(query_ds, json, nullptr);
+    REQUIRE(search_res.has_value());
+    for (int i = 0; i < nq; ++i) {
+        REQUIRE(search_res.value()->GetIds()[i] == i);
+    }
+}
+
+TEST_CASE("Test Low Precision Flat Get Vector By Ids", "[Float GetVectorByIds]") {
+    auto metric = GENERATE(as<std::string>{}, knowhere::metric::L2, knowhere::metric::COSINE);
+    check_low_precision_flat<knowhere::fp16>(metric);
+    check_low_precision_flat<knowhere::bf16>(metric);
+    check_low_precision_flat<knowhere::int8>(metric);
+}
+
+template <typename T>
+void
+check_low_precision_ivf_flat(const std::string& name, const std::string& metric) {
+    const int64_t nb = 1000;
+    const int64_t nq = 100;
+    const int64_t dim = 128;
+    const int64_t nlist = 16;
+    auto version = GenTestVersionList();
+
+    knowhere::Json json;
+    json[knowhere::meta::DIM] = dim;
+    json[knowhere::meta::METRIC_TYPE] = metric;
+    json[knowhere::meta::TOPK] = 1;
+    json[knowhere::indexparam::NLIST] = nlist;
+    json[knowhere::indexparam::NPROBE] = nlist;
+    json[knowhere::indexparam::SSIZE] = 48;
+
+    auto train_ds = knowhere::ConvertToDataTypeIfNeeded<T>(GenDataSet(nb, dim));
+    auto ids_ds = GenIdsDataSet(nb, nq);
+
+    auto idx = knowhere::IndexFactory::Instance().Create<T>(name, version).value();
+    REQUIRE(idx.Build(train_ds, json) == knowhere::Status::success);
+    // inverted lists hold the vectors in their own type, only the centroids are fp32
+    REQUIRE(idx.Size() < nb * dim * (int64_t)sizeof(float));
+
+    knowhere::BinarySet bs;
+    REQUIRE(idx.Serialize(bs) == knowhere::Status::success);
+    auto idx_new = knowhere::IndexFactory::Instance().Create<T>(name, version).value();
+    REQUIRE(idx_new.Deserialize(bs) == knowhere::Status::success);
+
+    auto results = idx_new.GetVectorByIds(ids_ds);
+    REQUIRE(results.has_value());
+    auto xb = (const T*)train_ds->GetTensor();
+    auto res_data = (const T*)results.value()->GetTensor();
+    REQUIRE(results.value()->GetRows() == nq);
+    for (int i = 0; i < nq; ++i) {
+        const auto id = ids_ds->GetIds()[i];
+        REQUIRE(std::memcmp(res_data + i * dim, xb + id * dim, dim * sizeof(T)) == 0);
+    }
+
+    // every base vector finds itself when all the lists are probed
+    auto query_ds = knowhere::GenDataSet(nq, dim, train_ds->GetTensor());
+    auto search_res = idx_new.Search(query_ds, json, nullptr);
+    REQUIRE(search_res.has_value());
+    for (int i = 0; i < nq; ++i) {
+        REQUIRE(search_res.value()->GetIds()[i] == i);
+    }
+}
+
+// distance_to_code() is used by the inverted list iterators, it has to agree with scan_codes_and_return()
+template <typename T>
+void
+check_low_precision_ivf_flat_cosine_distance_to_code() {
+    const int64_t nb = 200;
+    const int64_t dim = 32;
+    const int64_t nlist = 4;
+    auto train_ds = GenDataSet(nb, dim);
+    auto xb = (const float*)train_ds->GetTensor();
+
+    faiss::cppcontrib::knowhere::IndexFlat quantizer(dim, faiss::METRIC_INNER_PRODUCT);
+    faiss::cppcontrib::knowhere::IndexIVFFlatTyped<T> ivf(&quantizer, dim, nlist, faiss::METRIC_INNER_PRODUCT, true);
+    ivf.train(nb, xb);
+    ivf.add(nb, xb);
+
+    std::unique_ptr<faiss::cppcontrib::knowhere::InvertedListScanner> scanner(
+        ivf.get_InvertedListScanner(false, nullptr, nullptr));
+    scanner->set_query(xb);
+    for (int64_t list_no = 0; list_no < nlist; list_no++) {
+        scanner->set_list(list_no, 0);
+        const auto list_size = ivf.invlists->list_size(list_no);
+        const auto codes = ivf.invlists->get_codes(list_no);
+        std::vector<knowhere::DistId> scanned;
+        scanner->scan_codes_and_return(list_size, codes, ivf.invlists->get_code_norms(list_no, 0),
+                                       ivf.invlists->get_ids(list_no), scanned);
+        REQUIRE(scanned.size() == list_size);
+        for (size_t j = 0; j < list_size; j++) {
+            REQUIRE(scanner->distance_to_code(codes + j * ivf.code_size) == Catch::Approx(scanned[j].val));
+        }
+    }
+}
+
+TEST_CASE("Test Low Precision IVF Flat Cosine Distance To Code", "[Float GetVectorByIds]") {
+    check_low_precision_ivf_flat_cosine_distance_to_code<knowhere::fp16>();
+    check_low_precision_ivf_flat_cosine_distance_to_code<knowhere::bf16>();
+    check_low_precision_ivf_flat_cosine_distance_to_code<knowhere::int8>();
+}
+
+TEST_CASE("Test Low Precision IVF Flat Get Vector By Ids", "[Float GetVectorByIds]") {
+    auto name = GENERATE(as<std::string>{}, knowhere::IndexEnum::INDEX_FAISS_IVFFLAT,
+                         knowhere::IndexEnum::INDEX_FAISS_IVFFLAT_CC);
+    auto metric = GENERATE(as<std::string>{}, knowhere::metric::L2, knowhere::metric::COSINE);
+    check_low_precision_ivf_flat<knowhere::fp16>(name, metric);
+    check_low_precision_ivf_flat<knowhere::bf16>(name, metric);
+    check_low_precision_ivf_flat<knowhere::int8>(name, metric);
+}
@@ -50,6 +50,10 @@ TEST_CASE("Knowhere global config", "[init]") {
 #ifdef KNOWHERE_WITH_DISKANN
     REQUIRE_FALSE(knowhere::KnowhereConfig::SetAioContextPool(0));
     REQUIRE(knowhere::KnowhereConfig::SetAioContextPool(16));
+    REQUIRE(knowhere::KnowhereConfig::SetDiskIOEngine(knowhere::KnowhereConfig::DiskIOEngine::AIO));
+    // io_uring may be unavailable on the test host, either way libaio must stay usable
+    knowhere::KnowhereConfig::SetDiskIOEngine(knowhere::KnowhereConfig::DiskIOEngine::URING);
+    REQUIRE(knowhere::KnowhereConfig::SetDiskIOEngine(knowhere::KnowhereConfig::DiskIOEngine::AIO));
 #endif
 
 #ifdef KNOWHERE_WITH_CUVS
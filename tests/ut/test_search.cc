@@ -13,6 +13,7 @@
 #include <folly/futures/Future.h>
 
 #include <atomic>
+#include <cstring>
 #include <thread>
 
 #include "catch2/catch_approx.hpp"
@@ -448,6 +449,37 @@ TEST_CASE("Test Mem Index With Float Vector", "[float metrics]") {
         }
     }
 
+    SECTION("Test IVF Search with a large batch of queries") {
+        using std::make_tuple;
+        auto [name, gen] = GENERATE_REF(table<std::string, std::function<knowhere::Json()>>({
+            make_tuple(knowhere::IndexEnum::INDEX_FAISS_IVFFLAT, ivfflat_gen),
+            make_tuple(knowhere::IndexEnum::INDEX_FAISS_IVFSQ8, ivfsq_gen),
+            make_tuple(knowhere::IndexEnum::INDEX_FAISS_IVFPQ, ivfpq_gen),
+        }));
+        auto idx = knowhere::IndexFactory::Instance().Create<knowhere::fp32>(name, version).value();
+        auto cfg_json = gen().dump();
+        CAPTURE(name, cfg_json);
+        knowhere::Json json = knowhere::Json::parse(cfg_json);
+        REQUIRE(idx.Build(train_ds, json) == knowhere::Status::success);
+
+        // enough queries to search several queries per task, using the list-major scan
+        const int64_t large_nq = 32 * knowhere::ThreadPool::GetGlobalSearchThreadPoolSize();
+        const auto large_query_ds = GenDataSet(large_nq, dim, 7);
+        const auto small_query_ds = CopyDataSet(large_query_ds, nq);
+
+        auto large_results = idx.Search(large_query_ds, json, nullptr);
+        REQUIRE(large_results.has_value());
+        auto small_results = idx.Search(small_query_ds, json, nullptr);
+        REQUIRE(small_results.has_value());
+
+        // the batched search returns the same results as the query-by-query search
+        REQUIRE(GetKNNRecall(*large_results.value(), *small_results.value()) > kBruteForceRecallThreshold);
+        if (name == knowhere::IndexEnum::INDEX_FAISS_IVFFLAT) {
+            auto large_gt = knowhere::BruteForce::Search<knowhere::fp32>(train_ds, large_query_ds, conf, nullptr);
+            REQUIRE(GetKNNRecall(*large_gt.value(), *large_results.value()) > kKnnRecallThreshold);
+        }
+    }
+
     SECTION("Test Search with Bitset") {
         using std::make_tuple;
         auto [name, gen, threshold] = GENERATE_REF(table<std::string, std::function<knowhere::Json()>, float>({
@@ -481,6 +513,112 @@ TEST_CASE("Test Mem Index With Float Vector", "[float metrics]") {
         }
     }
 
+    SECTION("Test Search with Allow List") {
+        using std::make_tuple;
+        auto [name, gen] = GENERATE_REF(table<std::string, std::function<knowhere::Json()>>({
+            make_tuple(knowhere::IndexEnum::INDEX_HNSW, hnsw_gen),
+            make_tuple(knowhere::IndexEnum::INDEX_HNSW_SQ, hnsw_gen),
+        }));
+        auto idx = knowhere::IndexFactory::Instance().Create<knowhere::fp32>(name, version).value();
+        auto cfg_json = gen().dump();
+        CAPTURE(name, cfg_json);
+        knowhere::Json json = knowhere::Json::parse(cfg_json);
+        REQUIRE(idx.Build(train_ds, json) == knowhere::Status::success);
+
+        // few enough rows pass the filter for every search to fall back to brute force
+        auto bitset_data = GenerateBitsetWithRandomTbitsSet(nb, nb - nb / 200);
+        knowhere::BitsetView bitset(bitset_data.data(), nb);
+        std::vector<uint32_t> allow_ids;
+        for (int64_t i = 0; i < nb; i++) {
+            if (!bitset.test(i)) {
+                allow_ids.push_back(i);
+            }
+        }
+        knowhere::BitsetView allow_bitset(bitset_data.data(), nb);
+        allow_bitset.set_allow_list(allow_ids.data(), allow_ids.size());
+        REQUIRE(allow_bitset.count() == bitset.get_filtered_out_num_());
+        REQUIRE(allow_bitset.get_first_valid_index() == bitset.get_first_valid_index());
+
+        auto results = idx.Search(query_ds, json, bitset);
+        auto allow_results = idx.Search(query_ds, json, allow_bitset);
+        REQUIRE(results.has_value());
+        REQUIRE(allow_results.has_value());
+        for (int64_t i = 0; i < nq * topk; i++) {
+            REQUIRE(results.value()->GetIds()[i] == allow_results.value()->GetIds()[i]);
+        }
+
+        auto range_results = idx.RangeSearch(query_ds, json, bitset);
+        auto allow_range_results = idx.RangeSearch(query_ds, json, allow_bitset);
+        REQUIRE(range_results.has_value());
+        REQUIRE(allow_range_results.has_value());
+        for (int64_t i = 0; i <= nq; i++) {
+            REQUIRE(range_results.value()->GetLims()[i] == allow_range_results.value()->GetLims()[i]);
+        }
+    }
+
+    SECTION("Test Search with Reordered Graph") {
+        using std::make_tuple;
+        auto hnsw_sq_refine_gen = [hnsw_gen]() {
+            knowhere::Json json = hnsw_gen();
+            json[knowhere::indexparam::SQ_TYPE] = "SQ8";
+            json[knowhere::indexparam::HNSW_REFINE] = true;
+            json[knowhere::indexparam::HNSW_REFINE_TYPE] = "FLAT";
+            return json;
+        };
+        auto [name, gen] = GENERATE_REF(table<std::string, std::function<knowhere::Json()>>({
+            make_tuple(knowhere::IndexEnum::INDEX_HNSW, hnsw_gen),
+            make_tuple(knowhere::IndexEnum::INDEX_HNSW_SQ, hnsw_gen),
+            make_tuple(knowhere::IndexEnum::INDEX_HNSW_SQ, hnsw_sq_refine_gen),
+        }));
+        auto idx = knowhere::IndexFactory::Instance().Create<knowhere::fp32>(name, version).value();
+        knowhere::Json json = gen();
+        json[knowhere::indexparam::HNSW_REORDER] = true;
+        auto cfg_json = json.dump();
+        CAPTURE(name, cfg_json);
+        REQUIRE(idx.Build(train_ds, json) == knowhere::Status::success);
+        REQUIRE(idx.Count() == nb);
+
+        auto results = idx.Search(query_ds, json, nullptr);
+        REQUIRE(results.has_value());
+        REQUIRE(GetKNNRecall(*gt.value(), *results.value()) > kKnnRecallThreshold);
+
+        auto bitset_data = GenerateBitsetWithRandomTbitsSet(nb, nb / 2);
+        knowhere::BitsetView bitset(bitset_data.data(), nb);
+        auto filtered_results = idx.Search(query_ds, json, bitset);
+        REQUIRE(filtered_results.has_value());
+        auto filtered_gt = knowhere::BruteForce::Search<knowhere::fp32>(train_ds, query_ds, json, bitset);
+        REQUIRE(GetKNNRecall(*filtered_gt.value(), *filtered_results.value()) > kKnnRecallThreshold);
+        for (int64_t i = 0; i < nq * topk; i++) {
+            auto id = filtered_results.value()->GetIds()[i];
+            REQUIRE((id == -1 || !bitset.test(id)));
+        }
+
+        // ids keep referring to the rows as they were added
+        if (idx.HasRawData(metric)) {
+            auto ids_ds = GenIdsDataSet(nb, nq);
+            auto vectors = idx.GetVectorByIds(ids_ds);
+            REQUIRE(vectors.has_value());
+            auto xb = (const float*)train_ds->GetTensor();
+            auto data = (const float*)vectors.value()->GetTensor();
+            for (int64_t i = 0; i < nq; i++) {
+                auto id = ids_ds->GetIds()[i];
+                for (int64_t j = 0; j < dim; j++) {
+                    REQUIRE(data[i * dim + j] == xb[id * dim + j]);
+                }
+            }
+        }
+
+        knowhere::BinarySet bs;
+        REQUIRE(idx.Serialize(bs) == knowhere::Status::success);
+        auto idx_ = knowhere::IndexFactory::Instance().Create<knowhere::fp32>(name, version).value();
+        REQUIRE(idx_.Deserialize(bs) == knowhere::Status::success);
+        auto loaded_results = idx_.Search(query_ds, json, nullptr);
+        REQUIRE(loaded_results.has_value());
+        for (int64_t i = 0; i < nq * topk; i++) {
+            REQUIRE(results.value()->GetIds()[i] == loaded_results.value()->GetIds()[i]);
+        }
+    }
+
     SECTION("Test Serialize/Deserialize") {
         using std::make_tuple;
         auto [name, gen] = GENERATE_REF(table<std::string, std::function<knowhere::Json()>>(
@@ -520,6 +658,150 @@ TEST_CASE("Test Mem Index With Float Vector", "[float metrics]") {
         REQUIRE(results.has_value());
     }
 
+    SECTION("Test Zero-Copy Deserialize") {
+        using std::make_tuple;
+        auto [name, gen] = GENERATE_REF(table<std::string, std::function<knowhere::Json()>>(
+            {make_tuple(knowhere::IndexEnum::INDEX_FAISS_IDMAP, flat_gen),
+             make_tuple(knowhere::IndexEnum::INDEX_FAISS_IVFFLAT, ivfflat_gen),
+             make_tuple(knowhere::IndexEnum::INDEX_FAISS_IVFSQ8, ivfsq_gen),
+             make_tuple(knowhere::IndexEnum::INDEX_FAISS_IVFPQ, ivfpq_gen),
+             make_tuple(knowhere::IndexEnum::INDEX_HNSW, hnsw_gen),
+             make_tuple(knowhere::IndexEnum::INDEX_HNSW_SQ, hnsw_gen)}));
+
+        auto idx = knowhere::IndexFactory::Instance().Create<knowhere::fp32>(name, version).value();
+        auto cfg_json = gen().dump();
+        CAPTURE(name, cfg_json);
+        knowhere::Json json = knowhere::Json::parse(cfg_json);
+        REQUIRE(idx.Build(train_ds, json) == knowhere::Status::success);
+        knowhere::BinarySet bs;
+        REQUIRE(idx.Serialize(bs) == knowhere::Status::success);
+
+        auto idx_copy = knowhere::IndexFactory::Instance().Create<knowhere::fp32>(name, version).value();
+        REQUIRE(idx_copy.Deserialize(bs, json) == knowhere::Status::success);
+        auto idx_view = knowhere::IndexFactory::Instance().Create<knowhere::fp32>(name, version).value();
+        json["enable_zero_copy"] = true;
+        REQUIRE(idx_view.Deserialize(bs, json) == knowhere::Status::success);
+        // the index keeps the blob alive on its own
+        bs = knowhere::BinarySet();
+
+        auto results_copy = idx_copy.Search(query_ds, json, nullptr);
+        auto results_view = idx_view.Search(query_ds, json, nullptr);
+        REQUIRE(results_copy.has_value());
+        REQUIRE(results_view.has_value());
+        auto ids_copy = results_copy.value()->GetIds();
+        auto ids_view = results_view.value()->GetIds();
+        for (int64_t i = 0; i < nq * topk; i++) {
+            REQUIRE(ids_copy[i] == ids_view[i]);
+        }
+    }
+
+    SECTION("Test Search With Prepared Plan") {
+        using std::make_tuple;
+        auto [name, gen] = GENERATE_REF(table<std::string, std::function<knowhere::Json()>>(
+            {make_tuple(knowhere::IndexEnum::INDEX_FAISS_IDMAP, flat_gen),
+             make_tuple(knowhere::IndexEnum::INDEX_FAISS_IVFFLAT, ivfflat_gen),
+             make_tuple(knowhere::IndexEnum::INDEX_HNSW, hnsw_gen)}));
+
+        auto idx = knowhere::IndexFactory::Instance().Create<knowhere::fp32>(name, version).value();
+        auto cfg_json = gen().dump();
+        CAPTURE(name, cfg_json);
+        knowhere::Json json = knowhere::Json::parse(cfg_json);
+        REQUIRE(idx.Build(train_ds, json) == knowhere::Status::success);
+
+        auto check_same = [&](const knowhere::DataSetPtr& expect, const knowhere::DataSetPtr& actual, int64_t k) {
+            REQUIRE(expect->GetDim() == k);
+            REQUIRE(actual->GetDim() == k);
+            for (int64_t i = 0; i < nq * k; i++) {
+                REQUIRE(expect->GetIds()[i] == actual->GetIds()[i]);
+                REQUIRE(expect->GetDistance()[i] == actual->GetDistance()[i]);
+            }
+        };
+
+        auto plan = idx.PrepareSearch(json);
+        REQUIRE(plan.has_value());
+        auto results = idx.Search(query_ds, json, nullptr);
+        REQUIRE(results.has_value());
+        for (int i = 0; i < 2; i++) {
+            auto plan_results = idx.Search(query_ds, *plan.value(), nullptr);
+            REQUIRE(plan_results.has_value());
+            check_same(results.value(), plan_results.value(), topk);
+        }
+
+        // k is the only param that makes the plan load the config again
+        const int64_t k = std::max<int64_t>(topk / 2, 1);
+        knowhere::Json k_json = json;
+        k_json[knowhere::meta::TOPK] = k;
+        auto k_results = idx.Search(query_ds, k_json, nullptr);
+        REQUIRE(k_results.has_value());
+        knowhere::SearchPlanOverrides overrides;
+        overrides.k = k;
+        auto k_plan_results = idx.Search(query_ds, *plan.value(), nullptr, overrides);
+        REQUIRE(k_plan_results.has_value());
+        check_same(k_results.value(), k_plan_results.value(), k);
+
+        auto range_plan = idx.PrepareSearch(json, knowhere::PARAM_TYPE::RANGE_SEARCH);
+        REQUIRE(range_plan.has_value());
+        auto range_results = idx.RangeSearch(query_ds, json, nullptr);
+        auto range_plan_results = idx.RangeSearch(query_ds, *range_plan.value(), nullptr);
+        REQUIRE(range_results.has_value());
+        REQUIRE(range_plan_results.has_value());
+        for (int64_t i = 0; i <= nq; i++) {
+            REQUIRE(range_results.value()->GetLims()[i] == range_plan_results.value()->GetLims()[i]);
+        }
+
+        // a plan only serves the kind of search and the index type it was prepared for
+        REQUIRE(idx.RangeSearch(query_ds, *plan.value(), nullptr).error() == knowhere::Status::invalid_args);
+        auto other_name = name == knowhere::IndexEnum::INDEX_FAISS_IDMAP ? knowhere::IndexEnum::INDEX_FAISS_IVFFLAT
+                                                                         : knowhere::IndexEnum::INDEX_FAISS_IDMAP;
+        auto other_idx = knowhere::IndexFactory::Instance().Create<knowhere::fp32>(other_name, version).value();
+        REQUIRE(other_idx.Build(train_ds, ivfflat_gen()) == knowhere::Status::success);
+        REQUIRE(other_idx.Search(query_ds, *plan.value(), nullptr).error() == knowhere::Status::invalid_args);
+    }
+
+    SECTION("Test SerializeToFile") {
+        using std::make_tuple;
+        auto [name, gen] = GENERATE_REF(table<std::string, std::function<knowhere::Json()>>(
+            {make_tuple(knowhere::IndexEnum::INDEX_FAISS_IDMAP, flat_gen),
+             make_tuple(knowhere::IndexEnum::INDEX_FAISS_IVFFLAT, ivfflat_gen),
+             make_tuple(knowhere::IndexEnum::INDEX_FAISS_IVFSQ8, ivfsq_gen),
+             make_tuple(knowhere::IndexEnum::INDEX_HNSW, hnsw_gen),
+             make_tuple(knowhere::IndexEnum::INDEX_HNSW_SQ, hnsw_gen)}));
+        auto direct_io = GENERATE(as<bool>{}, true, false);
+
+        auto idx = knowhere::IndexFactory::Instance().Create<knowhere::fp32>(name, version).value();
+        auto cfg_json = gen().dump();
+        CAPTURE(name, cfg_json, direct_io);
+        knowhere::Json json = knowhere::Json::parse(cfg_json);
+        REQUIRE(idx.Build(train_ds, json) == knowhere::Status::success);
+        knowhere::BinarySet bs;
+        REQUIRE(idx.Serialize(bs) == knowhere::Status::success);
+        std::remove(kMmapIndexPath);
+        REQUIRE(idx.SerializeToFile(kMmapIndexPath, direct_io) == knowhere::Status::success);
+
+        // the file holds exactly the bytes of the in-memory binary
+        auto binary = bs.GetByName(idx.Type());
+        REQUIRE(binary != nullptr);
+        std::ifstream in(kMmapIndexPath, std::ios::binary);
+        std::vector<char> file_data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        REQUIRE(file_data.size() == static_cast<size_t>(binary->size));
+        REQUIRE(std::memcmp(file_data.data(), binary->data.get(), binary->size) == 0);
+
+        auto idx_mem = knowhere::IndexFactory::Instance().Create<knowhere::fp32>(name, version).value();
+        REQUIRE(idx_mem.Deserialize(bs, json) == knowhere::Status::success);
+        auto idx_file = knowhere::IndexFactory::Instance().Create<knowhere::fp32>(name, version).value();
+        REQUIRE(idx_file.DeserializeFromFile(kMmapIndexPath, json) == knowhere::Status::success);
+
+        auto results_mem = idx_mem.Search(query_ds, json, nullptr);
+        auto results_file = idx_file.Search(query_ds, json, nullptr);
+        REQUIRE(results_mem.has_value());
+        REQUIRE(results_file.has_value());
+        auto ids_mem = results_mem.value()->GetIds();
+        auto ids_file = results_file.value()->GetIds();
+        for (int64_t i = 0; i < nq * topk; i++) {
+            REQUIRE(ids_mem[i] == ids_file[i]);
+        }
+    }
+
     SECTION("Test IVFPQ with invalid params") {
         auto idx = knowhere::IndexFactory::Instance()
                        .Create<knowhere::fp32>(knowhere::IndexEnum::INDEX_FAISS_IVFPQ, version)
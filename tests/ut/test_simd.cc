@@ -614,3 +614,128 @@ TEST_CASE("Test distance") {
         run_test();
     }
 }
+
+template <typename DataType>
+void
+CheckDistanceKernels(const faiss::cppcontrib::knowhere::DistanceKernels<DataType>& kernels,
+                     const faiss::cppcontrib::knowhere::DistanceKernels<DataType>& ref, const DataType* x,
+                     const DataType* y, const size_t dim, const float tolerance) {
+    const DataType* y0 = y;
+    const DataType* y1 = y + dim;
+    const DataType* y2 = y + 2 * dim;
+    const DataType* y3 = y + 3 * dim;
+    REQUIRE_THAT(kernels.inner_product(x, y0, dim),
+                 Catch::Matchers::WithinRel(ref.inner_product(x, y0, dim), tolerance));
+    REQUIRE_THAT(kernels.L2sqr(x, y0, dim), Catch::Matchers::WithinRel(ref.L2sqr(x, y0, dim), tolerance));
+
+    std::vector<float> ref_batch_4(4), batch_4(4);
+    ref.inner_product_batch_4(x, y0, y1, y2, y3, dim, ref_batch_4[0], ref_batch_4[1], ref_batch_4[2], ref_batch_4[3]);
+    kernels.inner_product_batch_4(x, y0, y1, y2, y3, dim, batch_4[0], batch_4[1], batch_4[2], batch_4[3]);
+    for (size_t i = 0; i < 4; i++) {
+        REQUIRE_THAT(batch_4[i], Catch::Matchers::WithinRel(ref_batch_4[i], tolerance));
+    }
+    ref.L2sqr_batch_4(x, y0, y1, y2, y3, dim, ref_batch_4[0], ref_batch_4[1], ref_batch_4[2], ref_batch_4[3]);
+    kernels.L2sqr_batch_4(x, y0, y1, y2, y3, dim, batch_4[0], batch_4[1], batch_4[2], batch_4[3]);
+    for (size_t i = 0; i < 4; i++) {
+        REQUIRE_THAT(batch_4[i], Catch::Matchers::WithinRel(ref_batch_4[i], tolerance));
+    }
+}
+
+TEST_CASE("Test distance kernels") {
+    using namespace faiss::cppcontrib::knowhere;
+    auto simd_type = GENERATE(as<knowhere::KnowhereConfig::SimdType>{}, knowhere::KnowhereConfig::SimdType::AVX512,
+                              knowhere::KnowhereConfig::SimdType::AVX2, knowhere::KnowhereConfig::SimdType::SSE4_2,
+                              knowhere::KnowhereConfig::SimdType::GENERIC, knowhere::KnowhereConfig::SimdType::AUTO);
+    // the fixed dimensions, with the neighbours that fall back to the generic kernels
+    auto dim = GENERATE(as<size_t>{}, 127, 128, 129, 384, 768, 1000, 1024, 1536);
+
+    LOG_KNOWHERE_INFO_ << "simd type: " << simd_type << ", dim: " << dim;
+    knowhere::KnowhereConfig::SetSimdType(simd_type);
+
+    const size_t nx = 1, ny = 4;
+    // the inputs are the same, only the order of the accumulation differs
+    const float tolerance = 0.00005f;
+    const auto x = GenRandomVector<float>(dim, nx, 314);
+    const auto y = GenRandomVector<float>(dim, ny, 271);
+
+    SECTION("float") {
+        DistanceKernels<float> ref;
+        ref.inner_product = fvec_inner_product_ref;
+        ref.L2sqr = fvec_L2sqr_ref;
+        ref.inner_product_batch_4 = fvec_inner_product_batch_4_ref;
+        ref.L2sqr_batch_4 = fvec_L2sqr_batch_4_ref;
+        CheckDistanceKernels(get_distance_kernels<float>(dim), ref, x.get(), y.get(), dim, tolerance);
+    }
+
+    SECTION("fp16") {
+        const auto x_fp16 = ConvertVector<knowhere::fp16>(x.get(), nx, dim);
+        const auto y_fp16 = ConvertVector<knowhere::fp16>(y.get(), ny, dim);
+        DistanceKernels<knowhere::fp16> ref;
+        ref.inner_product = fp16_vec_inner_product_ref;
+        ref.L2sqr = fp16_vec_L2sqr_ref;
+        ref.inner_product_batch_4 = fp16_vec_inner_product_batch_4_ref;
+        ref.L2sqr_batch_4 = fp16_vec_L2sqr_batch_4_ref;
+        CheckDistanceKernels(get_distance_kernels<knowhere::fp16>(dim), ref, x_fp16.get(), y_fp16.get(), dim,
+                             tolerance);
+    }
+
+    SECTION("bf16") {
+        const auto x_bf16 = ConvertVector<knowhere::bf16>(x.get(), nx, dim);
+        const auto y_bf16 = ConvertVector<knowhere::bf16>(y.get(), ny, dim);
+        DistanceKernels<knowhere::bf16> ref;
+        ref.inner_product = bf16_vec_inner_product_ref;
+        ref.L2sqr = bf16_vec_L2sqr_ref;
+        ref.inner_product_batch_4 = bf16_vec_inner_product_batch_4_ref;
+        ref.L2sqr_batch_4 = bf16_vec_L2sqr_batch_4_ref;
+        CheckDistanceKernels(get_distance_kernels<knowhere::bf16>(dim), ref, x_bf16.get(), y_bf16.get(), dim,
+                             tolerance);
+    }
+
+    SECTION("int8") {
+        const auto x_int8 = ConvertVector<knowhere::int8>(x.get(), nx, dim);
+        const auto y_int8 = ConvertVector<knowhere::int8>(y.get(), ny, dim);
+        DistanceKernels<knowhere::int8> ref;
+        ref.inner_product = int8_vec_inner_product_ref;
+        ref.L2sqr = int8_vec_L2sqr_ref;
+        ref.inner_product_batch_4 = int8_vec_inner_product_batch_4_ref;
+        ref.L2sqr_batch_4 = int8_vec_L2sqr_batch_4_ref;
+        // int8 should have no precision loss
+        CheckDistanceKernels(get_distance_kernels<knowhere::int8>(dim), ref, x_int8.get(), y_int8.get(), dim,
+                             0.000001f);
+    }
+}
+
+TEST_CASE("Test int8 distance with extreme values") {
+    using namespace faiss::cppcontrib::knowhere;
+    auto simd_type = GENERATE(as<knowhere::KnowhereConfig::SimdType>{}, knowhere::KnowhereConfig::SimdType::AVX512,
+                              knowhere::KnowhereConfig::SimdType::AVX2, knowhere::KnowhereConfig::SimdType::SSE4_2,
+                              knowhere::KnowhereConfig::SimdType::GENERIC, knowhere::KnowhereConfig::SimdType::AUTO);
+    auto dim = GENERATE(as<size_t>{}, 1, 15, 16, 31, 33, 63, 64, 65, 127, 768, 4095, 4096);
+
+    LOG_KNOWHERE_INFO_ << "simd type: " << simd_type << ", dim: " << dim;
+    knowhere::KnowhereConfig::SetSimdType(simd_type);
+
+    // -128 and 127 only, so products and differences take their extreme values
+    std::mt19937 rng(42);
+    std::vector<int8_t> x(dim), y(4 * dim);
+    for (auto& v : x) {
+        v = (rng() & 1) ? 127 : -128;
+    }
+    for (auto& v : y) {
+        v = (rng() & 1) ? 127 : -128;
+    }
+    const int8_t* ys[4] = {y.data(), y.data() + dim, y.data() + 2 * dim, y.data() + 3 * dim};
+
+    // the references sum in int32 like the kernels, so the results must be identical
+    CHECK(int8_vec_inner_product(x.data(), ys[0], dim) == int8_vec_inner_product_ref(x.data(), ys[0], dim));
+    CHECK(int8_vec_L2sqr(x.data(), ys[0], dim) == int8_vec_L2sqr_ref(x.data(), ys[0], dim));
+    CHECK(int8_vec_norm_L2sqr(x.data(), dim) == int8_vec_norm_L2sqr_ref(x.data(), dim));
+
+    float ip[4], l2[4];
+    int8_vec_inner_product_batch_4(x.data(), ys[0], ys[1], ys[2], ys[3], dim, ip[0], ip[1], ip[2], ip[3]);
+    int8_vec_L2sqr_batch_4(x.data(), ys[0], ys[1], ys[2], ys[3], dim, l2[0], l2[1], l2[2], l2[3]);
+    for (size_t i = 0; i < 4; i++) {
+        CHECK(ip[i] == int8_vec_inner_product_ref(x.data(), ys[i], dim));
+        CHECK(l2[i] == int8_vec_L2sqr_ref(x.data(), ys[i], dim));
+    }
+}
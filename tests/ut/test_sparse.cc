@@ -47,7 +47,8 @@ TEST_CASE("Test Mem Sparse Index With Float Vector", "[float metrics]") {
 
     auto metric = GENERATE(knowhere::metric::IP, knowhere::metric::BM25);
 
-    auto inverted_index_algo = GENERATE("TAAT_NAIVE", "DAAT_WAND", "DAAT_MAXSCORE");
+    auto inverted_index_algo = GENERATE("TAAT_NAIVE", "DAAT_WAND", "DAAT_MAXSCORE", "DAAT_BLOCK_MAX_WAND",
+                                        "DAAT_BLOCK_MAX_MAXSCORE");
 
     auto drop_ratio_search = metric == knowhere::metric::BM25 ? GENERATE(0.0, 0.1) : GENERATE(0.0, 0.3);
 
@@ -127,10 +128,13 @@ TEST_CASE("Test Mem Sparse Index With Float Vector", "[float metrics]") {
         check_distance_decreasing(*gt.value());
 
         auto use_mmap = GENERATE(true, false);
+        auto use_compression = GENERATE(false, true);
         auto tmp_file = "/tmp/knowhere_sparse_inverted_index_test";
         {
             auto idx = knowhere::IndexFactory::Instance().Create<knowhere::sparse_u32_f32>(name, version).value();
-            auto cfg_json = gen().dump();
+            auto json_with_compression = gen();
+            json_with_compression[knowhere::indexparam::INVERTED_INDEX_COMPRESSION] = use_compression;
+            auto cfg_json = json_with_compression.dump();
             CAPTURE(name, cfg_json);
             knowhere::Json json = knowhere::Json::parse(cfg_json);
             REQUIRE(idx.Type() == name);
@@ -205,6 +209,80 @@ TEST_CASE("Test Mem Sparse Index With Float Vector", "[float metrics]") {
         }
     }
 
+    SECTION("Test Batched Search") {
+        using std::make_tuple;
+        auto [name, gen] = GENERATE_REF(table<std::string, std::function<knowhere::Json()>>({
+            make_tuple(knowhere::IndexEnum::INDEX_SPARSE_INVERTED_INDEX, sparse_inverted_index_gen),
+            make_tuple(knowhere::IndexEnum::INDEX_SPARSE_WAND, sparse_inverted_index_gen),
+        }));
+        // enough queries for each search task to get several of them
+        auto large_nq = 50 * nq;
+        auto large_query_ds = sparse_dataset_gen(large_nq, dim + 20, query_sparsity);
+
+        auto idx = knowhere::IndexFactory::Instance().Create<knowhere::sparse_u32_f32>(name, version).value();
+        auto cfg_json = gen().dump();
+        CAPTURE(name, cfg_json);
+        knowhere::Json json = knowhere::Json::parse(cfg_json);
+        REQUIRE(idx.Build(train_ds, json) == knowhere::Status::success);
+
+        auto bitset_data = GenerateBitsetWithRandomTbitsSet(nb, 0.4f * nb);
+        knowhere::BitsetView bitset(bitset_data.data(), nb);
+        auto filter_gt = knowhere::BruteForce::SearchSparse(train_ds, large_query_ds, conf, bitset);
+
+        auto results = idx.Search(large_query_ds, json, bitset);
+        REQUIRE(results.has_value());
+        check_result_match_filter(*results.value(), bitset);
+        check_distance_decreasing(*results.value());
+        float recall = GetKNNRecall(*filter_gt.value(), *results.value());
+        auto drop_ratio_search = json[knowhere::indexparam::DROP_RATIO_SEARCH].get<float>();
+        if (drop_ratio_search == 0) {
+            REQUIRE(recall == 1);
+        } else {
+            REQUIRE(recall >= 0.8);
+        }
+    }
+
+    SECTION("Test Search with Doc Reorder and Parallel Build") {
+        using std::make_tuple;
+        auto [name, gen] = GENERATE_REF(table<std::string, std::function<knowhere::Json()>>({
+            make_tuple(knowhere::IndexEnum::INDEX_SPARSE_INVERTED_INDEX, sparse_inverted_index_gen),
+            make_tuple(knowhere::IndexEnum::INDEX_SPARSE_WAND, sparse_inverted_index_gen),
+        }));
+        auto doc_reorder = GENERATE(false, true);
+        // large enough for rows to be added by several tasks of the build pool
+        auto large_nb = 5 * nb;
+        auto large_train_ds = sparse_dataset_gen(large_nb, dim, doc_sparsity);
+
+        auto idx = knowhere::IndexFactory::Instance().Create<knowhere::sparse_u32_f32>(name, version).value();
+        auto json_with_reorder = gen();
+        json_with_reorder[knowhere::indexparam::INVERTED_INDEX_DOC_REORDER] = doc_reorder;
+        auto cfg_json = json_with_reorder.dump();
+        CAPTURE(name, cfg_json);
+        knowhere::Json json = knowhere::Json::parse(cfg_json);
+        REQUIRE(idx.Build(large_train_ds, json) == knowhere::Status::success);
+        REQUIRE(idx.Count() == large_nb);
+
+        knowhere::BinarySet bs;
+        REQUIRE(idx.Serialize(bs) == knowhere::Status::success);
+        REQUIRE(idx.Deserialize(bs, json) == knowhere::Status::success);
+
+        auto bitset_data = GenerateBitsetWithRandomTbitsSet(large_nb, 0.4f * large_nb);
+        knowhere::BitsetView bitset(bitset_data.data(), large_nb);
+        auto filter_gt = knowhere::BruteForce::SearchSparse(large_train_ds, query_ds, conf, bitset);
+
+        auto results = idx.Search(query_ds, json, bitset);
+        REQUIRE(results.has_value());
+        check_result_match_filter(*results.value(), bitset);
+        check_distance_decreasing(*results.value());
+        float recall = GetKNNRecall(*filter_gt.value(), *results.value());
+        auto drop_ratio_search = json[knowhere::indexparam::DROP_RATIO_SEARCH].get<float>();
+        if (drop_ratio_search == 0) {
+            REQUIRE(recall == 1);
+        } else {
+            REQUIRE(recall >= 0.8);
+        }
+    }
+
     SECTION("Test Sparse Iterator with Bitset") {
         using std::make_tuple;
         auto [name, gen] = GENERATE_REF(table<std::string, std::function<knowhere::Json()>>({
@@ -323,6 +401,180 @@ TEST_CASE("Test Mem Sparse Index With Float Vector", "[float metrics]") {
     }
 }
 
+TEST_CASE("Test Mem Sparse Seismic Index", "[float metrics]") {
+    auto [nb, dim, doc_sparsity, query_sparsity] = GENERATE(table<int32_t, int32_t, float, float>({
+        // 300 dim, avg doc nnz 12, avg query nnz 9
+        {2000, 300, 0.95, 0.97},
+        // 3000 dim, avg doc nnz 90, avg query nnz 30
+        {2000, 3000, 0.97, 0.99},
+    }));
+    auto topk = 5;
+    int64_t nq = 10;
+    auto metric = knowhere::metric::IP;
+    auto name = knowhere::IndexEnum::INDEX_SPARSE_SEISMIC;
+    auto version = GenTestVersionList();
+
+    auto train_ds = GenSparseDataSet(nb, dim, doc_sparsity);
+    auto query_ds = GenSparseDataSet(nq, dim + 20, query_sparsity);
+
+    const knowhere::Json conf = {
+        {knowhere::meta::METRIC_TYPE, metric},
+        {knowhere::meta::TOPK, topk},
+    };
+
+    auto base_gen = [=, dim = dim]() {
+        knowhere::Json json;
+        json[knowhere::meta::DIM] = dim;
+        json[knowhere::meta::METRIC_TYPE] = metric;
+        json[knowhere::meta::TOPK] = topk;
+        return json;
+    };
+
+    // values are non-negative, so with whole summaries and nothing pruned, a skipped block can't hold a better row.
+    auto exhaustive_gen = [base_gen, nb = nb]() {
+        knowhere::Json json = base_gen();
+        json[knowhere::indexparam::SEISMIC_N_POSTINGS] = nb;
+        json[knowhere::indexparam::SEISMIC_SUMMARY_ENERGY] = 1.0;
+        json[knowhere::indexparam::SEISMIC_HEAP_FACTOR] = 1.0;
+        return json;
+    };
+
+    auto check_result = [&](const knowhere::DataSet& ds, const knowhere::BitsetView& bitset) {
+        auto k = ds.GetDim();
+        auto* distances = ds.GetDistance();
+        auto* ids = ds.GetIds();
+        for (auto i = 0; i < nq; ++i) {
+            for (auto j = 0; j < k; ++j) {
+                if (ids[i * k + j] == -1) {
+                    break;
+                }
+                REQUIRE(ids[i * k + j] < nb);
+                REQUIRE((bitset.empty() || !bitset.test(ids[i * k + j])));
+                if (j > 0) {
+                    REQUIRE(distances[i * k + j - 1] >= distances[i * k + j]);
+                }
+            }
+        }
+    };
+
+    SECTION("Test Search") {
+        auto gt = knowhere::BruteForce::SearchSparse(train_ds, query_ds, conf, nullptr);
+        auto use_mmap = GENERATE(true, false);
+        auto tmp_file = "/tmp/knowhere_sparse_seismic_index_test";
+        {
+            auto idx = knowhere::IndexFactory::Instance().Create<knowhere::sparse_u32_f32>(name, version).value();
+            auto cfg_json = exhaustive_gen().dump();
+            CAPTURE(name, cfg_json);
+            knowhere::Json json = knowhere::Json::parse(cfg_json);
+            REQUIRE(idx.Type() == name);
+            REQUIRE(idx.Build(train_ds, json) == knowhere::Status::success);
+            REQUIRE(idx.Size() > 0);
+            REQUIRE(idx.Count() == nb);
+
+            auto results_before = idx.Search(query_ds, json, nullptr);
+            REQUIRE(results_before.has_value());
+
+            knowhere::BinarySet bs;
+            REQUIRE(idx.Serialize(bs) == knowhere::Status::success);
+            if (use_mmap) {
+                WriteBinaryToFile(tmp_file, bs.GetByName(idx.Type()));
+                REQUIRE(idx.DeserializeFromFile(tmp_file, json) == knowhere::Status::success);
+            } else {
+                REQUIRE(idx.Deserialize(bs, json) == knowhere::Status::success);
+            }
+            REQUIRE(idx.Count() == nb);
+
+            auto results = idx.Search(query_ds, json, nullptr);
+            REQUIRE(results.has_value());
+            check_result(*results.value(), nullptr);
+            for (int i = 0; i < nq * topk; ++i) {
+                REQUIRE(results.value()->GetIds()[i] == results_before.value()->GetIds()[i]);
+            }
+            REQUIRE(GetKNNRecall(*gt.value(), *results.value()) >= 0.99);
+            // idx to destruct and munmap
+        }
+        if (use_mmap) {
+            REQUIRE(std::remove(tmp_file) == 0);
+        }
+    }
+
+    SECTION("Test Search with Bitset and Approximation") {
+        auto idx = knowhere::IndexFactory::Instance().Create<knowhere::sparse_u32_f32>(name, version).value();
+        auto heap_factor = GENERATE(0.5f, 0.9f);
+        auto drop_ratio_search = GENERATE(0.0f, 0.3f);
+        knowhere::Json json = base_gen();
+        json[knowhere::indexparam::SEISMIC_N_POSTINGS] = nb / 4;
+        json[knowhere::indexparam::SEISMIC_HEAP_FACTOR] = heap_factor;
+        json[knowhere::indexparam::DROP_RATIO_SEARCH] = drop_ratio_search;
+        CAPTURE(json.dump());
+        REQUIRE(idx.Build(train_ds, json) == knowhere::Status::success);
+
+        auto bitset_data = GenerateBitsetWithRandomTbitsSet(nb, 0.4f * nb);
+        knowhere::BitsetView bitset(bitset_data.data(), nb);
+        auto results = idx.Search(query_ds, json, bitset);
+        REQUIRE(results.has_value());
+        check_result(*results.value(), bitset);
+
+        // rows are scored with the forward index, so the distances of the results are exact.
+        if (drop_ratio_search == 0) {
+            auto docs = static_cast<const knowhere::sparse::SparseRow<float>*>(train_ds->GetTensor());
+            auto queries = static_cast<const knowhere::sparse::SparseRow<float>*>(query_ds->GetTensor());
+            for (int i = 0; i < nq; ++i) {
+                for (int j = 0; j < topk; ++j) {
+                    auto id = results.value()->GetIds()[i * topk + j];
+                    if (id == -1) {
+                        break;
+                    }
+                    auto expected = queries[i].dot(docs[id]);
+                    REQUIRE(std::abs(results.value()->GetDistance()[i * topk + j] - expected) <= 1e-4f * expected);
+                }
+            }
+        }
+    }
+
+    SECTION("Test Add") {
+        // Add only clusters the posting lists of the dims of the added rows again, the index is the same as the one
+        // built over all the rows at once.
+        auto docs = static_cast<const knowhere::sparse::SparseRow<float>*>(train_ds->GetTensor());
+        auto half = nb / 2;
+        auto first_ds = knowhere::GenDataSet(half, dim, docs);
+        first_ds->SetIsSparse(true);
+        auto second_ds = knowhere::GenDataSet(nb - half, dim, docs + half);
+        second_ds->SetIsSparse(true);
+        knowhere::Json json = base_gen();
+        json[knowhere::indexparam::SEISMIC_N_POSTINGS] = nb / 4;
+        json[knowhere::indexparam::SEISMIC_HEAP_FACTOR] = 0.9f;
+
+        auto built = knowhere::IndexFactory::Instance().Create<knowhere::sparse_u32_f32>(name, version).value();
+        REQUIRE(built.Build(train_ds, json) == knowhere::Status::success);
+        auto added = knowhere::IndexFactory::Instance().Create<knowhere::sparse_u32_f32>(name, version).value();
+        REQUIRE(added.Build(first_ds, json) == knowhere::Status::success);
+        REQUIRE(added.Add(second_ds, json) == knowhere::Status::success);
+        REQUIRE(added.Count() == nb);
+
+        auto expected = built.Search(query_ds, json, nullptr);
+        REQUIRE(expected.has_value());
+        auto results = added.Search(query_ds, json, nullptr);
+        REQUIRE(results.has_value());
+        for (int i = 0; i < nq * topk; ++i) {
+            REQUIRE(results.value()->GetIds()[i] == expected.value()->GetIds()[i]);
+            if (expected.value()->GetIds()[i] != -1) {
+                REQUIRE(results.value()->GetDistance()[i] == expected.value()->GetDistance()[i]);
+            }
+        }
+    }
+
+    SECTION("Test Build with BM25") {
+        auto idx = knowhere::IndexFactory::Instance().Create<knowhere::sparse_u32_f32>(name, version).value();
+        knowhere::Json json = base_gen();
+        json[knowhere::meta::METRIC_TYPE] = knowhere::metric::BM25;
+        json[knowhere::meta::BM25_K1] = 1.2;
+        json[knowhere::meta::BM25_B] = 0.75;
+        json[knowhere::meta::BM25_AVGDL] = 100;
+        REQUIRE(idx.Build(train_ds, json) == knowhere::Status::invalid_metric_type);
+    }
+}
+
 TEST_CASE("Test Mem Sparse Index Handle Empty Vector", "[float metrics]") {
     auto [base_data, has_first_result] = GENERATE(table<std::vector<std::map<int32_t, float>>, bool>(
         {{std::vector<std::map<int32_t, float>>{
@@ -468,7 +720,8 @@ TEST_CASE("Test Mem Sparse Index CC", "[float metrics]") {
 
     auto query_ds = doc_vector_gen(nq, dim);
 
-    auto inverted_index_algo = GENERATE("TAAT_NAIVE", "DAAT_WAND", "DAAT_MAXSCORE");
+    auto inverted_index_algo = GENERATE("TAAT_NAIVE", "DAAT_WAND", "DAAT_MAXSCORE", "DAAT_BLOCK_MAX_WAND",
+                                        "DAAT_BLOCK_MAX_MAXSCORE");
 
     auto drop_ratio_search = GENERATE(0.0, 0.3);
 
@@ -562,6 +815,55 @@ TEST_CASE("Test Mem Sparse Index CC", "[float metrics]") {
         }
     }
 
+    SECTION("Test Search with new dims") {
+        // rows added in dims unseen so far grow the dim map shared with readers, the queries don't touch these dims
+        // so the results must still be from the initial batch.
+        auto add_new_dims_task = [&]() {
+            auto start = std::chrono::steady_clock::now();
+            int32_t dim_base = dim;
+            while (std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now() - start).count() <
+                   test_time) {
+                std::vector<std::map<int32_t, float>> data(nb);
+                for (int32_t i = 0; i < nb; ++i) {
+                    data[i][dim_base + i % dim] = 1.0f;
+                }
+                dim_base += dim;
+                REQUIRE(idx.Add(GenSparseDataSet(data, dim_base), json) == knowhere::Status::success);
+            }
+        };
+        std::vector<std::future<void>> task_list;
+        for (int thread = 0; thread < 5; thread++) {
+            task_list.push_back(std::async(std::launch::async, search_task));
+        }
+        task_list.push_back(std::async(std::launch::async, add_new_dims_task));
+        for (auto& task : task_list) {
+            task.wait();
+        }
+    }
+
+    SECTION("Test Count") {
+        // each batch of added vectors becomes visible to readers at once
+        auto count_task = [&]() {
+            auto start = std::chrono::steady_clock::now();
+            int64_t last_count = 0;
+            while (std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now() - start).count() <
+                   test_time) {
+                auto count = idx.Count();
+                REQUIRE(count % nb == 0);
+                REQUIRE(count >= last_count);
+                last_count = count;
+            }
+        };
+        std::vector<std::future<void>> task_list;
+        for (int thread = 0; thread < 2; thread++) {
+            task_list.push_back(std::async(std::launch::async, count_task));
+        }
+        task_list.push_back(std::async(std::launch::async, add_task));
+        for (auto& task : task_list) {
+            task.wait();
+        }
+    }
+
     SECTION("Test GetVectorByIds") {
         std::vector<int64_t> ids = {0, 1, 2};
         REQUIRE(idx.HasRawData(metric) ==
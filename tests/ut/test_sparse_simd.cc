@@ -9,6 +9,9 @@
 // is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
 // or implied. See the License for the specific language governing permissions and limitations under the License.
 
+#include <algorithm>
+#include <limits>
+#include <numeric>
 #include <random>
 #include <set>
 #include <vector>
@@ -319,3 +322,72 @@ TEST_CASE("Test Sparse SIMD AVX512 - Multiple Accumulations", "[sparse simd avx5
     SKIP("Test only runs on x86_64 platforms");
 #endif
 }
+
+TEST_CASE("Test Sparse Posting List Block Codec", "[sparse simd]") {
+    SECTION("Encode and decode blocks") {
+        auto block_n = GENERATE(1, 3, 4, 5, 17, 63, 64);
+        auto max_gap = GENERATE(1u, 2u, 3u, 100u, 70000u, 1u << 30);
+        auto base = GENERATE(0u, 12345u);
+        std::mt19937 gen(block_n * 31 + max_gap);
+        std::uniform_int_distribution<uint32_t> gap_dist(1, max_gap);
+
+        std::vector<uint32_t> ids(block_n);
+        uint64_t prev = static_cast<uint64_t>(base) - 1;
+        for (auto& id : ids) {
+            prev += gap_dist(gen);
+            id = static_cast<uint32_t>(std::min<uint64_t>(prev, std::numeric_limits<uint32_t>::max()));
+        }
+        ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+
+        std::vector<uint32_t> words(posting_list_block_max_words);
+        auto bit_width = encode_posting_block(ids.data(), ids.size(), base, words.data());
+        REQUIRE(bit_width % 2 == 0);
+        REQUIRE(bit_width <= 32);
+
+        std::vector<uint32_t> decoded(posting_list_block_size);
+        decode_posting_block(words.data(), bit_width, base, decoded.data());
+        for (size_t i = 0; i < ids.size(); ++i) {
+            REQUIRE(decoded[i] == ids[i]);
+        }
+    }
+
+    SECTION("Consecutive ids take no space") {
+        std::vector<uint32_t> ids(posting_list_block_size);
+        std::iota(ids.begin(), ids.end(), 1000);
+        std::vector<uint32_t> words(posting_list_block_max_words);
+        REQUIRE(encode_posting_block(ids.data(), ids.size(), 1000, words.data()) == 0);
+
+        std::vector<uint32_t> decoded(posting_list_block_size);
+        decode_posting_block(words.data(), 0, 1000, decoded.data());
+        REQUIRE(decoded == ids);
+    }
+}
+
+TEST_CASE("Test Sparse SIMD Accumulate Into A Window", "[sparse simd]") {
+    // the scores only cover the doc ids [id_base, id_base + window)
+    const size_t n_docs = 1000;
+    const uint32_t id_base = 600;
+    const size_t window = n_docs - id_base;
+    const float q_weight = 0.5f;
+    auto plist_size = GENERATE(1, 15, 16, 33, 100, 400);
+
+    PostingListTestData test_data(plist_size, n_docs, 2024);
+    std::vector<uint32_t> doc_ids;
+    std::vector<float> doc_vals;
+    for (size_t i = 0; i < test_data.doc_ids.size(); ++i) {
+        if (test_data.doc_ids[i] >= id_base) {
+            doc_ids.push_back(test_data.doc_ids[i]);
+            doc_vals.push_back(test_data.doc_vals[i]);
+        }
+    }
+
+    std::vector<float> ref_scores(n_docs, 0.0f);
+    accumulate_posting_list_ip_scalar_ref(doc_ids.data(), doc_vals.data(), doc_ids.size(), q_weight,
+                                          ref_scores.data());
+    std::vector<float> window_scores(window, 0.0f);
+    accumulate_posting_list_contribution_ip_dispatch<float>(doc_ids.data(), doc_vals.data(), doc_ids.size(), q_weight,
+                                                            window_scores.data(), id_base);
+    for (size_t i = 0; i < window; ++i) {
+        REQUIRE_THAT(window_scores[i], Catch::Matchers::WithinAbs(ref_scores[id_base + i], 1e-6f));
+    }
+}
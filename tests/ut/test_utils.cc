@@ -10,11 +10,19 @@
 // or implied. See the License for the specific language governing permissions and limitations under the License.
 
 #include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
 #include <thread>
 #include <vector>
 
 #include "catch2/catch_approx.hpp"
 #include "catch2/catch_test_macros.hpp"
+#include "faiss/cppcontrib/knowhere/utils/VisitedTable.h"
+#include "io/file_io.h"
+#include "io/memory_io.h"
+#include "knowhere/comp/bloomfilter.h"
 #include "knowhere/comp/task.h"
 #include "knowhere/comp/time_recorder.h"
 #include "knowhere/expected.h"
@@ -113,6 +121,41 @@ TEST_CASE("Test Bitset Generation", "[utils]") {
     }
 }
 
+TEST_CASE("Test Bitset Allow List", "[utils]") {
+    for (const auto size : kBitsetSizes) {
+        auto bitset_data = GenerateBitsetWithRandomTbitsSet(size, size * 3 / 4);
+        std::vector<uint32_t> allow_ids;
+        for (size_t j = 0; j < size; ++j) {
+            if (!knowhere::BitsetView(bitset_data.data(), size).test(j)) {
+                allow_ids.push_back(j);
+            }
+        }
+        // ids past the bitmap are filtered out by test(), they must not count as allowed
+        allow_ids.push_back(size + 5);
+
+        for (const size_t id_offset : {size_t(0), size_t(3), size / 2}) {
+            knowhere::BitsetView bitset(bitset_data.data(), size);
+            bitset.set_id_offset(id_offset);
+            size_t expected_count = 0;
+            size_t expected_first = size;
+            for (size_t j = 0; j < size; ++j) {
+                if (bitset.test(j)) {
+                    expected_count++;
+                } else if (expected_first == size) {
+                    expected_first = j;
+                }
+            }
+
+            knowhere::BitsetView allow_bitset(bitset_data.data(), size);
+            allow_bitset.set_allow_list(allow_ids.data(), allow_ids.size());
+            allow_bitset.set_id_offset(id_offset);
+            REQUIRE(allow_bitset.count() == expected_count);
+            REQUIRE(allow_bitset.get_filtered_out_num_() == expected_count);
+            REQUIRE(allow_bitset.get_first_valid_index() == expected_first);
+        }
+    }
+}
+
 namespace {
 constexpr size_t kHeapSize = 10;
 constexpr size_t kElementCount = 10000;
@@ -134,6 +177,100 @@ TEST_CASE("ResultMaxHeap") {
     REQUIRE(heap.Size() == 0);
 }
 
+TEST_CASE("Test EpochVisitedTable", "[utils]") {
+    constexpr size_t kSize = 1000;
+
+    SECTION("clear() forgets visited elements across epoch wraparounds") {
+        auto table = faiss::cppcontrib::knowhere::EpochVisitedTable::create_cleared(kSize);
+        for (size_t round = 0; round < 600; round++) {
+            for (size_t i = 0; i < kSize; i++) {
+                REQUIRE_FALSE(table.get(i));
+            }
+            table.set(round % kSize);
+            table[(round * 7 + 1) % kSize] = true;
+            REQUIRE(table.get(round % kSize));
+            REQUIRE(table[(round * 7 + 1) % kSize]);
+            table.clear();
+        }
+    }
+
+    SECTION("pooled tables are reused and come back cleared") {
+        faiss::cppcontrib::knowhere::VisitedTablePool pool;
+
+        const faiss::cppcontrib::knowhere::EpochVisitedTable* first_table = nullptr;
+        {
+            auto handle = pool.acquire(kSize);
+            first_table = handle.get();
+            for (size_t i = 0; i < kSize; i += 3) {
+                handle->set(i);
+            }
+        }
+        REQUIRE(pool.size() == kSize);
+
+        // a smaller request reuses the released table
+        auto handle = pool.acquire(kSize / 2);
+        REQUIRE(handle.get() == first_table);
+        REQUIRE(handle->size == kSize / 2);
+        for (size_t i = 0; i < kSize / 2; i++) {
+            REQUIRE_FALSE(handle->get(i));
+        }
+
+        // a nested request gets a different table
+        auto nested_handle = pool.acquire(kSize * 2);
+        REQUIRE(nested_handle.get() != handle.get());
+        REQUIRE(nested_handle->size == kSize * 2);
+
+        pool.clear();
+        REQUIRE(pool.size() == 0);
+    }
+
+    SECTION("idle tables are kept up to the byte limit") {
+        faiss::cppcontrib::knowhere::VisitedTablePool pool(kSize * 3);
+        {
+            auto small = pool.acquire(kSize);
+            auto medium = pool.acquire(kSize * 2);
+            auto large = pool.acquire(kSize * 4);
+        }
+        // the large table is released first and is over the limit alone
+        REQUIRE(pool.size() == kSize * 3);
+    }
+}
+
+TEST_CASE("Test FileIOWriter", "[utils]") {
+    const std::string path = "/tmp/knowhere_file_io_writer_test";
+    const std::string tmp_path = path + ".tmp";
+    auto read_file = [](const std::string& file) {
+        std::ifstream in(file, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    };
+    {
+        std::ofstream out(path, std::ios::binary);
+        out << "previous";
+    }
+    const std::string content(10000, 'x');
+    auto direct_io = GENERATE(as<bool>{}, true, false);
+
+    SECTION("the file is replaced once closed") {
+        knowhere::FileIOWriter writer(path, direct_io);
+        writer(content.data(), 1, content.size());
+        REQUIRE(read_file(path) == "previous");
+        writer.close();
+        REQUIRE(read_file(path) == content);
+        REQUIRE_FALSE(std::filesystem::exists(tmp_path));
+    }
+
+    SECTION("a writer that is not closed leaves the file untouched") {
+        {
+            knowhere::FileIOWriter writer(path, direct_io);
+            writer(content.data(), 1, content.size());
+        }
+        REQUIRE(read_file(path) == "previous");
+        REQUIRE_FALSE(std::filesystem::exists(tmp_path));
+    }
+
+    std::filesystem::remove(path);
+}
+
 TEST_CASE("Test Time Recorder") {
     knowhere::TimeRecorder tr("test", 2);
     int64_t sum = 0;
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <shared_mutex>
+#include <vector>
+
+#include "tsl/robin_map.h"
+
+namespace diskann {
+  // A bounded cache of disk nodes that follows the query distribution.
+  //
+  // It is filled from the nodes beam searches read from disk anyway, so the
+  // nodes that keep being fetched end up in DRAM without re-warming. Node ids
+  // are hashed over shards, and each shard runs CLOCK over a fixed slab of
+  // slots. Admission is frequency based: every miss bumps a small count-min
+  // sketch, and once the shard is full a node only takes the slot of the
+  // CLOCK victim if it was missed more often, so one-off traversals do not
+  // flush hot nodes.
+  //
+  // A hit copies the node out under the shard's shared lock, so callers never
+  // hold a pointer into a slot that may be recycled.
+  class AdaptiveNodeCache {
+   public:
+    // `capacity` nodes of `node_len` bytes each
+    AdaptiveNodeCache(uint64_t capacity, uint64_t node_len);
+    ~AdaptiveNodeCache();
+
+    // copies node `id` into `out`, which has room for node_len bytes
+    bool get(uint32_t id, char *out);
+
+    // records a miss of node `id`, just read into `node`, and caches it if
+    // it is admitted
+    void offer(uint32_t id, const char *node);
+
+    uint64_t capacity() const;
+    uint64_t size() const;
+    uint64_t mem_size() const;
+
+   private:
+    struct Shard;
+
+    Shard &shard_of(uint32_t id);
+
+    uint64_t                            node_len_;
+    uint64_t                            capacity_ = 0;
+    std::vector<std::unique_ptr<Shard>> shards_;
+  };
+}  // namespace diskann
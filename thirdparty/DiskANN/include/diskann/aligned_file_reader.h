@@ -9,6 +9,7 @@
 #include <atomic>
 #include <fcntl.h>
 #include <libaio.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
 #include <malloc.h>
@@ -55,6 +56,12 @@ class AlignedFileReader {
   virtual void open(const std::string& fname) = 0;
   virtual void close() = 0;
 
+  // Long-lived read destinations (e.g. per-thread sector scratch) that the
+  // reader may pin up front. Must be called after open() and the buffers
+  // must stay valid until close().
+  virtual void register_buffers(const std::vector<iovec> &bufs) {
+  }
+
   // process batch of aligned requests in parallel
   // NOTE :: blocking call
   virtual void read(std::vector<AlignedRead>& read_reqs, IOContext& ctx,
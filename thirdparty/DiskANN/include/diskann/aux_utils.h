@@ -131,6 +131,9 @@ namespace diskann {
     uint32_t inline_pq = 0;
     bool rearrange = false;
     int num_entry_points = 0;
+    // write the nodes to disk in breadth-first order of the graph, so that
+    // neighbors tend to share a sector
+    bool bfs_layout = false;
   };
 
   template<typename T>
@@ -151,6 +154,7 @@ namespace diskann {
   void create_disk_layout(
       const std::string base_file, const std::string mem_index_file,
       const std::string output_file,
-      const std::string reorder_data_file = std::string(""));
+      const std::string reorder_data_file = std::string(""),
+      const bool        bfs_layout = false);
 
 }  // namespace diskann
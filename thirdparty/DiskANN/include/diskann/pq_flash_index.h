@@ -16,12 +16,14 @@
 #include "knowhere/bitsetview.h"
 #include "knowhere/feder/DiskANN.h"
 
+#include "adaptive_node_cache.h"
 #include "aligned_file_reader.h"
 #include "concurrent_queue.h"
 #include "neighbor.h"
 #include "parameters.h"
 #include "percentile_stats.h"
 #include "pq_table.h"
+#include "timer.h"
 #include "utils.h"
 #include "diskann/distance.h"
 #include "knowhere/thread_pool.h"
@@ -79,6 +81,49 @@ namespace diskann {
     QueryScratch<T> scratch;
   };
 
+  // A cached_beam_search query between two beams. Keeping it off the stack
+  // lets batch_cached_beam_search interleave several queries on one thread.
+  template<typename T>
+  struct BeamSearchState {
+    ThreadData<T>        data;
+    float                query_norm = 0;
+    _u64                 k_search = 0;
+    _u64                 l_search = 0;
+    _u64                 beam_width = 0;
+    _s64                *indices = nullptr;
+    float               *distances = nullptr;
+    QueryStats          *stats = nullptr;
+    const knowhere::feder::diskann::FederResultUniq *feder = nullptr;
+    knowhere::BitsetView bitset_view;
+
+    std::vector<Neighbor> retset;
+    std::vector<Neighbor> full_retset;
+    unsigned              cur_list_size = 0;
+    // best position in retset that has not been expanded yet
+    unsigned k = 0;
+    float    accumulative_alpha = 0;
+
+    // cleared every beam
+    std::vector<unsigned>                    frontier;
+    std::vector<std::pair<unsigned, char *>> frontier_nhoods;
+    std::vector<AlignedRead>                 frontier_read_reqs;
+    std::vector<std::pair<unsigned, std::pair<unsigned, unsigned *>>>
+                          cached_nhoods;
+    // frontier nodes copied out of the adaptive cache, nothing is read for
+    // them
+    std::vector<std::pair<unsigned, char *>> adaptive_nhoods;
+    std::vector<unsigned>                    filtered_nbrs;
+
+    // the sector scratch is used as a ring over the whole query, so the
+    // sectors of recent beams stay readable. read_sectors maps the offset of
+    // each sector read to the number of the ring slot it was read into, a
+    // frontier node in a sector still held there is not read again.
+    tsl::robin_map<_u64, _u64> read_sectors;
+    _u64                       n_ring_slots = 0;
+
+    Timer query_timer;
+  };
+
   /** Algorithm Introduction for diskann-iterator
    * First, two unbounded min-heaps are maintained: `retset` and `candidates`,
    * sorted by *pq_dist*. (Similar to the navigation search path of hnswlib-hnsw
@@ -203,6 +248,11 @@ namespace diskann {
     virtual void cache_bfs_levels(_u64                   num_nodes_to_cache,
                           std::vector<uint32_t> &node_list);
 
+    // Sets aside room for `num_nodes_to_cache` nodes that are cached at
+    // search time from the nodes beam searches read, on top of the static
+    // cache. 0 turns it off.
+    void enable_adaptive_cache(_u64 num_nodes_to_cache);
+
     void cached_beam_search(
         const T *query, const _u64 k_search, const _u64 l_search, _s64 *res_ids,
         float *res_dists, const _u64 beam_width,
@@ -211,6 +261,19 @@ namespace diskann {
         knowhere::BitsetView                             bitset_view = nullptr,
         const float                                      filter_ratio = -1.0f);
 
+    // Searches `nq` queries, `query_stride` elements apart, on the calling
+    // thread with up to `max_inflight` of them in flight. The beams of all
+    // in-flight queries are read with one submission, and while one half of
+    // them waits for its sectors the other half is being expanded. Results
+    // match cached_beam_search query by query. `stats` is nullptr or has nq
+    // entries.
+    void batch_cached_beam_search(
+        const T *queries, const _u64 nq, const _u64 query_stride,
+        const _u64 k_search, const _u64 l_search, _s64 *res_ids,
+        float *res_dists, const _u64 beam_width, const _u64 max_inflight,
+        QueryStats *stats = nullptr, knowhere::BitsetView bitset_view = nullptr,
+        const float filter_ratio = -1.0f);
+
     void calc_dist_by_ids(const T *query, const int64_t *ids, const int64_t n,
                           float *const output_dists);
 
@@ -262,14 +325,20 @@ namespace diskann {
     // sector # on disk where node_id is present with in the graph part
     virtual _u64 get_node_sector_offset(_u64 node_id) {
       return long_node ? (node_id * nsectors_per_node + 1) * diskann::defaults::SECTOR_LEN
-                       : (node_id / nnodes_per_sector + 1) * diskann::defaults::SECTOR_LEN;
+                       : (get_node_slot(node_id) / nnodes_per_sector + 1) * diskann::defaults::SECTOR_LEN;
     }
 
     // obtains region of sector containing node
     char *get_offset_to_node(char *sector_buf, _u64 node_id) {
-      return long_node
-                 ? sector_buf
-                 : sector_buf + (node_id % nnodes_per_sector) * max_node_len;
+      return long_node ? sector_buf
+                       : sector_buf + (get_node_slot(node_id) % nnodes_per_sector) *
+                                          max_node_len;
+    }
+
+    // position of the node in the graph part, its id unless the index was
+    // written with a bfs layout
+    _u64 get_node_slot(_u64 node_id) const {
+      return node_slots.empty() ? node_id : node_slots[node_id];
     }
 
     void copy_vec_base_data(T *des, const int64_t des_idx, void *src);
@@ -278,6 +347,16 @@ namespace diskann {
     // If there is no value, there is nothing to do with the given query
     std::optional<float> init_thread_data(ThreadData<T> &data, const T *query1);
 
+    // Steps of cached_beam_search: start seeds the candidate list from the
+    // closest medoid, next picks the following beam and returns false once
+    // the search has converged, expand consumes the beam after its sectors
+    // have been read and finish writes out the results.
+    void beam_search_start(BeamSearchState<T> &s);
+    bool beam_search_next(BeamSearchState<T> &s);
+    void beam_search_expand(BeamSearchState<T> &s);
+    void beam_search_finish(BeamSearchState<T> &s, IOContext &ctx,
+                            const bool use_reorder_data);
+
     // Brute force search for the given query. Use beam search rather than
     // sending whole bunch of requests at once to avoid all threads sending I/O
     // requests and the time overlaps.
@@ -297,11 +376,13 @@ namespace diskann {
                                                  T *output_data);
 
     // index info
-    // nhood of node `i` is in sector: [i / nnodes_per_sector]
-    // offset in sector: [(i % nnodes_per_sector) * max_node_len]
+    // nhood of node `i` is in sector: [slot(i) / nnodes_per_sector]
+    // offset in sector: [(slot(i) % nnodes_per_sector) * max_node_len]
     // nnbrs of node `i`: *(unsigned*) (buf)
     // nbrs of node `i`: ((unsigned*)buf) + 1
     _u64 max_node_len = 0, nnodes_per_sector = 0, max_degree = 0;
+    // slot of every node with a bfs layout, empty when slot(i) == i
+    std::vector<unsigned> node_slots;
 
     // Data used for searching with re-order vectors
     _u64 ndims_reorder_vecs = 0, reorder_data_start_sector = 0,
@@ -397,6 +478,9 @@ namespace diskann {
     T                        *coord_cache_buf = nullptr;
     tsl::robin_map<_u32, T *> coord_cache;
 
+    // nodes cached while searching, consulted after the static cache
+    std::unique_ptr<AdaptiveNodeCache> adaptive_cache = nullptr;
+
     // thread-specific scratch
     ConcurrentQueue<ThreadData<T>> thread_data;
     _u64                           max_nthreads;
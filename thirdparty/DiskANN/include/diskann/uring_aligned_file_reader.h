@@ -0,0 +1,75 @@
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "aligned_file_reader.h"
+#include "aio_context_pool.h"
+
+// AlignedFileReader backed by io_uring.
+//
+// Contexts are still handed out by the global AioContextPool, so the pool
+// keeps bounding the number of concurrent searches and the AiSAQ PQ reader,
+// which issues its own libaio reads on the same context, keeps working. Each
+// context is lazily paired with a private ring that has the index file and
+// the registered scratch buffers attached; a batch of reads costs a single
+// io_uring_enter (none with SQPOLL) for both submission and completion.
+class UringAlignedFileReader : public AlignedFileReader {
+ public:
+  explicit UringAlignedFileReader(bool sqpoll = false);
+  ~UringAlignedFileReader();
+
+  io_context_t get_ctx() override {
+    return ctx_pool_->pop();
+  }
+
+  void put_ctx(io_context_t ctx) override {
+    ctx_pool_->push(ctx);
+  }
+
+  // Open & close ops
+  // Blocking calls
+  void open(const std::string &fname) override;
+  void close() override;
+
+  void register_buffers(const std::vector<iovec> &bufs) override;
+
+  // process batch of aligned requests in parallel
+  // NOTE :: blocking call
+  void read(std::vector<AlignedRead> &read_reqs, IOContext &ctx,
+            bool async = false) override;
+
+  // async reads
+  void get_submitted_req(io_context_t &ctx, size_t n_ops) override;
+  void submit_req(io_context_t &ctx, std::vector<AlignedRead> &read_reqs) override;
+
+  // whether an io_uring with the given setup can be created on this kernel
+  static bool is_supported(bool sqpoll);
+
+ private:
+  struct Ring;
+
+  Ring *get_ring(io_context_t ctx);
+
+  FileHandle                      file_desc;
+  bool                            sqpoll_;
+  std::shared_ptr<AioContextPool> ctx_pool_;
+
+  std::mutex                               rings_mut_;
+  tsl::robin_map<io_context_t, Ring *>     rings_;
+  // fd of the first SQPOLL ring, the others attach to its poller thread
+  int                                      sq_owner_fd_ = -1;
+  std::shared_ptr<const std::vector<iovec>> fixed_bufs_;
+};
+
+namespace diskann {
+  enum class IOEngine { AIO = 0, URING = 1 };
+
+  // Selects the AlignedFileReader returned by create_aligned_file_reader().
+  // Returns false and keeps libaio when io_uring is requested but cannot be
+  // set up on this kernel.
+  bool set_global_io_engine(IOEngine engine, bool sqpoll = false);
+
+  std::shared_ptr<AlignedFileReader> create_aligned_file_reader();
+}  // namespace diskann
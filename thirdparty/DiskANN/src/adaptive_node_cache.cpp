@@ -0,0 +1,204 @@
+#include "diskann/adaptive_node_cache.h"
+
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+
+namespace {
+  // enough shards to keep writers of different nodes apart
+  static constexpr uint64_t max_shards = 64;
+  // CLOCK reference counts saturate here, so a node that was hit often
+  // survives that many sweeps of the hand
+  static constexpr uint8_t max_ref = 3;
+  // count-min sketch geometry; the counters are halved every
+  // `sketch_sample_factor` * (shard slots) misses so old hot spots fade
+  static constexpr uint64_t sketch_depth = 4;
+  static constexpr uint8_t  max_freq = 15;
+  static constexpr uint64_t sketch_sample_factor = 10;
+
+  inline uint64_t mix(uint64_t x) {
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ULL;
+    x ^= x >> 33;
+    return x;
+  }
+
+  inline uint64_t next_pow2(uint64_t x) {
+    uint64_t p = 1;
+    while (p < x) {
+      p <<= 1;
+    }
+    return p;
+  }
+}  // namespace
+
+namespace diskann {
+  struct AdaptiveNodeCache::Shard {
+    std::shared_mutex                      mtx;
+    tsl::robin_map<uint32_t, uint32_t>     slot_of;
+    std::vector<uint32_t>                  ids;
+    std::unique_ptr<std::atomic<uint8_t>[]> refs;
+    std::unique_ptr<char[]>                buf;
+    uint64_t                               n_slots = 0;
+    uint64_t                               n_used = 0;
+    uint64_t                               hand = 0;
+
+    std::vector<uint8_t> sketch;
+    uint64_t             sketch_mask = 0;
+    uint64_t             n_misses = 0;
+
+    Shard(uint64_t slots, uint64_t node_len) : n_slots(slots) {
+      slot_of.reserve(slots);
+      ids.resize(slots);
+      refs = std::make_unique<std::atomic<uint8_t>[]>(slots);
+      for (uint64_t i = 0; i < slots; i++) {
+        refs[i].store(0, std::memory_order_relaxed);
+      }
+      buf = std::make_unique<char[]>(slots * node_len);
+      const uint64_t width = next_pow2(std::max<uint64_t>(slots, 64));
+      sketch.assign(sketch_depth * width, 0);
+      sketch_mask = width - 1;
+    }
+
+    uint8_t *counter(uint32_t id, uint64_t row) {
+      const uint64_t h = mix(((uint64_t) id << 2) | row);
+      return &sketch[row * (sketch_mask + 1) + (h & sketch_mask)];
+    }
+
+    uint8_t frequency(uint32_t id) {
+      uint8_t f = max_freq;
+      for (uint64_t r = 0; r < sketch_depth; r++) {
+        f = std::min(f, *counter(id, r));
+      }
+      return f;
+    }
+
+    void record_miss(uint32_t id) {
+      for (uint64_t r = 0; r < sketch_depth; r++) {
+        auto c = counter(id, r);
+        if (*c < max_freq) {
+          (*c)++;
+        }
+      }
+      if (++n_misses >= sketch_sample_factor * n_slots) {
+        for (auto &c : sketch) {
+          c >>= 1;
+        }
+        n_misses = 0;
+      }
+    }
+
+    // advances the hand to a slot whose reference count ran out
+    uint64_t clock_victim() {
+      while (true) {
+        auto &ref = refs[hand];
+        const uint8_t r = ref.load(std::memory_order_relaxed);
+        if (r == 0) {
+          return hand;
+        }
+        ref.store(r - 1, std::memory_order_relaxed);
+        hand = (hand + 1) % n_slots;
+      }
+    }
+  };
+
+  AdaptiveNodeCache::AdaptiveNodeCache(uint64_t capacity, uint64_t node_len)
+      : node_len_(node_len) {
+    if (capacity == 0) {
+      return;
+    }
+    uint64_t n_shards = 1;
+    while (n_shards * 2 <= std::min(capacity, max_shards)) {
+      n_shards *= 2;
+    }
+    const uint64_t slots = capacity / n_shards;
+    shards_.reserve(n_shards);
+    for (uint64_t i = 0; i < n_shards; i++) {
+      shards_.emplace_back(std::make_unique<Shard>(slots, node_len));
+    }
+    capacity_ = slots * n_shards;
+  }
+
+  AdaptiveNodeCache::~AdaptiveNodeCache() = default;
+
+  AdaptiveNodeCache::Shard &AdaptiveNodeCache::shard_of(uint32_t id) {
+    return *shards_[mix(id) & (shards_.size() - 1)];
+  }
+
+  bool AdaptiveNodeCache::get(uint32_t id, char *out) {
+    if (capacity_ == 0) {
+      return false;
+    }
+    auto                               &shard = shard_of(id);
+    std::shared_lock<std::shared_mutex> lock(shard.mtx);
+    auto                                it = shard.slot_of.find(id);
+    if (it == shard.slot_of.end()) {
+      return false;
+    }
+    const uint32_t slot = it->second;
+    memcpy(out, shard.buf.get() + slot * node_len_, node_len_);
+    // racing hits may lose an increment, which CLOCK does not care about
+    auto         &ref = shard.refs[slot];
+    const uint8_t r = ref.load(std::memory_order_relaxed);
+    if (r < max_ref) {
+      ref.store(r + 1, std::memory_order_relaxed);
+    }
+    return true;
+  }
+
+  void AdaptiveNodeCache::offer(uint32_t id, const char *node) {
+    if (capacity_ == 0) {
+      return;
+    }
+    auto                               &shard = shard_of(id);
+    std::unique_lock<std::shared_mutex> lock(shard.mtx);
+    if (shard.slot_of.find(id) != shard.slot_of.end()) {
+      // another search read the same node in the meantime
+      return;
+    }
+    shard.record_miss(id);
+
+    uint64_t slot;
+    if (shard.n_used < shard.n_slots) {
+      slot = shard.n_used++;
+    } else {
+      slot = shard.clock_victim();
+      const uint32_t victim = shard.ids[slot];
+      if (shard.frequency(id) <= shard.frequency(victim)) {
+        return;
+      }
+      shard.slot_of.erase(victim);
+      shard.hand = (slot + 1) % shard.n_slots;
+    }
+    memcpy(shard.buf.get() + slot * node_len_, node, node_len_);
+    shard.ids[slot] = id;
+    shard.refs[slot].store(0, std::memory_order_relaxed);
+    shard.slot_of[id] = (uint32_t) slot;
+  }
+
+  uint64_t AdaptiveNodeCache::capacity() const {
+    return capacity_;
+  }
+
+  uint64_t AdaptiveNodeCache::size() const {
+    uint64_t n = 0;
+    for (auto &shard : shards_) {
+      std::shared_lock<std::shared_mutex> lock(shard->mtx);
+      n += shard->n_used;
+    }
+    return n;
+  }
+
+  uint64_t AdaptiveNodeCache::mem_size() const {
+    uint64_t bytes = sizeof(*this);
+    for (auto &shard : shards_) {
+      bytes += sizeof(Shard);
+      bytes += shard->n_slots * (node_len_ + sizeof(uint32_t) + 1);
+      bytes += shard->n_slots * sizeof(std::pair<uint32_t, uint32_t>) * 2;
+      bytes += shard->sketch.size();
+    }
+    return bytes;
+  }
+}  // namespace diskann
@@ -912,11 +912,47 @@ namespace diskann {
     return best_bw;
   }
 
+  // Order in which the nodes of a bfs layout are written: breadth-first from
+  // the medoid, then from every node that was not reached yet. The nodes
+  // discovered from the same node end up next to each other.
+  static std::vector<unsigned> bfs_layout_order(
+      const _u64 npts, const _u64 start, const std::vector<_u64> &nhood_offsets,
+      const std::vector<unsigned> &nhoods) {
+    std::vector<unsigned> order;
+    order.reserve(npts);
+    std::vector<bool> visited(npts, false);
+    auto bfs_from = [&](const _u64 root) {
+      _u64 head = order.size();
+      visited[root] = true;
+      order.push_back((unsigned) root);
+      while (head < order.size()) {
+        const unsigned node = order[head++];
+        for (_u64 j = nhood_offsets[node]; j < nhood_offsets[node + 1]; j++) {
+          const unsigned nbr = nhoods[j];
+          if (nbr < npts && !visited[nbr]) {
+            visited[nbr] = true;
+            order.push_back(nbr);
+          }
+        }
+      }
+    };
+    if (start < npts) {
+      bfs_from(start);
+    }
+    for (_u64 i = 0; i < npts; i++) {
+      if (!visited[i]) {
+        bfs_from(i);
+      }
+    }
+    return order;
+  }
+
   template<typename T>
   void create_disk_layout(const std::string base_file,
                           const std::string mem_index_file,
                           const std::string output_file,
-                          const std::string reorder_data_file) {
+                          const std::string reorder_data_file,
+                          const bool        bfs_layout) {
     unsigned npts, ndims;
 
     // amount to read or write in one shot
@@ -1018,6 +1054,29 @@ namespace diskann {
                           << "nnodes_per_sector: " << nnodes_per_sector << "B";
     }
 
+    // A bfs layout needs the whole graph to order the nodes, each node is then
+    // written to its slot in that order. The slot of every id is appended to
+    // the file, the ids themselves do not change.
+    const bool write_bfs_layout = bfs_layout && !long_node;
+    if (bfs_layout && long_node) {
+      LOG_KNOWHERE_WARNING_
+          << "BFS layout is not supported for nodes larger than a sector, "
+             "the nodes are written in id order.";
+    }
+    std::vector<_u64>     nhood_offsets;
+    std::vector<unsigned> nhoods;
+    if (write_bfs_layout) {
+      nhood_offsets.resize(npts_64 + 1, 0);
+      for (_u64 i = 0; i < npts_64; i++) {
+        unsigned nnbrs;
+        vamana_reader.read((char *) &nnbrs, sizeof(unsigned));
+        nhoods.resize(nhood_offsets[i] + nnbrs);
+        vamana_reader.read((char *) (nhoods.data() + nhood_offsets[i]),
+                           nnbrs * sizeof(unsigned));
+        nhood_offsets[i + 1] = nhood_offsets[i] + nnbrs;
+      }
+    }
+
     // number of sectors (1 for meta data)
     _u64 n_sectors =
         long_node ? nsector_per_node * npts_64
@@ -1031,8 +1090,14 @@ namespace diskann {
       n_reorder_sectors =
           ROUND_UP(npts_64, n_data_nodes_per_sector) / n_data_nodes_per_sector;
     }
+    _u64 n_layout_sectors =
+        write_bfs_layout
+            ? ROUND_UP(npts_64 * sizeof(unsigned), diskann::defaults::SECTOR_LEN) /
+                  diskann::defaults::SECTOR_LEN
+            : 0;
     _u64 disk_index_file_size =
-        (n_sectors + n_reorder_sectors + 1) * diskann::defaults::SECTOR_LEN;
+        (n_sectors + n_reorder_sectors + n_layout_sectors + 1) *
+        diskann::defaults::SECTOR_LEN;
 
     // SECTOR_LEN buffer for each sector
     _u64 sector_buf_size =
@@ -1055,6 +1120,9 @@ namespace diskann {
       *(_u64 *) (sector_buf.get() + 10 * sizeof(_u64)) =
           n_data_nodes_per_sector;
     }
+    // first sector of the node slots, 0 when the nodes are in id order
+    *(_u64 *) (sector_buf.get() + 11 * sizeof(_u64)) =
+        write_bfs_layout ? n_sectors + n_reorder_sectors + 1 : 0;
 
     diskann_writer.write(sector_buf.get(), diskann::defaults::SECTOR_LEN);
 
@@ -1084,6 +1152,17 @@ namespace diskann {
       return;
     }
 
+    std::vector<unsigned> layout_order;
+    std::vector<unsigned> node_slots;
+    std::ifstream         base_data_reader;
+    if (write_bfs_layout) {
+      layout_order = bfs_layout_order(npts_64, medoid, nhood_offsets, nhoods);
+      node_slots.resize(npts_64);
+      base_data_reader.exceptions(std::ifstream::failbit |
+                                  std::ifstream::badbit);
+      base_data_reader.open(base_file, std::ios::binary);
+    }
+
     LOG_KNOWHERE_DEBUG_ << "# sectors: " << n_sectors;
     _u64 cur_node_id = 0;
     for (_u64 sector = 0; sector < n_sectors; sector++) {
@@ -1100,6 +1179,23 @@ namespace diskann {
         char *nhood_buf =
             sector_node_buf + (ndims_64 * sizeof(T)) + sizeof(unsigned);
 
+        if (write_bfs_layout) {
+          // cur_node_id is the slot here, the node written to it comes from
+          // the bfs order and its coords are read at random from the base file
+          const unsigned node = layout_order[cur_node_id];
+          node_slots[node] = (unsigned) cur_node_id;
+          const _u64 node_nnbrs = nhood_offsets[node + 1] - nhood_offsets[node];
+          *(unsigned *) nnbrs = (unsigned) node_nnbrs;
+          memcpy(nhood_buf, nhoods.data() + nhood_offsets[node],
+                 node_nnbrs * sizeof(unsigned));
+          base_data_reader.seekg(2 * sizeof(uint32_t) +
+                                 (_u64) node * ndims_64 * sizeof(T));
+          base_data_reader.read(sector_node_buf, sizeof(T) * ndims_64);
+
+          cur_node_id++;
+          continue;
+        }
+
         // read cur node's nnbrs
         vamana_reader.read(nnbrs, sizeof(unsigned));
 
@@ -1146,6 +1242,15 @@ namespace diskann {
         diskann_writer.write(sector_buf.get(), diskann::defaults::SECTOR_LEN);
       }
     }
+    if (write_bfs_layout) {
+      LOG_KNOWHERE_INFO_ << "Index written. Appending the node slots...";
+      diskann_writer.write((char *) node_slots.data(),
+                           npts_64 * sizeof(unsigned));
+      memset(sector_buf.get(), 0, diskann::defaults::SECTOR_LEN);
+      diskann_writer.write(sector_buf.get(),
+                           n_layout_sectors * diskann::defaults::SECTOR_LEN -
+                               npts_64 * sizeof(unsigned));
+    }
     LOG_KNOWHERE_DEBUG_ << "Output file written.";
   }
 
@@ -2018,15 +2123,18 @@ template<typename T>
     {
         if (!use_disk_pq) {
           diskann::create_disk_layout<T>(data_file_to_save.c_str(), mem_index_path,
-                                         disk_index_path);
+                                         disk_index_path, std::string(""),
+                                         config.bfs_layout);
         } else {
           if (!reorder_data)
             diskann::create_disk_layout<_u8>(disk_pq_compressed_vectors_path,
-                                             mem_index_path, disk_index_path);
+                                             mem_index_path, disk_index_path,
+                                             std::string(""), config.bfs_layout);
           else
             diskann::create_disk_layout<_u8>(disk_pq_compressed_vectors_path,
                                              mem_index_path, disk_index_path,
-                                             data_file_to_save.c_str());
+                                             data_file_to_save.c_str(),
+                                             config.bfs_layout);
         }
     }
     double ten_percent_points = std::ceil(points_num * 0.1);
@@ -2072,20 +2180,25 @@ template<typename T>
   template void create_disk_layout<int8_t>(const std::string base_file,
                                            const std::string mem_index_file,
                                            const std::string output_file,
-                                           const std::string reorder_data_file);
+                                           const std::string reorder_data_file,
+                                           const bool        bfs_layout);
   template void create_disk_layout<uint8_t>(
       const std::string base_file, const std::string mem_index_file,
-      const std::string output_file, const std::string reorder_data_file);
+      const std::string output_file, const std::string reorder_data_file,
+      const bool bfs_layout);
   template void create_disk_layout<float>(const std::string base_file,
                                           const std::string mem_index_file,
                                           const std::string output_file,
-                                          const std::string reorder_data_file);
+                                          const std::string reorder_data_file,
+                                          const bool        bfs_layout);
   template void create_disk_layout<knowhere::fp16>(
       const std::string base_file, const std::string mem_index_file,
-      const std::string output_file, const std::string reorder_data_file);
+      const std::string output_file, const std::string reorder_data_file,
+      const bool bfs_layout);
   template void create_disk_layout<knowhere::bf16>(
       const std::string base_file, const std::string mem_index_file,
-      const std::string output_file, const std::string reorder_data_file);
+      const std::string output_file, const std::string reorder_data_file,
+      const bool bfs_layout);
 
   template int8_t  *load_warmup<int8_t>(const std::string &cache_warmup_file,
                                        uint64_t          &warmup_num,
@@ -235,6 +235,7 @@ namespace diskann {
   void PQFlashIndex<T>::setup_thread_data(_u64 nthreads) {
     LOG(INFO) << "Setting up thread-specific contexts for nthreads: "
               << nthreads;
+    std::vector<iovec> sector_bufs;
     for (_s64 thread = 0; thread < (_s64) nthreads; thread++) {
       QueryScratch<T> scratch;
       _u64 coord_alloc_size = ROUND_UP(sizeof(T) * this->aligned_dim, 256);
@@ -264,10 +265,16 @@ namespace diskann {
              this->aligned_dim * sizeof(T));
       memset(scratch.aligned_query_float, 0, this->aligned_dim * sizeof(float));
 
+      sector_bufs.push_back(
+          {scratch.sector_scratch,
+           (_u64) diskann::defaults::MAX_N_SECTOR_READS * read_len_for_node});
+
       ThreadData<T> data;
       data.scratch = scratch;
       this->thread_data.push(data);
     }
+    // every beam search read lands in a sector scratch
+    reader->register_buffers(sector_bufs);
     load_flag = true;
   }
 
@@ -517,6 +524,19 @@ namespace diskann {
     return;
   }
 
+  template<typename T>
+  void PQFlashIndex<T>::enable_adaptive_cache(_u64 num_nodes_to_cache) {
+    if (num_nodes_to_cache == 0) {
+      adaptive_cache.reset();
+      return;
+    }
+    // nodes are kept in their on-disk layout, coords followed by the nhood
+    adaptive_cache =
+        std::make_unique<AdaptiveNodeCache>(num_nodes_to_cache, max_node_len);
+    LOG(INFO) << "Adaptive cache holds up to " << adaptive_cache->capacity()
+              << " nodes";
+  }
+
   template<typename T>
   void PQFlashIndex<T>::cache_bfs_levels(_u64 num_nodes_to_cache,
                                          std::vector<uint32_t> &node_list) {
@@ -821,6 +841,20 @@ namespace diskann {
       READ_U64(index_metadata, this->ndims_reorder_vecs);
       READ_U64(index_metadata, this->nvecs_per_sector);
     }
+
+    // the first sector of the node slots of a bfs layout, 0 otherwise
+    _u64 node_slots_start_sector;
+    index_metadata.seekg(11 * sizeof(_u64), index_metadata.beg);
+    READ_U64(index_metadata, node_slots_start_sector);
+    this->node_slots.clear();
+    if (node_slots_start_sector != 0 && !long_node) {
+      this->node_slots.resize(num_points);
+      index_metadata.seekg(node_slots_start_sector * diskann::defaults::SECTOR_LEN,
+                           index_metadata.beg);
+      index_metadata.read((char *) this->node_slots.data(),
+                          num_points * sizeof(unsigned));
+      LOG(INFO) << "Disk-Index nodes are stored in bfs order.";
+    }
     LOG(INFO) << "Disk-Index File Meta-data: "
               << "# nodes per sector: " << nnodes_per_sector
               << ", max node len (bytes): " << max_node_len
@@ -1148,59 +1182,62 @@ namespace diskann {
       return;
     }
 
-    auto         query_scratch = &(data.scratch);
-    const T     *query = data.scratch.aligned_query_T;
-    const float *query_float = data.scratch.aligned_query_float;
-
-    // pointers to buffers for data
-    T *data_buf = query_scratch->coord_scratch;
+    BeamSearchState<T> s;
+    s.data = data;
+    s.query_norm = query_norm;
+    s.k_search = k_search;
+    s.l_search = l_search;
+    s.beam_width = beam_width;
+    s.indices = indices;
+    s.distances = distances;
+    s.stats = stats;
+    s.feder = &feder;
+    s.bitset_view = bitset_view;
+    beam_search_start(s);
+
+    Timer io_timer;
+    while (beam_search_next(s)) {
+      if (!s.frontier_read_reqs.empty()) {
+        io_timer.reset();
+        reader->read(s.frontier_read_reqs, ctx);  // synchronous IO linux
+        if (stats != nullptr) {
+          stats->io_us += (double) io_timer.elapsed();
+        }
+      }
+      beam_search_expand(s);
+    }
+    beam_search_finish(s, ctx, use_reorder_data);
 
-    // sector scratch
-    char *sector_scratch = query_scratch->sector_scratch;
-    _u64 &sector_scratch_idx = query_scratch->sector_idx;
+    this->thread_data.push(data);
+    this->thread_data.push_notify_all();
+    this->reader->put_ctx(ctx);
+  }
 
-    Timer io_timer, query_timer;
-    // cleared every iteration
-    std::vector<unsigned> frontier;
-    frontier.reserve(2 * beam_width);
-    std::vector<std::pair<unsigned, char *>> frontier_nhoods;
-    frontier_nhoods.reserve(2 * beam_width);
-    std::vector<AlignedRead> frontier_read_reqs;
-    frontier_read_reqs.reserve(2 * beam_width);
-    std::vector<std::pair<unsigned, std::pair<unsigned, unsigned *>>>
-        cached_nhoods;
-    cached_nhoods.reserve(2 * beam_width);
+  template<typename T>
+  void PQFlashIndex<T>::beam_search_start(BeamSearchState<T> &s) {
+    s.query_timer.reset();
+    auto         query_scratch = &(s.data.scratch);
+    const float *query_float = query_scratch->aligned_query_float;
+
+    s.frontier.reserve(2 * s.beam_width);
+    s.frontier_nhoods.reserve(2 * s.beam_width);
+    s.frontier_read_reqs.reserve(2 * s.beam_width);
+    s.cached_nhoods.reserve(2 * s.beam_width);
+    s.adaptive_nhoods.reserve(2 * s.beam_width);
+    s.filtered_nbrs.reserve(this->max_degree);
 
     // query <-> PQ chunk centers distances
     float *pq_dists = query_scratch->aligned_pqtable_dist_scratch;
     pq_table.populate_chunk_distances(query_float, pq_dists);
 
-    // query <-> neighbor list
-    float *dist_scratch = query_scratch->aligned_dist_scratch;
-    _u8   *pq_coord_scratch = query_scratch->aligned_pq_coord_scratch;
-
-    // lambda to batch compute query<-> node distances in PQ space
-    auto compute_dists = [this, pq_coord_scratch, pq_dists](const unsigned *ids,
-                                                            const _u64 n_ids,
-                                                            float *dists_out) {
-      aggregate_coords(ids, n_ids, this->data.get(), this->n_chunks,
-                       pq_coord_scratch);
-      pq_dist_lookup(pq_coord_scratch, n_ids, this->n_chunks, pq_dists,
-                     dists_out);
-    };
-    Timer                 cpu_timer;
-    std::vector<Neighbor> retset(l_search + 1);
-    tsl::robin_set<_u64> &visited = *(query_scratch->visited);
-
-    std::vector<Neighbor> full_retset;
-    full_retset.reserve(4096);
+    s.retset.resize(s.l_search + 1);
+    s.full_retset.reserve(4096);
     // auto vec_hash = knowhere::hash_vec(query_float, data_dim);
     _u32 best_medoid = 0;
     // for tuning, do not use cache
 
     float best_dist = (std::numeric_limits<float>::max)();
 
-    std::vector<SimpleNeighbor> medoid_dists;
     for (_u64 cur_m = 0; cur_m < num_medoids; cur_m++) {
       float cur_expanded_dist =
           dist_cmp_float_wrap(query_float, centroid_data + aligned_dim * cur_m,
@@ -1211,27 +1248,167 @@ namespace diskann {
       }
     }
 
-    compute_dists(&best_medoid, 1, dist_scratch);
-    retset[0].id = best_medoid;
-    retset[0].flag = true;
-    retset[0].distance = dist_scratch[0];
-    visited.insert(best_medoid);
+    float *dist_scratch = query_scratch->aligned_dist_scratch;
+    aggregate_coords(&best_medoid, 1, this->data.get(), this->n_chunks,
+                     query_scratch->aligned_pq_coord_scratch);
+    pq_dist_lookup(query_scratch->aligned_pq_coord_scratch, 1, this->n_chunks,
+                   pq_dists, dist_scratch);
+    s.retset[0].id = best_medoid;
+    s.retset[0].flag = true;
+    s.retset[0].distance = dist_scratch[0];
+    query_scratch->visited->insert(best_medoid);
+
+    s.cur_list_size = 1;
+    s.k = 0;
+    s.read_sectors.clear();
+    s.n_ring_slots = 0;
+  }
+
+  template<typename T>
+  bool PQFlashIndex<T>::beam_search_next(BeamSearchState<T> &s) {
+    if (s.k >= s.cur_list_size) {
+      return false;
+    }
+    auto                 &retset = s.retset;
+    auto                 &cur_list_size = s.cur_list_size;
+    const auto           &bitset_view = s.bitset_view;
+    QueryStats           *stats = s.stats;
+    auto                  query_scratch = &(s.data.scratch);
+    char                 *sector_scratch = query_scratch->sector_scratch;
+
+    // clear iteration state
+    s.frontier.clear();
+    s.frontier_nhoods.clear();
+    s.frontier_read_reqs.clear();
+    s.cached_nhoods.clear();
+    s.adaptive_nhoods.clear();
+    // find new beam
+    _u32 marker = s.k;
+    _u32 num_seen = 0;
+    while (marker < cur_list_size && s.frontier.size() < s.beam_width &&
+           num_seen < s.beam_width) {
+      if (retset[marker].flag) {
+        num_seen++;
+        {
+          std::shared_lock<std::shared_mutex> lock(this->cache_mtx);
+          auto iter = nhood_cache.find(retset[marker].id);
+          if (iter != nhood_cache.end()) {
+            s.cached_nhoods.push_back(
+                std::make_pair(retset[marker].id, iter->second));
+            if (stats != nullptr) {
+              stats->n_cache_hits++;
+            }
+          } else {
+            s.frontier.push_back(retset[marker].id);
+          }
+        }
+        retset[marker].flag = false;
+        {
+          std::shared_lock<std::shared_mutex> lock(
+              this->node_visit_counter_mtx);
+          if (this->count_visited_nodes) {
+            this->node_visit_counter[retset[marker].id].second->fetch_add(1);
+          }
+        }
+        if (!bitset_view.empty() && bitset_view.test(retset[marker].id)) {
+          std::memmove(&retset[marker], &retset[marker + 1],
+                       (cur_list_size - marker - 1) * sizeof(Neighbor));
+          cur_list_size--;
+        } else {
+          marker++;
+        }
+      } else {
+        marker++;
+      }
+    }
+
+    // read nhoods of frontier ids
+    if (!s.frontier.empty()) {
+      if (stats != nullptr)
+        stats->n_hops++;
+      for (_u64 i = 0; i < s.frontier.size(); i++) {
+        auto                    id = s.frontier[i];
+        std::pair<_u32, char *> fnhood;
+        fnhood.first = id;
+        const _u64 sector_offset = get_node_sector_offset(((size_t) id));
+        if (!long_node) {
+          // the sector was read by this beam or a recent one, it is reused
+          // unless the slots this beam may still take can wrap around to it
+          auto iter = s.read_sectors.find(sector_offset);
+          if (iter != s.read_sectors.end() &&
+              s.n_ring_slots - iter->second + s.beam_width <=
+                  defaults::MAX_N_SECTOR_READS) {
+            fnhood.second =
+                sector_scratch + (iter->second % defaults::MAX_N_SECTOR_READS) *
+                                     read_len_for_node;
+            s.frontier_nhoods.push_back(fnhood);
+            continue;
+          }
+        }
+        const _u64 slot_no = s.n_ring_slots++;
+        fnhood.second =
+            sector_scratch +
+            (slot_no % defaults::MAX_N_SECTOR_READS) * read_len_for_node;
+        if (adaptive_cache != nullptr &&
+            adaptive_cache->get(id, get_offset_to_node(fnhood.second, id))) {
+          s.adaptive_nhoods.push_back(fnhood);
+          if (stats != nullptr) {
+            stats->n_cache_hits++;
+          }
+          continue;
+        }
+        s.frontier_nhoods.push_back(fnhood);
+        s.frontier_read_reqs.emplace_back(sector_offset, read_len_for_node,
+                                          fnhood.second);
+        if (!long_node) {
+          s.read_sectors[sector_offset] = slot_no;
+        }
+        if (stats != nullptr) {
+          stats->n_4k++;
+          stats->n_ios++;
+        }
+      }
+    }
+    return true;
+  }
 
-    unsigned cur_list_size = 1;
+  template<typename T>
+  void PQFlashIndex<T>::beam_search_expand(BeamSearchState<T> &s) {
+    auto                 &retset = s.retset;
+    auto                 &cur_list_size = s.cur_list_size;
+    const auto           &bitset_view = s.bitset_view;
+    const auto           &feder = *s.feder;
+    QueryStats           *stats = s.stats;
+    const _u64            l_search = s.l_search;
+    auto                  query_scratch = &(s.data.scratch);
+    const T              *query = query_scratch->aligned_query_T;
+    const float          *query_float = query_scratch->aligned_query_float;
+    tsl::robin_set<_u64> &visited = *(query_scratch->visited);
 
-    std::sort(retset.begin(), retset.begin() + cur_list_size);
+    // pointers to buffers for data
+    T *data_buf = query_scratch->coord_scratch;
 
-    unsigned cmps = 0;
-    unsigned hops = 0;
-    unsigned num_ios = 0;
-    unsigned k = 0;
+    // query <-> PQ chunk centers distances
+    float *pq_dists = query_scratch->aligned_pqtable_dist_scratch;
+
+    // query <-> neighbor list
+    float *dist_scratch = query_scratch->aligned_dist_scratch;
+    _u8   *pq_coord_scratch = query_scratch->aligned_pq_coord_scratch;
+
+    // lambda to batch compute query<-> node distances in PQ space
+    auto compute_dists = [this, pq_coord_scratch, pq_dists](const unsigned *ids,
+                                                            const _u64 n_ids,
+                                                            float *dists_out) {
+      aggregate_coords(ids, n_ids, this->data.get(), this->n_chunks,
+                       pq_coord_scratch);
+      pq_dist_lookup(pq_coord_scratch, n_ids, this->n_chunks, pq_dists,
+                     dists_out);
+    };
+    Timer cpu_timer;
 
-    float                 accumulative_alpha = 0;
-    std::vector<unsigned> filtered_nbrs;
-    filtered_nbrs.reserve(this->max_degree);
     auto filter_nbrs = [&](_u64      nnbrs,
                            unsigned *node_nbrs) -> std::pair<_u64, unsigned *> {
-      filtered_nbrs.clear();
+      s.filtered_nbrs.clear();
       for (_u64 m = 0; m < nnbrs; ++m) {
         unsigned id = node_nbrs[m];
         if (visited.find(id) != visited.end()) {
@@ -1239,197 +1416,145 @@ namespace diskann {
         }
         visited.insert(id);
         if (!bitset_view.empty() && bitset_view.test(id)) {
-          accumulative_alpha += kAlpha;
-          if (accumulative_alpha < 1.0f) {
+          s.accumulative_alpha += kAlpha;
+          if (s.accumulative_alpha < 1.0f) {
             continue;
           }
-          accumulative_alpha -= 1.0f;
+          s.accumulative_alpha -= 1.0f;
         }
-        cmps++;
-        filtered_nbrs.push_back(id);
+        s.filtered_nbrs.push_back(id);
       }
-      return {filtered_nbrs.size(), filtered_nbrs.data()};
+      return {s.filtered_nbrs.size(), s.filtered_nbrs.data()};
     };
 
-    while (k < cur_list_size) {
-      auto nk = cur_list_size;
-      // clear iteration state
-      frontier.clear();
-      frontier_nhoods.clear();
-      frontier_read_reqs.clear();
-      cached_nhoods.clear();
-      sector_scratch_idx = 0;
-      // find new beam
-      _u32 marker = k;
-      _u32 num_seen = 0;
-      while (marker < cur_list_size && frontier.size() < beam_width &&
-             num_seen < beam_width) {
-        if (retset[marker].flag) {
-          num_seen++;
-          {
-            std::shared_lock<std::shared_mutex> lock(this->cache_mtx);
-            auto iter = nhood_cache.find(retset[marker].id);
-            if (iter != nhood_cache.end()) {
-              cached_nhoods.push_back(
-                  std::make_pair(retset[marker].id, iter->second));
-              if (stats != nullptr) {
-                stats->n_cache_hits++;
-              }
-            } else {
-              frontier.push_back(retset[marker].id);
-            }
-          }
-          retset[marker].flag = false;
-          {
-            std::shared_lock<std::shared_mutex> lock(
-                this->node_visit_counter_mtx);
-            if (this->count_visited_nodes) {
-              this->node_visit_counter[retset[marker].id].second->fetch_add(1);
-            }
-          }
-          if (!bitset_view.empty() && bitset_view.test(retset[marker].id)) {
-            std::memmove(&retset[marker], &retset[marker + 1],
-                         (cur_list_size - marker - 1) * sizeof(Neighbor));
-            cur_list_size--;
-          } else {
-            marker++;
-          }
+    auto nk = cur_list_size;
+    auto process_node = [&](T *node_fp_coords_copy, auto node_id, auto n_nbr,
+                            auto *nbrs) {
+      if (bitset_view.empty() || !bitset_view.test(node_id)) {
+        float cur_expanded_dist;
+        if (!use_disk_index_pq) {
+          cur_expanded_dist = dist_cmp_wrap(query, node_fp_coords_copy,
+                                            (size_t) aligned_dim, node_id);
         } else {
-          marker++;
+          if (metric == diskann::Metric::INNER_PRODUCT ||
+              metric == diskann::Metric::COSINE)
+            cur_expanded_dist = disk_pq_table.inner_product(
+                query_float, (_u8 *) node_fp_coords_copy);
+          else
+            cur_expanded_dist = disk_pq_table.l2_distance(
+                query_float, (_u8 *) node_fp_coords_copy);
         }
-      }
+        s.full_retset.push_back(
+            Neighbor((unsigned) node_id, cur_expanded_dist, true));
 
-      // read nhoods of frontier ids
-      if (!frontier.empty()) {
-        if (stats != nullptr)
-          stats->n_hops++;
-        for (_u64 i = 0; i < frontier.size(); i++) {
-          auto                    id = frontier[i];
-          std::pair<_u32, char *> fnhood;
-          fnhood.first = id;
-          fnhood.second =
-              sector_scratch + sector_scratch_idx * read_len_for_node;
-          sector_scratch_idx++;
-          frontier_nhoods.push_back(fnhood);
-          frontier_read_reqs.emplace_back(get_node_sector_offset(((size_t) id)),
-                                          read_len_for_node, fnhood.second);
-          if (stats != nullptr) {
-            stats->n_4k++;
-            stats->n_ios++;
-          }
-          num_ios++;
-        }
-        io_timer.reset();
-        reader->read(frontier_read_reqs, ctx);  // synchronous IO linux
-        if (stats != nullptr) {
-          stats->io_us += (double) io_timer.elapsed();
+        // add top candidate info into feder result
+        if (feder != nullptr) {
+          feder->visit_info_.AddTopCandidateInfo(node_id, cur_expanded_dist);
+          feder->id_set_.insert(node_id);
         }
       }
+      auto [nnbrs, node_nbrs] = filter_nbrs(n_nbr, nbrs);
 
-      auto process_node = [&](T *node_fp_coords_copy, auto node_id, auto n_nbr,
-                              auto *nbrs) {
-        if (bitset_view.empty() || !bitset_view.test(node_id)) {
-          float cur_expanded_dist;
-          if (!use_disk_index_pq) {
-            cur_expanded_dist = dist_cmp_wrap(query, node_fp_coords_copy,
-                                              (size_t) aligned_dim, node_id);
-          } else {
-            if (metric == diskann::Metric::INNER_PRODUCT ||
-                metric == diskann::Metric::COSINE)
-              cur_expanded_dist = disk_pq_table.inner_product(
-                  query_float, (_u8 *) node_fp_coords_copy);
-            else
-              cur_expanded_dist = disk_pq_table.l2_distance(
-                  query_float, (_u8 *) node_fp_coords_copy);
-          }
-          full_retset.push_back(
-              Neighbor((unsigned) node_id, cur_expanded_dist, true));
-
-          // add top candidate info into feder result
-          if (feder != nullptr) {
-            feder->visit_info_.AddTopCandidateInfo(node_id, cur_expanded_dist);
-            feder->id_set_.insert(node_id);
-          }
-        }
-        auto [nnbrs, node_nbrs] = filter_nbrs(n_nbr, nbrs);
-
-        // compute node_nbrs <-> query dists in PQ space
-        cpu_timer.reset();
-        compute_dists(node_nbrs, nnbrs, dist_scratch);
-        if (stats != nullptr) {
-          stats->n_cmps += (double) nnbrs;
-          stats->cpu_us += (double) cpu_timer.elapsed();
-        }
-
-        cpu_timer.reset();
-        // process prefetched nhood
-        for (_u64 m = 0; m < nnbrs; ++m) {
-          unsigned id = node_nbrs[m];
+      // compute node_nbrs <-> query dists in PQ space
+      cpu_timer.reset();
+      compute_dists(node_nbrs, nnbrs, dist_scratch);
+      if (stats != nullptr) {
+        stats->n_cmps += (double) nnbrs;
+        stats->cpu_us += (double) cpu_timer.elapsed();
+      }
 
-          // add neighbor info into feder result
-          if (feder != nullptr) {
-            feder->visit_info_.AddTopCandidateNeighbor(node_id, id,
-                                                       dist_scratch[m]);
-            feder->id_set_.insert(id);
-          }
+      cpu_timer.reset();
+      // process prefetched nhood
+      for (_u64 m = 0; m < nnbrs; ++m) {
+        unsigned id = node_nbrs[m];
 
-          float dist = dist_scratch[m];
-          if (stats != nullptr) {
-            stats->n_cmps++;
-          }
-          if (cur_list_size > 0 && dist >= retset[cur_list_size - 1].distance &&
-              (cur_list_size == l_search))
-            continue;
-          Neighbor nn(id, dist, true);
-          // Return position in sorted list where nn inserted.
-          auto r = InsertIntoPool(retset.data(), cur_list_size, nn);
-          if (cur_list_size < l_search)
-            ++cur_list_size;
-          if (r < nk)
-            // nk logs the best position in the retset that was
-            // updated due to neighbors of n.
-            nk = r;
-        }
-        if (stats != nullptr) {
-          stats->cpu_us += (double) cpu_timer.elapsed();
+        // add neighbor info into feder result
+        if (feder != nullptr) {
+          feder->visit_info_.AddTopCandidateNeighbor(node_id, id,
+                                                     dist_scratch[m]);
+          feder->id_set_.insert(id);
         }
-      };
 
-      // process cached nhoods
-      for (auto &cached_nhood : cached_nhoods) {
+        float dist = dist_scratch[m];
         if (stats != nullptr) {
-          stats->n_hops++;
-        }
-        T *node_fp_coords_copy;
-        {
-          std::shared_lock<std::shared_mutex> lock(this->cache_mtx);
-          auto global_cache_iter = coord_cache.find(cached_nhood.first);
-          node_fp_coords_copy = global_cache_iter->second;
+          stats->n_cmps++;
         }
-        process_node(node_fp_coords_copy, cached_nhood.first,
-                     cached_nhood.second.first, cached_nhood.second.second);
+        if (cur_list_size > 0 && dist >= retset[cur_list_size - 1].distance &&
+            (cur_list_size == l_search))
+          continue;
+        Neighbor nn(id, dist, true);
+        // Return position in sorted list where nn inserted.
+        auto r = InsertIntoPool(retset.data(), cur_list_size, nn);
+        if (cur_list_size < l_search)
+          ++cur_list_size;
+        if (r < nk)
+          // nk logs the best position in the retset that was
+          // updated due to neighbors of n.
+          nk = r;
+      }
+      if (stats != nullptr) {
+        stats->cpu_us += (double) cpu_timer.elapsed();
       }
+    };
 
-      for (auto &frontier_nhood : frontier_nhoods) {
-        char *node_disk_buf =
-            get_offset_to_node(frontier_nhood.second, frontier_nhood.first);
-        unsigned *node_buf = OFFSET_TO_NODE_NHOOD(node_disk_buf);
-        T        *node_fp_coords = OFFSET_TO_NODE_COORDS(node_disk_buf);
-        T        *node_fp_coords_copy = data_buf;
-        memcpy(node_fp_coords_copy, node_fp_coords, disk_bytes_per_point);
-        process_node(node_fp_coords_copy, frontier_nhood.first, *node_buf,
-                     node_buf + 1);
+    // process cached nhoods
+    for (auto &cached_nhood : s.cached_nhoods) {
+      if (stats != nullptr) {
+        stats->n_hops++;
       }
+      T *node_fp_coords_copy;
+      {
+        std::shared_lock<std::shared_mutex> lock(this->cache_mtx);
+        auto global_cache_iter = coord_cache.find(cached_nhood.first);
+        node_fp_coords_copy = global_cache_iter->second;
+      }
+      process_node(node_fp_coords_copy, cached_nhood.first,
+                   cached_nhood.second.first, cached_nhood.second.second);
+    }
+
+    auto process_sector_node = [&](const std::pair<unsigned, char *> &nhood) {
+      char     *node_disk_buf = get_offset_to_node(nhood.second, nhood.first);
+      unsigned *node_buf = OFFSET_TO_NODE_NHOOD(node_disk_buf);
+      T        *node_fp_coords = OFFSET_TO_NODE_COORDS(node_disk_buf);
+      T        *node_fp_coords_copy = data_buf;
+      memcpy(node_fp_coords_copy, node_fp_coords, disk_bytes_per_point);
+      process_node(node_fp_coords_copy, nhood.first, *node_buf, node_buf + 1);
+    };
 
-      // update best inserted position
-      if (nk <= k)
-        k = nk;  // k is the best position in retset updated in this round.
-      else
-        ++k;
+    for (auto &adaptive_nhood : s.adaptive_nhoods) {
+      process_sector_node(adaptive_nhood);
+    }
 
-      hops++;
+    for (auto &frontier_nhood : s.frontier_nhoods) {
+      process_sector_node(frontier_nhood);
+      if (adaptive_cache != nullptr) {
+        adaptive_cache->offer(
+            frontier_nhood.first,
+            get_offset_to_node(frontier_nhood.second, frontier_nhood.first));
+      }
     }
 
+    // update best inserted position
+    if (nk <= s.k)
+      s.k = nk;  // k is the best position in retset updated in this round.
+    else
+      ++s.k;
+  }
+
+  template<typename T>
+  void PQFlashIndex<T>::beam_search_finish(BeamSearchState<T> &s,
+                                           IOContext         &ctx,
+                                           const bool use_reorder_data) {
+    auto        &full_retset = s.full_retset;
+    const _u64   k_search = s.k_search;
+    _s64        *indices = s.indices;
+    float       *distances = s.distances;
+    QueryStats  *stats = s.stats;
+    const T     *query = s.data.scratch.aligned_query_T;
+    char        *sector_scratch = s.data.scratch.sector_scratch;
+    const float  query_norm = s.query_norm;
+    Timer        io_timer;
+
     // re-sort by distance
     std::sort(full_retset.begin(), full_retset.end(),
               [](const Neighbor &left, const Neighbor &right) {
@@ -1506,18 +1631,209 @@ namespace diskann {
       }
     }
 
-    this->thread_data.push(data);
-    this->thread_data.push_notify_all();
-    this->reader->put_ctx(ctx);
-
     if (stats != nullptr) {
-      stats->total_us = (double) query_timer.elapsed();
+      stats->total_us = (double) s.query_timer.elapsed();
     }
     if (this->count_visited_nodes) {
       this->search_counter.fetch_add(1);
     }
   }
 
+  template<typename T>
+  void PQFlashIndex<T>::batch_cached_beam_search(
+      const T *queries, const _u64 nq, const _u64 query_stride,
+      const _u64 k_search, const _u64 l_search, _s64 *indices,
+      float *distances, const _u64 beam_width, const _u64 max_inflight,
+      QueryStats *stats, knowhere::BitsetView bitset_view,
+      const float filter_ratio_in) {
+    if (beam_width > defaults::MAX_N_SECTOR_READS)
+      throw ANNException("Beamwidth can not be higher than MAX_N_SECTOR_READS",
+                         -1, __FUNCSIG__, __FILE__, __LINE__);
+
+    auto search_one = [&](_u64 q) {
+      cached_beam_search(
+          queries + q * query_stride, k_search, l_search,
+          indices + q * k_search,
+          distances == nullptr ? nullptr : distances + q * k_search,
+          beam_width, false, stats == nullptr ? nullptr : stats + q, nullptr,
+          bitset_view, filter_ratio_in);
+    };
+
+    // the brute force fallbacks read in large batches on their own
+    size_t bv_cnt = 0;
+    bool   brute_force = false;
+    if (!bitset_view.empty()) {
+      const auto filter_threshold =
+          filter_ratio_in < 0 ? kFilterThreshold : filter_ratio_in;
+      bv_cnt = bitset_view.count();
+      brute_force = bitset_view.size() == bv_cnt ||
+                    bv_cnt >= bitset_view.size() * filter_threshold;
+    }
+    brute_force = brute_force || k_search > 0.5 * (num_points - bv_cnt);
+
+    // the reads of one group must fit in a single io context
+    const _u64 max_events =
+        AioContextPool::GetGlobalAioPool()->max_events_per_ctx();
+    const _u64 group_cap = std::max<_u64>(1, max_events / beam_width);
+    const _u64 n_slots = std::min({max_inflight, nq, 2 * group_cap});
+    if (brute_force || n_slots <= 1) {
+      for (_u64 q = 0; q < nq; q++) {
+        search_one(q);
+      }
+      return;
+    }
+
+    std::vector<std::unique_ptr<BeamSearchState<T>>> slots;
+    slots.reserve(n_slots);
+    while (slots.size() < n_slots) {
+      ThreadData<T> data = this->thread_data.pop();
+      if (data.scratch.sector_scratch == nullptr) {
+        // take what is free, but never less than one query in flight
+        if (!slots.empty()) {
+          break;
+        }
+        this->thread_data.wait_for_push_notify();
+        continue;
+      }
+      slots.emplace_back(std::make_unique<BeamSearchState<T>>());
+      slots.back()->data = data;
+    }
+
+    // The slots are split into two groups, each reading through its own
+    // context, so that one group's neighbors are expanded while the sectors
+    // of the other one are being read.
+    struct Group {
+      IOContext                        ctx;
+      std::vector<BeamSearchState<T> *> states;
+      std::vector<AlignedRead>         reqs;
+      _u64                             n_inflight = 0;
+    };
+    Group groups[2];
+    {
+      // contexts are taken in pairs under a lock so that two batches can not
+      // each hold one and wait for the other's
+      static std::mutex           ctx_pair_mtx;
+      std::lock_guard<std::mutex> lock(ctx_pair_mtx);
+      groups[0].ctx = this->reader->get_ctx();
+      groups[1].ctx = this->reader->get_ctx();
+    }
+    for (size_t i = 0; i < slots.size(); i++) {
+      groups[i % 2].states.push_back(slots[i].get());
+    }
+
+    const knowhere::feder::diskann::FederResultUniq no_feder = nullptr;
+    _u64                                            next_query = 0;
+    // binds the next query to `s`, false once all of them are handed out
+    auto assign = [&](BeamSearchState<T> &s) -> bool {
+      while (next_query < nq) {
+        const _u64 q = next_query++;
+        auto       query_norm_opt =
+            init_thread_data(s.data, queries + q * query_stride);
+        if (!query_norm_opt.has_value()) {
+          // an empty answer for a zero query, as in cached_beam_search
+          continue;
+        }
+        s.query_norm = query_norm_opt.value();
+        s.k_search = k_search;
+        s.l_search = l_search;
+        s.beam_width = beam_width;
+        s.indices = indices + q * k_search;
+        s.distances = distances == nullptr ? nullptr : distances + q * k_search;
+        s.stats = stats == nullptr ? nullptr : stats + q;
+        s.feder = &no_feder;
+        s.bitset_view = bitset_view;
+        s.full_retset.clear();
+        s.accumulative_alpha = 0;
+        beam_search_start(s);
+        return true;
+      }
+      return false;
+    };
+
+    // retires converged queries, refills their slots and submits the next
+    // beam of every query in the group at once
+    auto issue = [&](Group &g) {
+      g.reqs.clear();
+      for (auto &s : g.states) {
+        if (s == nullptr) {
+          continue;
+        }
+        while (!beam_search_next(*s)) {
+          beam_search_finish(*s, g.ctx, false);
+          if (!assign(*s)) {
+            s = nullptr;
+            break;
+          }
+        }
+        if (s != nullptr) {
+          g.reqs.insert(g.reqs.end(), s->frontier_read_reqs.begin(),
+                        s->frontier_read_reqs.end());
+        }
+      }
+      if (!g.reqs.empty()) {
+        this->reader->submit_req(g.ctx, g.reqs);
+      }
+      g.n_inflight = g.reqs.size();
+    };
+
+    auto complete = [&](Group &g) {
+      if (g.n_inflight > 0) {
+        this->reader->get_submitted_req(g.ctx, g.n_inflight);
+        g.n_inflight = 0;
+      }
+      for (auto s : g.states) {
+        if (s != nullptr) {
+          beam_search_expand(*s);
+        }
+      }
+    };
+
+    auto active = [](const Group &g) {
+      return std::any_of(g.states.begin(), g.states.end(),
+                         [](const BeamSearchState<T> *s) { return s != nullptr; });
+    };
+
+    auto release = [&]() {
+      for (auto &g : groups) {
+        this->reader->put_ctx(g.ctx);
+      }
+      for (auto &s : slots) {
+        this->thread_data.push(s->data);
+      }
+      this->thread_data.push_notify_all();
+    };
+
+    try {
+      for (auto &g : groups) {
+        for (auto &s : g.states) {
+          if (!assign(*s)) {
+            s = nullptr;
+          }
+        }
+        issue(g);
+      }
+      while (active(groups[0]) || active(groups[1])) {
+        for (auto &g : groups) {
+          complete(g);
+          issue(g);
+        }
+      }
+    } catch (...) {
+      // nothing may still be writing into the scratch when it is handed back
+      for (auto &g : groups) {
+        if (g.n_inflight > 0) {
+          try {
+            this->reader->get_submitted_req(g.ctx, g.n_inflight);
+          } catch (...) {
+          }
+        }
+      }
+      release();
+      throw;
+    }
+    release();
+  }
+
   template<typename T>
   void PQFlashIndex<T>::calc_dist_by_ids(const T *query_, const int64_t *ids,
                                          const int64_t n,
@@ -2038,6 +2354,9 @@ namespace diskann {
     index_mem_size += coord_cache.size() * sizeof(std::pair<_u32, T *>);
     index_mem_size +=
         nhood_cache.size() * sizeof(std::pair<_u32, std::pair<_u32, _u32 *>>);
+    if (adaptive_cache != nullptr) {
+      index_mem_size += adaptive_cache->mem_size();
+    }
     // get entry points:
     index_mem_size += ROUND_UP(num_medoids * aligned_dim * sizeof(float), 32);
     index_mem_size += num_medoids * aligned_dim * sizeof(uint32_t);
@@ -0,0 +1,363 @@
+#include "diskann/uring_aligned_file_reader.h"
+#include <liburing.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <sstream>
+#include <vector>
+#include "diskann/linux_aligned_file_reader.h"
+#include "diskann/utils.h"
+
+namespace {
+  static constexpr uint64_t n_retries = 10;
+  // how long an idle SQPOLL thread spins before it goes to sleep
+  static constexpr uint32_t sq_thread_idle_ms = 1000;
+  // UIO_MAXIOV, the registration limit on older kernels
+  static constexpr size_t max_fixed_bufs = 1024;
+
+  void throw_uring_error(const char *op, int err, const char *func,
+                         const char *file, int line) {
+    std::stringstream ss;
+    ss << "Unknown error occur in " << op << ", errno: " << err << ", "
+       << strerror(err);
+    throw diskann::ANNException(ss.str(), -1, func, file, line);
+  }
+
+  bool probe_uring(bool sqpoll) {
+    struct io_uring        ring;
+    struct io_uring_params p;
+    memset(&p, 0, sizeof(p));
+    if (sqpoll) {
+      p.flags |= IORING_SETUP_SQPOLL;
+      p.sq_thread_idle = sq_thread_idle_ms;
+    }
+    if (io_uring_queue_init_params(4, &ring, &p) < 0) {
+      return false;
+    }
+    bool                    ok = false;
+    struct io_uring_probe  *probe = io_uring_get_probe_ring(&ring);
+    if (probe != nullptr) {
+      ok = io_uring_opcode_supported(probe, IORING_OP_READ) &&
+           io_uring_opcode_supported(probe, IORING_OP_READ_FIXED);
+      io_uring_free_probe(probe);
+    }
+    io_uring_queue_exit(&ring);
+    return ok;
+  }
+}  // namespace
+
+struct UringAlignedFileReader::Ring {
+  struct io_uring ring;
+  bool            fixed_file = false;
+  // buffers registered with this ring, sorted by address
+  std::shared_ptr<const std::vector<iovec>> fixed_bufs;
+  // requests of the batch in flight, indexed by cqe user_data
+  std::vector<AlignedRead> pending;
+
+  int fixed_buf_index(const AlignedRead &req) const {
+    if (fixed_bufs == nullptr) {
+      return -1;
+    }
+    auto it = std::upper_bound(
+        fixed_bufs->begin(), fixed_bufs->end(), req.buf,
+        [](const void *p, const iovec &v) { return p < v.iov_base; });
+    if (it == fixed_bufs->begin()) {
+      return -1;
+    }
+    --it;
+    auto base = (const char *) it->iov_base;
+    auto buf = (const char *) req.buf;
+    if (buf + req.len > base + it->iov_len) {
+      return -1;
+    }
+    return (int) (it - fixed_bufs->begin());
+  }
+
+  void prep(FileHandle fd, uint64_t idx) {
+    struct io_uring_sqe *sqe = io_uring_get_sqe(&ring);
+    if (sqe == nullptr) {
+      throw diskann::ANNException("io_uring submission queue is full", -1,
+                                  __FUNCSIG__, __FILE__, __LINE__);
+    }
+    const AlignedRead &req = pending[idx];
+    const int          file = fixed_file ? 0 : fd;
+    const int          buf_idx = fixed_buf_index(req);
+    if (buf_idx >= 0) {
+      io_uring_prep_read_fixed(sqe, file, req.buf, req.len, req.offset,
+                               buf_idx);
+    } else {
+      io_uring_prep_read(sqe, file, req.buf, req.len, req.offset);
+    }
+    if (fixed_file) {
+      sqe->flags |= IOSQE_FIXED_FILE;
+    }
+    io_uring_sqe_set_data64(sqe, idx);
+  }
+
+  void submit(unsigned wait_nr) {
+    int ret;
+    while ((ret = io_uring_submit_and_wait(&ring, wait_nr)) < 0) {
+      if (ret != -EINTR && ret != -EAGAIN) {
+        throw_uring_error("io_uring_submit", -ret, __FUNCSIG__, __FILE__,
+                          __LINE__);
+      }
+    }
+  }
+
+  // Reaps `n_ops` completions of `pending`, resubmitting interrupted and
+  // short reads. A failed read is only reported once the whole batch has
+  // landed so that nothing is left in flight on the ring.
+  void wait(FileHandle fd, size_t n_ops) {
+    size_t   num_read = 0;
+    uint64_t read_retry = 0;
+    int      read_err = 0;
+    while (num_read < n_ops) {
+      struct io_uring_cqe *cqe;
+      int                  ret = io_uring_wait_cqe(&ring, &cqe);
+      if (ret < 0) {
+        if (ret == -EINTR || ret == -EAGAIN) {
+          continue;
+        }
+        throw_uring_error("io_uring_wait_cqe", -ret, __FUNCSIG__, __FILE__,
+                          __LINE__);
+      }
+      unsigned head, seen = 0, resubmitted = 0;
+      io_uring_for_each_cqe(&ring, head, cqe) {
+        seen++;
+        const uint64_t idx = io_uring_cqe_get_data64(cqe);
+        const int      res = cqe->res;
+        AlignedRead   &req = pending[idx];
+        if (res == (int) req.len || res == 0) {
+          // res == 0 is EOF, which libaio leaves unreported as well
+          num_read++;
+          continue;
+        }
+        if (res > 0 || res == -EINTR || res == -EAGAIN) {
+          if (++read_retry > n_retries) {
+            LOG(WARNING) << "io_uring read failed after retried " << n_retries
+                         << " times";
+            read_err = res > 0 ? EIO : -res;
+            num_read++;
+            continue;
+          }
+          if (res > 0) {
+            req.offset += res;
+            req.len -= res;
+            req.buf = (char *) req.buf + res;
+          }
+          prep(fd, idx);
+          resubmitted++;
+          continue;
+        }
+        read_err = -res;
+        num_read++;
+      }
+      io_uring_cq_advance(&ring, seen);
+      if (resubmitted > 0) {
+        submit(0);
+      }
+    }
+    if (read_err != 0) {
+      throw_uring_error("io_uring read", read_err, __FUNCSIG__, __FILE__,
+                        __LINE__);
+    }
+  }
+};
+
+UringAlignedFileReader::UringAlignedFileReader(bool sqpoll) {
+  this->file_desc = -1;
+  this->sqpoll_ = sqpoll;
+  this->ctx_pool_ = AioContextPool::GetGlobalAioPool();
+}
+
+UringAlignedFileReader::~UringAlignedFileReader() {
+  if (this->file_desc != -1) {
+    this->close();
+  }
+}
+
+bool UringAlignedFileReader::is_supported(bool sqpoll) {
+  static const bool plain = probe_uring(false);
+  if (!sqpoll) {
+    return plain;
+  }
+  static const bool polled = plain && probe_uring(true);
+  return polled;
+}
+
+void UringAlignedFileReader::open(const std::string &fname) {
+  int flags = O_DIRECT | O_RDONLY | O_LARGEFILE;
+  this->file_desc = ::open(fname.c_str(), flags);
+  // error checks
+  assert(this->file_desc != -1);
+  LOG_KNOWHERE_DEBUG_ << "Opened file : " << fname << " with io_uring"
+                      << (sqpoll_ ? " (sqpoll)" : "");
+}
+
+void UringAlignedFileReader::close() {
+  {
+    std::scoped_lock lk(rings_mut_);
+    for (auto &kv : rings_) {
+      io_uring_queue_exit(&kv.second->ring);
+      delete kv.second;
+    }
+    rings_.clear();
+    sq_owner_fd_ = -1;
+    fixed_bufs_.reset();
+  }
+  ::close(this->file_desc);
+  this->file_desc = -1;
+}
+
+void UringAlignedFileReader::register_buffers(const std::vector<iovec> &bufs) {
+  if (bufs.empty() || bufs.size() > max_fixed_bufs) {
+    return;
+  }
+  auto sorted = std::make_shared<std::vector<iovec>>(bufs);
+  std::sort(sorted->begin(), sorted->end(),
+            [](const iovec &a, const iovec &b) {
+              return a.iov_base < b.iov_base;
+            });
+  std::scoped_lock lk(rings_mut_);
+  // rings created from now on pick these up, existing ones keep unregistered
+  // reads
+  fixed_bufs_ = std::move(sorted);
+}
+
+UringAlignedFileReader::Ring *UringAlignedFileReader::get_ring(
+    io_context_t ctx) {
+  std::scoped_lock lk(rings_mut_);
+  auto             it = rings_.find(ctx);
+  if (it != rings_.end()) {
+    return it->second;
+  }
+
+  auto                   r = std::make_unique<Ring>();
+  struct io_uring_params p;
+  memset(&p, 0, sizeof(p));
+  if (sqpoll_) {
+    p.flags |= IORING_SETUP_SQPOLL;
+    p.sq_thread_idle = sq_thread_idle_ms;
+    if (sq_owner_fd_ >= 0) {
+      p.flags |= IORING_SETUP_ATTACH_WQ;
+      p.wq_fd = sq_owner_fd_;
+    }
+  }
+  int ret = io_uring_queue_init_params(ctx_pool_->max_events_per_ctx(),
+                                       &r->ring, &p);
+  if (ret < 0) {
+    throw_uring_error("io_uring_queue_init", -ret, __FUNCSIG__, __FILE__,
+                      __LINE__);
+  }
+  if (sqpoll_ && sq_owner_fd_ < 0) {
+    sq_owner_fd_ = r->ring.ring_fd;
+  }
+
+  r->fixed_file = io_uring_register_files(&r->ring, &file_desc, 1) == 0;
+  if (fixed_bufs_ != nullptr) {
+    ret = io_uring_register_buffers(&r->ring, fixed_bufs_->data(),
+                                    fixed_bufs_->size());
+    if (ret == 0) {
+      r->fixed_bufs = fixed_bufs_;
+    } else {
+      // mostly RLIMIT_MEMLOCK, plain reads work the same only slower
+      LOG(WARNING) << "io_uring_register_buffers() failed, errno: " << -ret
+                   << ", " << strerror(-ret)
+                   << "; falling back to unregistered buffers";
+    }
+  }
+
+  auto ring = r.release();
+  rings_[ctx] = ring;
+  return ring;
+}
+
+void UringAlignedFileReader::read(std::vector<AlignedRead> &read_reqs,
+                                  io_context_t &ctx, bool async) {
+  if (async == true) {
+    diskann::cout << "Async currently not supported in linux." << std::endl;
+  }
+  assert(this->file_desc != -1);
+
+  Ring      *r = get_ring(ctx);
+  const auto maxnr = ctx_pool_->max_events_per_ctx();
+  for (size_t start = 0; start < read_reqs.size(); start += maxnr) {
+    const size_t n_ops = std::min(read_reqs.size() - start, maxnr);
+    r->pending.assign(read_reqs.begin() + start,
+                      read_reqs.begin() + start + n_ops);
+    for (size_t i = 0; i < n_ops; i++) {
+      r->prep(file_desc, i);
+    }
+    r->submit(n_ops);
+    r->wait(file_desc, n_ops);
+  }
+}
+
+void UringAlignedFileReader::submit_req(io_context_t             &ctx,
+                                        std::vector<AlignedRead> &read_reqs) {
+  const auto maxnr = this->ctx_pool_->max_events_per_ctx();
+  if (read_reqs.size() > maxnr) {
+    std::stringstream err;
+    err << "Async does not support number of read requests ("
+        << read_reqs.size() << ") exceeds max number of events per context ("
+        << maxnr << ")";
+    throw diskann::ANNException(err.str(), -1, __FUNCSIG__, __FILE__, __LINE__);
+  }
+  Ring *r = get_ring(ctx);
+  r->pending = read_reqs;
+  for (size_t i = 0; i < read_reqs.size(); i++) {
+    r->prep(file_desc, i);
+  }
+  r->submit(0);
+}
+
+void UringAlignedFileReader::get_submitted_req(io_context_t &ctx,
+                                               size_t        n_ops) {
+  Ring *r = get_ring(ctx);
+  if (n_ops > r->pending.size()) {
+    std::stringstream err;
+    err << "Async does not support getting number of read requests (" << n_ops
+        << ") exceeds number of submitted requests (" << r->pending.size()
+        << ")";
+    throw diskann::ANNException(err.str(), -1, __FUNCSIG__, __FILE__, __LINE__);
+  }
+  r->wait(file_desc, n_ops);
+}
+
+namespace diskann {
+  namespace {
+    std::mutex io_engine_mut;
+    IOEngine   io_engine = IOEngine::AIO;
+    bool       io_engine_sqpoll = false;
+  }  // namespace
+
+  bool set_global_io_engine(IOEngine engine, bool sqpoll) {
+    bool ok = true;
+    if (engine == IOEngine::URING &&
+        !UringAlignedFileReader::is_supported(sqpoll)) {
+      LOG(WARNING) << "io_uring" << (sqpoll ? " with sqpoll" : "")
+                   << " is not available, falling back to libaio";
+      engine = IOEngine::AIO;
+      ok = false;
+    }
+    std::scoped_lock lk(io_engine_mut);
+    io_engine = engine;
+    io_engine_sqpoll = engine == IOEngine::URING && sqpoll;
+    return ok;
+  }
+
+  std::shared_ptr<AlignedFileReader> create_aligned_file_reader() {
+    IOEngine engine;
+    bool     sqpoll;
+    {
+      std::scoped_lock lk(io_engine_mut);
+      engine = io_engine;
+      sqpoll = io_engine_sqpoll;
+    }
+    if (engine == IOEngine::URING) {
+      return std::make_shared<UringAlignedFileReader>(sqpoll);
+    }
+    return std::make_shared<LinuxAlignedFileReader>();
+  }
+}  // namespace diskann
@@ -39,10 +39,12 @@ struct FlatCosineDis : FlatCodesDistanceComputer {
     const float* inverse_l2_norms;
     float inverse_query_norm = 0;
 
+    DistanceKernels<float> kernels;
+
     float distance_to_code(const uint8_t* code) final {
         ndis++;
         const float norm = fvec_norm_L2sqr((const float*)code, d);
-        return (norm == 0) ? 0 : (fvec_inner_product(q, (const float*)code, d) / sqrtf(norm) * inverse_query_norm);
+        return (norm == 0) ? 0 : (kernels.inner_product(q, (const float*)code, d) / sqrtf(norm) * inverse_query_norm);
     }
 
     float operator()(const idx_t i) final override {
@@ -51,7 +53,7 @@ struct FlatCosineDis : FlatCodesDistanceComputer {
 
         prefetch_L2(inverse_l2_norms + i);
 
-        const float dp0 = fvec_inner_product(q, y_i, d);
+        const float dp0 = kernels.inner_product(q, y_i, d);
 
         const float inverse_code_norm_i = inverse_l2_norms[i];
         const float distance = dp0 * inverse_code_norm_i * inverse_query_norm;
@@ -67,7 +69,7 @@ struct FlatCosineDis : FlatCodesDistanceComputer {
         prefetch_L2(inverse_l2_norms + i);
         prefetch_L2(inverse_l2_norms + j);
 
-        const float dp0 = fvec_inner_product(y_i, y_j, d);
+        const float dp0 = kernels.inner_product(y_i, y_j, d);
 
         const float inverse_code_norm_i = inverse_l2_norms[i];
         const float inverse_code_norm_j = inverse_l2_norms[j];
@@ -83,7 +85,8 @@ struct FlatCosineDis : FlatCodesDistanceComputer {
               nb(storage.ntotal),
               q(q),
               b(storage.get_xb()),
-              ndis(0) {
+              ndis(0),
+              kernels(get_distance_kernels<float>(storage.d)) {
         // it is the caller's responsibility to ensure that everything is all right.
         inverse_l2_norms = storage.get_inverse_l2_norms();
 
@@ -137,7 +140,7 @@ struct FlatCosineDis : FlatCodesDistanceComputer {
         float dp1 = 0;
         float dp2 = 0;
         float dp3 = 0;
-        fvec_inner_product_batch_4(q, y0, y1, y2, y3, d, dp0, dp1, dp2, dp3);
+        kernels.inner_product_batch_4(q, y0, y1, y2, y3, d, dp0, dp1, dp2, dp3);
         
         const float inverse_code_norm0 = inverse_l2_norms[idx0];
         const float inverse_code_norm1 = inverse_l2_norms[idx1];
@@ -218,6 +221,11 @@ float WithCosineNormDistanceComputer::symmetric_dis(idx_t i, idx_t j) {
     return v;
 }
 
+void WithCosineNormDistanceComputer::prefetch(idx_t i) {
+    basedis->prefetch(i);
+    prefetch_L2(inverse_l2_norms + i);
+}
+
 
 //////////////////////////////////////////////////////////////////////////////////
 
@@ -261,6 +269,14 @@ std::vector<float> L2NormsStorage::as_l2_norms() const {
     return result;
 }
 
+void L2NormsStorage::permute(const idx_t* perm) {
+    std::vector<float> new_inverse_l2_norms(inverse_l2_norms.size());
+    for (size_t i = 0; i < inverse_l2_norms.size(); i++) {
+        new_inverse_l2_norms[i] = inverse_l2_norms[perm[i]];
+    }
+    std::swap(inverse_l2_norms, new_inverse_l2_norms);
+}
+
 
 //////////////////////////////////////////////////////////////////////////////////
 
@@ -293,6 +309,11 @@ void IndexFlatCosine::reset() {
     inverse_norms_storage.reset();
 }
 
+void IndexFlatCosine::permute_entries(const idx_t* perm) {
+    IndexFlat::permute_entries(perm);
+    inverse_norms_storage.permute(perm);
+}
+
 const float* IndexFlatCosine::get_inverse_l2_norms() const {
     return inverse_norms_storage.inverse_l2_norms.data();
 }
@@ -336,6 +357,11 @@ void IndexScalarQuantizerCosine::reset() {
     inverse_norms_storage.reset();
 }
 
+void IndexScalarQuantizerCosine::permute_entries(const idx_t* perm) {
+    IndexScalarQuantizer::permute_entries(perm);
+    inverse_norms_storage.permute(perm);
+}
+
 const float* IndexScalarQuantizerCosine::get_inverse_l2_norms() const {
     return inverse_norms_storage.inverse_l2_norms.data();
 }
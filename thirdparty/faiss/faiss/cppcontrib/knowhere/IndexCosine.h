@@ -64,6 +64,9 @@ struct WithCosineNormDistanceComputer : DistanceComputer {
 
     /// compute distance between two stored vectors
     float symmetric_dis(idx_t i, idx_t j) override;
+
+    /// prefetch both the base data and the inverse norm of vector i
+    void prefetch(idx_t i) override;
 };
 
 struct HasInverseL2Norms {
@@ -90,6 +93,9 @@ struct L2NormsStorage {
 
     // produces a vector of L2 norms, effectively inverting inverse_l2_norms
     std::vector<float> as_l2_norms() const;
+
+    // reorders the norms, perm maps new to old positions
+    void permute(const idx_t* perm);
 };
 
 // A dedicated index used for Cosine Distance in the future.
@@ -101,6 +107,7 @@ struct IndexFlatCosine : IndexFlat, HasInverseL2Norms {
 
     void add(idx_t n, const float* x) override;
     void reset() override;
+    void permute_entries(const idx_t* perm) override;
 
     FlatCodesDistanceComputer* get_FlatCodesDistanceComputer() const override;
 
@@ -119,6 +126,7 @@ struct IndexScalarQuantizerCosine : IndexScalarQuantizer, HasInverseL2Norms {
 
     void add(idx_t n, const float* x) override;
     void reset() override;
+    void permute_entries(const idx_t* perm) override;
 
     DistanceComputer* get_distance_computer() const override;
 
@@ -149,14 +149,16 @@ struct FlatL2Dis : FlatCodesDistanceComputer {
     const float* q;
     const float* b;
     size_t ndis;
+    // picked once for d, see get_distance_kernels()
+    DistanceKernels<float> kernels;
 
     float distance_to_code(const uint8_t* code) final {
         ndis++;
-        return fvec_L2sqr(q, (float*)code, d);
+        return kernels.L2sqr(q, (float*)code, d);
     }
 
     float symmetric_dis(idx_t i, idx_t j) override {
-        return fvec_L2sqr(b + j * d, b + i * d, d);
+        return kernels.L2sqr(b + j * d, b + i * d, d);
     }
 
     explicit FlatL2Dis(const IndexFlat& storage, const float* q = nullptr)
@@ -167,7 +169,8 @@ struct FlatL2Dis : FlatCodesDistanceComputer {
               nb(storage.ntotal),
               q(q),
               b(storage.get_xb()),
-              ndis(0) {}
+              ndis(0),
+              kernels(get_distance_kernels<float>(storage.d)) {}
 
     void set_query(const float* x) override {
         q = x;
@@ -199,7 +202,7 @@ struct FlatL2Dis : FlatCodesDistanceComputer {
         float dp1 = 0;
         float dp2 = 0;
         float dp3 = 0;
-        fvec_L2sqr_batch_4(q, y0, y1, y2, y3, d, dp0, dp1, dp2, dp3);
+        kernels.L2sqr_batch_4(q, y0, y1, y2, y3, d, dp0, dp1, dp2, dp3);
         dis0 = dp0;
         dis1 = dp1;
         dis2 = dp2;
@@ -213,14 +216,15 @@ struct FlatIPDis : FlatCodesDistanceComputer {
     const float* q;
     const float* b;
     size_t ndis;
+    DistanceKernels<float> kernels;
 
     float symmetric_dis(idx_t i, idx_t j) final override {
-        return fvec_inner_product(b + j * d, b + i * d, d);
+        return kernels.inner_product(b + j * d, b + i * d, d);
     }
 
     float distance_to_code(const uint8_t* code) final override {
         ndis++;
-        return fvec_inner_product(q, (const float*)code, d);
+        return kernels.inner_product(q, (const float*)code, d);
     }
 
     explicit FlatIPDis(const IndexFlat& storage, const float* q = nullptr)
@@ -231,7 +235,8 @@ struct FlatIPDis : FlatCodesDistanceComputer {
               nb(storage.ntotal),
               q(q),
               b(storage.get_xb()),
-              ndis(0) {}
+              ndis(0),
+              kernels(get_distance_kernels<float>(storage.d)) {}
 
     void set_query(const float* x) override {
         q = x;
@@ -263,7 +268,7 @@ struct FlatIPDis : FlatCodesDistanceComputer {
         float dp1 = 0;
         float dp2 = 0;
         float dp3 = 0;
-        fvec_inner_product_batch_4(q, y0, y1, y2, y3, d, dp0, dp1, dp2, dp3);
+        kernels.inner_product_batch_4(q, y0, y1, y2, y3, d, dp0, dp1, dp2, dp3);
         dis0 = dp0;
         dis1 = dp1;
         dis2 = dp2;
@@ -311,13 +316,14 @@ struct FlatL2WithNormsDis : FlatCodesDistanceComputer {
     const float* q;
     const float* b;
     size_t ndis;
+    DistanceKernels<float> kernels;
 
     const float* l2norms;
     float query_l2norm;
 
     float distance_to_code(const uint8_t* code) final override {
         ndis++;
-        return fvec_L2sqr(q, (float*)code, d);
+        return kernels.L2sqr(q, (float*)code, d);
     }
 
     float operator()(const idx_t i) final override {
@@ -325,7 +331,7 @@ struct FlatL2WithNormsDis : FlatCodesDistanceComputer {
                 reinterpret_cast<const float*>(codes + i * code_size);
 
         prefetch_L2(l2norms + i);
-        const float dp0 = fvec_inner_product(q, y, d);
+        const float dp0 = kernels.inner_product(q, y, d);
         return query_l2norm + l2norms[i] - 2 * dp0;
     }
 
@@ -337,7 +343,7 @@ struct FlatL2WithNormsDis : FlatCodesDistanceComputer {
 
         prefetch_L2(l2norms + i);
         prefetch_L2(l2norms + j);
-        const float dp0 = fvec_inner_product(yi, yj, d);
+        const float dp0 = kernels.inner_product(yi, yj, d);
         return l2norms[i] + l2norms[j] - 2 * dp0;
     }
 
@@ -352,6 +358,7 @@ struct FlatL2WithNormsDis : FlatCodesDistanceComputer {
               q(q),
               b(storage.get_xb()),
               ndis(0),
+              kernels(get_distance_kernels<float>(storage.d)),
               l2norms(storage.cached_l2norms.data()),
               query_l2norm(0) {}
 
@@ -391,7 +398,7 @@ struct FlatL2WithNormsDis : FlatCodesDistanceComputer {
         float dp1 = 0;
         float dp2 = 0;
         float dp3 = 0;
-        fvec_inner_product_batch_4(q, y0, y1, y2, y3, d, dp0, dp1, dp2, dp3);
+        kernels.inner_product_batch_4(q, y0, y1, y2, y3, d, dp0, dp1, dp2, dp3);
         dis0 = query_l2norm + l2norms[idx0] - 2 * dp0;
         dis1 = query_l2norm + l2norms[idx1] - 2 * dp1;
         dis2 = query_l2norm + l2norms[idx2] - 2 * dp2;
@@ -415,6 +422,17 @@ void IndexFlatL2::clear_l2norms() {
     cached_l2norms.shrink_to_fit();
 }
 
+void IndexFlatL2::permute_entries(const idx_t* perm) {
+    IndexFlat::permute_entries(perm);
+    if (!cached_l2norms.empty()) {
+        std::vector<float> new_l2norms(ntotal);
+        for (idx_t i = 0; i < ntotal; i++) {
+            new_l2norms[i] = cached_l2norms[perm[i]];
+        }
+        std::swap(cached_l2norms, new_l2norms);
+    }
+}
+
 FlatCodesDistanceComputer* IndexFlatL2::get_FlatCodesDistanceComputer() const {
     if (metric_type == METRIC_L2) {
         if (!cached_l2norms.empty()) {
@@ -116,6 +116,9 @@ struct IndexFlatL2 : IndexFlat {
     void sync_l2norms();
     // clear L2 norms
     void clear_l2norms();
+
+    // keeps the L2 norms cache in line with the codes
+    void permute_entries(const idx_t* perm) override;
 };
 
 /// optimized version for 1D "vectors".
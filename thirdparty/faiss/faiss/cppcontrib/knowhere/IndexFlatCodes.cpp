@@ -115,6 +115,14 @@ void IndexFlatCodes::permute_entries(const idx_t* perm) {
                code_size);
     }
     std::swap(codes, new_codes);
+
+    if (code_norms.size() == (size_t)ntotal) {
+        std::vector<float> new_code_norms(ntotal);
+        for (idx_t i = 0; i < ntotal; i++) {
+            new_code_norms[i] = code_norms[perm[i]];
+        }
+        std::swap(code_norms, new_code_norms);
+    }
 }
 
 }
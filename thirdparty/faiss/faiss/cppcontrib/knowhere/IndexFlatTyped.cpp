@@ -0,0 +1,206 @@
+// Copyright (C) 2019-2024 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License.
+
+#include <faiss/cppcontrib/knowhere/IndexFlatTyped.h>
+
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+
+#include <faiss/impl/AuxIndexStructures.h>
+#include <faiss/impl/FaissAssert.h>
+#include <faiss/cppcontrib/knowhere/utils/distances_typed.h>
+
+#include "knowhere/operands.h"
+#include "simd/hook.h"
+
+namespace faiss::cppcontrib::knowhere {
+
+namespace {
+
+template <typename DataType>
+float typed_norm_L2sqr(const DataType* x, size_t d) {
+    if constexpr (std::is_same_v<DataType, ::knowhere::fp16>) {
+        return fp16_vec_norm_L2sqr(x, d);
+    } else if constexpr (std::is_same_v<DataType, ::knowhere::bf16>) {
+        return bf16_vec_norm_L2sqr(x, d);
+    } else {
+        static_assert(std::is_same_v<DataType, ::knowhere::int8>);
+        return int8_vec_norm_L2sqr(x, d);
+    }
+}
+
+template <typename DataType>
+std::unique_ptr<DataType[]> convert_from_float(
+        idx_t n,
+        idx_t d,
+        const float* x) {
+    auto converted = std::make_unique<DataType[]>(n * d);
+    for (idx_t i = 0; i < n * d; i++) {
+        converted[i] = DataType(x[i]);
+    }
+    return converted;
+}
+
+} // namespace
+
+template <typename DataType>
+IndexFlatTyped<DataType>::IndexFlatTyped(
+        idx_t d,
+        MetricType metric,
+        bool is_cosine)
+        : IndexFlatCodes(sizeof(DataType) * d, d, metric) {
+    this->is_cosine = is_cosine;
+}
+
+template <typename DataType>
+void IndexFlatTyped<DataType>::add(idx_t n, const float* x) {
+    auto converted = convert_from_float<DataType>(n, d, x);
+    add(n, converted.get());
+}
+
+template <typename DataType>
+void IndexFlatTyped<DataType>::add(idx_t n, const DataType* x) {
+    FAISS_THROW_IF_NOT(is_trained);
+    codes.resize((ntotal + n) * code_size);
+    std::memcpy(&codes[ntotal * code_size], x, n * code_size);
+    if (is_cosine) {
+        // the vectors are kept as is, the typed cosine kernels divide by
+        //   the stored norms instead
+        code_norms.resize(ntotal + n);
+        for (idx_t i = 0; i < n; i++) {
+            code_norms[ntotal + i] = std::sqrt(typed_norm_L2sqr(x + i * d, d));
+        }
+    }
+    ntotal += n;
+}
+
+template <typename DataType>
+void IndexFlatTyped<DataType>::search(
+        idx_t n,
+        const float* x,
+        idx_t k,
+        float* distances,
+        idx_t* labels,
+        const SearchParameters* params) const {
+    auto converted = convert_from_float<DataType>(n, d, x);
+    search(n, converted.get(), k, distances, labels, params);
+}
+
+template <typename DataType>
+void IndexFlatTyped<DataType>::search(
+        idx_t n,
+        const DataType* x,
+        idx_t k,
+        float* distances,
+        idx_t* labels,
+        const SearchParameters* params) const {
+    IDSelector* sel = params ? params->sel : nullptr;
+    FAISS_THROW_IF_NOT(k > 0);
+
+    switch (metric_type) {
+        case METRIC_INNER_PRODUCT:
+            if (is_cosine) {
+                knn_cosine_typed(x, get_xb(), get_norms(), d, n, ntotal, k,
+                                 distances, labels, sel);
+            } else {
+                knn_inner_product_typed(x, get_xb(), d, n, ntotal, k,
+                                        distances, labels, sel);
+            }
+            break;
+        case METRIC_L2:
+            knn_L2sqr_typed(x, get_xb(), d, n, ntotal, k, distances, labels,
+                            nullptr, sel);
+            break;
+        default:
+            FAISS_THROW_MSG("metric type not supported");
+    }
+}
+
+template <typename DataType>
+void IndexFlatTyped<DataType>::range_search(
+        idx_t n,
+        const float* x,
+        float radius,
+        RangeSearchResult* result,
+        const SearchParameters* params) const {
+    auto converted = convert_from_float<DataType>(n, d, x);
+    range_search(n, converted.get(), radius, result, params);
+}
+
+template <typename DataType>
+void IndexFlatTyped<DataType>::range_search(
+        idx_t n,
+        const DataType* x,
+        float radius,
+        RangeSearchResult* result,
+        const SearchParameters* params) const {
+    IDSelector* sel = params ? params->sel : nullptr;
+
+    switch (metric_type) {
+        case METRIC_INNER_PRODUCT:
+            if (is_cosine) {
+                range_search_cosine_typed(x, get_xb(), get_norms(), d, n,
+                                          ntotal, radius, result, sel);
+            } else {
+                range_search_inner_product_typed(x, get_xb(), d, n, ntotal,
+                                                 radius, result, sel);
+            }
+            break;
+        case METRIC_L2:
+            range_search_L2sqr_typed(x, get_xb(), d, n, ntotal, radius,
+                                     result, sel);
+            break;
+        default:
+            FAISS_THROW_MSG("metric type not supported");
+    }
+}
+
+template <typename DataType>
+void IndexFlatTyped<DataType>::reconstruct(idx_t key, float* recons) const {
+    sa_decode(1, codes.data() + key * code_size, recons);
+}
+
+template <typename DataType>
+void IndexFlatTyped<DataType>::reconstruct(idx_t key, DataType* recons)
+        const {
+    FAISS_THROW_IF_NOT(key >= 0 && key < ntotal);
+    std::memcpy(recons, codes.data() + key * code_size, code_size);
+}
+
+template <typename DataType>
+void IndexFlatTyped<DataType>::sa_encode(
+        idx_t n,
+        const float* x,
+        uint8_t* bytes) const {
+    DataType* out = (DataType*)bytes;
+    for (idx_t i = 0; i < n * d; i++) {
+        out[i] = DataType(x[i]);
+    }
+}
+
+template <typename DataType>
+void IndexFlatTyped<DataType>::sa_decode(
+        idx_t n,
+        const uint8_t* bytes,
+        float* x) const {
+    const DataType* in = (const DataType*)bytes;
+    for (idx_t i = 0; i < n * d; i++) {
+        x[i] = float(in[i]);
+    }
+}
+
+template struct IndexFlatTyped<::knowhere::fp16>;
+template struct IndexFlatTyped<::knowhere::bf16>;
+template struct IndexFlatTyped<::knowhere::int8>;
+
+} // namespace faiss::cppcontrib::knowhere
@@ -0,0 +1,91 @@
+// Copyright (C) 2019-2024 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License.
+
+#pragma once
+
+#include <faiss/cppcontrib/knowhere/IndexFlatCodes.h>
+
+#include "knowhere/operands.h"
+
+namespace faiss {
+namespace cppcontrib {
+namespace knowhere {
+
+/** Index that stores the full vectors in their native low precision type
+ * (fp16, bf16 or int8) and performs exhaustive search with the typed
+ * distance kernels, instead of keeping an fp32 copy as IndexFlat does.
+ *
+ * The overloads that accept DataType pointers expect queries of the same
+ * type as the stored vectors. The regular float interface converts the
+ * queries to DataType first.
+ */
+template <typename DataType>
+struct IndexFlatTyped : IndexFlatCodes {
+    explicit IndexFlatTyped(
+            idx_t d, ///< dimensionality of the input vectors
+            MetricType metric = METRIC_L2,
+            bool is_cosine = false);
+
+    IndexFlatTyped() {}
+
+    void add(idx_t n, const float* x) override;
+    void add(idx_t n, const DataType* x);
+
+    void search(
+            idx_t n,
+            const float* x,
+            idx_t k,
+            float* distances,
+            idx_t* labels,
+            const SearchParameters* params = nullptr) const override;
+    void search(
+            idx_t n,
+            const DataType* x,
+            idx_t k,
+            float* distances,
+            idx_t* labels,
+            const SearchParameters* params = nullptr) const;
+
+    void range_search(
+            idx_t n,
+            const float* x,
+            float radius,
+            RangeSearchResult* result,
+            const SearchParameters* params = nullptr) const override;
+    void range_search(
+            idx_t n,
+            const DataType* x,
+            float radius,
+            RangeSearchResult* result,
+            const SearchParameters* params = nullptr) const;
+
+    void reconstruct(idx_t key, float* recons) const override;
+    void reconstruct(idx_t key, DataType* recons) const;
+
+    /* The standalone codec interface (a type conversion in this case) */
+    void sa_encode(idx_t n, const float* x, uint8_t* bytes) const override;
+
+    void sa_decode(idx_t n, const uint8_t* bytes, float* x) const override;
+
+    // get pointer to the stored vectors
+    const DataType* get_xb() const {
+        return (const DataType*)codes.data();
+    }
+
+    // l2 norms of the stored vectors, available for cosine only
+    const float* get_norms() const {
+        return code_norms.data();
+    }
+};
+
+}
+}
+} // namespace faiss
@@ -371,6 +371,7 @@ void IndexHNSW::add(idx_t n, const float* x) {
 void IndexHNSW::reset() {
     hnsw.reset();
     storage->reset();
+    visited_pool.clear();
     ntotal = 0;
 }
 
@@ -15,6 +15,7 @@
 #include <faiss/cppcontrib/knowhere/IndexPQ.h>
 #include <faiss/cppcontrib/knowhere/IndexScalarQuantizer.h>
 #include <faiss/cppcontrib/knowhere/impl/HNSW.h>
+#include <faiss/cppcontrib/knowhere/utils/VisitedTable.h>
 #include <faiss/utils/utils.h>
 
 namespace faiss {
@@ -46,6 +47,10 @@ struct IndexHNSW : Index {
     // used when GpuIndexCagra::copyFrom(IndexHNSWCagra*) is invoked.
     bool keep_max_size_level0 = false;
 
+    // visited tables reused by the searches of knowhere's IndexHNSWWrapper,
+    // freed together with the index
+    mutable VisitedTablePool visited_pool;
+
     explicit IndexHNSW(int d = 0, int M = 32, MetricType metric = METRIC_L2);
     explicit IndexHNSW(faiss::cppcontrib::knowhere::Index* storage, int M = 32);
 
@@ -344,8 +344,52 @@ void IndexIVF::search(
             std::min(nlist, params ? params->nprobe : this->nprobe);
     FAISS_THROW_IF_NOT(nprobe > 0);
 
+    // for a batch of queries against a flat quantizer, compute all the
+    // coarse distances with a single GEMM instead of one query at a time
+    auto coarse_assign_with_blas = [this, params](
+                                           idx_t n,
+                                           const float* x,
+                                           idx_t nprobe,
+                                           float* coarse_dis,
+                                           idx_t* idx) {
+        if (n <= 1 || params == nullptr || !params->list_major_scan ||
+            params->quantizer_params != nullptr) {
+            return false;
+        }
+        const IndexFlat* flat_quantizer =
+                dynamic_cast<const IndexFlat*>(quantizer);
+        if (flat_quantizer == nullptr || flat_quantizer->is_cosine) {
+            return false;
+        }
+
+        if (flat_quantizer->metric_type == METRIC_L2) {
+            knn_L2sqr_blas(
+                    x,
+                    flat_quantizer->get_xb(),
+                    d,
+                    n,
+                    flat_quantizer->ntotal,
+                    nprobe,
+                    coarse_dis,
+                    idx);
+        } else if (flat_quantizer->metric_type == METRIC_INNER_PRODUCT) {
+            knn_inner_product_blas(
+                    x,
+                    flat_quantizer->get_xb(),
+                    d,
+                    n,
+                    flat_quantizer->ntotal,
+                    nprobe,
+                    coarse_dis,
+                    idx);
+        } else {
+            return false;
+        }
+        return true;
+    };
+
     // search function for a subset of queries
-    auto sub_search_func = [this, k, nprobe, params](
+    auto sub_search_func = [this, k, nprobe, params, &coarse_assign_with_blas](
                                    idx_t n,
                                    const float* x,
                                    float* distances,
@@ -355,13 +399,15 @@ void IndexIVF::search(
         std::unique_ptr<float[]> coarse_dis(new float[n * nprobe]);
 
         double t0 = getmillisecs();
-        quantizer->search(
-                n,
-                x,
-                nprobe,
-                coarse_dis.get(),
-                idx.get(),
-                params ? params->quantizer_params : nullptr);
+        if (!coarse_assign_with_blas(n, x, nprobe, coarse_dis.get(), idx.get())) {
+            quantizer->search(
+                    n,
+                    x,
+                    nprobe,
+                    coarse_dis.get(),
+                    idx.get(),
+                    params ? params->quantizer_params : nullptr);
+        }
 
         double t1 = getmillisecs();
         invlists->prefetch_lists(idx.get(), n * nprobe);
@@ -477,6 +523,22 @@ void IndexIVF::search_preassigned(
             max_codes == 0 || pmode == 0 || pmode == 3,
             "max_codes supported only for parallel_mode = 0 or 3");
 
+    if (params && params->list_major_scan && max_codes == 0 && pmode == 0 &&
+        !store_pairs && selr == nullptr && !invlists->use_iterator && n > 1) {
+        search_preassigned_list_major(
+                n,
+                x,
+                k,
+                keys,
+                coarse_dis,
+                distances,
+                labels,
+                sel,
+                params,
+                ivf_stats);
+        return;
+    }
+
     if (max_codes == 0) {
         max_codes = unlimited_list_size;
     }
@@ -755,6 +817,152 @@ void IndexIVF::search_preassigned(
     }
 }
 
+void IndexIVF::search_preassigned_list_major(
+        idx_t n,
+        const float* x,
+        idx_t k,
+        const idx_t* keys,
+        const float* coarse_dis,
+        float* distances,
+        idx_t* labels,
+        const IDSelector* sel,
+        const IVFSearchParameters* params,
+        IndexIVFStats* ivf_stats) const {
+    idx_t nprobe = params ? params->nprobe : this->nprobe;
+    nprobe = std::min((idx_t)nlist, nprobe);
+
+    using HeapForIP = CMin<float, idx_t>;
+    using HeapForL2 = CMax<float, idx_t>;
+
+    const bool do_heap_init = !(this->parallel_mode & PARALLEL_MODE_NO_HEAP_INIT);
+    void* inverted_list_context =
+            params ? params->inverted_list_context : nullptr;
+
+    // bucket the (query, probe) pairs by inverted list with a counting sort,
+    // the pairs of a list keep the order of the queries
+    std::vector<idx_t> list_lims(nlist + 1, 0);
+    for (idx_t ij = 0; ij < n * nprobe; ij++) {
+        const idx_t key = keys[ij];
+        if (key < 0) {
+            // not enough centroids for multiprobe
+            continue;
+        }
+        FAISS_THROW_IF_NOT_FMT(
+                key < (idx_t)nlist,
+                "Invalid key=%" PRId64 " nlist=%zd\n",
+                key,
+                nlist);
+        list_lims[key + 1]++;
+    }
+    for (size_t list_no = 0; list_no < nlist; list_no++) {
+        list_lims[list_no + 1] += list_lims[list_no];
+    }
+
+    std::vector<idx_t> list_pairs(list_lims[nlist]);
+    {
+        std::vector<idx_t> list_ofs(list_lims.begin(), list_lims.end() - 1);
+        for (idx_t ij = 0; ij < n * nprobe; ij++) {
+            if (keys[ij] >= 0) {
+                list_pairs[list_ofs[keys[ij]]++] = ij;
+            }
+        }
+    }
+
+    // one scanner per query, so that the query-dependent state (such as
+    // distance tables) is computed only once
+    std::vector<std::unique_ptr<InvertedListScanner>> scanners(n);
+    for (idx_t i = 0; i < n; i++) {
+        scanners[i].reset(get_InvertedListScanner(false, sel, params));
+        scanners[i]->set_query(x + i * d);
+
+        if (do_heap_init) {
+            if (metric_type == METRIC_INNER_PRODUCT) {
+                heap_heapify<HeapForIP>(k, distances + i * k, labels + i * k);
+            } else {
+                heap_heapify<HeapForL2>(k, distances + i * k, labels + i * k);
+            }
+        }
+    }
+
+    size_t nlistv = 0, ndis = 0, nheap = 0;
+
+    for (size_t list_no = 0; list_no < nlist; list_no++) {
+        const idx_t pair_begin = list_lims[list_no];
+        const idx_t pair_end = list_lims[list_no + 1];
+        if (pair_begin == pair_end ||
+            invlists->is_empty(list_no, inverted_list_context)) {
+            continue;
+        }
+
+        // pin all the segments of the list once for all its queries
+        const size_t segment_num = invlists->get_segment_num(list_no);
+        std::vector<size_t> segment_sizes(segment_num);
+        std::vector<std::unique_ptr<InvertedLists::ScopedCodes>> scodes(
+                segment_num);
+        std::vector<std::unique_ptr<InvertedLists::ScopedIds>> sids(
+                segment_num);
+        std::vector<std::unique_ptr<InvertedLists::ScopedCodeNorms>>
+                scode_norms(segment_num);
+        for (size_t segment_idx = 0; segment_idx < segment_num;
+             segment_idx++) {
+            const size_t segment_offset =
+                    invlists->get_segment_offset(list_no, segment_idx);
+            segment_sizes[segment_idx] =
+                    invlists->get_segment_size(list_no, segment_idx);
+            scodes[segment_idx] = std::make_unique<InvertedLists::ScopedCodes>(
+                    invlists, list_no, segment_offset);
+            sids[segment_idx] = std::make_unique<InvertedLists::ScopedIds>(
+                    invlists, list_no, segment_offset);
+            scode_norms[segment_idx] =
+                    std::make_unique<InvertedLists::ScopedCodeNorms>(
+                            invlists, list_no, segment_offset);
+        }
+
+        for (idx_t pair_idx = pair_begin; pair_idx < pair_end; pair_idx++) {
+            const idx_t ij = list_pairs[pair_idx];
+            const idx_t i = ij / nprobe;
+            InvertedListScanner* scanner = scanners[i].get();
+
+            scanner->set_list(list_no, coarse_dis[ij]);
+            nlistv++;
+
+            size_t scan_cnt = 0;
+            for (size_t segment_idx = 0; segment_idx < segment_num;
+                 segment_idx++) {
+                nheap += scanner->scan_codes(
+                        segment_sizes[segment_idx],
+                        scodes[segment_idx]->get(),
+                        scode_norms[segment_idx]->get(),
+                        sids[segment_idx]->get(),
+                        distances + i * k,
+                        labels + i * k,
+                        k,
+                        scan_cnt);
+            }
+            ndis += scan_cnt;
+        }
+
+        InterruptCallback::check();
+    }
+
+    if (do_heap_init) {
+        for (idx_t i = 0; i < n; i++) {
+            if (metric_type == METRIC_INNER_PRODUCT) {
+                heap_reorder<HeapForIP>(k, distances + i * k, labels + i * k);
+            } else {
+                heap_reorder<HeapForL2>(k, distances + i * k, labels + i * k);
+            }
+        }
+    }
+
+    if (ivf_stats) {
+        ivf_stats->nq += n;
+        ivf_stats->nlist += nlistv;
+        ivf_stats->ndis += ndis;
+        ivf_stats->nheap_updates += nheap;
+    }
+}
+
 void IndexIVF::range_search(
         idx_t nx,
         const float* x,
@@ -94,6 +94,13 @@ struct SearchParametersIVF : SearchParameters {
     /// context object to pass to InvertedLists
     void* inverted_list_context = nullptr;
 
+    ///< process a batch of queries list by list rather than query by query:
+    ///< the coarse assignment is done with a single GEMM (flat quantizers
+    ///< only), and every probed inverted list is scanned once for all the
+    ///< queries of the batch that probe it, while the list is hot in cache.
+    ///< ignored when max_codes is set or for iterable inverted lists.
+    bool list_major_scan = false;
+
     virtual ~SearchParametersIVF() {}
 };
 
@@ -358,6 +365,20 @@ struct IndexIVF : Index, IndexIVFInterface {
             idx_t* labels,
             const SearchParameters* params = nullptr) const override;
 
+    /** search_preassigned() that visits every inverted list once for all the
+     * queries probing it, see SearchParametersIVF::list_major_scan */
+    void search_preassigned_list_major(
+            idx_t n,
+            const float* x,
+            idx_t k,
+            const idx_t* assign,
+            const float* centroid_dis,
+            float* distances,
+            idx_t* labels,
+            const IDSelector* sel,
+            const IVFSearchParameters* params,
+            IndexIVFStats* stats) const;
+
     void range_search(
             idx_t n,
             const float* x,
@@ -365,7 +386,7 @@ struct IndexIVF : Index, IndexIVFInterface {
             faiss::RangeSearchResult* result,
             const SearchParameters* params = nullptr) const override;
 
-    void calc_dist_by_ids(
+    virtual void calc_dist_by_ids(
             idx_t n,
             const float* x,
             size_t num_keys,
@@ -0,0 +1,510 @@
+// Copyright (C) 2019-2024 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License.
+
+#include <faiss/cppcontrib/knowhere/IndexIVFFlatTyped.h>
+
+#include <omp.h>
+
+#include <cassert>
+#include <cinttypes>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "knowhere/bitsetview_idselector.h"
+#include "knowhere/object.h"
+#include "knowhere/operands.h"
+
+#include <faiss/cppcontrib/knowhere/invlists/InvertedLists.h>
+#include <faiss/impl/AuxIndexStructures.h>
+#include <faiss/impl/FaissAssert.h>
+#include <faiss/impl/IDSelector.h>
+#include <faiss/cppcontrib/knowhere/utils/distances.h>
+#include <faiss/cppcontrib/knowhere/utils/distances_if.h>
+#include <faiss/utils/Heap.h>
+
+#include <faiss/cppcontrib/knowhere/MetricType.h>
+#include "simd/hook.h"
+
+namespace faiss::cppcontrib::knowhere {
+
+namespace {
+
+template <typename DataType>
+float typed_norm_L2sqr(const DataType* x, size_t d) {
+    if constexpr (std::is_same_v<DataType, ::knowhere::fp16>) {
+        return fp16_vec_norm_L2sqr(x, d);
+    } else if constexpr (std::is_same_v<DataType, ::knowhere::bf16>) {
+        return bf16_vec_norm_L2sqr(x, d);
+    } else {
+        static_assert(std::is_same_v<DataType, ::knowhere::int8>);
+        return int8_vec_norm_L2sqr(x, d);
+    }
+}
+
+template <typename DataType, MetricType metric>
+float typed_distance(const DataType* x, const DataType* y, size_t d) {
+    if constexpr (std::is_same_v<DataType, ::knowhere::fp16>) {
+        return metric == METRIC_INNER_PRODUCT ? fp16_vec_inner_product(x, y, d)
+                                              : fp16_vec_L2sqr(x, y, d);
+    } else if constexpr (std::is_same_v<DataType, ::knowhere::bf16>) {
+        return metric == METRIC_INNER_PRODUCT ? bf16_vec_inner_product(x, y, d)
+                                              : bf16_vec_L2sqr(x, y, d);
+    } else {
+        return metric == METRIC_INNER_PRODUCT ? int8_vec_inner_product(x, y, d)
+                                              : int8_vec_L2sqr(x, y, d);
+    }
+}
+
+// the typed counterpart of fvec_inner_products_ny_if / fvec_L2sqr_ny_if
+template <typename DataType, MetricType metric, typename Pred, typename Apply>
+void typed_distances_ny_if(
+        const DataType* x,
+        const DataType* y,
+        size_t d,
+        size_t ny,
+        Pred pred,
+        Apply apply) {
+    if constexpr (std::is_same_v<DataType, ::knowhere::fp16>) {
+        if constexpr (metric == METRIC_INNER_PRODUCT) {
+            fp16_vec_inner_products_ny_if(x, y, d, ny, pred, apply);
+        } else {
+            fp16_vec_L2sqr_ny_if(x, y, d, ny, pred, apply);
+        }
+    } else if constexpr (std::is_same_v<DataType, ::knowhere::bf16>) {
+        if constexpr (metric == METRIC_INNER_PRODUCT) {
+            bf16_vec_inner_products_ny_if(x, y, d, ny, pred, apply);
+        } else {
+            bf16_vec_L2sqr_ny_if(x, y, d, ny, pred, apply);
+        }
+    } else {
+        if constexpr (metric == METRIC_INNER_PRODUCT) {
+            int8_vec_inner_products_ny_if(x, y, d, ny, pred, apply);
+        } else {
+            int8_vec_L2sqr_ny_if(x, y, d, ny, pred, apply);
+        }
+    }
+}
+
+template <typename DataType>
+void convert_from_float(size_t n, const float* x, DataType* out) {
+    for (size_t i = 0; i < n; i++) {
+        out[i] = DataType(x[i]);
+    }
+}
+
+template <typename DataType>
+void convert_to_float(size_t n, const DataType* x, float* out) {
+    for (size_t i = 0; i < n; i++) {
+        out[i] = float(x[i]);
+    }
+}
+
+// The query is converted to DataType once per set_query(). For cosine,
+//   the distances are divided by the norms of both the query and the code,
+//   because typed queries cannot be normalized in place.
+// use_bitset_view is the counterpart of IVFFlatBitsetViewScanner, which
+//   avoids the virtual is_member() calls for knowhere bitsets.
+template <
+        typename DataType,
+        MetricType metric,
+        class C,
+        bool use_sel,
+        bool use_bitset_view>
+struct IVFFlatTypedScanner : InvertedListScanner {
+    size_t d;
+    bool is_cosine;
+    ::knowhere::BitsetView bitset;
+
+    std::vector<DataType> xi;
+    float query_norm = 1.0f;
+
+    IVFFlatTypedScanner(
+            size_t d,
+            bool is_cosine,
+            bool store_pairs,
+            const IDSelector* sel)
+            : InvertedListScanner(store_pairs, sel),
+              d(d),
+              is_cosine(is_cosine),
+              xi(d) {
+        keep_max = faiss::cppcontrib::knowhere::is_similarity_metric(metric);
+        code_size = sizeof(DataType) * d;
+        if constexpr (use_bitset_view) {
+            const auto* bitsetview_sel =
+                    dynamic_cast<const ::knowhere::BitsetViewIDSelector*>(sel);
+            FAISS_ASSERT_MSG(
+                    (bitsetview_sel != nullptr),
+                    "Unsupported scanner for IVFFlatTypedScanner");
+            bitset = bitsetview_sel->bitset_view;
+        }
+    }
+
+    void set_query(const float* query) override {
+        convert_from_float(d, query, xi.data());
+        query_norm = 1.0f;
+        if (is_cosine) {
+            const float norm = std::sqrt(typed_norm_L2sqr(xi.data(), d));
+            if (norm > 0) {
+                query_norm = norm;
+            }
+        }
+    }
+
+    void set_list(idx_t list_no, float /* coarse_dis */) override {
+        this->list_no = list_no;
+    }
+
+    // for cosine, the norm of the code is computed from the code itself the
+    //   same way add_core() computes the stored one, so that the distance
+    //   matches the one of scan_codes()
+    float distance_to_code(const uint8_t* code) const override {
+        const DataType* y = (const DataType*)code;
+        const float dis = typed_distance<DataType, metric>(xi.data(), y, d);
+        if (!is_cosine) {
+            return dis;
+        }
+        const float code_norm = std::sqrt(typed_norm_L2sqr(y, d));
+        return dis / (code_norm * query_norm);
+    }
+
+    bool is_accepted(const idx_t* ids, const size_t j) const {
+        if constexpr (!use_sel) {
+            return true;
+        } else if constexpr (use_bitset_view) {
+            return !bitset.test(ids[j]);
+        } else {
+            return sel->is_member(ids[j]);
+        }
+    }
+
+    float normalize(const float dis_in, const float* code_norms, size_t j)
+            const {
+        return (code_norms == nullptr) ? dis_in
+                                       : (dis_in / (code_norms[j] * query_norm));
+    }
+
+    size_t scan_codes(
+            size_t list_size,
+            const uint8_t* __restrict codes,
+            const float* __restrict code_norms,
+            const idx_t* __restrict ids,
+            float* __restrict simi,
+            idx_t* __restrict idxi,
+            size_t k,
+            size_t& scan_cnt) const override {
+        const DataType* list_vecs = (const DataType*)codes;
+        size_t nup = 0;
+
+        // the lambda that filters acceptable elements.
+        auto filter = [&](const size_t j) { return is_accepted(ids, j); };
+
+        // the lambda that applies a valid element.
+        auto apply = [&](const float dis_in, const size_t j) {
+            const float dis = normalize(dis_in, code_norms, j);
+            scan_cnt++;
+            if (C::cmp(simi[0], dis)) {
+                const int64_t id = store_pairs ? lo_build(list_no, j) : ids[j];
+                heap_replace_top<C>(k, simi, idxi, dis, id);
+                nup++;
+            }
+        };
+
+        typed_distances_ny_if<DataType, metric>(
+                xi.data(), list_vecs, d, list_size, filter, apply);
+
+        return nup;
+    }
+
+    void scan_codes_and_return(
+            size_t list_size,
+            const uint8_t* codes,
+            const float* code_norms,
+            const idx_t* ids,
+            std::vector<::knowhere::DistId>& out) const override {
+        const DataType* list_vecs = (const DataType*)codes;
+
+        // the lambda that filters acceptable elements.
+        auto filter = [&](const size_t j) { return is_accepted(ids, j); };
+        // the lambda that applies a valid element.
+        auto apply = [&](const float dis_in, const size_t j) {
+            out.emplace_back(ids[j], normalize(dis_in, code_norms, j));
+        };
+
+        typed_distances_ny_if<DataType, metric>(
+                xi.data(), list_vecs, d, list_size, filter, apply);
+    }
+
+    void scan_codes_range(
+            size_t list_size,
+            const uint8_t* __restrict codes,
+            const float* __restrict code_norms,
+            const idx_t* __restrict ids,
+            float radius,
+            RangeQueryResult& res) const override {
+        const DataType* list_vecs = (const DataType*)codes;
+
+        // the lambda that filters acceptable elements.
+        auto filter = [&](const size_t j) { return is_accepted(ids, j); };
+
+        // the lambda that applies a filtered element.
+        auto apply = [&](const float dis_in, const size_t j) {
+            const float dis = normalize(dis_in, code_norms, j);
+            if (C::cmp(radius, dis)) {
+                int64_t id = store_pairs ? lo_build(list_no, j) : ids[j];
+                res.add(dis, id);
+            }
+        };
+
+        typed_distances_ny_if<DataType, metric>(
+                xi.data(), list_vecs, d, list_size, filter, apply);
+    }
+};
+
+template <typename DataType, bool use_sel, bool use_bitset_view>
+InvertedListScanner* get_InvertedListScanner2(
+        const IndexIVFFlatTyped<DataType>* ivf,
+        bool store_pairs,
+        const IDSelector* sel) {
+    if (ivf->metric_type == METRIC_INNER_PRODUCT) {
+        return new IVFFlatTypedScanner<
+                DataType,
+                METRIC_INNER_PRODUCT,
+                CMin<float, int64_t>,
+                use_sel,
+                use_bitset_view>(ivf->d, ivf->is_cosine, store_pairs, sel);
+    } else if (ivf->metric_type == METRIC_L2) {
+        return new IVFFlatTypedScanner<
+                DataType,
+                METRIC_L2,
+                CMax<float, int64_t>,
+                use_sel,
+                use_bitset_view>(ivf->d, ivf->is_cosine, store_pairs, sel);
+    } else {
+        FAISS_THROW_MSG("metric type not supported");
+    }
+}
+
+} // namespace
+
+template <typename DataType>
+IndexIVFFlatTyped<DataType>::IndexIVFFlatTyped(
+        Index* quantizer,
+        size_t d,
+        size_t nlist,
+        MetricType metric,
+        bool is_cosine)
+        : IndexIVFFlat(quantizer, d, nlist, metric, is_cosine) {
+    code_size = sizeof(DataType) * d;
+    replace_invlists(new ArrayInvertedLists(nlist, code_size, is_cosine), true);
+}
+
+template <typename DataType>
+void IndexIVFFlatTyped<DataType>::add_core(
+        idx_t n,
+        const float* x,
+        const float* /* x_norms */,
+        const idx_t* xids,
+        const idx_t* coarse_idx,
+        void* inverted_list_context) {
+    FAISS_THROW_IF_NOT(is_trained);
+    FAISS_THROW_IF_NOT(coarse_idx);
+    FAISS_THROW_IF_NOT(!by_residual);
+    assert(invlists);
+    direct_map.check_can_add(xids);
+
+    int64_t n_add = 0;
+
+    DirectMapAdd dm_adder(direct_map, n, xids);
+
+#pragma omp parallel reduction(+ : n_add)
+    {
+        int nt = omp_get_num_threads();
+        int rank = omp_get_thread_num();
+        std::vector<DataType> code(d);
+
+        // each thread takes care of a subset of lists
+        for (size_t i = 0; i < n; i++) {
+            idx_t list_no = coarse_idx[i];
+
+            if (list_no >= 0 && list_no % nt == rank) {
+                idx_t id = xids ? xids[i] : ntotal + i;
+                convert_from_float(d, x + i * d, code.data());
+                // the norms are taken from the stored values, so that they
+                //   match the typed distances exactly
+                float code_norm = 0;
+                if (is_cosine) {
+                    code_norm = std::sqrt(typed_norm_L2sqr(code.data(), d));
+                }
+                size_t offset = invlists->add_entry(
+                        list_no,
+                        id,
+                        (const uint8_t*)code.data(),
+                        is_cosine ? &code_norm : nullptr,
+                        inverted_list_context);
+                dm_adder.add(i, list_no, offset);
+                n_add++;
+            } else if (rank == 0 && list_no == -1) {
+                dm_adder.add(i, -1, 0);
+            }
+        }
+    }
+
+    if (verbose) {
+        printf("IndexIVFFlatTyped::add_core: added %" PRId64 " / %" PRId64
+               " vectors\n",
+               n_add,
+               n);
+    }
+    ntotal += n;
+}
+
+template <typename DataType>
+void IndexIVFFlatTyped<DataType>::encode_vectors(
+        idx_t n,
+        const float* x,
+        const idx_t* list_nos,
+        uint8_t* codes,
+        bool include_listnos) const {
+    FAISS_THROW_IF_NOT(!by_residual);
+    size_t coarse_size = include_listnos ? coarse_code_size() : 0;
+    for (size_t i = 0; i < n; i++) {
+        uint8_t* code = codes + i * (code_size + coarse_size);
+        if (include_listnos) {
+            int64_t list_no = list_nos[i];
+            if (list_no < 0) {
+                memset(code, 0, code_size + coarse_size);
+                continue;
+            }
+            encode_listno(list_no, code);
+        }
+        convert_from_float(d, x + i * d, (DataType*)(code + coarse_size));
+    }
+}
+
+template <typename DataType>
+void IndexIVFFlatTyped<DataType>::sa_decode(
+        idx_t n,
+        const uint8_t* bytes,
+        float* x) const {
+    size_t coarse_size = coarse_code_size();
+    for (size_t i = 0; i < n; i++) {
+        const uint8_t* code = bytes + i * (code_size + coarse_size);
+        convert_to_float(d, (const DataType*)(code + coarse_size), x + i * d);
+    }
+}
+
+template <typename DataType>
+InvertedListScanner* IndexIVFFlatTyped<DataType>::get_InvertedListScanner(
+        bool store_pairs,
+        const IDSelector* sel,
+        const IVFSearchParameters*) const {
+    if (dynamic_cast<const ::knowhere::BitsetViewIDSelector*>(sel)) {
+        return get_InvertedListScanner2<DataType, true, true>(
+                this, store_pairs, sel);
+    } else if (sel) {
+        return get_InvertedListScanner2<DataType, true, false>(
+                this, store_pairs, sel);
+    } else {
+        return get_InvertedListScanner2<DataType, false, false>(
+                this, store_pairs, sel);
+    }
+}
+
+template <typename DataType>
+void IndexIVFFlatTyped<DataType>::calc_dist_by_ids(
+        idx_t n,
+        const float* x,
+        size_t num_keys,
+        const int64_t* keys,
+        float* __restrict out_dist) const {
+    assert(n == 1);
+    if (direct_map.type == DirectMap::Type::NoMap) {
+        throw std::runtime_error(
+                "NoMap direct map not supported `calculate_dist_by_ids`");
+    }
+
+    std::vector<DataType> xi(d);
+    convert_from_float(d, x, xi.data());
+    float query_norm = 1.0f;
+    if (is_cosine) {
+        const float norm = std::sqrt(typed_norm_L2sqr(xi.data(), d));
+        if (norm > 0) {
+            query_norm = norm;
+        }
+    }
+    auto has_norms = invlists->get_code_norms((size_t)0, (size_t)0) != nullptr;
+
+    for (size_t i = 0; i < num_keys; i++) {
+        auto lo = direct_map.get(keys[i]);
+        auto list_no = lo_listno(lo);
+        auto offset = lo_offset(lo);
+        auto code = (const DataType*)invlists->get_single_code(list_no, offset);
+        if (metric_type == METRIC_INNER_PRODUCT) {
+            out_dist[i] = typed_distance<DataType, METRIC_INNER_PRODUCT>(
+                    xi.data(), code, d);
+            if (has_norms) {
+                out_dist[i] /= invlists->get_norm(list_no, offset) * query_norm;
+            }
+        } else {
+            out_dist[i] = typed_distance<DataType, METRIC_L2>(xi.data(), code, d);
+        }
+    }
+}
+
+template <typename DataType>
+void IndexIVFFlatTyped<DataType>::reconstruct(idx_t key, DataType* recons)
+        const {
+    idx_t lo = direct_map.get(key);
+    std::memcpy(
+            recons,
+            invlists->get_single_code(lo_listno(lo), lo_offset(lo)),
+            code_size);
+}
+
+template <typename DataType>
+void IndexIVFFlatTyped<DataType>::reconstruct_from_offset(
+        int64_t list_no,
+        int64_t offset,
+        float* recons) const {
+    convert_to_float(
+            d,
+            (const DataType*)invlists->get_single_code(list_no, offset),
+            recons);
+}
+
+template <typename DataType>
+IndexIVFFlatCCTyped<DataType>::IndexIVFFlatCCTyped(
+        Index* quantizer,
+        size_t d,
+        size_t nlist,
+        size_t ssize,
+        MetricType metric,
+        bool is_cosine)
+        : IndexIVFFlatTyped<DataType>(quantizer, d, nlist, metric, is_cosine) {
+    this->replace_invlists(
+            new ConcurrentArrayInvertedLists(
+                    nlist, this->code_size, ssize, is_cosine),
+            true);
+}
+
+template struct IndexIVFFlatTyped<::knowhere::fp16>;
+template struct IndexIVFFlatTyped<::knowhere::bf16>;
+template struct IndexIVFFlatTyped<::knowhere::int8>;
+
+template struct IndexIVFFlatCCTyped<::knowhere::fp16>;
+template struct IndexIVFFlatCCTyped<::knowhere::bf16>;
+template struct IndexIVFFlatCCTyped<::knowhere::int8>;
+
+} // namespace faiss::cppcontrib::knowhere
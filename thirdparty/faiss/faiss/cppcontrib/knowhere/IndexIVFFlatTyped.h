@@ -0,0 +1,96 @@
+// Copyright (C) 2019-2024 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License.
+
+#pragma once
+
+#include <faiss/cppcontrib/knowhere/IndexIVFFlat.h>
+
+#include "knowhere/operands.h"
+
+namespace faiss {
+namespace cppcontrib {
+namespace knowhere {
+
+/** Inverted file that stores the vectors in their native low precision
+ * type (fp16, bf16 or int8) and scans the inverted lists with the typed
+ * distance kernels, instead of keeping an fp32 copy as IndexIVFFlat does.
+ *
+ * The coarse quantizer and the float interface are unchanged: the vectors
+ * are converted to DataType when they are added, and the queries are
+ * converted when a scanner is set up. For cosine, the queries are expected
+ * as is (not normalized), the scanners divide by both norms.
+ */
+template <typename DataType>
+struct IndexIVFFlatTyped : IndexIVFFlat {
+    IndexIVFFlatTyped(
+            Index* quantizer,
+            size_t d,
+            size_t nlist_,
+            MetricType = METRIC_L2,
+            bool is_cosine = false);
+
+    IndexIVFFlatTyped() {}
+
+    void add_core(
+            idx_t n,
+            const float* x,
+            const float* x_norms,
+            const idx_t* xids,
+            const idx_t* precomputed_idx,
+            void* inverted_list_context = nullptr) override;
+
+    void encode_vectors(
+            idx_t n,
+            const float* x,
+            const idx_t* list_nos,
+            uint8_t* codes,
+            bool include_listnos = false) const override;
+
+    InvertedListScanner* get_InvertedListScanner(
+            bool store_pairs,
+            const IDSelector* sel,
+            const IVFSearchParameters* params) const override;
+
+    void calc_dist_by_ids(
+            idx_t n,
+            const float* x,
+            size_t num_keys,
+            const int64_t* keys,
+            float* out_dist) const override;
+
+    using IndexIVFFlat::reconstruct;
+    void reconstruct(idx_t key, DataType* recons) const;
+
+    void reconstruct_from_offset(int64_t list_no, int64_t offset, float* recons)
+            const override;
+
+    void sa_decode(idx_t n, const uint8_t* bytes, float* x) const override;
+};
+
+/** IndexIVFFlatTyped on top of ConcurrentArrayInvertedLists, the typed
+ * counterpart of IndexIVFFlatCC.
+ */
+template <typename DataType>
+struct IndexIVFFlatCCTyped : IndexIVFFlatTyped<DataType> {
+    IndexIVFFlatCCTyped(
+            Index* quantizer,
+            size_t d,
+            size_t nlist,
+            size_t ssize,
+            MetricType = METRIC_L2,
+            bool is_cosine = false);
+
+    IndexIVFFlatCCTyped() {}
+};
+
+}
+}
+} // namespace faiss
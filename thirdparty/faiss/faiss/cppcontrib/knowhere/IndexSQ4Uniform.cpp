@@ -83,6 +83,10 @@ float SQ4UniformCosineDistanceComputer::symmetric_dis(idx_t i, idx_t j) {
     return 1.0f - 0.5f * l2_sqr_dis;
 }
 
+void SQ4UniformCosineDistanceComputer::prefetch(idx_t i) {
+    basedis->prefetch(i);
+}
+
 //////////////////////////////////////////////////////////////////////////////////
 // WithSQ4UniformNormIPDistanceComputer implementation
 //////////////////////////////////////////////////////////////////////////////////
@@ -153,6 +157,11 @@ float WithSQ4UniformNormIPDistanceComputer::symmetric_dis(idx_t i, idx_t j) {
     return 0.5f * (norm_i_sqr + norm_j_sqr - l2_sqr_dis);
 }
 
+void WithSQ4UniformNormIPDistanceComputer::prefetch(idx_t i) {
+    basedis->prefetch(i);
+    prefetch_L2(l2_norms_sqr + i);
+}
+
 //////////////////////////////////////////////////////////////////////////////////
 // IndexScalarQuantizer4bitUniformCosine implementation
 //////////////////////////////////////////////////////////////////////////////////
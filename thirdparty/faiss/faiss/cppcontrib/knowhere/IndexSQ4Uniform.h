@@ -72,6 +72,9 @@ struct SQ4UniformCosineDistanceComputer : DistanceComputer {
 
     /// Compute distance between two stored vectors
     float symmetric_dis(idx_t i, idx_t j) override;
+
+    /// Prefetch the data of vector i
+    void prefetch(idx_t i) override;
 };
 
 /**
@@ -116,6 +119,9 @@ struct WithSQ4UniformNormIPDistanceComputer : DistanceComputer {
 
     /// Compute distance between two stored vectors
     float symmetric_dis(idx_t i, idx_t j) override;
+
+    /// Prefetch the data of vector i
+    void prefetch(idx_t i) override;
 };
 
 //////////////////////////////////////////////////////////////////////////////////
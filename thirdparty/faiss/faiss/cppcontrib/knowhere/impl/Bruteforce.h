@@ -85,6 +85,64 @@ void brute_force_range_search_impl(
     }
 }
 
+// Same as brute_force_search_impl(), but only visits the given ids, which
+//   is what a very selective filter wants instead of testing every row.
+// C is CMax<> or CMin<>
+template<typename C, typename DistanceComputerT>
+void brute_force_search_by_ids_impl(
+    const idx_t* __restrict ids,
+    const idx_t n_ids,
+    DistanceComputerT& __restrict qdis,
+    const idx_t k,
+    float* __restrict distances,
+    idx_t* __restrict labels
+) {
+    static_assert(std::is_same_v<typename C::T, float>);
+    static_assert(std::is_same_v<typename C::TI, idx_t>);
+
+    auto max_heap = std::make_unique<std::pair<float, idx_t>[]>(k);
+    idx_t n_added = 0;
+    for (idx_t i = 0; i < n_ids; ++i) {
+        const idx_t idx = ids[i];
+        const float distance = qdis(idx);
+        if (n_added < k) {
+            n_added += 1;
+            heap_push<C>(n_added, max_heap.get(), distance, idx);
+        } else if (C::cmp(max_heap[0].first, distance)) {
+            heap_replace_top<C>(k, max_heap.get(), distance, idx);
+        }
+    }
+
+    const idx_t len = std::min(n_added, idx_t(k));
+    for (idx_t i = 0; i < len; i++) {
+        labels[len - i - 1] = max_heap[0].second;
+        distances[len - i - 1] = max_heap[0].first;
+
+        heap_pop<C>(len - i, max_heap.get());
+    }
+
+    // fill leftovers
+    if (len < k) {
+        for (idx_t idx = len; idx < k; idx++) {
+            labels[idx] = -1;
+            distances[idx] = C::neutral();
+        }
+    }
+}
+
+template<typename ResultHandlerT, typename DistanceComputerT>
+void brute_force_range_search_by_ids_impl(
+    const idx_t* __restrict ids,
+    const idx_t n_ids,
+    DistanceComputerT& __restrict qdis,
+    ResultHandlerT& __restrict rres
+) {
+    for (idx_t i = 0; i < n_ids; ++i) {
+        const float distance = qdis(ids[i]);
+        rres.add_result(distance, ids[i]);
+    }
+}
+
 }
 }
 }
@@ -1142,7 +1142,7 @@ void HNSW::permute_entries(const idx_t* map) {
         entry_point = imap[entry_point];
     }
     std::vector<int> new_levels(ntotal);
-    std::vector<size_t> new_offsets(ntotal + 1);
+    MaybeOwnedVector<size_t> new_offsets(ntotal + 1);
     std::vector<storage_idx_t> new_neighbors(neighbors.size());
     size_t no = 0;
     for (int i = 0; i < ntotal; i++) {
@@ -1157,10 +1157,47 @@ void HNSW::permute_entries(const idx_t* map) {
     assert(new_offsets[ntotal] == offsets[ntotal]);
     // swap everyone
     std::swap(levels, new_levels);
-    std::swap(offsets, new_offsets);
+    offsets = std::move(new_offsets);
     neighbors = std::move(new_neighbors);
 }
 
+void HNSW::bfs_order(idx_t* map) const {
+    storage_idx_t ntotal = levels.size();
+    std::vector<bool> visited(ntotal, false);
+    idx_t n_ordered = 0;
+
+    // map[head..n_ordered) is the queue of the traversal
+    auto traverse_from = [&](storage_idx_t start) {
+        visited[start] = true;
+        map[n_ordered++] = start;
+        for (idx_t head = n_ordered - 1; head < n_ordered; head++) {
+            size_t begin, end;
+            neighbor_range(map[head], 0, &begin, &end);
+            for (size_t j = begin; j < end; j++) {
+                storage_idx_t v = neighbors[j];
+                if (v < 0) {
+                    break;
+                }
+                if (!visited[v]) {
+                    visited[v] = true;
+                    map[n_ordered++] = v;
+                }
+            }
+        }
+    };
+
+    if (entry_point >= 0) {
+        traverse_from(entry_point);
+    }
+    // nodes that cannot be reached from the entry point follow their own
+    // connected parts
+    for (storage_idx_t i = 0; i < ntotal; i++) {
+        if (!visited[i]) {
+            traverse_from(i);
+        }
+    }
+}
+
 /**************************************************************
  * MinimaxHeap
  **************************************************************/
@@ -120,7 +120,7 @@ struct HNSW {
 
     /// offsets[i] is the offset in the neighbors array where vector i is stored
     /// size ntotal + 1
-    std::vector<size_t> offsets;
+    MaybeOwnedVector<size_t> offsets;
 
     /// neighbors[offsets[i]:offsets[i+1]] is the list of neighbors of vector i
     /// for all levels. this is where all storage goes.
@@ -235,6 +235,11 @@ struct HNSW {
             bool keep_max_size_level0 = false);
 
     void permute_entries(const idx_t* map);
+
+    /// order of the nodes in a breadth-first traversal of level 0 from the
+    /// entry point, so that nodes get ids close to their neighbors'. map is
+    /// of size ntotal and maps new to old ids, as permute_entries expects
+    void bfs_order(idx_t* map) const;
 };
 
 struct HNSWStats {
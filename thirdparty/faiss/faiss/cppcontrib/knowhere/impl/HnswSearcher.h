@@ -31,6 +31,7 @@
 #include <faiss/cppcontrib/knowhere/impl/HNSW.h>
 #include <faiss/cppcontrib/knowhere/impl/ResultHandler.h>
 #include <faiss/utils/ordered_key_value.h>
+#include <faiss/utils/prefetch.h>
 
 // Knowhere-specific headers
 #include <faiss/cppcontrib/knowhere/impl/Neighbor.h>
@@ -44,6 +45,14 @@ namespace {
 // whether to track statistics
 constexpr bool track_hnsw_stats = true;
 
+// how many batches of 4 vectors are requested from memory ahead of
+//   the batch whose distances are being evaluated.
+constexpr size_t prefetch_lookahead_batches = 2;
+
+// the max number of candidates that are buffered between the
+//   'check visited / filter' pass and the 'evaluate distances' pass.
+constexpr size_t max_buffered_candidates = 64;
+
 } // namespace
 
 // Accomodates all the search logic and variables.
@@ -111,6 +120,32 @@ struct v2_hnsw_searcher {
     v2_hnsw_searcher& operator=(const v2_hnsw_searcher&) = delete;
     v2_hnsw_searcher& operator=(v2_hnsw_searcher&&) = delete;
 
+    // requests the link list of a given node from memory.
+    void prefetch_neighbors(const storage_idx_t node_id, const int level)
+            const {
+        size_t begin = 0;
+        size_t end = 0;
+        hnsw.neighbor_range(node_id, level, &begin, &end);
+
+        prefetch_L2(hnsw.neighbors.data() + begin);
+    }
+
+    // requests the batch of 4 vectors that goes 'prefetch_lookahead_batches'
+    //   batches after the one that starts at idx_begin.
+    //   indices past idx_end are ignored.
+    template <typename IndexT>
+    void prefetch_lookahead(
+            const IndexT* const __restrict indices,
+            const size_t idx_begin,
+            const size_t idx_end) {
+        const size_t lookahead_begin =
+                idx_begin + 4 * prefetch_lookahead_batches;
+        const size_t lookahead_end = std::min(lookahead_begin + 4, idx_end);
+        for (size_t i = lookahead_begin; i < lookahead_end; i++) {
+            qdis.prefetch(indices[i]);
+        }
+    }
+
     // greedily update a nearest vector at a given level.
     // * the update starts from the value in 'nearest'.
     faiss::cppcontrib::knowhere::HNSWStats greedy_update_nearest(
@@ -126,7 +161,7 @@ struct v2_hnsw_searcher {
             size_t end = 0;
             hnsw.neighbor_range(nearest, level, &begin, &end);
 
-            // prefetch and eval the size
+            // eval the size
             size_t count = 0;
             for (size_t i = begin; i < end; i++) {
                 storage_idx_t v = hnsw.neighbors[i];
@@ -134,13 +169,51 @@ struct v2_hnsw_searcher {
                     break;
                 }
 
-                // qdis.prefetch(v);
                 count += 1;
             }
 
-            // visit neighbors
-            for (size_t i = begin; i < begin + count; i++) {
-                storage_idx_t v = hnsw.neighbors[i];
+            const storage_idx_t* const __restrict candidates =
+                    hnsw.neighbors.data() + begin;
+
+            // prefetch the leading batches
+            const size_t n_leading =
+                    std::min(count, 4 * prefetch_lookahead_batches);
+            for (size_t i = 0; i < n_leading; i++) {
+                qdis.prefetch(candidates[i]);
+            }
+
+            // visit neighbors, 4 at a time
+            size_t i = 0;
+            for (; i + 4 <= count; i += 4) {
+                prefetch_lookahead(candidates, i, count);
+
+                float dis[4] = {0, 0, 0, 0};
+                qdis.distances_batch_4(
+                        candidates[i + 0],
+                        candidates[i + 1],
+                        candidates[i + 2],
+                        candidates[i + 3],
+                        dis[0],
+                        dis[1],
+                        dis[2],
+                        dis[3]);
+
+                for (size_t id4 = 0; id4 < 4; id4++) {
+                    // record a traversed edge
+                    graph_visitor.visit_edge(
+                            level, prev_nearest, nearest, dis[id4]);
+
+                    // check if an update is needed
+                    if (dis[id4] < d_nearest) {
+                        nearest = candidates[i + id4];
+                        d_nearest = dis[id4];
+                    }
+                }
+            }
+
+            // process leftovers
+            for (; i < count; i++) {
+                const storage_idx_t v = candidates[i];
 
                 // compute the distance
                 const float dis = qdis(v);
@@ -165,6 +238,9 @@ struct v2_hnsw_searcher {
             if (nearest == prev_nearest) {
                 return stats;
             }
+
+            // the next hop starts from the new nearest node
+            prefetch_neighbors(nearest, level);
         }
     }
 
@@ -185,10 +261,75 @@ struct v2_hnsw_searcher {
         size_t end = 0;
         hnsw.neighbor_range(node_id, level, &begin, &end);
 
-        // todo: add prefetch
+        // Candidates are collected first and evaluated afterwards, so that
+        //   the vectors of the upcoming batches of 4 can be requested from
+        //   memory while the current batch is being evaluated.
         size_t counter = 0;
-        size_t saved_indices[4];
-        int saved_statuses[4];
+        storage_idx_t saved_indices[max_buffered_candidates];
+        int saved_statuses[max_buffered_candidates];
+
+        // evaluates all buffered candidates
+        auto evaluate_saved = [&]() {
+            // prefetch the leading batches
+            const size_t n_leading =
+                    std::min(counter, 4 * prefetch_lookahead_batches);
+            for (size_t i = 0; i < n_leading; i++) {
+                qdis.prefetch(saved_indices[i]);
+            }
+
+            size_t i = 0;
+            for (; i + 4 <= counter; i += 4) {
+                prefetch_lookahead(saved_indices, i, counter);
+
+                // evaluate 4x distances at once
+                float dis[4] = {0, 0, 0, 0};
+                qdis.distances_batch_4(
+                        saved_indices[i + 0],
+                        saved_indices[i + 1],
+                        saved_indices[i + 2],
+                        saved_indices[i + 3],
+                        dis[0],
+                        dis[1],
+                        dis[2],
+                        dis[3]);
+
+                for (size_t id4 = 0; id4 < 4; id4++) {
+                    // record a traversed edge
+                    graph_visitor.visit_edge(
+                            level, node_id, saved_indices[i + id4], dis[id4]);
+
+                    // add a record of visited nodes
+                    knowhere::Neighbor nn(
+                            saved_indices[i + id4],
+                            dis[id4],
+                            saved_statuses[i + id4]);
+                    if (func_add_candidate(nn)) {
+                        // the node is likely to be expanded soon
+                        prefetch_neighbors(nn.id, level);
+                    }
+                }
+            }
+
+            // process leftovers
+            for (; i < counter; i++) {
+                // evaluate a single distance
+                const float dis = qdis(saved_indices[i]);
+
+                // record a traversed edge
+                graph_visitor.visit_edge(
+                        level, node_id, saved_indices[i], dis);
+
+                // add a record of visited
+                knowhere::Neighbor nn(
+                        saved_indices[i], dis, saved_statuses[i]);
+                if (func_add_candidate(nn)) {
+                    // the node is likely to be expanded soon
+                    prefetch_neighbors(nn.id, level);
+                }
+            }
+
+            counter = 0;
+        };
 
         size_t ndis = 0;
         for (size_t j = begin; j < end; j++) {
@@ -230,56 +371,12 @@ struct v2_hnsw_searcher {
 
             ndis += 1;
 
-            if (counter == 4) {
-                // evaluate 4x distances at once
-                float dis[4] = {0, 0, 0, 0};
-                qdis.distances_batch_4(
-                        saved_indices[0],
-                        saved_indices[1],
-                        saved_indices[2],
-                        saved_indices[3],
-                        dis[0],
-                        dis[1],
-                        dis[2],
-                        dis[3]);
-
-                for (size_t id4 = 0; id4 < 4; id4++) {
-                    // record a traversed edge
-                    graph_visitor.visit_edge(
-                            level, node_id, saved_indices[id4], dis[id4]);
-
-                    // add a record of visited nodes
-                    knowhere::Neighbor nn(
-                            saved_indices[id4], dis[id4], saved_statuses[id4]);
-                    if (func_add_candidate(nn)) {
-#if defined(USE_PREFETCH)
-                        // TODO
-                        // _mm_prefetch(get_linklist0(v), _MM_HINT_T0);
-#endif
-                    }
-                }
-
-                counter = 0;
+            if (counter == max_buffered_candidates) {
+                evaluate_saved();
             }
         }
 
-        // process leftovers
-        for (size_t id4 = 0; id4 < counter; id4++) {
-            // evaluate a single distance
-            const float dis = qdis(saved_indices[id4]);
-
-            // record a traversed edge
-            graph_visitor.visit_edge(level, node_id, saved_indices[id4], dis);
-
-            // add a record of visited
-            knowhere::Neighbor nn(saved_indices[id4], dis, saved_statuses[id4]);
-            if (func_add_candidate(nn)) {
-#if defined(USE_PREFETCH)
-                // TODO
-                // _mm_prefetch(get_linklist0(v), _MM_HINT_T0);
-#endif
-            }
-        }
+        evaluate_saved();
 
         // update stats
         if (track_hnsw_stats) {
@@ -26,9 +26,11 @@
 #include <faiss/cppcontrib/knowhere/IndexAdditiveQuantizer.h>
 #include <faiss/cppcontrib/knowhere/IndexCosine.h>
 #include <faiss/cppcontrib/knowhere/IndexFlat.h>
+#include <faiss/cppcontrib/knowhere/IndexFlatTyped.h>
 #include <faiss/cppcontrib/knowhere/IndexHNSW.h>
 #include <faiss/cppcontrib/knowhere/IndexIVF.h>
 #include <faiss/cppcontrib/knowhere/IndexIVFFlat.h>
+#include <faiss/cppcontrib/knowhere/IndexIVFFlatTyped.h>
 #include <faiss/cppcontrib/knowhere/IndexIVFPQ.h>
 #include <faiss/cppcontrib/knowhere/IndexIVFPQFastScan.h>
 #include <faiss/cppcontrib/knowhere/IndexIVFRaBitQ.h>
@@ -157,7 +159,7 @@ bool read_vector_base(
                     size_t(size),
                     strerror(errno));
 
-            VectorT view = VectorT::create_view(address, nread, nullptr);
+            VectorT view = VectorT::create_view(address, nread, zr->owner);
             target = std::move(view);
 
             return true;
@@ -581,7 +583,7 @@ static void read_HNSW(HNSW* hnsw, IOReader* f) {
     READVECTOR(hnsw->assign_probas);
     READVECTOR(hnsw->cum_nneighbor_per_level);
     READVECTOR(hnsw->levels);
-    READVECTOR(hnsw->offsets);
+    read_vector(hnsw->offsets, f);
     read_vector(hnsw->neighbors, f);
 
     READ1(hnsw->entry_point);
@@ -747,6 +749,30 @@ Index* read_index(IOReader* f, int io_flags) {
                 idxf->codes.size() == idxf->ntotal * idxf->code_size);
         // leak!
         idx = idxf;
+    } else if (
+            h == fourcc("IxFh") || h == fourcc("IxFb") || h == fourcc("IxFc")) {
+        IndexFlatCodes* idxf;
+        size_t elem_size;
+        if (h == fourcc("IxFh")) {
+            idxf = new IndexFlatTyped<::knowhere::fp16>();
+            elem_size = sizeof(::knowhere::fp16);
+        } else if (h == fourcc("IxFb")) {
+            idxf = new IndexFlatTyped<::knowhere::bf16>();
+            elem_size = sizeof(::knowhere::bf16);
+        } else {
+            idxf = new IndexFlatTyped<::knowhere::int8>();
+            elem_size = sizeof(::knowhere::int8);
+        }
+        read_index_header(idxf, f);
+        idxf->code_size = idxf->d * elem_size;
+        read_vector(idxf->codes, f);
+        if (idxf->is_cosine) {
+            READVECTOR(idxf->code_norms);
+        }
+        FAISS_THROW_IF_NOT(
+                idxf->codes.size() == idxf->ntotal * idxf->code_size);
+        // leak!
+        idx = idxf;
     } else if (h == fourcc("IxP7")) {
         IndexPQCosine* idxp = new IndexPQCosine();
         read_index_header(idxp, f);
@@ -896,6 +922,37 @@ Index* read_index(IOReader* f, int io_flags) {
         }
         read_InvertedLists(ivfl, f, io_flags);
         idx = ivfl;
+    } else if (
+            h == fourcc("IwFh") || h == fourcc("IwFb") || h == fourcc("IwFi") ||
+            h == fourcc("IwCh") || h == fourcc("IwCb") || h == fourcc("IwCi")) {
+        IndexIVFFlat* ivfl;
+        size_t elem_size;
+        if (h == fourcc("IwFh")) {
+            ivfl = new IndexIVFFlatTyped<::knowhere::fp16>();
+            elem_size = sizeof(::knowhere::fp16);
+        } else if (h == fourcc("IwFb")) {
+            ivfl = new IndexIVFFlatTyped<::knowhere::bf16>();
+            elem_size = sizeof(::knowhere::bf16);
+        } else if (h == fourcc("IwFi")) {
+            ivfl = new IndexIVFFlatTyped<::knowhere::int8>();
+            elem_size = sizeof(::knowhere::int8);
+        } else if (h == fourcc("IwCh")) {
+            ivfl = new IndexIVFFlatCCTyped<::knowhere::fp16>();
+            elem_size = sizeof(::knowhere::fp16);
+        } else if (h == fourcc("IwCb")) {
+            ivfl = new IndexIVFFlatCCTyped<::knowhere::bf16>();
+            elem_size = sizeof(::knowhere::bf16);
+        } else {
+            ivfl = new IndexIVFFlatCCTyped<::knowhere::int8>();
+            elem_size = sizeof(::knowhere::int8);
+        }
+        read_ivf_header(ivfl, f);
+        ivfl->code_size = ivfl->d * elem_size;
+        if (ivfl->is_cosine) {
+            io_flags |= IO_FLAG_WITH_NORM;
+        }
+        read_InvertedLists(ivfl, f, io_flags);
+        idx = ivfl;
     } else if (h == fourcc("IxS8")) {
         IndexScalarQuantizerCosine* idxs = new IndexScalarQuantizerCosine();
         read_index_header(idxs, f);
@@ -25,9 +25,11 @@
 #include <faiss/cppcontrib/knowhere/IndexAdditiveQuantizer.h>
 #include <faiss/cppcontrib/knowhere/IndexCosine.h>
 #include <faiss/cppcontrib/knowhere/IndexFlat.h>
+#include <faiss/cppcontrib/knowhere/IndexFlatTyped.h>
 #include <faiss/cppcontrib/knowhere/IndexHNSW.h>
 #include <faiss/cppcontrib/knowhere/IndexIVF.h>
 #include <faiss/cppcontrib/knowhere/IndexIVFFlat.h>
+#include <faiss/cppcontrib/knowhere/IndexIVFFlatTyped.h>
 #include <faiss/cppcontrib/knowhere/IndexIVFPQ.h>
 #include <faiss/cppcontrib/knowhere/IndexIVFPQFastScan.h>
 #include <faiss/cppcontrib/knowhere/IndexIVFRaBitQ.h>
@@ -435,6 +437,36 @@ static void write_direct_map(const DirectMap* dm, IOWriter* f) {
     }
 }
 
+// returns the fourcc of an IndexFlatTyped, or nullptr for other indexes
+static const char* flat_typed_fourcc(const Index* idx) {
+    if (dynamic_cast<const IndexFlatTyped<::knowhere::fp16>*>(idx)) {
+        return "IxFh";
+    } else if (dynamic_cast<const IndexFlatTyped<::knowhere::bf16>*>(idx)) {
+        return "IxFb";
+    } else if (dynamic_cast<const IndexFlatTyped<::knowhere::int8>*>(idx)) {
+        return "IxFc";
+    }
+    return nullptr;
+}
+
+// returns the fourcc of an IndexIVFFlatTyped, or nullptr for other indexes
+static const char* ivf_flat_typed_fourcc(const Index* idx) {
+    if (dynamic_cast<const IndexIVFFlatCCTyped<::knowhere::fp16>*>(idx)) {
+        return "IwCh";
+    } else if (dynamic_cast<const IndexIVFFlatCCTyped<::knowhere::bf16>*>(idx)) {
+        return "IwCb";
+    } else if (dynamic_cast<const IndexIVFFlatCCTyped<::knowhere::int8>*>(idx)) {
+        return "IwCi";
+    } else if (dynamic_cast<const IndexIVFFlatTyped<::knowhere::fp16>*>(idx)) {
+        return "IwFh";
+    } else if (dynamic_cast<const IndexIVFFlatTyped<::knowhere::bf16>*>(idx)) {
+        return "IwFb";
+    } else if (dynamic_cast<const IndexIVFFlatTyped<::knowhere::int8>*>(idx)) {
+        return "IwFi";
+    }
+    return nullptr;
+}
+
 static void write_ivf_header(const IndexIVF* ivf, IOWriter* f) {
     write_index_header(ivf, f);
     WRITE1(ivf->nlist);
@@ -469,6 +501,17 @@ void write_index(const Index* idx, IOWriter* f, int io_flags) {
         if (idx->is_cosine) {
             WRITEVECTOR(idxf->code_norms);
         }
+    } else if (const char* typed_h = flat_typed_fourcc(idx)) {
+        // vectors are stored in their native low precision type,
+        //   the type is given by the fourcc
+        const IndexFlatCodes* idxf = dynamic_cast<const IndexFlatCodes*>(idx);
+        uint32_t h = fourcc(typed_h);
+        WRITE1(h);
+        write_index_header(idx, f);
+        WRITEVECTOR(idxf->codes);
+        if (idx->is_cosine) {
+            WRITEVECTOR(idxf->code_norms);
+        }
     } else if (const IndexPQCosine* idxp = dynamic_cast<const IndexPQCosine*>(idx)) {
         uint32_t h = fourcc("IxP7");
         WRITE1(h);
@@ -592,6 +635,14 @@ void write_index(const Index* idx, IOWriter* f, int io_flags) {
         write_index_header(idx, f);
         write_ScalarQuantizer(&idxs->sq, f);
         WRITEVECTOR(idxs->codes);
+    } else if (const char* typed_h = ivf_flat_typed_fourcc(idx)) {
+        // vectors are stored in their native low precision type,
+        //   the type is given by the fourcc
+        const IndexIVF* ivfl = dynamic_cast<const IndexIVF*>(idx);
+        uint32_t h = fourcc(typed_h);
+        WRITE1(h);
+        write_ivf_header(ivfl, f);
+        write_InvertedLists(ivfl->invlists, f);
     } else if (
             const IndexIVFFlatDedup* ivfl =
                     dynamic_cast<const IndexIVFFlatDedup*>(idx)) {
@@ -0,0 +1,243 @@
+// Copyright (C) 2019-2024 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace faiss {
+namespace cppcontrib {
+namespace knowhere {
+
+// A table of visited nodes that is cleared in O(1).
+// Every element keeps a tag, and an element is visited if its tag is equal
+//   to the current epoch. clear() just moves to the next epoch, and the
+//   actual memset happens only once per 255 clear() calls.
+// The interface matches Bitset, so both can be used as VisitedT in
+//   v2_hnsw_searcher.
+struct EpochVisitedTable final {
+    using tag_t = uint8_t;
+
+    struct Proxy {
+        tag_t& element;
+        tag_t epoch;
+
+        inline Proxy(tag_t& _element, const tag_t _epoch) :
+            element{_element}, epoch{_epoch} {}
+
+        inline operator bool() const { return (element == epoch); }
+
+        inline Proxy& operator=(const bool value) {
+            if (value) { set(); } else { reset(); }
+            return *this;
+        }
+
+        inline void set() {
+            element = epoch;
+        }
+
+        inline void reset() {
+            element = 0;
+        }
+    };
+
+    inline EpochVisitedTable() {}
+
+    // create a table with all elements being not visited
+    inline static EpochVisitedTable create_cleared(const size_t initial_size) {
+        EpochVisitedTable table;
+        table.resize(initial_size);
+
+        return table;
+    }
+
+    EpochVisitedTable(const EpochVisitedTable&) = delete;
+    EpochVisitedTable(EpochVisitedTable&&) = default;
+    EpochVisitedTable& operator=(const EpochVisitedTable&) = delete;
+    EpochVisitedTable& operator=(EpochVisitedTable&&) = default;
+
+    // makes sure that the table is able to track at least new_size elements.
+    // all elements become not visited if a reallocation happens.
+    inline void resize(const size_t new_size) {
+        if (new_size <= capacity) {
+            size = new_size;
+            return;
+        }
+
+        tags = std::make_unique<tag_t[]>(new_size);
+        capacity = new_size;
+        size = new_size;
+        epoch = 1;
+    }
+
+    inline bool get(const size_t index) const {
+        return (tags[index] == epoch);
+    }
+
+    inline void set(const size_t index) {
+        tags[index] = epoch;
+    }
+
+    inline void reset(const size_t index) {
+        tags[index] = 0;
+    }
+
+    inline void clear() {
+        epoch += 1;
+        if (epoch == 0) {
+            // the epoch has wrapped around, so old tags may collide with
+            //   future epochs.
+            std::memset(tags.get(), 0, capacity * sizeof(tag_t));
+            epoch = 1;
+        }
+    }
+
+    inline Proxy operator[](const size_t idx) {
+        return Proxy{tags[idx], epoch};
+    }
+
+    inline bool operator[](const size_t idx) const {
+        return get(idx);
+    }
+
+    std::unique_ptr<tag_t[]> tags;
+    size_t size = 0;
+    size_t capacity = 0;
+    // 0 is reserved for 'never visited'
+    tag_t epoch = 1;
+};
+
+// A pool of EpochVisitedTable objects that belongs to an index, similar to
+//   hnswlib's VisitedListPool. Tables are kept for reuse across searches
+//   as long as the idle ones take no more than max_idle_bytes, and are
+//   freed together with the pool.
+// A handle must not outlive the pool it was taken from.
+struct VisitedTablePool {
+    // the default limit of the bytes held by idle tables
+    static constexpr size_t default_max_idle_bytes = size_t(256) << 20;
+
+    // owns a table while it is in use and returns it to the pool afterwards
+    struct Handle {
+        inline Handle() {}
+        inline Handle(
+                VisitedTablePool* pool_,
+                std::unique_ptr<EpochVisitedTable>&& table_) :
+            pool{pool_}, table{std::move(table_)} {}
+
+        Handle(const Handle&) = delete;
+        inline Handle(Handle&& other) :
+            pool{other.pool}, table{std::move(other.table)} {}
+        Handle& operator=(const Handle&) = delete;
+        inline Handle& operator=(Handle&& other) {
+            if (this != &other) {
+                release();
+                pool = other.pool;
+                table = std::move(other.table);
+            }
+            return *this;
+        }
+
+        inline ~Handle() {
+            release();
+        }
+
+        inline EpochVisitedTable& operator*() const { return *table; }
+        inline EpochVisitedTable* operator->() const { return table.get(); }
+        inline EpochVisitedTable* get() const { return table.get(); }
+
+        inline void release() {
+            if (table != nullptr) {
+                pool->release(std::move(table));
+            }
+        }
+
+    private:
+        VisitedTablePool* pool = nullptr;
+        std::unique_ptr<EpochVisitedTable> table;
+    };
+
+    inline explicit VisitedTablePool(
+            const size_t max_idle_bytes_ = default_max_idle_bytes) :
+        max_idle_bytes{max_idle_bytes_} {}
+
+    // a copy of an index starts with an empty pool
+    inline VisitedTablePool(const VisitedTablePool& other) :
+        max_idle_bytes{other.max_idle_bytes} {}
+    inline VisitedTablePool& operator=(const VisitedTablePool& other) {
+        if (this != &other) {
+            clear();
+            max_idle_bytes = other.max_idle_bytes;
+        }
+        return *this;
+    }
+
+    // gets a cleared table that is able to track ntotal elements.
+    inline Handle acquire(const size_t ntotal) {
+        std::unique_ptr<EpochVisitedTable> table;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!idle.empty()) {
+                // prefer the most recently used table, it is likely cached
+                table = std::move(idle.back());
+                idle.pop_back();
+                idle_bytes -= table->capacity;
+            }
+        }
+        if (table == nullptr) {
+            table = std::make_unique<EpochVisitedTable>();
+        }
+
+        table->resize(ntotal);
+        table->clear();
+
+        return Handle(this, std::move(table));
+    }
+
+    // frees all idle tables
+    inline void clear() {
+        std::vector<std::unique_ptr<EpochVisitedTable>> tables;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            tables.swap(idle);
+            idle_bytes = 0;
+        }
+    }
+
+    // the bytes held by idle tables
+    inline size_t size() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return idle_bytes;
+    }
+
+private:
+    // a table that is not kept is freed after the lock is released
+    inline void release(std::unique_ptr<EpochVisitedTable> table) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (idle_bytes + table->capacity <= max_idle_bytes) {
+            idle_bytes += table->capacity;
+            idle.push_back(std::move(table));
+        }
+    }
+
+    mutable std::mutex mutex;
+    std::vector<std::unique_ptr<EpochVisitedTable>> idle;
+    size_t idle_bytes = 0;
+    size_t max_idle_bytes = default_max_idle_bytes;
+};
+
+}
+}
+}
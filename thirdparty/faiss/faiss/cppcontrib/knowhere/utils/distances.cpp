@@ -529,8 +529,9 @@ void exhaustive_inner_product_blas(
     if (nx == 0 || ny == 0)
         return;
 
-    /* block sizes */
-    const size_t bs_x = distance_compute_blas_query_bs;
+    /* block sizes, the query block is not larger than the number of queries
+       to avoid allocating a huge buffer for small batches */
+    const size_t bs_x = std::min(nx, size_t(distance_compute_blas_query_bs));
     const size_t bs_y = distance_compute_blas_database_bs;
     std::unique_ptr<float[]> ip_block(new float[bs_x * bs_y]);
 
@@ -586,8 +587,9 @@ void exhaustive_L2sqr_blas(
     if (nx == 0 || ny == 0)
         return;
 
-    /* block sizes */
-    const size_t bs_x = distance_compute_blas_query_bs;
+    /* block sizes, the query block is not larger than the number of queries
+       to avoid allocating a huge buffer for small batches */
+    const size_t bs_x = std::min(nx, size_t(distance_compute_blas_query_bs));
     const size_t bs_y = distance_compute_blas_database_bs;
     // const size_t bs_x = 16, bs_y = 16;
     std::unique_ptr<float[]> ip_block(new float[bs_x * bs_y]);
@@ -669,8 +671,9 @@ void exhaustive_cosine_blas(
     if (nx == 0 || ny == 0)
         return;
 
-    /* block sizes */
-    const size_t bs_x = distance_compute_blas_query_bs;
+    /* block sizes, the query block is not larger than the number of queries
+       to avoid allocating a huge buffer for small batches */
+    const size_t bs_x = std::min(nx, size_t(distance_compute_blas_query_bs));
     const size_t bs_y = distance_compute_blas_database_bs;
     // const size_t bs_x = 16, bs_y = 16;
     std::unique_ptr<float[]> ip_block(new float[bs_x * bs_y]);
@@ -939,6 +942,24 @@ void knn_inner_product(
     knn_inner_product(x, y, d, nx, ny, res->k, res->val, res->ids, sel);
 }
 
+void knn_inner_product_blas(
+        const float* x,
+        const float* y,
+        size_t d,
+        size_t nx,
+        size_t ny,
+        size_t k,
+        float* vals,
+        int64_t* ids) {
+    if (k < distance_compute_min_k_reservoir) {
+        HeapBlockResultHandler<CMin<float, int64_t>, false> res(nx, vals, ids, k);
+        exhaustive_inner_product_blas(x, y, d, nx, ny, res);
+    } else {
+        ReservoirBlockResultHandler<CMin<float, int64_t>, false> res(nx, vals, ids, k);
+        exhaustive_inner_product_blas(x, y, d, nx, ny, res);
+    }
+}
+
 // computes and stores all IP distances into output. Output should be
 // preallocated of size nx * ny, each element should be initialized to
 // {lowest distance, -1}.
@@ -1108,6 +1129,25 @@ void knn_L2sqr(
     knn_L2sqr(x, y, d, nx, ny, res->k, res->val, res->ids, y_norm2, sel);
 }
 
+void knn_L2sqr_blas(
+        const float* x,
+        const float* y,
+        size_t d,
+        size_t nx,
+        size_t ny,
+        size_t k,
+        float* vals,
+        int64_t* ids,
+        const float* y_norm2) {
+    if (k < distance_compute_min_k_reservoir) {
+        HeapBlockResultHandler<CMax<float, int64_t>, false> res(nx, vals, ids, k);
+        exhaustive_L2sqr_blas(x, y, d, nx, ny, res, y_norm2);
+    } else {
+        ReservoirBlockResultHandler<CMax<float, int64_t>, false> res(nx, vals, ids, k);
+        exhaustive_L2sqr_blas(x, y, d, nx, ny, res, y_norm2);
+    }
+}
+
 // computes and stores all L2 distances into output. Output should be
 // preallocated of size nx * ny, each element should be initialized to
 // {lowest distance, -1}.
@@ -241,6 +241,21 @@ void knn_inner_product(
         int64_t* indexes,
         const IDSelector* sel = nullptr);
 
+/** Same as knn_inner_product() without a selector, but the distances are
+ *  always computed with BLAS, regardless of distance_compute_blas_threshold.
+ *  This pays off for small batches of queries against a small set of
+ *  vectors, such as the coarse assignment of a batch of IVF queries.
+ */
+void knn_inner_product_blas(
+        const float* x,
+        const float* y,
+        size_t d,
+        size_t nx,
+        size_t ny,
+        size_t k,
+        float* distances,
+        int64_t* indexes);
+
 void all_inner_product(
         const float* x,
         const float* y,
@@ -299,6 +314,22 @@ void knn_L2sqr(
         const float* y_norm2 = nullptr,
         const IDSelector* sel = nullptr);
 
+/** Same as knn_L2sqr() without a selector, but the distances are always
+ *  computed with BLAS, regardless of distance_compute_blas_threshold.
+ *
+ * @param y_norm2    (optional) norms for the y vectors (nullptr or size ny)
+ */
+void knn_L2sqr_blas(
+        const float* x,
+        const float* y,
+        size_t d,
+        size_t nx,
+        size_t ny,
+        size_t k,
+        float* distances,
+        int64_t* indexes,
+        const float* y_norm2 = nullptr);
+
 void all_L2sqr(
         const float* x,
         const float* y,
@@ -0,0 +1,330 @@
+// Copyright (C) 2019-2023 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <type_traits>
+
+#include <faiss/impl/AuxIndexStructures.h>
+#include <faiss/impl/IDSelector.h>
+#include <faiss/utils/Heap.h>
+#include <faiss/cppcontrib/knowhere/utils/distances.h>
+#include <faiss/cppcontrib/knowhere/utils/distances_tiled.h>
+#include "knowhere/operands.h"
+#include "simd/hook.h"
+
+#ifndef FINTEGER
+#define FINTEGER long
+#endif
+
+extern "C" {
+
+/* declare BLAS functions, see http://www.netlib.org/clapack/cblas/ */
+
+int sgemm_(
+        const char* transa,
+        const char* transb,
+        FINTEGER* m,
+        FINTEGER* n,
+        FINTEGER* k,
+        const float* alpha,
+        const float* a,
+        FINTEGER* lda,
+        const float* b,
+        FINTEGER* ldb,
+        float* beta,
+        float* c,
+        FINTEGER* ldc);
+}
+
+namespace faiss::cppcontrib::knowhere {
+
+// 64 queries x 256KB of database rows keeps both operands of the sgemm and
+// the distance block resident in L2 on the machines we care about.
+int distance_compute_tiled_query_bs = 64;
+int distance_compute_tiled_database_bytes = 256 * 1024;
+
+namespace {
+
+enum class TiledMetric { L2, IP, COSINE };
+
+template <typename DataType>
+inline void widen_row(const DataType* src, size_t d, float* dst) {
+    if constexpr (std::is_same_v<DataType, float>) {
+        std::copy(src, src + d, dst);
+    } else {
+        for (size_t i = 0; i < d; i++) {
+            dst[i] = static_cast<float>(src[i]);
+        }
+    }
+}
+
+template <typename DataType, TiledMetric M>
+void knn_tiled_impl(
+        const DataType* x,
+        const DataType* y,
+        const float* y_norms_in,
+        size_t d,
+        size_t nx,
+        size_t ny,
+        size_t k,
+        float* vals,
+        int64_t* ids,
+        const IDSelector* sel) {
+    using C = std::conditional_t<
+            M == TiledMetric::L2,
+            CMax<float, int64_t>,
+            CMin<float, int64_t>>;
+    constexpr bool is_fp32 = std::is_same_v<DataType, float>;
+
+    for (size_t i = 0; i < nx; i++) {
+        heap_heapify<C>(k, vals + i * k, ids + i * k);
+    }
+    if (nx == 0 || ny == 0 || k == 0) {
+        return;
+    }
+
+    // queries are widened once and reused for every database tile
+    const float* xf = nullptr;
+    std::unique_ptr<float[]> x_buf;
+    if constexpr (is_fp32) {
+        xf = x;
+    } else {
+        x_buf.reset(new float[nx * d]);
+        for (size_t i = 0; i < nx; i++) {
+            widen_row(x + i * d, d, x_buf.get() + i * d);
+        }
+        xf = x_buf.get();
+    }
+
+    std::unique_ptr<float[]> x_norms;
+    if constexpr (M == TiledMetric::L2) {
+        x_norms.reset(new float[nx]);
+        fvec_norms_L2sqr(x_norms.get(), xf, d, nx);
+    } else if constexpr (M == TiledMetric::COSINE) {
+        x_norms.reset(new float[nx]);
+        for (size_t i = 0; i < nx; i++) {
+            float norm = std::sqrt(fvec_norm_L2sqr(xf + i * d, d));
+            x_norms[i] = (norm == 0.0f ? 1.0f : norm);
+        }
+    }
+
+    const size_t bs_x = std::min(
+            nx, size_t(std::max(distance_compute_tiled_query_bs, 1)));
+    const size_t bs_y = std::clamp(
+            size_t(distance_compute_tiled_database_bytes) /
+                    (d * sizeof(float)),
+            size_t(16),
+            size_t(4096));
+
+    std::unique_ptr<float[]> tile_buf;
+    if (!is_fp32 || sel != nullptr) {
+        tile_buf.reset(new float[bs_y * d]);
+    }
+    std::unique_ptr<int64_t[]> tile_ids(new int64_t[bs_y]);
+    std::unique_ptr<float[]> tile_norms;
+    if constexpr (M != TiledMetric::IP) {
+        tile_norms.reset(new float[bs_y]);
+    }
+    std::unique_ptr<float[]> ip_block(new float[bs_x * bs_y]);
+
+    for (size_t j0 = 0; j0 < ny; j0 += bs_y) {
+        const size_t j1 = std::min(j0 + bs_y, ny);
+
+        // pack the rows that pass the selector, widening them on the way
+        size_t m = 0;
+        const float* tile = nullptr;
+        if (is_fp32 && sel == nullptr) {
+            tile = reinterpret_cast<const float*>(y) + j0 * d;
+            for (size_t j = j0; j < j1; j++) {
+                tile_ids[m++] = j;
+            }
+        } else {
+            for (size_t j = j0; j < j1; j++) {
+                if (sel != nullptr && !sel->is_member(j)) {
+                    continue;
+                }
+                widen_row(y + j * d, d, tile_buf.get() + m * d);
+                tile_ids[m++] = j;
+            }
+            tile = tile_buf.get();
+        }
+        if (m == 0) {
+            continue;
+        }
+
+        if constexpr (M == TiledMetric::L2) {
+            if (y_norms_in != nullptr) {
+                for (size_t t = 0; t < m; t++) {
+                    tile_norms[t] = y_norms_in[tile_ids[t]];
+                }
+            } else {
+                fvec_norms_L2sqr(tile_norms.get(), tile, d, m);
+            }
+        } else if constexpr (M == TiledMetric::COSINE) {
+            for (size_t t = 0; t < m; t++) {
+                float norm = (y_norms_in != nullptr)
+                        ? y_norms_in[tile_ids[t]]
+                        : std::sqrt(fvec_norm_L2sqr(tile + t * d, d));
+                tile_norms[t] = (norm == 0.0f ? 1.0f : norm);
+            }
+        }
+
+        for (size_t i0 = 0; i0 < nx; i0 += bs_x) {
+            const size_t i1 = std::min(i0 + bs_x, nx);
+            {
+                float one = 1, zero = 0;
+                FINTEGER mi = m, nxi = i1 - i0, di = d;
+                sgemm_("Transpose",
+                       "Not transpose",
+                       &mi,
+                       &nxi,
+                       &di,
+                       &one,
+                       tile,
+                       &di,
+                       xf + i0 * d,
+                       &di,
+                       &zero,
+                       ip_block.get(),
+                       &mi);
+            }
+
+            for (size_t i = i0; i < i1; i++) {
+                const float* ip_line = ip_block.get() + (i - i0) * m;
+                float* heap_dis = vals + i * k;
+                int64_t* heap_ids = ids + i * k;
+                float thresh = heap_dis[0];
+                for (size_t t = 0; t < m; t++) {
+                    float dis = ip_line[t];
+                    if constexpr (M == TiledMetric::L2) {
+                        // the expansion only screens candidates, the few
+                        // that make it into the heap are rescored exactly so
+                        // that e.g. identical vectors keep a 0 distance
+                        dis = x_norms[i] + tile_norms[t] - 2 * dis;
+                        if (!C::cmp(thresh, dis)) {
+                            continue;
+                        }
+                        dis = fvec_L2sqr(xf + i * d, tile + t * d, d);
+                    } else if constexpr (M == TiledMetric::COSINE) {
+                        dis = dis / (x_norms[i] * tile_norms[t]);
+                    }
+                    if (C::cmp(thresh, dis)) {
+                        heap_replace_top<C>(
+                                k, heap_dis, heap_ids, dis, tile_ids[t]);
+                        thresh = heap_dis[0];
+                    }
+                }
+            }
+        }
+        InterruptCallback::check();
+    }
+
+    for (size_t i = 0; i < nx; i++) {
+        heap_reorder<C>(k, vals + i * k, ids + i * k);
+    }
+}
+
+} // namespace
+
+template <typename DataType>
+void knn_L2sqr_tiled(
+        const DataType* x,
+        const DataType* y,
+        size_t d,
+        size_t nx,
+        size_t ny,
+        size_t k,
+        float* vals,
+        int64_t* ids,
+        const float* y_norm2,
+        const IDSelector* sel) {
+    knn_tiled_impl<DataType, TiledMetric::L2>(
+            x, y, y_norm2, d, nx, ny, k, vals, ids, sel);
+}
+
+template <typename DataType>
+void knn_inner_product_tiled(
+        const DataType* x,
+        const DataType* y,
+        size_t d,
+        size_t nx,
+        size_t ny,
+        size_t k,
+        float* vals,
+        int64_t* ids,
+        const IDSelector* sel) {
+    knn_tiled_impl<DataType, TiledMetric::IP>(
+            x, y, nullptr, d, nx, ny, k, vals, ids, sel);
+}
+
+template <typename DataType>
+void knn_cosine_tiled(
+        const DataType* x,
+        const DataType* y,
+        const float* y_norms,
+        size_t d,
+        size_t nx,
+        size_t ny,
+        size_t k,
+        float* vals,
+        int64_t* ids,
+        const IDSelector* sel) {
+    knn_tiled_impl<DataType, TiledMetric::COSINE>(
+            x, y, y_norms, d, nx, ny, k, vals, ids, sel);
+}
+
+#define INSTANTIATE_KNN_TILED(DataType)                   \
+    template void knn_L2sqr_tiled<DataType>(              \
+            const DataType*,                              \
+            const DataType*,                              \
+            size_t,                                       \
+            size_t,                                       \
+            size_t,                                       \
+            size_t,                                       \
+            float*,                                       \
+            int64_t*,                                     \
+            const float*,                                 \
+            const IDSelector*);                           \
+    template void knn_inner_product_tiled<DataType>(      \
+            const DataType*,                              \
+            const DataType*,                              \
+            size_t,                                       \
+            size_t,                                       \
+            size_t,                                       \
+            size_t,                                       \
+            float*,                                       \
+            int64_t*,                                     \
+            const IDSelector*);                           \
+    template void knn_cosine_tiled<DataType>(             \
+            const DataType*,                              \
+            const DataType*,                              \
+            const float*,                                 \
+            size_t,                                       \
+            size_t,                                       \
+            size_t,                                       \
+            size_t,                                       \
+            float*,                                       \
+            int64_t*,                                     \
+            const IDSelector*);
+
+INSTANTIATE_KNN_TILED(float)
+INSTANTIATE_KNN_TILED(::knowhere::fp16)
+INSTANTIATE_KNN_TILED(::knowhere::bf16)
+INSTANTIATE_KNN_TILED(::knowhere::int8)
+
+#undef INSTANTIATE_KNN_TILED
+
+} // namespace faiss::cppcontrib::knowhere
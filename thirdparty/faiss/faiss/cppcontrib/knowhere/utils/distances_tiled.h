@@ -0,0 +1,87 @@
+// Copyright (C) 2019-2023 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License
+
+#pragma once
+
+#include <stdint.h>
+
+#include <faiss/impl/IDSelector.h>
+#include <faiss/impl/platform_macros.h>
+
+namespace faiss {
+namespace cppcontrib {
+namespace knowhere {
+
+/***************************************************************************
+ * Query-tiled KNN functions
+ *
+ * Unlike knn_L2sqr / knn_inner_product, which stream the whole database once
+ * per query unless nx is above distance_compute_blas_threshold, these always
+ * walk the database in cache-sized tiles and score every tile against all nx
+ * queries with a single sgemm. fp16, bf16 and int8 tiles are widened to
+ * float once per tile, so the conversion is amortized over the queries too.
+ *
+ * The selector is applied per tile before any distance is computed:
+ * filtered rows are dropped while the tile is packed, so they cost neither
+ * flops nor heap comparisons. The results are the same as the sequential
+ * functions up to float rounding.
+ ***************************************************************************/
+
+// number of queries and database rows that make up one tile
+FAISS_API extern int distance_compute_tiled_query_bs;
+FAISS_API extern int distance_compute_tiled_database_bytes;
+
+template <typename DataType>
+void knn_L2sqr_tiled(
+        const DataType* x,
+        const DataType* y,
+        size_t d,
+        size_t nx,
+        size_t ny,
+        size_t k,
+        float* distances,
+        int64_t* indexes,
+        const float* y_norm2 = nullptr,
+        const IDSelector* sel = nullptr);
+
+template <typename DataType>
+void knn_inner_product_tiled(
+        const DataType* x,
+        const DataType* y,
+        size_t d,
+        size_t nx,
+        size_t ny,
+        size_t k,
+        float* distances,
+        int64_t* indexes,
+        const IDSelector* sel = nullptr);
+
+// y_norms holds the (non-squared) L2 norms of the database vectors and may be
+// nullptr, in which case they are computed tile by tile.
+template <typename DataType>
+void knn_cosine_tiled(
+        const DataType* x,
+        const DataType* y,
+        const float* y_norms,
+        size_t d,
+        size_t nx,
+        size_t ny,
+        size_t k,
+        float* distances,
+        int64_t* indexes,
+        const IDSelector* sel = nullptr);
+
+} // namespace knowhere
+} // namespace cppcontrib
+} // namespace faiss
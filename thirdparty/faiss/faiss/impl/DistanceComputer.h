@@ -7,7 +7,10 @@
 
 #pragma once
 
+#include <algorithm>
+
 #include <faiss/Index.h>
+#include <faiss/utils/prefetch.h>
 
 namespace faiss {
 
@@ -56,6 +59,11 @@ struct DistanceComputer {
     /// compute distance between two stored vectors
     virtual float symmetric_dis(idx_t i, idx_t j) = 0;
 
+    /// hint that the data of stored vector i will be needed soon.
+    /// this is a pure performance hint: it must not change any state that
+    /// affects distances, and the default implementation does nothing.
+    virtual void prefetch(idx_t /* i */) {}
+
     virtual ~DistanceComputer() {}
 };
 
@@ -100,6 +108,10 @@ struct NegativeDistanceComputer : DistanceComputer {
         return -basedis->symmetric_dis(i, j);
     }
 
+    void prefetch(idx_t i) override {
+        basedis->prefetch(i);
+    }
+
     virtual ~NegativeDistanceComputer() override {
         delete basedis;
     }
@@ -130,6 +142,23 @@ struct FlatCodesDistanceComputer : DistanceComputer {
         return distance_to_code(codes + i * code_size);
     }
 
+    /// max number of bytes of a single code that prefetch() requests.
+    /// the hardware prefetcher picks up the rest of a long code once the
+    /// leading cache lines are in flight.
+    static constexpr size_t max_prefetch_bytes = 512;
+
+    void prefetch(idx_t i) override {
+        if (codes == nullptr) {
+            return;
+        }
+
+        const uint8_t* code = codes + i * code_size;
+        const size_t nbytes = std::min(code_size, max_prefetch_bytes);
+        for (size_t offset = 0; offset < nbytes; offset += 64) {
+            prefetch_L1(code + offset);
+        }
+    }
+
     /// Computes a partial dot product over a slice of the query vector.
     /// The slice is defined by the following parameters:
     ///   — `offset`: the starting index of the first component to include
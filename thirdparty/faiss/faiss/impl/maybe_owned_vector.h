@@ -248,6 +248,24 @@ struct MaybeOwnedVector {
         return result;
     }
 
+    void push_back(const value_type& v) {
+        FAISS_ASSERT_MSG(
+                is_owned,
+                "This operation cannot be performed on a viewed vector");
+
+        owned_data.push_back(v);
+        c_ptr = owned_data.data();
+        c_size = owned_data.size();
+    }
+
+    T& back() {
+        return c_ptr[c_size - 1];
+    }
+
+    const T& back() const {
+        return c_ptr[c_size - 1];
+    }
+
     void clear() {
         FAISS_ASSERT_MSG(
                 is_owned,
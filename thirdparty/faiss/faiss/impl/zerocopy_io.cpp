@@ -13,6 +13,12 @@ namespace faiss {
 ZeroCopyIOReader::ZeroCopyIOReader(const uint8_t* data, size_t size)
         : data_(data), rp_(0), total_(size) {}
 
+ZeroCopyIOReader::ZeroCopyIOReader(
+        const uint8_t* data,
+        size_t size,
+        std::shared_ptr<MaybeOwnedVectorOwner> owner)
+        : data_(data), rp_(0), total_(size), owner(std::move(owner)) {}
+
 ZeroCopyIOReader::~ZeroCopyIOReader() {}
 
 size_t ZeroCopyIOReader::get_data_view(void** ptr, size_t size, size_t nitems) {
@@ -8,18 +8,27 @@
 #pragma once
 
 #include <cstdint>
+#include <memory>
 
 #include <faiss/impl/io.h>
+#include <faiss/impl/maybe_owned_vector.h>
 
 namespace faiss {
 
 // ZeroCopyIOReader just maps the data from a given pointer.
+// If an owner is given, every vector viewing the data holds a reference to
+// it, so the buffer stays alive for as long as the loaded index does.
 struct ZeroCopyIOReader : public faiss::IOReader {
     const uint8_t* data_;
     size_t rp_ = 0;
     size_t total_ = 0;
+    std::shared_ptr<MaybeOwnedVectorOwner> owner;
 
     ZeroCopyIOReader(const uint8_t* data, size_t size);
+    ZeroCopyIOReader(
+            const uint8_t* data,
+            size_t size,
+            std::shared_ptr<MaybeOwnedVectorOwner> owner);
     ~ZeroCopyIOReader() override;
 
     void reset();
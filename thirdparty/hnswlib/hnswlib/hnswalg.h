@@ -902,7 +902,7 @@ class HierarchicalNSW : public AlgorithmInterface<dist_t> {
     }
 
     void
-    saveIndex(knowhere::MemoryIOWriter& output) {
+    saveIndex(knowhere::IOWriter& output) {
         using knowhere::writeBinaryPOD;
         // write l2/ip calculator
         writeBinaryPOD(output, metric_type_);
@@ -245,7 +245,7 @@ class AlgorithmInterface {
     searchKnnCloserFirst(void* query_data, size_t k, const knowhere::BitsetView) const;
 
     virtual void
-    saveIndex(knowhere::MemoryIOWriter& output) = 0;
+    saveIndex(knowhere::IOWriter& output) = 0;
     virtual ~AlgorithmInterface() {
     }
 };